@@ -0,0 +1,281 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_CONTAINERS_FLAT_HASH_MAP_H_
+#define BASE_CONTAINERS_FLAT_HASH_MAP_H_
+
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "base/check.h"
+#include "base/containers/flat_hash_table.h"
+#include "base/containers/flat_map.h"
+
+namespace base {
+
+// flat_hash_map is a hash map with a std::unordered_map-like interface that
+// stores its contents inline in an open-addressing table (a "Swiss table", see
+// flat_hash_table.h), rather than in one heap node per element.
+//
+// Please see //base/containers/README.md for an overview of which container
+// to select.
+//
+// PROS
+//
+//  - O(1) inserts, removals and lookups, without a node allocation per
+//    element.
+//  - Good memory locality: a lookup usually touches one cache line of control
+//    bytes and the slot of the element found.
+//  - Lookups match 16 slots at a time with SIMD on x86 (8 at a time with
+//    64-bit arithmetic elsewhere).
+//  - Heterogeneous lookup: std::string keys can be looked up with a
+//    base::StringPiece, and std::vector keys of integral elements with a
+//    base::span, without constructing a key.
+//
+// CONS
+//
+//  - Iteration order is unspecified.
+//  - Higher overhead than flat_map for maps of a few elements, since the table
+//    allocates at least 4 slots and keeps up to 1/8th of them empty.
+//  - Elements are moved when the table grows, so they must be movable.
+//
+// IMPORTANT NOTES
+//
+//  - Iterators, pointers and references to elements are invalidated by
+//    inserts that grow the table (unlike std::unordered_map, which never
+//    moves its elements). This means that the following line of code has
+//    undefined behavior:
+//      container["new element"] = it->second;
+//  - Erasing an element only invalidates iterators to that element.
+//  - If the number of elements is known in advance, call reserve() first.
+//  - Hash functions that are the identity (like std::hash of integers) are
+//    fine: hashes are mixed before use.
+//
+// QUICK REFERENCE
+//
+// Most of the core functionality is inherited from flat_hash_table. Please see
+// flat_hash_table.h for more details for most of these functions. As a quick
+// reference, the functions available are:
+//
+// Constructors:
+//   flat_hash_map(size_t bucket_count, const Hash& = Hash(),
+//                 const KeyEqual& = KeyEqual());
+//   flat_hash_map(const flat_hash_map&);
+//   flat_hash_map(flat_hash_map&&);
+//   flat_hash_map(InputIterator first, InputIterator last,
+//                 size_t bucket_count = 0, const Hash& = Hash(),
+//                 const KeyEqual& = KeyEqual());
+//   flat_hash_map(std::initializer_list<value_type> ilist,
+//                 size_t bucket_count = 0, const Hash& = Hash(),
+//                 const KeyEqual& = KeyEqual());
+//
+// Assignment functions:
+//   flat_hash_map& operator=(const flat_hash_map&);
+//   flat_hash_map& operator=(flat_hash_map&&);
+//   flat_hash_map& operator=(initializer_list<value_type>);
+//
+// Memory management functions:
+//   void   reserve(size_t);
+//   void   rehash(size_t);
+//   size_t capacity() const;
+//   size_t bucket_count() const;
+//   float  load_factor() const;
+//
+// Size management functions:
+//   void   clear();
+//   size_t size() const;
+//   size_t max_size() const;
+//   bool   empty() const;
+//
+// Iterator functions:
+//   iterator               begin();
+//   const_iterator         begin() const;
+//   const_iterator         cbegin() const;
+//   iterator               end();
+//   const_iterator         end() const;
+//   const_iterator         cend() const;
+//
+// Insert and accessor functions:
+//   mapped_type&         operator[](const key_type&);
+//   mapped_type&         operator[](key_type&&);
+//   mapped_type&         at(const K&);
+//   const mapped_type&   at(const K&) const;
+//   pair<iterator, bool> insert(const value_type&);
+//   pair<iterator, bool> insert(value_type&&);
+//   iterator             insert(const_iterator hint, const value_type&);
+//   iterator             insert(const_iterator hint, value_type&&);
+//   void                 insert(InputIterator first, InputIterator last);
+//   pair<iterator, bool> insert_or_assign(K&&, M&&);
+//   iterator             insert_or_assign(const_iterator hint, K&&, M&&);
+//   pair<iterator, bool> emplace(Args&&...);
+//   iterator             emplace_hint(const_iterator, Args&&...);
+//   pair<iterator, bool> try_emplace(K&&, Args&&...);
+//   iterator             try_emplace(const_iterator hint, K&&, Args&&...);
+//
+// Erase functions:
+//   iterator erase(iterator);
+//   iterator erase(const_iterator);
+//   iterator erase(const_iterator first, const_iterator& last);
+//   template <class K> size_t erase(const K& key);
+//
+// Hash policy (see std::unordered_map documentation):
+//   hasher    hash_function() const;
+//   key_equal key_eq() const;
+//
+// Search functions:
+//   template <typename K> size_t                   count(const K&) const;
+//   template <typename K> iterator                 find(const K&);
+//   template <typename K> const_iterator           find(const K&) const;
+//   template <typename K> bool                     contains(const K&) const;
+//   template <typename K> pair<iterator, iterator> equal_range(const K&);
+//
+// General functions:
+//   void swap(flat_hash_map&);
+//
+// Non-member operators:
+//   bool operator==(const flat_hash_map&, const flat_hash_map);
+//   bool operator!=(const flat_hash_map&, const flat_hash_map);
+//
+template <class Key,
+          class Mapped,
+          class Hash = FlatHashDefaultHash<Key>,
+          class KeyEqual = FlatHashDefaultEq<Key>>
+class flat_hash_map
+    : public ::base::internal::flat_hash_table<Key,
+                                               std::pair<Key, Mapped>,
+                                               internal::GetFirst,
+                                               Hash,
+                                               KeyEqual> {
+ private:
+  using table = typename ::base::internal::
+      flat_hash_table<Key, std::pair<Key, Mapped>, internal::GetFirst, Hash,
+                      KeyEqual>;
+
+ public:
+  using key_type = typename table::key_type;
+  using mapped_type = Mapped;
+  using value_type = typename table::value_type;
+  using iterator = typename table::iterator;
+  using const_iterator = typename table::const_iterator;
+
+  // --------------------------------------------------------------------------
+  // Lifetime and assignments.
+
+  using table::table;
+  using table::operator=;
+
+  // Out-of-bound calls to at() will CHECK.
+  template <class K>
+  mapped_type& at(const K& key);
+  template <class K>
+  const mapped_type& at(const K& key) const;
+
+  // --------------------------------------------------------------------------
+  // Map-specific insert operations.
+  //
+  // Normal insert() functions are inherited from flat_hash_table.
+  //
+  // Assume that every insertion invalidates iterators and references.
+
+  mapped_type& operator[](const key_type& key);
+  mapped_type& operator[](key_type&& key);
+
+  template <class K, class M>
+  std::pair<iterator, bool> insert_or_assign(K&& key, M&& obj);
+  template <class K, class M>
+  iterator insert_or_assign(const_iterator hint, K&& key, M&& obj) {
+    return insert_or_assign(std::forward<K>(key), std::forward<M>(obj)).first;
+  }
+
+  template <class K, class... Args>
+  std::enable_if_t<std::is_constructible<key_type, K&&>::value,
+                   std::pair<iterator, bool>>
+  try_emplace(K&& key, Args&&... args);
+
+  template <class K, class... Args>
+  std::enable_if_t<std::is_constructible<key_type, K&&>::value, iterator>
+  try_emplace(const_iterator hint, K&& key, Args&&... args) {
+    return try_emplace(std::forward<K>(key), std::forward<Args>(args)...).first;
+  }
+
+  // --------------------------------------------------------------------------
+  // General operations.
+
+  void swap(flat_hash_map& other) noexcept { table::swap(other); }
+
+  friend void swap(flat_hash_map& lhs, flat_hash_map& rhs) noexcept {
+    lhs.swap(rhs);
+  }
+};
+
+// ----------------------------------------------------------------------------
+// Lookups.
+
+template <class Key, class Mapped, class Hash, class KeyEqual>
+template <class K>
+auto flat_hash_map<Key, Mapped, Hash, KeyEqual>::at(const K& key)
+    -> mapped_type& {
+  iterator found = table::find(key);
+  CHECK(found != table::end());
+  return found->second;
+}
+
+template <class Key, class Mapped, class Hash, class KeyEqual>
+template <class K>
+auto flat_hash_map<Key, Mapped, Hash, KeyEqual>::at(const K& key) const
+    -> const mapped_type& {
+  const_iterator found = table::find(key);
+  CHECK(found != table::cend());
+  return found->second;
+}
+
+// ----------------------------------------------------------------------------
+// Insert operations.
+
+template <class Key, class Mapped, class Hash, class KeyEqual>
+auto flat_hash_map<Key, Mapped, Hash, KeyEqual>::operator[](
+    const key_type& key) -> mapped_type& {
+  return table::emplace_key_args(key, std::piecewise_construct,
+                                 std::forward_as_tuple(key),
+                                 std::forward_as_tuple())
+      .first->second;
+}
+
+template <class Key, class Mapped, class Hash, class KeyEqual>
+auto flat_hash_map<Key, Mapped, Hash, KeyEqual>::operator[](key_type&& key)
+    -> mapped_type& {
+  return table::emplace_key_args(key, std::piecewise_construct,
+                                 std::forward_as_tuple(std::move(key)),
+                                 std::forward_as_tuple())
+      .first->second;
+}
+
+template <class Key, class Mapped, class Hash, class KeyEqual>
+template <class K, class M>
+auto flat_hash_map<Key, Mapped, Hash, KeyEqual>::insert_or_assign(K&& key,
+                                                                  M&& obj)
+    -> std::pair<iterator, bool> {
+  auto result =
+      table::emplace_key_args(key, std::forward<K>(key), std::forward<M>(obj));
+  if (!result.second)
+    result.first->second = std::forward<M>(obj);
+  return result;
+}
+
+template <class Key, class Mapped, class Hash, class KeyEqual>
+template <class K, class... Args>
+auto flat_hash_map<Key, Mapped, Hash, KeyEqual>::try_emplace(K&& key,
+                                                             Args&&... args)
+    -> std::enable_if_t<std::is_constructible<key_type, K&&>::value,
+                        std::pair<iterator, bool>> {
+  return table::emplace_key_args(
+      key, std::piecewise_construct,
+      std::forward_as_tuple(std::forward<K>(key)),
+      std::forward_as_tuple(std::forward<Args>(args)...));
+}
+
+}  // namespace base
+
+#endif  // BASE_CONTAINERS_FLAT_HASH_MAP_H_
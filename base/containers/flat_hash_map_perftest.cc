@@ -0,0 +1,154 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/containers/flat_hash_map.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "base/containers/flat_map.h"
+#include "base/containers/small_map.h"
+#include "base/rand_util.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/stringprintf.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+// This file compares flat_hash_map against the other associative containers
+// with a map interface, for maps of increasing sizes with integer and string
+// keys.
+
+namespace base {
+
+namespace {
+
+constexpr char kMetricPrefixMap[] = "AssociativeContainer.";
+constexpr char kMetricInsertTime[] = "insert_time_per_element";
+constexpr char kMetricFindHitTime[] = "find_hit_time";
+constexpr char kMetricFindMissTime[] = "find_miss_time";
+constexpr char kMetricEraseTime[] = "erase_time_per_element";
+
+// Number of operations per measurement, across all maps of a given size.
+constexpr size_t kNumOperations = 1 << 20;
+
+// Ask the compiler not to use a register for this counter, so that lookups
+// are not optimized away.
+volatile size_t g_flat_hash_map_perf_test_found;
+
+perf_test::PerfResultReporter SetUpReporter(const std::string& story_name) {
+  perf_test::PerfResultReporter reporter(kMetricPrefixMap, story_name);
+  reporter.RegisterImportantMetric(kMetricInsertTime, "ns");
+  reporter.RegisterImportantMetric(kMetricFindHitTime, "ns");
+  reporter.RegisterImportantMetric(kMetricFindMissTime, "ns");
+  reporter.RegisterImportantMetric(kMetricEraseTime, "ns");
+  return reporter;
+}
+
+template <class Key>
+Key MakeKey(uint64_t value);
+
+template <>
+uint64_t MakeKey<uint64_t>(uint64_t value) {
+  return value;
+}
+
+template <>
+std::string MakeKey<std::string>(uint64_t value) {
+  // Typical of host names and cookie keys.
+  return StringPrintf("www.%s.example.com", NumberToString(value).c_str());
+}
+
+// Generates |count| distinct keys in random order.
+template <class Key>
+std::vector<Key> MakeKeys(size_t count) {
+  std::vector<Key> keys;
+  keys.reserve(count);
+  for (size_t i = 0; i < count; ++i)
+    keys.push_back(MakeKey<Key>(RandUint64()));
+  return keys;
+}
+
+template <class Map>
+void RunMapPerfTest(const std::string& map_name, size_t map_size) {
+  using Key = typename Map::key_type;
+  const size_t num_maps = std::max<size_t>(1, kNumOperations / map_size);
+  const size_t num_operations = num_maps * map_size;
+  std::vector<Key> keys = MakeKeys<Key>(map_size);
+  std::vector<Key> missing_keys = MakeKeys<Key>(map_size);
+  std::vector<Map> maps(num_maps);
+
+  TimeTicks start = TimeTicks::Now();
+  for (Map& map : maps) {
+    for (const Key& key : keys)
+      map[key] = 1;
+  }
+  TimeDelta insert_time = TimeTicks::Now() - start;
+
+  size_t found = 0;
+  start = TimeTicks::Now();
+  for (const Map& map : maps) {
+    for (const Key& key : keys)
+      found += map.find(key) != map.end();
+  }
+  TimeDelta find_hit_time = TimeTicks::Now() - start;
+  EXPECT_EQ(num_operations, found);
+
+  start = TimeTicks::Now();
+  for (const Map& map : maps) {
+    for (const Key& key : missing_keys)
+      found += map.find(key) != map.end();
+  }
+  TimeDelta find_miss_time = TimeTicks::Now() - start;
+  g_flat_hash_map_perf_test_found = found;
+
+  start = TimeTicks::Now();
+  for (Map& map : maps) {
+    for (const Key& key : keys)
+      map.erase(key);
+  }
+  TimeDelta erase_time = TimeTicks::Now() - start;
+
+  auto reporter = SetUpReporter(StringPrintf(
+      "%s_%s_%zu", map_name.c_str(),
+      std::is_same<Key, std::string>::value ? "string" : "int", map_size));
+  auto add_result = [&](const char* metric, TimeDelta time) {
+    reporter.AddResult(
+        metric, static_cast<double>(time.InNanoseconds()) / num_operations);
+  };
+  add_result(kMetricInsertTime, insert_time);
+  add_result(kMetricFindHitTime, find_hit_time);
+  add_result(kMetricFindMissTime, find_miss_time);
+  add_result(kMetricEraseTime, erase_time);
+}
+
+template <class Key>
+void RunAllMapPerfTests(size_t map_size) {
+  RunMapPerfTest<flat_hash_map<Key, int>>("flat_hash_map", map_size);
+  RunMapPerfTest<std::unordered_map<Key, int>>("unordered_map", map_size);
+  RunMapPerfTest<small_map<std::unordered_map<Key, int>>>("small_map",
+                                                          map_size);
+  // Inserting in random order is quadratic in flat_map.
+  if (map_size <= 1000)
+    RunMapPerfTest<flat_map<Key, int>>("flat_map", map_size);
+}
+
+}  // namespace
+
+TEST(FlatHashMapPerfTest, IntKeys) {
+  for (size_t map_size : {4, 16, 100, 1000, 100000})
+    RunAllMapPerfTests<uint64_t>(map_size);
+}
+
+TEST(FlatHashMapPerfTest, StringKeys) {
+  for (size_t map_size : {4, 16, 100, 1000, 100000})
+    RunAllMapPerfTests<std::string>(map_size);
+}
+
+}  // namespace base
@@ -0,0 +1,327 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/containers/flat_hash_map.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/containers/span.h"
+#include "base/rand_util.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_piece.h"
+#include "testing/gmock/include/gmock/gmock.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+// A flat_hash_map is basically an interface to flat_hash_table, so the table
+// itself is tested here as well, with both the platform's group
+// implementation and the portable one.
+
+using ::testing::Pair;
+using ::testing::UnorderedElementsAre;
+
+namespace base {
+
+namespace {
+
+// Hashes every key to the same value, so that all elements share one probe
+// sequence.
+struct CollidingHash {
+  size_t operator()(int) const { return 42; }
+};
+
+template <class Hash = std::hash<int>,
+          class Group = internal::HashGroupPortable>
+using PortableMap = internal::flat_hash_table<int,
+                                              std::pair<int, int>,
+                                              internal::GetFirst,
+                                              Hash,
+                                              std::equal_to<int>,
+                                              Group>;
+
+// Runs random inserts and erases against |map| and a std::map, checking that
+// their contents always match.
+template <class Map>
+void CheckAgainstStdMap(Map& map, int key_range, int iterations) {
+  std::map<int, int> expected;
+  for (int i = 0; i < iterations; ++i) {
+    int key = RandInt(0, key_range);
+    if (RandInt(0, 2) == 0) {
+      EXPECT_EQ(expected.erase(key), map.erase(key));
+    } else {
+      EXPECT_EQ(expected.emplace(key, i).second,
+                map.insert(std::make_pair(key, i)).second);
+    }
+    ASSERT_EQ(expected.size(), map.size());
+  }
+  for (const auto& element : expected) {
+    auto found = map.find(element.first);
+    ASSERT_NE(found, map.end());
+    EXPECT_EQ(element.second, found->second);
+  }
+  std::map<int, int> iterated(map.begin(), map.end());
+  EXPECT_EQ(expected, iterated);
+}
+
+}  // namespace
+
+TEST(FlatHashMap, InitializerList) {
+  flat_hash_map<int, int> cont({{1, 1},
+                                {2, 2},
+                                {3, 3},
+                                {4, 4},
+                                {5, 5},
+                                {6, 6},
+                                {1, 2},
+                                {10, 10},
+                                {8, 8}});
+  EXPECT_THAT(cont, UnorderedElementsAre(Pair(1, 1), Pair(2, 2), Pair(3, 3),
+                                         Pair(4, 4), Pair(5, 5), Pair(6, 6),
+                                         Pair(8, 8), Pair(10, 10)));
+}
+
+TEST(FlatHashMap, InsertFindErase) {
+  flat_hash_map<int, std::string> m;
+  EXPECT_TRUE(m.empty());
+  EXPECT_EQ(m.end(), m.find(1));
+
+  EXPECT_TRUE(m.insert({1, "a"}).second);
+  EXPECT_FALSE(m.insert({1, "b"}).second);
+  EXPECT_TRUE(m.emplace(2, "c").second);
+  EXPECT_EQ(2u, m.size());
+  EXPECT_EQ("a", m.find(1)->second);
+  EXPECT_TRUE(m.contains(2));
+  EXPECT_EQ(1u, m.count(2));
+  EXPECT_EQ(0u, m.count(3));
+
+  EXPECT_EQ(1u, m.erase(1));
+  EXPECT_EQ(0u, m.erase(1));
+  EXPECT_EQ(1u, m.size());
+  EXPECT_FALSE(m.contains(1));
+}
+
+TEST(FlatHashMap, SubscriptAndAt) {
+  flat_hash_map<std::string, int> m;
+  m["a"] = 1;
+  std::string b = "b";
+  m[std::move(b)] = 2;
+  m["a"] += 10;
+  EXPECT_EQ(11, m.at("a"));
+  EXPECT_EQ(2, m.at(std::string("b")));
+  EXPECT_EQ(2u, m.size());
+
+  const flat_hash_map<std::string, int>& const_m = m;
+  EXPECT_EQ(11, const_m.at("a"));
+  EXPECT_DEATH_IF_SUPPORTED(m.at("c"), "");
+}
+
+TEST(FlatHashMap, InsertOrAssign) {
+  flat_hash_map<int, std::unique_ptr<int>> m;
+  auto result = m.insert_or_assign(1, std::make_unique<int>(1));
+  EXPECT_TRUE(result.second);
+  EXPECT_EQ(1, *result.first->second);
+
+  result = m.insert_or_assign(1, std::make_unique<int>(2));
+  EXPECT_FALSE(result.second);
+  EXPECT_EQ(2, *result.first->second);
+  EXPECT_EQ(1u, m.size());
+}
+
+TEST(FlatHashMap, TryEmplace) {
+  flat_hash_map<int, std::pair<std::string, int>> m;
+  auto result = m.try_emplace(1, "a", 1);
+  EXPECT_TRUE(result.second);
+  EXPECT_EQ("a", result.first->second.first);
+
+  result = m.try_emplace(1, "b", 2);
+  EXPECT_FALSE(result.second);
+  EXPECT_EQ("a", result.first->second.first);
+
+  auto it = m.try_emplace(m.end(), 2, "c", 3);
+  EXPECT_EQ(2, it->first);
+  EXPECT_EQ(2u, m.size());
+}
+
+TEST(FlatHashMap, MoveOnlyValues) {
+  flat_hash_map<int, std::unique_ptr<int>> m;
+  for (int i = 0; i < 100; ++i)
+    m[i] = std::make_unique<int>(i);
+  for (int i = 0; i < 100; ++i)
+    EXPECT_EQ(i, *m.at(i));
+
+  flat_hash_map<int, std::unique_ptr<int>> moved(std::move(m));
+  EXPECT_EQ(100u, moved.size());
+  EXPECT_TRUE(m.empty());  // NOLINT(bugprone-use-after-move)
+}
+
+TEST(FlatHashMap, StringPieceLookup) {
+  flat_hash_map<std::string, int> m = {{"foo", 1}, {"bar", 2}};
+  StringPiece foo = "foo";
+  EXPECT_EQ(1, m.find(foo)->second);
+  EXPECT_TRUE(m.contains(StringPiece("bar")));
+  EXPECT_FALSE(m.contains(StringPiece("baz")));
+  EXPECT_EQ(1u, m.erase(StringPiece("bar")));
+  EXPECT_EQ(1u, m.size());
+}
+
+TEST(FlatHashMap, SpanLookup) {
+  flat_hash_map<std::vector<uint8_t>, int> m;
+  m[{1, 2, 3}] = 1;
+  m[{}] = 2;
+  const uint8_t key[] = {1, 2, 3};
+  EXPECT_EQ(1, m.find(make_span(key))->second);
+  EXPECT_EQ(2, m.find(span<const uint8_t>())->second);
+  EXPECT_FALSE(m.contains(make_span(key, 2u)));
+}
+
+TEST(FlatHashMap, IterationVisitsEveryElementOnce) {
+  flat_hash_map<int, int> m;
+  for (int i = 0; i < 1000; ++i)
+    m[i] = i;
+  std::vector<bool> seen(1000);
+  for (const auto& element : m) {
+    EXPECT_FALSE(seen[element.first]);
+    seen[element.first] = true;
+  }
+  EXPECT_EQ(std::vector<bool>(1000, true), seen);
+}
+
+TEST(FlatHashMap, EraseWhileIterating) {
+  flat_hash_map<int, int> m;
+  for (int i = 0; i < 100; ++i)
+    m[i] = i;
+  for (auto it = m.begin(); it != m.end();) {
+    if (it->first % 2)
+      it = m.erase(it);
+    else
+      ++it;
+  }
+  EXPECT_EQ(50u, m.size());
+  for (int i = 0; i < 100; ++i)
+    EXPECT_EQ(i % 2 == 0, m.contains(i));
+
+  m.erase(m.cbegin(), m.cend());
+  EXPECT_TRUE(m.empty());
+}
+
+TEST(FlatHashMap, ReserveAvoidsRehash) {
+  flat_hash_map<int, int> m;
+  m.reserve(1000);
+  size_t capacity = m.capacity();
+  EXPECT_GE(capacity, 1000u);
+  for (int i = 0; i < 1000; ++i)
+    m[i] = i;
+  EXPECT_EQ(capacity, m.capacity());
+}
+
+TEST(FlatHashMap, ClearKeepsCapacity) {
+  flat_hash_map<int, int> m;
+  for (int i = 0; i < 100; ++i)
+    m[i] = i;
+  size_t capacity = m.capacity();
+  m.clear();
+  EXPECT_TRUE(m.empty());
+  EXPECT_EQ(capacity, m.capacity());
+  EXPECT_EQ(m.end(), m.begin());
+
+  m.rehash(0);
+  EXPECT_EQ(0u, m.capacity());
+}
+
+TEST(FlatHashMap, ChurnDoesNotGrow) {
+  // Repeated inserts and erases reuse deleted slots or rehash in place rather
+  // than growing the table.
+  flat_hash_map<int, int> m;
+  for (int i = 0; i < 100; ++i)
+    m[i] = i;
+  size_t capacity = m.capacity();
+  for (int i = 100; i < 100000; ++i) {
+    m.erase(i - 100);
+    m[i] = i;
+  }
+  EXPECT_EQ(100u, m.size());
+  EXPECT_EQ(capacity, m.capacity());
+}
+
+TEST(FlatHashMap, CopyAndCompare) {
+  flat_hash_map<int, std::string> a;
+  for (int i = 0; i < 50; ++i)
+    a[i] = NumberToString(i);
+  flat_hash_map<int, std::string> b(a);
+  EXPECT_EQ(a, b);
+
+  b[0] = "changed";
+  EXPECT_NE(a, b);
+
+  b = a;
+  EXPECT_EQ(a, b);
+  b.erase(0);
+  EXPECT_NE(a, b);
+
+  swap(a, b);
+  EXPECT_EQ(49u, a.size());
+  EXPECT_EQ(50u, b.size());
+}
+
+TEST(FlatHashMap, RandomOperations) {
+  flat_hash_map<int, int> m;
+  CheckAgainstStdMap(m, 1000, 20000);
+}
+
+TEST(FlatHashTable, PortableGroupRandomOperations) {
+  PortableMap<> m;
+  CheckAgainstStdMap(m, 1000, 20000);
+}
+
+TEST(FlatHashTable, CollidingHashes) {
+  flat_hash_map<int, int, CollidingHash> m;
+  CheckAgainstStdMap(m, 100, 2000);
+
+  PortableMap<CollidingHash> portable;
+  CheckAgainstStdMap(portable, 100, 2000);
+}
+
+TEST(FlatHashTable, SmallTables) {
+  // Tables of a single group mirror every control byte after the end.
+  for (int size = 0; size < 20; ++size) {
+    PortableMap<> m;
+    for (int i = 0; i < size; ++i)
+      m.insert({i, i});
+    for (int i = 0; i < size; ++i)
+      EXPECT_TRUE(m.erase(i));
+    EXPECT_TRUE(m.empty());
+    EXPECT_EQ(m.end(), m.begin());
+  }
+}
+
+TEST(FlatHashTable, PortableGroupMatch) {
+  const internal::HashCtrl ctrl[] = {
+      3, internal::kHashCtrlEmpty, 5, internal::kHashCtrlDeleted,
+      3, 0x7f, internal::kHashCtrlEmpty, 4};
+  internal::HashGroupPortable group(ctrl);
+
+  auto match = group.Match(3);
+  ASSERT_TRUE(match);
+  EXPECT_EQ(0u, match.LowestBitSet());
+  match.ClearLowestBit();
+  ASSERT_TRUE(match);
+  EXPECT_EQ(4u, match.LowestBitSet());
+  match.ClearLowestBit();
+  EXPECT_FALSE(match);
+
+  EXPECT_FALSE(group.Match(6));
+
+  auto empty = group.MatchEmpty();
+  EXPECT_EQ(1u, empty.TrailingZeros());
+  EXPECT_EQ(1u, empty.LeadingZeros());
+
+  auto empty_or_deleted = group.MatchEmptyOrDeleted();
+  EXPECT_EQ(1u, empty_or_deleted.LowestBitSet());
+  empty_or_deleted.ClearLowestBit();
+  EXPECT_EQ(3u, empty_or_deleted.LowestBitSet());
+}
+
+}  // namespace base
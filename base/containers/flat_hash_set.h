@@ -0,0 +1,122 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_CONTAINERS_FLAT_HASH_SET_H_
+#define BASE_CONTAINERS_FLAT_HASH_SET_H_
+
+#include "base/containers/flat_hash_table.h"
+#include "base/functional/identity.h"
+
+namespace base {
+
+// flat_hash_set is a hash set with a std::unordered_set-like interface that
+// stores its contents inline in an open-addressing table (a "Swiss table", see
+// flat_hash_table.h).
+//
+// Please see //base/containers/README.md for an overview of which container
+// to select.
+//
+// The pros, cons and invalidation rules are the same as flat_hash_map's; see
+// flat_hash_map.h. In particular, inserts that grow the table invalidate
+// iterators, pointers and references to all elements.
+//
+// QUICK REFERENCE
+//
+// Most of the core functionality is inherited from flat_hash_table. Please see
+// flat_hash_table.h for more details for most of these functions. As a quick
+// reference, the functions available are:
+//
+// Constructors:
+//   flat_hash_set(size_t bucket_count, const Hash& = Hash(),
+//                 const KeyEqual& = KeyEqual());
+//   flat_hash_set(const flat_hash_set&);
+//   flat_hash_set(flat_hash_set&&);
+//   flat_hash_set(InputIterator first, InputIterator last,
+//                 size_t bucket_count = 0, const Hash& = Hash(),
+//                 const KeyEqual& = KeyEqual());
+//   flat_hash_set(std::initializer_list<value_type> ilist,
+//                 size_t bucket_count = 0, const Hash& = Hash(),
+//                 const KeyEqual& = KeyEqual());
+//
+// Assignment functions:
+//   flat_hash_set& operator=(const flat_hash_set&);
+//   flat_hash_set& operator=(flat_hash_set&&);
+//   flat_hash_set& operator=(initializer_list<Key>);
+//
+// Memory management functions:
+//   void   reserve(size_t);
+//   void   rehash(size_t);
+//   size_t capacity() const;
+//   size_t bucket_count() const;
+//   float  load_factor() const;
+//
+// Size management functions:
+//   void   clear();
+//   size_t size() const;
+//   size_t max_size() const;
+//   bool   empty() const;
+//
+// Iterator functions:
+//   iterator               begin();
+//   const_iterator         begin() const;
+//   const_iterator         cbegin() const;
+//   iterator               end();
+//   const_iterator         end() const;
+//   const_iterator         cend() const;
+//
+// Insert and accessor functions:
+//   pair<iterator, bool> insert(const key_type&);
+//   pair<iterator, bool> insert(key_type&&);
+//   iterator             insert(const_iterator hint, const key_type&);
+//   iterator             insert(const_iterator hint, key_type&&);
+//   void                 insert(InputIterator first, InputIterator last);
+//   pair<iterator, bool> emplace(Args&&...);
+//   iterator             emplace_hint(const_iterator, Args&&...);
+//
+// Erase functions:
+//   iterator erase(iterator);
+//   iterator erase(const_iterator first, const_iterator& last);
+//   template <class K> size_t erase(const K& key);
+//
+// Hash policy (see std::unordered_set documentation):
+//   hasher    hash_function() const;
+//   key_equal key_eq() const;
+//
+// Search functions:
+//   template <typename K> size_t                   count(const K&) const;
+//   template <typename K> iterator                 find(const K&);
+//   template <typename K> const_iterator           find(const K&) const;
+//   template <typename K> bool                     contains(const K&) const;
+//   template <typename K> pair<iterator, iterator> equal_range(const K&);
+//
+// General functions:
+//   void swap(flat_hash_set&);
+//
+// Non-member operators:
+//   bool operator==(const flat_hash_set&, const flat_hash_set);
+//   bool operator!=(const flat_hash_set&, const flat_hash_set);
+//
+template <class Key,
+          class Hash = FlatHashDefaultHash<Key>,
+          class KeyEqual = FlatHashDefaultEq<Key>>
+class flat_hash_set : public ::base::internal::
+                          flat_hash_table<Key, Key, identity, Hash, KeyEqual> {
+ private:
+  using table = typename ::base::internal::
+      flat_hash_table<Key, Key, identity, Hash, KeyEqual>;
+
+ public:
+  using table::table;
+  using table::operator=;
+
+  void swap(flat_hash_set& other) noexcept { table::swap(other); }
+
+  friend void swap(flat_hash_set& lhs, flat_hash_set& rhs) noexcept {
+    lhs.swap(rhs);
+  }
+};
+
+}  // namespace base
+
+#endif  // BASE_CONTAINERS_FLAT_HASH_SET_H_
@@ -0,0 +1,70 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/containers/flat_hash_set.h"
+
+#include <string>
+#include <vector>
+
+#include "base/strings/string_piece.h"
+#include "testing/gmock/include/gmock/gmock.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+// A flat_hash_set is basically an interface to flat_hash_table. So several
+// basic operations are tested to make sure things are set up properly, but the
+// bulk of the tests are in flat_hash_map_unittest.cc.
+
+using ::testing::UnorderedElementsAre;
+
+namespace base {
+
+TEST(FlatHashSet, RangeConstructor) {
+  const int input[] = {1, 2, 1, 3, 2, 1};
+  flat_hash_set<int> cont(std::begin(input), std::end(input));
+  EXPECT_THAT(cont, UnorderedElementsAre(1, 2, 3));
+}
+
+TEST(FlatHashSet, InitializerListAssignment) {
+  flat_hash_set<int> cont = {1, 2};
+  cont = {3, 4, 4};
+  EXPECT_THAT(cont, UnorderedElementsAre(3, 4));
+}
+
+TEST(FlatHashSet, InsertEraseContains) {
+  flat_hash_set<std::string> s;
+  EXPECT_TRUE(s.insert("a").second);
+  EXPECT_FALSE(s.insert("a").second);
+  EXPECT_TRUE(s.emplace(3, 'b').second);
+  EXPECT_TRUE(s.contains("bbb"));
+  EXPECT_TRUE(s.contains(StringPiece("a")));
+  EXPECT_EQ(1u, s.erase(StringPiece("a")));
+  EXPECT_THAT(s, UnorderedElementsAre("bbb"));
+}
+
+TEST(FlatHashSet, IteratorsAreConst) {
+  using Set = flat_hash_set<int>;
+  static_assert(std::is_same<Set::iterator, Set::const_iterator>::value,
+                "Set elements must not be modifiable");
+  static_assert(std::is_same<decltype(*std::declval<Set::iterator>()),
+                             const int&>::value,
+                "Set elements must not be modifiable");
+}
+
+TEST(FlatHashSet, EraseIterator) {
+  flat_hash_set<int> s = {1, 2, 3};
+  auto it = s.find(2);
+  ASSERT_NE(it, s.end());
+  s.erase(it);
+  EXPECT_THAT(s, UnorderedElementsAre(1, 3));
+}
+
+TEST(FlatHashSet, Compare) {
+  flat_hash_set<int> a = {1, 2, 3};
+  flat_hash_set<int> b = {3, 2, 1};
+  flat_hash_set<int> c = {1, 2};
+  EXPECT_EQ(a, b);
+  EXPECT_NE(a, c);
+}
+
+}  // namespace base
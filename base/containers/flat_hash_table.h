@@ -0,0 +1,1090 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_CONTAINERS_FLAT_HASH_TABLE_H_
+#define BASE_CONTAINERS_FLAT_HASH_TABLE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "base/bits.h"
+#include "base/check.h"
+#include "base/check_op.h"
+#include "base/compiler_specific.h"
+#include "base/containers/flat_tree.h"
+#include "base/containers/span.h"
+#include "base/hash/hash.h"
+#include "base/strings/string_piece.h"
+#include "build/build_config.h"
+
+#if defined(ARCH_CPU_X86_FAMILY) && !defined(OS_NACL)
+#include <emmintrin.h>
+#endif
+
+namespace base {
+
+// Default hash function of flat_hash_map and flat_hash_set. Same as std::hash,
+// except that string keys can also be hashed as string pieces and vector keys
+// of integral elements as spans, so that lookups don't need to construct a
+// key_type.
+template <class Key, class = void>
+struct FlatHashDefaultHash : std::hash<Key> {};
+
+template <class CharT, class Traits, class Alloc>
+struct FlatHashDefaultHash<std::basic_string<CharT, Traits, Alloc>> {
+  using is_transparent = void;
+  size_t operator()(BasicStringPiece<CharT, Traits> key) const {
+    return FastHash(as_bytes(make_span(key.data(), key.size())));
+  }
+};
+
+template <class T, class Alloc>
+struct FlatHashDefaultHash<std::vector<T, Alloc>,
+                           std::enable_if_t<std::is_integral<T>::value>> {
+  using is_transparent = void;
+  size_t operator()(span<const T> key) const {
+    return FastHash(as_bytes(key));
+  }
+};
+
+// Default key equality of flat_hash_map and flat_hash_set, transparent for the
+// same key types as FlatHashDefaultHash.
+template <class Key, class = void>
+struct FlatHashDefaultEq : std::equal_to<Key> {};
+
+template <class CharT, class Traits, class Alloc>
+struct FlatHashDefaultEq<std::basic_string<CharT, Traits, Alloc>> {
+  using is_transparent = void;
+  bool operator()(BasicStringPiece<CharT, Traits> lhs,
+                  BasicStringPiece<CharT, Traits> rhs) const {
+    return lhs == rhs;
+  }
+};
+
+template <class T, class Alloc>
+struct FlatHashDefaultEq<std::vector<T, Alloc>,
+                         std::enable_if_t<std::is_integral<T>::value>> {
+  using is_transparent = void;
+  bool operator()(span<const T> lhs, span<const T> rhs) const {
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+  }
+};
+
+namespace internal {
+
+// Every slot of a flat_hash_table has a control byte. Empty and deleted slots
+// have negative control bytes; a full slot stores the low 7 bits of its hash
+// (H2), so that a whole group of slots can be matched against a hash with a
+// few instructions before any key is compared.
+using HashCtrl = int8_t;
+constexpr HashCtrl kHashCtrlEmpty = -128;
+constexpr HashCtrl kHashCtrlDeleted = -2;
+
+inline bool IsHashCtrlFull(HashCtrl ctrl) {
+  return ctrl >= 0;
+}
+
+// The set of slots of a group that matched a query. Each slot is represented
+// by 2^|Shift| bits of |T|, of which only the highest one may be set.
+template <class T, int Width, int Shift>
+class HashGroupBitMask {
+ public:
+  explicit HashGroupBitMask(T mask) : mask_(mask) {}
+
+  explicit operator bool() const { return mask_ != 0; }
+
+  // Index of the first matching slot. The mask must not be empty.
+  size_t LowestBitSet() const {
+    return static_cast<size_t>(bits::CountTrailingZeroBits(mask_)) >> Shift;
+  }
+  void ClearLowestBit() { mask_ &= mask_ - 1; }
+
+  // Number of non-matching slots at the start and at the end of the group.
+  size_t TrailingZeros() const {
+    return static_cast<size_t>(bits::CountTrailingZeroBits(mask_)) >> Shift;
+  }
+  size_t LeadingZeros() const {
+    constexpr int kExtraBits = sizeof(T) * 8 - (Width << Shift);
+    return static_cast<size_t>(bits::CountLeadingZeroBits(mask_) -
+                               kExtraBits) >>
+           Shift;
+  }
+
+ private:
+  T mask_;
+};
+
+#if defined(ARCH_CPU_X86_FAMILY) && !defined(OS_NACL)
+// Matches 16 control bytes at once with SSE2, which every x86 CPU Chrome runs
+// on supports.
+class HashGroupSse2 {
+ public:
+  static constexpr size_t kWidth = 16;
+  using BitMask = HashGroupBitMask<uint16_t, kWidth, 0>;
+
+  explicit HashGroupSse2(const HashCtrl* ctrl)
+      : ctrl_(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl))) {}
+
+  BitMask Match(HashCtrl h2) const { return MatchByte(h2); }
+  BitMask MatchEmpty() const { return MatchByte(kHashCtrlEmpty); }
+  // Empty and deleted control bytes are the negative ones.
+  BitMask MatchEmptyOrDeleted() const {
+    return BitMask(static_cast<uint16_t>(_mm_movemask_epi8(ctrl_)));
+  }
+
+ private:
+  BitMask MatchByte(HashCtrl value) const {
+    return BitMask(static_cast<uint16_t>(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(value), ctrl_))));
+  }
+
+  __m128i ctrl_;
+};
+#endif  // defined(ARCH_CPU_X86_FAMILY) && !defined(OS_NACL)
+
+// Matches 8 control bytes at once with 64-bit arithmetic. Used on CPUs without
+// a specialized group, and in tests.
+class HashGroupPortable {
+ public:
+  static constexpr size_t kWidth = 8;
+  using BitMask = HashGroupBitMask<uint64_t, kWidth, 3>;
+
+  explicit HashGroupPortable(const HashCtrl* ctrl) {
+    // Slot i of the group maps to byte i of |ctrl_|.
+    static_assert(ARCH_CPU_LITTLE_ENDIAN, "Big-endian is not supported.");
+    memcpy(&ctrl_, ctrl, sizeof(ctrl_));
+  }
+
+  // May report a slot following a true match as a false positive, which is
+  // harmless since keys are compared anyway.
+  BitMask Match(HashCtrl h2) const {
+    uint64_t x = ctrl_ ^ (kLsbs * static_cast<uint8_t>(h2));
+    return BitMask((x - kLsbs) & ~x & kMsbs);
+  }
+  // kHashCtrlEmpty is the only control byte with the highest bit set and
+  // bit 1 cleared.
+  BitMask MatchEmpty() const { return BitMask(ctrl_ & (~ctrl_ << 6) & kMsbs); }
+  BitMask MatchEmptyOrDeleted() const { return BitMask(ctrl_ & kMsbs); }
+
+ private:
+  static constexpr uint64_t kLsbs = 0x0101010101010101ull;
+  static constexpr uint64_t kMsbs = 0x8080808080808080ull;
+
+  uint64_t ctrl_;
+};
+
+#if defined(ARCH_CPU_X86_FAMILY) && !defined(OS_NACL)
+using HashGroup = HashGroupSse2;
+#else
+using HashGroup = HashGroupPortable;
+#endif
+
+// Spreads the entropy of |hash| over all of its bits. std::hash of integers
+// and pointers is typically the identity, while the table takes the slot index
+// from the high bits and the control byte from the low bits.
+inline size_t MixHash(size_t hash) {
+  uint64_t mixed = hash;
+  mixed ^= mixed >> 33;
+  mixed *= 0xff51afd7ed558ccdull;
+  mixed ^= mixed >> 33;
+  return static_cast<size_t>(mixed);
+}
+
+// flat_hash_table is the open-addressing hash table backing flat_hash_map and
+// flat_hash_set, modeled after Abseil's "Swiss table".
+//
+// Elements are stored inline in an array of slots, in no particular order,
+// next to an array of one control byte per slot (see HashCtrl). A lookup
+// probes the table group by group, starting at the group selected by the high
+// bits of the hash: all slots of a group whose control byte matches the low
+// bits of the hash are compared to the key, and the lookup ends at the first
+// group that has an empty slot. Groups are read at any slot offset; the
+// control bytes of the first |Group::kWidth| slots are mirrored after the end
+// of the array so that a group never has to wrap around.
+//
+// Erasing an element marks its slot deleted rather than empty, unless no
+// probe sequence could have gone past it. Deleted slots are reused by
+// insertions and dropped when the table is rehashed.
+//
+// The table grows to double its capacity when it would be more than 7/8 full.
+// Capacities are powers of two.
+//
+// Iterators, pointers and references are invalidated by insertions that cause
+// a rehash, i.e. when size() reaches the value it had when capacity() last
+// changed plus the growth left at that time. Erase only invalidates iterators
+// to the erased element.
+template <class Key,
+          class Value,
+          class GetKeyFromValue,
+          class Hash,
+          class KeyEqual,
+          class Group = HashGroup>
+class flat_hash_table {
+ private:
+  // Elements of a set are their own key and must not be modified in place.
+  static constexpr bool kConstIterators = std::is_same<Key, Value>::value;
+
+  template <bool kIsConst>
+  class Iterator;
+
+ public:
+  using key_type = Key;
+  using value_type = Value;
+  using hasher = Hash;
+  using key_equal = KeyEqual;
+  using size_type = size_t;
+  using difference_type = ptrdiff_t;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using pointer = value_type*;
+  using const_pointer = const value_type*;
+  using iterator = Iterator<kConstIterators>;
+  using const_iterator = Iterator<true>;
+
+  // --------------------------------------------------------------------------
+  // Lifetime.
+
+  flat_hash_table() = default;
+
+  explicit flat_hash_table(size_t bucket_count,
+                           const Hash& hash = Hash(),
+                           const KeyEqual& key_equal = KeyEqual());
+
+  template <class InputIterator>
+  flat_hash_table(InputIterator first,
+                  InputIterator last,
+                  size_t bucket_count = 0,
+                  const Hash& hash = Hash(),
+                  const KeyEqual& key_equal = KeyEqual());
+
+  flat_hash_table(std::initializer_list<value_type> ilist,
+                  size_t bucket_count = 0,
+                  const Hash& hash = Hash(),
+                  const KeyEqual& key_equal = KeyEqual());
+
+  flat_hash_table(const flat_hash_table& other);
+  flat_hash_table(flat_hash_table&& other) noexcept;
+
+  ~flat_hash_table();
+
+  // --------------------------------------------------------------------------
+  // Assignments.
+
+  flat_hash_table& operator=(const flat_hash_table& other);
+  flat_hash_table& operator=(flat_hash_table&& other) noexcept;
+  flat_hash_table& operator=(std::initializer_list<value_type> ilist);
+
+  // --------------------------------------------------------------------------
+  // Memory management.
+  //
+  // reserve(n) makes room for |n| elements in total without rehashing.
+  // rehash(n) rehashes to a capacity that holds at least |n| slots and all the
+  // current elements; rehash(0) shrinks the table to fit.
+
+  void reserve(size_t new_size);
+  void rehash(size_t new_capacity);
+  size_t capacity() const { return capacity_; }
+  size_t bucket_count() const { return capacity_; }
+  float load_factor() const {
+    return capacity_ ? static_cast<float>(size_) / capacity_ : 0.0f;
+  }
+
+  // --------------------------------------------------------------------------
+  // Size management.
+  //
+  // clear() destroys all elements but keeps the allocated slots.
+
+  void clear();
+
+  size_t size() const { return size_; }
+  size_t max_size() const { return std::numeric_limits<size_t>::max() / 2; }
+  bool empty() const { return size_ == 0; }
+
+  // --------------------------------------------------------------------------
+  // Iterators.
+  //
+  // Iteration order is unspecified and changes across rehashes.
+
+  iterator begin() { return MakeIterator<iterator>(0, /*skip=*/true); }
+  const_iterator begin() const {
+    return MakeIterator<const_iterator>(0, /*skip=*/true);
+  }
+  const_iterator cbegin() const { return begin(); }
+
+  iterator end() { return MakeIterator<iterator>(capacity_, /*skip=*/false); }
+  const_iterator end() const {
+    return MakeIterator<const_iterator>(capacity_, /*skip=*/false);
+  }
+  const_iterator cend() const { return end(); }
+
+  // --------------------------------------------------------------------------
+  // Insert operations.
+
+  std::pair<iterator, bool> insert(const value_type& val);
+  std::pair<iterator, bool> insert(value_type&& val);
+
+  iterator insert(const_iterator hint, const value_type& val) {
+    return insert(val).first;
+  }
+  iterator insert(const_iterator hint, value_type&& val) {
+    return insert(std::move(val)).first;
+  }
+
+  template <class InputIterator>
+  void insert(InputIterator first, InputIterator last);
+  void insert(std::initializer_list<value_type> ilist) {
+    insert(ilist.begin(), ilist.end());
+  }
+
+  template <class... Args>
+  std::pair<iterator, bool> emplace(Args&&... args);
+
+  template <class... Args>
+  iterator emplace_hint(const_iterator hint, Args&&... args) {
+    return emplace(std::forward<Args>(args)...).first;
+  }
+
+  // --------------------------------------------------------------------------
+  // Erase operations.
+
+  iterator erase(iterator position);
+  // Only defined when the iterator types differ, to avoid redefinition.
+  template <class DummyT = void,
+            class = std::enable_if_t<!kConstIterators, DummyT>>
+  iterator erase(const_iterator position) {
+    return erase(MutableIterator(position));
+  }
+  iterator erase(const_iterator first, const_iterator last);
+  template <class K>
+  size_t erase(const K& key);
+
+  // --------------------------------------------------------------------------
+  // Search operations.
+  //
+  // If both the hasher and key_equal are transparent (define is_transparent),
+  // the key may be any type they accept, e.g. a base::StringPiece for
+  // std::string keys, or a base::span for std::vector keys.
+
+  template <class K>
+  size_t count(const K& key) const {
+    return contains(key) ? 1 : 0;
+  }
+
+  template <class K>
+  iterator find(const K& key);
+
+  template <class K>
+  const_iterator find(const K& key) const;
+
+  template <class K>
+  bool contains(const K& key) const {
+    return FindIndex(key) != capacity_;
+  }
+
+  template <class K>
+  std::pair<iterator, iterator> equal_range(const K& key);
+
+  template <class K>
+  std::pair<const_iterator, const_iterator> equal_range(const K& key) const;
+
+  // --------------------------------------------------------------------------
+  // General operations.
+
+  hasher hash_function() const { return hash_; }
+  key_equal key_eq() const { return key_equal_; }
+
+  void swap(flat_hash_table& other) noexcept;
+
+  // Estimates the memory allocated by the table itself, not counting the
+  // memory owned by its elements.
+  size_t EstimateTableMemoryUsage() const {
+    return capacity_ ? NumCtrlBytes(capacity_) + capacity_ * sizeof(value_type)
+                     : 0;
+  }
+
+  friend bool operator==(const flat_hash_table& lhs,
+                         const flat_hash_table& rhs) {
+    if (lhs.size() != rhs.size())
+      return false;
+    for (const value_type& value : lhs) {
+      const_iterator found = rhs.find(GetKeyFromValue()(value));
+      if (found == rhs.end() || !(*found == value))
+        return false;
+    }
+    return true;
+  }
+
+  friend bool operator!=(const flat_hash_table& lhs,
+                         const flat_hash_table& rhs) {
+    return !(lhs == rhs);
+  }
+
+ protected:
+  // Inserts a value constructed from |args| if there is no element with
+  // |key|, and returns the element with |key|.
+  template <class K, class... Args>
+  std::pair<iterator, bool> emplace_key_args(const K& key, Args&&... args);
+
+  // Transparent lookups require both the hasher and key_equal to be
+  // transparent. Otherwise a key_type is constructed once per lookup.
+  template <class K>
+  using KeyTypeOrK = typename std::conditional<
+      IsTransparentCompare<hasher>::value &&
+          IsTransparentCompare<key_equal>::value,
+      K,
+      key_type>::type;
+
+ private:
+  // Iterates over the slots of a probe sequence. Groups are visited in
+  // triangular steps, which reaches every group of a power of two capacity.
+  class ProbeSeq {
+   public:
+    ProbeSeq(size_t hash, size_t mask)
+        : mask_(mask), offset_((hash >> 7) & mask) {}
+
+    size_t offset() const { return offset_; }
+    size_t offset(size_t i) const { return (offset_ + i) & mask_; }
+    size_t index() const { return index_; }
+
+    void Next() {
+      index_ += Group::kWidth;
+      offset_ = (offset_ + index_) & mask_;
+    }
+
+   private:
+    size_t mask_;
+    size_t offset_;
+    size_t index_ = 0;
+  };
+
+  static HashCtrl H2(size_t hash) { return static_cast<HashCtrl>(hash & 0x7f); }
+
+  static size_t NumCtrlBytes(size_t capacity) {
+    return capacity + Group::kWidth;
+  }
+
+  // The number of elements a table of |capacity| holds before it grows. At
+  // least one slot stays empty so that probing terminates.
+  static size_t CapacityToGrowth(size_t capacity) {
+    return capacity < 8 ? capacity - 1 : capacity - capacity / 8;
+  }
+
+  static size_t GrowthToCapacity(size_t growth) {
+    size_t capacity = kMinCapacity;
+    while (CapacityToGrowth(capacity) < growth)
+      capacity *= 2;
+    return capacity;
+  }
+
+  static constexpr size_t kMinCapacity = 4;
+
+  template <class K>
+  size_t HashOf(const K& key) const {
+    const KeyTypeOrK<K>& key_ref = key;
+    return MixHash(hash_(key_ref));
+  }
+
+  template <class It>
+  It MakeIterator(size_t index, bool skip) const {
+    It it(ctrl_ + index, ctrl_ + capacity_, slots_ + index);
+    if (skip)
+      it.SkipEmptyOrDeleted();
+    return it;
+  }
+
+  iterator MutableIterator(const_iterator it) {
+    return MakeIterator<iterator>(static_cast<size_t>(it.ctrl_ - ctrl_),
+                                  /*skip=*/false);
+  }
+
+  // Returns the index of the element with |key|, or capacity_ if there is
+  // none.
+  template <class K>
+  size_t FindIndex(const K& key) const {
+    return capacity_ ? FindIndex(key, HashOf(key)) : capacity_;
+  }
+  template <class K>
+  size_t FindIndex(const K& key, size_t hash) const;
+
+  // Returns the index of the first empty or deleted slot of |hash|'s probe
+  // sequence.
+  size_t FindFirstNonFull(size_t hash) const;
+
+  // Claims a slot for a new element with |hash|, growing the table if needed.
+  // The caller constructs the element in the returned slot.
+  size_t PrepareInsert(size_t hash);
+
+  void SetCtrl(size_t index, HashCtrl ctrl) {
+    ctrl_[index] = ctrl;
+    // Mirror the control byte to every position after the end of the array
+    // that a group may read as slot |index|.
+    for (size_t mirror = index; mirror < Group::kWidth; mirror += capacity_)
+      ctrl_[capacity_ + mirror] = ctrl;
+  }
+
+  // Whether no probe sequence could have passed the full slot at |index|
+  // without stopping, i.e. whether the slot may become empty when erased.
+  bool WasNeverFull(size_t index) const;
+
+  void EraseAt(size_t index);
+
+  void Resize(size_t new_capacity);
+  void GrowIfNecessary();
+
+  void DestroyAndDeallocate();
+
+  HashCtrl* ctrl_ = nullptr;
+  value_type* slots_ = nullptr;
+  size_t capacity_ = 0;
+  size_t size_ = 0;
+  // Number of elements that can be inserted into empty slots before growing.
+  size_t growth_left_ = 0;
+
+  NO_UNIQUE_ADDRESS hasher hash_;
+  NO_UNIQUE_ADDRESS key_equal key_equal_;
+};
+
+// ----------------------------------------------------------------------------
+// Iterator.
+
+template <class Key, class Value, class GetKeyFromValue, class Hash,
+          class KeyEqual, class Group>
+template <bool kIsConst>
+class flat_hash_table<Key, Value, GetKeyFromValue, Hash, KeyEqual, Group>::
+    Iterator {
+ public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = Value;
+  using difference_type = ptrdiff_t;
+  using pointer = std::conditional_t<kIsConst, const Value*, Value*>;
+  using reference = std::conditional_t<kIsConst, const Value&, Value&>;
+
+  Iterator() = default;
+
+  // Converts an iterator to a const_iterator.
+  template <bool kOtherIsConst,
+            class = std::enable_if_t<kIsConst && !kOtherIsConst>>
+  Iterator(const Iterator<kOtherIsConst>& other)  // NOLINT
+      : ctrl_(other.ctrl_), ctrl_end_(other.ctrl_end_), slot_(other.slot_) {}
+
+  reference operator*() const {
+    DCHECK(ctrl_ != ctrl_end_ && IsHashCtrlFull(*ctrl_));
+    return *slot_;
+  }
+  pointer operator->() const { return &**this; }
+
+  Iterator& operator++() {
+    DCHECK(ctrl_ != ctrl_end_);
+    ++ctrl_;
+    ++slot_;
+    SkipEmptyOrDeleted();
+    return *this;
+  }
+  Iterator operator++(int) {
+    Iterator tmp = *this;
+    ++*this;
+    return tmp;
+  }
+
+  friend bool operator==(const Iterator& lhs, const Iterator& rhs) {
+    return lhs.ctrl_ == rhs.ctrl_;
+  }
+  friend bool operator!=(const Iterator& lhs, const Iterator& rhs) {
+    return !(lhs == rhs);
+  }
+
+ private:
+  friend class flat_hash_table;
+  friend class Iterator<!kIsConst>;
+
+  Iterator(const HashCtrl* ctrl, const HashCtrl* ctrl_end, Value* slot)
+      : ctrl_(ctrl), ctrl_end_(ctrl_end), slot_(slot) {}
+
+  void SkipEmptyOrDeleted() {
+    while (ctrl_ != ctrl_end_ && !IsHashCtrlFull(*ctrl_)) {
+      ++ctrl_;
+      ++slot_;
+    }
+  }
+
+  const HashCtrl* ctrl_ = nullptr;
+  const HashCtrl* ctrl_end_ = nullptr;
+  Value* slot_ = nullptr;
+};
+
+// ----------------------------------------------------------------------------
+// Lifetime.
+
+template <class Key, class Value, class GetKeyFromValue, class Hash,
+          class KeyEqual, class Group>
+flat_hash_table<Key, Value, GetKeyFromValue, Hash, KeyEqual, Group>::
+    flat_hash_table(size_t bucket_count,
+                    const Hash& hash,
+                    const KeyEqual& key_equal)
+    : hash_(hash), key_equal_(key_equal) {
+  if (bucket_count)
+    Resize(GrowthToCapacity(bucket_count));
+}
+
+template <class Key, class Value, class GetKeyFromValue, class Hash,
+          class KeyEqual, class Group>
+template <class InputIterator>
+flat_hash_table<Key, Value, GetKeyFromValue, Hash, KeyEqual, Group>::
+    flat_hash_table(InputIterator first,
+                    InputIterator last,
+                    size_t bucket_count,
+                    const Hash& hash,
+                    const KeyEqual& key_equal)
+    : flat_hash_table(bucket_count, hash, key_equal) {
+  insert(first, last);
+}
+
+template <class Key, class Value, class GetKeyFromValue, class Hash,
+          class KeyEqual, class Group>
+flat_hash_table<Key, Value, GetKeyFromValue, Hash, KeyEqual, Group>::
+    flat_hash_table(std::initializer_list<value_type> ilist,
+                    size_t bucket_count,
+                    const Hash& hash,
+                    const KeyEqual& key_equal)
+    : flat_hash_table(ilist.begin(), ilist.end(), bucket_count, hash,
+                      key_equal) {}
+
+template <class Key, class Value, class GetKeyFromValue, class Hash,
+          class KeyEqual, class Group>
+flat_hash_table<Key, Value, GetKeyFromValue, Hash, KeyEqual, Group>::
+    flat_hash_table(const flat_hash_table& other)
+    : flat_hash_table(other.size(), other.hash_, other.key_equal_) {
+  for (const value_type& value : other) {
+    size_t index = PrepareInsert(HashOf(GetKeyFromValue()(value)));
+    new (slots_ + index) value_type(value);
+  }
+}
+
+template <class Key, class Value, class GetKeyFromValue, class Hash,
+          class KeyEqual, class Group>
+flat_hash_table<Key, Value, GetKeyFromValue, Hash, KeyEqual, Group>::
+    flat_hash_table(flat_hash_table&& other) noexcept
+    : ctrl_(std::exchange(other.ctrl_, nullptr)),
+      slots_(std::exchange(other.slots_, nullptr)),
+      capacity_(std::exchange(other.capacity_, 0)),
+      size_(std::exchange(other.size_, 0)),
+      growth_left_(std::exchange(other.growth_left_, 0)),
+      hash_(other.hash_),
+      key_equal_(other.key_equal_) {}
+
+template <class Key, class Value, class GetKeyFromValue, class Hash,
+          class KeyEqual, class Group>
+flat_hash_table<Key, Value, GetKeyFromValue, Hash, KeyEqual, Group>::
+    ~flat_hash_table() {
+  DestroyAndDeallocate();
+}
+
+// ----------------------------------------------------------------------------
+// Assignments.
+
+template <class Key, class Value, class GetKeyFromValue, class Hash,
+          class KeyEqual, class Group>
+auto flat_hash_table<Key, Value, GetKeyFromValue, Hash, KeyEqual, Group>::
+operator=(const flat_hash_table& other) -> flat_hash_table& {
+  if (this != &other) {
+    flat_hash_table copy(other);
+    swap(copy);
+  }
+  return *this;
+}
+
+template <class Key, class Value, class GetKeyFromValue, class Hash,
+          class KeyEqual, class Group>
+auto flat_hash_table<Key, Value, GetKeyFromValue, Hash, KeyEqual, Group>::
+operator=(flat_hash_table&& other) noexcept -> flat_hash_table& {
+  if (this != &other) {
+    DestroyAndDeallocate();
+    ctrl_ = std::exchange(other.ctrl_, nullptr);
+    slots_ = std::exchange(other.slots_, nullptr);
+    capacity_ = std::exchange(other.capacity_, 0);
+    size_ = std::exchange(other.size_, 0);
+    growth_left_ = std::exchange(other.growth_left_, 0);
+    hash_ = other.hash_;
+    key_equal_ = other.key_equal_;
+  }
+  return *this;
+}
+
+template <class Key, class Value, class GetKeyFromValue, class Hash,
+          class KeyEqual, class Group>
+auto flat_hash_table<Key, Value, GetKeyFromValue, Hash, KeyEqual, Group>::
+operator=(std::initializer_list<value_type> ilist) -> flat_hash_table& {
+  clear();
+  insert(ilist);
+  return *this;
+}
+
+// ----------------------------------------------------------------------------
+// Memory management.
+
+template <class Key, class Value, class GetKeyFromValue, class Hash,
+          class KeyEqual, class Group>
+void flat_hash_table<Key, Value, GetKeyFromValue, Hash, KeyEqual, Group>::
+    reserve(size_t new_size) {
+  if (new_size > size_ + growth_left_)
+    Resize(GrowthToCapacity(new_size));
+}
+
+template <class Key, class Value, class GetKeyFromValue, class Hash,
+          class KeyEqual, class Group>
+void flat_hash_table<Key, Value, GetKeyFromValue, Hash, KeyEqual, Group>::
+    rehash(size_t new_capacity) {
+  if (new_capacity == 0 && size_ == 0) {
+    DestroyAndDeallocate();
+    return;
+  }
+  size_t capacity = std::max(GrowthToCapacity(size_), kMinCapacity);
+  while (capacity < new_capacity)
+    capacity *= 2;
+  Resize(capacity);
+}
+
+// ----------------------------------------------------------------------------
+// Size management.
+
+template <class Key, class Value, class GetKeyFromValue, class Hash,
+          class KeyEqual, class Group>
+void flat_hash_table<Key, Value, GetKeyFromValue, Hash, KeyEqual, Group>::
+    clear() {
+  if (!capacity_)
+    return;
+  for (size_t i = 0; i < capacity_; ++i) {
+    if (IsHashCtrlFull(ctrl_[i]))
+      slots_[i].~value_type();
+  }
+  memset(ctrl_, kHashCtrlEmpty, NumCtrlBytes(capacity_));
+  size_ = 0;
+  growth_left_ = CapacityToGrowth(capacity_);
+}
+
+// ----------------------------------------------------------------------------
+// Insert operations.
+
+template <class Key, class Value, class GetKeyFromValue, class Hash,
+          class KeyEqual, class Group>
+auto flat_hash_table<Key, Value, GetKeyFromValue, Hash, KeyEqual, Group>::
+    insert(const value_type& val) -> std::pair<iterator, bool> {
+  return emplace_key_args(GetKeyFromValue()(val), val);
+}
+
+template <class Key, class Value, class GetKeyFromValue, class Hash,
+          class KeyEqual, class Group>
+auto flat_hash_table<Key, Value, GetKeyFromValue, Hash, KeyEqual, Group>::
+    insert(value_type&& val) -> std::pair<iterator, bool> {
+  return emplace_key_args(GetKeyFromValue()(val), std::move(val));
+}
+
+template <class Key, class Value, class GetKeyFromValue, class Hash,
+          class KeyEqual, class Group>
+template <class InputIterator>
+void flat_hash_table<Key, Value, GetKeyFromValue, Hash, KeyEqual, Group>::
+    insert(InputIterator first, InputIterator last) {
+  if (is_multipass<InputIterator>())
+    reserve(size_ + static_cast<size_t>(std::distance(first, last)));
+  for (; first != last; ++first)
+    insert(*first);
+}
+
+template <class Key, class Value, class GetKeyFromValue, class Hash,
+          class KeyEqual, class Group>
+template <class... Args>
+auto flat_hash_table<Key, Value, GetKeyFromValue, Hash, KeyEqual, Group>::
+    emplace(Args&&... args) -> std::pair<iterator, bool> {
+  value_type new_value(std::forward<Args>(args)...);
+  return insert(std::move(new_value));
+}
+
+template <class Key, class Value, class GetKeyFromValue, class Hash,
+          class KeyEqual, class Group>
+template <class K, class... Args>
+auto flat_hash_table<Key, Value, GetKeyFromValue, Hash, KeyEqual, Group>::
+    emplace_key_args(const K& key, Args&&... args)
+        -> std::pair<iterator, bool> {
+  size_t hash = HashOf(key);
+  if (capacity_) {
+    size_t index = FindIndex(key, hash);
+    if (index != capacity_)
+      return {MakeIterator<iterator>(index, /*skip=*/false), false};
+  }
+  size_t index = PrepareInsert(hash);
+  new (slots_ + index) value_type(std::forward<Args>(args)...);
+  return {MakeIterator<iterator>(index, /*skip=*/false), true};
+}
+
+// ----------------------------------------------------------------------------
+// Erase operations.
+
+template <class Key, class Value, class GetKeyFromValue, class Hash,
+          class KeyEqual, class Group>
+auto flat_hash_table<Key, Value, GetKeyFromValue, Hash, KeyEqual, Group>::
+    erase(iterator position) -> iterator {
+  CHECK(position != end());
+  size_t index = static_cast<size_t>(position.ctrl_ - ctrl_);
+  ++position;
+  EraseAt(index);
+  return position;
+}
+
+template <class Key, class Value, class GetKeyFromValue, class Hash,
+          class KeyEqual, class Group>
+auto flat_hash_table<Key, Value, GetKeyFromValue, Hash, KeyEqual, Group>::
+    erase(const_iterator first, const_iterator last) -> iterator {
+  while (first != last) {
+    size_t index = static_cast<size_t>(first.ctrl_ - ctrl_);
+    ++first;
+    EraseAt(index);
+  }
+  return MutableIterator(last);
+}
+
+template <class Key, class Value, class GetKeyFromValue, class Hash,
+          class KeyEqual, class Group>
+template <class K>
+size_t flat_hash_table<Key, Value, GetKeyFromValue, Hash, KeyEqual, Group>::
+    erase(const K& key) {
+  size_t index = FindIndex(key);
+  if (index == capacity_)
+    return 0;
+  EraseAt(index);
+  return 1;
+}
+
+// ----------------------------------------------------------------------------
+// Search operations.
+
+template <class Key, class Value, class GetKeyFromValue, class Hash,
+          class KeyEqual, class Group>
+template <class K>
+auto flat_hash_table<Key, Value, GetKeyFromValue, Hash, KeyEqual, Group>::find(
+    const K& key) -> iterator {
+  return MakeIterator<iterator>(FindIndex(key), /*skip=*/false);
+}
+
+template <class Key, class Value, class GetKeyFromValue, class Hash,
+          class KeyEqual, class Group>
+template <class K>
+auto flat_hash_table<Key, Value, GetKeyFromValue, Hash, KeyEqual, Group>::find(
+    const K& key) const -> const_iterator {
+  return MakeIterator<const_iterator>(FindIndex(key), /*skip=*/false);
+}
+
+template <class Key, class Value, class GetKeyFromValue, class Hash,
+          class KeyEqual, class Group>
+template <class K>
+auto flat_hash_table<Key, Value, GetKeyFromValue, Hash, KeyEqual, Group>::
+    equal_range(const K& key) -> std::pair<iterator, iterator> {
+  iterator found = find(key);
+  if (found == end())
+    return {found, found};
+  return {found, std::next(found)};
+}
+
+template <class Key, class Value, class GetKeyFromValue, class Hash,
+          class KeyEqual, class Group>
+template <class K>
+auto flat_hash_table<Key, Value, GetKeyFromValue, Hash, KeyEqual, Group>::
+    equal_range(const K& key) const
+    -> std::pair<const_iterator, const_iterator> {
+  const_iterator found = find(key);
+  if (found == end())
+    return {found, found};
+  return {found, std::next(found)};
+}
+
+// ----------------------------------------------------------------------------
+// General operations.
+
+template <class Key, class Value, class GetKeyFromValue, class Hash,
+          class KeyEqual, class Group>
+void flat_hash_table<Key, Value, GetKeyFromValue, Hash, KeyEqual, Group>::swap(
+    flat_hash_table& other) noexcept {
+  std::swap(ctrl_, other.ctrl_);
+  std::swap(slots_, other.slots_);
+  std::swap(capacity_, other.capacity_);
+  std::swap(size_, other.size_);
+  std::swap(growth_left_, other.growth_left_);
+  std::swap(hash_, other.hash_);
+  std::swap(key_equal_, other.key_equal_);
+}
+
+// ----------------------------------------------------------------------------
+// Internal implementation.
+
+template <class Key, class Value, class GetKeyFromValue, class Hash,
+          class KeyEqual, class Group>
+template <class K>
+size_t flat_hash_table<Key, Value, GetKeyFromValue, Hash, KeyEqual, Group>::
+    FindIndex(const K& key, size_t hash) const {
+  DCHECK(capacity_);
+  const KeyTypeOrK<K>& key_ref = key;
+  ProbeSeq seq(hash, capacity_ - 1);
+  while (true) {
+    Group group(ctrl_ + seq.offset());
+    for (auto match = group.Match(H2(hash)); match; match.ClearLowestBit()) {
+      size_t index = seq.offset(match.LowestBitSet());
+      if (LIKELY(key_equal_(GetKeyFromValue()(slots_[index]), key_ref)))
+        return index;
+    }
+    if (group.MatchEmpty())
+      return capacity_;
+    seq.Next();
+    DCHECK_LE(seq.index(), capacity_) << "Full table";
+  }
+}
+
+template <class Key, class Value, class GetKeyFromValue, class Hash,
+          class KeyEqual, class Group>
+size_t flat_hash_table<Key, Value, GetKeyFromValue, Hash, KeyEqual, Group>::
+    FindFirstNonFull(size_t hash) const {
+  ProbeSeq seq(hash, capacity_ - 1);
+  while (true) {
+    auto match = Group(ctrl_ + seq.offset()).MatchEmptyOrDeleted();
+    if (match)
+      return seq.offset(match.LowestBitSet());
+    seq.Next();
+    DCHECK_LE(seq.index(), capacity_) << "Full table";
+  }
+}
+
+template <class Key, class Value, class GetKeyFromValue, class Hash,
+          class KeyEqual, class Group>
+size_t flat_hash_table<Key, Value, GetKeyFromValue, Hash, KeyEqual, Group>::
+    PrepareInsert(size_t hash) {
+  size_t index = capacity_ ? FindFirstNonFull(hash) : 0;
+  // Reusing a deleted slot doesn't use up growth.
+  if (!capacity_ || (growth_left_ == 0 && ctrl_[index] != kHashCtrlDeleted)) {
+    GrowIfNecessary();
+    index = FindFirstNonFull(hash);
+  }
+  ++size_;
+  if (ctrl_[index] == kHashCtrlEmpty) {
+    DCHECK_GT(growth_left_, 0u);
+    --growth_left_;
+  }
+  SetCtrl(index, H2(hash));
+  return index;
+}
+
+template <class Key, class Value, class GetKeyFromValue, class Hash,
+          class KeyEqual, class Group>
+bool flat_hash_table<Key, Value, GetKeyFromValue, Hash, KeyEqual, Group>::
+    WasNeverFull(size_t index) const {
+  // A single group covers the whole table, so every lookup inspects every
+  // slot before checking for empty ones.
+  if (capacity_ <= Group::kWidth)
+    return true;
+  // Otherwise, a probe sequence only passes a group without stopping if the
+  // group has no empty slot. Check the slots around |index|.
+  const size_t index_before = (index - Group::kWidth) & (capacity_ - 1);
+  auto empty_before = Group(ctrl_ + index_before).MatchEmpty();
+  auto empty_after = Group(ctrl_ + index).MatchEmpty();
+  return empty_before && empty_after &&
+         empty_after.TrailingZeros() + empty_before.LeadingZeros() <
+             Group::kWidth;
+}
+
+template <class Key, class Value, class GetKeyFromValue, class Hash,
+          class KeyEqual, class Group>
+void flat_hash_table<Key, Value, GetKeyFromValue, Hash, KeyEqual, Group>::
+    EraseAt(size_t index) {
+  DCHECK(IsHashCtrlFull(ctrl_[index]));
+  slots_[index].~value_type();
+  --size_;
+  if (WasNeverFull(index)) {
+    SetCtrl(index, kHashCtrlEmpty);
+    ++growth_left_;
+  } else {
+    SetCtrl(index, kHashCtrlDeleted);
+  }
+}
+
+template <class Key, class Value, class GetKeyFromValue, class Hash,
+          class KeyEqual, class Group>
+void flat_hash_table<Key, Value, GetKeyFromValue, Hash, KeyEqual, Group>::
+    Resize(size_t new_capacity) {
+  DCHECK(bits::IsPowerOfTwo(new_capacity));
+  DCHECK_GE(CapacityToGrowth(new_capacity), size_);
+
+  HashCtrl* old_ctrl = ctrl_;
+  value_type* old_slots = slots_;
+  size_t old_capacity = capacity_;
+
+  ctrl_ = new HashCtrl[NumCtrlBytes(new_capacity)];
+  memset(ctrl_, kHashCtrlEmpty, NumCtrlBytes(new_capacity));
+  slots_ = std::allocator<value_type>().allocate(new_capacity);
+  capacity_ = new_capacity;
+  growth_left_ = CapacityToGrowth(new_capacity) - size_;
+
+  for (size_t i = 0; i < old_capacity; ++i) {
+    if (!IsHashCtrlFull(old_ctrl[i]))
+      continue;
+    size_t hash = HashOf(GetKeyFromValue()(old_slots[i]));
+    size_t index = FindFirstNonFull(hash);
+    SetCtrl(index, H2(hash));
+    new (slots_ + index) value_type(std::move(old_slots[i]));
+    old_slots[i].~value_type();
+  }
+
+  if (old_capacity) {
+    delete[] old_ctrl;
+    std::allocator<value_type>().deallocate(old_slots, old_capacity);
+  }
+}
+
+template <class Key, class Value, class GetKeyFromValue, class Hash,
+          class KeyEqual, class Group>
+void flat_hash_table<Key, Value, GetKeyFromValue, Hash, KeyEqual, Group>::
+    GrowIfNecessary() {
+  if (!capacity_) {
+    Resize(kMinCapacity);
+  } else if (capacity_ > Group::kWidth && size_ * 32 <= capacity_ * 25) {
+    // Growth was used up by deleted slots: rehash to drop them instead of
+    // growing, as long as that leaves a reasonable amount of growth. Small
+    // tables never have deleted slots (see WasNeverFull()).
+    Resize(capacity_);
+  } else {
+    Resize(capacity_ * 2);
+  }
+}
+
+template <class Key, class Value, class GetKeyFromValue, class Hash,
+          class KeyEqual, class Group>
+void flat_hash_table<Key, Value, GetKeyFromValue, Hash, KeyEqual, Group>::
+    DestroyAndDeallocate() {
+  if (!capacity_)
+    return;
+  for (size_t i = 0; i < capacity_; ++i) {
+    if (IsHashCtrlFull(ctrl_[i]))
+      slots_[i].~value_type();
+  }
+  delete[] ctrl_;
+  std::allocator<value_type>().deallocate(slots_, capacity_);
+  ctrl_ = nullptr;
+  slots_ = nullptr;
+  capacity_ = 0;
+  size_ = 0;
+  growth_left_ = 0;
+}
+
+}  // namespace internal
+
+}  // namespace base
+
+#endif  // BASE_CONTAINERS_FLAT_HASH_TABLE_H_
@@ -0,0 +1,522 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// This file contains a Least Recently Used cache bounded by the total size of
+// its entries rather than by their count, as computed by a caller-provided
+// size function (e.g. a number of bytes).
+//
+// Unlike LRUCache, entries are not allocated one by one: they live in a pool
+// of nodes linked by index, which are recycled as entries are evicted, and
+// the key index is a flat_hash_map. Once the cache has reached its steady
+// state size (or after Reserve()), Put() reuses the memory of the entries it
+// evicts rather than allocating.
+//
+// The cache can optionally segment its entries to resist scans: see
+// LRUCachePolicy.
+
+#ifndef BASE_CONTAINERS_SIZED_LRU_CACHE_H_
+#define BASE_CONTAINERS_SIZED_LRU_CACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "base/check.h"
+#include "base/check_op.h"
+#include "base/compiler_specific.h"
+#include "base/containers/flat_hash_map.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
+
+namespace base {
+
+// Eviction policy of a SizedLRUCache.
+enum class LRUCachePolicy {
+  // Plain LRU: Put() and Get() move the entry to the front of the recency
+  // list, and the least recently used entries are evicted first.
+  kLRU,
+
+  // Segmented LRU, a variant of 2Q. New entries go to a probationary segment,
+  // and are promoted to a protected segment (holding up to 80% of the budget)
+  // when they are accessed again with Get(). Entries are evicted from the
+  // probationary segment first, and the least recently used protected entries
+  // are demoted back to it when the protected segment is full. A scan over
+  // many keys that are used once thus only evicts other probationary entries,
+  // not the working set.
+  kSegmented,
+};
+
+// Statistics of a SizedLRUCache, e.g. for memory-infra dumps.
+struct LRUCacheStats {
+  size_t entry_count = 0;
+  // Sum of the sizes of the entries, and limit of that sum (0 without limit).
+  // They are numbers of entries if |sizes_are_entry_counts|, and otherwise
+  // the units of the size function, which are usually bytes.
+  size_t used_size = 0;
+  size_t max_size = 0;
+  bool sizes_are_entry_counts = false;
+  // Number of Get() calls that found an entry, and that didn't.
+  size_t hit_count = 0;
+  size_t miss_count = 0;
+  // Number of entries evicted to fit in the budget.
+  size_t eviction_count = 0;
+  // Memory allocated by the cache itself, not counting the memory owned by
+  // the keys and payloads.
+  size_t table_memory_usage = 0;
+};
+
+// Default size function of SizedLRUCache: every entry has a size of 1, so the
+// cache is bounded by its number of entries.
+struct LRUCacheEntryCount {
+  template <class KeyType, class PayloadType>
+  size_t operator()(const KeyType&, const PayloadType&) const {
+    return 1;
+  }
+};
+
+// SizedLRUCache ---------------------------------------------------------------
+
+// |SizeOfType| is a functor returning the size of an entry given its key and
+// payload. It is called once when the entry is inserted: the size of an entry
+// must not change while it is in the cache (Put() it again instead).
+template <class KeyType,
+          class PayloadType,
+          class SizeOfType = LRUCacheEntryCount,
+          class HashType = FlatHashDefaultHash<KeyType>>
+class SizedLRUCache {
+ public:
+  // The payload of the list. This maintains a copy of the key so we can
+  // efficiently delete things given an element of the list.
+  using value_type = std::pair<KeyType, PayloadType>;
+  using size_type = size_t;
+
+ private:
+  using NodeIndex = uint32_t;
+
+  // |nodes_[kHead]| is the sentinel of the circular recency list.
+  static constexpr NodeIndex kHead = 0;
+  static constexpr NodeIndex kNoNode = std::numeric_limits<NodeIndex>::max();
+
+  struct Node {
+    absl::optional<value_type> value;
+    size_t size = 0;
+    NodeIndex prev = kHead;
+    // Next node in the recency list, or in the free list if |value| is empty.
+    NodeIndex next = kHead;
+    bool is_protected = false;
+  };
+
+  template <bool kIsConst>
+  class Iterator;
+
+ public:
+  using iterator = Iterator<false>;
+  using const_iterator = Iterator<true>;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  enum { NO_AUTO_EVICT = 0 };
+
+  // The max_size is the total size at which the cache will prune its members
+  // to when a new item is inserted. If the caller wants to manage this itself,
+  // it can pass NO_AUTO_EVICT to not restrict the cache size.
+  explicit SizedLRUCache(size_type max_size,
+                         LRUCachePolicy policy = LRUCachePolicy::kLRU,
+                         const SizeOfType& size_of = SizeOfType())
+      : max_size_(max_size), policy_(policy), size_of_(size_of) {
+    nodes_.emplace_back();
+  }
+
+  SizedLRUCache(const SizedLRUCache&) = delete;
+  SizedLRUCache& operator=(const SizedLRUCache&) = delete;
+
+  ~SizedLRUCache() = default;
+
+  size_type max_size() const { return max_size_; }
+  LRUCachePolicy policy() const { return policy_; }
+
+  // Returns the sum of the sizes of the entries.
+  size_type used_size() const { return used_size_; }
+
+  // Changes the maximum total size, evicting entries if needed.
+  void SetMaxSize(size_type max_size) {
+    max_size_ = max_size;
+    if (max_size_ != NO_AUTO_EVICT)
+      ShrinkToSize(max_size_);
+    DemoteOverflow();
+  }
+
+  // Allocates memory for |count| entries, so that the cache doesn't allocate
+  // until it holds more entries than that.
+  void Reserve(size_type count) {
+    nodes_.reserve(count + 1);
+    index_.reserve(count);
+  }
+
+  // Inserts a payload item with the given key. If an existing item has the
+  // same key, it is removed prior to insertion. Least recently used items are
+  // evicted until the new item fits in max_size(). An iterator indicating the
+  // inserted item will be returned, or end() if the item is bigger than
+  // max_size() on its own, in which case it isn't inserted (but an existing
+  // item with the same key is still removed).
+  //
+  // The payload will be forwarded.
+  //
+  // This invalidates the references to all the entries, and the iterators to
+  // the evicted entries (see begin()).
+  template <typename Payload>
+  iterator Put(const KeyType& key, Payload&& payload);
+
+  // Retrieves the contents of the given key, or end() if not found. This method
+  // has the side effect of moving the requested item to the front of the
+  // recency list (and of the protected segment, see LRUCachePolicy).
+  iterator Get(const KeyType& key);
+
+  // Retrieves the payload associated with a given key and returns it via
+  // result without affecting the ordering (unlike Get()).
+  iterator Peek(const KeyType& key) {
+    auto index_iter = index_.find(key);
+    if (index_iter == index_.end())
+      return end();
+    return iterator(this, index_iter->second);
+  }
+
+  const_iterator Peek(const KeyType& key) const {
+    auto index_iter = index_.find(key);
+    if (index_iter == index_.end())
+      return end();
+    return const_iterator(this, index_iter->second);
+  }
+
+  // Erases the item referenced by the given iterator. An iterator to the item
+  // following it will be returned. The iterator must be valid.
+  iterator Erase(iterator pos) {
+    DCHECK(pos.cache_ == this);
+    CHECK_NE(pos.node_, kHead);
+    NodeIndex next = nodes_[pos.node_].next;
+    EraseNode(pos.node_);
+    return iterator(this, next);
+  }
+
+  // SizedLRUCache entries are often processed in reverse order, so we add this
+  // convenience function (not typically defined by STL containers).
+  reverse_iterator Erase(reverse_iterator pos) {
+    // We have to actually give it the incremented iterator to delete, since
+    // the forward iterator that base() returns is actually one past the item
+    // being iterated over.
+    return reverse_iterator(Erase((++pos).base()));
+  }
+
+  // Evicts the least recently used items until the total size of the cache is
+  // at most |new_size|.
+  void ShrinkToSize(size_type new_size) {
+    while (used_size_ > new_size) {
+      EraseNode(nodes_[kHead].prev);
+      ++eviction_count_;
+    }
+  }
+
+  // Deletes everything from the cache. The memory used by the cache itself is
+  // kept for new items.
+  void Clear();
+
+  // Returns the number of elements in the cache.
+  size_type size() const { return index_.size(); }
+
+  bool empty() const { return index_.empty(); }
+
+  // Allows iteration over the list. Forward iteration starts with the most
+  // recent item and works backwards, i.e. reverse iteration visits items in
+  // eviction order.
+  //
+  // Unlike with LRUCache, the entries live in a vector which grows as the
+  // cache does:
+  // - References and pointers obtained from an iterator (operator* and
+  //   operator->) are invalidated by Put(), which may reallocate the nodes,
+  //   as well as by the eviction or erasure of their entry.
+  // - Iterators remain valid as other entries are inserted or deleted, but an
+  //   iterator to an entry that is evicted (by Put(), SetMaxSize() or
+  //   ShrinkToSize()) or erased must not be used anymore, as its node may be
+  //   reused by another entry.
+  iterator begin() { return iterator(this, nodes_[kHead].next); }
+  const_iterator begin() const {
+    return const_iterator(this, nodes_[kHead].next);
+  }
+  iterator end() { return iterator(this, kHead); }
+  const_iterator end() const { return const_iterator(this, kHead); }
+
+  reverse_iterator rbegin() { return reverse_iterator(end()); }
+  const_reverse_iterator rbegin() const {
+    return const_reverse_iterator(end());
+  }
+  reverse_iterator rend() { return reverse_iterator(begin()); }
+  const_reverse_iterator rend() const {
+    return const_reverse_iterator(begin());
+  }
+
+  LRUCacheStats GetStats() const;
+
+  // Estimates the memory allocated by the cache itself, not counting the
+  // memory owned by its keys and payloads.
+  size_t EstimateTableMemoryUsage() const {
+    return nodes_.capacity() * sizeof(Node) + index_.EstimateTableMemoryUsage();
+  }
+
+ private:
+  // Maximum total size of the protected segment, which is unbounded along
+  // with the cache.
+  size_type ProtectedMaxSize() const {
+    if (max_size_ == NO_AUTO_EVICT)
+      return std::numeric_limits<size_type>::max();
+    return max_size_ - max_size_ / 5;
+  }
+
+  void Unlink(NodeIndex node) {
+    nodes_[nodes_[node].prev].next = nodes_[node].next;
+    nodes_[nodes_[node].next].prev = nodes_[node].prev;
+  }
+
+  void LinkBefore(NodeIndex position, NodeIndex node) {
+    nodes_[node].next = position;
+    nodes_[node].prev = nodes_[position].prev;
+    nodes_[nodes_[position].prev].next = node;
+    nodes_[position].prev = node;
+  }
+
+  NodeIndex AllocateNode() {
+    if (free_head_ != kNoNode) {
+      NodeIndex node = free_head_;
+      free_head_ = nodes_[node].next;
+      return node;
+    }
+    CHECK_LT(nodes_.size(), static_cast<size_t>(kNoNode));
+    nodes_.emplace_back();
+    return static_cast<NodeIndex>(nodes_.size() - 1);
+  }
+
+  void EraseNode(NodeIndex node);
+
+  // Moves |node| to the front of the protected segment.
+  void Touch(NodeIndex node);
+
+  // Moves the least recently used protected entries to the probationary
+  // segment until the protected segment fits in its budget.
+  void DemoteOverflow();
+
+  // The recency list holds the protected segment followed by the probationary
+  // segment, which starts at |probation_head_| (kHead if it is empty). With
+  // LRUCachePolicy::kLRU, all entries are protected.
+  std::vector<Node> nodes_;
+  NodeIndex probation_head_ = kHead;
+  NodeIndex free_head_ = kNoNode;
+  flat_hash_map<KeyType, NodeIndex, HashType> index_;
+
+  size_type max_size_;
+  size_type used_size_ = 0;
+  size_type protected_size_ = 0;
+  const LRUCachePolicy policy_;
+  NO_UNIQUE_ADDRESS SizeOfType size_of_;
+
+  size_t hit_count_ = 0;
+  size_t miss_count_ = 0;
+  size_t eviction_count_ = 0;
+};
+
+template <class KeyType, class PayloadType, class SizeOfType, class HashType>
+template <bool kIsConst>
+class SizedLRUCache<KeyType, PayloadType, SizeOfType, HashType>::Iterator {
+ public:
+  using iterator_category = std::bidirectional_iterator_tag;
+  using value_type = typename SizedLRUCache::value_type;
+  using difference_type = ptrdiff_t;
+  using pointer = std::conditional_t<kIsConst, const value_type*, value_type*>;
+  using reference =
+      std::conditional_t<kIsConst, const value_type&, value_type&>;
+
+  Iterator() = default;
+
+  // Converts an iterator to a const_iterator.
+  template <bool kOtherIsConst,
+            class = std::enable_if_t<kIsConst && !kOtherIsConst>>
+  Iterator(const Iterator<kOtherIsConst>& other)  // NOLINT
+      : cache_(other.cache_), node_(other.node_) {}
+
+  reference operator*() const {
+    DCHECK_NE(node_, kHead);
+    return *cache_->nodes_[node_].value;
+  }
+  pointer operator->() const { return &**this; }
+
+  Iterator& operator++() {
+    node_ = cache_->nodes_[node_].next;
+    return *this;
+  }
+  Iterator operator++(int) {
+    Iterator tmp = *this;
+    ++*this;
+    return tmp;
+  }
+  Iterator& operator--() {
+    node_ = cache_->nodes_[node_].prev;
+    return *this;
+  }
+  Iterator operator--(int) {
+    Iterator tmp = *this;
+    --*this;
+    return tmp;
+  }
+
+  friend bool operator==(const Iterator& lhs, const Iterator& rhs) {
+    return lhs.node_ == rhs.node_;
+  }
+  friend bool operator!=(const Iterator& lhs, const Iterator& rhs) {
+    return !(lhs == rhs);
+  }
+
+ private:
+  friend class SizedLRUCache;
+  friend class Iterator<!kIsConst>;
+
+  using CachePointer =
+      std::conditional_t<kIsConst, const SizedLRUCache*, SizedLRUCache*>;
+
+  Iterator(CachePointer cache, NodeIndex node) : cache_(cache), node_(node) {}
+
+  CachePointer cache_ = nullptr;
+  NodeIndex node_ = kHead;
+};
+
+template <class KeyType, class PayloadType, class SizeOfType, class HashType>
+template <typename Payload>
+auto SizedLRUCache<KeyType, PayloadType, SizeOfType, HashType>::Put(
+    const KeyType& key,
+    Payload&& payload) -> iterator {
+  // Remove any existing payload with that key.
+  auto index_iter = index_.find(key);
+  if (index_iter != index_.end())
+    EraseNode(index_iter->second);
+
+  const size_type size = size_of_(key, payload);
+  if (max_size_ != NO_AUTO_EVICT) {
+    if (size > max_size_)
+      return end();
+    // Kick the oldest things out to make room for the new item.
+    ShrinkToSize(max_size_ - size);
+  }
+
+  NodeIndex node = AllocateNode();
+  nodes_[node].value.emplace(key, std::forward<Payload>(payload));
+  nodes_[node].size = size;
+  used_size_ += size;
+  index_.emplace(key, node);
+
+  if (policy_ == LRUCachePolicy::kLRU) {
+    nodes_[node].is_protected = true;
+    protected_size_ += size;
+    LinkBefore(nodes_[kHead].next, node);
+  } else {
+    nodes_[node].is_protected = false;
+    LinkBefore(probation_head_, node);
+    probation_head_ = node;
+  }
+  return iterator(this, node);
+}
+
+template <class KeyType, class PayloadType, class SizeOfType, class HashType>
+auto SizedLRUCache<KeyType, PayloadType, SizeOfType, HashType>::Get(
+    const KeyType& key) -> iterator {
+  auto index_iter = index_.find(key);
+  if (index_iter == index_.end()) {
+    ++miss_count_;
+    return end();
+  }
+  ++hit_count_;
+  Touch(index_iter->second);
+  return iterator(this, index_iter->second);
+}
+
+template <class KeyType, class PayloadType, class SizeOfType, class HashType>
+void SizedLRUCache<KeyType, PayloadType, SizeOfType, HashType>::Clear() {
+  index_.clear();
+  nodes_.resize(1);
+  nodes_[kHead].prev = nodes_[kHead].next = kHead;
+  probation_head_ = kHead;
+  free_head_ = kNoNode;
+  used_size_ = 0;
+  protected_size_ = 0;
+}
+
+template <class KeyType, class PayloadType, class SizeOfType, class HashType>
+LRUCacheStats SizedLRUCache<KeyType, PayloadType, SizeOfType, HashType>::
+    GetStats() const {
+  LRUCacheStats stats;
+  stats.entry_count = size();
+  stats.used_size = used_size_;
+  stats.max_size = max_size_;
+  stats.sizes_are_entry_counts =
+      std::is_same<SizeOfType, LRUCacheEntryCount>::value;
+  stats.hit_count = hit_count_;
+  stats.miss_count = miss_count_;
+  stats.eviction_count = eviction_count_;
+  stats.table_memory_usage = EstimateTableMemoryUsage();
+  return stats;
+}
+
+template <class KeyType, class PayloadType, class SizeOfType, class HashType>
+void SizedLRUCache<KeyType, PayloadType, SizeOfType, HashType>::EraseNode(
+    NodeIndex node) {
+  DCHECK_NE(node, kHead);
+  Node& entry = nodes_[node];
+  if (probation_head_ == node)
+    probation_head_ = entry.next;
+  if (entry.is_protected)
+    protected_size_ -= entry.size;
+  used_size_ -= entry.size;
+  Unlink(node);
+  index_.erase(entry.value->first);
+  entry.value.reset();
+  entry.next = free_head_;
+  free_head_ = node;
+}
+
+template <class KeyType, class PayloadType, class SizeOfType, class HashType>
+void SizedLRUCache<KeyType, PayloadType, SizeOfType, HashType>::Touch(
+    NodeIndex node) {
+  Node& entry = nodes_[node];
+  if (!entry.is_protected) {
+    if (probation_head_ == node)
+      probation_head_ = entry.next;
+    entry.is_protected = true;
+    protected_size_ += entry.size;
+  }
+  if (nodes_[kHead].next != node) {
+    Unlink(node);
+    LinkBefore(nodes_[kHead].next, node);
+  }
+  DemoteOverflow();
+}
+
+template <class KeyType, class PayloadType, class SizeOfType, class HashType>
+void SizedLRUCache<KeyType, PayloadType, SizeOfType, HashType>::
+    DemoteOverflow() {
+  if (policy_ != LRUCachePolicy::kSegmented)
+    return;
+  while (protected_size_ > ProtectedMaxSize()) {
+    // The least recently used protected entry precedes the probationary
+    // segment, so demoting it only moves the segment boundary.
+    NodeIndex node = nodes_[probation_head_].prev;
+    DCHECK(nodes_[node].is_protected);
+    nodes_[node].is_protected = false;
+    protected_size_ -= nodes_[node].size;
+    probation_head_ = node;
+  }
+}
+
+}  // namespace base
+
+#endif  // BASE_CONTAINERS_SIZED_LRU_CACHE_H_
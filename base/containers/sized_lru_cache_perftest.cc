@@ -0,0 +1,111 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/containers/sized_lru_cache.h"
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "base/containers/lru_cache.h"
+#include "base/rand_util.h"
+#include "base/strings/stringprintf.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+// This file compares SizedLRUCache against HashingLRUCache on a lookup-or-
+// insert workload where most lookups are for a hot working set, interleaved
+// with scans of keys that are only used once.
+
+namespace base {
+
+namespace {
+
+constexpr char kMetricPrefixLRUCache[] = "LRUCache.";
+constexpr char kMetricTimePerOperation[] = "time_per_operation";
+constexpr char kMetricHitRate[] = "hit_rate";
+
+constexpr size_t kCacheSize = 1000;
+constexpr size_t kNumOperations = 1000000;
+
+perf_test::PerfResultReporter SetUpReporter(const std::string& story_name) {
+  perf_test::PerfResultReporter reporter(kMetricPrefixLRUCache, story_name);
+  reporter.RegisterImportantMetric(kMetricTimePerOperation, "ns");
+  reporter.RegisterImportantMetric(kMetricHitRate, "%");
+  return reporter;
+}
+
+// Generates the keys to look up, drawn from a working set of 3/4 of the cache
+// size. If |with_scans|, about 10% of the keys are part of scans of unique
+// keys, each half the cache size long.
+std::vector<uint64_t> MakeWorkload(bool with_scans) {
+  constexpr size_t kWorkingSetSize = kCacheSize * 3 / 4;
+  constexpr size_t kScanSize = kCacheSize / 2;
+  std::vector<uint64_t> keys;
+  keys.reserve(kNumOperations);
+  uint64_t next_scan_key = kWorkingSetSize;
+  while (keys.size() < kNumOperations) {
+    if (with_scans && RandInt(0, static_cast<int>(kScanSize * 9)) == 0) {
+      for (size_t i = 0; i < kScanSize && keys.size() < kNumOperations; ++i)
+        keys.push_back(next_scan_key++);
+    } else {
+      keys.push_back(RandGenerator(kWorkingSetSize));
+    }
+  }
+  return keys;
+}
+
+template <class Cache>
+void RunCachePerfTest(const std::string& story_name,
+                      Cache& cache,
+                      const std::vector<uint64_t>& keys) {
+  size_t hits = 0;
+  TimeTicks start = TimeTicks::Now();
+  for (uint64_t key : keys) {
+    if (cache.Get(key) != cache.end())
+      ++hits;
+    else
+      cache.Put(key, key);
+  }
+  TimeDelta elapsed = TimeTicks::Now() - start;
+
+  auto reporter = SetUpReporter(story_name);
+  reporter.AddResult(kMetricTimePerOperation,
+                     static_cast<double>(elapsed.InNanoseconds()) /
+                         keys.size());
+  reporter.AddResult(kMetricHitRate, 100.0 * hits / keys.size());
+}
+
+void RunAllCachePerfTests(bool with_scans) {
+  const std::vector<uint64_t> keys = MakeWorkload(with_scans);
+  const char* workload = with_scans ? "WithScans" : "WorkingSet";
+  {
+    HashingLRUCache<uint64_t, uint64_t> cache(kCacheSize);
+    RunCachePerfTest(StringPrintf("HashingLRUCache_%s", workload), cache, keys);
+  }
+  {
+    SizedLRUCache<uint64_t, uint64_t> cache(kCacheSize);
+    RunCachePerfTest(StringPrintf("SizedLRUCache_%s", workload), cache, keys);
+  }
+  {
+    SizedLRUCache<uint64_t, uint64_t> cache(kCacheSize,
+                                            LRUCachePolicy::kSegmented);
+    RunCachePerfTest(StringPrintf("SizedLRUCacheSegmented_%s", workload),
+                     cache, keys);
+  }
+}
+
+}  // namespace
+
+TEST(SizedLRUCachePerfTest, WorkingSet) {
+  RunAllCachePerfTests(/*with_scans=*/false);
+}
+
+TEST(SizedLRUCachePerfTest, WithScans) {
+  RunAllCachePerfTests(/*with_scans=*/true);
+}
+
+}  // namespace base
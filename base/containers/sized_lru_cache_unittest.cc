@@ -0,0 +1,284 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/containers/sized_lru_cache.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "testing/gmock/include/gmock/gmock.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+int cached_item_live_count = 0;
+
+struct CachedItem {
+  CachedItem() : value(0) { cached_item_live_count++; }
+
+  explicit CachedItem(int new_value) : value(new_value) {
+    cached_item_live_count++;
+  }
+
+  CachedItem(const CachedItem& other) : value(other.value) {
+    cached_item_live_count++;
+  }
+
+  CachedItem(CachedItem&& other) : value(other.value) {
+    cached_item_live_count++;
+  }
+
+  CachedItem& operator=(const CachedItem& other) = default;
+
+  ~CachedItem() { cached_item_live_count--; }
+
+  int value;
+};
+
+// Sizes std::string payloads by their length.
+struct StringSize {
+  size_t operator()(int key, const std::string& payload) const {
+    return payload.size();
+  }
+};
+
+using StringCache = SizedLRUCache<int, std::string, StringSize>;
+
+// Returns the keys of |cache| from the most to the least recently used.
+template <class Cache>
+std::vector<int> Keys(const Cache& cache) {
+  std::vector<int> keys;
+  for (const auto& item : cache)
+    keys.push_back(item.first);
+  return keys;
+}
+
+}  // namespace
+
+TEST(SizedLRUCacheTest, Basic) {
+  using Cache = SizedLRUCache<int, CachedItem>;
+  Cache cache(Cache::NO_AUTO_EVICT);
+
+  EXPECT_TRUE(cache.Get(0) == cache.end());
+  EXPECT_TRUE(cache.Peek(0) == cache.end());
+
+  auto inserted = cache.Put(5, CachedItem(10));
+  EXPECT_TRUE(inserted == cache.begin());
+  cache.Put(7, CachedItem(12));
+  EXPECT_EQ(2u, cache.size());
+  EXPECT_EQ(2u, cache.used_size());
+  EXPECT_EQ(2, cached_item_live_count);
+
+  // 5 is the oldest, until it is accessed with Get().
+  EXPECT_EQ(5, cache.rbegin()->first);
+  EXPECT_EQ(10, cache.Peek(5)->second.value);
+  EXPECT_EQ(5, cache.rbegin()->first);
+  EXPECT_EQ(10, cache.Get(5)->second.value);
+  EXPECT_EQ(7, cache.rbegin()->first);
+
+  // Replacing an item moves it to the front.
+  cache.Put(7, CachedItem(13));
+  EXPECT_EQ(13, cache.begin()->second.value);
+  EXPECT_EQ(2u, cache.size());
+  EXPECT_EQ(2, cached_item_live_count);
+
+  cache.Erase(cache.begin());
+  EXPECT_EQ(1u, cache.size());
+  EXPECT_EQ(1, cached_item_live_count);
+
+  cache.Clear();
+  EXPECT_TRUE(cache.empty());
+  EXPECT_EQ(0, cached_item_live_count);
+}
+
+TEST(SizedLRUCacheTest, EvictsToCount) {
+  SizedLRUCache<int, int> cache(3);
+  for (int i = 0; i < 5; ++i)
+    cache.Put(i, i);
+  EXPECT_THAT(Keys(cache), testing::ElementsAre(4, 3, 2));
+  EXPECT_EQ(2u, cache.GetStats().eviction_count);
+}
+
+TEST(SizedLRUCacheTest, EvictsToSize) {
+  StringCache cache(10);
+  cache.Put(1, "aaaa");
+  cache.Put(2, "bbbb");
+  EXPECT_EQ(8u, cache.used_size());
+
+  // Needs to evict 1 only.
+  cache.Put(3, "ccc");
+  EXPECT_THAT(Keys(cache), testing::ElementsAre(3, 2));
+  EXPECT_EQ(7u, cache.used_size());
+
+  // Needs to evict both 2 and 3.
+  cache.Put(4, "dddddddd");
+  EXPECT_THAT(Keys(cache), testing::ElementsAre(4));
+  EXPECT_EQ(8u, cache.used_size());
+
+  // Too big on its own: not inserted.
+  EXPECT_TRUE(cache.Put(5, "eeeeeeeeeee") == cache.end());
+  EXPECT_THAT(Keys(cache), testing::ElementsAre(4));
+
+  cache.SetMaxSize(5);
+  EXPECT_TRUE(cache.empty());
+  EXPECT_EQ(0u, cache.used_size());
+}
+
+TEST(SizedLRUCacheTest, ReplaceUpdatesSize) {
+  StringCache cache(StringCache::NO_AUTO_EVICT);
+  cache.Put(1, "a");
+  cache.Put(1, "aaaaa");
+  EXPECT_EQ(5u, cache.used_size());
+  cache.Put(1, "aa");
+  EXPECT_EQ(2u, cache.used_size());
+  cache.Erase(cache.Peek(1));
+  EXPECT_EQ(0u, cache.used_size());
+}
+
+TEST(SizedLRUCacheTest, ShrinkToSize) {
+  StringCache cache(StringCache::NO_AUTO_EVICT);
+  for (int i = 0; i < 10; ++i)
+    cache.Put(i, "xx");
+  EXPECT_EQ(20u, cache.used_size());
+  cache.ShrinkToSize(7);
+  EXPECT_THAT(Keys(cache), testing::ElementsAre(9, 8, 7));
+}
+
+TEST(SizedLRUCacheTest, ReverseIterationAndErase) {
+  SizedLRUCache<int, int> cache(SizedLRUCache<int, int>::NO_AUTO_EVICT);
+  for (int i = 0; i < 6; ++i)
+    cache.Put(i, i);
+  // Erase the odd keys, oldest first.
+  for (auto it = cache.rbegin(); it != cache.rend();) {
+    if (it->first % 2)
+      it = cache.Erase(it);
+    else
+      ++it;
+  }
+  EXPECT_THAT(Keys(cache), testing::ElementsAre(4, 2, 0));
+}
+
+TEST(SizedLRUCacheTest, IteratorsSurviveInserts) {
+  SizedLRUCache<int, std::unique_ptr<int>> cache(100);
+  cache.Put(0, std::make_unique<int>(0));
+  auto it = cache.Peek(0);
+  for (int i = 1; i < 100; ++i)
+    cache.Put(i, std::make_unique<int>(i));
+  EXPECT_EQ(0, it->first);
+  EXPECT_EQ(0, *it->second);
+}
+
+TEST(SizedLRUCacheTest, ReusesNodes) {
+  SizedLRUCache<int, int> cache(16);
+  cache.Reserve(16);
+  size_t memory_usage = cache.EstimateTableMemoryUsage();
+  for (int i = 0; i < 1000; ++i)
+    cache.Put(i, i);
+  EXPECT_EQ(16u, cache.size());
+  EXPECT_EQ(memory_usage, cache.EstimateTableMemoryUsage());
+}
+
+TEST(SizedLRUCacheTest, Stats) {
+  SizedLRUCache<int, int> cache(2);
+  cache.Put(1, 1);
+  cache.Put(2, 2);
+  cache.Put(3, 3);
+  cache.Get(1);
+  cache.Get(2);
+  cache.Get(3);
+
+  LRUCacheStats stats = cache.GetStats();
+  EXPECT_EQ(2u, stats.entry_count);
+  EXPECT_EQ(2u, stats.used_size);
+  EXPECT_EQ(2u, stats.max_size);
+  EXPECT_TRUE(stats.sizes_are_entry_counts);
+  EXPECT_EQ(2u, stats.hit_count);
+  EXPECT_EQ(1u, stats.miss_count);
+  EXPECT_EQ(1u, stats.eviction_count);
+  EXPECT_EQ(cache.EstimateTableMemoryUsage(), stats.table_memory_usage);
+}
+
+TEST(SizedLRUCacheTest, SegmentedPromotesOnGet) {
+  SizedLRUCache<int, int> cache(5, LRUCachePolicy::kSegmented);
+  for (int i = 0; i < 5; ++i)
+    cache.Put(i, i);
+  // Accessed entries move to the protected segment, in front of the
+  // probationary ones.
+  cache.Get(1);
+  cache.Get(3);
+  EXPECT_THAT(Keys(cache), testing::ElementsAre(3, 1, 4, 2, 0));
+
+  // New entries are inserted at the front of the probationary segment, and
+  // evict the oldest probationary entry.
+  cache.Put(5, 5);
+  EXPECT_THAT(Keys(cache), testing::ElementsAre(3, 1, 5, 4, 2));
+}
+
+TEST(SizedLRUCacheTest, SegmentedDemotesOverflow) {
+  // The protected segment holds up to 4 entries.
+  SizedLRUCache<int, int> cache(5, LRUCachePolicy::kSegmented);
+  for (int i = 0; i < 5; ++i)
+    cache.Put(i, i);
+  for (int i = 0; i < 5; ++i)
+    cache.Get(i);
+  // 0 was demoted to the probationary segment, and is evicted first.
+  EXPECT_THAT(Keys(cache), testing::ElementsAre(4, 3, 2, 1, 0));
+  cache.Put(5, 5);
+  EXPECT_THAT(Keys(cache), testing::ElementsAre(4, 3, 2, 1, 5));
+
+  // Shrinking the budget shrinks the protected segment too.
+  cache.SetMaxSize(2);
+  EXPECT_THAT(Keys(cache), testing::ElementsAre(4, 3));
+  cache.Put(6, 6);
+  EXPECT_THAT(Keys(cache), testing::ElementsAre(4, 6));
+}
+
+TEST(SizedLRUCacheTest, SegmentedWithoutLimitKeepsPromotedEntries) {
+  SizedLRUCache<int, int> cache(SizedLRUCache<int, int>::NO_AUTO_EVICT,
+                                LRUCachePolicy::kSegmented);
+  for (int i = 0; i < 3; ++i)
+    cache.Put(i, i);
+  cache.Get(0);
+
+  // 0 stays protected, so new entries are inserted after it.
+  cache.Put(3, 3);
+  EXPECT_THAT(Keys(cache), testing::ElementsAre(0, 3, 2, 1));
+
+  // Probationary entries are evicted first once a limit is set.
+  cache.SetMaxSize(2);
+  EXPECT_THAT(Keys(cache), testing::ElementsAre(0, 3));
+}
+
+TEST(SizedLRUCacheTest, SegmentedResistsScans) {
+  constexpr int kWorkingSetSize = 50;
+  SizedLRUCache<int, int> lru(100);
+  SizedLRUCache<int, int> segmented(100, LRUCachePolicy::kSegmented);
+
+  for (auto* cache : {&lru, &segmented}) {
+    // Make a working set hot.
+    for (int round = 0; round < 2; ++round) {
+      for (int i = 0; i < kWorkingSetSize; ++i) {
+        if (cache->Get(i) == cache->end())
+          cache->Put(i, i);
+      }
+    }
+    // Scan many keys that are used once.
+    for (int i = 1000; i < 1200; ++i)
+      cache->Put(i, i);
+  }
+
+  int lru_hits = 0;
+  int segmented_hits = 0;
+  for (int i = 0; i < kWorkingSetSize; ++i) {
+    lru_hits += lru.Peek(i) != lru.end();
+    segmented_hits += segmented.Peek(i) != segmented.end();
+  }
+  EXPECT_EQ(0, lru_hits);
+  EXPECT_EQ(kWorkingSetSize, segmented_hits);
+}
+
+}  // namespace base
@@ -644,4 +644,17 @@ const CPU& CPU::GetInstanceNoAllocation() {
   return *cpu;
 }
 
+// static
+bool CPU::CanUseAVX2() {
+  static const bool can_use_avx2 = GetInstanceNoAllocation().has_avx2();
+  return can_use_avx2;
+}
+
+// static
+bool CPU::CanUseAVX2AndFMA3() {
+  static const bool can_use_avx2_and_fma3 =
+      CanUseAVX2() && GetInstanceNoAllocation().has_fma3();
+  return can_use_avx2_and_fma3;
+}
+
 }  // namespace base
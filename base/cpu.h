@@ -44,6 +44,16 @@ class BASE_EXPORT CPU final {
   // implications.
   static const CPU& GetInstanceNoAllocation();
 
+  // Returns true if code built with __attribute__((target("avx2"))) can run,
+  // which needs both the CPU and the OS to support AVX2. Chrome is only
+  // compiled for SSE3, so such code, and the intrinsics headers it includes
+  // directly, must only be reached after checking this. The CPU is only
+  // checked once, without allocating, so this can be called on hot paths.
+  static bool CanUseAVX2();
+
+  // Same as CanUseAVX2(), for code that also needs FMA3.
+  static bool CanUseAVX2AndFMA3();
+
   enum IntelMicroArchitecture {
     PENTIUM = 0,
     SSE = 1,
@@ -159,6 +159,12 @@ TEST(CPU, BrandAndVendorContainsNoNUL) {
   EXPECT_FALSE(base::Contains(cpu.vendor_name(), '\0'));
 }
 
+TEST(CPU, CanUseAVX2) {
+  base::CPU cpu;
+  EXPECT_EQ(cpu.has_avx2(), base::CPU::CanUseAVX2());
+  EXPECT_EQ(cpu.has_avx2() && cpu.has_fma3(), base::CPU::CanUseAVX2AndFMA3());
+}
+
 #if defined(ARCH_CPU_X86_FAMILY)
 // Tests that we compute the correct CPU family and model based on the vendor
 // and CPUID signature.
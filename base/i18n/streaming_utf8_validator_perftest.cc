@@ -20,6 +20,7 @@
 #include "base/callback.h"
 #include "base/strings/string_util.h"
 #include "base/strings/stringprintf.h"
+#include "base/strings/utf_string_conversions.h"
 #include "base/test/perf_time_logger.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -42,6 +43,11 @@ const char kThreeByteSeqRangeEnd[] = "\xe9\xbf\x83";    // U+9FC3 "to blink"
 const char kFourByteSeqRangeStart[] = "\xf0\xa0\x80\x8b";  // U+2000B
 const char kFourByteSeqRangeEnd[] = "\xf0\xaa\x9a\xb2";    // U+2A6B2
 
+// Typical of text in Latin scripts: mostly ASCII, with the odd accented
+// letter.
+const char kMostlyASCIISeq[] =
+    "The quick brown fox jumps over the lazy dog at the caf\xc3\xa9. ";
+
 // The different lengths of strings to test.
 const size_t kTestLengths[] = {1, 32, 256, 32768, 1 << 20};
 
@@ -139,10 +145,18 @@ bool IsStringUTF8(const std::string& str) {
   return base::IsStringUTF8(base::StringPiece(str));
 }
 
+// Conversion validates as it goes, so it is compared to validation alone.
+bool ConvertUTF8ToUTF16(const std::string& str) {
+  std::u16string utf16;
+  return base::UTF8ToUTF16(str.data(), str.size(), &utf16);
+}
+
 // IsString7Bit is intentionally placed last so it can be excluded easily.
 const TestFunctionDescription kTestFunctions[] = {
     {&StreamingUtf8Validator::Validate, "StreamingUtf8Validator"},
-    {&IsStringUTF8, "IsStringUTF8"}, {&IsString7Bit, "IsString7Bit"}};
+    {&IsStringUTF8, "IsStringUTF8"},
+    {&ConvertUTF8ToUTF16, "UTF8ToUTF16"},
+    {&IsString7Bit, "IsString7Bit"}};
 
 // Construct a test string from |construct_test_string| for each of the lengths
 // in |kTestLengths| in turn. For each string, run each test in |test_functions|
@@ -173,35 +187,35 @@ TEST(StreamingUtf8ValidatorPerfTest, OneByteRepeated) {
   RunSomeTests(
       "%s: bytes=1 repeated length=%d repeat=%d",
       base::BindRepeating(ConstructRepeatedTestString, kOneByteSeqRangeStart),
-      kTestFunctions, 3);
+      kTestFunctions, 4);
 }
 
 TEST(StreamingUtf8ValidatorPerfTest, OneByteRange) {
   RunSomeTests("%s: bytes=1 ranged length=%d repeat=%d",
                base::BindRepeating(ConstructRangedTestString,
                                    kOneByteSeqRangeStart, kOneByteSeqRangeEnd),
-               kTestFunctions, 3);
+               kTestFunctions, 4);
 }
 
 TEST(StreamingUtf8ValidatorPerfTest, TwoByteRepeated) {
   RunSomeTests(
       "%s: bytes=2 repeated length=%d repeat=%d",
       base::BindRepeating(ConstructRepeatedTestString, kTwoByteSeqRangeStart),
-      kTestFunctions, 2);
+      kTestFunctions, 3);
 }
 
 TEST(StreamingUtf8ValidatorPerfTest, TwoByteRange) {
   RunSomeTests("%s: bytes=2 ranged length=%d repeat=%d",
                base::BindRepeating(ConstructRangedTestString,
                                    kTwoByteSeqRangeStart, kTwoByteSeqRangeEnd),
-               kTestFunctions, 2);
+               kTestFunctions, 3);
 }
 
 TEST(StreamingUtf8ValidatorPerfTest, ThreeByteRepeated) {
   RunSomeTests(
       "%s: bytes=3 repeated length=%d repeat=%d",
       base::BindRepeating(ConstructRepeatedTestString, kThreeByteSeqRangeStart),
-      kTestFunctions, 2);
+      kTestFunctions, 3);
 }
 
 TEST(StreamingUtf8ValidatorPerfTest, ThreeByteRange) {
@@ -209,14 +223,14 @@ TEST(StreamingUtf8ValidatorPerfTest, ThreeByteRange) {
       "%s: bytes=3 ranged length=%d repeat=%d",
       base::BindRepeating(ConstructRangedTestString, kThreeByteSeqRangeStart,
                           kThreeByteSeqRangeEnd),
-      kTestFunctions, 2);
+      kTestFunctions, 3);
 }
 
 TEST(StreamingUtf8ValidatorPerfTest, FourByteRepeated) {
   RunSomeTests(
       "%s: bytes=4 repeated length=%d repeat=%d",
       base::BindRepeating(ConstructRepeatedTestString, kFourByteSeqRangeStart),
-      kTestFunctions, 2);
+      kTestFunctions, 3);
 }
 
 TEST(StreamingUtf8ValidatorPerfTest, FourByteRange) {
@@ -224,7 +238,14 @@ TEST(StreamingUtf8ValidatorPerfTest, FourByteRange) {
       "%s: bytes=4 ranged length=%d repeat=%d",
       base::BindRepeating(ConstructRangedTestString, kFourByteSeqRangeStart,
                           kFourByteSeqRangeEnd),
-      kTestFunctions, 2);
+      kTestFunctions, 3);
+}
+
+TEST(StreamingUtf8ValidatorPerfTest, MostlyASCIIRepeated) {
+  RunSomeTests(
+      "%s: mostly ASCII repeated length=%d repeat=%d",
+      base::BindRepeating(ConstructRepeatedTestString, kMostlyASCIISeq),
+      kTestFunctions, 3);
 }
 
 }  // namespace
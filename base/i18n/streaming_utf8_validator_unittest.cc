@@ -318,6 +318,22 @@ TEST(StreamingUtf8ValidatorTest, ResetWorks) {
   EXPECT_EQ(VALID_ENDPOINT, validator.AddBytes("a", 1));
 }
 
+// Runs of ASCII are skipped in bulk, so check that sequences anywhere in a
+// long run are still looked at.
+TEST(StreamingUtf8ValidatorTest, LongASCIIRuns) {
+  for (size_t pos = 0; pos < 100; ++pos) {
+    std::string text(100, 'a');
+    text.replace(pos, 1, "\xC3\xA9");
+    EXPECT_TRUE(StreamingUtf8Validator::Validate(text));
+    text[pos] = '\xFF';
+    EXPECT_FALSE(StreamingUtf8Validator::Validate(text));
+    text.resize(pos + 1);
+    text[pos] = '\xC3';
+    EXPECT_EQ(VALID_MIDPOINT,
+              StreamingUtf8Validator().AddBytes(text.data(), text.size()));
+  }
+}
+
 TEST_F(StreamingUtf8ValidatorSingleSequenceTest, Valid) {
   CheckRange(valid, valid_end, VALID_ENDPOINT);
 }
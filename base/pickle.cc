@@ -8,6 +8,7 @@
 
 #include <algorithm>  // for max()
 #include <limits>
+#include <utility>
 
 #include "base/bits.h"
 #include "base/numerics/safe_conversions.h"
@@ -217,6 +218,177 @@ bool PickleIterator::ReadBytes(const char** data, int length) {
   return true;
 }
 
+ChunkedPickleIterator::ChunkedPickleIterator(
+    std::vector<span<const char>> chunks)
+    : chunks_(std::move(chunks)) {
+  // Deduce the header size from the data length, like the read-only Pickle
+  // constructor does.
+  size_t data_len = 0;
+  for (const auto& chunk : chunks_)
+    data_len += chunk.size();
+  if (data_len < sizeof(Pickle::Header))
+    return;
+  Pickle::Header header;
+  CopyFromChunks(reinterpret_cast<char*>(&header), sizeof(header));
+  if (header.payload_size > data_len - sizeof(header))
+    return;
+  const size_t header_size = data_len - header.payload_size;
+  if (header_size != bits::AlignUp(header_size, sizeof(uint32_t)))
+    return;
+  CopyFromChunks(nullptr, header_size - sizeof(header));
+  remaining_ = header.payload_size;
+}
+
+ChunkedPickleIterator::~ChunkedPickleIterator() = default;
+
+void ChunkedPickleIterator::CopyFromChunks(char* dest, size_t size) {
+  while (size) {
+    DCHECK_LT(chunk_index_, chunks_.size());
+    const span<const char> chunk = chunks_[chunk_index_];
+    const size_t copy_size = std::min(size, chunk.size() - chunk_offset_);
+    if (dest && copy_size) {
+      memcpy(dest, chunk.data() + chunk_offset_, copy_size);
+      dest += copy_size;
+    }
+    size -= copy_size;
+    chunk_offset_ += copy_size;
+    if (chunk_offset_ == chunk.size()) {
+      ++chunk_index_;
+      chunk_offset_ = 0;
+    }
+  }
+}
+
+bool ChunkedPickleIterator::CopyAndAdvance(void* dest, size_t size) {
+  if (size > remaining_) {
+    remaining_ = 0;
+    return false;
+  }
+  // Like PickleIterator::Advance(), stop at the end if the padding is missing.
+  const size_t padding =
+      std::min(bits::AlignUp(size, sizeof(uint32_t)), remaining_) - size;
+  CopyFromChunks(static_cast<char*>(dest), size);
+  CopyFromChunks(nullptr, padding);
+  remaining_ -= size + padding;
+  return true;
+}
+
+template <typename Type>
+inline bool ChunkedPickleIterator::ReadBuiltinType(Type* result) {
+  return CopyAndAdvance(result, sizeof(*result));
+}
+
+bool ChunkedPickleIterator::ReadBool(bool* result) {
+  // Read the whole int written by Pickle::WriteBool(), rather than a byte that
+  // might not be a valid bool.
+  int value;
+  if (!ReadBuiltinType(&value))
+    return false;
+  *result = value != 0;
+  return true;
+}
+
+bool ChunkedPickleIterator::ReadInt(int* result) {
+  return ReadBuiltinType(result);
+}
+
+bool ChunkedPickleIterator::ReadLong(long* result) {
+  int64_t result_int64 = 0;
+  if (!ReadBuiltinType(&result_int64))
+    return false;
+  *result = base::checked_cast<long>(result_int64);
+  return true;
+}
+
+bool ChunkedPickleIterator::ReadUInt16(uint16_t* result) {
+  return ReadBuiltinType(result);
+}
+
+bool ChunkedPickleIterator::ReadUInt32(uint32_t* result) {
+  return ReadBuiltinType(result);
+}
+
+bool ChunkedPickleIterator::ReadInt64(int64_t* result) {
+  return ReadBuiltinType(result);
+}
+
+bool ChunkedPickleIterator::ReadUInt64(uint64_t* result) {
+  return ReadBuiltinType(result);
+}
+
+bool ChunkedPickleIterator::ReadFloat(float* result) {
+  return ReadBuiltinType(result);
+}
+
+bool ChunkedPickleIterator::ReadDouble(double* result) {
+  return ReadBuiltinType(result);
+}
+
+// The lengths below are checked against the remaining payload before the
+// results are resized, so that a bad length can't cause a huge allocation.
+
+bool ChunkedPickleIterator::ReadString(std::string* result) {
+  int len;
+  if (!ReadLength(&len) || static_cast<size_t>(len) > remaining_) {
+    remaining_ = 0;
+    return false;
+  }
+  result->resize(len);
+  return CopyAndAdvance(&(*result)[0], len);
+}
+
+bool ChunkedPickleIterator::ReadString16(std::u16string* result) {
+  int len;
+  size_t num_bytes;
+  if (!ReadLength(&len) ||
+      !CheckMul(static_cast<size_t>(len), sizeof(char16_t))
+           .AssignIfValid(&num_bytes) ||
+      num_bytes > remaining_) {
+    remaining_ = 0;
+    return false;
+  }
+  result->resize(len);
+  return CopyAndAdvance(&(*result)[0], num_bytes);
+}
+
+bool ChunkedPickleIterator::ReadData(std::vector<char>* result) {
+  int len;
+  if (!ReadLength(&len) || static_cast<size_t>(len) > remaining_) {
+    remaining_ = 0;
+    return false;
+  }
+  result->resize(len);
+  return CopyAndAdvance(result->data(), len);
+}
+
+bool ChunkedPickleIterator::ReadBytes(void* data, int length) {
+  if (length < 0) {
+    remaining_ = 0;
+    return false;
+  }
+  return CopyAndAdvance(data, static_cast<size_t>(length));
+}
+
+void PickleSizer::AddString(const StringPiece& value) {
+  AddInt();
+  AddBytes(static_cast<int>(value.size()));
+}
+
+void PickleSizer::AddString16(const StringPiece16& value) {
+  AddInt();
+  AddBytes(static_cast<int>(value.size() * sizeof(char16_t)));
+}
+
+void PickleSizer::AddData(int length) {
+  DCHECK_GE(length, 0);
+  AddInt();
+  AddBytes(length);
+}
+
+void PickleSizer::AddBytes(int length) {
+  payload_size_ += bits::AlignUp(static_cast<size_t>(length), sizeof(uint32_t));
+}
+
 Pickle::Attachment::Attachment() = default;
 
 Pickle::Attachment::~Attachment() = default;
@@ -330,6 +502,13 @@ void Pickle::Reserve(size_t length) {
     Resize(capacity_after_header_ * 2 + new_size);
 }
 
+void Pickle::Reset() {
+  DCHECK_NE(kCapacityReadOnly, capacity_after_header_)
+      << "oops: pickle is readonly";
+  header_->payload_size = 0;
+  write_offset_ = 0;
+}
+
 bool Pickle::WriteAttachment(scoped_refptr<Attachment> attachment) {
   return false;
 }
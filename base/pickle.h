@@ -9,6 +9,7 @@
 #include <stdint.h>
 
 #include <string>
+#include <vector>
 
 #include "base/base_export.h"
 #include "base/check_op.h"
@@ -109,6 +110,108 @@ class BASE_EXPORT PickleIterator {
   FRIEND_TEST_ALL_PREFIXES(PickleTest, GetReadPointerAndAdvance);
 };
 
+// ChunkedPickleIterator reads data from a Pickle that was received in several
+// discontiguous chunks, such as network or shared memory buffers, without
+// first copying them into one contiguous buffer. The chunks hold the whole
+// Pickle, header included, in order, and must remain valid while the
+// ChunkedPickleIterator is in use.
+//
+// Unlike PickleIterator, values are copied out of the chunks, so there are no
+// methods returning pointers into the data.
+class BASE_EXPORT ChunkedPickleIterator {
+ public:
+  explicit ChunkedPickleIterator(std::vector<span<const char>> chunks);
+  ChunkedPickleIterator(const ChunkedPickleIterator&) = delete;
+  ChunkedPickleIterator& operator=(const ChunkedPickleIterator&) = delete;
+  ~ChunkedPickleIterator();
+
+  // Methods for reading the payload of the Pickle. They behave like those of
+  // PickleIterator, and are compatible with the Pickle write methods.
+  bool ReadBool(bool* result) WARN_UNUSED_RESULT;
+  bool ReadInt(int* result) WARN_UNUSED_RESULT;
+  bool ReadLong(long* result) WARN_UNUSED_RESULT;
+  bool ReadUInt16(uint16_t* result) WARN_UNUSED_RESULT;
+  bool ReadUInt32(uint32_t* result) WARN_UNUSED_RESULT;
+  bool ReadInt64(int64_t* result) WARN_UNUSED_RESULT;
+  bool ReadUInt64(uint64_t* result) WARN_UNUSED_RESULT;
+  bool ReadFloat(float* result) WARN_UNUSED_RESULT;
+  bool ReadDouble(double* result) WARN_UNUSED_RESULT;
+  bool ReadString(std::string* result) WARN_UNUSED_RESULT;
+  bool ReadString16(std::u16string* result) WARN_UNUSED_RESULT;
+
+  // Reads a blob written by Pickle::WriteData().
+  bool ReadData(std::vector<char>* result) WARN_UNUSED_RESULT;
+
+  // Copies |length| bytes written by Pickle::WriteBytes() into |data|.
+  bool ReadBytes(void* data, int length) WARN_UNUSED_RESULT;
+
+  bool ReadLength(int* result) WARN_UNUSED_RESULT {
+    return ReadInt(result) && *result >= 0;
+  }
+
+  bool SkipBytes(int num_bytes) WARN_UNUSED_RESULT {
+    return num_bytes >= 0 &&
+           CopyAndAdvance(nullptr, static_cast<size_t>(num_bytes));
+  }
+
+  bool ReachedEnd() const { return !remaining_; }
+
+ private:
+  template <typename Type>
+  bool ReadBuiltinType(Type* result);
+
+  // Copies the next |size| bytes of payload into |dest|, unless it is null,
+  // and advances past them and their padding. Fails and skips to the end of
+  // the payload if fewer than |size| bytes are left.
+  bool CopyAndAdvance(void* dest, size_t size);
+
+  // Copies the next |size| bytes of the chunks into |dest|, unless it is null.
+  // There must be at least |size| bytes left.
+  void CopyFromChunks(char* dest, size_t size);
+
+  std::vector<span<const char>> chunks_;
+  size_t chunk_index_ = 0;
+  size_t chunk_offset_ = 0;
+  size_t remaining_ = 0;  // Bytes of payload left to read.
+};
+
+// PickleSizer computes the size of the payload that a sequence of Pickle
+// writes will produce, so that a Pickle can be sized with Reserve() before
+// writing to it, instead of growing as values are appended. Each Add
+// method corresponds to the Pickle write method of the same name.
+class BASE_EXPORT PickleSizer {
+ public:
+  PickleSizer() = default;
+  PickleSizer(const PickleSizer&) = delete;
+  PickleSizer& operator=(const PickleSizer&) = delete;
+  ~PickleSizer() = default;
+
+  // Returns the payload size that the writes added so far produce.
+  size_t payload_size() const { return payload_size_; }
+
+  void AddBool() { AddInt(); }
+  void AddInt() { AddPOD<int>(); }
+  void AddLong() { AddPOD<int64_t>(); }
+  void AddUInt16() { AddPOD<uint16_t>(); }
+  void AddUInt32() { AddPOD<uint32_t>(); }
+  void AddInt64() { AddPOD<int64_t>(); }
+  void AddUInt64() { AddPOD<uint64_t>(); }
+  void AddFloat() { AddPOD<float>(); }
+  void AddDouble() { AddPOD<double>(); }
+  void AddString(const StringPiece& value);
+  void AddString16(const StringPiece16& value);
+  void AddData(int length);
+  void AddBytes(int length);
+
+ private:
+  template <typename T>
+  void AddPOD() {
+    AddBytes(sizeof(T));
+  }
+
+  size_t payload_size_ = 0;
+};
+
 // This class provides facilities for basic binary value packing and unpacking.
 //
 // The Pickle class supports appending primitive values (ints, strings, etc.)
@@ -227,9 +330,14 @@ class BASE_EXPORT Pickle {
 
   // Reserves space for upcoming writes when multiple writes will be made and
   // their sizes are computed in advance. It can be significantly faster to call
-  // Reserve() before calling WriteFoo() multiple times.
+  // Reserve() before calling WriteFoo() multiple times. See PickleSizer.
   void Reserve(size_t additional_capacity);
 
+  // Discards the payload, keeping the header and the allocated capacity, so
+  // that one Pickle can be used as an arena to write a series of payloads
+  // without reallocating. Any attachments are left to subclasses to discard.
+  void Reset();
+
   // Payload follows after allocation of Header (header size is customizable).
   struct Header {
     uint32_t payload_size;  // Specifies the size of the payload.
@@ -0,0 +1,244 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/pickle.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "base/strings/stringprintf.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+// This file compares ways of writing a series of Pickles, like the records of
+// a session restore file or a stream of IPC messages, and of reading them
+// back from contiguous and discontiguous buffers.
+
+namespace base {
+
+namespace {
+
+constexpr char kMetricPrefixPickle[] = "Pickle.";
+constexpr char kMetricThroughput[] = "throughput";
+constexpr char kMetricAllocationsPerPickle[] = "allocations_per_pickle";
+
+constexpr size_t kNumPickles = 10000;
+
+// The size of the chunks that pickles are split into for
+// ChunkedPickleIterator, such as those of a network or disk cache buffer.
+constexpr size_t kChunkSize = 4096;
+
+perf_test::PerfResultReporter SetUpReporter(const std::string& story_name) {
+  perf_test::PerfResultReporter reporter(kMetricPrefixPickle, story_name);
+  reporter.RegisterImportantMetric(kMetricThroughput, "bytesPerSecond");
+  reporter.RegisterImportantMetric(kMetricAllocationsPerPickle, "count");
+  return reporter;
+}
+
+// A navigation entry, roughly as saved by session restore.
+struct Entry {
+  int id;
+  std::string url;
+  std::u16string title;
+  int64_t timestamp;
+  std::string page_state;
+};
+
+// Returns |num_entries| entries whose page states are |page_state_size| bytes.
+std::vector<Entry> MakeEntries(size_t num_entries, size_t page_state_size) {
+  std::vector<Entry> entries;
+  for (size_t i = 0; i < num_entries; ++i) {
+    entries.push_back(
+        {static_cast<int>(i),
+         StringPrintf("https://www.example.com/path/to/page%zu.html", i),
+         u"A page title of typical length", static_cast<int64_t>(i) << 32,
+         std::string(page_state_size, 'p')});
+  }
+  return entries;
+}
+
+void AddEntries(const std::vector<Entry>& entries, PickleSizer* sizer) {
+  sizer->AddInt();
+  for (const Entry& entry : entries) {
+    sizer->AddInt();
+    sizer->AddString(entry.url);
+    sizer->AddString16(entry.title);
+    sizer->AddInt64();
+    sizer->AddData(static_cast<int>(entry.page_state.size()));
+  }
+}
+
+// Writes |entries| to |pickle|, and returns the number of times its buffer
+// was reallocated.
+size_t WriteEntries(const std::vector<Entry>& entries, Pickle* pickle) {
+  size_t reallocations = 0;
+  size_t capacity = pickle->GetTotalAllocatedSize();
+  pickle->WriteInt(static_cast<int>(entries.size()));
+  for (const Entry& entry : entries) {
+    pickle->WriteInt(entry.id);
+    pickle->WriteString(entry.url);
+    pickle->WriteString16(entry.title);
+    pickle->WriteInt64(entry.timestamp);
+    pickle->WriteData(entry.page_state.data(),
+                      static_cast<int>(entry.page_state.size()));
+    if (pickle->GetTotalAllocatedSize() != capacity) {
+      capacity = pickle->GetTotalAllocatedSize();
+      ++reallocations;
+    }
+  }
+  return reallocations;
+}
+
+bool ReadEntries(PickleIterator* iter, std::vector<Entry>* entries) {
+  int num_entries;
+  if (!iter->ReadLength(&num_entries))
+    return false;
+  entries->resize(num_entries);
+  for (Entry& entry : *entries) {
+    const char* page_state;
+    int page_state_size;
+    if (!iter->ReadInt(&entry.id) || !iter->ReadString(&entry.url) ||
+        !iter->ReadString16(&entry.title) ||
+        !iter->ReadInt64(&entry.timestamp) ||
+        !iter->ReadData(&page_state, &page_state_size)) {
+      return false;
+    }
+    entry.page_state.assign(page_state, page_state_size);
+  }
+  return true;
+}
+
+bool ReadEntries(ChunkedPickleIterator* iter, std::vector<Entry>* entries) {
+  int num_entries;
+  if (!iter->ReadLength(&num_entries))
+    return false;
+  entries->resize(num_entries);
+  std::vector<char> page_state;
+  for (Entry& entry : *entries) {
+    if (!iter->ReadInt(&entry.id) || !iter->ReadString(&entry.url) ||
+        !iter->ReadString16(&entry.title) ||
+        !iter->ReadInt64(&entry.timestamp) || !iter->ReadData(&page_state)) {
+      return false;
+    }
+    entry.page_state.assign(page_state.data(), page_state.size());
+  }
+  return true;
+}
+
+enum class WriteMode {
+  // A new Pickle grows as the values are written.
+  kGrow,
+  // A new Pickle is sized with a PickleSizer first.
+  kSized,
+  // One Pickle is reset and reused for every write.
+  kArena,
+};
+
+class PicklePerfTest : public testing::TestWithParam<size_t> {
+ protected:
+  std::string StoryName(const char* name) const {
+    return StringPrintf("%s_%zu", name, GetParam());
+  }
+
+  std::vector<Entry> MakeTestEntries() const {
+    return MakeEntries(10, GetParam());
+  }
+
+  void RunWriteTest(const char* name, WriteMode mode) {
+    const std::vector<Entry> entries = MakeTestEntries();
+    size_t allocations = 0;
+    size_t bytes = 0;
+    Pickle arena;
+    TimeTicks start = TimeTicks::Now();
+    for (size_t i = 0; i < kNumPickles; ++i) {
+      if (mode == WriteMode::kArena) {
+        arena.Reset();
+        allocations += WriteEntries(entries, &arena);
+        bytes += arena.size();
+        continue;
+      }
+      Pickle pickle;
+      ++allocations;
+      if (mode == WriteMode::kSized) {
+        PickleSizer sizer;
+        AddEntries(entries, &sizer);
+        const size_t capacity = pickle.GetTotalAllocatedSize();
+        pickle.Reserve(sizer.payload_size());
+        if (pickle.GetTotalAllocatedSize() != capacity)
+          ++allocations;
+      }
+      allocations += WriteEntries(entries, &pickle);
+      bytes += pickle.size();
+    }
+    TimeDelta elapsed = TimeTicks::Now() - start;
+
+    auto reporter = SetUpReporter(StoryName(name));
+    reporter.AddResult(kMetricThroughput, bytes / elapsed.InSecondsF());
+    reporter.AddResult(kMetricAllocationsPerPickle,
+                       static_cast<double>(allocations) / kNumPickles);
+  }
+
+  void RunReadTest(const char* name, bool chunked) {
+    const std::vector<Entry> entries = MakeTestEntries();
+    Pickle pickle;
+    WriteEntries(entries, &pickle);
+    const char* data = static_cast<const char*>(pickle.data());
+    std::vector<span<const char>> chunks;
+    for (size_t offset = 0; offset < pickle.size(); offset += kChunkSize) {
+      chunks.emplace_back(data + offset,
+                          std::min(kChunkSize, pickle.size() - offset));
+    }
+
+    std::vector<Entry> read_entries;
+    TimeTicks start = TimeTicks::Now();
+    for (size_t i = 0; i < kNumPickles; ++i) {
+      if (chunked) {
+        ChunkedPickleIterator iter(chunks);
+        ASSERT_TRUE(ReadEntries(&iter, &read_entries));
+      } else {
+        PickleIterator iter(pickle);
+        ASSERT_TRUE(ReadEntries(&iter, &read_entries));
+      }
+    }
+    TimeDelta elapsed = TimeTicks::Now() - start;
+
+    auto reporter = SetUpReporter(StoryName(name));
+    reporter.AddResult(kMetricThroughput,
+                       pickle.size() * kNumPickles / elapsed.InSecondsF());
+  }
+};
+
+// The page state size of each entry.
+INSTANTIATE_TEST_SUITE_P(All,
+                         PicklePerfTest,
+                         testing::Values(16, 1024, 16 * 1024));
+
+TEST_P(PicklePerfTest, WriteGrow) {
+  RunWriteTest("WriteGrow", WriteMode::kGrow);
+}
+
+TEST_P(PicklePerfTest, WriteSized) {
+  RunWriteTest("WriteSized", WriteMode::kSized);
+}
+
+TEST_P(PicklePerfTest, WriteArena) {
+  RunWriteTest("WriteArena", WriteMode::kArena);
+}
+
+TEST_P(PicklePerfTest, ReadContiguous) {
+  RunReadTest("ReadContiguous", false);
+}
+
+TEST_P(PicklePerfTest, ReadChunked) {
+  RunReadTest("ReadChunked", true);
+}
+
+}  // namespace
+
+}  // namespace base
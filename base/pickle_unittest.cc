@@ -8,8 +8,11 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <algorithm>
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "base/cxx17_backports.h"
 #include "base/ignore_result.h"
@@ -107,6 +110,121 @@ void VerifyResult(const Pickle& pickle) {
   EXPECT_FALSE(iter.ReadInt(&outint));
 }
 
+// Writes the values checked by VerifyResult() to |pickle|, and adds their
+// sizes to |sizer|.
+void WriteTestValues(Pickle* pickle, PickleSizer* sizer) {
+  pickle->WriteBool(testbool1);
+  sizer->AddBool();
+  pickle->WriteBool(testbool2);
+  sizer->AddBool();
+  pickle->WriteInt(testint);
+  sizer->AddInt();
+  pickle->WriteLong(testlong);
+  sizer->AddLong();
+  pickle->WriteUInt16(testuint16);
+  sizer->AddUInt16();
+  pickle->WriteUInt32(testuint32);
+  sizer->AddUInt32();
+  pickle->WriteInt64(testint64);
+  sizer->AddInt64();
+  pickle->WriteUInt64(testuint64);
+  sizer->AddUInt64();
+  pickle->WriteFloat(testfloat);
+  sizer->AddFloat();
+  pickle->WriteDouble(testdouble);
+  sizer->AddDouble();
+  pickle->WriteString(teststring);
+  sizer->AddString(teststring);
+  pickle->WriteString16(teststring16);
+  sizer->AddString16(teststring16);
+  pickle->WriteString(testrawstring);
+  sizer->AddString(testrawstring);
+  pickle->WriteString16(testrawstring16);
+  sizer->AddString16(testrawstring16);
+  pickle->WriteData(testdata, testdatalen);
+  sizer->AddData(testdatalen);
+}
+
+// Checks that the results can be read correctly from |chunks|, which hold the
+// data of a Pickle written by WriteTestValues().
+void VerifyChunkedResult(std::vector<span<const char>> chunks) {
+  ChunkedPickleIterator iter(std::move(chunks));
+
+  bool outbool;
+  EXPECT_TRUE(iter.ReadBool(&outbool));
+  EXPECT_FALSE(outbool);
+  EXPECT_TRUE(iter.ReadBool(&outbool));
+  EXPECT_TRUE(outbool);
+
+  int outint;
+  EXPECT_TRUE(iter.ReadInt(&outint));
+  EXPECT_EQ(testint, outint);
+
+  long outlong;
+  EXPECT_TRUE(iter.ReadLong(&outlong));
+  EXPECT_EQ(testlong, outlong);
+
+  uint16_t outuint16;
+  EXPECT_TRUE(iter.ReadUInt16(&outuint16));
+  EXPECT_EQ(testuint16, outuint16);
+
+  uint32_t outuint32;
+  EXPECT_TRUE(iter.ReadUInt32(&outuint32));
+  EXPECT_EQ(testuint32, outuint32);
+
+  int64_t outint64;
+  EXPECT_TRUE(iter.ReadInt64(&outint64));
+  EXPECT_EQ(testint64, outint64);
+
+  uint64_t outuint64;
+  EXPECT_TRUE(iter.ReadUInt64(&outuint64));
+  EXPECT_EQ(testuint64, outuint64);
+
+  float outfloat;
+  EXPECT_TRUE(iter.ReadFloat(&outfloat));
+  EXPECT_EQ(testfloat, outfloat);
+
+  double outdouble;
+  EXPECT_TRUE(iter.ReadDouble(&outdouble));
+  EXPECT_EQ(testdouble, outdouble);
+
+  std::string outstring;
+  EXPECT_TRUE(iter.ReadString(&outstring));
+  EXPECT_EQ(teststring, outstring);
+
+  std::u16string outstring16;
+  EXPECT_TRUE(iter.ReadString16(&outstring16));
+  EXPECT_EQ(teststring16, outstring16);
+
+  EXPECT_TRUE(iter.ReadString(&outstring));
+  EXPECT_EQ(testrawstring, outstring);
+
+  EXPECT_TRUE(iter.ReadString16(&outstring16));
+  EXPECT_EQ(testrawstring16, outstring16);
+
+  std::vector<char> outdata;
+  EXPECT_TRUE(iter.ReadData(&outdata));
+  EXPECT_EQ(std::vector<char>(testdata, testdata + testdatalen), outdata);
+
+  // reads past the end should fail
+  EXPECT_TRUE(iter.ReachedEnd());
+  EXPECT_FALSE(iter.ReadInt(&outint));
+}
+
+// Splits the data of |pickle| into chunks of at most |chunk_size| bytes, with
+// an empty chunk in between each.
+std::vector<span<const char>> SplitIntoChunks(const Pickle& pickle,
+                                              size_t chunk_size) {
+  const char* data = static_cast<const char*>(pickle.data());
+  std::vector<span<const char>> chunks;
+  for (size_t offset = 0; offset < pickle.size(); offset += chunk_size) {
+    chunks.emplace_back(data + offset,
+                        std::min(chunk_size, pickle.size() - offset));
+    chunks.emplace_back();
+  }
+  return chunks;
+}
+
 }  // namespace
 
 TEST(PickleTest, EncodeDecode) {
@@ -597,4 +715,130 @@ TEST(PickleTest, ReachedEnd) {
   EXPECT_TRUE(iter.ReachedEnd());
 }
 
+// Checks that PickleSizer computes the payload size of every type of write,
+// so that a Pickle reserved with it never grows.
+TEST(PickleTest, PickleSizer) {
+  Pickle sized_pickle;
+  PickleSizer sizer;
+  WriteTestValues(&sized_pickle, &sizer);
+  EXPECT_EQ(sized_pickle.payload_size(), sizer.payload_size());
+
+  Pickle pickle;
+  const size_t initial_capacity = pickle.GetTotalAllocatedSize();
+  pickle.Reserve(sizer.payload_size());
+  const size_t capacity = pickle.GetTotalAllocatedSize();
+  EXPECT_GE(capacity, sizeof(Pickle::Header) + sizer.payload_size());
+  // Reserve() adds twice the previous capacity, rounded up to the allocation
+  // granularity.
+  EXPECT_LT(capacity, initial_capacity * 2 + sizer.payload_size() + 64);
+
+  PickleSizer unused_sizer;
+  WriteTestValues(&pickle, &unused_sizer);
+  EXPECT_EQ(capacity, pickle.GetTotalAllocatedSize());
+  VerifyResult(pickle);
+}
+
+TEST(PickleTest, Reset) {
+  Pickle pickle;
+  PickleSizer sizer;
+  WriteTestValues(&pickle, &sizer);
+  const size_t capacity = pickle.GetTotalAllocatedSize();
+
+  pickle.Reset();
+  EXPECT_EQ(0u, pickle.payload_size());
+  EXPECT_EQ(sizeof(Pickle::Header), pickle.size());
+  EXPECT_TRUE(PickleIterator(pickle).ReachedEnd());
+
+  // The same payload fits in the space that is kept.
+  for (int i = 0; i < 3; ++i) {
+    WriteTestValues(&pickle, &sizer);
+    EXPECT_EQ(capacity, pickle.GetTotalAllocatedSize());
+    VerifyResult(pickle);
+    pickle.Reset();
+  }
+}
+
+TEST(PickleTest, ChunkedPickleIterator) {
+  Pickle pickle;
+  PickleSizer sizer;
+  WriteTestValues(&pickle, &sizer);
+
+  for (size_t chunk_size = 1; chunk_size <= pickle.size(); ++chunk_size) {
+    SCOPED_TRACE(chunk_size);
+    VerifyChunkedResult(SplitIntoChunks(pickle, chunk_size));
+  }
+}
+
+TEST(PickleTest, ChunkedPickleIteratorHeaderPadding) {
+  const uint32_t kMagic = 0x12345678;
+
+  Pickle pickle(sizeof(Pickle::Header) + 12);
+  pickle.WriteInt(kMagic);
+  pickle.WriteString(teststring);
+
+  for (size_t chunk_size = 1; chunk_size <= pickle.size(); ++chunk_size) {
+    ChunkedPickleIterator iter(SplitIntoChunks(pickle, chunk_size));
+    int result;
+    std::string outstring;
+    ASSERT_TRUE(iter.ReadInt(&result));
+    EXPECT_EQ(static_cast<uint32_t>(result), kMagic);
+    ASSERT_TRUE(iter.ReadString(&outstring));
+    EXPECT_EQ(teststring, outstring);
+    EXPECT_TRUE(iter.ReachedEnd());
+  }
+}
+
+TEST(PickleTest, ChunkedPickleIteratorBadData) {
+  // Too short for a header.
+  const char kShort[] = {1, 0};
+  ChunkedPickleIterator short_iter({make_span(kShort)});
+  int outint;
+  EXPECT_TRUE(short_iter.ReachedEnd());
+  EXPECT_FALSE(short_iter.ReadInt(&outint));
+
+  // A payload size larger than the data.
+  Pickle pickle;
+  pickle.WriteInt(1);
+  std::string data(static_cast<const char*>(pickle.data()), pickle.size());
+  data[0] = 5;
+  ChunkedPickleIterator bad_size_iter({make_span(data)});
+  EXPECT_TRUE(bad_size_iter.ReachedEnd());
+  EXPECT_FALSE(bad_size_iter.ReadInt(&outint));
+
+  // A header size that is not a multiple of 4.
+  data.push_back(0);
+  data[0] = 4;
+  ChunkedPickleIterator unaligned_iter({make_span(data)});
+  EXPECT_TRUE(unaligned_iter.ReachedEnd());
+}
+
+TEST(PickleTest, ChunkedPickleIteratorEvilLengths) {
+  // A length that is only too large once multiplied by sizeof(char16_t).
+  Pickle source;
+  std::string str(100000, 'A');
+  source.WriteData(str.c_str(), 100000);
+  for (size_t chunk_size : {size_t{7}, source.size()}) {
+    ChunkedPickleIterator iter(SplitIntoChunks(source, chunk_size));
+    std::u16string str16;
+    EXPECT_FALSE(iter.ReadString16(&str16));
+    EXPECT_TRUE(str16.empty());
+  }
+
+  // Lengths must be checked before allocating space for the result.
+  Pickle toolong;
+  toolong.WriteInt(1 << 30);
+  ChunkedPickleIterator toolong_iter(SplitIntoChunks(toolong, 3));
+  std::string outstring;
+  std::vector<char> outdata;
+  EXPECT_FALSE(toolong_iter.ReadString(&outstring));
+  EXPECT_TRUE(outstring.empty());
+
+  Pickle negative;
+  negative.WriteInt(-1);
+  negative.WriteInt(0);
+  ChunkedPickleIterator negative_iter(SplitIntoChunks(negative, 5));
+  EXPECT_FALSE(negative_iter.ReadData(&outdata));
+  EXPECT_TRUE(negative_iter.ReachedEnd());
+}
+
 }  // namespace base
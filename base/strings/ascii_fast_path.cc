@@ -0,0 +1,550 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/strings/ascii_fast_path.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include "base/bits.h"
+#include "build/build_config.h"
+
+#if defined(ARCH_CPU_X86_FAMILY) && !defined(OS_NACL)
+#include <emmintrin.h>
+#define ASCII_FAST_PATH_SSE2
+#elif defined(ARCH_CPU_ARM64)
+#include <arm_neon.h>
+#define ASCII_FAST_PATH_NEON
+#endif
+
+#if defined(ARCH_CPU_X86_64) && !defined(OS_NACL)
+// Include order is important, so we disable formatting.
+// clang-format off
+#include <immintrin.h>
+#include <avxintrin.h>
+#include <avx2intrin.h>
+// clang-format on
+#include "base/cpu.h"
+#define ASCII_FAST_PATH_AVX2
+#endif
+
+namespace base {
+namespace internal {
+
+namespace {
+
+// Portable kernels ------------------------------------------------------------
+// These process a machine word at a time, and also finish the runs left over
+// by the SIMD kernels one code unit at a time.
+
+constexpr uint64_t kNonASCIIMask8 = 0x8080808080808080ULL;
+constexpr uint64_t kNonASCIIMask16 = 0xFF80FF80FF80FF80ULL;
+
+inline bool IsASCII(char c) {
+  return !(static_cast<unsigned char>(c) & 0x80);
+}
+
+inline bool IsASCII(char16_t c) {
+  return c < 0x80;
+}
+
+size_t CountLeadingASCIIPortable(const char* src, size_t length) {
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= length; i += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, src + i, sizeof(word));
+    if (word & kNonASCIIMask8)
+      break;
+  }
+  while (i < length && IsASCII(src[i]))
+    ++i;
+  return i;
+}
+
+size_t CopyLeadingASCIIPortable(const char* src,
+                                size_t length,
+                                char16_t* dest) {
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= length; i += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, src + i, sizeof(word));
+    if (word & kNonASCIIMask8)
+      break;
+    for (size_t j = 0; j < sizeof(uint64_t); ++j)
+      dest[i + j] = static_cast<char16_t>(src[i + j]);
+  }
+  for (; i < length && IsASCII(src[i]); ++i)
+    dest[i] = static_cast<char16_t>(src[i]);
+  return i;
+}
+
+size_t CopyLeadingASCIIPortable(const char16_t* src,
+                                size_t length,
+                                char* dest) {
+  constexpr size_t kCharsPerWord = sizeof(uint64_t) / sizeof(char16_t);
+  size_t i = 0;
+  for (; i + kCharsPerWord <= length; i += kCharsPerWord) {
+    uint64_t word;
+    memcpy(&word, src + i, sizeof(word));
+    if (word & kNonASCIIMask16)
+      break;
+    for (size_t j = 0; j < kCharsPerWord; ++j)
+      dest[i + j] = static_cast<char>(src[i + j]);
+  }
+  for (; i < length && IsASCII(src[i]); ++i)
+    dest[i] = static_cast<char>(src[i]);
+  return i;
+}
+
+inline char ToLowerASCIIChar(char c) {
+  return (c >= 'A' && c <= 'Z') ? static_cast<char>(c + ('a' - 'A')) : c;
+}
+
+inline char ToUpperASCIIChar(char c) {
+  return (c >= 'a' && c <= 'z') ? static_cast<char>(c + ('A' - 'a')) : c;
+}
+
+size_t FindCaseInsensitiveMismatchASCIIPortable(const char* a,
+                                                const char* b,
+                                                size_t length) {
+  size_t i = 0;
+  // Skip the identical prefix a word at a time.
+  for (; i + sizeof(uint64_t) <= length; i += sizeof(uint64_t)) {
+    if (memcmp(a + i, b + i, sizeof(uint64_t)))
+      break;
+  }
+  for (; i < length; ++i) {
+    if (ToLowerASCIIChar(a[i]) != ToLowerASCIIChar(b[i]))
+      return i;
+  }
+  return length;
+}
+
+template <bool kToUpper>
+void CopyChangeCaseASCIIPortable(const char* src, size_t length, char* dest) {
+  for (size_t i = 0; i < length; ++i)
+    dest[i] = kToUpper ? ToUpperASCIIChar(src[i]) : ToLowerASCIIChar(src[i]);
+}
+
+// SSE2 kernels ----------------------------------------------------------------
+
+#if defined(ASCII_FAST_PATH_SSE2)
+
+size_t CountLeadingASCIISse2(const char* src, size_t length) {
+  size_t i = 0;
+  for (; i + sizeof(__m128i) <= length; i += sizeof(__m128i)) {
+    const __m128i chars =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    // The top bit of each byte is set for non-ASCII code units.
+    const int mask = _mm_movemask_epi8(chars);
+    if (mask)
+      return i + bits::CountTrailingZeroBits(static_cast<uint32_t>(mask));
+  }
+  return i + CountLeadingASCIIPortable(src + i, length - i);
+}
+
+// The copying kernels store whole vectors before looking for the end of the
+// run, which is fine since |dest| has room for |length| code units. This
+// makes them return without falling back to the next kernel when the run ends
+// early, as is common in mixed text.
+
+size_t CopyLeadingASCIISse2(const char* src, size_t length, char16_t* dest) {
+  const __m128i zero = _mm_setzero_si128();
+  size_t i = 0;
+  for (; i + sizeof(__m128i) <= length; i += sizeof(__m128i)) {
+    const __m128i chars =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i),
+                     _mm_unpacklo_epi8(chars, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i + 8),
+                     _mm_unpackhi_epi8(chars, zero));
+    const int mask = _mm_movemask_epi8(chars);
+    if (mask)
+      return i + bits::CountTrailingZeroBits(static_cast<uint32_t>(mask));
+  }
+  return i + CopyLeadingASCIIPortable(src + i, length - i, dest + i);
+}
+
+size_t CopyLeadingASCIISse2(const char16_t* src, size_t length, char* dest) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i non_ascii = _mm_set1_epi16(static_cast<int16_t>(0xFF80));
+  // Two vectors of UTF-16 are packed into one of ASCII.
+  constexpr size_t kCharsPerStep = 2 * sizeof(__m128i) / sizeof(char16_t);
+  size_t i = 0;
+  for (; i + kCharsPerStep <= length; i += kCharsPerStep) {
+    const __m128i low =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    const __m128i high =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 8));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i),
+                     _mm_packus_epi16(low, high));
+    // Has one bit set for each ASCII code unit.
+    const int mask = _mm_movemask_epi8(
+        _mm_packs_epi16(_mm_cmpeq_epi16(_mm_and_si128(low, non_ascii), zero),
+                        _mm_cmpeq_epi16(_mm_and_si128(high, non_ascii), zero)));
+    if (mask != 0xFFFF)
+      return i + bits::CountTrailingZeroBits(static_cast<uint32_t>(~mask));
+  }
+  return i + CopyLeadingASCIIPortable(src + i, length - i, dest + i);
+}
+
+// Returns a mask of the bytes of |chars| that are letters of the case that
+// starts at |first|, i.e. in the range [first, first + 26). The range is
+// shifted to the bottom of the signed range, so that a single signed
+// comparison can be used.
+inline __m128i LetterMaskSse2(__m128i chars, char first) {
+  const __m128i shifted =
+      _mm_add_epi8(chars, _mm_set1_epi8(static_cast<char>(0x80 - first)));
+  return _mm_cmplt_epi8(shifted, _mm_set1_epi8(static_cast<char>(0x80 + 26)));
+}
+
+inline __m128i ToLowerASCIISse2(__m128i chars) {
+  return _mm_or_si128(
+      chars, _mm_and_si128(LetterMaskSse2(chars, 'A'), _mm_set1_epi8(0x20)));
+}
+
+inline __m128i ToUpperASCIISse2(__m128i chars) {
+  return _mm_andnot_si128(
+      _mm_and_si128(LetterMaskSse2(chars, 'a'), _mm_set1_epi8(0x20)), chars);
+}
+
+size_t FindCaseInsensitiveMismatchASCIISse2(const char* a,
+                                            const char* b,
+                                            size_t length) {
+  size_t i = 0;
+  for (; i + sizeof(__m128i) <= length; i += sizeof(__m128i)) {
+    const __m128i lower_a = ToLowerASCIISse2(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)));
+    const __m128i lower_b = ToLowerASCIISse2(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+    const int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(lower_a, lower_b));
+    if (mask != 0xFFFF)
+      return i + bits::CountTrailingZeroBits(static_cast<uint32_t>(~mask));
+  }
+  return i + FindCaseInsensitiveMismatchASCIIPortable(a + i, b + i, length - i);
+}
+
+template <bool kToUpper>
+void CopyChangeCaseASCIISse2(const char* src, size_t length, char* dest) {
+  size_t i = 0;
+  for (; i + sizeof(__m128i) <= length; i += sizeof(__m128i)) {
+    const __m128i chars =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i*>(dest + i),
+        kToUpper ? ToUpperASCIISse2(chars) : ToLowerASCIISse2(chars));
+  }
+  CopyChangeCaseASCIIPortable<kToUpper>(src + i, length - i, dest + i);
+}
+
+#endif  // defined(ASCII_FAST_PATH_SSE2)
+
+// AVX2 kernels ----------------------------------------------------------------
+
+#if defined(ASCII_FAST_PATH_AVX2)
+
+// The AVX2 kernels finish with the SSE2 ones, which are not VEX-encoded, so
+// they clear the upper halves of the vector registers first to avoid the
+// penalty for mixing the two.
+
+__attribute__((target("avx2"))) size_t CountLeadingASCIIAvx2(const char* src,
+                                                              size_t length) {
+  size_t i = 0;
+  for (; i + sizeof(__m256i) <= length; i += sizeof(__m256i)) {
+    const __m256i chars =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    const int mask = _mm256_movemask_epi8(chars);
+    if (mask)
+      return i + bits::CountTrailingZeroBits(static_cast<uint32_t>(mask));
+  }
+  _mm256_zeroupper();
+  return i + CountLeadingASCIISse2(src + i, length - i);
+}
+
+__attribute__((target("avx2"))) size_t
+CopyLeadingASCIIAvx2(const char* src, size_t length, char16_t* dest) {
+  size_t i = 0;
+  for (; i + sizeof(__m256i) <= length; i += sizeof(__m256i)) {
+    const __m256i chars =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i*>(dest + i),
+        _mm256_cvtepu8_epi16(_mm256_castsi256_si128(chars)));
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i*>(dest + i + 16),
+        _mm256_cvtepu8_epi16(_mm256_extracti128_si256(chars, 1)));
+    const int mask = _mm256_movemask_epi8(chars);
+    if (mask)
+      return i + bits::CountTrailingZeroBits(static_cast<uint32_t>(mask));
+  }
+  _mm256_zeroupper();
+  return i + CopyLeadingASCIISse2(src + i, length - i, dest + i);
+}
+
+__attribute__((target("avx2"))) size_t
+CopyLeadingASCIIAvx2(const char16_t* src, size_t length, char* dest) {
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i non_ascii = _mm256_set1_epi16(static_cast<int16_t>(0xFF80));
+  constexpr size_t kCharsPerStep = 2 * sizeof(__m256i) / sizeof(char16_t);
+  size_t i = 0;
+  for (; i + kCharsPerStep <= length; i += kCharsPerStep) {
+    const __m256i low =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    const __m256i high =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 16));
+    // Packing works within each 128-bit lane, so the middle 64-bit quarters
+    // of the results need to be swapped to restore the order.
+    const __m256i packed = _mm256_packus_epi16(low, high);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + i),
+                        _mm256_permute4x64_epi64(packed, 0xD8));
+    if (_mm256_testz_si256(_mm256_or_si256(low, high), non_ascii))
+      continue;
+    const __m256i is_ascii = _mm256_packs_epi16(
+        _mm256_cmpeq_epi16(_mm256_and_si256(low, non_ascii), zero),
+        _mm256_cmpeq_epi16(_mm256_and_si256(high, non_ascii), zero));
+    const uint32_t mask = static_cast<uint32_t>(
+        _mm256_movemask_epi8(_mm256_permute4x64_epi64(is_ascii, 0xD8)));
+    return i + bits::CountTrailingZeroBits(~mask);
+  }
+  _mm256_zeroupper();
+  return i + CopyLeadingASCIISse2(src + i, length - i, dest + i);
+}
+
+__attribute__((target("avx2"))) inline __m256i LetterMaskAvx2(__m256i chars,
+                                                               char first) {
+  const __m256i shifted =
+      _mm256_add_epi8(chars, _mm256_set1_epi8(static_cast<char>(0x80 - first)));
+  return _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(0x80 + 26)),
+                           shifted);
+}
+
+__attribute__((target("avx2"))) inline __m256i ToLowerASCIIAvx2(
+    __m256i chars) {
+  return _mm256_or_si256(chars, _mm256_and_si256(LetterMaskAvx2(chars, 'A'),
+                                                 _mm256_set1_epi8(0x20)));
+}
+
+__attribute__((target("avx2"))) inline __m256i ToUpperASCIIAvx2(
+    __m256i chars) {
+  return _mm256_andnot_si256(
+      _mm256_and_si256(LetterMaskAvx2(chars, 'a'), _mm256_set1_epi8(0x20)),
+      chars);
+}
+
+__attribute__((target("avx2"))) size_t
+FindCaseInsensitiveMismatchASCIIAvx2(const char* a,
+                                     const char* b,
+                                     size_t length) {
+  size_t i = 0;
+  for (; i + sizeof(__m256i) <= length; i += sizeof(__m256i)) {
+    const __m256i lower_a = ToLowerASCIIAvx2(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)));
+    const __m256i lower_b = ToLowerASCIIAvx2(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+    const uint32_t mask = static_cast<uint32_t>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi8(lower_a, lower_b)));
+    if (mask != 0xFFFFFFFF)
+      return i + bits::CountTrailingZeroBits(~mask);
+  }
+  _mm256_zeroupper();
+  return i + FindCaseInsensitiveMismatchASCIISse2(a + i, b + i, length - i);
+}
+
+template <bool kToUpper>
+__attribute__((target("avx2"))) void CopyChangeCaseASCIIAvx2(const char* src,
+                                                              size_t length,
+                                                              char* dest) {
+  size_t i = 0;
+  for (; i + sizeof(__m256i) <= length; i += sizeof(__m256i)) {
+    const __m256i chars =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i*>(dest + i),
+        kToUpper ? ToUpperASCIIAvx2(chars) : ToLowerASCIIAvx2(chars));
+  }
+  _mm256_zeroupper();
+  CopyChangeCaseASCIISse2<kToUpper>(src + i, length - i, dest + i);
+}
+
+#endif  // defined(ASCII_FAST_PATH_AVX2)
+
+// NEON kernels ----------------------------------------------------------------
+
+#if defined(ASCII_FAST_PATH_NEON)
+
+size_t CountLeadingASCIINeon(const char* src, size_t length) {
+  size_t i = 0;
+  for (; i + sizeof(uint8x16_t) <= length; i += sizeof(uint8x16_t)) {
+    const uint8x16_t chars =
+        vld1q_u8(reinterpret_cast<const uint8_t*>(src + i));
+    if (vmaxvq_u8(chars) >= 0x80)
+      break;
+  }
+  return i + CountLeadingASCIIPortable(src + i, length - i);
+}
+
+size_t CopyLeadingASCIINeon(const char* src, size_t length, char16_t* dest) {
+  size_t i = 0;
+  for (; i + sizeof(uint8x16_t) <= length; i += sizeof(uint8x16_t)) {
+    const uint8x16_t chars =
+        vld1q_u8(reinterpret_cast<const uint8_t*>(src + i));
+    if (vmaxvq_u8(chars) >= 0x80)
+      break;
+    vst1q_u16(reinterpret_cast<uint16_t*>(dest + i),
+              vmovl_u8(vget_low_u8(chars)));
+    vst1q_u16(reinterpret_cast<uint16_t*>(dest + i + 8), vmovl_high_u8(chars));
+  }
+  return i + CopyLeadingASCIIPortable(src + i, length - i, dest + i);
+}
+
+size_t CopyLeadingASCIINeon(const char16_t* src, size_t length, char* dest) {
+  constexpr size_t kCharsPerStep = 2 * sizeof(uint16x8_t) / sizeof(char16_t);
+  size_t i = 0;
+  for (; i + kCharsPerStep <= length; i += kCharsPerStep) {
+    const uint16x8_t low =
+        vld1q_u16(reinterpret_cast<const uint16_t*>(src + i));
+    const uint16x8_t high =
+        vld1q_u16(reinterpret_cast<const uint16_t*>(src + i + 8));
+    if (vmaxvq_u16(vorrq_u16(low, high)) >= 0x80)
+      break;
+    vst1q_u8(reinterpret_cast<uint8_t*>(dest + i),
+             vcombine_u8(vmovn_u16(low), vmovn_u16(high)));
+  }
+  return i + CopyLeadingASCIIPortable(src + i, length - i, dest + i);
+}
+
+// Returns a mask of the bytes of |chars| in the range [first, first + 26).
+inline uint8x16_t LetterMaskNeon(uint8x16_t chars, char first) {
+  return vcltq_u8(vsubq_u8(chars, vdupq_n_u8(first)), vdupq_n_u8(26));
+}
+
+inline uint8x16_t ToLowerASCIINeon(uint8x16_t chars) {
+  return vorrq_u8(chars,
+                  vandq_u8(LetterMaskNeon(chars, 'A'), vdupq_n_u8(0x20)));
+}
+
+inline uint8x16_t ToUpperASCIINeon(uint8x16_t chars) {
+  return vbicq_u8(chars,
+                  vandq_u8(LetterMaskNeon(chars, 'a'), vdupq_n_u8(0x20)));
+}
+
+size_t FindCaseInsensitiveMismatchASCIINeon(const char* a,
+                                            const char* b,
+                                            size_t length) {
+  size_t i = 0;
+  for (; i + sizeof(uint8x16_t) <= length; i += sizeof(uint8x16_t)) {
+    const uint8x16_t lower_a =
+        ToLowerASCIINeon(vld1q_u8(reinterpret_cast<const uint8_t*>(a + i)));
+    const uint8x16_t lower_b =
+        ToLowerASCIINeon(vld1q_u8(reinterpret_cast<const uint8_t*>(b + i)));
+    if (vminvq_u8(vceqq_u8(lower_a, lower_b)) != 0xFF)
+      break;
+  }
+  return i + FindCaseInsensitiveMismatchASCIIPortable(a + i, b + i, length - i);
+}
+
+template <bool kToUpper>
+void CopyChangeCaseASCIINeon(const char* src, size_t length, char* dest) {
+  size_t i = 0;
+  for (; i + sizeof(uint8x16_t) <= length; i += sizeof(uint8x16_t)) {
+    const uint8x16_t chars =
+        vld1q_u8(reinterpret_cast<const uint8_t*>(src + i));
+    vst1q_u8(reinterpret_cast<uint8_t*>(dest + i),
+             kToUpper ? ToUpperASCIINeon(chars) : ToLowerASCIINeon(chars));
+  }
+  CopyChangeCaseASCIIPortable<kToUpper>(src + i, length - i, dest + i);
+}
+
+#endif  // defined(ASCII_FAST_PATH_NEON)
+
+}  // namespace
+
+size_t CountLeadingASCII(const char* src, size_t length) {
+#if defined(ASCII_FAST_PATH_AVX2)
+  if (CPU::CanUseAVX2())
+    return CountLeadingASCIIAvx2(src, length);
+#endif
+#if defined(ASCII_FAST_PATH_SSE2)
+  return CountLeadingASCIISse2(src, length);
+#elif defined(ASCII_FAST_PATH_NEON)
+  return CountLeadingASCIINeon(src, length);
+#else
+  return CountLeadingASCIIPortable(src, length);
+#endif
+}
+
+size_t CopyLeadingASCII(const char* src, size_t length, char16_t* dest) {
+#if defined(ASCII_FAST_PATH_AVX2)
+  if (CPU::CanUseAVX2())
+    return CopyLeadingASCIIAvx2(src, length, dest);
+#endif
+#if defined(ASCII_FAST_PATH_SSE2)
+  return CopyLeadingASCIISse2(src, length, dest);
+#elif defined(ASCII_FAST_PATH_NEON)
+  return CopyLeadingASCIINeon(src, length, dest);
+#else
+  return CopyLeadingASCIIPortable(src, length, dest);
+#endif
+}
+
+size_t CopyLeadingASCII(const char16_t* src, size_t length, char* dest) {
+#if defined(ASCII_FAST_PATH_AVX2)
+  if (CPU::CanUseAVX2())
+    return CopyLeadingASCIIAvx2(src, length, dest);
+#endif
+#if defined(ASCII_FAST_PATH_SSE2)
+  return CopyLeadingASCIISse2(src, length, dest);
+#elif defined(ASCII_FAST_PATH_NEON)
+  return CopyLeadingASCIINeon(src, length, dest);
+#else
+  return CopyLeadingASCIIPortable(src, length, dest);
+#endif
+}
+
+size_t FindCaseInsensitiveMismatchASCII(const char* a,
+                                        const char* b,
+                                        size_t length) {
+#if defined(ASCII_FAST_PATH_AVX2)
+  if (CPU::CanUseAVX2())
+    return FindCaseInsensitiveMismatchASCIIAvx2(a, b, length);
+#endif
+#if defined(ASCII_FAST_PATH_SSE2)
+  return FindCaseInsensitiveMismatchASCIISse2(a, b, length);
+#elif defined(ASCII_FAST_PATH_NEON)
+  return FindCaseInsensitiveMismatchASCIINeon(a, b, length);
+#else
+  return FindCaseInsensitiveMismatchASCIIPortable(a, b, length);
+#endif
+}
+
+void CopyLowerCaseASCII(const char* src, size_t length, char* dest) {
+#if defined(ASCII_FAST_PATH_AVX2)
+  if (CPU::CanUseAVX2())
+    return CopyChangeCaseASCIIAvx2</*kToUpper=*/false>(src, length, dest);
+#endif
+#if defined(ASCII_FAST_PATH_SSE2)
+  CopyChangeCaseASCIISse2</*kToUpper=*/false>(src, length, dest);
+#elif defined(ASCII_FAST_PATH_NEON)
+  CopyChangeCaseASCIINeon</*kToUpper=*/false>(src, length, dest);
+#else
+  CopyChangeCaseASCIIPortable</*kToUpper=*/false>(src, length, dest);
+#endif
+}
+
+void CopyUpperCaseASCII(const char* src, size_t length, char* dest) {
+#if defined(ASCII_FAST_PATH_AVX2)
+  if (CPU::CanUseAVX2())
+    return CopyChangeCaseASCIIAvx2</*kToUpper=*/true>(src, length, dest);
+#endif
+#if defined(ASCII_FAST_PATH_SSE2)
+  CopyChangeCaseASCIISse2</*kToUpper=*/true>(src, length, dest);
+#elif defined(ASCII_FAST_PATH_NEON)
+  CopyChangeCaseASCIINeon</*kToUpper=*/true>(src, length, dest);
+#else
+  CopyChangeCaseASCIIPortable</*kToUpper=*/true>(src, length, dest);
+#endif
+}
+
+}  // namespace internal
+}  // namespace base
@@ -0,0 +1,56 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Vectorized kernels for ASCII text. They are the fast paths of the UTF-8 <->
+// UTF-16 conversions and of UTF-8 validation, and of the ASCII case-insensitive
+// comparisons and case conversions of 8-bit strings. Most text that goes
+// through these (host names, URLs, headers, markup) is predominantly ASCII,
+// and ASCII code units map 1:1 between encodings and never need validation,
+// so they can be handled many at a time and only the remaining code points
+// need to go through the ICU macros.
+//
+// The best available SIMD extension is picked at runtime on x86-64 (AVX2 if
+// present, else SSE2) and at compile time elsewhere (SSE2 on x86, NEON on
+// ARM64, or a word-at-a-time fallback).
+
+#ifndef BASE_STRINGS_ASCII_FAST_PATH_H_
+#define BASE_STRINGS_ASCII_FAST_PATH_H_
+
+#include <stddef.h>
+
+#include "base/base_export.h"
+
+namespace base {
+namespace internal {
+
+// Returns the number of leading ASCII code units in the |length| code units
+// starting at |src|.
+BASE_EXPORT size_t CountLeadingASCII(const char* src, size_t length);
+
+// Copies the leading ASCII code units of the |length| code units starting at
+// |src| into |dest|, and returns how many were copied. |dest| must have room
+// for |length| code units, and those past the copied ones may be overwritten.
+BASE_EXPORT size_t CopyLeadingASCII(const char* src,
+                                    size_t length,
+                                    char16_t* dest);
+BASE_EXPORT size_t CopyLeadingASCII(const char16_t* src,
+                                    size_t length,
+                                    char* dest);
+
+// Returns the index of the first of the |length| code units starting at |a|
+// and |b| that differ after ASCII case folding, or |length| if there is none.
+BASE_EXPORT size_t FindCaseInsensitiveMismatchASCII(const char* a,
+                                                    const char* b,
+                                                    size_t length);
+
+// Copies the |length| code units starting at |src| to |dest|, converting ASCII
+// letters to lower or upper case respectively. Other code units are copied
+// unchanged.
+BASE_EXPORT void CopyLowerCaseASCII(const char* src, size_t length, char* dest);
+BASE_EXPORT void CopyUpperCaseASCII(const char* src, size_t length, char* dest);
+
+}  // namespace internal
+}  // namespace base
+
+#endif  // BASE_STRINGS_ASCII_FAST_PATH_H_
@@ -0,0 +1,172 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/strings/ascii_fast_path.h"
+
+#include <string>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+namespace internal {
+
+namespace {
+
+// Longer than the widest vector, plus slack to shift the start of the input
+// across all alignments.
+constexpr size_t kMaxLength = 100;
+constexpr size_t kMaxOffset = 32;
+
+char ToLowerASCIIReference(char c) {
+  return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+}
+
+char ToUpperASCIIReference(char c) {
+  return (c >= 'a' && c <= 'z') ? c - ('a' - 'A') : c;
+}
+
+}  // namespace
+
+TEST(ASCIIFastPathTest, CountLeadingASCII) {
+  EXPECT_EQ(0u, CountLeadingASCII(nullptr, 0));
+  for (size_t offset = 0; offset < kMaxOffset; ++offset) {
+    for (size_t length = 0; length < kMaxLength; ++length) {
+      std::string str(offset + length + 1, 'a');
+      // A non-ASCII code unit just past the end must not be looked at.
+      str.back() = '\x80';
+      EXPECT_EQ(length, CountLeadingASCII(str.data() + offset, length));
+      for (size_t pos = 0; pos < length; ++pos) {
+        str[offset + pos] = '\xff';
+        EXPECT_EQ(pos, CountLeadingASCII(str.data() + offset, length));
+        str[offset + pos] = '\x7f';
+      }
+    }
+  }
+}
+
+TEST(ASCIIFastPathTest, CopyLeadingASCIIFromUTF8) {
+  for (size_t offset = 0; offset < kMaxOffset; ++offset) {
+    for (size_t length = 0; length < kMaxLength; ++length) {
+      std::string src(offset + length + 1, 'b');
+      src.back() = '\xc3';
+      for (size_t i = 0; i < length; ++i)
+        src[offset + i] = static_cast<char>(i % 0x80);
+      std::u16string dest(length + 1, u'z');
+      EXPECT_EQ(length,
+                CopyLeadingASCII(src.data() + offset, length, &dest[0]));
+      for (size_t i = 0; i < length; ++i)
+        EXPECT_EQ(i % 0x80, dest[i]);
+      // Nothing is written past the end.
+      EXPECT_EQ(u'z', dest[length]);
+
+      for (size_t pos = 0; pos < length; ++pos) {
+        src[offset + pos] = '\xc3';
+        EXPECT_EQ(pos, CopyLeadingASCII(src.data() + offset, length, &dest[0]));
+        src[offset + pos] = static_cast<char>(pos % 0x80);
+      }
+    }
+  }
+}
+
+TEST(ASCIIFastPathTest, CopyLeadingASCIIFromUTF16) {
+  for (size_t offset = 0; offset < kMaxOffset; ++offset) {
+    for (size_t length = 0; length < kMaxLength; ++length) {
+      std::u16string src(offset + length + 1, u'b');
+      src.back() = u'\x00e9';
+      for (size_t i = 0; i < length; ++i)
+        src[offset + i] = static_cast<char16_t>(i % 0x80);
+      std::string dest(length + 1, 'z');
+      EXPECT_EQ(length,
+                CopyLeadingASCII(src.data() + offset, length, &dest[0]));
+      for (size_t i = 0; i < length; ++i)
+        EXPECT_EQ(static_cast<char>(i % 0x80), dest[i]);
+      EXPECT_EQ('z', dest[length]);
+
+      // Also check code units that are ASCII in their low byte only.
+      for (char16_t non_ascii : {u'\x0080', u'\x0100', u'\x4141', u'\xd800'}) {
+        for (size_t pos = 0; pos < length; ++pos) {
+          src[offset + pos] = non_ascii;
+          EXPECT_EQ(pos,
+                    CopyLeadingASCII(src.data() + offset, length, &dest[0]));
+          src[offset + pos] = static_cast<char16_t>(pos % 0x80);
+        }
+      }
+    }
+  }
+}
+
+TEST(ASCIIFastPathTest, FindCaseInsensitiveMismatchASCII) {
+  EXPECT_EQ(0u, FindCaseInsensitiveMismatchASCII(nullptr, nullptr, 0));
+  for (size_t offset = 0; offset < kMaxOffset; ++offset) {
+    for (size_t length = 0; length < kMaxLength; ++length) {
+      std::string a(offset + length + 1, 'a');
+      std::string b(length + 1, 'A');
+      // A mismatch just past the end must not be looked at.
+      a.back() = 'x';
+      for (size_t i = 0; i < length; ++i) {
+        a[offset + i] = static_cast<char>('a' + i % 26);
+        b[i] = static_cast<char>((i % 2 ? 'A' : 'a') + i % 26);
+      }
+      const char* a_start = a.data() + offset;
+      EXPECT_EQ(length,
+                FindCaseInsensitiveMismatchASCII(a_start, b.data(), length));
+      for (size_t pos = 0; pos < length; ++pos) {
+        const char original = b[pos];
+        // Differ in more than case, including pairs of chars that differ only
+        // in the case bit but are not letters.
+        for (char mismatch : {'-', '@', '`', '[', '{', '\xc1', '\xe1'}) {
+          b[pos] = mismatch;
+          EXPECT_EQ(pos, FindCaseInsensitiveMismatchASCII(a_start, b.data(),
+                                                          length));
+        }
+        b[pos] = original;
+      }
+    }
+  }
+}
+
+TEST(ASCIIFastPathTest, FindCaseInsensitiveMismatchASCIIAllBytes) {
+  // Every pair of bytes, at every position within a vector.
+  constexpr size_t kLength = 64;
+  for (int i = 0; i < 256; ++i) {
+    for (int j = 0; j < 256; ++j) {
+      const char a = static_cast<char>(i);
+      const char b = static_cast<char>(j);
+      const bool equal = ToLowerASCIIReference(a) == ToLowerASCIIReference(b);
+      for (size_t pos = 0; pos < kLength; pos += 7) {
+        std::string str_a(kLength, 'q');
+        std::string str_b(kLength, 'Q');
+        str_a[pos] = a;
+        str_b[pos] = b;
+        EXPECT_EQ(equal ? kLength : pos,
+                  FindCaseInsensitiveMismatchASCII(str_a.data(), str_b.data(),
+                                                   kLength));
+      }
+    }
+  }
+}
+
+TEST(ASCIIFastPathTest, CopyChangeCaseASCII) {
+  for (size_t offset = 0; offset < kMaxOffset; ++offset) {
+    for (size_t length = 0; length < kMaxLength; ++length) {
+      std::string src(offset + length, '\0');
+      for (size_t i = 0; i < length; ++i)
+        src[offset + i] = static_cast<char>((i * 7 + offset) % 256);
+      std::string lower(length + 1, 'z');
+      std::string upper(length + 1, 'z');
+      CopyLowerCaseASCII(src.data() + offset, length, &lower[0]);
+      CopyUpperCaseASCII(src.data() + offset, length, &upper[0]);
+      for (size_t i = 0; i < length; ++i) {
+        EXPECT_EQ(ToLowerASCIIReference(src[offset + i]), lower[i]);
+        EXPECT_EQ(ToUpperASCIIReference(src[offset + i]), upper[i]);
+      }
+      // Nothing is written past the end.
+      EXPECT_EQ('z', lower[length]);
+      EXPECT_EQ('z', upper[length]);
+    }
+  }
+}
+
+}  // namespace internal
+}  // namespace base
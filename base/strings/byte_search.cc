@@ -0,0 +1,280 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/strings/byte_search.h"
+
+#include <limits.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "base/bits.h"
+#include "build/build_config.h"
+
+#if defined(ARCH_CPU_X86_FAMILY) && !defined(OS_NACL)
+#include <emmintrin.h>
+#define BYTE_SEARCH_SSE2
+#endif
+
+#if defined(ARCH_CPU_X86_64) && !defined(OS_NACL)
+// Include order is important, so we disable formatting.
+// clang-format off
+#include <immintrin.h>
+#include <avxintrin.h>
+#include <avx2intrin.h>
+// clang-format on
+#include "base/cpu.h"
+#define BYTE_SEARCH_AVX2
+#endif
+
+namespace base {
+namespace internal {
+
+namespace {
+
+// Sets of up to this many bytes are searched for with one comparison per byte
+// of the set. Larger sets use a lookup table.
+constexpr size_t kMaxVectorizedSetSize = 16;
+
+// Shorter inputs are searched for any set without a lookup table.
+constexpr size_t kMinLengthForLookupTable = 64;
+
+// Portable kernels ------------------------------------------------------------
+// These use the C library, which is vectorized on most platforms, and also
+// finish the searches left over by the SIMD kernels.
+
+// Requires |needle_size| > 0.
+const char* FindBytesPortable(const char* haystack,
+                              size_t haystack_size,
+                              const char* needle,
+                              size_t needle_size) {
+  if (needle_size > haystack_size)
+    return nullptr;
+  const char* const last_start = haystack + haystack_size - needle_size;
+  for (const char* p = haystack; p <= last_start; ++p) {
+    p = static_cast<const char*>(memchr(p, needle[0], last_start - p + 1));
+    if (!p)
+      return nullptr;
+    if (!memcmp(p + 1, needle + 1, needle_size - 1))
+      return p;
+  }
+  return nullptr;
+}
+
+const char* FindFirstOfBytesPortable(const char* src,
+                                     size_t length,
+                                     const char* set,
+                                     size_t set_size) {
+  // Short inputs, like the tails left over by the SIMD kernels, are not worth
+  // building the lookup table for.
+  if (length < kMinLengthForLookupTable) {
+    for (size_t i = 0; i < length; ++i) {
+      if (memchr(set, src[i], set_size))
+        return src + i;
+    }
+    return nullptr;
+  }
+
+  bool lookup[UCHAR_MAX + 1] = {false};
+  for (size_t i = 0; i < set_size; ++i)
+    lookup[static_cast<unsigned char>(set[i])] = true;
+  for (size_t i = 0; i < length; ++i) {
+    if (lookup[static_cast<unsigned char>(src[i])])
+      return src + i;
+  }
+  return nullptr;
+}
+
+// SSE2 kernels ----------------------------------------------------------------
+
+#if defined(BYTE_SEARCH_SSE2)
+
+// Compares blocks of candidate start positions against both the first and
+// the last byte of the needle, and only compares the rest of the needle at
+// the positions where both match. Requires |needle_size| >= 2.
+const char* FindBytesSse2(const char* haystack,
+                          size_t haystack_size,
+                          const char* needle,
+                          size_t needle_size) {
+  if (needle_size > haystack_size)
+    return nullptr;
+  const __m128i first = _mm_set1_epi8(needle[0]);
+  const __m128i last = _mm_set1_epi8(needle[needle_size - 1]);
+  const size_t num_starts = haystack_size - needle_size + 1;
+  size_t i = 0;
+  while (i + sizeof(__m128i) <= num_starts) {
+    // Where the first byte is rare, memchr() skips ahead faster than this
+    // loop, so only the block following each occurrence is compared.
+    const char* next = static_cast<const char*>(
+        memchr(haystack + i, needle[0], num_starts - i));
+    if (!next)
+      return nullptr;
+    i = static_cast<size_t>(next - haystack);
+    if (i + sizeof(__m128i) > num_starts)
+      break;
+    const __m128i block_first =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(haystack + i));
+    const __m128i block_last = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(haystack + i + needle_size - 1));
+    uint32_t mask = static_cast<uint32_t>(
+        _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(block_first, first),
+                                        _mm_cmpeq_epi8(block_last, last))));
+    while (mask) {
+      const char* candidate = haystack + i + bits::CountTrailingZeroBits(mask);
+      if (!memcmp(candidate + 1, needle + 1, needle_size - 2))
+        return candidate;
+      mask &= mask - 1;
+    }
+    i += sizeof(__m128i);
+  }
+  return FindBytesPortable(haystack + i, haystack_size - i, needle,
+                           needle_size);
+}
+
+const char* FindFirstOfBytesSse2(const char* src,
+                                 size_t length,
+                                 const char* set,
+                                 size_t set_size) {
+  if (set_size > kMaxVectorizedSetSize)
+    return FindFirstOfBytesPortable(src, length, set, set_size);
+  __m128i set_bytes[kMaxVectorizedSetSize];
+  for (size_t j = 0; j < set_size; ++j)
+    set_bytes[j] = _mm_set1_epi8(set[j]);
+  size_t i = 0;
+  for (; i + sizeof(__m128i) <= length; i += sizeof(__m128i)) {
+    const __m128i block =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    __m128i matches = _mm_cmpeq_epi8(block, set_bytes[0]);
+    for (size_t j = 1; j < set_size; ++j)
+      matches = _mm_or_si128(matches, _mm_cmpeq_epi8(block, set_bytes[j]));
+    const int mask = _mm_movemask_epi8(matches);
+    if (mask)
+      return src + i + bits::CountTrailingZeroBits(static_cast<uint32_t>(mask));
+  }
+  return FindFirstOfBytesPortable(src + i, length - i, set, set_size);
+}
+
+#endif  // defined(BYTE_SEARCH_SSE2)
+
+// AVX2 kernels ----------------------------------------------------------------
+
+#if defined(BYTE_SEARCH_AVX2)
+
+// The AVX2 kernels finish with the SSE2 ones, which are not VEX-encoded, so
+// they clear the upper halves of the vector registers first to avoid the
+// penalty for mixing the two.
+
+__attribute__((target("avx2"))) const char* FindBytesAvx2(
+    const char* haystack,
+    size_t haystack_size,
+    const char* needle,
+    size_t needle_size) {
+  if (needle_size > haystack_size)
+    return nullptr;
+  const __m256i first = _mm256_set1_epi8(needle[0]);
+  const __m256i last = _mm256_set1_epi8(needle[needle_size - 1]);
+  const size_t num_starts = haystack_size - needle_size + 1;
+  size_t i = 0;
+  while (i + sizeof(__m256i) <= num_starts) {
+    const char* next = static_cast<const char*>(
+        memchr(haystack + i, needle[0], num_starts - i));
+    if (!next)
+      return nullptr;
+    i = static_cast<size_t>(next - haystack);
+    if (i + sizeof(__m256i) > num_starts)
+      break;
+    const __m256i block_first =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(haystack + i));
+    const __m256i block_last = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(haystack + i + needle_size - 1));
+    uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(
+        _mm256_and_si256(_mm256_cmpeq_epi8(block_first, first),
+                         _mm256_cmpeq_epi8(block_last, last))));
+    while (mask) {
+      const char* candidate = haystack + i + bits::CountTrailingZeroBits(mask);
+      if (!memcmp(candidate + 1, needle + 1, needle_size - 2))
+        return candidate;
+      mask &= mask - 1;
+    }
+    i += sizeof(__m256i);
+  }
+  _mm256_zeroupper();
+  return FindBytesSse2(haystack + i, haystack_size - i, needle, needle_size);
+}
+
+__attribute__((target("avx2"))) const char* FindFirstOfBytesAvx2(
+    const char* src,
+    size_t length,
+    const char* set,
+    size_t set_size) {
+  if (set_size > kMaxVectorizedSetSize)
+    return FindFirstOfBytesPortable(src, length, set, set_size);
+  __m256i set_bytes[kMaxVectorizedSetSize];
+  for (size_t j = 0; j < set_size; ++j)
+    set_bytes[j] = _mm256_set1_epi8(set[j]);
+  size_t i = 0;
+  for (; i + sizeof(__m256i) <= length; i += sizeof(__m256i)) {
+    const __m256i block =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    __m256i matches = _mm256_cmpeq_epi8(block, set_bytes[0]);
+    for (size_t j = 1; j < set_size; ++j) {
+      matches =
+          _mm256_or_si256(matches, _mm256_cmpeq_epi8(block, set_bytes[j]));
+    }
+    const uint32_t mask =
+        static_cast<uint32_t>(_mm256_movemask_epi8(matches));
+    if (mask)
+      return src + i + bits::CountTrailingZeroBits(mask);
+  }
+  _mm256_zeroupper();
+  return FindFirstOfBytesSse2(src + i, length - i, set, set_size);
+}
+
+#endif  // defined(BYTE_SEARCH_AVX2)
+
+}  // namespace
+
+const char* FindBytes(const char* haystack,
+                      size_t haystack_size,
+                      const char* needle,
+                      size_t needle_size) {
+  if (needle_size == 0)
+    return haystack;
+  // memchr() is already vectorized.
+  if (needle_size == 1) {
+    return haystack_size ? static_cast<const char*>(
+                               memchr(haystack, needle[0], haystack_size))
+                         : nullptr;
+  }
+#if defined(BYTE_SEARCH_AVX2)
+  if (CPU::CanUseAVX2())
+    return FindBytesAvx2(haystack, haystack_size, needle, needle_size);
+#endif
+#if defined(BYTE_SEARCH_SSE2)
+  return FindBytesSse2(haystack, haystack_size, needle, needle_size);
+#else
+  return FindBytesPortable(haystack, haystack_size, needle, needle_size);
+#endif
+}
+
+const char* FindFirstOfBytes(const char* src,
+                             size_t length,
+                             const char* set,
+                             size_t set_size) {
+  if (!length || !set_size)
+    return nullptr;
+  if (set_size == 1)
+    return static_cast<const char*>(memchr(src, set[0], length));
+#if defined(BYTE_SEARCH_AVX2)
+  if (CPU::CanUseAVX2())
+    return FindFirstOfBytesAvx2(src, length, set, set_size);
+#endif
+#if defined(BYTE_SEARCH_SSE2)
+  return FindFirstOfBytesSse2(src, length, set, set_size);
+#else
+  return FindFirstOfBytesPortable(src, length, set, set_size);
+#endif
+}
+
+}  // namespace internal
+}  // namespace base
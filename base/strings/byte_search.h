@@ -0,0 +1,37 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Vectorized memchr()-style searches, used by the 8-bit StringPiece::find()
+// and find_first_of(). The best available SIMD extension is picked at runtime
+// on x86-64 (AVX2 if present, else SSE2) and at compile time elsewhere.
+
+#ifndef BASE_STRINGS_BYTE_SEARCH_H_
+#define BASE_STRINGS_BYTE_SEARCH_H_
+
+#include <stddef.h>
+
+#include "base/base_export.h"
+
+namespace base {
+namespace internal {
+
+// Returns a pointer to the first occurrence of the |needle_size| bytes at
+// |needle| in the |haystack_size| bytes at |haystack|, or nullptr if there is
+// none. Like memmem(), an empty needle is found at |haystack|.
+BASE_EXPORT const char* FindBytes(const char* haystack,
+                                  size_t haystack_size,
+                                  const char* needle,
+                                  size_t needle_size);
+
+// Returns a pointer to the first of the |length| bytes at |src| that is one of
+// the |set_size| bytes at |set|, or nullptr if there is none.
+BASE_EXPORT const char* FindFirstOfBytes(const char* src,
+                                         size_t length,
+                                         const char* set,
+                                         size_t set_size);
+
+}  // namespace internal
+}  // namespace base
+
+#endif  // BASE_STRINGS_BYTE_SEARCH_H_
@@ -0,0 +1,144 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/strings/byte_search.h"
+
+#include <string>
+
+#include "base/rand_util.h"
+#include "base/strings/string_piece.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+namespace internal {
+
+namespace {
+
+// Longer than the widest vector, plus slack to shift the start of the input
+// across all alignments.
+constexpr size_t kMaxLength = 100;
+constexpr size_t kMaxOffset = 32;
+
+const char* FindBytesReference(StringPiece haystack, StringPiece needle) {
+  for (size_t i = 0; i + needle.size() <= haystack.size(); ++i) {
+    if (haystack.substr(i, needle.size()) == needle)
+      return haystack.data() + i;
+  }
+  return nullptr;
+}
+
+const char* FindFirstOfBytesReference(StringPiece src, StringPiece set) {
+  for (size_t i = 0; i < src.size(); ++i) {
+    for (char c : set) {
+      if (src[i] == c)
+        return src.data() + i;
+    }
+  }
+  return nullptr;
+}
+
+// Returns a string of |length| chars drawn from the first |alphabet_size|
+// lower case letters, so that short needles are likely to occur in it.
+std::string RandomString(size_t length, int alphabet_size) {
+  std::string str(length, '\0');
+  for (char& c : str)
+    c = static_cast<char>('a' + RandInt(0, alphabet_size - 1));
+  return str;
+}
+
+}  // namespace
+
+TEST(ByteSearchTest, FindBytesEmptyNeedle) {
+  const char haystack[] = "abc";
+  EXPECT_EQ(haystack, FindBytes(haystack, 3, "", 0));
+  EXPECT_EQ(haystack, FindBytes(haystack, 0, "", 0));
+}
+
+TEST(ByteSearchTest, FindBytesAtEveryPosition) {
+  for (size_t needle_size = 1; needle_size < 40; needle_size += 3) {
+    const std::string needle = std::string(needle_size - 1, 'x') + 'y';
+    for (size_t offset = 0; offset < kMaxOffset; ++offset) {
+      for (size_t length = 0; length < kMaxLength; ++length) {
+        // The needle just past the end must not be found.
+        std::string str = std::string(offset + length, 'x') + needle;
+        const char* haystack = str.data() + offset;
+        EXPECT_EQ(nullptr,
+                  FindBytes(haystack, length, needle.data(), needle.size()));
+        for (size_t pos = 0; pos + needle_size <= length; ++pos) {
+          str[offset + pos + needle_size - 1] = 'y';
+          EXPECT_EQ(haystack + pos, FindBytes(haystack, length, needle.data(),
+                                              needle.size()));
+          str[offset + pos + needle_size - 1] = 'x';
+        }
+      }
+    }
+  }
+}
+
+TEST(ByteSearchTest, FindBytesPartialMatches) {
+  // Candidates matching the first and last byte of the needle but not the
+  // middle must be skipped.
+  const std::string haystack = "abxbaabxba" + std::string(64, 'a') + "abcba";
+  EXPECT_EQ(haystack.size() - 5,
+            static_cast<size_t>(
+                FindBytes(haystack.data(), haystack.size(), "abcba", 5) -
+                haystack.data()));
+  EXPECT_EQ(nullptr, FindBytes(haystack.data(), haystack.size(), "abcbb", 5));
+}
+
+TEST(ByteSearchTest, FindBytesRandom) {
+  for (int i = 0; i < 10000; ++i) {
+    const std::string haystack =
+        RandomString(RandInt(0, kMaxLength * 2), RandInt(1, 4));
+    const std::string needle = RandomString(RandInt(1, 8), RandInt(1, 4));
+    EXPECT_EQ(FindBytesReference(haystack, needle),
+              FindBytes(haystack.data(), haystack.size(), needle.data(),
+                        needle.size()))
+        << haystack << " " << needle;
+  }
+}
+
+TEST(ByteSearchTest, FindFirstOfBytesEmpty) {
+  EXPECT_EQ(nullptr, FindFirstOfBytes("abc", 3, "", 0));
+  EXPECT_EQ(nullptr, FindFirstOfBytes("", 0, "abc", 3));
+}
+
+TEST(ByteSearchTest, FindFirstOfBytesAtEveryPosition) {
+  // Covers sets searched with vector comparisons and with the lookup table.
+  for (size_t set_size : {1, 2, 3, 16, 17, 40}) {
+    std::string set;
+    for (size_t i = 0; i < set_size; ++i)
+      set.push_back(static_cast<char>(0x80 + i));
+    for (size_t offset = 0; offset < kMaxOffset; ++offset) {
+      for (size_t length = 0; length < kMaxLength; ++length) {
+        std::string str(offset + length + 1, 'a');
+        str.back() = set[0];
+        const char* src = str.data() + offset;
+        EXPECT_EQ(nullptr,
+                  FindFirstOfBytes(src, length, set.data(), set.size()));
+        for (size_t pos = 0; pos < length; ++pos) {
+          str[offset + pos] = set[pos % set_size];
+          EXPECT_EQ(src + pos,
+                    FindFirstOfBytes(src, length, set.data(), set.size()));
+          str[offset + pos] = 'a';
+        }
+      }
+    }
+  }
+}
+
+TEST(ByteSearchTest, FindFirstOfBytesRandom) {
+  for (int i = 0; i < 10000; ++i) {
+    const std::string src =
+        RandomString(RandInt(0, kMaxLength * 2), RandInt(1, 26));
+    const std::string set = RandomString(RandInt(1, 24), 26);
+    EXPECT_EQ(
+        FindFirstOfBytesReference(src, set),
+        FindFirstOfBytes(src.data(), src.size(), set.data(), set.size()))
+        << src << " " << set;
+  }
+}
+
+}  // namespace internal
+}  // namespace base
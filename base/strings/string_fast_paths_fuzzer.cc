@@ -0,0 +1,74 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Checks the vectorized 8-bit string searches, case-insensitive comparisons
+// and case conversions against straightforward implementations.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+
+#include "base/check_op.h"
+#include "base/strings/string_piece.h"
+#include "base/strings/string_util.h"
+
+namespace {
+
+int Sign(int value) {
+  return (value > 0) - (value < 0);
+}
+
+int CompareCaseInsensitiveASCIIReference(base::StringPiece a,
+                                         base::StringPiece b) {
+  for (size_t i = 0; i < a.size() && i < b.size(); ++i) {
+    const char lower_a = base::ToLowerASCII(a[i]);
+    const char lower_b = base::ToLowerASCII(b[i]);
+    if (lower_a != lower_b)
+      return lower_a < lower_b ? -1 : 1;
+  }
+  if (a.size() == b.size())
+    return 0;
+  return a.size() < b.size() ? -1 : 1;
+}
+
+}  // namespace
+
+// Entry point for LibFuzzer.
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  if (size < 2)
+    return 0;
+
+  // The first byte picks how the rest is split into a string and a pattern,
+  // the second where the search starts.
+  const size_t rest_size = size - 2;
+  const size_t pattern_size = rest_size ? data[0] % (rest_size + 1) : 0;
+  const std::string pattern(reinterpret_cast<const char*>(data + 2),
+                            pattern_size);
+  const std::string str(reinterpret_cast<const char*>(data + 2 + pattern_size),
+                        rest_size - pattern_size);
+  const size_t pos = data[1];
+  const base::StringPiece str_piece(str);
+  const base::StringPiece pattern_piece(pattern);
+
+  CHECK_EQ(str.find(pattern, pos), str_piece.find(pattern_piece, pos));
+  CHECK_EQ(str.find_first_of(pattern, pos),
+           str_piece.find_first_of(pattern_piece, pos));
+
+  CHECK_EQ(CompareCaseInsensitiveASCIIReference(str, pattern),
+           Sign(base::CompareCaseInsensitiveASCII(str, pattern)));
+  CHECK_EQ(CompareCaseInsensitiveASCIIReference(str, pattern) == 0,
+           base::EqualsCaseInsensitiveASCII(str, pattern));
+
+  const std::string lower = base::ToLowerASCII(str);
+  const std::string upper = base::ToUpperASCII(str);
+  CHECK_EQ(str.size(), lower.size());
+  CHECK_EQ(str.size(), upper.size());
+  for (size_t i = 0; i < str.size(); ++i) {
+    CHECK_EQ(base::ToLowerASCII(str[i]), lower[i]);
+    CHECK_EQ(base::ToUpperASCII(str[i]), upper[i]);
+  }
+
+  return 0;
+}
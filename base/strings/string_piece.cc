@@ -10,6 +10,7 @@
 #include <ostream>
 #include <string>
 
+#include "base/strings/byte_search.h"
 #include "base/strings/utf_string_conversions.h"
 #include "build/build_config.h"
 
@@ -68,8 +69,16 @@ size_t findT(T self, T s, size_t pos) {
   return xpos + s.size() <= self.size() ? xpos : BasicStringPiece<CharT>::npos;
 }
 
+// 8-bit version using the vectorized search.
 size_t find(StringPiece self, StringPiece s, size_t pos) {
-  return findT(self, s, pos);
+  if (pos > self.size())
+    return StringPiece::npos;
+  if (s.empty())
+    return pos;
+
+  const char* result =
+      FindBytes(self.data() + pos, self.size() - pos, s.data(), s.size());
+  return result ? static_cast<size_t>(result - self.data()) : StringPiece::npos;
 }
 
 size_t find(StringPiece16 self, StringPiece16 s, size_t pos) {
@@ -100,23 +109,14 @@ size_t rfind(StringPiece16 self, StringPiece16 s, size_t pos) {
   return rfindT(self, s, pos);
 }
 
-// 8-bit version using lookup table.
+// 8-bit version using the vectorized search.
 size_t find_first_of(StringPiece self, StringPiece s, size_t pos) {
-  if (self.size() == 0 || s.size() == 0)
+  if (pos >= self.size() || s.size() == 0)
     return StringPiece::npos;
 
-  // Avoid the cost of BuildLookupTable() for a single-character search.
-  if (s.size() == 1)
-    return self.find(s.data()[0], pos);
-
-  bool lookup[UCHAR_MAX + 1] = { false };
-  BuildLookupTable(s, lookup);
-  for (size_t i = pos; i < self.size(); ++i) {
-    if (lookup[static_cast<unsigned char>(self.data()[i])]) {
-      return i;
-    }
-  }
-  return StringPiece::npos;
+  const char* result = FindFirstOfBytes(self.data() + pos, self.size() - pos,
+                                        s.data(), s.size());
+  return result ? static_cast<size_t>(result - self.data()) : StringPiece::npos;
 }
 
 // Generic brute force version.
@@ -24,6 +24,7 @@
 #include "base/check_op.h"
 #include "base/cxx17_backports.h"
 #include "base/no_destructor.h"
+#include "base/strings/ascii_fast_path.h"
 #include "base/strings/string_util_internal.h"
 #include "base/strings/utf_string_conversion_utils.h"
 #include "base/strings/utf_string_conversions.h"
@@ -73,7 +74,9 @@ bool IsWprintfFormatPortable(const wchar_t* format) {
 }
 
 std::string ToLowerASCII(StringPiece str) {
-  return internal::ToLowerASCIIImpl(str);
+  std::string ret(str.size(), '\0');
+  internal::CopyLowerCaseASCII(str.data(), str.size(), ret.data());
+  return ret;
 }
 
 std::u16string ToLowerASCII(StringPiece16 str) {
@@ -81,7 +84,9 @@ std::u16string ToLowerASCII(StringPiece16 str) {
 }
 
 std::string ToUpperASCII(StringPiece str) {
-  return internal::ToUpperASCIIImpl(str);
+  std::string ret(str.size(), '\0');
+  internal::CopyUpperCaseASCII(str.data(), str.size(), ret.data());
+  return ret;
 }
 
 std::u16string ToUpperASCII(StringPiece16 str) {
@@ -89,7 +94,17 @@ std::u16string ToUpperASCII(StringPiece16 str) {
 }
 
 int CompareCaseInsensitiveASCII(StringPiece a, StringPiece b) {
-  return internal::CompareCaseInsensitiveASCIIT(a, b);
+  const size_t length = std::min(a.size(), b.size());
+  const size_t i =
+      internal::FindCaseInsensitiveMismatchASCII(a.data(), b.data(), length);
+  if (i < length) {
+    // Like CompareCaseInsensitiveASCIIT(), this compares the folded chars, so
+    // the sign of non-ASCII bytes depends on whether char is signed.
+    return ToLowerASCII(a[i]) < ToLowerASCII(b[i]) ? -1 : 1;
+  }
+  if (a.size() == b.size())
+    return 0;
+  return a.size() < b.size() ? -1 : 1;
 }
 
 int CompareCaseInsensitiveASCII(StringPiece16 a, StringPiece16 b) {
@@ -98,7 +113,8 @@ int CompareCaseInsensitiveASCII(StringPiece16 a, StringPiece16 b) {
 
 bool EqualsCaseInsensitiveASCII(StringPiece a, StringPiece b) {
   return a.size() == b.size() &&
-         internal::CompareCaseInsensitiveASCIIT(a, b) == 0;
+         internal::FindCaseInsensitiveMismatchASCII(a.data(), b.data(),
+                                                    a.size()) == a.size();
 }
 
 bool EqualsCaseInsensitiveASCII(StringPiece16 a, StringPiece16 b) {
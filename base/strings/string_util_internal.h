@@ -274,8 +274,7 @@ bool StartsWithT(T str, T search_for, CompareCase case_sensitivity) {
       return source == search_for;
 
     case CompareCase::INSENSITIVE_ASCII:
-      return std::equal(search_for.begin(), search_for.end(), source.begin(),
-                        CaseInsensitiveCompareASCII<CharT>());
+      return EqualsCaseInsensitiveASCII(source, search_for);
 
     default:
       NOTREACHED();
@@ -296,8 +295,7 @@ bool EndsWithT(T str, T search_for, CompareCase case_sensitivity) {
       return source == search_for;
 
     case CompareCase::INSENSITIVE_ASCII:
-      return std::equal(source.begin(), source.end(), search_for.begin(),
-                        CaseInsensitiveCompareASCII<CharT>());
+      return EqualsCaseInsensitiveASCII(source, search_for);
 
     default:
       NOTREACHED();
@@ -311,7 +309,7 @@ struct SubstringMatcher {
   BasicStringPiece<CharT> find_this;
 
   size_t Find(const std::basic_string<CharT>& input, size_t pos) {
-    return input.find(find_this.data(), pos, find_this.length());
+    return BasicStringPiece<CharT>(input).find(find_this, pos);
   }
   size_t MatchSize() { return find_this.length(); }
 };
@@ -328,8 +326,8 @@ struct CharacterMatcher {
   BasicStringPiece<CharT> find_any_of_these;
 
   size_t Find(const std::basic_string<CharT>& input, size_t pos) {
-    return input.find_first_of(find_any_of_these.data(), pos,
-                               find_any_of_these.length());
+    return BasicStringPiece<CharT>(input).find_first_of(find_any_of_these,
+                                                        pos);
   }
   constexpr size_t MatchSize() { return 1; }
 };
@@ -6,6 +6,8 @@
 
 #include <cinttypes>
 
+#include "base/strings/string_piece.h"
+#include "base/strings/utf_string_conversions.h"
 #include "base/time/time.h"
 #include "build/build_config.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -43,4 +45,102 @@ TEST(StringUtilTest, DISABLED_IsStringASCIIPerf) {
   }
 }
 
+// Measures converting a string of |str_length| ASCII characters, with one
+// non-ASCII character every |non_ascii_interval| characters, to UTF-16 and
+// back.
+void MeasureUTFConversion(size_t str_length, size_t non_ascii_interval) {
+  std::u16string utf16(str_length, 'A');
+  for (size_t i = non_ascii_interval - 1; i < str_length;
+       i += non_ascii_interval) {
+    utf16[i] = u'\x00e9';
+  }
+  const std::string utf8 = UTF16ToUTF8(utf16);
+  const size_t iterations = (1 << 26) / str_length;
+
+  std::u16string converted16;
+  TimeTicks t0 = TimeTicks::Now();
+  for (size_t i = 0; i < iterations; ++i)
+    UTF8ToUTF16(utf8.data(), utf8.size(), &converted16);
+  TimeDelta utf8_to_utf16_time = TimeTicks::Now() - t0;
+  EXPECT_EQ(utf16, converted16);
+
+  std::string converted8;
+  t0 = TimeTicks::Now();
+  for (size_t i = 0; i < iterations; ++i)
+    UTF16ToUTF8(utf16.data(), utf16.size(), &converted8);
+  TimeDelta utf16_to_utf8_time = TimeTicks::Now() - t0;
+  EXPECT_EQ(utf8, converted8);
+
+  printf(
+      "length:\t%zu\tnon-ascii-interval:\t%zu\tUTF8ToUTF16-Mchars/s:\t%.1f"
+      "\tUTF16ToUTF8-Mchars/s:\t%.1f\n",
+      str_length, non_ascii_interval,
+      iterations * str_length / utf8_to_utf16_time.InMicrosecondsF(),
+      iterations * str_length / utf16_to_utf8_time.InMicrosecondsF());
+}
+
+TEST(StringUtilTest, DISABLED_UTFConversionPerf) {
+  for (size_t str_length = 16; str_length <= 4096; str_length *= 4) {
+    // The largest interval is beyond the length, i.e. pure ASCII.
+    for (size_t non_ascii_interval : {2, 16, 64, 8192})
+      MeasureUTFConversion(str_length, non_ascii_interval);
+  }
+}
+
+// Measures the 8-bit case-insensitive comparison, case conversion and searches
+// over strings of |str_length| characters, where the compared strings and the
+// searched for bytes only differ or occur at the end.
+void MeasureStringSearchAndCase(size_t str_length) {
+  std::string lower(str_length, 'a');
+  for (size_t i = 0; i < str_length; ++i)
+    lower[i] = static_cast<char>('a' + i % 26);
+  const std::string upper = ToUpperASCII(lower);
+  std::string haystack(str_length, 'x');
+  haystack.replace(str_length - 3, 3, "key");
+  const StringPiece haystack_piece(haystack);
+  const size_t iterations = (1 << 26) / str_length;
+
+  size_t equal_count = 0;
+  TimeTicks t0 = TimeTicks::Now();
+  for (size_t i = 0; i < iterations; ++i)
+    equal_count += EqualsCaseInsensitiveASCII(lower, upper);
+  TimeDelta equals_time = TimeTicks::Now() - t0;
+  EXPECT_EQ(iterations, equal_count);
+
+  size_t converted_size = 0;
+  t0 = TimeTicks::Now();
+  for (size_t i = 0; i < iterations; ++i)
+    converted_size += ToLowerASCII(upper).size();
+  TimeDelta to_lower_time = TimeTicks::Now() - t0;
+  EXPECT_EQ(iterations * str_length, converted_size);
+
+  size_t found = 0;
+  t0 = TimeTicks::Now();
+  for (size_t i = 0; i < iterations; ++i)
+    found += haystack_piece.find("key");
+  TimeDelta find_time = TimeTicks::Now() - t0;
+  EXPECT_EQ(iterations * (str_length - 3), found);
+
+  found = 0;
+  t0 = TimeTicks::Now();
+  for (size_t i = 0; i < iterations; ++i)
+    found += haystack_piece.find_first_of("\r\n;ey");
+  TimeDelta find_first_of_time = TimeTicks::Now() - t0;
+  EXPECT_EQ(iterations * (str_length - 2), found);
+
+  printf(
+      "length:\t%zu\tEqualsCaseInsensitiveASCII-Mchars/s:\t%.1f"
+      "\tToLowerASCII-Mchars/s:\t%.1f\tfind-Mchars/s:\t%.1f"
+      "\tfind_first_of-Mchars/s:\t%.1f\n",
+      str_length, iterations * str_length / equals_time.InMicrosecondsF(),
+      iterations * str_length / to_lower_time.InMicrosecondsF(),
+      iterations * str_length / find_time.InMicrosecondsF(),
+      iterations * str_length / find_first_of_time.InMicrosecondsF());
+}
+
+TEST(StringUtilTest, DISABLED_StringSearchAndCasePerf) {
+  for (size_t str_length = 16; str_length <= 4096; str_length *= 4)
+    MeasureStringSearchAndCase(str_length);
+}
+
 }  // namespace base
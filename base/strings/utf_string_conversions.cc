@@ -10,6 +10,7 @@
 #include <ostream>
 #include <type_traits>
 
+#include "base/strings/ascii_fast_path.h"
 #include "base/strings/string_piece.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversion_utils.h"
@@ -85,6 +86,32 @@ void UnicodeAppendUnsafe(Char* out, int32_t* size, uint32_t code_point) {
   out[(*size)++] = code_point;
 }
 
+// CopyASCIIRun ---------------------------------------------------------------
+// Function overloads that copy the run of ASCII code units at the start of src
+// to dest, and return its length. ASCII is encoded the same way in all
+// encodings and is always valid, so this is the fast path of the conversions
+// below. Dest has to have enough room for length code units.
+
+size_t CopyASCIIRun(const char* src, size_t length, char16_t* dest) {
+  return internal::CopyLeadingASCII(src, length, dest);
+}
+
+size_t CopyASCIIRun(const char16_t* src, size_t length, char* dest) {
+  return internal::CopyLeadingASCII(src, length, dest);
+}
+
+// Wide strings are rare enough to not need vectorized kernels.
+template <typename SrcChar, typename DestChar>
+size_t CopyASCIIRun(const SrcChar* src, size_t length, DestChar* dest) {
+  size_t i = 0;
+  for (; i < length; ++i) {
+    if (static_cast<std::make_unsigned_t<SrcChar>>(src[i]) >= 0x80)
+      break;
+    dest[i] = static_cast<DestChar>(src[i]);
+  }
+  return i;
+}
+
 // DoUTFConversion ------------------------------------------------------------
 // Main driver of UTFConversion specialized for different Src encodings.
 // dest has to have enough room for the converted text.
@@ -97,6 +124,18 @@ bool DoUTFConversion(const char* src,
   bool success = true;
 
   for (int32_t i = 0; i < src_len;) {
+    if (CBU8_IS_SINGLE(src[i])) {
+      // Single ASCII characters between non-ASCII ones are not worth a call.
+      int32_t run_length = 1;
+      if (i + 1 < src_len && CBU8_IS_SINGLE(src[i + 1]))
+        run_length = CopyASCIIRun(src + i, src_len - i, dest + *dest_len);
+      else
+        dest[*dest_len] = static_cast<DestChar>(src[i]);
+      i += run_length;
+      *dest_len += run_length;
+      continue;
+    }
+
     int32_t code_point;
     CBU8_NEXT(src, i, src_len, code_point);
 
@@ -131,6 +170,17 @@ bool DoUTFConversion(const char16_t* src,
   // Always have another symbol in order to avoid checking boundaries in the
   // middle of the surrogate pair.
   while (i < src_len - 1) {
+    if (src[i] < 0x80) {
+      int32_t run_length = 1;
+      if (src[i + 1] < 0x80)
+        run_length = CopyASCIIRun(src + i, src_len - i, dest + *dest_len);
+      else
+        dest[*dest_len] = static_cast<DestChar>(src[i]);
+      i += run_length;
+      *dest_len += run_length;
+      continue;
+    }
+
     int32_t code_point;
 
     if (CBU16_IS_LEAD(src[i]) && CBU16_IS_TRAIL(src[i + 1])) {
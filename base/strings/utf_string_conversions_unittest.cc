@@ -200,4 +200,34 @@ TEST(UTFStringConversionsTest, ConvertMultiString) {
   EXPECT_EQ(expected, converted);
 }
 
+// The conversions copy runs of ASCII in bulk, so check that non-ASCII and
+// invalid code units are still found wherever they fall in a run.
+TEST(UTFStringConversionsTest, ConvertMixedASCIIRuns) {
+  for (size_t length = 1; length < 80; ++length) {
+    for (size_t pos = 0; pos < length; ++pos) {
+      std::string utf8(length, 'a');
+      std::u16string utf16(length, u'a');
+      utf8.replace(pos, 1, "\xc3\xa9");
+      utf16[pos] = u'\x00e9';
+      EXPECT_EQ(utf16, UTF8ToUTF16(utf8));
+      EXPECT_EQ(utf8, UTF16ToUTF8(utf16));
+
+      std::u16string converted16;
+      std::string invalid8(length, 'a');
+      invalid8[pos] = '\xff';
+      utf16[pos] = u'\xfffd';
+      EXPECT_FALSE(UTF8ToUTF16(invalid8.data(), invalid8.size(), &converted16));
+      EXPECT_EQ(utf16, converted16);
+
+      std::string converted8;
+      std::u16string invalid16(length, u'a');
+      invalid16[pos] = u'\xdc00';
+      utf8.replace(pos, 2, "\xef\xbf\xbd");
+      EXPECT_FALSE(
+          UTF16ToUTF8(invalid16.data(), invalid16.size(), &converted8));
+      EXPECT_EQ(utf8, converted8);
+    }
+  }
+}
+
 }  // namespace base
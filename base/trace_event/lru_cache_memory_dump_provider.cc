@@ -0,0 +1,58 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/trace_event/lru_cache_memory_dump_provider.h"
+
+#include <utility>
+
+#include "base/threading/sequenced_task_runner_handle.h"
+#include "base/trace_event/memory_allocator_dump.h"
+#include "base/trace_event/memory_dump_manager.h"
+#include "base/trace_event/process_memory_dump.h"
+
+namespace base {
+namespace trace_event {
+
+LRUCacheMemoryDumpProvider::LRUCacheMemoryDumpProvider(
+    const std::string& name,
+    StatsCallback get_stats)
+    : dump_name_("lru_cache/" + name), get_stats_(std::move(get_stats)) {
+  MemoryDumpManager::GetInstance()->RegisterDumpProviderWithSequencedTaskRunner(
+      this, "LRUCache", SequencedTaskRunnerHandle::Get(),
+      MemoryDumpProvider::Options());
+}
+
+LRUCacheMemoryDumpProvider::~LRUCacheMemoryDumpProvider() {
+  MemoryDumpManager::GetInstance()->UnregisterDumpProvider(this);
+}
+
+bool LRUCacheMemoryDumpProvider::OnMemoryDump(const MemoryDumpArgs& args,
+                                              ProcessMemoryDump* pmd) {
+  const LRUCacheStats stats = get_stats_.Run();
+
+  MemoryAllocatorDump* dump = pmd->CreateAllocatorDump(dump_name_);
+  dump->AddScalar(MemoryAllocatorDump::kNameSize,
+                  MemoryAllocatorDump::kUnitsBytes, stats.table_memory_usage);
+  dump->AddScalar(MemoryAllocatorDump::kNameObjectCount,
+                  MemoryAllocatorDump::kUnitsObjects, stats.entry_count);
+  // The budget of the cache is either a number of entries, or assumed to be a
+  // number of bytes.
+  const char* size_units = stats.sizes_are_entry_counts
+                               ? MemoryAllocatorDump::kUnitsObjects
+                               : MemoryAllocatorDump::kUnitsBytes;
+  dump->AddScalar("used_size", size_units, stats.used_size);
+  dump->AddScalar("max_size", size_units, stats.max_size);
+  if (args.level_of_detail == MemoryDumpLevelOfDetail::DETAILED) {
+    dump->AddScalar("hit_count", MemoryAllocatorDump::kUnitsObjects,
+                    stats.hit_count);
+    dump->AddScalar("miss_count", MemoryAllocatorDump::kUnitsObjects,
+                    stats.miss_count);
+    dump->AddScalar("eviction_count", MemoryAllocatorDump::kUnitsObjects,
+                    stats.eviction_count);
+  }
+  return true;
+}
+
+}  // namespace trace_event
+}  // namespace base
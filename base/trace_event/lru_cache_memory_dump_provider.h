@@ -0,0 +1,65 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_TRACE_EVENT_LRU_CACHE_MEMORY_DUMP_PROVIDER_H_
+#define BASE_TRACE_EVENT_LRU_CACHE_MEMORY_DUMP_PROVIDER_H_
+
+#include <string>
+
+#include "base/base_export.h"
+#include "base/callback.h"
+#include "base/containers/sized_lru_cache.h"
+#include "base/trace_event/memory_dump_provider.h"
+
+namespace base {
+namespace trace_event {
+
+// Dump provider which reports the statistics of a SizedLRUCache under
+// "lru_cache/<name>". The dump's size is the memory allocated by the cache
+// itself. The used and maximum sizes of the cache are reported as objects if
+// the cache is bounded by its number of entries (LRUCacheEntryCount), and
+// otherwise in bytes, which assumes that the cache's size function returns
+// bytes.
+//
+// The provider registers itself on the current sequence, where |get_stats| is
+// run (typically bound to SizedLRUCache::GetStats() with Unretained()), and
+// must be destroyed on that sequence, before the cache. Example:
+//
+//   class MyCache {
+//    public:
+//     MyCache()
+//         : cache_(kMaxBytes),
+//           dump_provider_("my_cache",
+//                          BindRepeating(&Cache::GetStats,
+//                                        Unretained(&cache_))) {}
+//    private:
+//     using Cache = SizedLRUCache<std::string, Entry, EntrySize>;
+//     Cache cache_;
+//     LRUCacheMemoryDumpProvider dump_provider_;
+//   };
+class BASE_EXPORT LRUCacheMemoryDumpProvider : public MemoryDumpProvider {
+ public:
+  using StatsCallback = RepeatingCallback<LRUCacheStats()>;
+
+  LRUCacheMemoryDumpProvider(const std::string& name, StatsCallback get_stats);
+
+  LRUCacheMemoryDumpProvider(const LRUCacheMemoryDumpProvider&) = delete;
+  LRUCacheMemoryDumpProvider& operator=(const LRUCacheMemoryDumpProvider&) =
+      delete;
+
+  ~LRUCacheMemoryDumpProvider() override;
+
+  // MemoryDumpProvider implementation.
+  bool OnMemoryDump(const MemoryDumpArgs& args,
+                    ProcessMemoryDump* pmd) override;
+
+ private:
+  const std::string dump_name_;
+  const StatsCallback get_stats_;
+};
+
+}  // namespace trace_event
+}  // namespace base
+
+#endif  // BASE_TRACE_EVENT_LRU_CACHE_MEMORY_DUMP_PROVIDER_H_
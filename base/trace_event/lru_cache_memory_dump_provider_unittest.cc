@@ -0,0 +1,92 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/trace_event/lru_cache_memory_dump_provider.h"
+
+#include <string>
+
+#include "base/bind.h"
+#include "base/containers/sized_lru_cache.h"
+#include "base/test/task_environment.h"
+#include "base/trace_event/memory_allocator_dump.h"
+#include "base/trace_event/process_memory_dump.h"
+#include "testing/gmock/include/gmock/gmock.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+namespace trace_event {
+
+namespace {
+
+struct StringSize {
+  size_t operator()(int key, const std::string& payload) const {
+    return payload.size();
+  }
+};
+
+using Cache = SizedLRUCache<int, std::string, StringSize>;
+
+void CheckScalar(const MemoryAllocatorDump* dump,
+                 const std::string& name,
+                 const char* expected_units,
+                 uint64_t expected_value) {
+  MemoryAllocatorDump::Entry expected(name, expected_units, expected_value);
+  EXPECT_THAT(dump->entries(),
+              testing::Contains(testing::Eq(testing::ByRef(expected))));
+}
+
+}  // namespace
+
+TEST(LRUCacheMemoryDumpProviderTest, DumpsStats) {
+  test::TaskEnvironment task_environment;
+  Cache cache(10);
+  LRUCacheMemoryDumpProvider dump_provider(
+      "test", BindRepeating(&Cache::GetStats, Unretained(&cache)));
+
+  cache.Put(1, "aaaa");
+  cache.Put(2, "bbbb");
+  cache.Put(3, "cccc");
+  cache.Get(3);
+  cache.Get(1);
+
+  MemoryDumpArgs dump_args = {MemoryDumpLevelOfDetail::DETAILED};
+  ProcessMemoryDump pmd(dump_args);
+  ASSERT_TRUE(dump_provider.OnMemoryDump(dump_args, &pmd));
+
+  const MemoryAllocatorDump* dump = pmd.GetAllocatorDump("lru_cache/test");
+  ASSERT_NE(nullptr, dump);
+  CheckScalar(dump, MemoryAllocatorDump::kNameSize,
+              MemoryAllocatorDump::kUnitsBytes,
+              cache.EstimateTableMemoryUsage());
+  CheckScalar(dump, MemoryAllocatorDump::kNameObjectCount,
+              MemoryAllocatorDump::kUnitsObjects, 2);
+  CheckScalar(dump, "used_size", MemoryAllocatorDump::kUnitsBytes, 8);
+  CheckScalar(dump, "max_size", MemoryAllocatorDump::kUnitsBytes, 10);
+  CheckScalar(dump, "hit_count", MemoryAllocatorDump::kUnitsObjects, 1);
+  CheckScalar(dump, "miss_count", MemoryAllocatorDump::kUnitsObjects, 1);
+  CheckScalar(dump, "eviction_count", MemoryAllocatorDump::kUnitsObjects, 1);
+}
+
+TEST(LRUCacheMemoryDumpProviderTest, DumpsEntryCountsAsObjects) {
+  test::TaskEnvironment task_environment;
+  SizedLRUCache<int, int> cache(10);
+  LRUCacheMemoryDumpProvider dump_provider(
+      "test", BindRepeating(&SizedLRUCache<int, int>::GetStats,
+                            Unretained(&cache)));
+
+  cache.Put(1, 1);
+  cache.Put(2, 2);
+
+  MemoryDumpArgs dump_args = {MemoryDumpLevelOfDetail::BACKGROUND};
+  ProcessMemoryDump pmd(dump_args);
+  ASSERT_TRUE(dump_provider.OnMemoryDump(dump_args, &pmd));
+
+  const MemoryAllocatorDump* dump = pmd.GetAllocatorDump("lru_cache/test");
+  ASSERT_NE(nullptr, dump);
+  CheckScalar(dump, "used_size", MemoryAllocatorDump::kUnitsObjects, 2);
+  CheckScalar(dump, "max_size", MemoryAllocatorDump::kUnitsObjects, 10);
+}
+
+}  // namespace trace_event
+}  // namespace base
@@ -23,11 +23,14 @@
 
 #include "base/base_export.h"
 #include "base/containers/circular_deque.h"
+#include "base/containers/flat_hash_map.h"
+#include "base/containers/flat_hash_set.h"
 #include "base/containers/flat_map.h"
 #include "base/containers/flat_set.h"
 #include "base/containers/linked_list.h"
 #include "base/containers/lru_cache.h"
 #include "base/containers/queue.h"
+#include "base/containers/sized_lru_cache.h"
 #include "base/memory/raw_ptr.h"
 #include "base/stl_util.h"
 #include "base/template_util.h"
@@ -178,6 +181,12 @@ size_t EstimateMemoryUsage(const base::flat_set<T, C>& set);
 template <class K, class V, class C>
 size_t EstimateMemoryUsage(const base::flat_map<K, V, C>& map);
 
+template <class T, class H, class E>
+size_t EstimateMemoryUsage(const base::flat_hash_set<T, H, E>& set);
+
+template <class K, class V, class H, class E>
+size_t EstimateMemoryUsage(const base::flat_hash_map<K, V, H, E>& map);
+
 template <class Key,
           class Payload,
           class HashOrComp,
@@ -185,6 +194,10 @@ template <class Key,
           class Map>
 size_t EstimateMemoryUsage(const LRUCacheBase<Key, Payload, HashOrComp, Map>&);
 
+template <class Key, class Payload, class SizeOf, class Hash>
+size_t EstimateMemoryUsage(
+    const base::SizedLRUCache<Key, Payload, SizeOf, Hash>& lru_cache);
+
 // TODO(dskiba):
 //   std::forward_list
 
@@ -652,6 +665,18 @@ size_t EstimateMemoryUsage(const base::flat_map<K, V, C>& map) {
   return sizeof(value_type) * map.capacity() + EstimateIterableMemoryUsage(map);
 }
 
+// Flat hash containers allocate their slots and control bytes in one table.
+
+template <class T, class H, class E>
+size_t EstimateMemoryUsage(const base::flat_hash_set<T, H, E>& set) {
+  return set.EstimateTableMemoryUsage() + EstimateIterableMemoryUsage(set);
+}
+
+template <class K, class V, class H, class E>
+size_t EstimateMemoryUsage(const base::flat_hash_map<K, V, H, E>& map) {
+  return map.EstimateTableMemoryUsage() + EstimateIterableMemoryUsage(map);
+}
+
 template <class Key,
           class Payload,
           class HashOrComp,
@@ -662,6 +687,17 @@ size_t EstimateMemoryUsage(
   return internal::DoEstimateMemoryUsageForLruCache(lru_cache);
 }
 
+template <class Key, class Payload, class SizeOf, class Hash>
+size_t EstimateMemoryUsage(
+    const base::SizedLRUCache<Key, Payload, SizeOf, Hash>& lru_cache) {
+  size_t memory_usage = lru_cache.EstimateTableMemoryUsage() +
+                        EstimateIterableMemoryUsage(lru_cache);
+  // The key index holds a copy of each key.
+  for (const auto& item : lru_cache)
+    memory_usage += EstimateMemoryUsage(item.first);
+  return memory_usage;
+}
+
 }  // namespace trace_event
 }  // namespace base
 
@@ -226,6 +226,41 @@ TEST(EstimateMemoryUsageTest, UnorderedMultiMap) {
   EXPECT_EQ_32_64(515540u, 531580u, EstimateMemoryUsage(map));
 }
 
+TEST(EstimateMemoryUsageTest, FlatHashSet) {
+  base::flat_hash_set<Data, Data::Hasher> set;
+  set.reserve(1000);
+  size_t table_size = set.capacity() * (sizeof(Data) + 1) +
+                      base::internal::HashGroup::kWidth;
+  EXPECT_EQ(table_size, EstimateMemoryUsage(set));
+
+  for (int i = 0; i != 1000; ++i) {
+    set.insert(Data(i));
+  }
+  EXPECT_EQ(table_size + 499500u, EstimateMemoryUsage(set));
+}
+
+TEST(EstimateMemoryUsageTest, FlatHashMap) {
+  base::flat_hash_map<int, Data> map;
+  for (int i = 0; i != 1000; ++i) {
+    map.insert({i, Data(i)});
+  }
+  size_t table_size =
+      map.capacity() * (sizeof(std::pair<int, Data>) + 1) +
+      base::internal::HashGroup::kWidth;
+  EXPECT_EQ(table_size + 499500u, EstimateMemoryUsage(map));
+}
+
+TEST(EstimateMemoryUsageTest, SizedLRUCache) {
+  base::SizedLRUCache<Data, Data, base::LRUCacheEntryCount, Data::Hasher>
+      cache(100);
+  for (int i = 0; i != 100; ++i) {
+    cache.Put(Data(i), Data(i));
+  }
+  // Keys are stored twice, payloads once.
+  EXPECT_EQ(cache.EstimateTableMemoryUsage() + 3 * 4950u,
+            EstimateMemoryUsage(cache));
+}
+
 TEST(EstimateMemoryUsageTest, Deque) {
   std::deque<Data> deque;
 
@@ -34,6 +34,7 @@
 #include "base/synchronization/waitable_event.h"
 #include "base/task/single_thread_task_runner.h"
 #include "base/threading/platform_thread.h"
+#include "base/threading/simple_thread.h"
 #include "base/threading/thread.h"
 #include "base/time/time.h"
 #include "base/trace_event/event_name_filter.h"
@@ -1483,6 +1484,62 @@ TEST_F(TraceEventTestFixture, DataCapturedManyThreads) {
   }
 }
 
+// Emits events from a thread without a message loop, like a thread pool
+// worker, so that they go through the thread's chunk cache.
+class TraceManyEventsDelegate : public DelegateSimpleThread::Delegate {
+ public:
+  TraceManyEventsDelegate(int thread_id, int num_events)
+      : thread_id_(thread_id), num_events_(num_events) {}
+
+  void Run() override {
+    TRACE_EVENT1("test_all", "thread without message loop", "thread",
+                 thread_id_);
+    TraceManyInstantEvents(thread_id_, num_events_, nullptr);
+  }
+
+ private:
+  const int thread_id_;
+  const int num_events_;
+};
+
+// Test that data sent from threads without a message loop is gathered, both
+// from threads that exit before the flush and from threads still running.
+TEST_F(TraceEventTestFixture, DataCapturedManyThreadsWithoutMessageLoop) {
+  BeginTrace();
+
+  const int num_threads = 4;
+  // Not a multiple of the chunk size, so that the last chunk of each thread
+  // is only partially filled when the thread stops adding events.
+  const int num_events = 1000;
+  std::vector<std::unique_ptr<TraceManyEventsDelegate>> delegates;
+  std::vector<std::unique_ptr<DelegateSimpleThread>> threads;
+  for (int i = 0; i < num_threads; i++) {
+    delegates.push_back(
+        std::make_unique<TraceManyEventsDelegate>(i, num_events));
+    threads.push_back(std::make_unique<DelegateSimpleThread>(
+        delegates.back().get(), StringPrintf("Thread %d", i)));
+    threads.back()->Start();
+  }
+  for (auto& thread : threads)
+    thread->Join();
+
+  // The threads are gone, so their cached chunks were returned on exit.
+  // Events from the current thread, which has no ThreadLocalEventBuffer, are
+  // still cached until the flush.
+  TRACE_EVENT_INSTANT0("test_all", "event on flushing thread",
+                       TRACE_EVENT_SCOPE_THREAD);
+
+  EndTraceAndFlush();
+  ValidateInstantEventPresentOnEveryThread(trace_parsed_, num_threads,
+                                           num_events);
+  EXPECT_TRUE(FindNamePhase("event on flushing thread", "i"));
+  std::vector<const Value*> complete_events =
+      FindTraceEntries(trace_parsed_, "thread without message loop");
+  ASSERT_EQ(static_cast<size_t>(num_threads), complete_events.size());
+  for (const Value* complete_event : complete_events)
+    EXPECT_TRUE(complete_event->FindKey("dur"));
+}
+
 // Test that thread and process names show up in the trace
 TEST_F(TraceEventTestFixture, ThreadNames) {
   // Create threads before we enable tracing to make sure
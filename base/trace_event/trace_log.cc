@@ -14,6 +14,7 @@
 #include "base/bind.h"
 #include "base/command_line.h"
 #include "base/containers/contains.h"
+#include "base/containers/cxx20_erase.h"
 #include "base/debug/leak_annotations.h"
 #include "base/location.h"
 #include "base/logging.h"
@@ -621,6 +622,159 @@ void TraceLog::ThreadLocalEventBuffer::FlushWhileLocked() {
   // find the generation mismatch and delete this buffer soon.
 }
 
+// Caches a chunk of the main buffer for a thread that can't own a
+// ThreadLocalEventBuffer, e.g. a thread pool worker or a thread whose message
+// loop may block, so that its events are added without taking |lock_| except
+// once per chunk. Only the owning thread accesses the chunk without |lock_|,
+// and only inside a ScopedWrite. Any thread holding |lock_| can take the
+// chunk back by marking the cache released with ReleaseWhileLocked(), and
+// once no write is in flight, calling TakeChunkWhileLocked(). Both flags are
+// accessed with sequentially consistent ordering, so either the writer
+// observes the release or the releaser observes the write. A writer which
+// observes a release when its write ends signals
+// |thread_chunk_cache_write_ended_|, which releasers wait on.
+class TraceLog::ThreadChunkCache {
+ public:
+  // Allows the owning thread to access the cached chunk until destroyed or
+  // Reset(), unless the chunk has been released. |cache| may be null.
+  class ScopedWrite {
+   public:
+    explicit ScopedWrite(ThreadChunkCache* cache)
+        : cache_(cache && cache->BeginWrite() ? cache : nullptr) {}
+    ScopedWrite(const ScopedWrite&) = delete;
+    ScopedWrite& operator=(const ScopedWrite&) = delete;
+    ~ScopedWrite() { Reset(); }
+
+    // Returns null if the cached chunk can't be accessed.
+    ThreadChunkCache* cache() const { return cache_; }
+
+    void Reset() {
+      if (cache_) {
+        cache_->EndWrite();
+        cache_ = nullptr;
+      }
+    }
+
+   private:
+    raw_ptr<ThreadChunkCache> cache_;
+  };
+
+  explicit ThreadChunkCache(TraceLog* trace_log) : trace_log_(trace_log) {}
+  ThreadChunkCache(const ThreadChunkCache&) = delete;
+  ThreadChunkCache& operator=(const ThreadChunkCache&) = delete;
+  ~ThreadChunkCache() = default;
+
+  TraceLog* trace_log() const { return trace_log_; }
+
+  // Must be called inside a ScopedWrite. Returns null if the chunk is full.
+  TraceEvent* AddTraceEvent(TraceEventHandle* handle) {
+    DCHECK(chunk_);
+    return AddTraceEventToChunk(handle);
+  }
+
+  // Must be called inside a ScopedWrite, or on the owning thread while
+  // holding |lock_|.
+  TraceEvent* GetEventByHandle(TraceEventHandle handle) {
+    if (!chunk_ || handle.chunk_seq != chunk_->seq() ||
+        handle.chunk_index != chunk_index_) {
+      return nullptr;
+    }
+    return chunk_->GetEventAt(handle.event_index);
+  }
+
+  // Replaces a full or released chunk with a new one from the main buffer and
+  // adds the event to it. Called on the owning thread outside of ScopedWrite.
+  TraceEvent* AddTraceEventWhileLocked(TraceEventHandle* handle);
+
+  // Prevents the owning thread from accessing the chunk without |lock_|.
+  // Returns whether a write started before is still in flight.
+  bool ReleaseWhileLocked() {
+    trace_log_->lock_.AssertAcquired();
+    released_.store(true, std::memory_order_seq_cst);
+    return writing_.load(std::memory_order_seq_cst);
+  }
+
+  // Returns the chunk to the main buffer, or discards it if |return_chunk| is
+  // false. Must be called after ReleaseWhileLocked() returned false, without
+  // releasing |lock_| in between.
+  void TakeChunkWhileLocked(bool return_chunk);
+
+  // Discards the chunk, which belongs to a main buffer being replaced. Unlike
+  // TakeChunkWhileLocked(), doesn't wait for a write in flight, whose chunk is
+  // only destroyed when it is next taken.
+  void DiscardChunkWhileLocked();
+
+ private:
+  bool BeginWrite() {
+    writing_.store(true, std::memory_order_seq_cst);
+    if (!released_.load(std::memory_order_seq_cst))
+      return true;
+    writing_.store(false, std::memory_order_release);
+    return false;
+  }
+
+  void EndWrite() {
+    writing_.store(false, std::memory_order_seq_cst);
+    // A releaser may be waiting for this write to end.
+    if (released_.load(std::memory_order_seq_cst))
+      trace_log_->OnThreadChunkCacheWriteEnded();
+  }
+
+  TraceEvent* AddTraceEventToChunk(TraceEventHandle* handle) {
+    size_t event_index;
+    TraceEvent* trace_event = chunk_->AddTraceEvent(&event_index);
+    if (trace_event && handle)
+      MakeHandle(chunk_->seq(), chunk_index_, event_index, handle);
+    return trace_event;
+  }
+
+  // Since TraceLog is a leaky singleton, trace_log_ will always be valid
+  // as long as the thread exists.
+  const raw_ptr<TraceLog> trace_log_;
+  std::unique_ptr<TraceBufferChunk> chunk_;
+  size_t chunk_index_ = 0;
+  // Set when |chunk_| belongs to a replaced main buffer. Guarded by |lock_|.
+  bool chunk_discarded_ = false;
+  std::atomic<bool> writing_{false};
+  // Set while |chunk_| may only be accessed with |lock_| held. There is no
+  // chunk initially.
+  std::atomic<bool> released_{true};
+};
+
+TraceEvent* TraceLog::ThreadChunkCache::AddTraceEventWhileLocked(
+    TraceEventHandle* handle) {
+  trace_log_->lock_.AssertAcquired();
+  // A remaining chunk is either full or discarded, as TakeChunkWhileLocked()
+  // clears |chunk_|.
+  TakeChunkWhileLocked(/*return_chunk=*/true);
+  chunk_ = trace_log_->logged_events_->GetChunk(&chunk_index_);
+  trace_log_->CheckIfBufferIsFullWhileLocked();
+  if (!chunk_)
+    return nullptr;
+
+  released_.store(false, std::memory_order_seq_cst);
+  return AddTraceEventToChunk(handle);
+}
+
+void TraceLog::ThreadChunkCache::TakeChunkWhileLocked(bool return_chunk) {
+  trace_log_->lock_.AssertAcquired();
+  DCHECK(!writing_.load(std::memory_order_relaxed));
+  if (!chunk_)
+    return;
+  if (return_chunk && !chunk_discarded_)
+    trace_log_->logged_events_->ReturnChunk(chunk_index_, std::move(chunk_));
+  else
+    chunk_.reset();
+  chunk_discarded_ = false;
+}
+
+void TraceLog::ThreadChunkCache::DiscardChunkWhileLocked() {
+  if (ReleaseWhileLocked())
+    chunk_discarded_ = true;
+  else
+    TakeChunkWhileLocked(/*return_chunk=*/false);
+}
+
 void TraceLog::SetAddTraceEventOverrides(
     const AddTraceEventOverrideFunction& add_event_override,
     const OnFlushFunction& on_flush_override,
@@ -686,6 +840,9 @@ TraceLog::TraceLog(int generation)
       generation_(generation),
       use_worker_thread_(false) {
   CategoryRegistry::Initialize();
+  // Waits for a write of a single event, which must not be reported as
+  // blocking since that could add trace events.
+  thread_chunk_cache_write_ended_.declare_only_used_while_idle();
 
 #if defined(OS_NACL)  // NaCl shouldn't expose the process id.
   SetProcessID(0);
@@ -739,6 +896,68 @@ void TraceLog::InitializeThreadLocalEventBufferIfSupported() {
   }
 }
 
+TraceLog::ThreadChunkCache* TraceLog::GetThreadChunkCache() const {
+  return static_cast<ThreadChunkCache*>(thread_chunk_cache_.Get());
+}
+
+TraceLog::ThreadChunkCache* TraceLog::GetOrCreateThreadChunkCache() {
+  ThreadChunkCache* thread_chunk_cache = GetThreadChunkCache();
+  if (thread_chunk_cache)
+    return thread_chunk_cache;
+
+  HEAP_PROFILER_SCOPED_IGNORE;
+  auto new_thread_chunk_cache = std::make_unique<ThreadChunkCache>(this);
+  thread_chunk_cache = new_thread_chunk_cache.get();
+  {
+    AutoLock lock(lock_);
+    thread_chunk_caches_.push_back(std::move(new_thread_chunk_cache));
+  }
+  thread_chunk_cache_.Set(thread_chunk_cache);
+  return thread_chunk_cache;
+}
+
+void TraceLog::ReturnThreadChunkCachesWhileLocked() {
+  lock_.AssertAcquired();
+  // Events of writes in flight are still being filled in, so wait for them to
+  // end. The wait releases |lock_|, during which owning threads may replace
+  // their chunks, so all caches are released again after it.
+  for (;;) {
+    bool writing = false;
+    for (const auto& thread_chunk_cache : thread_chunk_caches_)
+      writing |= thread_chunk_cache->ReleaseWhileLocked();
+    if (!writing)
+      break;
+    thread_chunk_cache_write_ended_.Wait();
+  }
+  for (const auto& thread_chunk_cache : thread_chunk_caches_)
+    thread_chunk_cache->TakeChunkWhileLocked(/*return_chunk=*/true);
+}
+
+void TraceLog::DiscardThreadChunkCachesWhileLocked() {
+  lock_.AssertAcquired();
+  for (const auto& thread_chunk_cache : thread_chunk_caches_)
+    thread_chunk_cache->DiscardChunkWhileLocked();
+}
+
+void TraceLog::OnThreadChunkCacheWriteEnded() {
+  AutoLock lock(lock_);
+  thread_chunk_cache_write_ended_.Broadcast();
+}
+
+// static
+void TraceLog::OnThreadChunkCacheThreadExit(void* cache) {
+  auto* thread_chunk_cache = static_cast<ThreadChunkCache*>(cache);
+  TraceLog* trace_log = thread_chunk_cache->trace_log();
+  AutoLock lock(trace_log->lock_);
+  // The exiting thread has no write in flight.
+  thread_chunk_cache->ReleaseWhileLocked();
+  thread_chunk_cache->TakeChunkWhileLocked(/*return_chunk=*/true);
+  base::EraseIf(trace_log->thread_chunk_caches_,
+                [thread_chunk_cache](const auto& entry) {
+                  return entry.get() == thread_chunk_cache;
+                });
+}
+
 bool TraceLog::OnMemoryDump(const MemoryDumpArgs& args,
                             ProcessMemoryDump* pmd) {
   // TODO(ssid): Use MemoryDumpArgs to create light dumps when requested
@@ -1444,6 +1663,8 @@ void TraceLog::FlushInternal(const TraceLog::OutputCallback& cb,
   std::vector<scoped_refptr<SingleThreadTaskRunner>> task_runners;
   {
     AutoLock lock(lock_);
+    // This may release |lock_| for a while, so it comes first.
+    ReturnThreadChunkCachesWhileLocked();
     DCHECK(!flush_task_runner_);
     flush_task_runner_ = SequencedTaskRunnerHandle::IsSet()
                              ? SequencedTaskRunnerHandle::Get()
@@ -1653,6 +1874,8 @@ void TraceLog::OnFlushTimeout(int generation, bool discard_events) {
 }
 
 void TraceLog::UseNextTraceBuffer() {
+  // Chunks still cached by threads belong to the old buffer.
+  DiscardThreadChunkCachesWhileLocked();
   logged_events_.reset(CreateTraceBuffer());
   generation_.fetch_add(1, std::memory_order_relaxed);
   thread_shared_chunk_.reset();
@@ -1902,13 +2125,23 @@ TraceEventHandle TraceLog::AddTraceEventWithThreadIdAndTimestamps(
   if ((*category_group_enabled & TraceCategory::ENABLED_FOR_RECORDING) &&
       !disabled_by_filters) {
     OptionalAutoLock lock(&lock_);
+    // Threads without a ThreadLocalEventBuffer add their events to a cached
+    // chunk, and only take |lock_| when that chunk needs to be replaced.
+    ThreadChunkCache::ScopedWrite thread_chunk_cache_write(
+        thread_local_event_buffer ? nullptr : GetOrCreateThreadChunkCache());
 
     TraceEvent* trace_event = nullptr;
     if (thread_local_event_buffer) {
       trace_event = thread_local_event_buffer->AddTraceEvent(&handle);
     } else {
-      lock.EnsureAcquired();
-      trace_event = AddEventToThreadSharedChunkWhileLocked(&handle, true);
+      if (thread_chunk_cache_write.cache()) {
+        trace_event = thread_chunk_cache_write.cache()->AddTraceEvent(&handle);
+      }
+      if (!trace_event) {
+        thread_chunk_cache_write.Reset();
+        lock.EnsureAcquired();
+        trace_event = GetThreadChunkCache()->AddTraceEventWhileLocked(&handle);
+      }
     }
 
     // NO_THREAD_SAFETY_ANALYSIS: Conditional locking above.
@@ -2077,8 +2310,17 @@ void TraceLog::UpdateTraceEventDurationExplicit(
   std::string console_message;
   if (category_group_enabled_local & TraceCategory::ENABLED_FOR_RECORDING) {
     OptionalAutoLock lock(&lock_);
+    ThreadChunkCache::ScopedWrite thread_chunk_cache_write(
+        GetThreadChunkCache());
 
-    TraceEvent* trace_event = GetEventByHandleInternal(handle, &lock);
+    TraceEvent* trace_event = nullptr;
+    if (thread_chunk_cache_write.cache()) {
+      trace_event = thread_chunk_cache_write.cache()->GetEventByHandle(handle);
+    }
+    if (!trace_event) {
+      thread_chunk_cache_write.Reset();
+      trace_event = GetEventByHandleInternal(handle, &lock);
+    }
     if (trace_event) {
       DCHECK(trace_event->phase() == TRACE_EVENT_PHASE_COMPLETE);
 
@@ -2219,6 +2461,14 @@ TraceEvent* TraceLog::GetEventByHandleInternal(TraceEventHandle handle,
   if (lock)
     lock->EnsureAcquired();
 
+  // With |lock_| held, the cached chunk of the current thread can't be
+  // released concurrently.
+  if (GetThreadChunkCache()) {
+    TraceEvent* trace_event = GetThreadChunkCache()->GetEventByHandle(handle);
+    if (trace_event)
+      return trace_event;
+  }
+
   if (thread_shared_chunk_ &&
       handle.chunk_index == thread_shared_chunk_index_) {
     return handle.chunk_seq == thread_shared_chunk_->seq()
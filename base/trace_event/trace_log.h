@@ -18,8 +18,10 @@
 #include "base/gtest_prod_util.h"
 #include "base/memory/scoped_refptr.h"
 #include "base/no_destructor.h"
+#include "base/synchronization/condition_variable.h"
 #include "base/task/single_thread_task_runner.h"
 #include "base/threading/platform_thread.h"
+#include "base/threading/thread_local_storage.h"
 #include "base/time/time_override.h"
 #include "base/trace_event/category_registry.h"
 #include "base/trace_event/memory_dump_provider.h"
@@ -498,6 +500,7 @@ class BASE_EXPORT TraceLog :
       const TraceConfig& config);
 
   class ThreadLocalEventBuffer;
+  class ThreadChunkCache;
   class OptionalAutoLock;
   struct RegisteredAsyncObserver;
 
@@ -531,6 +534,21 @@ class BASE_EXPORT TraceLog :
   TraceEvent* GetEventByHandleInternal(TraceEventHandle handle,
                                        OptionalAutoLock* lock);
 
+  // Returns the chunk cache of the current thread, creating it on first use.
+  ThreadChunkCache* GetOrCreateThreadChunkCache();
+  ThreadChunkCache* GetThreadChunkCache() const;
+  // Takes the cached chunks back from all threads and returns them to
+  // |logged_events_|. Waits for writes in flight, releasing |lock_| meanwhile.
+  void ReturnThreadChunkCachesWhileLocked();
+  // Takes the cached chunks back from all threads and discards them, without
+  // waiting.
+  void DiscardThreadChunkCachesWhileLocked();
+  // Called by a thread whose write to its cached chunk ends after the chunk
+  // was released.
+  void OnThreadChunkCacheWriteEnded();
+  // Destructor of |thread_chunk_cache_|, run when a thread exits.
+  static void OnThreadChunkCacheThreadExit(void* cache);
+
   void FlushInternal(const OutputCallback& cb,
                      bool use_worker_thread,
                      bool discard_events);
@@ -579,6 +597,8 @@ class BASE_EXPORT TraceLog :
   // This lock protects TraceLog member accesses (except for members protected
   // by thread_info_lock_) from arbitrary threads.
   mutable Lock lock_;
+  // Signaled when a write to a released thread chunk cache ends.
+  ConditionVariable thread_chunk_cache_write_ended_{&lock_};
   Lock thread_info_lock_;
   uint8_t enabled_modes_;  // See TraceLog::Mode.
   int num_traces_recorded_;
@@ -640,6 +660,12 @@ class BASE_EXPORT TraceLog :
   std::unique_ptr<TraceBufferChunk> thread_shared_chunk_;
   size_t thread_shared_chunk_index_;
 
+  // Chunk caches of threads that can't use a ThreadLocalEventBuffer, e.g.
+  // thread pool workers. Each cache is also referenced from its own thread
+  // through |thread_chunk_cache_| and is destroyed when that thread exits.
+  std::vector<std::unique_ptr<ThreadChunkCache>> thread_chunk_caches_;
+  ThreadLocalStorage::Slot thread_chunk_cache_{&OnThreadChunkCacheThreadExit};
+
   // Set when asynchronous Flush is in progress.
   OutputCallback flush_output_callback_;
   scoped_refptr<SequencedTaskRunner> flush_task_runner_;
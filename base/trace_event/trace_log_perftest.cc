@@ -0,0 +1,152 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/barrier_closure.h"
+#include "base/bind.h"
+#include "base/callback.h"
+#include "base/memory/raw_ptr.h"
+#include "base/memory/ref_counted_memory.h"
+#include "base/strings/stringprintf.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/threading/simple_thread.h"
+#include "base/time/time.h"
+#include "base/trace_event/trace_event.h"
+#include "base/trace_event/trace_log.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+// This file measures the per-event cost of TRACE_EVENT macros while tracing is
+// enabled, on threads without a message loop (e.g. thread pool workers), with
+// increasing numbers of threads adding events concurrently.
+
+namespace base {
+namespace trace_event {
+
+namespace {
+
+constexpr char kMetricPrefixTraceLog[] = "TraceLog.";
+constexpr char kMetricTimePerEvent[] = "time_per_event";
+constexpr char kMetricThroughput[] = "throughput";
+constexpr int kNumEventsPerThread = 200000;
+
+perf_test::PerfResultReporter SetUpReporter(const std::string& story_name) {
+  perf_test::PerfResultReporter reporter(kMetricPrefixTraceLog, story_name);
+  reporter.RegisterImportantMetric(kMetricTimePerEvent, "ns");
+  reporter.RegisterImportantMetric(kMetricThroughput, "events/ms");
+  return reporter;
+}
+
+enum class EventType { kInstant, kScoped };
+
+// A thread without a message loop that waits for |start_event| to be signaled,
+// then adds |kNumEventsPerThread| trace events and invokes |done_closure|.
+class TraceEventThread : public SimpleThread {
+ public:
+  TraceEventThread(WaitableEvent* start_event,
+                   EventType event_type,
+                   OnceClosure done_closure)
+      : SimpleThread("TraceEventThread"),
+        start_event_(start_event),
+        event_type_(event_type),
+        done_closure_(std::move(done_closure)) {}
+
+  // SimpleThread:
+  void Run() override {
+    start_event_->Wait();
+    if (event_type_ == EventType::kInstant) {
+      for (int i = 0; i < kNumEventsPerThread; ++i) {
+        TRACE_EVENT_INSTANT1("perftest", "instant", TRACE_EVENT_SCOPE_THREAD,
+                             "i", i);
+      }
+    } else {
+      for (int i = 0; i < kNumEventsPerThread; ++i) {
+        TRACE_EVENT1("perftest", "scoped", "i", i);
+      }
+    }
+    std::move(done_closure_).Run();
+  }
+
+ private:
+  const raw_ptr<WaitableEvent> start_event_;
+  const EventType event_type_;
+  OnceClosure done_closure_;
+};
+
+void RunTraceEventPerfTest(const std::string& story_prefix,
+                           EventType event_type,
+                           int num_threads) {
+  TraceLog* trace_log = TraceLog::GetInstance();
+  // Record continuously so that the buffer never fills up and stops recording
+  // in the middle of the measurement.
+  trace_log->SetEnabled(TraceConfig("perftest", RECORD_CONTINUOUSLY),
+                        TraceLog::RECORDING_MODE);
+
+  WaitableEvent start_event;
+  WaitableEvent end_event;
+  RepeatingClosure done_closure = BarrierClosure(
+      num_threads, BindOnce(&WaitableEvent::Signal, Unretained(&end_event)));
+
+  std::vector<std::unique_ptr<TraceEventThread>> threads;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.push_back(std::make_unique<TraceEventThread>(
+        &start_event, event_type, done_closure));
+    threads.back()->Start();
+  }
+
+  TimeTicks start_time = TimeTicks::Now();
+  start_event.Signal();
+  end_event.Wait();
+  TimeDelta elapsed = TimeTicks::Now() - start_time;
+
+  for (auto& thread : threads)
+    thread->Join();
+
+  // The events themselves are not of interest, drop them.
+  trace_log->CancelTracing(BindRepeating(
+      [](const scoped_refptr<RefCountedString>&, bool has_more_events) {}));
+
+  // Each thread adds its events concurrently, so the wall time per event on
+  // one thread shows how much the threads slow each other down.
+  auto reporter = SetUpReporter(
+      StringPrintf("%s_%d_threads", story_prefix.c_str(), num_threads));
+  reporter.AddResult(
+      kMetricTimePerEvent,
+      static_cast<double>(elapsed.InNanoseconds()) / kNumEventsPerThread);
+  reporter.AddResult(
+      kMetricThroughput,
+      num_threads * kNumEventsPerThread / elapsed.InMillisecondsF());
+}
+
+}  // namespace
+
+TEST(TraceLogPerfTest, InstantEvent_1Thread) {
+  RunTraceEventPerfTest("InstantEvent", EventType::kInstant, 1);
+}
+
+TEST(TraceLogPerfTest, InstantEvent_8Threads) {
+  RunTraceEventPerfTest("InstantEvent", EventType::kInstant, 8);
+}
+
+TEST(TraceLogPerfTest, InstantEvent_32Threads) {
+  RunTraceEventPerfTest("InstantEvent", EventType::kInstant, 32);
+}
+
+TEST(TraceLogPerfTest, ScopedEvent_1Thread) {
+  RunTraceEventPerfTest("ScopedEvent", EventType::kScoped, 1);
+}
+
+TEST(TraceLogPerfTest, ScopedEvent_8Threads) {
+  RunTraceEventPerfTest("ScopedEvent", EventType::kScoped, 8);
+}
+
+TEST(TraceLogPerfTest, ScopedEvent_32Threads) {
+  RunTraceEventPerfTest("ScopedEvent", EventType::kScoped, 32);
+}
+
+}  // namespace trace_event
+}  // namespace base
@@ -10,15 +10,21 @@
 
 #include <algorithm>
 #include <cmath>
+#include <limits>
 #include <map>
 #include <utility>
 #include <vector>
 
+#include "base/bits.h"
 #include "base/check_op.h"
-#include "base/memory/raw_ptr.h"
 #include "base/numerics/clamped_math.h"
+#include "build/build_config.h"
 #include "ui/gfx/geometry/rect.h"
 
+#if defined(ARCH_CPU_X86_FAMILY) && !defined(OS_NACL)
+#include <emmintrin.h>
+#endif
+
 namespace cc {
 
 // The following description and most of the implementation is borrowed from
@@ -27,9 +33,15 @@ namespace cc {
 // An R-Tree implementation. In short, it is a balanced n-ary tree containing a
 // hierarchy of bounding rectangles.
 //
-// It only supports bulk-loading, i.e. creation from a batch of bounding
+// It is created by bulk-loading, i.e. creation from a batch of bounding
 // rectangles. This performs a bottom-up bulk load using the STR
-// (sort-tile-recursive) algorithm.
+// (sort-tile-recursive) algorithm. After that, items can be appended and their
+// bounds updated, which only changes the nodes on their path from the root,
+// instead of rebuilding the tree.
+//
+// The bounds of the children of a node are stored as separate arrays of their
+// edges, so that a query is compared with 4 of them at once with SIMD
+// instructions.
 //
 // Things to do: Experiment with other bulk-load algorithms (in particular the
 // Hilbert pack variant, which groups rects by position on the Hilbert curve, is
@@ -81,6 +93,18 @@ class RTree {
   // container.
   void SearchRefs(const gfx::Rect& query, std::vector<const T*>* results) const;
 
+  // Adds an item with |bounds| and |payload| after all the others, so that
+  // searches return it last. Like Build(), skips items with empty bounds.
+  // Invalidates the pointers returned by SearchRefs().
+  void Insert(const gfx::Rect& bounds, T payload);
+
+  // Changes the bounds of the item with |payload| and |old_bounds| to
+  // |new_bounds|, and returns true, or returns false if there is no such item.
+  // Searches don't return an item whose bounds are empty.
+  bool Update(const T& payload,
+              const gfx::Rect& old_bounds,
+              const gfx::Rect& new_bounds);
+
   // Returns the total bounds of all items in this rtree.
   // if !has_valid_bounds() this function will CHECK.
   gfx::Rect GetBoundsOrDie() const;
@@ -97,16 +121,17 @@ class RTree {
   enum { kMinChildren = 6 };
   enum { kMaxChildren = 11 };
 
-  template <typename U>
-  struct Node;
+  // The children of a node, padded to a multiple of the number of bounds
+  // compared at once.
+  enum { kPaddedChildren = (kMaxChildren + 3) / 4 * 4 };
 
   template <typename U>
   struct Branch {
     // When the node level is 0, then the node is a leaf and the branch has a
     // valid index pointing to an element in the vector that was used to build
     // this rtree. When the level is not 0, it's an internal node and it has a
-    // valid subtree pointer.
-    raw_ptr<Node<U>> subtree;
+    // valid subtree index into |nodes_|.
+    uint32_t subtree = 0u;
     U payload;
 
     gfx::Rect bounds;
@@ -120,39 +145,100 @@ class RTree {
   struct Node {
     uint16_t num_children = 0u;
     uint16_t level = 0u;
-    Branch<U> children[kMaxChildren];
 
-    explicit Node(uint16_t level) : level(level) {}
+    // The edges of the bounds of the children. Empty bounds, and the padding,
+    // have a left edge to the right of their right edge, and a top edge below
+    // their bottom edge, so that they intersect nothing.
+    int32_t left[kPaddedChildren];
+    int32_t top[kPaddedChildren];
+    int32_t right[kPaddedChildren];
+    int32_t bottom[kPaddedChildren];
+
+    uint32_t subtrees[kMaxChildren] = {};
+    U payloads[kMaxChildren];
+
+    explicit Node(uint16_t level) : level(level) {
+      for (size_t i = 0; i < kPaddedChildren; ++i)
+        SetBounds(i, gfx::Rect());
+    }
+
+    void AddChild(Branch<U> branch) {
+      DCHECK_LT(num_children, static_cast<uint16_t>(kMaxChildren));
+      subtrees[num_children] = branch.subtree;
+      payloads[num_children] = std::move(branch.payload);
+      SetBounds(num_children, branch.bounds);
+      ++num_children;
+    }
+
+    gfx::Rect GetBounds(size_t i) const {
+      if (left[i] >= right[i])
+        return gfx::Rect();
+      return gfx::Rect(left[i], top[i], right[i] - left[i],
+                       bottom[i] - top[i]);
+    }
+
+    void SetBounds(size_t i, const gfx::Rect& bounds) {
+      if (bounds.IsEmpty()) {
+        left[i] = top[i] = std::numeric_limits<int32_t>::max();
+        right[i] = bottom[i] = std::numeric_limits<int32_t>::min();
+      } else {
+        left[i] = bounds.x();
+        top[i] = bounds.y();
+        right[i] = bounds.right();
+        bottom[i] = bounds.bottom();
+      }
+    }
+
+    // Returns a mask with the bits of the children whose bounds intersect
+    // |query|, which must not be empty.
+    uint32_t GetIntersectingChildren(const gfx::Rect& query) const;
   };
 
-  void SearchRecursive(Node<T>* root,
+  void SearchRecursive(uint32_t node_index,
                        const gfx::Rect& query,
                        std::vector<T>* results,
                        std::vector<gfx::Rect>* rects = nullptr) const;
-  void SearchRefsRecursive(Node<T>* root,
+  void SearchRefsRecursive(uint32_t node_index,
                            const gfx::Rect& query,
                            std::vector<const T*>* results) const;
 
   // The following two functions are slow fallback versions of SearchRecursive
   // and SearchRefsRecursive for when !has_valid_bounds().
-  void SearchRecursiveFallback(Node<T>* root,
+  void SearchRecursiveFallback(uint32_t node_index,
                                const gfx::Rect& query,
                                std::vector<T>* results,
                                std::vector<gfx::Rect>* rects = nullptr) const;
-  void SearchRefsRecursiveFallback(Node<T>* root,
+  void SearchRefsRecursiveFallback(uint32_t node_index,
                                    const gfx::Rect& query,
                                    std::vector<const T*>* results) const;
 
   // Consumes the input array.
   Branch<T> BuildRecursive(std::vector<Branch<T>>* branches, int level);
-  Node<T>* AllocateNodeAtLevel(int level);
+  uint32_t AllocateNodeAtLevel(int level);
+
+  // Appends the node and child index of the item with |payload| and
+  // |old_bounds| in the subtree of |node_index|, and of each of its ancestors
+  // in the subtree, to |path|. Returns false if there is no such item.
+  bool FindRecursive(uint32_t node_index,
+                     const T& payload,
+                     const gfx::Rect& old_bounds,
+                     std::vector<std::pair<uint32_t, uint16_t>>* path) const;
+
+  // Returns the union of the bounds of the children of |node|.
+  gfx::Rect GetNodeBounds(const Node<T>& node);
 
-  void GetAllBoundsRecursive(Node<T>* root,
+  // Returns the union of |a| and |b|. If the union overflows, the rtree no
+  // longer has valid bounds.
+  gfx::Rect UnionBounds(const gfx::Rect& a, const gfx::Rect& b);
+
+  void GetAllBoundsRecursive(uint32_t node_index,
                              std::map<T, gfx::Rect>* results) const;
 
   // This is the count of data elements (rather than total nodes in the tree)
   size_t num_data_elements_ = 0u;
   Branch<T> root_;
+  // The nodes refer to each other by index, so that the vector can grow when
+  // items are inserted.
   std::vector<Node<T>> nodes_;
 
   // If false, the rtree encountered overflow does not have reliable bounds.
@@ -193,11 +279,10 @@ void RTree<T>::Build(const Container& items,
   num_data_elements_ = branches.size();
   if (num_data_elements_ == 1u) {
     nodes_.reserve(1);
-    Node<T>* node = AllocateNodeAtLevel(0);
+    uint32_t node = AllocateNodeAtLevel(0);
     root_.subtree = node;
     root_.bounds = branches[0].bounds;
-    node->num_children = 1;
-    node->children[0] = std::move(branches[0]);
+    nodes_[node].AddChild(std::move(branches[0]));
   } else if (num_data_elements_ > 1u) {
     // Determine a reasonable upper bound on the number of nodes to prevent
     // reallocations. This is basically (n**d - 1) / (n - 1), which is the
@@ -213,7 +298,10 @@ void RTree<T>::Build(const Container& items,
                             (branch_count - 1)) +
         kMinChildren;
     nodes_.reserve(node_count);
+    const size_t capacity = nodes_.capacity();
     root_ = BuildRecursive(&branches, 0);
+    // The upper bound should've been large enough.
+    DCHECK_EQ(capacity, nodes_.capacity());
   }
   // We should've wasted at most kMinChildren nodes.
   DCHECK_LE(nodes_.capacity() - nodes_.size(),
@@ -221,12 +309,9 @@ void RTree<T>::Build(const Container& items,
 }
 
 template <typename T>
-auto RTree<T>::AllocateNodeAtLevel(int level) -> Node<T>* {
-  // We don't allow reallocations, since that would invalidate references to
-  // existing nodes, so verify that capacity > size.
-  DCHECK_GT(nodes_.capacity(), nodes_.size());
+uint32_t RTree<T>::AllocateNodeAtLevel(int level) {
   nodes_.emplace_back(level);
-  return &nodes_.back();
+  return static_cast<uint32_t>(nodes_.size() - 1);
 }
 
 template <typename T>
@@ -269,13 +354,13 @@ auto RTree<T>::BuildRecursive(std::vector<Branch<T>>* branches, int level)
         remainder -= kMaxChildren - kMinChildren;
       }
     }
-    Node<T>* node = AllocateNodeAtLevel(level);
-    node->num_children = 1;
-    node->children[0] = (*branches)[current_branch];
+    uint32_t node_index = AllocateNodeAtLevel(level);
+    Node<T>& node = nodes_[node_index];
 
     Branch<T> branch;
     branch.bounds = (*branches)[current_branch].bounds;
-    branch.subtree = node;
+    branch.subtree = node_index;
+    node.AddChild(std::move((*branches)[current_branch]));
     ++current_branch;
     int x = branch.bounds.x();
     int y = branch.bounds.y();
@@ -292,8 +377,7 @@ auto RTree<T>::BuildRecursive(std::vector<Branch<T>>* branches, int level)
       right = std::max(right, bounds.right());
       bottom = std::max(bottom, bounds.bottom());
 
-      node->children[k] = (*branches)[current_branch];
-      ++node->num_children;
+      node.AddChild(std::move((*branches)[current_branch]));
       ++current_branch;
     }
     branch.bounds.SetRect(x, y, base::ClampSub(right, x),
@@ -312,17 +396,199 @@ auto RTree<T>::BuildRecursive(std::vector<Branch<T>>* branches, int level)
   return BuildRecursive(branches, level + 1);
 }
 
+template <typename T>
+void RTree<T>::Insert(const gfx::Rect& bounds, T payload) {
+  if (bounds.IsEmpty())
+    return;
+
+  Branch<T> branch(std::move(payload), bounds);
+  if (num_data_elements_++ == 0u) {
+    nodes_.clear();
+    root_.subtree = AllocateNodeAtLevel(0);
+    root_.bounds = bounds;
+    nodes_[root_.subtree].AddChild(std::move(branch));
+    return;
+  }
+
+  // Build() adds the items to the nodes of each level in order, so add the
+  // item to the last node of a level too, which keeps the items in order for
+  // searches. |path| is the last node of each level, from the root.
+  std::vector<uint32_t> path = {root_.subtree};
+  while (nodes_[path.back()].level > 0) {
+    const Node<T>& node = nodes_[path.back()];
+    path.push_back(node.subtrees[node.num_children - 1]);
+  }
+
+  // Find the lowest node of the path with room for another child, or add a
+  // level above the root if they are all full.
+  size_t depth = path.size();
+  while (depth > 0 && nodes_[path[depth - 1]].num_children == kMaxChildren)
+    --depth;
+  if (depth == 0) {
+    uint32_t new_root = AllocateNodeAtLevel(nodes_[root_.subtree].level + 1);
+    nodes_[new_root].AddChild(std::move(root_));
+    root_.subtree = new_root;
+    path.insert(path.begin(), new_root);
+    depth = 1;
+  }
+
+  // Add a new node at each level below that node, down to a leaf with the
+  // item.
+  const uint32_t parent = path[depth - 1];
+  for (uint16_t level = 0; level < nodes_[parent].level; ++level) {
+    uint32_t node = AllocateNodeAtLevel(level);
+    nodes_[node].AddChild(std::move(branch));
+    branch = Branch<T>();
+    branch.subtree = node;
+    branch.bounds = bounds;
+  }
+  nodes_[parent].AddChild(std::move(branch));
+
+  // Extend the bounds of the branches to the nodes of the path above it.
+  for (size_t i = 0; i + 1 < depth; ++i) {
+    Node<T>& node = nodes_[path[i]];
+    const size_t last_child = node.num_children - 1;
+    node.SetBounds(last_child, UnionBounds(node.GetBounds(last_child), bounds));
+  }
+  root_.bounds = UnionBounds(root_.bounds, bounds);
+}
+
+template <typename T>
+bool RTree<T>::Update(const T& payload,
+                      const gfx::Rect& old_bounds,
+                      const gfx::Rect& new_bounds) {
+  std::vector<std::pair<uint32_t, uint16_t>> path;
+  if (num_data_elements_ == 0 ||
+      !FindRecursive(root_.subtree, payload, old_bounds, &path)) {
+    return false;
+  }
+
+  // Only the bounds of the item and of its ancestors change. |path| goes from
+  // the leaf to the root.
+  nodes_[path[0].first].SetBounds(path[0].second, new_bounds);
+  for (size_t i = 1; i < path.size(); ++i) {
+    nodes_[path[i].first].SetBounds(path[i].second,
+                                    GetNodeBounds(nodes_[path[i - 1].first]));
+  }
+  root_.bounds = GetNodeBounds(nodes_[root_.subtree]);
+  return true;
+}
+
+template <typename T>
+bool RTree<T>::FindRecursive(
+    uint32_t node_index,
+    const T& payload,
+    const gfx::Rect& old_bounds,
+    std::vector<std::pair<uint32_t, uint16_t>>* path) const {
+  const Node<T>& node = nodes_[node_index];
+  for (uint16_t i = 0; i < node.num_children; ++i) {
+    const gfx::Rect bounds = node.GetBounds(i);
+    if (node.level == 0) {
+      if ((bounds == old_bounds ||
+           (bounds.IsEmpty() && old_bounds.IsEmpty())) &&
+          node.payloads[i] == payload) {
+        path->emplace_back(node_index, i);
+        return true;
+      }
+      continue;
+    }
+    // Empty bounds aren't part of the bounds of their ancestors, and the bounds
+    // may be invalid, so the subtrees which can't have the item can only be
+    // skipped otherwise.
+    if ((old_bounds.IsEmpty() || !has_valid_bounds_ ||
+         bounds.Contains(old_bounds)) &&
+        FindRecursive(node.subtrees[i], payload, old_bounds, path)) {
+      path->emplace_back(node_index, i);
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename T>
+gfx::Rect RTree<T>::GetNodeBounds(const Node<T>& node) {
+  gfx::Rect bounds;
+  for (uint16_t i = 0; i < node.num_children; ++i)
+    bounds = UnionBounds(bounds, node.GetBounds(i));
+  return bounds;
+}
+
+template <typename T>
+gfx::Rect RTree<T>::UnionBounds(const gfx::Rect& a, const gfx::Rect& b) {
+  if (a.IsEmpty())
+    return b;
+  if (b.IsEmpty())
+    return a;
+
+  int x = std::min(a.x(), b.x());
+  int y = std::min(a.y(), b.y());
+  int right = std::max(a.right(), b.right());
+  int bottom = std::max(a.bottom(), b.bottom());
+  gfx::Rect bounds(x, y, base::ClampSub(right, x), base::ClampSub(bottom, y));
+
+  // If we had to clamp right/bottom values, we've overflowed.
+  bool overflow = bounds.right() != right || bounds.bottom() != bottom;
+  has_valid_bounds_ &= !overflow;
+  return bounds;
+}
+
+template <typename T>
+template <typename U>
+uint32_t RTree<T>::Node<U>::GetIntersectingChildren(
+    const gfx::Rect& query) const {
+  DCHECK(!query.IsEmpty());
+  uint32_t mask = 0u;
+#if defined(ARCH_CPU_X86_FAMILY) && !defined(OS_NACL)
+  // The bounds of 4 children intersect |query| if their left and top edges
+  // are before its right and bottom edges, and their right and bottom edges
+  // after its left and top edges.
+  const __m128i query_left = _mm_set1_epi32(query.x());
+  const __m128i query_top = _mm_set1_epi32(query.y());
+  const __m128i query_right = _mm_set1_epi32(query.right());
+  const __m128i query_bottom = _mm_set1_epi32(query.bottom());
+  for (size_t i = 0; i < kPaddedChildren; i += 4) {
+    const __m128i intersects = _mm_and_si128(
+        _mm_and_si128(
+            _mm_cmplt_epi32(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(left + i)),
+                query_right),
+            _mm_cmpgt_epi32(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(right + i)),
+                query_left)),
+        _mm_and_si128(
+            _mm_cmplt_epi32(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(top + i)),
+                query_bottom),
+            _mm_cmpgt_epi32(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(bottom + i)),
+                query_top)));
+    mask |= static_cast<uint32_t>(
+                _mm_movemask_ps(_mm_castsi128_ps(intersects)))
+            << i;
+  }
+#else
+  for (size_t i = 0; i < kPaddedChildren; ++i) {
+    mask |= static_cast<uint32_t>(left[i] < query.right() &&
+                                  right[i] > query.x() &&
+                                  top[i] < query.bottom() &&
+                                  bottom[i] > query.y())
+            << i;
+  }
+#endif
+  return mask;
+}
+
 template <typename T>
 void RTree<T>::Search(const gfx::Rect& query,
                       std::vector<T>* results,
                       std::vector<gfx::Rect>* rects) const {
   results->clear();
-  if (num_data_elements_ == 0)
+  if (num_data_elements_ == 0 || query.IsEmpty())
     return;
   if (!has_valid_bounds_) {
-    SearchRecursiveFallback(root_.subtree.get(), query, results, rects);
+    SearchRecursiveFallback(root_.subtree, query, results, rects);
   } else if (query.Intersects(root_.bounds)) {
-    SearchRecursive(root_.subtree.get(), query, results, rects);
+    SearchRecursive(root_.subtree, query, results, rects);
   }
 }
 
@@ -330,80 +596,77 @@ template <typename T>
 void RTree<T>::SearchRefs(const gfx::Rect& query,
                           std::vector<const T*>* results) const {
   results->clear();
-  if (num_data_elements_ == 0)
+  if (num_data_elements_ == 0 || query.IsEmpty())
     return;
   if (!has_valid_bounds_) {
-    SearchRefsRecursiveFallback(root_.subtree.get(), query, results);
+    SearchRefsRecursiveFallback(root_.subtree, query, results);
   } else if (query.Intersects(root_.bounds)) {
-    SearchRefsRecursive(root_.subtree.get(), query, results);
+    SearchRefsRecursive(root_.subtree, query, results);
   }
 }
 
 template <typename T>
-void RTree<T>::SearchRecursive(Node<T>* node,
+void RTree<T>::SearchRecursive(uint32_t node_index,
                                const gfx::Rect& query,
                                std::vector<T>* results,
                                std::vector<gfx::Rect>* rects) const {
-  for (uint16_t i = 0; i < node->num_children; ++i) {
-    if (query.Intersects(node->children[i].bounds)) {
-      if (node->level == 0) {
-        results->push_back(node->children[i].payload);
-        if (rects)
-          rects->push_back(node->children[i].bounds);
-      } else {
-        SearchRecursive(node->children[i].subtree.get(), query, results, rects);
-      }
+  const Node<T>& node = nodes_[node_index];
+  for (uint32_t mask = node.GetIntersectingChildren(query); mask;
+       mask &= mask - 1) {
+    const size_t i = base::bits::CountTrailingZeroBits(mask);
+    if (node.level == 0) {
+      results->push_back(node.payloads[i]);
+      if (rects)
+        rects->push_back(node.GetBounds(i));
+    } else {
+      SearchRecursive(node.subtrees[i], query, results, rects);
     }
   }
 }
 
 template <typename T>
-void RTree<T>::SearchRefsRecursive(Node<T>* node,
+void RTree<T>::SearchRefsRecursive(uint32_t node_index,
                                    const gfx::Rect& query,
                                    std::vector<const T*>* results) const {
-  for (uint16_t i = 0; i < node->num_children; ++i) {
-    if (query.Intersects(node->children[i].bounds)) {
-      if (node->level == 0)
-        results->push_back(&node->children[i].payload);
-      else
-        SearchRefsRecursive(node->children[i].subtree.get(), query, results);
-    }
+  const Node<T>& node = nodes_[node_index];
+  for (uint32_t mask = node.GetIntersectingChildren(query); mask;
+       mask &= mask - 1) {
+    const size_t i = base::bits::CountTrailingZeroBits(mask);
+    if (node.level == 0)
+      results->push_back(&node.payloads[i]);
+    else
+      SearchRefsRecursive(node.subtrees[i], query, results);
   }
 }
 
 // When !has_valid_bounds(), any non-leaf bounds may have overflowed and be
 // invalid. Iterate over the entire tree, checking bounds at each leaf.
 template <typename T>
-void RTree<T>::SearchRecursiveFallback(Node<T>* node,
+void RTree<T>::SearchRecursiveFallback(uint32_t node_index,
                                        const gfx::Rect& query,
                                        std::vector<T>* results,
                                        std::vector<gfx::Rect>* rects) const {
-  for (uint16_t i = 0; i < node->num_children; ++i) {
-    if (node->level == 0) {
-      if (query.Intersects(node->children[i].bounds)) {
-        results->push_back(node->children[i].payload);
-        if (rects)
-          rects->push_back(node->children[i].bounds);
-      }
-    } else {
-      SearchRecursive(node->children[i].subtree.get(), query, results, rects);
-    }
+  const Node<T>& node = nodes_[node_index];
+  if (node.level == 0) {
+    SearchRecursive(node_index, query, results, rects);
+    return;
   }
+  for (uint16_t i = 0; i < node.num_children; ++i)
+    SearchRecursive(node.subtrees[i], query, results, rects);
 }
 
 template <typename T>
 void RTree<T>::SearchRefsRecursiveFallback(
-    Node<T>* node,
+    uint32_t node_index,
     const gfx::Rect& query,
     std::vector<const T*>* results) const {
-  for (uint16_t i = 0; i < node->num_children; ++i) {
-    if (node->level == 0) {
-      if (query.Intersects(node->children[i].bounds))
-        results->push_back(&node->children[i].payload);
-    } else {
-      SearchRefsRecursive(node->children[i].subtree.get(), query, results);
-    }
+  const Node<T>& node = nodes_[node_index];
+  if (node.level == 0) {
+    SearchRefsRecursive(node_index, query, results);
+    return;
   }
+  for (uint16_t i = 0; i < node.num_children; ++i)
+    SearchRefsRecursive(node.subtrees[i], query, results);
 }
 
 template <typename T>
@@ -416,18 +679,19 @@ template <typename T>
 std::map<T, gfx::Rect> RTree<T>::GetAllBoundsForTracing() const {
   std::map<T, gfx::Rect> results;
   if (num_data_elements_ > 0)
-    GetAllBoundsRecursive(root_.subtree.get(), &results);
+    GetAllBoundsRecursive(root_.subtree, &results);
   return results;
 }
 
 template <typename T>
-void RTree<T>::GetAllBoundsRecursive(Node<T>* node,
+void RTree<T>::GetAllBoundsRecursive(uint32_t node_index,
                                      std::map<T, gfx::Rect>* results) const {
-  for (uint16_t i = 0; i < node->num_children; ++i) {
-    if (node->level == 0)
-      (*results)[node->children[i].payload] = node->children[i].bounds;
+  const Node<T>& node = nodes_[node_index];
+  for (uint16_t i = 0; i < node.num_children; ++i) {
+    if (node.level == 0)
+      (*results)[node.payloads[i]] = node.GetBounds(i);
     else
-      GetAllBoundsRecursive(node->children[i].subtree.get(), results);
+      GetAllBoundsRecursive(node.subtrees[i], results);
   }
 }
 
@@ -69,6 +69,43 @@ class RTreePerfTest : public testing::Test {
     reporter.AddResult("_search", timer_.LapsPerSecond());
   }
 
+  // Inserts the rects one by one instead of building the rtree with them.
+  void RunInsertTest(const std::string& test_name, int rect_count) {
+    std::vector<gfx::Rect> rects = BuildRects(rect_count);
+    timer_.Reset();
+    do {
+      RTree<size_t> rtree;
+      for (size_t i = 0; i < rects.size(); ++i)
+        rtree.Insert(rects[i], i);
+      timer_.NextLap();
+    } while (!timer_.HasTimeLimitExpired());
+
+    perf_test::PerfResultReporter reporter = SetUpReporter(test_name);
+    reporter.AddResult("_insert", timer_.LapsPerSecond());
+  }
+
+  // Moves one rect at a time, as a small invalidation would, instead of
+  // rebuilding the rtree.
+  void RunUpdateTest(const std::string& test_name, int rect_count) {
+    std::vector<gfx::Rect> rects = BuildRects(rect_count);
+    RTree<size_t> rtree;
+    rtree.Build(rects);
+
+    size_t index = 0;
+    timer_.Reset();
+    do {
+      gfx::Rect new_bounds = rects[index];
+      new_bounds.Offset(1, 0);
+      rtree.Update(index, rects[index], new_bounds);
+      rects[index] = new_bounds;
+      index = (index + 7919) % rects.size();
+      timer_.NextLap();
+    } while (!timer_.HasTimeLimitExpired());
+
+    perf_test::PerfResultReporter reporter = SetUpReporter(test_name);
+    reporter.AddResult("_update", timer_.LapsPerSecond());
+  }
+
   std::vector<gfx::Rect> BuildRects(int count) {
     std::vector<gfx::Rect> result;
     int width = std::sqrt(count);
@@ -89,6 +126,8 @@ class RTreePerfTest : public testing::Test {
     perf_test::PerfResultReporter reporter("rtree", story_name);
     reporter.RegisterImportantMetric("_construct", "runs/s");
     reporter.RegisterImportantMetric("_search", "runs/s");
+    reporter.RegisterImportantMetric("_insert", "runs/s");
+    reporter.RegisterImportantMetric("_update", "runs/s");
     return reporter;
   }
 
@@ -109,5 +148,19 @@ TEST_F(RTreePerfTest, Search) {
   RunSearchTest("100000", 100000);
 }
 
+TEST_F(RTreePerfTest, Insert) {
+  RunInsertTest("100", 100);
+  RunInsertTest("1000", 1000);
+  RunInsertTest("10000", 10000);
+  RunInsertTest("100000", 100000);
+}
+
+TEST_F(RTreePerfTest, Update) {
+  RunUpdateTest("100", 100);
+  RunUpdateTest("1000", 1000);
+  RunUpdateTest("10000", 10000);
+  RunUpdateTest("100000", 100000);
+}
+
 }  // namespace
 }  // namespace cc
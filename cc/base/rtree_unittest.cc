@@ -43,9 +43,8 @@ void SearchAndVerifyBounds(const RTree<T>& rtree,
 
 TEST(RTreeTest, ReserveNodesDoesntDcheck) {
   // Make sure that anywhere between 0 and 1000 rects, our reserve math in rtree
-  // is correct. (This test would DCHECK if broken either in
-  // RTree::AllocateNodeAtLevel, indicating that the capacity calculation was
-  // too small or in RTree::Build, indicating the capacity was too large).
+  // is correct. (This test would DCHECK if broken in RTree::Build, indicating
+  // that the capacity calculation was too small or too large).
   for (int i = 0; i < 1000; ++i) {
     std::vector<gfx::Rect> rects;
     for (int j = 0; j < i; ++j)
@@ -324,4 +323,130 @@ TEST(RTreeTest, InvalidBoundsGetAllBounds) {
   EXPECT_EQ(all_bounds, expected_all_bounds);
 }
 
+TEST(RTreeTest, SearchMatchesIntersects) {
+  // Overlapping rects of all sizes, some of them empty.
+  std::vector<gfx::Rect> rects;
+  for (int i = 0; i < 2000; ++i) {
+    rects.push_back(gfx::Rect((i * 37) % 1000, (i * 53) % 1000, (i * 7) % 90,
+                              (i * 11) % 70));
+  }
+
+  RTree<size_t> rtree;
+  rtree.Build(rects);
+
+  std::vector<size_t> results;
+  for (int i = 0; i < 100; ++i) {
+    gfx::Rect query((i * 97) % 1100 - 50, (i * 89) % 1100 - 50,
+                    (i * 13) % 200, (i * 17) % 200);
+    std::vector<size_t> expected_results;
+    for (size_t j = 0; j < rects.size(); ++j) {
+      if (query.Intersects(rects[j]))
+        expected_results.push_back(j);
+    }
+    SearchAndVerifyRefs(rtree, query, &results);
+    EXPECT_EQ(expected_results, results);
+  }
+}
+
+TEST(RTreeTest, Insert) {
+  std::vector<gfx::Rect> rects;
+  for (int y = 0; y < 50; ++y) {
+    for (int x = 0; x < 50; ++x)
+      rects.push_back(gfx::Rect(x, y, 1, 1));
+  }
+
+  // Inserting the rects one by one, and after building the tree with some of
+  // them, gives the same results as building it with all of them.
+  RTree<size_t> built_rtree;
+  built_rtree.Build(rects);
+  RTree<size_t> inserted_rtree;
+  for (size_t i = 0; i < rects.size(); ++i)
+    inserted_rtree.Insert(rects[i], i);
+  RTree<size_t> partially_built_rtree;
+  partially_built_rtree.Build(
+      rects, [](const std::vector<gfx::Rect>& items, size_t index) {
+        return index < 1000 ? items[index] : gfx::Rect();
+      },
+      [](const std::vector<gfx::Rect>& items, size_t index) { return index; });
+  for (size_t i = 1000; i < rects.size(); ++i)
+    partially_built_rtree.Insert(rects[i], i);
+
+  EXPECT_EQ(gfx::Rect(0, 0, 50, 50), inserted_rtree.GetBoundsOrDie());
+  EXPECT_EQ(gfx::Rect(0, 0, 50, 50), partially_built_rtree.GetBoundsOrDie());
+  for (const gfx::Rect& query :
+       {gfx::Rect(0, 0, 50, 50), gfx::Rect(10, 10, 5, 30),
+        gfx::Rect(45, 0, 10, 50), gfx::Rect(-5, -5, 6, 6),
+        gfx::Rect(60, 60, 5, 5)}) {
+    std::vector<size_t> expected_results;
+    SearchAndVerifyRefs(built_rtree, query, &expected_results);
+    std::vector<size_t> results;
+    SearchAndVerifyRefs(inserted_rtree, query, &results);
+    EXPECT_EQ(expected_results, results);
+    SearchAndVerifyRefs(partially_built_rtree, query, &results);
+    EXPECT_EQ(expected_results, results);
+  }
+}
+
+TEST(RTreeTest, InsertEmptyRect) {
+  RTree<size_t> rtree;
+  rtree.Insert(gfx::Rect(), 0);
+  rtree.Insert(gfx::Rect(5, 5, 5, 5), 1);
+
+  EXPECT_EQ(gfx::Rect(5, 5, 5, 5), rtree.GetBoundsOrDie());
+  std::map<size_t, gfx::Rect> expected_all_bounds = {
+      {1, gfx::Rect(5, 5, 5, 5)}};
+  EXPECT_EQ(expected_all_bounds, rtree.GetAllBoundsForTracing());
+}
+
+TEST(RTreeTest, InsertInvalidBounds) {
+  RTree<size_t> rtree;
+  rtree.Insert(gfx::Rect(-INT_MAX, -INT_MAX, INT_MAX, INT_MAX), 0);
+  EXPECT_TRUE(rtree.has_valid_bounds());
+  rtree.Insert(gfx::Rect(100, 100, 10, 10), 1);
+  EXPECT_FALSE(rtree.has_valid_bounds());
+
+  std::vector<size_t> found;
+  SearchAndVerifyRefs(rtree, gfx::Rect(0, 0, INT_MAX, INT_MAX), &found);
+  EXPECT_EQ(found, std::vector<size_t>({1}));
+}
+
+TEST(RTreeTest, Update) {
+  std::vector<gfx::Rect> rects;
+  for (int y = 0; y < 50; ++y) {
+    for (int x = 0; x < 50; ++x)
+      rects.push_back(gfx::Rect(x, y, 1, 1));
+  }
+
+  RTree<size_t> rtree;
+  rtree.Build(rects);
+
+  // Move the last item to the top left corner.
+  EXPECT_TRUE(rtree.Update(2499, rects[2499], gfx::Rect(-10, -10, 1, 1)));
+  EXPECT_EQ(gfx::Rect(-10, -10, 60, 60), rtree.GetBoundsOrDie());
+  std::vector<size_t> results;
+  std::vector<gfx::Rect> result_rects;
+  SearchAndVerifyBounds(rtree, gfx::Rect(-10, -10, 5, 5), &results,
+                        &result_rects);
+  EXPECT_EQ(std::vector<size_t>({2499}), results);
+  EXPECT_EQ(std::vector<gfx::Rect>({gfx::Rect(-10, -10, 1, 1)}), result_rects);
+  SearchAndVerifyRefs(rtree, gfx::Rect(45, 45, 10, 10), &results);
+  EXPECT_EQ(24u, results.size());
+  EXPECT_EQ(2498u, results.back());
+
+  // The item isn't at its old bounds anymore, and the payload must match.
+  EXPECT_FALSE(rtree.Update(2499, rects[2499], gfx::Rect(0, 0, 1, 1)));
+  EXPECT_FALSE(rtree.Update(2498, gfx::Rect(-10, -10, 1, 1), rects[2498]));
+
+  // Items with empty bounds aren't found, but can be updated again.
+  EXPECT_TRUE(rtree.Update(2499, gfx::Rect(-10, -10, 1, 1), gfx::Rect()));
+  EXPECT_EQ(gfx::Rect(0, 0, 50, 50), rtree.GetBoundsOrDie());
+  SearchAndVerifyRefs(rtree, gfx::Rect(-10, -10, 100, 100), &results);
+  EXPECT_EQ(2499u, results.size());
+  EXPECT_TRUE(rtree.Update(2499, gfx::Rect(), rects[2499]));
+  SearchAndVerifyRefs(rtree, gfx::Rect(-10, -10, 100, 100), &results);
+  ASSERT_EQ(2500u, results.size());
+  for (size_t i = 0; i < 2500; ++i)
+    ASSERT_EQ(results[i], i);
+}
+
 }  // namespace cc
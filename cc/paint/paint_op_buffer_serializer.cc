@@ -4,12 +4,20 @@
 
 #include "cc/paint/paint_op_buffer_serializer.h"
 
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
 #include <limits>
 #include <memory>
 #include <utility>
 #include <vector>
 
 #include "base/bind.h"
+#include "base/bits.h"
+#include "base/task/post_job.h"
+#include "base/task/task_traits.h"
+#include "base/task/thread_pool/thread_pool_instance.h"
 #include "base/trace_event/trace_event.h"
 #include "cc/paint/clear_for_opaque_raster.h"
 #include "cc/paint/scoped_raster_flags.h"
@@ -19,6 +27,11 @@
 namespace cc {
 namespace {
 
+// The most ops serialized together by a worker of ParallelBufferSerializer.
+constexpr size_t kMaxDeferredOpsPerChunk = 256;
+
+// The memory a chunk of deferred ops is first serialized into.
+constexpr size_t kInitialChunkBytes = 16 * 1024;
 
 PlaybackParams MakeParams(const SkCanvas* canvas) {
   // We don't use an ImageProvider here since the ops are played onto a no-draw
@@ -42,6 +55,71 @@ std::unique_ptr<SkCanvas> MakeAnalysisCanvas(
              : std::make_unique<SkNoDrawCanvas>(kMaxExtent, kMaxExtent);
 }
 
+// Returns true if |op| can be serialized on any thread, which is the case when
+// it doesn't use the image provider, the transfer cache, the paint cache or the
+// strike server of the SerializeOptions, and its flags are its own.
+bool CanSerializeOnAnyThread(const PaintOp* op,
+                             const PaintFlags* flags_to_serialize) {
+  if (op->IsPaintOpWithFlags()) {
+    const PaintFlags& flags = static_cast<const PaintOpWithFlags*>(op)->flags;
+    // Alpha folding and image decodes serialize temporary flags.
+    if (flags_to_serialize != &flags)
+      return false;
+    if (flags.HasShader() || flags.getImageFilter())
+      return false;
+  }
+
+  switch (op->GetType()) {
+    case PaintOpType::ClipPath:
+    case PaintOpType::DrawImage:
+    case PaintOpType::DrawImageRect:
+    case PaintOpType::DrawPath:
+    case PaintOpType::DrawRecord:
+    case PaintOpType::DrawSkottie:
+    case PaintOpType::DrawTextBlob:
+      return false;
+    default:
+      return true;
+  }
+}
+
+// Calls |callback| with each index below |count|, on the thread pool if there
+// is one, and returns once all the calls have returned.
+void RunInParallel(size_t count,
+                   const base::RepeatingCallback<void(size_t)>& callback) {
+  if (count < 2 || !base::ThreadPoolInstance::Get()) {
+    for (size_t i = 0; i < count; ++i)
+      callback.Run(i);
+    return;
+  }
+
+  // The job is joined, so it can't outlive the state on the stack.
+  std::atomic<size_t> next_index(0u);
+  base::PostJob(
+      FROM_HERE, {base::TaskPriority::USER_VISIBLE},
+      base::BindRepeating(
+          [](std::atomic<size_t>* next_index, size_t count,
+             const base::RepeatingCallback<void(size_t)>* callback,
+             base::JobDelegate* delegate) {
+            while (!delegate->ShouldYield()) {
+              size_t index =
+                  next_index->fetch_add(1u, std::memory_order_relaxed);
+              if (index >= count)
+                return;
+              callback->Run(index);
+            }
+          },
+          base::Unretained(&next_index), count, base::Unretained(&callback)),
+      base::BindRepeating(
+          [](std::atomic<size_t>* next_index, size_t count,
+             size_t worker_count) {
+            return count - std::min(count, next_index->load(
+                                               std::memory_order_relaxed));
+          },
+          base::Unretained(&next_index), count))
+      .Join();
+}
+
 }  // namespace
 
 PaintOpBufferSerializer::PaintOpBufferSerializer(
@@ -427,4 +505,157 @@ size_t SimpleBufferSerializer::SerializeToMemory(
   return bytes;
 }
 
+ParallelBufferSerializer::Chunk::Chunk() = default;
+
+ParallelBufferSerializer::Chunk::Chunk(Chunk&&) = default;
+
+ParallelBufferSerializer::Chunk& ParallelBufferSerializer::Chunk::operator=(
+    Chunk&&) = default;
+
+ParallelBufferSerializer::Chunk::~Chunk() = default;
+
+ParallelBufferSerializer::ParallelBufferSerializer(
+    void* memory,
+    size_t size,
+    const PaintOp::SerializeOptions& options)
+    : memory_(memory), total_(size), options_(options) {}
+
+ParallelBufferSerializer::~ParallelBufferSerializer() = default;
+
+void ParallelBufferSerializer::Serialize(
+    const PaintOpBuffer* buffer,
+    const std::vector<size_t>* offsets,
+    const PaintOpBufferSerializer::Preamble& preamble) {
+  TRACE_EVENT0("cc", "ParallelBufferSerializer::Serialize");
+  DCHECK(chunks_.empty());
+
+  buffer_ = buffer;
+  PaintOpBufferSerializer serializer(
+      base::BindRepeating(&ParallelBufferSerializer::SerializeOrDefer,
+                          base::Unretained(this)),
+      options_);
+  serializer.Serialize(buffer, offsets, preamble);
+  buffer_ = nullptr;
+  if (!serializer.valid()) {
+    valid_ = false;
+    return;
+  }
+
+  RunInParallel(
+      chunks_.size(),
+      base::BindRepeating(&ParallelBufferSerializer::SerializeDeferredOps,
+                          base::Unretained(this)));
+
+  size_t offset = 0u;
+  for (Chunk& chunk : chunks_) {
+    if (!chunk.valid || chunk.size > total_ - offset) {
+      valid_ = false;
+      return;
+    }
+    chunk.offset = offset;
+    offset += chunk.size;
+  }
+
+  // Move the ops serialized on the calling thread to their offsets. The
+  // deferred ops only move them forward, so the last ones are moved first.
+  char* memory = static_cast<char*>(memory_.get());
+  for (auto chunk = chunks_.rbegin(); chunk != chunks_.rend(); ++chunk) {
+    if (chunk->deferred_ops.empty() &&
+        chunk->offset != chunk->serialized_offset) {
+      DCHECK_GT(chunk->offset, chunk->serialized_offset);
+      memmove(memory + chunk->offset, memory + chunk->serialized_offset,
+              chunk->size);
+    }
+  }
+
+  RunInParallel(chunks_.size(),
+                base::BindRepeating(&ParallelBufferSerializer::CopyChunk,
+                                    base::Unretained(this)));
+  written_ = offset;
+}
+
+size_t ParallelBufferSerializer::SerializeOrDefer(
+    const PaintOp* op,
+    const PaintOp::SerializeOptions& options,
+    const PaintFlags* flags_to_serialize,
+    const SkM44& current_ctm,
+    const SkM44& original_ctm) {
+  const char* buffer_begin =
+      reinterpret_cast<const char*>(buffer_->GetFirstOp());
+  const char* op_address = reinterpret_cast<const char*>(op);
+  if (op_address >= buffer_begin &&
+      op_address < buffer_begin + buffer_->next_op_offset() &&
+      CanSerializeOnAnyThread(op, flags_to_serialize)) {
+    if (chunks_.empty() || chunks_.back().deferred_ops.empty() ||
+        chunks_.back().deferred_ops.size() == kMaxDeferredOpsPerChunk) {
+      chunks_.emplace_back();
+    }
+    chunks_.back().deferred_ops.push_back(
+        {op, flags_to_serialize, current_ctm, original_ctm});
+    // The size of the op isn't known until it's serialized, any valid size
+    // lets PaintOpBufferSerializer continue.
+    return PaintOpBuffer::PaintOpAlign;
+  }
+
+  if (serialized_size_ == total_)
+    return 0u;
+
+  size_t bytes = op->Serialize(
+      static_cast<char*>(memory_.get()) + serialized_size_,
+      total_ - serialized_size_, options, flags_to_serialize, current_ctm,
+      original_ctm);
+  if (!bytes)
+    return 0u;
+
+  if (chunks_.empty() || !chunks_.back().deferred_ops.empty()) {
+    chunks_.emplace_back();
+    chunks_.back().serialized_offset = serialized_size_;
+  }
+  chunks_.back().size += bytes;
+  serialized_size_ += bytes;
+  return bytes;
+}
+
+void ParallelBufferSerializer::SerializeDeferredOps(size_t chunk_index) {
+  Chunk& chunk = chunks_[chunk_index];
+  if (chunk.deferred_ops.empty())
+    return;
+
+  size_t capacity = std::min(kInitialChunkBytes, total_);
+  chunk.data.resize(
+      base::bits::AlignUp(capacity, sizeof(uint64_t)) / sizeof(uint64_t));
+  for (const DeferredOp& deferred_op : chunk.deferred_ops) {
+    while (true) {
+      char* data = reinterpret_cast<char*>(chunk.data.data());
+      size_t bytes = deferred_op.op->Serialize(
+          data + chunk.size, capacity - chunk.size, options_,
+          deferred_op.flags_to_serialize, deferred_op.current_ctm,
+          deferred_op.original_ctm);
+      if (bytes) {
+        chunk.size += bytes;
+        break;
+      }
+      if (capacity == total_) {
+        chunk.valid = false;
+        return;
+      }
+
+      // Clear what the op wrote before it ran out of memory, since the
+      // padding of the ops isn't written.
+      memset(data + chunk.size, 0, capacity - chunk.size);
+      capacity = std::min(capacity * 2, total_);
+      chunk.data.resize(
+          base::bits::AlignUp(capacity, sizeof(uint64_t)) / sizeof(uint64_t));
+    }
+  }
+}
+
+void ParallelBufferSerializer::CopyChunk(size_t chunk_index) {
+  const Chunk& chunk = chunks_[chunk_index];
+  if (chunk.deferred_ops.empty())
+    return;
+  memcpy(static_cast<char*>(memory_.get()) + chunk.offset, chunk.data.data(),
+         chunk.size);
+}
+
 }  // namespace cc
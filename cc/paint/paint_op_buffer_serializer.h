@@ -5,6 +5,8 @@
 #ifndef CC_PAINT_PAINT_OP_BUFFER_SERIALIZER_H_
 #define CC_PAINT_PAINT_OP_BUFFER_SERIALIZER_H_
 
+#include <stdint.h>
+
 #include <memory>
 #include <vector>
 
@@ -142,6 +144,103 @@ class CC_PAINT_EXPORT SimpleBufferSerializer : public PaintOpBufferSerializer {
   size_t written_ = 0u;
 };
 
+// Serializes the ops in the memory available like SimpleBufferSerializer, with
+// the same output, but in two phases so that large buffers are serialized
+// mostly on the thread pool.
+//
+// The first phase walks the buffer on the calling thread, which tracks the
+// canvas state. The ops which use the image provider, the transfer cache, the
+// paint cache or the strike server are serialized there, in order, directly
+// into the memory. The others are recorded with their transforms and
+// serialized in chunks in parallel, which gives the size and offset of each
+// chunk. The second phase moves the ops serialized on the calling thread to
+// their offsets, and copies the other chunks into the memory in parallel.
+// Without a thread pool, both phases run on the calling thread.
+//
+// The ops don't write their padding, which keeps whatever the memory held in
+// SimpleBufferSerializer, but is zero in the deferred chunks and is moved
+// along with the ops serialized on the calling thread. The output is thus only
+// the same bytes as SimpleBufferSerializer's if |memory| is zero-filled;
+// otherwise only the padding differs, which deserialization ignores.
+//
+// Fails on overflow, in which case written() is 0 and the contents of the
+// memory are unspecified.
+//
+// This is only meant for tests and benchmarks (paint_op_perftest) for now, and
+// has no production caller.
+class CC_PAINT_EXPORT ParallelBufferSerializer {
+ public:
+  ParallelBufferSerializer(void* memory,
+                           size_t size,
+                           const PaintOp::SerializeOptions& options);
+  ParallelBufferSerializer(const ParallelBufferSerializer&) = delete;
+  ParallelBufferSerializer& operator=(const ParallelBufferSerializer&) = delete;
+  ~ParallelBufferSerializer();
+
+  // Serializes the buffer with a preamble, as PaintOpBufferSerializer does.
+  // Can only be called once.
+  void Serialize(const PaintOpBuffer* buffer,
+                 const std::vector<size_t>* offsets,
+                 const PaintOpBufferSerializer::Preamble& preamble);
+
+  bool valid() const { return valid_; }
+  size_t written() const { return written_; }
+
+ private:
+  // An op of |buffer_| recorded in the first phase, with the arguments of its
+  // serialization.
+  struct DeferredOp {
+    raw_ptr<const PaintOp> op;
+    raw_ptr<const PaintFlags> flags_to_serialize;
+    SkM44 current_ctm;
+    SkM44 original_ctm;
+  };
+
+  // A run of ops which are serialized together, either deferred ops, or ops
+  // serialized on the calling thread.
+  struct Chunk {
+    Chunk();
+    Chunk(Chunk&&);
+    Chunk& operator=(Chunk&&);
+    ~Chunk();
+
+    std::vector<DeferredOp> deferred_ops;
+    // The serialized deferred ops.
+    std::vector<uint64_t> data;
+    // The offset the ops serialized on the calling thread are first written
+    // at in the memory.
+    size_t serialized_offset = 0u;
+    size_t size = 0u;
+    bool valid = true;
+    // The offset of the chunk in the memory.
+    size_t offset = 0u;
+  };
+
+  size_t SerializeOrDefer(const PaintOp* op,
+                          const PaintOp::SerializeOptions& options,
+                          const PaintFlags* flags_to_serialize,
+                          const SkM44& current_ctm,
+                          const SkM44& original_ctm);
+  void SerializeDeferredOps(size_t chunk_index);
+  void CopyChunk(size_t chunk_index);
+
+  raw_ptr<void> memory_;
+  const size_t total_;
+  const PaintOp::SerializeOptions options_;
+
+  // The buffer being serialized in the first phase. Only its own ops are
+  // deferred, since the others may not outlive the first phase.
+  raw_ptr<const PaintOpBuffer> buffer_ = nullptr;
+  // The ops serialized on the calling thread are written one after the other
+  // at the start of the memory, and moved after the deferred ops before them
+  // in the second phase.
+  size_t serialized_size_ = 0u;
+  std::vector<Chunk> chunks_;
+
+  bool valid_ = true;
+  size_t written_ = 0u;
+};
+
 }  // namespace cc
 
 #endif  // CC_PAINT_PAINT_OP_BUFFER_SERIALIZER_H_
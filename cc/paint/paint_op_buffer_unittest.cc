@@ -12,6 +12,7 @@
 #include "base/memory/scoped_refptr.h"
 #include "base/strings/stringprintf.h"
 #include "base/test/bind.h"
+#include "base/test/task_environment.h"
 #include "cc/paint/decoded_draw_image.h"
 #include "cc/paint/display_item_list.h"
 #include "cc/paint/image_provider.h"
@@ -2240,6 +2241,88 @@ TEST(PaintOpSerializationTest, Preamble) {
   }
 }
 
+// Pushes runs of ops which can be serialized on any thread, interleaved with
+// ops which use the paint cache or have flags with shaders, and folded
+// SaveLayerAlpha / draw / Restore sequences.
+void PushParallelSerializationOps(PaintOpBuffer* buffer) {
+  for (size_t i = 0; i < 1000; ++i) {
+    const PaintFlags& flags = test_flags[i % test_flags.size()];
+    buffer->push<TranslateOp>(test_floats[i % test_floats.size()], 1.f);
+    buffer->push<DrawRectOp>(test_rects[i % test_rects.size()], flags);
+    if (i % 10 == 0)
+      buffer->push<DrawPathOp>(test_paths[i % test_paths.size()], flags);
+    if (i % 50 == 0) {
+      buffer->push<SaveLayerAlphaOp>(nullptr, 128);
+      buffer->push<DrawRectOp>(test_rects[0], test_flags[0]);
+      buffer->push<RestoreOp>();
+    }
+  }
+}
+
+// Expects ParallelBufferSerializer to write the same bytes as
+// SimpleBufferSerializer.
+void ExpectParallelSerializationMatches(const PaintOpBuffer& buffer,
+                                        size_t size) {
+  PaintOpBufferSerializer::Preamble preamble;
+  preamble.content_size = gfx::Size(1000, 1000);
+  preamble.playback_rect = gfx::Rect(preamble.content_size);
+  preamble.full_raster_rect = preamble.playback_rect;
+  preamble.requires_clear = true;
+
+  // The padding of the ops isn't written, so start from the same memory.
+  std::unique_ptr<char, base::AlignedFreeDeleter> expected_memory(
+      static_cast<char*>(
+          base::AlignedAlloc(size, PaintOpBuffer::PaintOpAlign)));
+  memset(expected_memory.get(), 0, size);
+  TestOptionsProvider expected_options_provider;
+  SimpleBufferSerializer expected_serializer(
+      expected_memory.get(), size,
+      expected_options_provider.serialize_options());
+  expected_serializer.Serialize(&buffer, nullptr, preamble);
+  ASSERT_TRUE(expected_serializer.valid());
+
+  std::unique_ptr<char, base::AlignedFreeDeleter> memory(static_cast<char*>(
+      base::AlignedAlloc(size, PaintOpBuffer::PaintOpAlign)));
+  memset(memory.get(), 0, size);
+  TestOptionsProvider options_provider;
+  ParallelBufferSerializer serializer(memory.get(), size,
+                                      options_provider.serialize_options());
+  serializer.Serialize(&buffer, nullptr, preamble);
+  ASSERT_TRUE(serializer.valid());
+  ASSERT_EQ(expected_serializer.written(), serializer.written());
+  EXPECT_EQ(0, memcmp(expected_memory.get(), memory.get(), size));
+}
+
+TEST(PaintOpSerializationTest, ParallelBufferSerialization) {
+  base::test::TaskEnvironment task_environment;
+  PaintOpBuffer buffer;
+  PushParallelSerializationOps(&buffer);
+  ExpectParallelSerializationMatches(buffer, 1024 * 1024);
+}
+
+TEST(PaintOpSerializationTest, ParallelBufferSerializationWithoutThreadPool) {
+  PaintOpBuffer buffer;
+  PushParallelSerializationOps(&buffer);
+  ExpectParallelSerializationMatches(buffer, 1024 * 1024);
+}
+
+TEST(PaintOpSerializationTest, ParallelBufferSerializationOverflow) {
+  base::test::TaskEnvironment task_environment;
+  PaintOpBuffer buffer;
+  PushParallelSerializationOps(&buffer);
+
+  std::unique_ptr<char, base::AlignedFreeDeleter> memory(
+      static_cast<char*>(base::AlignedAlloc(PaintOpBuffer::kInitialBufferSize,
+                                            PaintOpBuffer::PaintOpAlign)));
+  TestOptionsProvider options_provider;
+  ParallelBufferSerializer serializer(memory.get(),
+                                      PaintOpBuffer::kInitialBufferSize,
+                                      options_provider.serialize_options());
+  serializer.Serialize(&buffer, nullptr, PaintOpBufferSerializer::Preamble());
+  EXPECT_FALSE(serializer.valid());
+  EXPECT_EQ(0u, serializer.written());
+}
+
 TEST(PaintOpSerializationTest, SerializesNestedRecords) {
   auto record = sk_make_sp<PaintOpBuffer>();
   record->push<ScaleOp>(0.5f, 0.75f);
@@ -5,6 +5,7 @@
 #include <utility>
 
 #include "base/test/launcher/unit_test_launcher.h"
+#include "base/test/task_environment.h"
 #include "base/test/test_suite.h"
 #include "base/timer/lap_timer.h"
 #include "cc/paint/paint_op_buffer.h"
@@ -25,6 +26,7 @@ static const int kNumWarmupRuns = 20;
 static const int kTimeCheckInterval = 1;
 
 static const size_t kMaxSerializedBufferBytes = 100000;
+static const size_t kMaxLargeSerializedBufferBytes = 16 * 1024 * 1024;
 
 class PaintOpPerfTest : public testing::Test {
  public:
@@ -95,6 +97,52 @@ class PaintOpPerfTest : public testing::Test {
     reporter.AddResult("", timer_.LapsPerSecond());
   }
 
+  // Compares serializing |buffer| on the calling thread and in parallel.
+  void RunSerializersTest(const std::string& name,
+                          const PaintOpBuffer& buffer) {
+    std::unique_ptr<char, base::AlignedFreeDeleter> memory(
+        static_cast<char*>(base::AlignedAlloc(kMaxLargeSerializedBufferBytes,
+                                              PaintOpBuffer::PaintOpAlign)));
+    TestOptionsProvider test_options_provider;
+    PaintOpBufferSerializer::Preamble preamble;
+
+    size_t simple_bytes_written = 0u;
+    timer_.Reset();
+    do {
+      SimpleBufferSerializer serializer(
+          memory.get(), kMaxLargeSerializedBufferBytes,
+          test_options_provider.serialize_options());
+      serializer.Serialize(&buffer, nullptr, preamble);
+      simple_bytes_written = serializer.written();
+
+      test_options_provider.client_paint_cache()->PurgeAll();
+      timer_.NextLap();
+    } while (!timer_.HasTimeLimitExpired());
+    CHECK_GT(simple_bytes_written, 0u);
+
+    perf_test::PerfResultReporter reporter(name, "  serialize");
+    reporter.RegisterImportantMetric("", "runs/s");
+    reporter.AddResult("", timer_.LapsPerSecond());
+
+    size_t parallel_bytes_written = 0u;
+    timer_.Reset();
+    do {
+      ParallelBufferSerializer serializer(
+          memory.get(), kMaxLargeSerializedBufferBytes,
+          test_options_provider.serialize_options());
+      serializer.Serialize(&buffer, nullptr, preamble);
+      parallel_bytes_written = serializer.written();
+
+      test_options_provider.client_paint_cache()->PurgeAll();
+      timer_.NextLap();
+    } while (!timer_.HasTimeLimitExpired());
+    CHECK_EQ(simple_bytes_written, parallel_bytes_written);
+
+    reporter = perf_test::PerfResultReporter(name, "  parallel_serialize");
+    reporter.RegisterImportantMetric("", "runs/s");
+    reporter.AddResult("", timer_.LapsPerSecond());
+  }
+
  protected:
   base::LapTimer timer_;
   std::unique_ptr<char, base::AlignedFreeDeleter> serialized_data_;
@@ -172,5 +220,60 @@ TEST_F(PaintOpPerfTest, TextOps) {
   RunTest("text", buffer);
 }
 
+// A large recorded page: boxes, borders and text in nested transforms and
+// clips, with some paths and layers.
+TEST_F(PaintOpPerfTest, LargePage) {
+  base::test::TaskEnvironment task_environment;
+  PaintOpBuffer buffer;
+
+  PaintFlags fill_flags;
+  fill_flags.setColor(SK_ColorBLUE);
+  PaintFlags border_flags;
+  border_flags.setStyle(PaintFlags::kStroke_Style);
+  border_flags.setStrokeWidth(2.f);
+  SkScalar intervals[] = {2.f, 2.f};
+  PaintFlags dashed_flags = border_flags;
+  dashed_flags.setPathEffect(SkDashPathEffect::Make(intervals, 2, 0));
+  PaintFlags shadow_flags;
+  shadow_flags.setMaskFilter(
+      SkMaskFilter::MakeBlur(SkBlurStyle::kNormal_SkBlurStyle, 3.f));
+
+  SkFont font;
+  font.setTypeface(SkTypeface::MakeDefault());
+  SkTextBlobBuilder builder;
+  const int glyph_count = 20;
+  const auto& run = builder.allocRun(font, glyph_count, 0.f, 0.f);
+  std::fill(run.glyphs, run.glyphs + glyph_count, 0);
+  auto blob = builder.make();
+
+  SkPath path;
+  path.addCircle(10, 10, 8);
+  path.addArc(SkRect::MakeXYWH(0, 0, 20, 20), 30, 120);
+
+  for (size_t i = 0; i < 5000; ++i) {
+    SkRect box = SkRect::MakeXYWH(0, 0, 200 + i % 50, 40 + i % 10);
+    buffer.push<SaveOp>();
+    buffer.push<TranslateOp>(10.f, 48.f);
+    buffer.push<ClipRectOp>(box, SkClipOp::kIntersect, false);
+    buffer.push<DrawRectOp>(box, i % 7 ? fill_flags : shadow_flags);
+    buffer.push<DrawRRectOp>(SkRRect::MakeRectXY(box, 4, 4),
+                             i % 5 ? border_flags : dashed_flags);
+    if (i % 4 == 0)
+      buffer.push<DrawTextBlobOp>(blob, 4.f, 20.f, fill_flags);
+    if (i % 20 == 0)
+      buffer.push<DrawPathOp>(path, fill_flags);
+    if (i % 50 == 0) {
+      buffer.push<SaveLayerAlphaOp>(&box, 200);
+      buffer.push<DrawLineOp>(0.f, 0.f, box.width(), box.height(),
+                              border_flags);
+      buffer.push<DrawOvalOp>(box, fill_flags);
+      buffer.push<RestoreOp>();
+    }
+    buffer.push<RestoreOp>();
+  }
+
+  RunSerializersTest("large_page", buffer);
+}
+
 }  // namespace
 }  // namespace cc
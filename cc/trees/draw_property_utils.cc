@@ -1184,8 +1184,8 @@ void UpdateElasticOverscroll(
           scroller_size.height());
     }
   }
-  overscroll_elasticity_transform_node->needs_local_transform_update = true;
-  property_trees->transform_tree.set_needs_update(true);
+  property_trees->transform_tree.SetNeedsLocalTransformUpdate(
+      overscroll_elasticity_transform_node);
 #else  // defined(OS_ANDROID)
   if (!overscroll_elasticity_transform_node) {
     DCHECK(elastic_overscroll.IsZero());
@@ -1201,8 +1201,8 @@ void UpdateElasticOverscroll(
 
   overscroll_elasticity_transform_node->scroll_offset = overscroll_offset;
 
-  overscroll_elasticity_transform_node->needs_local_transform_update = true;
-  property_trees->transform_tree.set_needs_update(true);
+  property_trees->transform_tree.SetNeedsLocalTransformUpdate(
+      overscroll_elasticity_transform_node);
 
 #endif  // defined(OS_ANDROID)
 }
@@ -1412,9 +1412,30 @@ void ComputeTransforms(TransformTree* transform_tree) {
 #endif
     return;
   }
+  if (transform_tree->needs_full_update()) {
+    for (int i = TransformTree::kContentsRootNodeId;
+         i < static_cast<int>(transform_tree->size()); ++i)
+      transform_tree->UpdateTransforms(i);
+    transform_tree->set_needs_update(false);
+    return;
+  }
+
+  // Only the nodes which need a local transform update and their subtrees
+  // need to be updated. A node's parent always comes before it, so a single
+  // pass in index order sees whether the parent was updated. Sticky position
+  // nodes depend on scroll offsets elsewhere in the tree, so they are always
+  // updated.
+  std::vector<bool> updated(transform_tree->size(), false);
   for (int i = TransformTree::kContentsRootNodeId;
-       i < static_cast<int>(transform_tree->size()); ++i)
-    transform_tree->UpdateTransforms(i);
+       i < static_cast<int>(transform_tree->size()); ++i) {
+    TransformNode* node = transform_tree->Node(i);
+    DCHECK_LT(node->parent_id, i);
+    if (node->needs_local_transform_update ||
+        node->sticky_position_constraint_id >= 0 || updated[node->parent_id]) {
+      transform_tree->UpdateTransforms(i);
+      updated[i] = true;
+    }
+  }
   transform_tree->set_needs_update(false);
 }
 
@@ -1497,8 +1518,8 @@ void UpdatePageScaleFactor(PropertyTrees* property_trees,
   page_scale_node->local.MakeIdentity();
   page_scale_node->local.Scale(page_scale_factor, page_scale_factor);
 
-  page_scale_node->needs_local_transform_update = true;
-  property_trees->transform_tree.set_needs_update(true);
+  property_trees->transform_tree.SetNeedsLocalTransformUpdate(
+      page_scale_node);
 }
 
 void CalculateDrawProperties(
@@ -22,6 +22,7 @@
 #include "cc/test/layer_tree_json_parser.h"
 #include "cc/test/layer_tree_test.h"
 #include "cc/trees/layer_tree_impl.h"
+#include "cc/trees/property_tree.h"
 #include "cc/trees/transform_node.h"
 #include "components/viz/test/paths.h"
 #include "testing/perf/perf_result_reporter.h"
@@ -97,6 +98,50 @@ class CalcDrawPropsTest : public DrawPropertyUtilsPerfTest {
   }
 };
 
+// Changes the local transform of one node before each computation of the
+// draw properties, as a transform animation does, to measure the update of a
+// tree with many layers of which few change.
+class CalcDrawPropsWithTransformChangeTest : public DrawPropertyUtilsPerfTest {
+ public:
+  // With |full_update|, the whole transform tree is marked as needing an
+  // update, instead of only the changed node.
+  void RunCalcDrawProps(bool full_update) {
+    full_update_ = full_update;
+    RunTest(CompositorMode::SINGLE_THREADED);
+  }
+
+  void BeginTest() override { PostSetNeedsCommitToMainThread(); }
+
+  void DrawLayersOnThread(LayerTreeHostImpl* host_impl) override {
+    TransformTree& transform_tree =
+        host_impl->active_tree()->property_trees()->transform_tree;
+    // The last node is deep in the tree, and has few descendants if any.
+    TransformNode* node = transform_tree.Node(transform_tree.size() - 1);
+    const gfx::Transform local = node->local;
+    timer_.Reset();
+
+    do {
+      node->local = local;
+      node->local.Translate(timer_.NumLaps() % 2, 0);
+      if (full_update_) {
+        node->needs_local_transform_update = true;
+        transform_tree.set_needs_update(true);
+      } else {
+        transform_tree.SetNeedsLocalTransformUpdate(node);
+      }
+      RenderSurfaceList render_surface_list;
+      draw_property_utils::CalculateDrawProperties(host_impl->active_tree(),
+                                                   &render_surface_list);
+      timer_.NextLap();
+    } while (!timer_.HasTimeLimitExpired());
+
+    EndTest();
+  }
+
+ private:
+  bool full_update_ = false;
+};
+
 TEST_F(CalcDrawPropsTest, TenTen) {
   SetUpReporter("10_10");
   ReadTestFile("10_10_layer_tree");
@@ -121,5 +166,24 @@ TEST_F(CalcDrawPropsTest, TouchRegionHeavy) {
   RunCalcDrawProps();
 }
 
+TEST_F(CalcDrawPropsWithTransformChangeTest, HeavyPageOneTransformChanged) {
+  SetUpReporter("heavy_page_one_transform_changed");
+  ReadTestFile("heavy_layer_tree");
+  RunCalcDrawProps(false);
+}
+
+TEST_F(CalcDrawPropsWithTransformChangeTest, HeavyPageFullTransformUpdate) {
+  SetUpReporter("heavy_page_full_transform_update");
+  ReadTestFile("heavy_layer_tree");
+  RunCalcDrawProps(true);
+}
+
+TEST_F(CalcDrawPropsWithTransformChangeTest,
+       TouchRegionHeavyOneTransformChanged) {
+  SetUpReporter("touch_region_heavy_one_transform_changed");
+  ReadTestFile("touch_region_heavy");
+  RunCalcDrawProps(false);
+}
+
 }  // namespace
 }  // namespace cc
@@ -971,9 +971,8 @@ void LayerTreeHost::UpdateScrollOffsetFromImpl(
       auto* transform_node = transform_tree.Node(scroll_node->transform_id);
       if (transform_node->scroll_offset != new_offset) {
         transform_node->scroll_offset = new_offset;
-        transform_node->needs_local_transform_update = true;
         transform_node->transform_changed = true;
-        transform_tree.set_needs_update(true);
+        transform_tree.SetNeedsLocalTransformUpdate(transform_node);
       }
 
       // The transform tree has been modified which requires a call to
@@ -1765,9 +1764,8 @@ void LayerTreeHost::SetElementTransformMutated(
       return;
 
     node->local = transform;
-    node->needs_local_transform_update = true;
     node->has_potential_animation = true;
-    property_trees()->transform_tree.set_needs_update(true);
+    property_trees()->transform_tree.SetNeedsLocalTransformUpdate(node);
   }
 
   SetNeedsUpdateLayers();
@@ -242,8 +242,7 @@ void LayerTreeImpl::DidUpdateScrollOffset(ElementId id) {
     if (transform_node->scroll_offset !=
         scroll_tree.current_scroll_offset(id)) {
       transform_node->scroll_offset = scroll_tree.current_scroll_offset(id);
-      transform_node->needs_local_transform_update = true;
-      transform_tree.set_needs_update(true);
+      transform_tree.SetNeedsLocalTransformUpdate(transform_node);
     }
     transform_node->transform_changed = true;
     property_trees()->changed = true;
@@ -1136,8 +1135,7 @@ void LayerTreeImpl::UpdatePropertyTreeAnimationFromMainThread() {
       continue;
     }
     node->local = element_id_to_transform->second;
-    node->needs_local_transform_update = true;
-    property_trees_.transform_tree.set_needs_update(true);
+    property_trees_.transform_tree.SetNeedsLocalTransformUpdate(node);
     ++element_id_to_transform;
   }
 
@@ -1161,7 +1159,8 @@ void LayerTreeImpl::UpdateTransformAnimation(ElementId element_id,
         node->has_potential_animation = has_potential_animation;
         node->maximum_animation_scale =
             mutator_host()->MaximumScale(element_id, list_type);
-        transform_tree.set_needs_update(true);
+        // Updating the node propagates the change to its subtree.
+        transform_tree.SetNeedsLocalTransformUpdate(node);
         set_needs_update_draw_properties();
       }
     }
@@ -55,7 +55,8 @@ PropertyTree<T>& PropertyTree<T>::operator=(const PropertyTree<T>&) = default;
 TransformTree::TransformTree()
     : page_scale_factor_(1.f),
       device_scale_factor_(1.f),
-      device_transform_scale_factor_(1.f) {
+      device_transform_scale_factor_(1.f),
+      needs_full_update_(true) {
   cached_data_.push_back(TransformCachedNodeData());
 }
 
@@ -123,6 +124,7 @@ void TransformTree::clear() {
   page_scale_factor_ = 1.f;
   device_scale_factor_ = 1.f;
   device_transform_scale_factor_ = 1.f;
+  needs_full_update_ = true;
   nodes_affected_by_outer_viewport_bounds_delta_.clear();
   cached_data_.clear();
   cached_data_.push_back(TransformCachedNodeData());
@@ -137,6 +139,15 @@ void TransformTree::set_needs_update(bool needs_update) {
   if (needs_update && !PropertyTree<TransformNode>::needs_update())
     property_trees()->UpdateTransformTreeUpdateNumber();
   PropertyTree<TransformNode>::set_needs_update(needs_update);
+  needs_full_update_ = needs_update;
+}
+
+void TransformTree::SetNeedsLocalTransformUpdate(TransformNode* node) {
+  node->needs_local_transform_update = true;
+  if (PropertyTree<TransformNode>::needs_update())
+    return;
+  property_trees()->UpdateTransformTreeUpdateNumber();
+  PropertyTree<TransformNode>::set_needs_update(true);
 }
 
 TransformNode* TransformTree::FindNodeFromElementId(ElementId id) {
@@ -154,10 +165,9 @@ bool TransformTree::OnTransformAnimated(ElementId element_id,
   if (node->local == transform)
     return false;
   node->local = transform;
-  node->needs_local_transform_update = true;
+  SetNeedsLocalTransformUpdate(node);
   node->transform_changed = true;
   property_trees()->changed = true;
-  set_needs_update(true);
   return true;
 }
 
@@ -186,6 +196,7 @@ void TransformTree::UpdateTransforms(int id) {
   UpdateTransformChanged(node, parent_node);
   UpdateNodeAndAncestorsAreAnimatedOrInvertible(node, parent_node);
   UpdateNodeOrAncestorsWillChangeTransform(node, parent_node);
+  property_trees()->DidUpdateTransforms(id);
 
   DCHECK(!node->needs_local_transform_update);
 }
@@ -620,8 +631,7 @@ void TransformTree::SetRootScaleAndTransform(
   TransformNode* contents_root_node = Node(kContentsRootNodeId);
   if (contents_root_node->local != transform) {
     contents_root_node->local = transform;
-    contents_root_node->needs_local_transform_update = true;
-    set_needs_update(true);
+    SetNeedsLocalTransformUpdate(contents_root_node);
   }
 }
 
@@ -629,9 +639,8 @@ void TransformTree::UpdateOuterViewportContainerBoundsDelta() {
   if (nodes_affected_by_outer_viewport_bounds_delta_.empty())
     return;
 
-  set_needs_update(true);
   for (int i : nodes_affected_by_outer_viewport_bounds_delta_)
-    Node(i)->needs_local_transform_update = true;
+    SetNeedsLocalTransformUpdate(Node(i));
 }
 
 void TransformTree::AddNodeAffectedByOuterViewportBoundsDelta(int node_id) {
@@ -836,7 +845,7 @@ void EffectTree::UpdateSurfaceContentsScale(EffectNode* effect_node) {
   // Invalidates the draw transform cache and updates the clip for the surface.
   if (old_scale != effect_node->surface_contents_scale) {
     property_trees()->clip_tree.set_needs_update(true);
-    property_trees()->UpdateTransformTreeUpdateNumber();
+    property_trees()->InvalidateDrawTransforms();
   }
 }
 
@@ -1746,7 +1755,7 @@ void ScrollTree::NotifyDidChangeScrollbarsHidden(ElementId scroll_element_id,
 }
 
 PropertyTreesCachedData::PropertyTreesCachedData()
-    : transform_tree_update_number(0) {
+    : transform_tree_update_number(0), draw_transforms_update_number(0) {
   animation_scales.clear();
 }
 
@@ -1893,7 +1902,8 @@ bool PropertyTrees::ElementIsAnimatingChanged(
           if (mask.potentially_animating[property]) {
             transform_node->has_potential_animation =
                 state.potentially_animating[property];
-            transform_tree.set_needs_update(true);
+            // Updating the node propagates the change to its subtree.
+            transform_tree.SetNeedsLocalTransformUpdate(transform_node);
             // We track transform updates specifically, whereas we
             // don't do so for opacity/filter, because whether a
             // transform is animating can change what layer(s) we
@@ -2246,10 +2256,17 @@ DrawTransforms& PropertyTrees::GetDrawTransforms(int transform_id,
   DrawTransformData& data =
       FetchDrawTransformsDataFromCache(transform_id, dest_id);
 
-  DCHECK(data.update_number != cached_data_.transform_tree_update_number ||
+  // The draw transforms are valid if they were computed after the last
+  // update of both nodes.
+  DCHECK(data.update_number == kInvalidUpdateNumber ||
          data.target_id != EffectTree::kInvalidNodeId);
-  if (data.update_number == cached_data_.transform_tree_update_number)
+  if (data.update_number != kInvalidUpdateNumber &&
+      data.update_number >= cached_data_.draw_transforms_update_number &&
+      data.update_number >=
+          cached_data_.transform_update_numbers[transform_id] &&
+      data.update_number >= cached_data_.transform_update_numbers[dest_id]) {
     return data.transforms;
+  }
 
   // Cache miss.
   gfx::Transform target_space_transform;
@@ -2308,12 +2325,31 @@ void PropertyTrees::ResetCachedData() {
     draw_transforms_for_id[0].update_number = kInvalidUpdateNumber;
     draw_transforms_for_id[0].target_id = EffectTree::kInvalidNodeId;
   }
+  cached_data_.transform_update_numbers.assign(transform_count,
+                                               kInvalidUpdateNumber);
+  cached_data_.draw_transforms_update_number = 0;
 }
 
 void PropertyTrees::UpdateTransformTreeUpdateNumber() {
   cached_data_.transform_tree_update_number++;
 }
 
+void PropertyTrees::DidUpdateTransforms(int transform_id) {
+  // The property tree builder updates nodes as it inserts them, before the
+  // cached data is resized for them.
+  if (transform_id <
+      static_cast<int>(cached_data_.transform_update_numbers.size())) {
+    cached_data_.transform_update_numbers[transform_id] =
+        cached_data_.transform_tree_update_number;
+  }
+}
+
+void PropertyTrees::InvalidateDrawTransforms() {
+  UpdateTransformTreeUpdateNumber();
+  cached_data_.draw_transforms_update_number =
+      cached_data_.transform_tree_update_number;
+}
+
 gfx::Transform PropertyTrees::ToScreenSpaceTransformWithoutSurfaceContentsScale(
     int transform_id,
     int effect_id) const {
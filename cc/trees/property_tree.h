@@ -154,7 +154,15 @@ class CC_EXPORT TransformTree final : public PropertyTree<TransformNode> {
   void UpdateNodeOrAncestorsWillChangeTransform(TransformNode* node,
                                                 TransformNode* parent_node);
 
+  // Marks the whole tree as needing an update, or as up to date.
   void set_needs_update(bool needs_update);
+  // Marks |node| as needing its local transform recomputed. Unlike
+  // set_needs_update(true), this doesn't make the next update recompute the
+  // whole tree, only the marked nodes and their subtrees.
+  void SetNeedsLocalTransformUpdate(TransformNode* node);
+  // Whether the next update must recompute every node, rather than only the
+  // ones marked by SetNeedsLocalTransformUpdate() and their subtrees.
+  bool needs_full_update() const { return needs_full_update_; }
 
   // We store the page scale factor on the transform tree so that it can be
   // easily be retrieved and updated in UpdatePageScale.
@@ -243,6 +251,7 @@ class CC_EXPORT TransformTree final : public PropertyTree<TransformNode> {
   float page_scale_factor_;
   float device_scale_factor_;
   float device_transform_scale_factor_;
+  bool needs_full_update_;
   std::vector<int> nodes_affected_by_outer_viewport_bounds_delta_;
   std::vector<TransformCachedNodeData> cached_data_;
   std::vector<StickyPositionNodeData> sticky_position_data_;
@@ -614,6 +623,14 @@ struct PropertyTreesCachedData {
   int transform_tree_update_number;
   std::vector<AnimationScaleData> animation_scales;
   mutable std::vector<std::vector<DrawTransformData>> draw_transforms;
+  // The transform tree update number at which each transform node was last
+  // updated. Cached draw transforms are only invalidated by updates of their
+  // own source and destination nodes, so that an update of a small subtree
+  // keeps the draw transforms of the rest of the tree.
+  std::vector<int> transform_update_numbers;
+  // Cached draw transforms computed before this update number are invalid,
+  // whichever nodes they are between.
+  int draw_transforms_update_number;
 
   PropertyTreesCachedData();
   ~PropertyTreesCachedData();
@@ -711,6 +728,11 @@ class CC_EXPORT PropertyTrees final {
 
   void ResetCachedData();
   void UpdateTransformTreeUpdateNumber();
+  // Invalidates the cached draw transforms from and to |transform_id|, after
+  // its transforms were updated.
+  void DidUpdateTransforms(int transform_id);
+  // Invalidates all the cached draw transforms.
+  void InvalidateDrawTransforms();
   gfx::Transform ToScreenSpaceTransformWithoutSurfaceContentsScale(
       int transform_id,
       int effect_id) const;
@@ -370,6 +370,123 @@ TEST(PropertyTreeTest, ComputeTransformToTargetWithZeroSurfaceContentsScale) {
   EXPECT_TRANSFORM_EQ(expected_transform, transform);
 }
 
+TEST(PropertyTreeTest, ComputeTransformsUpdatesOnlyChangedSubtrees) {
+  PropertyTrees property_trees;
+  TransformTree& tree = property_trees.transform_tree;
+  int contents_root = tree.Insert(TransformNode(), 0);
+
+  int parent = tree.Insert(TransformNode(), contents_root);
+  tree.Node(parent)->local.Translate(2.f, 2.f);
+  int child = tree.Insert(TransformNode(), parent);
+  tree.Node(child)->local.Translate(3.f, 3.f);
+  int sibling = tree.Insert(TransformNode(), contents_root);
+  tree.Node(sibling)->local.Translate(7.f, 7.f);
+
+  tree.set_needs_update(true);
+  EXPECT_TRUE(tree.needs_full_update());
+  draw_property_utils::ComputeTransforms(&tree);
+  EXPECT_FALSE(tree.needs_update());
+  EXPECT_FALSE(tree.needs_full_update());
+
+  gfx::Transform expected;
+  expected.Translate(5.f, 5.f);
+  EXPECT_TRANSFORM_EQ(expected, tree.ToScreen(child));
+
+  // Only the parent is marked, so the sibling keeps its stale transform.
+  tree.Node(parent)->local.MakeIdentity();
+  tree.Node(parent)->local.Translate(4.f, 4.f);
+  tree.SetNeedsLocalTransformUpdate(tree.Node(parent));
+  tree.Node(sibling)->local.MakeIdentity();
+  tree.Node(sibling)->local.Translate(9.f, 9.f);
+  EXPECT_TRUE(tree.needs_update());
+  EXPECT_FALSE(tree.needs_full_update());
+  draw_property_utils::ComputeTransforms(&tree);
+
+  expected.MakeIdentity();
+  expected.Translate(7.f, 7.f);
+  EXPECT_TRANSFORM_EQ(expected, tree.ToScreen(child));
+  EXPECT_TRANSFORM_EQ(expected, tree.ToScreen(sibling));
+
+  // A full update recomputes every node.
+  tree.set_needs_update(true);
+  EXPECT_TRUE(tree.needs_full_update());
+  draw_property_utils::ComputeTransforms(&tree);
+
+  expected.MakeIdentity();
+  expected.Translate(9.f, 9.f);
+  EXPECT_TRANSFORM_EQ(expected, tree.ToScreen(sibling));
+}
+
+TEST(PropertyTreeTest, DrawTransformsInvalidatedByChangedSubtrees) {
+  PropertyTrees property_trees;
+  TransformTree& tree = property_trees.transform_tree;
+  EffectTree& effect_tree = property_trees.effect_tree;
+
+  int contents_root = tree.Insert(TransformNode(), 0);
+  int effect_root = effect_tree.Insert(EffectNode(), 0);
+  effect_tree.Node(effect_root)->transform_id = contents_root;
+  effect_tree.Node(effect_root)->surface_contents_scale =
+      gfx::Vector2dF(1.f, 1.f);
+
+  int parent = tree.Insert(TransformNode(), contents_root);
+  tree.Node(parent)->local.Translate(2.f, 2.f);
+  int effect_parent = effect_tree.Insert(EffectNode(), effect_root);
+  effect_tree.Node(effect_parent)->transform_id = parent;
+  effect_tree.Node(effect_parent)->surface_contents_scale =
+      gfx::Vector2dF(1.f, 1.f);
+  int child = tree.Insert(TransformNode(), parent);
+  tree.Node(child)->local.Translate(3.f, 3.f);
+  int sibling = tree.Insert(TransformNode(), contents_root);
+  tree.Node(sibling)->local.Translate(7.f, 7.f);
+
+  tree.set_needs_update(true);
+  draw_property_utils::ComputeTransforms(&tree);
+  property_trees.ResetCachedData();
+
+  gfx::Transform to_target;
+  gfx::Transform expected;
+  expected.Translate(5.f, 5.f);
+  property_trees.GetToTarget(child, effect_root, &to_target);
+  EXPECT_TRANSFORM_EQ(expected, to_target);
+  expected.MakeIdentity();
+  expected.Translate(3.f, 3.f);
+  property_trees.GetToTarget(child, effect_parent, &to_target);
+  EXPECT_TRANSFORM_EQ(expected, to_target);
+  expected.MakeIdentity();
+  expected.Translate(7.f, 7.f);
+  property_trees.GetToTarget(sibling, effect_root, &to_target);
+  EXPECT_TRANSFORM_EQ(expected, to_target);
+
+  tree.Node(parent)->local.MakeIdentity();
+  tree.Node(parent)->local.Translate(4.f, 4.f);
+  tree.SetNeedsLocalTransformUpdate(tree.Node(parent));
+  draw_property_utils::ComputeTransforms(&tree);
+
+  expected.MakeIdentity();
+  expected.Translate(7.f, 7.f);
+  property_trees.GetToTarget(child, effect_root, &to_target);
+  EXPECT_TRANSFORM_EQ(expected, to_target);
+  expected.MakeIdentity();
+  expected.Translate(3.f, 3.f);
+  property_trees.GetToTarget(child, effect_parent, &to_target);
+  EXPECT_TRANSFORM_EQ(expected, to_target);
+  expected.MakeIdentity();
+  expected.Translate(7.f, 7.f);
+  property_trees.GetToTarget(sibling, effect_root, &to_target);
+  EXPECT_TRANSFORM_EQ(expected, to_target);
+
+  // Changing the surface contents scale invalidates every draw transform.
+  effect_tree.Node(effect_root)->surface_contents_scale =
+      gfx::Vector2dF(2.f, 2.f);
+  property_trees.InvalidateDrawTransforms();
+
+  expected.MakeIdentity();
+  expected.Scale(2.f, 2.f);
+  expected.Translate(7.f, 7.f);
+  property_trees.GetToTarget(sibling, effect_root, &to_target);
+  EXPECT_TRANSFORM_EQ(expected, to_target);
+}
+
 TEST(PropertyTreeTest, FlatteningWhenDestinationHasOnlyFlatAncestors) {
   // This tests that flattening is performed correctly when
   // destination and its ancestors are flat, but there are 3d transforms
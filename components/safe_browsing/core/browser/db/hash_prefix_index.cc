@@ -0,0 +1,112 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "components/safe_browsing/core/browser/db/hash_prefix_index.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "base/check_op.h"
+#include "base/numerics/safe_conversions.h"
+#include "build/build_config.h"
+#include "components/safe_browsing/core/browser/db/prefix_iterator.h"
+
+#if defined(ARCH_CPU_X86_FAMILY) && !defined(OS_NACL)
+#include <emmintrin.h>
+#define HASH_PREFIX_INDEX_SSE2
+#endif
+
+namespace safe_browsing {
+
+namespace {
+
+constexpr size_t kNumBuckets = 1 << 16;
+
+// Buckets with more hash prefixes than this are binary searched instead of
+// scanned. With the hash prefixes spread evenly, as they are, this only
+// happens for lists of more than about 4 million hash prefixes.
+constexpr size_t kMaxScannedBucketSize = 64;
+
+size_t GetBucket(base::StringPiece prefix) {
+  return static_cast<uint8_t>(prefix[0]) << 8 | static_cast<uint8_t>(prefix[1]);
+}
+
+// Returns true if one of the |count| 4 byte hash prefixes at |prefixes| is
+// |prefix|.
+bool ScanBucket(const char* prefixes, size_t count, base::StringPiece prefix) {
+  uint32_t needle;
+  memcpy(&needle, prefix.data(), sizeof(needle));
+  size_t i = 0;
+#if defined(HASH_PREFIX_INDEX_SSE2)
+  // Compares 4 hash prefixes at a time.
+  const __m128i needles = _mm_set1_epi32(static_cast<int>(needle));
+  for (; i + 4 <= count; i += 4) {
+    const __m128i block = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(prefixes + i * sizeof(needle)));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi32(block, needles)))
+      return true;
+  }
+#endif
+  for (; i < count; ++i) {
+    uint32_t candidate;
+    memcpy(&candidate, prefixes + i * sizeof(candidate), sizeof(candidate));
+    if (candidate == needle)
+      return true;
+  }
+  return false;
+}
+
+}  // namespace
+
+HashPrefixIndex::HashPrefixIndex(base::StringPiece prefixes,
+                                 PrefixSize prefix_size)
+    : prefix_size_(prefix_size),
+      num_prefixes_(prefixes.size() / prefix_size),
+      bucket_offsets_(kNumBuckets + 1) {
+  DCHECK_GE(prefix_size, kMinHashPrefixLength);
+  DCHECK_EQ(0u, prefixes.size() % prefix_size);
+  DCHECK(std::is_sorted(PrefixIterator(prefixes, 0, prefix_size),
+                        PrefixIterator(prefixes, num_prefixes_, prefix_size)));
+  // The offsets are 32 bit to halve the size of the table. The stores are much
+  // smaller than 4 billion hash prefixes.
+  const uint32_t num_prefixes = base::checked_cast<uint32_t>(num_prefixes_);
+
+  uint32_t index = 0;
+  for (size_t bucket = 0; bucket < kNumBuckets; ++bucket) {
+    bucket_offsets_[bucket] = index;
+    while (index < num_prefixes &&
+           GetBucket(prefixes.substr(index * prefix_size)) == bucket) {
+      ++index;
+    }
+  }
+  bucket_offsets_[kNumBuckets] = index;
+}
+
+HashPrefixIndex::HashPrefixIndex(HashPrefixIndex&& other) = default;
+
+HashPrefixIndex& HashPrefixIndex::operator=(HashPrefixIndex&& other) = default;
+
+HashPrefixIndex::~HashPrefixIndex() = default;
+
+bool HashPrefixIndex::Contains(base::StringPiece prefixes,
+                               base::StringPiece prefix) const {
+  CHECK_EQ(num_prefixes_ * prefix_size_, prefixes.size());
+  if (prefix.size() != prefix_size_)
+    return false;
+
+  const size_t bucket = GetBucket(prefix);
+  const size_t begin = bucket_offsets_[bucket];
+  const size_t end = bucket_offsets_[bucket + 1];
+  if (prefix_size_ == kMinHashPrefixLength &&
+      end - begin <= kMaxScannedBucketSize) {
+    return ScanBucket(prefixes.data() + begin * prefix_size_, end - begin,
+                      prefix);
+  }
+  return std::binary_search(PrefixIterator(prefixes, begin, prefix_size_),
+                            PrefixIterator(prefixes, end, prefix_size_),
+                            prefix);
+}
+
+}  // namespace safe_browsing
@@ -0,0 +1,56 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef COMPONENTS_SAFE_BROWSING_CORE_BROWSER_DB_HASH_PREFIX_INDEX_H_
+#define COMPONENTS_SAFE_BROWSING_CORE_BROWSER_DB_HASH_PREFIX_INDEX_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "base/strings/string_piece.h"
+#include "components/safe_browsing/core/browser/db/v4_protocol_manager_util.h"
+
+namespace safe_browsing {
+
+// An index of a |HashPrefixes|, the sorted and concatenated hash prefixes of
+// one size. It's a two-level radix table: the first level maps the first 16
+// bits of a hash prefix to the bucket of hash prefixes which start with them,
+// and the second level is the bucket itself, which is small enough to scan,
+// with SIMD instructions for 4 byte hash prefixes. This replaces the cache
+// misses of a binary search over a large list by one or two.
+//
+// The index doesn't keep a pointer to the hash prefixes, which must be passed
+// to each lookup, and be the ones the index was built from.
+class HashPrefixIndex {
+ public:
+  // Builds the index of |prefixes|, which must be sorted and have a size
+  // which is a multiple of |prefix_size|.
+  HashPrefixIndex(base::StringPiece prefixes, PrefixSize prefix_size);
+  HashPrefixIndex(HashPrefixIndex&& other);
+  HashPrefixIndex& operator=(HashPrefixIndex&& other);
+  HashPrefixIndex(const HashPrefixIndex&) = delete;
+  HashPrefixIndex& operator=(const HashPrefixIndex&) = delete;
+  ~HashPrefixIndex();
+
+  // Returns true if |prefix| is one of |prefixes|, which must be the hash
+  // prefixes the index was built from.
+  bool Contains(base::StringPiece prefixes, base::StringPiece prefix) const;
+
+  PrefixSize prefix_size() const { return prefix_size_; }
+  size_t num_prefixes() const { return num_prefixes_; }
+
+ private:
+  PrefixSize prefix_size_;
+  size_t num_prefixes_;
+
+  // The index of the first hash prefix of each bucket, and the number of hash
+  // prefixes at the end.
+  std::vector<uint32_t> bucket_offsets_;
+};
+
+}  // namespace safe_browsing
+
+#endif  // COMPONENTS_SAFE_BROWSING_CORE_BROWSER_DB_HASH_PREFIX_INDEX_H_
@@ -0,0 +1,83 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "components/safe_browsing/core/browser/db/hash_prefix_index.h"
+
+#include <string>
+
+#include "base/strings/string_piece.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace safe_browsing {
+
+namespace {
+
+// Returns the 4 byte hash prefix of |value|, in big-endian order so that the
+// hash prefixes of increasing values are sorted.
+std::string GetPrefix(uint32_t value) {
+  return std::string({static_cast<char>(value >> 24),
+                      static_cast<char>(value >> 16),
+                      static_cast<char>(value >> 8), static_cast<char>(value)});
+}
+
+}  // namespace
+
+TEST(HashPrefixIndexTest, Empty) {
+  const HashPrefixIndex index("", 4);
+  EXPECT_EQ(0u, index.num_prefixes());
+  EXPECT_FALSE(index.Contains("", "abcd"));
+}
+
+TEST(HashPrefixIndexTest, FourBytePrefixes) {
+  std::string prefixes;
+  // Every third value in the first and last buckets, and spread over the
+  // others.
+  for (uint32_t value = 0; value < 300; value += 3)
+    prefixes += GetPrefix(value);
+  for (uint32_t value = 300; value < 0xffff0000; value += 0x12345)
+    prefixes += GetPrefix(value);
+  for (uint32_t value = 0xffff0000; value < 0xffff0100; value += 3)
+    prefixes += GetPrefix(value);
+
+  const HashPrefixIndex index(prefixes, 4);
+  EXPECT_EQ(prefixes.size() / 4, index.num_prefixes());
+  EXPECT_EQ(4u, index.prefix_size());
+  for (uint32_t value = 0; value < 300; ++value)
+    EXPECT_EQ(value % 3 == 0, index.Contains(prefixes, GetPrefix(value)));
+  for (uint32_t value = 300; value < 0xffff0000 - 0x12345; value += 0x12345) {
+    EXPECT_TRUE(index.Contains(prefixes, GetPrefix(value)));
+    EXPECT_FALSE(index.Contains(prefixes, GetPrefix(value + 1)));
+  }
+  for (uint32_t value = 0xffff0000; value < 0xffff0100; ++value)
+    EXPECT_EQ(value % 3 == 0, index.Contains(prefixes, GetPrefix(value)));
+}
+
+TEST(HashPrefixIndexTest, LargeBucket) {
+  // More hash prefixes with the same first 16 bits than are scanned.
+  std::string prefixes;
+  for (uint32_t value = 0x12340000; value < 0x12340400; value += 2)
+    prefixes += GetPrefix(value);
+
+  const HashPrefixIndex index(prefixes, 4);
+  for (uint32_t value = 0x12340000; value < 0x12340400; ++value)
+    EXPECT_EQ(value % 2 == 0, index.Contains(prefixes, GetPrefix(value)));
+  EXPECT_FALSE(index.Contains(prefixes, GetPrefix(0x12330000)));
+  EXPECT_FALSE(index.Contains(prefixes, GetPrefix(0x12350000)));
+}
+
+TEST(HashPrefixIndexTest, LongerPrefixes) {
+  const std::string prefixes = "aaaaa" "abcde" "abcdf" "bcdef" "zzzzz";
+  const HashPrefixIndex index(prefixes, 5);
+  EXPECT_EQ(5u, index.num_prefixes());
+  EXPECT_TRUE(index.Contains(prefixes, "aaaaa"));
+  EXPECT_TRUE(index.Contains(prefixes, "abcdf"));
+  EXPECT_TRUE(index.Contains(prefixes, "zzzzz"));
+  EXPECT_FALSE(index.Contains(prefixes, "abcdd"));
+  EXPECT_FALSE(index.Contains(prefixes, "bcdee"));
+  // Hash prefixes of another size never match.
+  EXPECT_FALSE(index.Contains(prefixes, "abcd"));
+  EXPECT_FALSE(index.Contains(prefixes, "abcdef"));
+}
+
+}  // namespace safe_browsing
@@ -14,6 +14,7 @@
 #include "base/memory/ptr_util.h"
 #include "base/metrics/histogram_macros.h"
 #include "base/task/task_runner_util.h"
+#include "base/task/thread_pool.h"
 #include "base/threading/sequenced_task_runner_handle.h"
 #include "build/build_config.h"
 #include "components/safe_browsing/core/common/proto/webui.pb.h"
@@ -177,10 +178,6 @@ void V4Database::ApplyUpdate(
 
   db_updated_callback_ = db_updated_callback;
 
-  // Post the V4Store update task on the DB sequence but get the callback on the
-  // current sequence.
-  const scoped_refptr<base::SequencedTaskRunner> current_task_runner =
-      base::SequencedTaskRunnerHandle::Get();
   for (std::unique_ptr<ListUpdateResponse>& response :
        *parsed_server_response) {
     ListIdentifier identifier(*response);
@@ -190,14 +187,20 @@ void V4Database::ApplyUpdate(
       if (old_store->state() != response->new_client_state()) {
         // A different state implies there are updates to process.
         pending_store_updates_++;
-        UpdatedStoreReadyCallback store_ready_callback =
-            base::BindOnce(&V4Database::UpdatedStoreReady,
-                           weak_factory_on_io_.GetWeakPtr(), identifier);
-        db_task_runner_->PostTask(
-            FROM_HERE, base::BindOnce(&V4Store::ApplyUpdate,
-                                      base::Unretained(old_store.get()),
-                                      std::move(response), current_task_runner,
-                                      std::move(store_ready_callback)));
+        if (V4Store::HasRiceEncodedData(*response)) {
+          // Decode the lists on the thread pool, so that the lists of
+          // different stores decode in parallel rather than one after another
+          // on the DB sequence. The reply comes back to this sequence, so it's
+          // dropped if the database is destroyed in the meantime.
+          base::ThreadPool::PostTaskAndReplyWithResult(
+              FROM_HERE, {base::TaskPriority::USER_VISIBLE},
+              base::BindOnce(&V4Store::DecodeUpdate, old_store->store_path(),
+                             std::move(response)),
+              base::BindOnce(&V4Database::PostStoreUpdate,
+                             weak_factory_on_io_.GetWeakPtr(), identifier));
+        } else {
+          PostStoreUpdate(identifier, std::move(response));
+        }
       }
     } else {
       NOTREACHED() << "Got update for unexpected identifier: " << identifier;
@@ -205,11 +208,33 @@ void V4Database::ApplyUpdate(
   }
 
   if (!pending_store_updates_) {
-    current_task_runner->PostTask(FROM_HERE, db_updated_callback_);
+    base::SequencedTaskRunnerHandle::Get()->PostTask(FROM_HERE,
+                                                     db_updated_callback_);
     db_updated_callback_.Reset();
   }
 }
 
+void V4Database::PostStoreUpdate(
+    ListIdentifier identifier,
+    std::unique_ptr<ListUpdateResponse> response) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(io_sequence_checker_);
+  StoreMap::const_iterator iter = store_map_->find(identifier);
+  DCHECK(iter != store_map_->end());
+  const std::unique_ptr<V4Store>& old_store = iter->second;
+
+  // Post the V4Store update task on the DB sequence but get the callback on the
+  // current sequence.
+  UpdatedStoreReadyCallback store_ready_callback =
+      base::BindOnce(&V4Database::UpdatedStoreReady,
+                     weak_factory_on_io_.GetWeakPtr(), identifier);
+  db_task_runner_->PostTask(
+      FROM_HERE,
+      base::BindOnce(&V4Store::ApplyUpdate, base::Unretained(old_store.get()),
+                     std::move(response),
+                     base::SequencedTaskRunnerHandle::Get(),
+                     std::move(store_ready_callback)));
+}
+
 void V4Database::UpdatedStoreReady(ListIdentifier identifier,
                                    std::unique_ptr<V4Store> new_store) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(io_sequence_checker_);
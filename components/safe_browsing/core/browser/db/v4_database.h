@@ -225,6 +225,11 @@ class V4Database {
   static void RegisterStoreFactoryForTest(
       std::unique_ptr<V4StoreFactory> factory);
 
+  // Posts the task that applies |response| to the store for |identifier| on the
+  // DB sequence.
+  void PostStoreUpdate(ListIdentifier identifier,
+                       std::unique_ptr<ListUpdateResponse> response);
+
   // Callback called when a new store has been created and is ready to be used.
   // This method updates the store_map_ to point to the new store, which causes
   // the old store to get deleted.
@@ -259,6 +259,51 @@ TEST_F(V4DatabaseTest, TestApplyUpdateWithNewStates) {
   WaitForTasksOnTaskRunner();
 }
 
+// Test to check that Rice-encoded updates are decoded before they're applied.
+TEST_F(V4DatabaseTest, TestApplyUpdateWithRiceEncodedUpdate) {
+  RegisterFactory();
+
+  V4Database::Create(task_runner_, database_dirname_, list_infos_,
+                     std::move(callback_db_ready_));
+  created_but_not_called_back_ = true;
+  WaitForTasksOnTaskRunner();
+
+  EXPECT_TRUE(v4_database_);
+  const StoreMap* db_stores = v4_database_->store_map_.get();
+  for (const auto& store_iter : *db_stores) {
+    V4Store* store = store_iter.second.get();
+    expected_store_state_map_[store_iter.first] = store->state() + "_fake";
+    old_stores_map_[store_iter.first] = store;
+  }
+
+  std::unique_ptr<ParsedServerResponse> parsed_server_response =
+      CreateFakeServerResponse(expected_store_state_map_, true);
+  for (std::unique_ptr<ListUpdateResponse>& lur : *parsed_server_response) {
+    ThreatEntrySet* addition = lur->add_additions();
+    addition->set_compression_type(RICE);
+    RiceDeltaEncoding* rice_hashes = addition->mutable_rice_hashes();
+    rice_hashes->set_first_value(5);
+    rice_hashes->set_num_entries(3);
+    rice_hashes->set_rice_parameter(28);
+    rice_hashes->set_encoded_data(
+        "\xbf\xa8\x3f\xfb\xf\xf\x5e\x27\xe6\xc3\x1d\xc6\x38");
+  }
+  v4_database_->ApplyUpdate(std::move(parsed_server_response),
+                            callback_db_updated_);
+
+  // The updates are decoded on the thread pool before they're posted to the
+  // task runner.
+  EXPECT_FALSE(task_runner_->HasPendingTask());
+  task_environment_.RunUntilIdle();
+  EXPECT_TRUE(task_runner_->HasPendingTask());
+  WaitForTasksOnTaskRunner();
+
+  VerifyExpectedStoresState(true);
+
+  // Wait for the old stores to get destroyed on task runner.
+  WaitForTasksOnTaskRunner();
+}
+
 // Test to ensure no state updates leads to no store updates.
 TEST_F(V4DatabaseTest, TestApplyUpdateWithNoNewState) {
   RegisterFactory();
@@ -2,9 +2,14 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <inttypes.h>
+#include <string.h>
+
 #include <algorithm>
+#include <array>
 #include <vector>
 
+#include "base/bits.h"
 #include "base/check_op.h"
 #include "base/notreached.h"
 #include "base/numerics/safe_math.h"
@@ -12,12 +17,6 @@
 #include "build/build_config.h"
 #include "components/safe_browsing/core/browser/db/v4_rice.h"
 
-#if defined(OS_WIN)
-#include <winsock2.h>
-#elif defined(OS_POSIX) || defined(OS_FUCHSIA)
-#include <arpa/inet.h>
-#endif
-
 using ::google::protobuf::int32;
 using ::google::protobuf::int64;
 using ::google::protobuf::RepeatedField;
@@ -33,6 +32,63 @@ namespace {
 const int kBitsPerByte = 8;
 const unsigned int kMaxBitIndex = kBitsPerByte * sizeof(uint32_t);
 
+// The number of buckets of each radix sort pass of DecodePrefixes(), which
+// sorts by one byte of the decoded values.
+constexpr size_t kNumRadixBuckets = 1 << kBitsPerByte;
+
+// The number of radix sort passes of DecodePrefixes().
+constexpr size_t kNumRadixPasses = 3;
+
+using RadixHistogram = std::array<size_t, kNumRadixBuckets>;
+
+// Returns the byte of |value| which radix sort pass |pass| sorts by: the third
+// byte for the first pass, and the first one for the last pass.
+size_t GetRadixBucket(uint32_t value, size_t pass) {
+  return (value >> ((kNumRadixPasses - 1 - pass) * kBitsPerByte)) &
+         (kNumRadixBuckets - 1);
+}
+
+// Reads the |index|th value of the uint32_t values at |data|, which needn't be
+// aligned.
+uint32_t LoadValue(const char* data, size_t index) {
+  uint32_t value;
+  memcpy(&value, data + index * sizeof(value), sizeof(value));
+  return value;
+}
+
+// Writes |value| as the |index|th of the uint32_t values at |data|, which
+// needn't be aligned.
+void StoreValue(char* data, size_t index, uint32_t value) {
+  memcpy(data + index * sizeof(value), &value, sizeof(value));
+}
+
+// Stably sorts the |num_values| values returned by |load| for the indexes up to
+// |num_values| by their byte for radix sort pass |pass|, given the number of
+// values in each bucket in |histogram|, by calling |store| with each value and
+// its index in the sorted order.
+template <typename LoadFunction, typename StoreFunction>
+void RadixSortPass(size_t num_values,
+                   size_t pass,
+                   const RadixHistogram& histogram,
+                   LoadFunction load,
+                   StoreFunction store) {
+  RadixHistogram offsets;
+  size_t offset = 0;
+  for (size_t bucket = 0; bucket < kNumRadixBuckets; ++bucket) {
+    offsets[bucket] = offset;
+    offset += histogram[bucket];
+  }
+  for (size_t index = 0; index < num_values; ++index) {
+    uint32_t value = load(index);
+    store(offsets[GetRadixBucket(value, pass)]++, value);
+  }
+}
+
+// Returns |bits| without its |count| least significant bits.
+uint64_t DropBits(uint64_t bits, unsigned int count) {
+  return count < 64 ? bits >> count : 0;
+}
+
 }  // namespace
 
 // static
@@ -110,15 +166,51 @@ V4DecodeResult V4RiceDecoder::DecodePrefixes(const int64 first_value,
                                              std::vector<uint32_t>* out) {
   DCHECK(out);
 
+  std::string prefixes;
+  V4DecodeResult result = DecodePrefixes(first_value, rice_parameter,
+                                         num_entries, encoded_data, &prefixes);
+  if (result != DECODE_SUCCESS) {
+    return result;
+  }
+
+  out->resize(prefixes.size() / sizeof(uint32_t));
+  memcpy(out->data(), prefixes.data(), prefixes.size());
+  return DECODE_SUCCESS;
+}
+
+// static
+V4DecodeResult V4RiceDecoder::DecodePrefixes(const int64 first_value,
+                                             const int32 rice_parameter,
+                                             const int32 num_entries,
+                                             const std::string& encoded_data,
+                                             std::string* out) {
+  DCHECK(out);
+
   V4DecodeResult result =
       ValidateInput(rice_parameter, num_entries, encoded_data);
   if (result != DECODE_SUCCESS) {
     return result;
   }
-  out->reserve((num_entries + 1));
+
+  // Each hash prefix is the little-endian bytes of a decoded value, so the hash
+  // prefixes are sorted by the decoded values with their bytes flipped. The
+  // decoded values increase, so they are sorted by their last byte already,
+  // and a stable radix sort by each of the three others, from the third to the
+  // first, sorts them as hash prefixes. The buckets of each pass are counted
+  // while decoding. The passes go back and forth between |values| and |out|,
+  // so |values| is the only scratch buffer.
+  std::vector<uint32_t> values;
+  values.reserve(num_entries + 1);
+  std::array<RadixHistogram, kNumRadixPasses> histograms = {};
+  auto add_value = [&values, &histograms](uint32_t value) {
+    values.push_back(value);
+    for (size_t pass = 0; pass < kNumRadixPasses; ++pass) {
+      ++histograms[pass][GetRadixBucket(value, pass)];
+    }
+  };
 
   base::CheckedNumeric<uint32_t> last_value(first_value);
-  out->push_back(htonl(last_value.ValueOrDie()));
+  add_value(last_value.ValueOrDie());
 
   if (num_entries > 0) {
     V4RiceDecoder decoder(rice_parameter, num_entries, encoded_data);
@@ -135,38 +227,45 @@ V4DecodeResult V4RiceDecoder::DecodePrefixes(const int64 first_value,
         return DECODED_INTEGER_OVERFLOW_FAILURE;
       }
 
-      // This flipping is done so that the decoded uint32 is interpreted
-      // correcly as a string of 4 bytes.
-      out->push_back(htonl(last_value.ValueOrDie()));
+      add_value(last_value.ValueOrDie());
     }
   }
 
-  // Flipping the bytes, as done above, destroys the sort order. Sort the
-  // values back.
-  std::sort(out->begin(), out->end());
-
-  // This flipping is done so that when the vector is interpreted as a string,
-  // the bytes are in the correct order.
-  for (size_t i = 0; i < out->size(); i++) {
-    (*out)[i] = ntohl((*out)[i]);
-  }
+  const size_t num_values = values.size();
+  out->resize(num_values * sizeof(uint32_t));
+  char* prefixes = &(*out)[0];
+  auto load_from_values = [&values](size_t index) { return values[index]; };
+  auto store_to_values = [&values](size_t index, uint32_t value) {
+    values[index] = value;
+  };
+  auto load_from_prefixes = [prefixes](size_t index) {
+    return LoadValue(prefixes, index);
+  };
+  auto store_to_prefixes = [prefixes](size_t index, uint32_t value) {
+    StoreValue(prefixes, index, value);
+  };
+  RadixSortPass(num_values, 0, histograms[0], load_from_values,
+                store_to_prefixes);
+  RadixSortPass(num_values, 1, histograms[1], load_from_prefixes,
+                store_to_values);
+  RadixSortPass(num_values, 2, histograms[2], load_from_values,
+                store_to_prefixes);
 
   return DECODE_SUCCESS;
 }
 
 V4RiceDecoder::V4RiceDecoder(const int rice_parameter,
                              const int num_entries,
-                             const std::string& encoded_data)
+                             base::StringPiece encoded_data)
     : rice_parameter_(rice_parameter),
       num_entries_(num_entries),
       data_(encoded_data),
-      current_word_(0) {
+      data_byte_index_(0),
+      bits_(0),
+      num_bits_(0) {
   DCHECK_LE(0, num_entries_);
   DCHECK_LE(2u, rice_parameter_);
   DCHECK_GE(28u, rice_parameter_);
-
-  data_byte_index_ = 0;
-  current_word_bit_index_ = kMaxBitIndex;
 }
 
 V4RiceDecoder::~V4RiceDecoder() {}
@@ -180,18 +279,30 @@ V4DecodeResult V4RiceDecoder::GetNextValue(uint32_t* value) {
     return DECODE_NO_MORE_ENTRIES_FAILURE;
   }
 
-  V4DecodeResult result;
+  // The quotient is unary-coded, as a run of 1 bits ended by a 0 bit. Count
+  // the 1 bits of |bits_| at once instead of reading them one by one.
   uint32_t q = 0;
-  uint32_t bit;
-  do {
-    result = GetNextBits(1, &bit);
-    if (result != DECODE_SUCCESS) {
-      return result;
+  while (true) {
+    if (num_bits_ == 0 && !FillBits()) {
+      return DECODE_RAN_OUT_OF_BITS_FAILURE;
+    }
+
+    // The bits above |num_bits_| are zero, so the run is at most |num_bits_|
+    // long.
+    const unsigned int run = base::bits::CountTrailingZeroBits(~bits_);
+    if (run < num_bits_) {
+      q += run;
+      bits_ = DropBits(bits_, run + 1);
+      num_bits_ -= run + 1;
+      break;
     }
-    q += bit;
-  } while (bit);
+    q += num_bits_;
+    bits_ = 0;
+    num_bits_ = 0;
+  }
+
   uint32_t r = 0;
-  result = GetNextBits(rice_parameter_, &r);
+  V4DecodeResult result = GetNextBits(rice_parameter_, &r);
   if (result != DECODE_SUCCESS) {
     return result;
   }
@@ -206,27 +317,23 @@ V4DecodeResult V4RiceDecoder::GetNextWord(uint32_t* word) {
     return DECODE_RAN_OUT_OF_BITS_FAILURE;
   }
 
-  const size_t mask = 0xFF;
-  *word = (data_[data_byte_index_] & mask);
-  data_byte_index_++;
-  current_word_bit_index_ = 0;
-
-  if (data_byte_index_ < data_.size()) {
-    *word |= ((data_[data_byte_index_] & mask) << 8);
-    data_byte_index_++;
-
-    if (data_byte_index_ < data_.size()) {
-      *word |= ((data_[data_byte_index_] & mask) << 16);
-      data_byte_index_++;
+  const size_t num_bytes =
+      std::min(sizeof(*word), data_.size() - data_byte_index_);
+  *word = 0;
+  memcpy(word, data_.data() + data_byte_index_, num_bytes);
+  data_byte_index_ += num_bytes;
+  return DECODE_SUCCESS;
+}
 
-      if (data_byte_index_ < data_.size()) {
-        *word |= ((data_[data_byte_index_] & mask) << 24);
-        data_byte_index_++;
-      }
-    }
+bool V4RiceDecoder::FillBits() {
+  bool filled = false;
+  uint32_t word;
+  while (num_bits_ <= kMaxBitIndex && GetNextWord(&word) == DECODE_SUCCESS) {
+    bits_ |= static_cast<uint64_t>(word) << num_bits_;
+    num_bits_ += kMaxBitIndex;
+    filled = true;
   }
-
-  return DECODE_SUCCESS;
+  return filled;
 }
 
 V4DecodeResult V4RiceDecoder::GetNextBits(unsigned int num_requested_bits,
@@ -236,57 +343,31 @@ V4DecodeResult V4RiceDecoder::GetNextBits(unsigned int num_requested_bits,
     return DECODE_REQUESTED_TOO_MANY_BITS_FAILURE;
   }
 
-  if (current_word_bit_index_ == kMaxBitIndex) {
-    V4DecodeResult result = GetNextWord(&current_word_);
-    if (result != DECODE_SUCCESS) {
-      return result;
+  if (num_bits_ < num_requested_bits) {
+    FillBits();
+    if (num_bits_ < num_requested_bits) {
+      return DECODE_RAN_OUT_OF_BITS_FAILURE;
     }
   }
 
-  unsigned int num_bits_left_in_current_word =
-      kMaxBitIndex - current_word_bit_index_;
-  if (num_bits_left_in_current_word >= num_requested_bits) {
-    // All the bits that we need are in |current_word_|.
-    *x = GetBitsFromCurrentWord(num_requested_bits);
-  } else {
-    // |current_word_| contains fewer bits than we need so read the remaining
-    // bits from |current_word_| into |lower|, and then call GetNextBits on the
-    // remaining number of bits, which will read in a new word into
-    // |current_word_|.
-    uint32_t lower = GetBitsFromCurrentWord(num_bits_left_in_current_word);
-
-    unsigned int num_bits_from_next_word =
-        num_requested_bits - num_bits_left_in_current_word;
-    uint32_t upper;
-    V4DecodeResult result = GetNextBits(num_bits_from_next_word, &upper);
-    if (result != DECODE_SUCCESS) {
-      return result;
-    }
-    *x = (upper << num_bits_left_in_current_word) | lower;
-  }
+  const uint64_t mask = (uint64_t{1} << num_requested_bits) - 1;
+  *x = static_cast<uint32_t>(bits_ & mask);
+  bits_ = DropBits(bits_, num_requested_bits);
+  num_bits_ -= num_requested_bits;
   return DECODE_SUCCESS;
 }
 
-uint32_t V4RiceDecoder::GetBitsFromCurrentWord(
-    unsigned int num_requested_bits) {
-  uint32_t mask = 0xFFFFFFFF >> (kMaxBitIndex - num_requested_bits);
-  uint32_t x = current_word_ & mask;
-  current_word_ = current_word_ >> num_requested_bits;
-  current_word_bit_index_ += num_requested_bits;
-  return x;
-}
-
 std::string V4RiceDecoder::DebugString() const {
   // Calculates the total number of bits that we have read from the buffer,
-  // excluding those that have been read into current_word_ but not yet
-  // consumed byt GetNextBits().
-  unsigned bits_read = (data_byte_index_ - sizeof(uint32_t)) * kBitsPerByte +
-                       current_word_bit_index_;
+  // including the padding of the last word, and excluding those that have been
+  // read into bits_ but not yet consumed.
+  size_t bits_read =
+      base::bits::AlignUp(data_byte_index_, sizeof(uint32_t)) * kBitsPerByte -
+      num_bits_;
   return base::StringPrintf(
-      "bits_read: %x; current_word_: %x; data_byte_index_; %x, "
-      "current_word_bit_index_: %x; rice_parameter_: %x",
-      bits_read, current_word_, data_byte_index_, current_word_bit_index_,
-      rice_parameter_);
+      "bits_read: %zx; bits_: %" PRIx64
+      "; data_byte_index_: %zx; num_bits_: %x; rice_parameter_: %x",
+      bits_read, bits_, data_byte_index_, num_bits_, rice_parameter_);
 }
 
 std::ostream& operator<<(std::ostream& os, const V4RiceDecoder& rice_decoder) {
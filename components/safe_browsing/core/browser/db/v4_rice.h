@@ -8,10 +8,13 @@
 #ifndef COMPONENTS_SAFE_BROWSING_CORE_BROWSER_DB_V4_RICE_H_
 #define COMPONENTS_SAFE_BROWSING_CORE_BROWSER_DB_V4_RICE_H_
 
+#include <stdint.h>
+
 #include <ostream>
 #include <string>
 #include <vector>
 #include "base/gtest_prod_util.h"
+#include "base/strings/string_piece.h"
 #include "third_party/protobuf/src/google/protobuf/repeated_field.h"
 
 namespace safe_browsing {
@@ -74,15 +77,12 @@ class V4RiceDecoder {
   // 4-byte hash prefixes, not as a vector of uint32_t values.
   // This method does the following:
   // 1. Rice-decode the |encoded_data| as a list of uint32_t values.
-  // 2. Flip the endianness (on little-endian machines) of each of these
-  //    values. This is done because when a hash prefix is represented as a
-  //    uint32_t, the bytes get reordered. This generates the hash prefix that
-  //    the server would have sent in the absence of Rice-encoding.
-  // 3. Sort the resulting list of uint32_t values.
-  // 4. Flip the endianness once again since the uint32_t are expected to be
+  // 2. Sort these values by their bytes in little-endian order, which is the
+  //    order of the hash prefixes the server would have sent in the absence of
+  //    Rice-encoding.
+  // 3. Store the little-endian bytes of each value, so that the uint32_t are
   //    consumed as a concatenated list of 4-byte hash prefixes, when merging
-  //    the
-  //    update with the existing state.
+  //    the update with the existing state.
   static V4DecodeResult DecodePrefixes(
       const ::google::protobuf::int64 first_value,
       const ::google::protobuf::int32 rice_parameter,
@@ -90,6 +90,17 @@ class V4RiceDecoder {
       const std::string& encoded_data,
       std::vector<uint32_t>* out);
 
+  // Same as the method above, but stores the sorted hash prefixes in |out| as
+  // a string, ready to be merged into a store without being copied. The
+  // decoded values are bucketed while they are decoded, and then radix sorted,
+  // instead of being flipped and sorted with comparisons.
+  static V4DecodeResult DecodePrefixes(
+      const ::google::protobuf::int64 first_value,
+      const ::google::protobuf::int32 rice_parameter,
+      const ::google::protobuf::int32 num_entries,
+      const std::string& encoded_data,
+      std::string* out);
+
   virtual ~V4RiceDecoder();
 
   std::string DebugString() const;
@@ -112,7 +123,7 @@ class V4RiceDecoder {
   // |encoded_data| is the Rice-encoded string to decode.
   V4RiceDecoder(const ::google::protobuf::int32 rice_parameter,
                 const ::google::protobuf::int32 num_entries,
-                const std::string& encoded_data);
+                base::StringPiece encoded_data);
 
   // Returns true until |num_entries| entries have been decoded.
   bool HasAnotherValue() const;
@@ -121,16 +132,17 @@ class V4RiceDecoder {
   // |encoded_data|.
   V4DecodeResult GetNextValue(uint32_t* value);
 
-  // Reads in up to 32 bits from |encoded_data| into |word|, from which
-  // subsequent GetNextBits() calls read bits.
+  // Reads in up to 32 bits from |encoded_data| into |word|. The last word is
+  // padded with zero bits.
   V4DecodeResult GetNextWord(uint32_t* word);
 
-  // Reads |num_requested_bits| into |x| from |current_word_| and advances it
-  // if needed by calling GetNextWord().
-  V4DecodeResult GetNextBits(unsigned int num_requested_bits, uint32_t* x);
+  // Appends words read with GetNextWord() to |bits_| until it holds more than
+  // 32 bits or there are no more words. Returns false if no word was left.
+  bool FillBits();
 
-  // Reads |num_requested_bits| from |current_word_|.
-  uint32_t GetBitsFromCurrentWord(unsigned int num_requested_bits);
+  // Reads |num_requested_bits| into |x| from |bits_| and refills it if needed
+  // by calling FillBits().
+  V4DecodeResult GetNextBits(unsigned int num_requested_bits, uint32_t* x);
 
   // The Rice parameter, which is the exponent of two for calculating 'M'. 'M'
   // is used as the base to calculate the quotient and remainder in the
@@ -140,21 +152,20 @@ class V4RiceDecoder {
   // The number of entries encoded in the data stream.
   ::google::protobuf::int32 num_entries_;
 
-  // The Rice-encoded string.
-  const std::string data_;
+  // The Rice-encoded string, which must outlive the decoder.
+  const base::StringPiece data_;
 
-  // Represents how many total bytes have we read from |data_| into
-  // |current_word_|.
-  unsigned int data_byte_index_;
+  // Represents how many total bytes have we read from |data_| into |bits_|.
+  size_t data_byte_index_;
 
-  // Represents the number of bits that we have read from |current_word_|. When
-  // this becomes 32, which is the size of |current_word_|, a new
-  // |current_word_| needs to be read from |data_|.
-  unsigned int current_word_bit_index_;
+  // The bits read from |data_| but not consumed yet, starting with the least
+  // significant one. All bit reading operations operate on |bits_|, which is
+  // refilled a word at a time, so that a whole unary-coded quotient can
+  // usually be consumed at once.
+  uint64_t bits_;
 
-  // The 32-bit value read from |data_|. All bit reading operations operate on
-  // |current_word_|.
-  uint32_t current_word_;
+  // The number of bits in |bits_|. The bits above them are zero.
+  unsigned int num_bits_;
 };
 
 std::ostream& operator<<(std::ostream& os, const V4RiceDecoder& rice_decoder);
@@ -0,0 +1,100 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "components/safe_browsing/core/browser/db/v4_rice.h"
+
+#include <stdint.h>
+
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "base/timer/elapsed_timer.h"
+#include "components/safe_browsing/core/browser/db/v4_test_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace safe_browsing {
+
+namespace {
+
+constexpr char kMetricPrefixV4Rice[] = "V4Rice.";
+constexpr char kMetricDecodeTimeMs[] = "decode_time";
+constexpr char kMetricDecodedValuesPerSecond[] = "decoded_values_per_second";
+
+// Debug builds can be quite slow. Use a smaller number of values to test.
+#if defined(NDEBUG)
+constexpr size_t kNumValues = 2000000;
+#else
+constexpr size_t kNumValues = 20000;
+#endif
+
+// Returns |kNumValues| increasing values, spread evenly over most of |range|,
+// as the hash prefixes of a list or the removed indices of an update are.
+std::vector<uint32_t> GetValues(uint32_t range) {
+  std::vector<uint32_t> values = {0};
+  const uint32_t max_offset = range / kNumValues * 3 / 2;
+  for (size_t i = 1; i < kNumValues; ++i)
+    values.push_back(values.back() + (i * 2654435761u) % max_offset);
+  return values;
+}
+
+// Returns the Rice parameter which the server would use for |values|, which is
+// about the base 2 logarithm of their average offset.
+unsigned int GetRiceParameter(const std::vector<uint32_t>& values) {
+  unsigned int rice_parameter = 2;
+  while ((2u << rice_parameter) < (values.back() - values.front()) /
+                                      (values.size() - 1)) {
+    ++rice_parameter;
+  }
+  return rice_parameter;
+}
+
+void ReportDecodeTime(const std::string& story,
+                      const base::TimeDelta& elapsed) {
+  perf_test::PerfResultReporter reporter(kMetricPrefixV4Rice, story);
+  reporter.RegisterImportantMetric(kMetricDecodeTimeMs, "ms");
+  reporter.RegisterImportantMetric(kMetricDecodedValuesPerSecond, "runs/s");
+  reporter.AddResult(kMetricDecodeTimeMs, elapsed.InMillisecondsF());
+  reporter.AddResult(kMetricDecodedValuesPerSecond,
+                     kNumValues / elapsed.InSecondsF());
+}
+
+}  // namespace
+
+// Measures decoding the hash prefixes of a full update of a large list.
+TEST(V4RicePerftest, DecodePrefixes) {
+  const std::vector<uint32_t> values =
+      GetValues(std::numeric_limits<uint32_t>::max());
+  const unsigned int rice_parameter = GetRiceParameter(values);
+  const std::string encoded_data = GetRiceEncodedData(values, rice_parameter);
+
+  std::string prefixes;
+  base::ElapsedTimer timer;
+  EXPECT_EQ(DECODE_SUCCESS,
+            V4RiceDecoder::DecodePrefixes(values[0], rice_parameter,
+                                          kNumValues - 1, encoded_data,
+                                          &prefixes));
+  ReportDecodeTime("Prefixes", timer.Elapsed());
+  EXPECT_EQ(kNumValues * sizeof(uint32_t), prefixes.size());
+}
+
+// Measures decoding the removed indices of a partial update which removes a
+// large part of a list.
+TEST(V4RicePerftest, DecodeIntegers) {
+  const std::vector<uint32_t> values = GetValues(kNumValues * 8);
+  const unsigned int rice_parameter = GetRiceParameter(values);
+  const std::string encoded_data = GetRiceEncodedData(values, rice_parameter);
+
+  google::protobuf::RepeatedField<google::protobuf::int32> indices;
+  base::ElapsedTimer timer;
+  EXPECT_EQ(DECODE_SUCCESS,
+            V4RiceDecoder::DecodeIntegers(values[0], rice_parameter,
+                                          kNumValues - 1, encoded_data,
+                                          &indices));
+  ReportDecodeTime("Integers", timer.Elapsed());
+  EXPECT_EQ(static_cast<int>(kNumValues), indices.size());
+}
+
+}  // namespace safe_browsing
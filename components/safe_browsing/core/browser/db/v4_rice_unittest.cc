@@ -3,7 +3,13 @@
 // found in the LICENSE file.
 
 #include "components/safe_browsing/core/browser/db/v4_rice.h"
+
+#include <string.h>
+
+#include <algorithm>
+
 #include "base/logging.h"
+#include "components/safe_browsing/core/browser/db/v4_test_util.h"
 #include "testing/platform_test.h"
 
 using ::google::protobuf::int32;
@@ -263,6 +269,85 @@ TEST_F(V4RiceTest, TestDecoderPrefixesWithMultipleValues) {
   }
 }
 
+TEST_F(V4RiceTest, TestDecoderPrefixesAsStringWithMultipleValues) {
+  std::string out;
+  EXPECT_EQ(DECODE_SUCCESS,
+            V4RiceDecoder::DecodePrefixes(
+                5, 28, 3, "\xbf\xa8\x3f\xfb\xf\xf\x5e\x27\xe6\xc3\x1d\xc6\x38",
+                &out));
+  EXPECT_EQ(std::string("\x05\x00\x00\x00"
+                        "\x0c\x4c\x93\xad"
+                        "\x56\x7f\xf6\x6f"
+                        "\xce\x6f\x31\x81",
+                        16),
+            out);
+}
+
+// Decodes values encoded with runs of 1 bits for the quotients which are
+// longer than the bits the decoder reads at once, and data that isn't a
+// multiple of 4 bytes long.
+TEST_F(V4RiceTest, TestDecoderWithEncodedValues) {
+  for (unsigned int rice_parameter : {2u, 5u, 13u, 20u}) {
+    SCOPED_TRACE(rice_parameter);
+    std::vector<uint32_t> values = {7};
+    for (uint32_t i = 1; i < 2000; ++i) {
+      // Mostly quotients of less than 64, with a few much larger ones.
+      const uint32_t offset = i % 101 == 0
+                                  ? 150u << rice_parameter
+                                  : (i * 2654435761u) % (64u << rice_parameter);
+      if (values.back() > 0x7fffffffu - offset)
+        break;
+      values.push_back(values.back() + offset);
+    }
+    const std::string encoded_data =
+        GetRiceEncodedData(values, rice_parameter);
+    const int32 num_entries = static_cast<int32>(values.size() - 1);
+
+    RepeatedField<int32> integers;
+    EXPECT_EQ(DECODE_SUCCESS,
+              V4RiceDecoder::DecodeIntegers(values[0], rice_parameter,
+                                            num_entries, encoded_data,
+                                            &integers));
+    ASSERT_EQ(static_cast<int>(values.size()), integers.size());
+    for (size_t i = 0; i < values.size(); ++i)
+      EXPECT_EQ(values[i], static_cast<uint32_t>(integers.Get(i)));
+
+    // The hash prefixes are the little-endian bytes of the values, sorted.
+    std::vector<std::string> expected_prefixes;
+    for (uint32_t value : values) {
+      std::string prefix(sizeof(value), 0);
+      memcpy(&prefix[0], &value, sizeof(value));
+      expected_prefixes.push_back(prefix);
+    }
+    std::sort(expected_prefixes.begin(), expected_prefixes.end());
+    std::string expected;
+    for (const std::string& prefix : expected_prefixes)
+      expected += prefix;
+
+    std::string prefixes;
+    EXPECT_EQ(DECODE_SUCCESS,
+              V4RiceDecoder::DecodePrefixes(values[0], rice_parameter,
+                                            num_entries, encoded_data,
+                                            &prefixes));
+    EXPECT_EQ(expected, prefixes);
+
+    std::vector<uint32_t> prefixes_vector;
+    EXPECT_EQ(DECODE_SUCCESS,
+              V4RiceDecoder::DecodePrefixes(values[0], rice_parameter,
+                                            num_entries, encoded_data,
+                                            &prefixes_vector));
+    ASSERT_EQ(expected.size(), prefixes_vector.size() * sizeof(uint32_t));
+    EXPECT_EQ(0, memcmp(expected.data(), prefixes_vector.data(),
+                        expected.size()));
+
+    // Truncating the data makes the decoding fail.
+    EXPECT_EQ(DECODE_RAN_OUT_OF_BITS_FAILURE,
+              V4RiceDecoder::DecodePrefixes(
+                  values[0], rice_parameter, num_entries,
+                  encoded_data.substr(0, encoded_data.size() / 2), &prefixes));
+  }
+}
+
 #if defined(NDEBUG) && !defined(DCHECK_ALWAYS_ON)
 // This test hits a NOTREACHED so it is a release mode only test.
 TEST_F(V4RiceTest, TestDecoderPrefixesWithOverflowValues) {
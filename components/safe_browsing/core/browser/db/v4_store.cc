@@ -10,10 +10,13 @@
 #include "base/base64.h"
 #include "base/bind.h"
 #include "base/cxx17_backports.h"
+#include "base/files/file.h"
 #include "base/files/file_util.h"
+#include "base/files/memory_mapped_file.h"
 #include "base/logging.h"
 #include "base/metrics/histogram_functions.h"
 #include "base/metrics/histogram_macros.h"
+#include "base/numerics/safe_conversions.h"
 #include "base/strings/string_piece.h"
 #include "base/strings/stringprintf.h"
 #include "base/timer/elapsed_timer.h"
@@ -68,6 +71,11 @@ const int32_t ADDITIONS_HASHES_COUNT_FULL_UPDATE_MAX = 5000000;
 // The maximum size of removals hashes in a single update response.
 const int32_t REMOVALS_HASHES_COUNT_MAX = 10000;
 
+// Lists with fewer hash prefixes are binary searched instead of indexed. The
+// table of a HashPrefixIndex is 256 KB, as large as such a list of 4 byte hash
+// prefixes, and a binary search over a smaller list mostly hits the cache.
+const size_t kMinIndexedHashPrefixes = 1 << 16;
+
 void RecordEnumWithAndWithoutSuffix(const std::string& metric,
                                     int32_t value,
                                     int32_t maximum,
@@ -176,6 +184,177 @@ const base::FilePath TemporaryFileForFilename(const base::FilePath& filename) {
   return base::FilePath(filename.value() + FILE_PATH_LITERAL("_new"));
 }
 
+// Returns APPLY_UPDATE_SUCCESS if |raw_hashes_length| bytes of raw hashes are
+// a valid list of hash prefixes of |prefix_size|.
+ApplyUpdateResult CheckUnlumpedHashes(PrefixSize prefix_size,
+                                      size_t raw_hashes_length) {
+  if (prefix_size < kMinHashPrefixLength) {
+    NOTREACHED();
+    return PREFIX_SIZE_TOO_SMALL_FAILURE;
+  }
+  if (prefix_size > kMaxHashPrefixLength) {
+    NOTREACHED();
+    return PREFIX_SIZE_TOO_LARGE_FAILURE;
+  }
+  if (raw_hashes_length % prefix_size != 0) {
+    return ADDITIONS_SIZE_UNEXPECTED_FAILURE;
+  }
+  return APPLY_UPDATE_SUCCESS;
+}
+
+// Replaces the Rice-encoded hash prefixes of |addition| with the raw hash
+// prefixes they decode to. |addition| is left as it is if they fail to decode.
+V4DecodeResult DecodeRiceHashes(ThreatEntrySet* addition) {
+  DCHECK_EQ(RICE, addition->compression_type());
+  DCHECK(addition->has_rice_hashes());
+
+  const RiceDeltaEncoding& rice_hashes = addition->rice_hashes();
+  HashPrefixes raw_hashes;
+  V4DecodeResult decode_result = V4RiceDecoder::DecodePrefixes(
+      rice_hashes.first_value(), rice_hashes.rice_parameter(),
+      rice_hashes.num_entries(), rice_hashes.encoded_data(), &raw_hashes);
+  if (decode_result != DECODE_SUCCESS) {
+    return decode_result;
+  }
+
+  // Rice-Golomb encoding is used to send compressed compressed 4-byte hash
+  // prefixes. Hash prefixes longer than 4 bytes will not be compressed, and
+  // will be served in raw format instead.
+  // Source: https://developers.google.com/safe-browsing/v4/compression
+  const PrefixSize kPrefixSize = 4;
+  addition->clear_rice_hashes();
+  addition->set_compression_type(RAW);
+  RawHashes* raw = addition->mutable_raw_hashes();
+  raw->set_prefix_size(kPrefixSize);
+  *raw->mutable_raw_hashes() = std::move(raw_hashes);
+  return DECODE_SUCCESS;
+}
+
+// Replaces the Rice-encoded indices of |removal| with the raw indices they
+// decode to. |removal| is left as it is if they fail to decode.
+V4DecodeResult DecodeRiceIndices(ThreatEntrySet* removal) {
+  DCHECK_EQ(RICE, removal->compression_type());
+  DCHECK(removal->has_rice_indices());
+
+  const RiceDeltaEncoding& rice_indices = removal->rice_indices();
+  ::google::protobuf::RepeatedField<::google::protobuf::int32> indices;
+  V4DecodeResult decode_result = V4RiceDecoder::DecodeIntegers(
+      rice_indices.first_value(), rice_indices.rice_parameter(),
+      rice_indices.num_entries(), rice_indices.encoded_data(), &indices);
+  if (decode_result != DECODE_SUCCESS) {
+    return decode_result;
+  }
+
+  removal->clear_rice_indices();
+  removal->set_compression_type(RAW);
+  removal->mutable_raw_indices()->mutable_indices()->Swap(&indices);
+  return DECODE_SUCCESS;
+}
+
+// Returns true if all the non-empty lists of |old_prefixes_map| and
+// |additions_map| have hash prefixes of the same size, and sets |prefix_size|
+// to it. This is the case for most updates, since only 4 byte hash prefixes are
+// Rice-encoded.
+bool GetOnlyPrefixSize(const HashPrefixMap& old_prefixes_map,
+                       const HashPrefixMap& additions_map,
+                       PrefixSize* prefix_size) {
+  bool has_prefix_size = false;
+  for (const HashPrefixMap* map : {&old_prefixes_map, &additions_map}) {
+    for (const auto& pair : *map) {
+      if (pair.second.empty())
+        continue;
+      if (has_prefix_size && *prefix_size != pair.first)
+        return false;
+      has_prefix_size = true;
+      *prefix_size = pair.first;
+    }
+  }
+  return has_prefix_size;
+}
+
+// Merges the sorted lists |old_prefixes| and |additions| of hash prefixes of
+// |prefix_size|, except the old hash prefixes at the indices in
+// |raw_removals|, which may be null, and appends them to |merged| and to
+// |checksum_ctx| if it's not null. Rather than one hash prefix at a time, this
+// copies each run of old hash prefixes up to the next addition or removal at
+// once, so merging a partial update into a large list costs about a copy of
+// the list, plus a binary search per addition.
+ApplyUpdateResult MergeSortedPrefixes(
+    PrefixSize prefix_size,
+    base::StringPiece old_prefixes,
+    base::StringPiece additions,
+    const ::google::protobuf::RepeatedField<::google::protobuf::int32>*
+        raw_removals,
+    crypto::SecureHash* checksum_ctx,
+    HashPrefixes* merged) {
+  auto append = [&](base::StringPiece prefixes) {
+    merged->append(prefixes.data(), prefixes.size());
+    if (checksum_ctx)
+      checksum_ctx->Update(prefixes.data(), prefixes.size());
+  };
+
+  const size_t num_old = old_prefixes.size() / prefix_size;
+  const size_t num_additions = additions.size() / prefix_size;
+  const int* removals_iter = raw_removals ? raw_removals->begin() : nullptr;
+  const int* removals_end = raw_removals ? raw_removals->end() : nullptr;
+  size_t old_index = 0;
+  size_t additions_index = 0;
+  while (additions_index < num_additions || old_index < num_old) {
+    if (old_index == num_old) {
+      append(additions.substr(additions_index * prefix_size));
+      break;
+    }
+
+    // The old hash prefixes before |run_end| are smaller than the next
+    // addition, and aren't removed.
+    base::StringPiece addition;
+    size_t run_end = num_old;
+    if (additions_index < num_additions) {
+      addition = additions.substr(additions_index * prefix_size, prefix_size);
+      run_end = std::lower_bound(
+                    PrefixIterator(old_prefixes, old_index, prefix_size),
+                    PrefixIterator(old_prefixes, num_old, prefix_size),
+                    addition) -
+                PrefixIterator(old_prefixes, 0, prefix_size);
+    }
+    // Removals which are out of order or out of range are never reached, so
+    // that the merge fails once it's done.
+    size_t next_removal = num_old;
+    if (removals_iter != removals_end && *removals_iter >= 0 &&
+        static_cast<size_t>(*removals_iter) >= old_index) {
+      next_removal = std::min(num_old, static_cast<size_t>(*removals_iter));
+      run_end = std::min(run_end, next_removal);
+    }
+    append(old_prefixes.substr(old_index * prefix_size,
+                               (run_end - old_index) * prefix_size));
+    old_index = run_end;
+
+    base::StringPiece old_prefix =
+        old_index < num_old
+            ? old_prefixes.substr(old_index * prefix_size, prefix_size)
+            : base::StringPiece();
+    // If the same hash prefix appears in the existing store and the additions
+    // list, something is clearly wrong. Discard the update.
+    if (!addition.empty() && old_prefix == addition)
+      return ADDITIONS_HAS_EXISTING_PREFIX_FAILURE;
+
+    if (!old_prefix.empty() && (addition.empty() || old_prefix < addition)) {
+      // The old hash prefix is removed.
+      DCHECK_EQ(next_removal, old_index);
+      ++old_index;
+      ++removals_iter;
+    } else if (!addition.empty()) {
+      append(addition);
+      ++additions_index;
+    }
+  }
+
+  if (removals_iter != removals_end) {
+    return REMOVALS_INDEX_TOO_LARGE_FAILURE;
+  }
+  return APPLY_UPDATE_SUCCESS;
+}
+
 }  // namespace
 
 using ::google::protobuf::int32;
@@ -239,6 +418,7 @@ void V4Store::Destroy(std::unique_ptr<V4Store> v4_store) {
 void V4Store::Reset() {
   expected_checksum_.clear();
   hash_prefix_map_.clear();
+  hash_prefix_indexes_.clear();
   state_ = "";
 }
 
@@ -292,28 +472,22 @@ ApplyUpdateResult V4Store::ProcessUpdate(
     const std::unique_ptr<ListUpdateResponse>& response,
     bool delay_checksum_check) {
   const RepeatedField<int32>* raw_removals = nullptr;
-  RepeatedField<int32> rice_removals;
   size_t removals_size = response->removals_size();
   DCHECK_LE(removals_size, 1u);
   if (removals_size == 1) {
-    const ThreatEntrySet& removal = response->removals().Get(0);
-    const CompressionType compression_type = removal.compression_type();
-    if (compression_type == RAW) {
-      raw_removals = &removal.raw_indices().indices();
-    } else if (compression_type == RICE) {
-      DCHECK(removal.has_rice_indices());
-
-      const RiceDeltaEncoding& rice_indices = removal.rice_indices();
-      V4DecodeResult decode_result = V4RiceDecoder::DecodeIntegers(
-          rice_indices.first_value(), rice_indices.rice_parameter(),
-          rice_indices.num_entries(), rice_indices.encoded_data(),
-          &rice_removals);
-
+    ThreatEntrySet* removal = response->mutable_removals(0);
+    // Unless DecodeUpdate() decoded them already.
+    if (removal->compression_type() == RICE) {
+      V4DecodeResult decode_result = DecodeRiceIndices(removal);
       RecordDecodeRemovalsResult(metric, decode_result, store_path_);
       if (decode_result != DECODE_SUCCESS) {
         return RICE_DECODING_FAILURE;
       }
-      raw_removals = &rice_removals;
+    }
+
+    const CompressionType compression_type = removal->compression_type();
+    if (compression_type == RAW) {
+      raw_removals = &removal->raw_indices().indices();
     } else {
       NOTREACHED() << "Unexpected compression_type type: " << compression_type;
       return UNEXPECTED_COMPRESSION_TYPE_REMOVALS_FAILURE;
@@ -325,7 +499,7 @@ ApplyUpdateResult V4Store::ProcessUpdate(
 
   HashPrefixMap hash_prefix_map;
   ApplyUpdateResult apply_update_result = UpdateHashPrefixMapFromAdditions(
-      metric, response->additions(), &hash_prefix_map);
+      metric, response->mutable_additions(), &hash_prefix_map);
   if (apply_update_result != APPLY_UPDATE_SUCCESS) {
     return apply_update_result;
   }
@@ -340,8 +514,9 @@ ApplyUpdateResult V4Store::ProcessUpdate(
     DCHECK(!raw_removals);
     // We delay the checksum check at startup to be able to load the DB
     // quickly. In this case, the |hash_prefix_map_old| should be empty, so just
-    // copy over the |hash_prefix_map|.
-    hash_prefix_map_ = hash_prefix_map;
+    // move over the |hash_prefix_map|.
+    hash_prefix_map_ = std::move(hash_prefix_map);
+    BuildHashPrefixIndexes();
 
     // Calculate the checksum asynchronously later and if it doesn't match,
     // reset the store.
@@ -358,6 +533,52 @@ ApplyUpdateResult V4Store::ProcessUpdate(
   return APPLY_UPDATE_SUCCESS;
 }
 
+// static
+bool V4Store::HasRiceEncodedData(const ListUpdateResponse& response) {
+  for (const ThreatEntrySet& addition : response.additions()) {
+    if (addition.compression_type() == RICE)
+      return true;
+  }
+  for (const ThreatEntrySet& removal : response.removals()) {
+    if (removal.compression_type() == RICE)
+      return true;
+  }
+  return false;
+}
+
+// static
+std::unique_ptr<ListUpdateResponse> V4Store::DecodeUpdate(
+    const base::FilePath& store_path,
+    std::unique_ptr<ListUpdateResponse> response) {
+  std::string metric;
+  if (response->response_type() == ListUpdateResponse::PARTIAL_UPDATE) {
+    metric = kProcessPartialUpdate;
+  } else if (response->response_type() == ListUpdateResponse::FULL_UPDATE) {
+    metric = kProcessFullUpdate;
+  } else {
+    // ApplyUpdate() rejects the response.
+    return response;
+  }
+
+  // Lists that fail to decode are left for ApplyUpdate() to fail on, and to
+  // record the failure.
+  for (ThreatEntrySet& addition : *response->mutable_additions()) {
+    if (addition.compression_type() == RICE &&
+        DecodeRiceHashes(&addition) == DECODE_SUCCESS) {
+      RecordDecodeAdditionsResult(metric, DECODE_SUCCESS, store_path);
+      RecordAdditionsHashesCount(
+          metric, addition.raw_hashes().raw_hashes().size(), store_path);
+    }
+  }
+  for (ThreatEntrySet& removal : *response->mutable_removals()) {
+    if (removal.compression_type() == RICE &&
+        DecodeRiceIndices(&removal) == DECODE_SUCCESS) {
+      RecordDecodeRemovalsResult(metric, DECODE_SUCCESS, store_path);
+    }
+  }
+  return response;
+}
+
 void V4Store::ApplyUpdate(
     std::unique_ptr<ListUpdateResponse> response,
     const scoped_refptr<base::SequencedTaskRunner>& callback_task_runner,
@@ -408,42 +629,34 @@ void V4Store::ApplyUpdate(
 
 ApplyUpdateResult V4Store::UpdateHashPrefixMapFromAdditions(
     const std::string& metric,
-    const RepeatedPtrField<ThreatEntrySet>& additions,
+    RepeatedPtrField<ThreatEntrySet>* additions,
     HashPrefixMap* additions_map) {
-  for (const auto& addition : additions) {
+  for (auto& addition : *additions) {
+    // Unless DecodeUpdate() decoded them already.
+    if (addition.compression_type() == RICE) {
+      V4DecodeResult decode_result = DecodeRiceHashes(&addition);
+      RecordDecodeAdditionsResult(metric, decode_result, store_path_);
+      if (decode_result != DECODE_SUCCESS) {
+        return RICE_DECODING_FAILURE;
+      }
+      RecordAdditionsHashesCount(metric,
+                                 addition.raw_hashes().raw_hashes().size(),
+                                 store_path_);
+    }
+
     ApplyUpdateResult apply_update_result = APPLY_UPDATE_SUCCESS;
     const CompressionType compression_type = addition.compression_type();
     if (compression_type == RAW) {
       DCHECK(addition.has_raw_hashes());
       DCHECK(addition.raw_hashes().has_raw_hashes());
 
-      apply_update_result =
-          AddUnlumpedHashes(addition.raw_hashes().prefix_size(),
-                            addition.raw_hashes().raw_hashes(), additions_map);
-    } else if (compression_type == RICE) {
-      DCHECK(addition.has_rice_hashes());
-
-      const RiceDeltaEncoding& rice_hashes = addition.rice_hashes();
-      std::vector<uint32_t> raw_hashes;
-      V4DecodeResult decode_result = V4RiceDecoder::DecodePrefixes(
-          rice_hashes.first_value(), rice_hashes.rice_parameter(),
-          rice_hashes.num_entries(), rice_hashes.encoded_data(), &raw_hashes);
-      RecordDecodeAdditionsResult(metric, decode_result, store_path_);
-      if (decode_result != DECODE_SUCCESS) {
-        return RICE_DECODING_FAILURE;
-      } else {
-        char* raw_hashes_start = reinterpret_cast<char*>(raw_hashes.data());
-        size_t raw_hashes_size = sizeof(uint32_t) * raw_hashes.size();
-        RecordAdditionsHashesCount(metric, raw_hashes_size, store_path_);
-
-        // Rice-Golomb encoding is used to send compressed compressed 4-byte
-        // hash prefixes. Hash prefixes longer than 4 bytes will not be
-        // compressed, and will be served in raw format instead.
-        // Source: https://developers.google.com/safe-browsing/v4/compression
-        const PrefixSize kPrefixSize = 4;
-        apply_update_result = AddUnlumpedHashes(kPrefixSize, raw_hashes_start,
-                                                raw_hashes_size, additions_map);
-      }
+      // The raw hashes of a full update, or of the store file read on startup,
+      // are the whole list, and decoded hash prefixes are only needed in the
+      // map, so move them rather than copy them.
+      apply_update_result = AddUnlumpedHashes(
+          addition.raw_hashes().prefix_size(),
+          std::move(*addition.mutable_raw_hashes()->mutable_raw_hashes()),
+          additions_map);
     } else {
       NOTREACHED() << "Unexpected compression_type type: " << compression_type;
       return UNEXPECTED_COMPRESSION_TYPE_ADDITIONS_FAILURE;
@@ -466,27 +679,30 @@ ApplyUpdateResult V4Store::AddUnlumpedHashes(PrefixSize prefix_size,
                            additions_map);
 }
 
+// static
+ApplyUpdateResult V4Store::AddUnlumpedHashes(PrefixSize prefix_size,
+                                             std::string&& raw_hashes,
+                                             HashPrefixMap* additions_map) {
+  ApplyUpdateResult result =
+      CheckUnlumpedHashes(prefix_size, raw_hashes.size());
+  if (result == APPLY_UPDATE_SUCCESS) {
+    (*additions_map)[prefix_size] = std::move(raw_hashes);
+  }
+  return result;
+}
+
 // static
 ApplyUpdateResult V4Store::AddUnlumpedHashes(PrefixSize prefix_size,
                                              const char* raw_hashes_begin,
                                              const size_t raw_hashes_length,
                                              HashPrefixMap* additions_map) {
-  if (prefix_size < kMinHashPrefixLength) {
-    NOTREACHED();
-    return PREFIX_SIZE_TOO_SMALL_FAILURE;
-  }
-  if (prefix_size > kMaxHashPrefixLength) {
-    NOTREACHED();
-    return PREFIX_SIZE_TOO_LARGE_FAILURE;
-  }
-  if (raw_hashes_length % prefix_size != 0) {
-    return ADDITIONS_SIZE_UNEXPECTED_FAILURE;
+  ApplyUpdateResult result =
+      CheckUnlumpedHashes(prefix_size, raw_hashes_length);
+  if (result == APPLY_UPDATE_SUCCESS) {
+    (*additions_map)[prefix_size] =
+        std::string(raw_hashes_begin, raw_hashes_begin + raw_hashes_length);
   }
-
-  // TODO(vakh): Figure out a way to avoid the following copy operation.
-  (*additions_map)[prefix_size] =
-      std::string(raw_hashes_begin, raw_hashes_begin + raw_hashes_length);
-  return APPLY_UPDATE_SUCCESS;
+  return result;
 }
 
 // static
@@ -552,10 +768,66 @@ ApplyUpdateResult V4Store::MergeUpdate(const HashPrefixMap& old_prefixes_map,
     return CHECKSUM_MISMATCH_FAILURE;
   }
 
+  // The indexes are only built again once the merge has succeeded, so that a
+  // failed merge leaves no index of the partially merged lists.
   hash_prefix_map_.clear();
+  hash_prefix_indexes_.clear();
   ReserveSpaceInPrefixMap(old_prefixes_map, &hash_prefix_map_);
   ReserveSpaceInPrefixMap(additions_map, &hash_prefix_map_);
 
+  std::unique_ptr<crypto::SecureHash> checksum_ctx(
+      crypto::SecureHash::Create(crypto::SecureHash::SHA256));
+
+  ApplyUpdateResult result;
+  PrefixSize prefix_size;
+  if (GetOnlyPrefixSize(old_prefixes_map, additions_map, &prefix_size)) {
+    auto old_prefixes = old_prefixes_map.find(prefix_size);
+    auto additions = additions_map.find(prefix_size);
+    result = MergeSortedPrefixes(
+        prefix_size,
+        old_prefixes != old_prefixes_map.end() ? old_prefixes->second
+                                               : base::StringPiece(),
+        additions != additions_map.end() ? additions->second
+                                         : base::StringPiece(),
+        raw_removals, calculate_checksum ? checksum_ctx.get() : nullptr,
+        &hash_prefix_map_[prefix_size]);
+  } else {
+    result = MergeHashPrefixMaps(
+        old_prefixes_map, additions_map, raw_removals,
+        calculate_checksum ? checksum_ctx.get() : nullptr);
+  }
+  if (result != APPLY_UPDATE_SUCCESS) {
+    return result;
+  }
+
+  if (calculate_checksum) {
+    char checksum[crypto::kSHA256Length];
+    checksum_ctx->Finish(checksum, sizeof(checksum));
+    for (size_t i = 0; i < crypto::kSHA256Length; i++) {
+      if (checksum[i] != expected_checksum[i]) {
+#if DCHECK_IS_ON()
+        std::string checksum_b64, expected_checksum_b64;
+        base::Base64Encode(base::StringPiece(checksum, base::size(checksum)),
+                           &checksum_b64);
+        base::Base64Encode(expected_checksum, &expected_checksum_b64);
+        DVLOG(1) << "Failure: Checksum mismatch: calculated: " << checksum_b64
+                 << "; expected: " << expected_checksum_b64
+                 << "; store: " << *this;
+#endif
+        return CHECKSUM_MISMATCH_FAILURE;
+      }
+    }
+  }
+
+  BuildHashPrefixIndexes();
+  return APPLY_UPDATE_SUCCESS;
+}
+
+ApplyUpdateResult V4Store::MergeHashPrefixMaps(
+    const HashPrefixMap& old_prefixes_map,
+    const HashPrefixMap& additions_map,
+    const RepeatedField<int32>* raw_removals,
+    crypto::SecureHash* checksum_ctx) {
   IteratorMap old_iterator_map;
   HashPrefix next_smallest_prefix_old;
   InitializeIteratorMap(old_prefixes_map, &old_iterator_map);
@@ -573,9 +845,6 @@ ApplyUpdateResult V4Store::MergeUpdate(const HashPrefixMap& old_prefixes_map,
   // At least one of the maps still has elements that need to be merged into the
   // new store.
 
-  std::unique_ptr<crypto::SecureHash> checksum_ctx(
-      crypto::SecureHash::Create(crypto::SecureHash::SHA256));
-
   // Keep track of the number of elements picked from the old map. This is used
   // to determine which elements to drop based on the raw_removals. Note that
   // picked is not the same as merged. A picked element isn't merged if its
@@ -610,7 +879,7 @@ ApplyUpdateResult V4Store::MergeUpdate(const HashPrefixMap& old_prefixes_map,
         // Append the smallest hash to the appropriate list.
         hash_prefix_map_[next_smallest_prefix_size] += next_smallest_prefix_old;
 
-        if (calculate_checksum) {
+        if (checksum_ctx) {
           checksum_ctx->Update(next_smallest_prefix_old.data(),
                                next_smallest_prefix_size);
         }
@@ -631,7 +900,7 @@ ApplyUpdateResult V4Store::MergeUpdate(const HashPrefixMap& old_prefixes_map,
       hash_prefix_map_[next_smallest_prefix_size] +=
           next_smallest_prefix_additions;
 
-      if (calculate_checksum) {
+      if (checksum_ctx) {
         checksum_ctx->Update(next_smallest_prefix_additions.data(),
                              next_smallest_prefix_size);
       }
@@ -652,25 +921,6 @@ ApplyUpdateResult V4Store::MergeUpdate(const HashPrefixMap& old_prefixes_map,
     return REMOVALS_INDEX_TOO_LARGE_FAILURE;
   }
 
-  if (calculate_checksum) {
-    char checksum[crypto::kSHA256Length];
-    checksum_ctx->Finish(checksum, sizeof(checksum));
-    for (size_t i = 0; i < crypto::kSHA256Length; i++) {
-      if (checksum[i] != expected_checksum[i]) {
-#if DCHECK_IS_ON()
-        std::string checksum_b64, expected_checksum_b64;
-        base::Base64Encode(base::StringPiece(checksum, base::size(checksum)),
-                           &checksum_b64);
-        base::Base64Encode(expected_checksum, &expected_checksum_b64);
-        DVLOG(1) << "Failure: Checksum mismatch: calculated: " << checksum_b64
-                 << "; expected: " << expected_checksum_b64
-                 << "; store: " << *this;
-#endif
-        return CHECKSUM_MISMATCH_FAILURE;
-      }
-    }
-  }
-
   return APPLY_UPDATE_SUCCESS;
 }
 
@@ -680,22 +930,34 @@ StoreReadResult V4Store::ReadFromDisk() {
   V4StoreFileFormat file_format;
   int64_t file_size;
   {
-    // A temporary scope to make sure that |contents| get destroyed as soon as
-    // we are doing using it.
-    std::string contents;
-    if (!base::ReadFileToStringWithMaxSize(store_path_, &contents,
-                                           kMaxStoreSizeBytes)) {
+    // A temporary scope to make sure that the file gets unmapped as soon as
+    // we are done using it. The file is parsed in place rather than read into
+    // a buffer first, which would double the memory used while loading.
+    base::File file(store_path_,
+                    base::File::FLAG_OPEN | base::File::FLAG_READ);
+    if (!file.IsValid()) {
       return FILE_UNREADABLE_FAILURE;
     }
 
-    if (contents.empty()) {
+    file_size = file.GetLength();
+    if (file_size < 0 ||
+        static_cast<uint64_t>(file_size) > kMaxStoreSizeBytes) {
+      return FILE_UNREADABLE_FAILURE;
+    }
+
+    if (file_size == 0) {
       return FILE_EMPTY_FAILURE;
     }
 
-    if (!file_format.ParseFromString(contents)) {
+    base::MemoryMappedFile contents;
+    if (!contents.Initialize(std::move(file))) {
+      return FILE_UNREADABLE_FAILURE;
+    }
+
+    if (!file_format.ParseFromArray(
+            contents.data(), base::checked_cast<int>(contents.length()))) {
       return PROTO_PARSING_FAILURE;
     }
-    file_size = static_cast<int64_t>(contents.size());
   }
 
   if (file_format.magic_number() != kFileMagic) {
@@ -718,6 +980,7 @@ StoreReadResult V4Store::ReadFromDisk() {
   last_apply_update_result_ = apply_update_result;
   if (apply_update_result != APPLY_UPDATE_SUCCESS) {
     hash_prefix_map_.clear();
+    hash_prefix_indexes_.clear();
     return HASH_PREFIX_MAP_GENERATION_FAILURE;
   }
 
@@ -782,12 +1045,26 @@ HashPrefix V4Store::GetMatchingHashPrefix(base::StringPiece full_hash) {
   for (const auto& pair : hash_prefix_map_) {
     const PrefixSize& prefix_size = pair.first;
     base::StringPiece hash_prefix = full_hash.substr(0, prefix_size);
-    if (HashPrefixMatches(hash_prefix, pair.second, prefix_size))
+    const auto index = hash_prefix_indexes_.find(prefix_size);
+    if (index != hash_prefix_indexes_.end()
+            ? index->second.Contains(pair.second, hash_prefix)
+            : HashPrefixMatches(hash_prefix, pair.second, prefix_size)) {
       return std::string(hash_prefix);
+    }
   }
   return HashPrefix();
 }
 
+void V4Store::BuildHashPrefixIndexes() {
+  hash_prefix_indexes_.clear();
+  for (const auto& pair : hash_prefix_map_) {
+    if (pair.second.size() / pair.first >= kMinIndexedHashPrefixes) {
+      hash_prefix_indexes_.emplace(pair.first,
+                                   HashPrefixIndex(pair.second, pair.first));
+    }
+  }
+}
+
 bool V4Store::HashPrefixMatches(base::StringPiece prefix,
                                 const HashPrefixes& prefixes,
                                 const PrefixSize& size) {
@@ -15,9 +15,14 @@
 #include "base/gtest_prod_util.h"
 #include "base/memory/ref_counted.h"
 #include "base/task/sequenced_task_runner.h"
+#include "components/safe_browsing/core/browser/db/hash_prefix_index.h"
 #include "components/safe_browsing/core/browser/db/v4_protocol_manager_util.h"
 #include "components/safe_browsing/core/common/proto/webui.pb.h"
 
+namespace crypto {
+class SecureHash;
+}  // namespace crypto
+
 namespace safe_browsing {
 
 class V4Store;
@@ -199,6 +204,18 @@ class V4Store {
                    const scoped_refptr<base::SequencedTaskRunner>& runner,
                    UpdatedStoreReadyCallback callback);
 
+  // Returns true if |response| has Rice-encoded additions or removals.
+  static bool HasRiceEncodedData(const ListUpdateResponse& response);
+
+  // Replaces the Rice-encoded additions and removals of |response|, an update
+  // of the store at |store_path|, with the raw hash prefixes and indices they
+  // decode to, and returns it. Lists that fail to decode are left as they are.
+  // This doesn't use the store, so it can run on any sequence, which lets the
+  // updates of several stores decode in parallel before ApplyUpdate().
+  static std::unique_ptr<ListUpdateResponse> DecodeUpdate(
+      const base::FilePath& store_path,
+      std::unique_ptr<ListUpdateResponse> response);
+
   // Records (in kilobytes) and returns the size of the file on disk for this
   // store using |base_metric| as prefix and the filename as suffix.
   int64_t RecordAndReturnFileSize(const std::string& base_metric);
@@ -226,6 +243,12 @@ class V4Store {
       const std::string& base_metric);
 
  protected:
+  // Indexes the large lists of |hash_prefix_map_|, to speed up
+  // GetMatchingHashPrefix; the other lists are binary searched. Whatever
+  // changes |hash_prefix_map_| must call this, or clear
+  // |hash_prefix_indexes_|, since an index is trusted to match its list.
+  void BuildHashPrefixIndexes();
+
   HashPrefixMap hash_prefix_map_;
 
  private:
@@ -295,7 +318,11 @@ class V4Store {
   FRIEND_TEST_ALL_PREFIXES(V4StoreTest, TestChecksumErrorOnStartup);
   FRIEND_TEST_ALL_PREFIXES(V4StoreTest, WriteToDiskFails);
   FRIEND_TEST_ALL_PREFIXES(V4StoreTest, FullUpdateFailsChecksumSynchronously);
+  FRIEND_TEST_ALL_PREFIXES(V4StoreTest, TestMergeUpdatesWithLargeList);
+  FRIEND_TEST_ALL_PREFIXES(V4StoreTest, TestReadFromDiskIndexesLargeList);
   FRIEND_TEST_ALL_PREFIXES(V4StorePerftest, StressTest);
+  FRIEND_TEST_ALL_PREFIXES(V4StorePerftest, Lookup);
+  FRIEND_TEST_ALL_PREFIXES(V4StorePerftest, Merge);
 
   friend class V4StoreTest;
   friend class V4StoreFuzzer;
@@ -315,6 +342,12 @@ class V4Store {
                                              const std::string& raw_hashes,
                                              HashPrefixMap* additions_map);
 
+  // An overloaded version of AddUnlumpedHashes that moves |raw_hashes| into
+  // |additions_map| instead of copying them.
+  static ApplyUpdateResult AddUnlumpedHashes(PrefixSize prefix_size,
+                                             std::string&& raw_hashes,
+                                             HashPrefixMap* additions_map);
+
   // Get the next unmerged hash prefix in dictionary order from
   // |hash_prefix_map|. |iterator_map| is used to determine which hash prefixes
   // have been merged already. Returns true if there are any unmerged hash
@@ -360,6 +393,18 @@ class V4Store {
           raw_removals,
       const std::string& expected_checksum);
 
+  // Merges |old_hash_prefix_map| and |additions_map|, except the indices in
+  // |raw_removals|, into |hash_prefix_map_|, one hash prefix at a time in
+  // lexicographically sorted order, and adds them to |checksum_ctx| if it's
+  // not null. MergeUpdate uses this for updates with hash prefixes of several
+  // sizes.
+  ApplyUpdateResult MergeHashPrefixMaps(
+      const HashPrefixMap& old_hash_prefix_map,
+      const HashPrefixMap& additions_map,
+      const ::google::protobuf::RepeatedField<::google::protobuf::int32>*
+          raw_removals,
+      crypto::SecureHash* checksum_ctx);
+
   // Processes the FULL_UPDATE |response| from the server, and writes the
   // merged V4Store to disk. If processing the |response| succeeds, it returns
   // APPLY_UPDATE_SUCCESS. The UMA metrics for all interesting sub-operations
@@ -407,11 +452,12 @@ class V4Store {
   StoreReadResult ReadFromDisk();
 
   // Updates the |additions_map| with the additions received in the partial
-  // update from the server. The UMA metrics for all interesting sub-operations
-  // use the prefix |metric|.
+  // update from the server. The raw hashes are moved out of |additions|
+  // instead of being copied. The UMA metrics for all interesting
+  // sub-operations use the prefix |metric|.
   ApplyUpdateResult UpdateHashPrefixMapFromAdditions(
       const std::string& metric,
-      const ::google::protobuf::RepeatedPtrField<ThreatEntrySet>& additions,
+      ::google::protobuf::RepeatedPtrField<ThreatEntrySet>* additions,
       HashPrefixMap* additions_map);
 
   // Writes the hash_prefix_map_ to disk as a V4StoreFileFormat proto.
@@ -438,6 +484,9 @@ class V4Store {
   // Records the number of times we have looked up the store.
   size_t checks_attempted_ = 0;
 
+  // The indexes of the large lists of |hash_prefix_map_|, by size.
+  std::unordered_map<PrefixSize, HashPrefixIndex> hash_prefix_indexes_;
+
   // The state of the store as returned by the PVer4 server in the last applied
   // update response.
   std::string state_;
@@ -2,6 +2,7 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <utility>
@@ -24,39 +25,71 @@ namespace {
 
 constexpr char kMetricPrefixV4Store[] = "V4Store.";
 constexpr char kMetricGetMatchingHashPrefixMs[] = "get_matching_hash_prefix";
+constexpr char kMetricLookupsPerSecond[] = "lookups_per_second";
+constexpr char kMetricMergeTimeMs[] = "merge_time";
+constexpr char kMetricMergedPrefixesPerSecond[] = "merged_prefixes_per_second";
+
+// Debug builds can be quite slow. Use a smaller number of prefixes to test.
+#if defined(NDEBUG)
+constexpr size_t kNumPrefixes = 2000000;
+#else
+constexpr size_t kNumPrefixes = 20000;
+#endif
+
+// The most hash prefixes added or removed by a partial update.
+constexpr size_t kNumPartialUpdatePrefixes = 10000;
 
 perf_test::PerfResultReporter SetUpV4StoreReporter(const std::string& story) {
   perf_test::PerfResultReporter reporter(kMetricPrefixV4Store, story);
   reporter.RegisterImportantMetric(kMetricGetMatchingHashPrefixMs, "ms");
+  reporter.RegisterImportantMetric(kMetricLookupsPerSecond, "runs/s");
+  reporter.RegisterImportantMetric(kMetricMergeTimeMs, "ms");
+  reporter.RegisterImportantMetric(kMetricMergedPrefixesPerSecond, "runs/s");
   return reporter;
 }
 
+// Returns the concatenated SHA256 hashes of the numbers from |begin| to |end|.
+// Keep the full hashes as one big string to avoid tons of allocations /
+// deallocations in the test.
+std::string GetFullHashes(size_t begin, size_t end) {
+  static_assert(kMaxHashPrefixLength == crypto::kSHA256Length,
+                "SHA256 produces a valid FullHash");
+  CHECK(base::IsValidForType<size_t>(
+      base::CheckMul(end - begin, kMaxHashPrefixLength)));
+
+  std::string full_hashes((end - begin) * kMaxHashPrefixLength, 0);
+  for (size_t i = begin; i < end; i++) {
+    crypto::SHA256HashString(base::StringPrintf("%zu", i),
+                             &full_hashes[(i - begin) * kMaxHashPrefixLength],
+                             kMaxHashPrefixLength);
+  }
+  return full_hashes;
+}
+
+// Returns the sorted and concatenated 4 byte hash prefixes of |full_hashes|.
+HashPrefixes GetSortedPrefixes(base::StringPiece full_hashes) {
+  std::vector<HashPrefix> prefixes;
+  for (size_t i = 0; i < full_hashes.size(); i += kMaxHashPrefixLength)
+    prefixes.emplace_back(full_hashes.substr(i, kMinHashPrefixLength));
+  std::sort(prefixes.begin(), prefixes.end());
+  prefixes.erase(std::unique(prefixes.begin(), prefixes.end()),
+                 prefixes.end());
+  HashPrefixes sorted_prefixes;
+  for (const HashPrefix& prefix : prefixes)
+    sorted_prefixes += prefix;
+  return sorted_prefixes;
+}
+
 }  // namespace
 
 class V4StorePerftest : public testing::Test {};
 
 TEST_F(V4StorePerftest, StressTest) {
-// Debug builds can be quite slow. Use a smaller number of prefixes to test.
-#if defined(NDEBUG)
-  const size_t kNumPrefixes = 2000000;
-#else
-  const size_t kNumPrefixes = 20000;
-#endif
-
-  static_assert(kMaxHashPrefixLength == crypto::kSHA256Length,
-                "SHA256 produces a valid FullHash");
-  CHECK(base::IsValidForType<size_t>(
-      base::CheckMul(kNumPrefixes, kMaxHashPrefixLength)));
-
-  // Keep the full hashes as one big string to avoid tons of allocations /
-  // deallocations in the test.
-  std::string full_hashes(kNumPrefixes * kMaxHashPrefixLength, 0);
+  const std::string full_hashes = GetFullHashes(0, kNumPrefixes);
   base::StringPiece full_hashes_piece = base::StringPiece(full_hashes);
   std::vector<std::string> prefixes;
   for (size_t i = 0; i < kNumPrefixes; i++) {
     size_t index = i * kMaxHashPrefixLength;
-    crypto::SHA256HashString(base::StringPrintf("%zu", i), &full_hashes[index],
-                             kMaxHashPrefixLength);
     prefixes.push_back(full_hashes.substr(index, kMinHashPrefixLength));
   }
 
@@ -79,4 +112,95 @@ TEST_F(V4StorePerftest, StressTest) {
   EXPECT_EQ(kNumPrefixes, matches);
 }
 
+// Compares looking up full hashes, about half of which match, with the
+// HashPrefixIndex of the list and with a binary search.
+TEST_F(V4StorePerftest, Lookup) {
+  auto store = std::make_unique<TestV4Store>(
+      base::MakeRefCounted<base::TestSimpleTaskRunner>(), base::FilePath());
+  store->hash_prefix_map_[kMinHashPrefixLength] =
+      GetSortedPrefixes(GetFullHashes(0, kNumPrefixes));
+  store->BuildHashPrefixIndexes();
+  const HashPrefixes& prefixes = store->hash_prefix_map_[kMinHashPrefixLength];
+  const std::string full_hashes =
+      GetFullHashes(kNumPrefixes / 2, kNumPrefixes * 3 / 2);
+  const base::StringPiece full_hashes_piece(full_hashes);
+
+  size_t indexed_matches = 0;
+  base::ElapsedTimer indexed_timer;
+  for (size_t i = 0; i < full_hashes.size(); i += kMaxHashPrefixLength) {
+    base::StringPiece full_hash =
+        full_hashes_piece.substr(i, kMaxHashPrefixLength);
+    indexed_matches += !store->GetMatchingHashPrefix(full_hash).empty();
+  }
+  auto indexed_reporter = SetUpV4StoreReporter("Indexed");
+  indexed_reporter.AddResult(
+      kMetricLookupsPerSecond,
+      kNumPrefixes / indexed_timer.Elapsed().InSecondsF());
+
+  size_t binary_search_matches = 0;
+  base::ElapsedTimer binary_search_timer;
+  for (size_t i = 0; i < full_hashes.size(); i += kMaxHashPrefixLength) {
+    binary_search_matches += V4Store::HashPrefixMatches(
+        full_hashes_piece.substr(i, kMinHashPrefixLength), prefixes,
+        kMinHashPrefixLength);
+  }
+  auto binary_search_reporter = SetUpV4StoreReporter("BinarySearch");
+  binary_search_reporter.AddResult(
+      kMetricLookupsPerSecond,
+      kNumPrefixes / binary_search_timer.Elapsed().InSecondsF());
+
+  EXPECT_LE(kNumPrefixes / 2, indexed_matches);
+  EXPECT_EQ(indexed_matches, binary_search_matches);
+}
+
+// Measures merging a full update into an empty store, and the largest partial
+// update into a full store, without the checksum but with the indexing of the
+// merged list.
+TEST_F(V4StorePerftest, Merge) {
+  const HashPrefixes prefixes =
+      GetSortedPrefixes(GetFullHashes(0, kNumPrefixes));
+  HashPrefixMap full_update;
+  full_update[kMinHashPrefixLength] = prefixes;
+  // The additions of an update can't be in the store already.
+  const HashPrefixes additions = GetSortedPrefixes(
+      GetFullHashes(kNumPrefixes, kNumPrefixes + kNumPartialUpdatePrefixes));
+  HashPrefixMap partial_update;
+  for (size_t i = 0; i < additions.size(); i += kMinHashPrefixLength) {
+    base::StringPiece addition =
+        base::StringPiece(additions).substr(i, kMinHashPrefixLength);
+    if (!V4Store::HashPrefixMatches(addition, prefixes, kMinHashPrefixLength)) {
+      partial_update[kMinHashPrefixLength].append(addition.data(),
+                                                  addition.size());
+    }
+  }
+  google::protobuf::RepeatedField<google::protobuf::int32> raw_removals;
+  const size_t num_prefixes = prefixes.size() / kMinHashPrefixLength;
+  for (size_t i = 0; i < kNumPartialUpdatePrefixes; i++) {
+    raw_removals.Add(
+        static_cast<int>(i * (num_prefixes / kNumPartialUpdatePrefixes)));
+  }
+
+  auto task_runner = base::MakeRefCounted<base::TestSimpleTaskRunner>();
+  auto run_merge = [&](const std::string& story_name,
+                       const HashPrefixMap& old_prefixes_map,
+                       const HashPrefixMap& additions_map,
+                       const google::protobuf::RepeatedField<
+                           google::protobuf::int32>* raw_removals) {
+    V4Store store(task_runner, base::FilePath());
+    base::ElapsedTimer timer;
+    EXPECT_EQ(APPLY_UPDATE_SUCCESS,
+              store.MergeUpdate(old_prefixes_map, additions_map, raw_removals,
+                                std::string()));
+    const base::TimeDelta elapsed = timer.Elapsed();
+
+    auto reporter = SetUpV4StoreReporter(story_name);
+    reporter.AddResult(kMetricMergeTimeMs, elapsed.InMillisecondsF());
+    reporter.AddResult(kMetricMergedPrefixesPerSecond,
+                       store.hash_prefix_map_[kMinHashPrefixLength].size() /
+                           kMinHashPrefixLength / elapsed.InSecondsF());
+  };
+  run_merge("FullUpdate", HashPrefixMap(), full_update, nullptr);
+  run_merge("PartialUpdate", full_update, partial_update, &raw_removals);
+}
+
 }  // namespace safe_browsing
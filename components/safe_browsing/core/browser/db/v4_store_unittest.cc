@@ -23,6 +23,21 @@ using ::google::protobuf::int32;
 using ::google::protobuf::RepeatedField;
 using ::google::protobuf::RepeatedPtrField;
 
+namespace {
+
+// Returns the 4 byte hash prefixes of the values from |begin| to |end| in
+// steps of |step|, in big-endian order so that they're sorted.
+HashPrefixes GetSortedPrefixes(uint32_t begin, uint32_t end, uint32_t step) {
+  HashPrefixes prefixes;
+  for (uint32_t value = begin; value < end; value += step) {
+    prefixes += {static_cast<char>(value >> 24), static_cast<char>(value >> 16),
+                 static_cast<char>(value >> 8), static_cast<char>(value)};
+  }
+  return prefixes;
+}
+
+}  // namespace
+
 class V4StoreTest : public PlatformTest {
  public:
   V4StoreTest() : task_runner_(new base::TestSimpleTaskRunner) {}
@@ -554,6 +569,69 @@ TEST_F(V4StoreTest, TestMergeUpdatesRemovesMultipleAcrossDifferentSizes) {
   EXPECT_EQ("1111133333bbbbb", prefix_map.at(5));
 }
 
+TEST_F(V4StoreTest, TestMergeUpdatesWithLargeList) {
+  // The multiples of 4, with additions in between, and the removal of some of
+  // the old hash prefixes.
+  HashPrefixMap prefix_map_old;
+  EXPECT_EQ(APPLY_UPDATE_SUCCESS,
+            V4Store::AddUnlumpedHashes(4, GetSortedPrefixes(0, 400000, 4),
+                                       &prefix_map_old));
+  HashPrefixMap prefix_map_additions;
+  EXPECT_EQ(APPLY_UPDATE_SUCCESS,
+            V4Store::AddUnlumpedHashes(
+                4,
+                GetSortedPrefixes(1, 2, 1) +
+                    GetSortedPrefixes(4001, 8000, 1000) +
+                    GetSortedPrefixes(400000, 400002, 1),
+                &prefix_map_additions));
+  RepeatedField<int32> raw_removals;
+  raw_removals.Add(0);
+  raw_removals.Add(1000);
+  raw_removals.Add(1001);
+  raw_removals.Add(99999);
+
+  HashPrefixes expected_prefixes;
+  expected_prefixes += GetSortedPrefixes(1, 2, 1);
+  expected_prefixes += GetSortedPrefixes(4, 4000, 4);
+  expected_prefixes += GetSortedPrefixes(4001, 4002, 1);
+  expected_prefixes += GetSortedPrefixes(4008, 5000, 4);
+  for (uint32_t addition = 5001; addition < 8000; addition += 1000) {
+    expected_prefixes += GetSortedPrefixes(addition - 1, addition + 1, 1);
+    expected_prefixes += GetSortedPrefixes(addition + 3, addition + 999, 4);
+  }
+  expected_prefixes += GetSortedPrefixes(8000, 399996, 4);
+  expected_prefixes += GetSortedPrefixes(400000, 400002, 1);
+
+  V4Store store(task_runner_, store_path_);
+  EXPECT_EQ(APPLY_UPDATE_SUCCESS,
+            store.MergeUpdate(prefix_map_old, prefix_map_additions,
+                              &raw_removals,
+                              crypto::SHA256HashString(expected_prefixes)));
+  ASSERT_EQ(1u, store.hash_prefix_map_.size());
+  EXPECT_EQ(expected_prefixes, store.hash_prefix_map_.at(4));
+  // The merged list is indexed again.
+  ASSERT_EQ(1u, store.hash_prefix_indexes_.size());
+  EXPECT_EQ(expected_prefixes.size() / 4,
+            store.hash_prefix_indexes_.at(4).num_prefixes());
+
+  // The same merge fails if an addition is one of the old hash prefixes, even
+  // if it's removed, or if a removal is out of order.
+  EXPECT_EQ(APPLY_UPDATE_SUCCESS,
+            V4Store::AddUnlumpedHashes(4,
+                                       GetSortedPrefixes(0, 1, 1) +
+                                           GetSortedPrefixes(4000, 4001, 1),
+                                       &prefix_map_additions));
+  V4Store existing_prefix_store(task_runner_, store_path_);
+  EXPECT_EQ(ADDITIONS_HAS_EXISTING_PREFIX_FAILURE,
+            existing_prefix_store.MergeUpdate(
+                prefix_map_old, prefix_map_additions, &raw_removals, ""));
+  raw_removals.Add(99998);
+  V4Store out_of_order_store(task_runner_, store_path_);
+  EXPECT_EQ(REMOVALS_INDEX_TOO_LARGE_FAILURE,
+            out_of_order_store.MergeUpdate(prefix_map_old, HashPrefixMap(),
+                                           &raw_removals, ""));
+}
+
 TEST_F(V4StoreTest, TestReadFullResponseWithValidHashPrefixMap) {
   V4Store write_store(task_runner_, store_path_);
   write_store.hash_prefix_map_[4] = "00000abc";
@@ -684,6 +762,33 @@ TEST_F(V4StoreTest, GetMatchingHashPrefixSize32Or21) {
 #endif
 }
 
+TEST_F(V4StoreTest, TestReadFromDiskIndexesLargeList) {
+  V4Store write_store(task_runner_, store_path_);
+  write_store.hash_prefix_map_[4] = GetSortedPrefixes(0, 1u << 24, 64);
+  write_store.hash_prefix_map_[5] = "11111";
+  EXPECT_EQ(WRITE_SUCCESS, write_store.WriteToDisk(Checksum()));
+
+  V4Store read_store(task_runner_, store_path_);
+  EXPECT_EQ(READ_SUCCESS, read_store.ReadFromDisk());
+  ASSERT_EQ(1u, read_store.hash_prefix_indexes_.size());
+  EXPECT_EQ(1u << 18, read_store.hash_prefix_indexes_.at(4).num_prefixes());
+  for (uint32_t value = 0; value < 1u << 24; value += 1001) {
+    FullHash full_hash = GetSortedPrefixes(value, value + 1, 1) +
+                         std::string(crypto::kSHA256Length - 4, 'x');
+    EXPECT_EQ(value % 64 == 0 ? full_hash.substr(0, 4) : HashPrefix(),
+              read_store.GetMatchingHashPrefix(full_hash));
+  }
+  FullHash full_hash_1 = "11111111111111111111111111111111";
+  EXPECT_EQ("11111", read_store.GetMatchingHashPrefix(full_hash_1));
+
+  // Indexing the lists again drops the index of a list which became small.
+  read_store.hash_prefix_map_[4] = "2222";
+  read_store.BuildHashPrefixIndexes();
+  EXPECT_TRUE(read_store.hash_prefix_indexes_.empty());
+  FullHash full_hash_2 = "22222222222222222222222222222222";
+  EXPECT_EQ("2222", read_store.GetMatchingHashPrefix(full_hash_2));
+}
+
 #if defined(NDEBUG) && !defined(DCHECK_ALWAYS_ON)
 // This test hits a NOTREACHED so it is a release mode only test.
 TEST_F(V4StoreTest, TestAdditionsWithRiceEncodingFailsWithInvalidInput) {
@@ -694,7 +799,7 @@ TEST_F(V4StoreTest, TestAdditionsWithRiceEncodingFailsWithInvalidInput) {
   HashPrefixMap additions_map;
   EXPECT_EQ(RICE_DECODING_FAILURE,
             V4Store(task_runner_, store_path_)
-                .UpdateHashPrefixMapFromAdditions("V4Metric", additions,
+                .UpdateHashPrefixMapFromAdditions("V4Metric", &additions,
                                                   &additions_map));
 }
 #endif
@@ -716,7 +821,7 @@ TEST_F(V4StoreTest, TestAdditionsWithRiceEncodingSucceeds) {
   HashPrefixMap additions_map;
   EXPECT_EQ(APPLY_UPDATE_SUCCESS,
             V4Store(task_runner_, store_path_)
-                .UpdateHashPrefixMapFromAdditions("V4Metric", additions,
+                .UpdateHashPrefixMapFromAdditions("V4Metric", &additions,
                                                   &additions_map));
   EXPECT_EQ(1u, additions_map.size());
   EXPECT_EQ(std::string("\x5\0\0\0\fL\x93\xADV\x7F\xF6o\xCEo1\x81", 16),
@@ -777,6 +882,56 @@ TEST_F(V4StoreTest, TestRemovalsWithRiceEncodingSucceeds) {
   EXPECT_TRUE(updated_store_->HasValidData());
 }
 
+TEST_F(V4StoreTest, TestDecodeUpdate) {
+  auto lur = std::make_unique<ListUpdateResponse>();
+  lur->set_response_type(ListUpdateResponse::PARTIAL_UPDATE);
+  ThreatEntrySet* addition = lur->add_additions();
+  addition->set_compression_type(RICE);
+  RiceDeltaEncoding* rice_hashes = addition->mutable_rice_hashes();
+  rice_hashes->set_first_value(5);
+  rice_hashes->set_num_entries(3);
+  rice_hashes->set_rice_parameter(28);
+  rice_hashes->set_encoded_data(
+      "\xbf\xa8\x3f\xfb\xf\xf\x5e\x27\xe6\xc3\x1d\xc6\x38");
+  // This one is truncated, so it fails to decode.
+  ThreatEntrySet* invalid_addition = lur->add_additions();
+  invalid_addition->set_compression_type(RICE);
+  *invalid_addition->mutable_rice_hashes() = *rice_hashes;
+  invalid_addition->mutable_rice_hashes()->set_encoded_data("\xbf\xa8");
+  ThreatEntrySet* removal = lur->add_removals();
+  removal->set_compression_type(RICE);
+  RiceDeltaEncoding* rice_indices = removal->mutable_rice_indices();
+  rice_indices->set_first_value(0);
+  rice_indices->set_num_entries(2);
+  rice_indices->set_rice_parameter(2);
+  rice_indices->set_encoded_data("\x16");
+  EXPECT_TRUE(V4Store::HasRiceEncodedData(*lur));
+
+  lur = V4Store::DecodeUpdate(store_path_, std::move(lur));
+  ASSERT_EQ(2, lur->additions_size());
+  EXPECT_EQ(RAW, lur->additions(0).compression_type());
+  EXPECT_FALSE(lur->additions(0).has_rice_hashes());
+  EXPECT_EQ(4, lur->additions(0).raw_hashes().prefix_size());
+  EXPECT_EQ(std::string("\x5\0\0\0\fL\x93\xADV\x7F\xF6o\xCEo1\x81", 16),
+            lur->additions(0).raw_hashes().raw_hashes());
+  // ApplyUpdate() fails on the list that didn't decode.
+  EXPECT_EQ(RICE, lur->additions(1).compression_type());
+  EXPECT_EQ("\xbf\xa8", lur->additions(1).rice_hashes().encoded_data());
+  ASSERT_EQ(1, lur->removals_size());
+  EXPECT_EQ(RAW, lur->removals(0).compression_type());
+  EXPECT_FALSE(lur->removals(0).has_rice_indices());
+  const RepeatedField<int32>& indices =
+      lur->removals(0).raw_indices().indices();
+  ASSERT_EQ(3, indices.size());
+  EXPECT_EQ(0, indices.Get(0));
+  EXPECT_EQ(3, indices.Get(1));
+  EXPECT_EQ(4, indices.Get(2));
+  EXPECT_TRUE(V4Store::HasRiceEncodedData(*lur));
+
+  lur->mutable_additions()->RemoveLast();
+  EXPECT_FALSE(V4Store::HasRiceEncodedData(*lur));
+}
+
 TEST_F(V4StoreTest, TestMergeUpdatesFailsChecksum) {
   // Proof of checksum mismatch using python:
   // >>> import hashlib
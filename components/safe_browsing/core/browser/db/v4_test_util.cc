@@ -8,6 +8,7 @@
 #include <string>
 #include <utility>
 
+#include "base/check_op.h"
 #include "base/strings/strcat.h"
 #include "components/safe_browsing/core/browser/db/util.h"
 #include "crypto/sha2.h"
@@ -54,6 +55,7 @@ void TestV4Store::MarkPrefixAsBad(HashPrefix prefix) {
   auto& vec = mock_prefixes_[prefix.size()];
   vec.insert(std::upper_bound(vec.begin(), vec.end(), prefix), prefix);
   hash_prefix_map_[prefix.size()] = base::StrCat(vec);
+  BuildHashPrefixIndexes();
 }
 
 void TestV4Store::SetPrefixes(std::vector<HashPrefix> prefixes,
@@ -61,6 +63,7 @@ void TestV4Store::SetPrefixes(std::vector<HashPrefix> prefixes,
   std::sort(prefixes.begin(), prefixes.end());
   mock_prefixes_[size] = prefixes;
   hash_prefix_map_[size] = base::StrCat(prefixes);
+  BuildHashPrefixIndexes();
 }
 
 TestV4Database::TestV4Database(
@@ -150,4 +153,30 @@ FullHashInfo GetFullHashInfoWithMetadata(
   return fhi;
 }
 
+std::string GetRiceEncodedData(const std::vector<uint32_t>& values,
+                               unsigned int rice_parameter) {
+  std::string encoded_data;
+  size_t num_bits = 0;
+  // The bits are written from the least significant bit of each byte.
+  auto add_bit = [&encoded_data, &num_bits](bool bit) {
+    if (num_bits % 8 == 0)
+      encoded_data.push_back(0);
+    if (bit)
+      encoded_data.back() |= static_cast<char>(1 << (num_bits % 8));
+    ++num_bits;
+  };
+
+  for (size_t i = 1; i < values.size(); ++i) {
+    DCHECK_LE(values[i - 1], values[i]);
+    const uint32_t offset = values[i] - values[i - 1];
+    // The quotient in unary, then the remainder.
+    for (uint32_t q = offset >> rice_parameter; q > 0; --q)
+      add_bit(true);
+    add_bit(false);
+    for (unsigned int bit = 0; bit < rice_parameter; ++bit)
+      add_bit((offset >> bit) & 1);
+  }
+  return encoded_data;
+}
+
 }  // namespace safe_browsing
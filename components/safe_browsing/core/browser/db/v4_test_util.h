@@ -10,6 +10,7 @@
 #include <map>
 #include <memory>
 #include <ostream>
+#include <string>
 #include <vector>
 
 #include "base/memory/raw_ptr.h"
@@ -123,6 +124,12 @@ FullHashInfo GetFullHashInfoWithMetadata(const GURL& url,
                                          const ListIdentifier& list_id,
                                          const ThreatMetadata& threat_metadata);
 
+// Returns the Rice encoding, with |rice_parameter|, of the offsets between the
+// consecutive increasing |values|, as sent by the server for V4RiceDecoder to
+// decode with |values[0]| as the first value.
+std::string GetRiceEncodedData(const std::vector<uint32_t>& values,
+                               unsigned int rice_parameter);
+
 }  // namespace safe_browsing
 
 #endif  // COMPONENTS_SAFE_BROWSING_CORE_BROWSER_DB_V4_TEST_UTIL_H_
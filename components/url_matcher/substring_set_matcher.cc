@@ -6,12 +6,16 @@
 
 #include <stddef.h>
 
+#include <string.h>
+
 #include <algorithm>
+#include <array>
 #include <queue>
 
 #include "base/check_op.h"
 #include "base/containers/contains.h"
 #include "base/containers/queue.h"
+#include "base/memory/ptr_util.h"
 #include "base/numerics/checked_math.h"
 #include "base/trace_event/memory_usage_estimator.h"
 
@@ -35,8 +39,35 @@ std::vector<const StringPattern*> GetVectorOfPointers(
   return pattern_pointers;
 }
 
+constexpr uint32_t kSnapshotMagic = 0x53534d53;  // "SSMS"
+
 }  // namespace
 
+// A snapshot consists of the header, followed by the nodes, the edge targets,
+// the dense transitions, the byte classes and the edge labels. All the
+// sections are multiples of 4 bytes long, but the last one.
+struct SubstringSetMatcher::SnapshotHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t is_empty;
+  uint32_t num_nodes;
+  uint32_t num_edges;
+  uint32_t num_byte_classes;
+  uint32_t num_dense_nodes;
+};
+
+struct SubstringSetMatcher::CompiledNode {
+  // The edges of the node are at [first_edge, first_edge + num_edges) in
+  // |edge_labels_| and |edge_targets_|, sorted by label.
+  uint32_t first_edge;
+  uint32_t num_edges;
+  // As in AhoCorasickNode. Both lead to nodes which come before this one, but
+  // for the failure edge of the root.
+  NodeID failure;
+  NodeID output_link;
+  StringPattern::ID match_id;
+};
+
 SubstringSetMatcher::SubstringSetMatcher(
     const std::vector<StringPattern>& patterns)
     : SubstringSetMatcher(GetVectorOfPointers(patterns)) {}
@@ -66,53 +97,56 @@ SubstringSetMatcher::SubstringSetMatcher(
   // size was correct.
   DCHECK_EQ(tree_.size(), static_cast<size_t>(GetTreeSize(patterns)));
 
-  is_empty_ = patterns.empty() && tree_.size() == 1u;
+  CompileTree(patterns.empty() && tree_.size() == 1u);
 }
 
+SubstringSetMatcher::SubstringSetMatcher() = default;
+
 SubstringSetMatcher::~SubstringSetMatcher() = default;
 
+// static
+std::unique_ptr<SubstringSetMatcher> SubstringSetMatcher::CreateFromSnapshot(
+    base::span<const uint8_t> snapshot) {
+  auto matcher = base::WrapUnique(new SubstringSetMatcher());
+  if (!matcher->LoadSnapshot(snapshot))
+    return nullptr;
+  return matcher;
+}
+
 bool SubstringSetMatcher::Match(const std::string& text,
                                 std::set<StringPattern::ID>* matches) const {
   const size_t old_number_of_matches = matches->size();
 
   // Handle patterns matching the empty string.
-  const AhoCorasickNode* const root = &tree_[kRootID];
-  AccumulateMatchesForNode(root, matches);
+  AccumulateMatchesForNode(kRootID, matches);
 
-  const AhoCorasickNode* current_node = root;
-  for (const char c : text) {
-    NodeID child = current_node->GetEdge(c);
-
-    // If the child not can't be found, progressively iterate over the longest
-    // proper suffix of the string represented by the current node. In a sense
-    // we are pruning prefixes from the text.
-    while (child == kInvalidNodeID && current_node != root) {
-      current_node = &tree_[current_node->failure()];
-      child = current_node->GetEdge(c);
-    }
+  // Only the empty pattern, if any.
+  if (nodes_.size() == 1u)
+    return old_number_of_matches != matches->size();
 
-    if (child != kInvalidNodeID) {
-      // The string represented by |child| is the longest possible suffix of the
-      // current position of |text| in the trie.
-      current_node = &tree_[child];
+  NodeID current_node = kRootID;
+  for (const char c : text) {
+    // The string represented by |current_node| is the longest possible suffix
+    // of the current position of |text| in the trie. If it's the root, that's
+    // the empty string, whose matches are already accumulated.
+    current_node = GetNextNode(current_node, c);
+    if (current_node != kRootID)
       AccumulateMatchesForNode(current_node, matches);
-    } else {
-      // The empty string is the longest possible suffix of the current position
-      // of |text| in the trie.
-      DCHECK_EQ(root, current_node);
-    }
   }
 
   return old_number_of_matches != matches->size();
 }
 
 size_t SubstringSetMatcher::EstimateMemoryUsage() const {
-  return base::trace_event::EstimateMemoryUsage(tree_);
+  return base::trace_event::EstimateMemoryUsage(tree_) +
+         base::trace_event::EstimateMemoryUsage(owned_snapshot_);
 }
 
 // static
 constexpr SubstringSetMatcher::NodeID SubstringSetMatcher::kInvalidNodeID;
 constexpr SubstringSetMatcher::NodeID SubstringSetMatcher::kRootID;
+constexpr size_t SubstringSetMatcher::kMaxDenseTransitions;
+constexpr uint32_t SubstringSetMatcher::kSnapshotVersion;
 
 SubstringSetMatcher::NodeID SubstringSetMatcher::GetTreeSize(
     const std::vector<const StringPattern*>& patterns) const {
@@ -268,19 +302,248 @@ void SubstringSetMatcher::CreateFailureAndOutputEdges() {
   }
 }
 
+void SubstringSetMatcher::CompileTree(bool is_empty) {
+  // Number the nodes in breadth first order. Failure edges and output links
+  // always lead to shallower nodes, so they lead to lower numbers.
+  std::vector<NodeID> order;
+  std::vector<NodeID> new_ids(tree_.size(), kInvalidNodeID);
+  order.reserve(tree_.size());
+  order.push_back(kRootID);
+  new_ids[kRootID] = 0;
+  size_t num_edges = 0;
+  for (size_t i = 0; i < order.size(); ++i) {
+    for (const auto& edge : tree_[order[i]].edges()) {
+      new_ids[edge.second] = static_cast<NodeID>(order.size());
+      order.push_back(edge.second);
+      ++num_edges;
+    }
+  }
+  DCHECK_EQ(tree_.size(), order.size());
+
+  // Give each byte which is an edge label a class of its own.
+  std::array<bool, 256> is_label = {};
+  for (const AhoCorasickNode& node : tree_) {
+    for (const auto& edge : node.edges())
+      is_label[static_cast<uint8_t>(edge.first)] = true;
+  }
+  const bool has_unused_bytes =
+      std::find(is_label.begin(), is_label.end(), false) != is_label.end();
+  std::array<uint8_t, 256> byte_classes = {};
+  std::vector<char> class_labels;
+  size_t num_byte_classes = has_unused_bytes ? 1 : 0;
+  for (size_t byte = 0; byte < is_label.size(); ++byte) {
+    if (!is_label[byte])
+      continue;
+    byte_classes[byte] = static_cast<uint8_t>(num_byte_classes++);
+    class_labels.push_back(static_cast<char>(byte));
+  }
+  DCHECK_LE(num_byte_classes, 256u);
+
+  // The dense transitions of a node only depend on the ones of its failure
+  // node, which comes before it, and failure edges from the other nodes
+  // eventually lead to one of them.
+  size_t num_dense_nodes = 0;
+  if (tree_.size() >= kMinDenseNodes) {
+    num_dense_nodes =
+        std::min(tree_.size(),
+                 std::max<size_t>(1u, kMaxDenseTransitions / num_byte_classes));
+  }
+
+  SnapshotHeader header = {};
+  header.magic = kSnapshotMagic;
+  header.version = kSnapshotVersion;
+  header.is_empty = is_empty;
+  header.num_nodes = static_cast<uint32_t>(tree_.size());
+  header.num_edges = static_cast<uint32_t>(num_edges);
+  header.num_byte_classes = static_cast<uint32_t>(num_byte_classes);
+  header.num_dense_nodes = static_cast<uint32_t>(num_dense_nodes);
+
+  const size_t nodes_offset = sizeof(SnapshotHeader);
+  const size_t edge_targets_offset =
+      nodes_offset + tree_.size() * sizeof(CompiledNode);
+  const size_t dense_transitions_offset =
+      edge_targets_offset + num_edges * sizeof(NodeID);
+  const size_t byte_classes_offset =
+      dense_transitions_offset +
+      num_dense_nodes * num_byte_classes * sizeof(NodeID);
+  const size_t edge_labels_offset = byte_classes_offset + byte_classes.size();
+  owned_snapshot_.resize(edge_labels_offset + num_edges);
+
+  uint8_t* const data = owned_snapshot_.data();
+  memcpy(data, &header, sizeof(header));
+  memcpy(data + byte_classes_offset, byte_classes.data(), byte_classes.size());
+  auto* const nodes = reinterpret_cast<CompiledNode*>(data + nodes_offset);
+  auto* const edge_targets =
+      reinterpret_cast<NodeID*>(data + edge_targets_offset);
+  auto* const dense_transitions =
+      reinterpret_cast<NodeID*>(data + dense_transitions_offset);
+  char* const edge_labels = reinterpret_cast<char*>(data + edge_labels_offset);
+
+  uint32_t first_edge = 0;
+  for (size_t id = 0; id < order.size(); ++id) {
+    const AhoCorasickNode& node = tree_[order[id]];
+    CompiledNode& compiled_node = nodes[id];
+    compiled_node.first_edge = first_edge;
+    compiled_node.num_edges = static_cast<uint32_t>(node.edges().size());
+    compiled_node.failure = new_ids[node.failure()];
+    compiled_node.output_link = node.output_link() == kInvalidNodeID
+                                    ? kInvalidNodeID
+                                    : new_ids[node.output_link()];
+    compiled_node.match_id =
+        node.IsEndOfPattern() ? node.GetMatchID() : StringPattern::kInvalidId;
+    for (const auto& edge : node.edges()) {
+      edge_labels[first_edge] = edge.first;
+      edge_targets[first_edge] = new_ids[edge.second];
+      ++first_edge;
+    }
+
+    if (id >= num_dense_nodes)
+      continue;
+    NodeID* const row = dense_transitions + id * num_byte_classes;
+    // The unused bytes, if any, lead back to the root from any node.
+    if (has_unused_bytes)
+      row[0] = kRootID;
+    for (size_t byte_class = has_unused_bytes ? 1 : 0;
+         byte_class < num_byte_classes; ++byte_class) {
+      const char label = class_labels[byte_class - (has_unused_bytes ? 1 : 0)];
+      const NodeID child = node.GetEdge(label);
+      if (child != kInvalidNodeID) {
+        row[byte_class] = new_ids[child];
+      } else if (id == kRootID) {
+        row[byte_class] = kRootID;
+      } else {
+        DCHECK_LT(compiled_node.failure, id);
+        row[byte_class] =
+            dense_transitions[compiled_node.failure * num_byte_classes +
+                              byte_class];
+      }
+    }
+  }
+
+  std::vector<AhoCorasickNode>().swap(tree_);
+
+  const bool loaded = LoadSnapshot(owned_snapshot_);
+  DCHECK(loaded);
+}
+
+bool SubstringSetMatcher::LoadSnapshot(base::span<const uint8_t> snapshot) {
+  SnapshotHeader header;
+  if (snapshot.size() < sizeof(header) ||
+      reinterpret_cast<uintptr_t>(snapshot.data()) % alignof(CompiledNode)) {
+    return false;
+  }
+  memcpy(&header, snapshot.data(), sizeof(header));
+  if (header.magic != kSnapshotMagic || header.version != kSnapshotVersion ||
+      header.num_nodes == 0 || header.num_byte_classes == 0 ||
+      header.num_byte_classes > 256 ||
+      header.num_dense_nodes > header.num_nodes) {
+    return false;
+  }
+
+  base::CheckedNumeric<size_t> nodes_size = header.num_nodes;
+  nodes_size *= sizeof(CompiledNode);
+  base::CheckedNumeric<size_t> edge_targets_size = header.num_edges;
+  edge_targets_size *= sizeof(NodeID);
+  base::CheckedNumeric<size_t> dense_transitions_size = header.num_dense_nodes;
+  dense_transitions_size *= header.num_byte_classes;
+  dense_transitions_size *= sizeof(NodeID);
+  const size_t kByteClassesSize = 256;
+  base::CheckedNumeric<size_t> snapshot_size = sizeof(header);
+  snapshot_size += nodes_size + edge_targets_size + dense_transitions_size +
+                   kByteClassesSize + header.num_edges;
+  if (!snapshot_size.IsValid() || snapshot_size.ValueOrDie() != snapshot.size())
+    return false;
+
+  base::span<const uint8_t> rest = snapshot.subspan(sizeof(header));
+  auto take = [&rest](size_t size) {
+    base::span<const uint8_t> section = rest.first(size);
+    rest = rest.subspan(size);
+    return section;
+  };
+  nodes_ = base::make_span(
+      reinterpret_cast<const CompiledNode*>(
+          take(nodes_size.ValueOrDie()).data()),
+      header.num_nodes);
+  edge_targets_ = base::make_span(
+      reinterpret_cast<const NodeID*>(
+          take(edge_targets_size.ValueOrDie()).data()),
+      header.num_edges);
+  dense_transitions_ = base::make_span(
+      reinterpret_cast<const NodeID*>(
+          take(dense_transitions_size.ValueOrDie()).data()),
+      header.num_dense_nodes * header.num_byte_classes);
+  byte_classes_ = take(kByteClassesSize);
+  edge_labels_ = base::make_span(
+      reinterpret_cast<const char*>(take(header.num_edges).data()),
+      header.num_edges);
+
+  // Matching doesn't check the IDs it follows, so they are all checked here.
+  // Failure edges and output links must also lead to earlier nodes for the
+  // automaton to terminate, and output links to nodes with a match.
+  for (size_t id = 0; id < nodes_.size(); ++id) {
+    const CompiledNode& node = nodes_[id];
+    if ((id == kRootID ? node.failure != kRootID : node.failure >= id) ||
+        (node.output_link != kInvalidNodeID &&
+         (node.output_link >= id ||
+          nodes_[node.output_link].match_id == StringPattern::kInvalidId)) ||
+        node.first_edge > header.num_edges ||
+        node.num_edges > header.num_edges - node.first_edge) {
+      return false;
+    }
+  }
+  auto is_node_id = [&header](NodeID id) { return id < header.num_nodes; };
+  if (!std::all_of(edge_targets_.begin(), edge_targets_.end(), is_node_id) ||
+      !std::all_of(dense_transitions_.begin(), dense_transitions_.end(),
+                   is_node_id) ||
+      !std::all_of(byte_classes_.begin(), byte_classes_.end(),
+                   [&header](uint8_t byte_class) {
+                     return byte_class < header.num_byte_classes;
+                   })) {
+    return false;
+  }
+
+  snapshot_ = snapshot;
+  num_byte_classes_ = header.num_byte_classes;
+  num_dense_nodes_ = header.num_dense_nodes;
+  is_empty_ = header.is_empty;
+  return true;
+}
+
+SubstringSetMatcher::NodeID SubstringSetMatcher::GetNextNode(NodeID node_id,
+                                                             char c) const {
+  // The root is compiled, unless no node is, so this ends there at the latest.
+  while (node_id >= num_dense_nodes_) {
+    const CompiledNode& node = nodes_[node_id];
+    const base::span<const char> labels =
+        edge_labels_.subspan(node.first_edge, node.num_edges);
+    const auto label = std::lower_bound(labels.begin(), labels.end(), c);
+    if (label != labels.end() && *label == c)
+      return edge_targets_[node.first_edge + (label - labels.begin())];
+    if (node_id == kRootID)
+      return kRootID;
+    // Progressively iterate over the longest proper suffix of the string
+    // represented by the current node. In a sense we are pruning prefixes
+    // from the text.
+    node_id = node.failure;
+  }
+  return dense_transitions_[node_id * num_byte_classes_ +
+                            byte_classes_[static_cast<uint8_t>(c)]];
+}
+
 void SubstringSetMatcher::AccumulateMatchesForNode(
-    const AhoCorasickNode* node,
+    NodeID node_id,
     std::set<StringPattern::ID>* matches) const {
   DCHECK(matches);
 
-  if (node->IsEndOfPattern())
-    matches->insert(node->GetMatchID());
+  const CompiledNode* node = &nodes_[node_id];
+  if (node->match_id != StringPattern::kInvalidId)
+    matches->insert(node->match_id);
 
-  NodeID node_id = node->output_link();
+  node_id = node->output_link;
   while (node_id != kInvalidNodeID) {
-    node = &tree_[node_id];
-    matches->insert(node->GetMatchID());
-    node_id = node->output_link();
+    node = &nodes_[node_id];
+    matches->insert(node->match_id);
+    node_id = node->output_link;
   }
 }
 
@@ -5,14 +5,17 @@
 #ifndef COMPONENTS_URL_MATCHER_SUBSTRING_SET_MATCHER_H_
 #define COMPONENTS_URL_MATCHER_SUBSTRING_SET_MATCHER_H_
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include <limits>
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
 
 #include "base/containers/flat_map.h"
+#include "base/containers/span.h"
 #include "components/url_matcher/string_pattern.h"
 #include "components/url_matcher/url_matcher_export.h"
 
@@ -20,6 +23,15 @@ namespace url_matcher {
 
 // Class that store a set of string patterns and can find for a string S,
 // which string patterns occur in S.
+//
+// Matching runs an Aho-Corasick automaton. Its shallowest states, which most
+// of the text is matched in, are compiled into a DFA over byte classes, with
+// the failure edges folded into the transitions, so that matching a byte from
+// them is a single table lookup. The deeper states keep their sparse edges and
+// fall back to failure edges, until they reach a compiled state.
+//
+// The compiled automaton is a flat snapshot, which can be saved and matched in
+// place later, e.g. from a memory-mapped file, instead of building it again.
 class URL_MATCHER_EXPORT SubstringSetMatcher {
  public:
   // Registers all |patterns|. Each pattern needs to have a unique ID and all
@@ -28,9 +40,10 @@ class URL_MATCHER_EXPORT SubstringSetMatcher {
   //    Let n = number of patterns.
   //    Let S = sum of pattern lengths.
   //    Let k = range of char. Generally 256.
-  // Complexity = O(nlogn + S * logk)
+  // Complexity = O(nlogn + S * logk + kMaxDenseTransitions)
   // nlogn comes from sorting the patterns.
   // log(k) comes from our usage of std::map to store edges.
+  // kMaxDenseTransitions bounds the size of the compiled states.
   SubstringSetMatcher(const std::vector<StringPattern>& patterns);
   SubstringSetMatcher(std::vector<const StringPattern*> patterns);
 
@@ -39,6 +52,17 @@ class URL_MATCHER_EXPORT SubstringSetMatcher {
 
   ~SubstringSetMatcher();
 
+  // Returns a matcher for |snapshot|, as returned by GetSnapshot(), which
+  // matches in place without copying it. |snapshot| must outlive the matcher,
+  // and be aligned for uint32_t. Returns null if |snapshot| was taken by
+  // another version of this class, or is corrupted.
+  static std::unique_ptr<SubstringSetMatcher> CreateFromSnapshot(
+      base::span<const uint8_t> snapshot);
+
+  // Returns the compiled automaton. It's in the byte order of this device, and
+  // only meant to be loaded by the same version of this class.
+  base::span<const uint8_t> GetSnapshot() const { return snapshot_; }
+
   // Matches |text| against all registered StringPatterns. Stores the IDs
   // of matching patterns in |matches|. |matches| is not cleared before adding
   // to it.
@@ -46,7 +70,8 @@ class URL_MATCHER_EXPORT SubstringSetMatcher {
   //    Let t = length of |text|.
   //    Let k = range of char. Generally 256.
   //    Let z = number of matches returned.
-  // Complexity = O(t * logk + zlogz)
+  // Complexity = O(t * logk + zlogz), and O(t + zlogz) while the text matches
+  // within the compiled states.
   bool Match(const std::string& text,
              std::set<StringPattern::ID>* matches) const;
 
@@ -57,6 +82,9 @@ class URL_MATCHER_EXPORT SubstringSetMatcher {
   // base/trace_event/memory_usage_estimator.h for details.
   size_t EstimateMemoryUsage() const;
 
+  // Bumped whenever the format of the snapshots changes.
+  static constexpr uint32_t kSnapshotVersion = 1;
+
  private:
   // Represents the index of the node within |tree_|. It is specifically
   // uint32_t so that we can be sure it takes up 4 bytes. If the computed size
@@ -64,11 +92,24 @@ class URL_MATCHER_EXPORT SubstringSetMatcher {
   // be a CHECK failure.
   using NodeID = uint32_t;
 
+  struct SnapshotHeader;
+  struct CompiledNode;
+
   // This is the maximum possible size of |tree_| and hence can't be a valid ID.
   static constexpr NodeID kInvalidNodeID = std::numeric_limits<NodeID>::max();
 
   static constexpr NodeID kRootID = 0;
 
+  // The minimum number of nodes of a tree for its states to be compiled.
+  // Smaller trees are only matched through their sparse edges. This is slower
+  // per byte, but keeps the many small matchers, which match short URLs, a few
+  // times smaller.
+  static constexpr size_t kMinDenseNodes = 256;
+
+  // The maximum number of transitions of the compiled states, which bounds
+  // their memory usage to 4 MB. Smaller pattern sets are compiled entirely.
+  static constexpr size_t kMaxDenseTransitions = 1 << 20;
+
   // A node of an Aho Corasick Tree. See
   // http://web.stanford.edu/class/archive/cs/cs166/cs166.1166/lectures/02/Small02.pdf
   // to understand the algorithm.
@@ -162,6 +203,9 @@ class URL_MATCHER_EXPORT SubstringSetMatcher {
 
   using SubstringPatternVector = std::vector<const StringPattern*>;
 
+  // Creates an empty matcher, for CreateFromSnapshot().
+  SubstringSetMatcher();
+
   // Given the set of patterns, compute how many nodes will the corresponding
   // Aho-Corasick tree have. Note that |patterns| need to be sorted.
   NodeID GetTreeSize(const std::vector<const StringPattern*>& patterns) const;
@@ -174,14 +218,47 @@ class URL_MATCHER_EXPORT SubstringSetMatcher {
 
   void CreateFailureAndOutputEdges();
 
+  // Writes the tree to |owned_snapshot_|, with its nodes in breadth first
+  // order, and compiles the shallowest ones into |dense_transitions_|, up to
+  // kMaxDenseTransitions, if there are at least kMinDenseNodes. Releases
+  // |tree_|.
+  void CompileTree(bool is_empty);
+
+  // Points the members below at the sections of |snapshot|. Returns false if
+  // it isn't a valid snapshot.
+  bool LoadSnapshot(base::span<const uint8_t> snapshot);
+
+  // Returns the node the automaton moves to from |node| on |c|.
+  NodeID GetNextNode(NodeID node, char c) const;
+
   // Adds all pattern IDs to |matches| which are a suffix of the string
   // represented by |node|.
-  void AccumulateMatchesForNode(const AhoCorasickNode* node,
+  void AccumulateMatchesForNode(NodeID node,
                                 std::set<StringPattern::ID>* matches) const;
 
-  // The nodes of a Aho-Corasick tree.
+  // The nodes of a Aho-Corasick tree, while it's being built.
   std::vector<AhoCorasickNode> tree_;
 
+  // The snapshot of a built matcher.
+  std::vector<uint8_t> owned_snapshot_;
+
+  // The snapshot the matcher runs on, and its sections.
+  base::span<const uint8_t> snapshot_;
+  base::span<const CompiledNode> nodes_;
+  base::span<const NodeID> edge_targets_;
+  base::span<const char> edge_labels_;
+
+  // Maps each byte to its class. The bytes which occur in no pattern share
+  // class 0, and all the others have a class of their own.
+  base::span<const uint8_t> byte_classes_;
+  size_t num_byte_classes_ = 0;
+
+  // The transitions of the nodes below |num_dense_nodes_|, by node and then
+  // byte class, including the ones that follow failure edges. Empty if the
+  // tree is smaller than kMinDenseNodes.
+  base::span<const NodeID> dense_transitions_;
+  size_t num_dense_nodes_ = 0;
+
   bool is_empty_ = true;
 };
 
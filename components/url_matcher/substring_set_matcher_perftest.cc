@@ -5,6 +5,8 @@
 #include "components/url_matcher/substring_set_matcher.h"
 
 #include <limits>
+#include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -30,17 +32,13 @@ std::string GetRandomString(size_t len) {
   return std::string(random_chars.begin(), random_chars.end());
 }
 
-// Tests performance of SubstringSetMatcher for 20000 random patterns of length
-// 30.
-TEST(SubstringSetMatcherPerfTest, RandomKeys) {
+// Creates |num_patterns| unique random patterns of length |pattern_len|.
+std::vector<StringPattern> CreatePatterns(size_t num_patterns,
+                                          size_t pattern_len) {
   std::vector<StringPattern> patterns;
   std::set<std::string> pattern_strings;
-
-  // Create patterns.
-  const size_t kNumPatterns = 20000;
-  const size_t kPatternLen = 30;
-  for (size_t i = 0; i < kNumPatterns; i++) {
-    std::string str = GetRandomString(kPatternLen);
+  for (size_t i = 0; i < num_patterns; i++) {
+    std::string str = GetRandomString(pattern_len);
 
     // Ensure we don't have any duplicate pattern strings.
     if (base::Contains(pattern_strings, str))
@@ -49,7 +47,14 @@ TEST(SubstringSetMatcherPerfTest, RandomKeys) {
     pattern_strings.insert(str);
     patterns.emplace_back(str, i);
   }
+  return patterns;
+}
 
+// Reports the initialization time and memory usage of a SubstringSetMatcher
+// for |patterns|, and the time it takes to match them against a random string
+// of 500 characters and against a megabyte of random strings.
+void RunTest(const std::string& story_name,
+             const std::vector<StringPattern>& patterns) {
   base::ElapsedTimer init_timer;
 
   // Allocate SubstringSetMatcher on the heap so that EstimateMemoryUsage below
@@ -64,22 +69,49 @@ TEST(SubstringSetMatcherPerfTest, RandomKeys) {
   matcher->Match(GetRandomString(kTextLen), &matches);
   base::TimeDelta match_time = match_timer.Elapsed();
 
+  // Match patterns against many of them, which is dominated by walking the
+  // automaton rather than by the cache misses of the first few characters.
+  const size_t kNumTexts = 2000;
+  std::vector<std::string> texts;
+  for (size_t i = 0; i < kNumTexts; i++)
+    texts.push_back(GetRandomString(kTextLen));
+  base::ElapsedTimer throughput_timer;
+  for (const std::string& text : texts)
+    matcher->Match(text, &matches);
+  base::TimeDelta throughput_time = throughput_timer.Elapsed();
+
   const char* kInitializationTime = ".init_time";
   const char* kMatchTime = ".match_time";
+  const char* kMatchThroughput = ".match_throughput";
   const char* kMemoryUsage = ".memory_usage";
   auto reporter =
-      perf_test::PerfResultReporter("SubstringSetMatcher", "RandomKeys");
+      perf_test::PerfResultReporter("SubstringSetMatcher", story_name);
   reporter.RegisterImportantMetric(kInitializationTime, "us");
   reporter.RegisterImportantMetric(kMatchTime, "us");
+  reporter.RegisterImportantMetric(kMatchThroughput, "MiB/s");
   reporter.RegisterImportantMetric(kMemoryUsage, "Mb");
 
   reporter.AddResult(kInitializationTime, init_time);
   reporter.AddResult(kMatchTime, match_time);
+  reporter.AddResult(kMatchThroughput, kNumTexts * kTextLen * 1.0 / (1 << 20) /
+                                           throughput_time.InSecondsF());
   reporter.AddResult(
       kMemoryUsage,
       (base::trace_event::EstimateMemoryUsage(matcher) * 1.0 / (1 << 20)));
 }
 
+// Tests performance of SubstringSetMatcher for 20000 random patterns of length
+// 30.
+TEST(SubstringSetMatcherPerfTest, RandomKeys) {
+  RunTest("RandomKeys", CreatePatterns(20000, 30));
+}
+
+// Tests performance of SubstringSetMatcher for 200000 random patterns of length
+// 10, more than fit in the dense transitions.
+TEST(SubstringSetMatcherPerfTest, ManyRandomKeys) {
+  RunTest("ManyRandomKeys", CreatePatterns(200000, 10));
+}
+
 }  // namespace
 
 }  // namespace url_matcher
@@ -5,7 +5,10 @@
 #include "components/url_matcher/substring_set_matcher.h"
 
 #include <stddef.h>
+#include <string.h>
 
+#include <memory>
+#include <random>
 #include <set>
 #include <string>
 #include <vector>
@@ -67,6 +70,46 @@ void TestTwoPatterns(const std::string& test_string,
   }
 }
 
+// Returns a random string of |length| characters from |alphabet|.
+std::string GetRandomString(std::minstd_rand* generator,
+                            const std::string& alphabet,
+                            size_t length) {
+  std::string str;
+  for (size_t i = 0; i < length; ++i)
+    str.push_back(alphabet[(*generator)() % alphabet.size()]);
+  return str;
+}
+
+// Adds a pattern for |str| to |patterns|, unless there's one already.
+void AddUniquePattern(const std::string& str,
+                      std::vector<StringPattern>* patterns) {
+  for (const StringPattern& pattern : *patterns) {
+    if (pattern.pattern() == str)
+      return;
+  }
+  patterns->emplace_back(str, static_cast<StringPattern::ID>(patterns->size()));
+}
+
+// Checks that the matches of |patterns| in random texts are the ones found by
+// searching each pattern in turn.
+void TestRandomTexts(std::minstd_rand* generator,
+                     const std::vector<StringPattern>& patterns,
+                     const std::string& alphabet) {
+  SubstringSetMatcher matcher(patterns);
+  for (int i = 0; i < 200; ++i) {
+    const std::string text =
+        GetRandomString(generator, alphabet, (*generator)() % 200);
+    std::set<int> expected_matches;
+    for (const StringPattern& pattern : patterns) {
+      if (text.find(pattern.pattern()) != std::string::npos)
+        expected_matches.insert(pattern.id());
+    }
+    std::set<int> matches;
+    EXPECT_EQ(!expected_matches.empty(), matcher.Match(text, &matches));
+    EXPECT_EQ(expected_matches, matches) << text;
+  }
+}
+
 }  // namespace
 
 TEST(SubstringSetMatcherTest, TestMatcher) {
@@ -177,4 +220,180 @@ TEST(SubstringSetMatcherTest, TestEmptyMatcher) {
   EXPECT_TRUE(matcher.IsEmpty());
 }
 
+// Few patterns, fewer than kMinDenseNodes states, which are only matched
+// through their sparse edges.
+TEST(SubstringSetMatcherTest, TestRandomPatterns) {
+  std::minstd_rand generator(42);
+  const std::string kAlphabet = "abcd";
+  std::vector<StringPattern> patterns;
+  for (int i = 0; i < 50; ++i) {
+    AddUniquePattern(
+        GetRandomString(&generator, kAlphabet, 1 + generator() % 6), &patterns);
+  }
+  TestRandomTexts(&generator, patterns, kAlphabet + "xy");
+}
+
+// Enough patterns for their states to be compiled, which all fit in the dense
+// transitions.
+TEST(SubstringSetMatcherTest, TestCompiledRandomPatterns) {
+  std::minstd_rand generator(42);
+  const std::string kAlphabet = "abcd";
+  std::vector<StringPattern> patterns;
+  for (int i = 0; i < 200; ++i) {
+    AddUniquePattern(
+        GetRandomString(&generator, kAlphabet, 1 + generator() % 8), &patterns);
+  }
+  TestRandomTexts(&generator, patterns, kAlphabet + "xy");
+}
+
+// Patterns and texts which use all the byte values.
+TEST(SubstringSetMatcherTest, TestAllBytes) {
+  std::minstd_rand generator(42);
+  std::string all_bytes;
+  for (int c = 0; c < 256; ++c)
+    all_bytes.push_back(static_cast<char>(c));
+  std::vector<StringPattern> patterns;
+  AddUniquePattern(all_bytes, &patterns);
+  for (int i = 0; i < 100; ++i)
+    AddUniquePattern(GetRandomString(&generator, all_bytes, 2), &patterns);
+  TestRandomTexts(&generator, patterns, all_bytes);
+}
+
+// Enough patterns that only the shallow states fit in the dense transitions,
+// so that the matcher also follows sparse and failure edges.
+TEST(SubstringSetMatcherTest, TestManyRandomPatterns) {
+  std::minstd_rand generator(42);
+  const std::string kAlphabet = "abcdefghijklmnopqrstuvwxyz";
+  std::vector<StringPattern> patterns;
+  for (int i = 0; i < 5000; ++i) {
+    std::string pattern = GetRandomString(&generator, kAlphabet, 20);
+    // Make some of the patterns overlap, so that deep states have failure
+    // edges to other deep states.
+    if (i % 2)
+      pattern = patterns.back().pattern().substr(10) + pattern.substr(10);
+    AddUniquePattern(pattern, &patterns);
+  }
+  SubstringSetMatcher matcher(patterns);
+  for (int i = 0; i < 20; ++i) {
+    // Texts made of overlapping patterns.
+    std::string text;
+    for (int j = 0; j < 10; ++j) {
+      const std::string& pattern =
+          patterns[generator() % patterns.size()].pattern();
+      text += pattern.substr(generator() % pattern.size());
+    }
+    std::set<int> expected_matches;
+    for (const StringPattern& pattern : patterns) {
+      if (text.find(pattern.pattern()) != std::string::npos)
+        expected_matches.insert(pattern.id());
+    }
+    std::set<int> matches;
+    matcher.Match(text, &matches);
+    EXPECT_EQ(expected_matches, matches) << text;
+  }
+  TestRandomTexts(&generator, patterns, kAlphabet);
+}
+
+TEST(SubstringSetMatcherTest, TestSnapshot) {
+  std::minstd_rand generator(42);
+  const std::string kAlphabet = "abcd";
+  std::vector<StringPattern> patterns;
+  for (int i = 0; i < 50; ++i) {
+    AddUniquePattern(
+        GetRandomString(&generator, kAlphabet, 1 + generator() % 6), &patterns);
+  }
+  SubstringSetMatcher matcher(patterns);
+  const std::vector<uint8_t> snapshot(matcher.GetSnapshot().begin(),
+                                      matcher.GetSnapshot().end());
+
+  std::unique_ptr<SubstringSetMatcher> loaded_matcher =
+      SubstringSetMatcher::CreateFromSnapshot(snapshot);
+  ASSERT_TRUE(loaded_matcher);
+  EXPECT_FALSE(loaded_matcher->IsEmpty());
+  // The snapshot is used in place.
+  EXPECT_EQ(snapshot.data(), loaded_matcher->GetSnapshot().data());
+  EXPECT_EQ(0u, loaded_matcher->EstimateMemoryUsage());
+
+  for (int i = 0; i < 200; ++i) {
+    const std::string text =
+        GetRandomString(&generator, kAlphabet + "xy", generator() % 200);
+    std::set<int> expected_matches;
+    matcher.Match(text, &expected_matches);
+    std::set<int> matches;
+    loaded_matcher->Match(text, &matches);
+    EXPECT_EQ(expected_matches, matches) << text;
+  }
+}
+
+TEST(SubstringSetMatcherTest, TestEmptySnapshot) {
+  std::vector<StringPattern> patterns;
+  SubstringSetMatcher matcher(patterns);
+  std::unique_ptr<SubstringSetMatcher> loaded_matcher =
+      SubstringSetMatcher::CreateFromSnapshot(matcher.GetSnapshot());
+  ASSERT_TRUE(loaded_matcher);
+  EXPECT_TRUE(loaded_matcher->IsEmpty());
+  std::set<int> matches;
+  EXPECT_FALSE(loaded_matcher->Match("abd", &matches));
+}
+
+TEST(SubstringSetMatcherTest, TestInvalidSnapshot) {
+  std::vector<StringPattern> patterns;
+  patterns.emplace_back("abc", 1);
+  patterns.emplace_back("bcd", 2);
+  SubstringSetMatcher matcher(patterns);
+  const base::span<const uint8_t> snapshot = matcher.GetSnapshot();
+  ASSERT_TRUE(SubstringSetMatcher::CreateFromSnapshot(snapshot));
+
+  EXPECT_FALSE(SubstringSetMatcher::CreateFromSnapshot({}));
+  EXPECT_FALSE(SubstringSetMatcher::CreateFromSnapshot(
+      snapshot.first(snapshot.size() - 1)));
+
+  std::vector<uint8_t> other_version(snapshot.begin(), snapshot.end());
+  other_version[sizeof(uint32_t)] ^= 1;
+  EXPECT_FALSE(SubstringSetMatcher::CreateFromSnapshot(other_version));
+
+  std::vector<uint8_t> misaligned(1);
+  misaligned.insert(misaligned.end(), snapshot.begin(), snapshot.end());
+  EXPECT_FALSE(SubstringSetMatcher::CreateFromSnapshot(
+      base::make_span(misaligned).subspan(1)));
+}
+
+// Snapshots may be corrupted on disk, so any of their IDs may be out of
+// bounds.
+TEST(SubstringSetMatcherTest, TestCorruptedSnapshot) {
+  std::minstd_rand generator(42);
+  const std::string kAlphabet = "abcd";
+  std::vector<StringPattern> patterns;
+  for (int i = 0; i < 200; ++i) {
+    AddUniquePattern(
+        GetRandomString(&generator, kAlphabet, 1 + generator() % 8), &patterns);
+  }
+  SubstringSetMatcher matcher(patterns);
+  const base::span<const uint8_t> snapshot = matcher.GetSnapshot();
+  std::string text;
+  for (int c = 0; c < 256; ++c)
+    text.push_back(static_cast<char>(c));
+  text += GetRandomString(&generator, kAlphabet, 1000);
+
+  // Every section is made of 4 byte words, but the edge labels.
+  std::vector<uint8_t> corrupted(snapshot.begin(), snapshot.end());
+  size_t num_rejected = 0;
+  for (size_t i = 0; i + sizeof(uint32_t) <= corrupted.size();
+       i += sizeof(uint32_t)) {
+    for (uint32_t value : {0x7fffffffu, 0xffffffffu}) {
+      memcpy(&corrupted[i], &value, sizeof(value));
+      std::unique_ptr<SubstringSetMatcher> loaded_matcher =
+          SubstringSetMatcher::CreateFromSnapshot(corrupted);
+      if (loaded_matcher) {
+        std::set<int> matches;
+        loaded_matcher->Match(text, &matches);
+      } else {
+        ++num_rejected;
+      }
+    }
+    memcpy(&corrupted[i], &snapshot[i], sizeof(uint32_t));
+  }
+  EXPECT_GT(num_rejected, corrupted.size() / sizeof(uint32_t));
+}
+
 }  // namespace url_matcher
@@ -4,14 +4,22 @@
 
 #include "components/url_matcher/url_matcher.h"
 
+#include <stdint.h>
+#include <string.h>
+
 #include <algorithm>
+#include <array>
 #include <iterator>
 #include <utility>
 
+#include "base/bits.h"
 #include "base/check.h"
 #include "base/containers/contains.h"
 #include "base/memory/ptr_util.h"
 #include "base/notreached.h"
+#include "base/numerics/checked_math.h"
+#include "base/numerics/safe_conversions.h"
+#include "crypto/sha2.h"
 #include "url/gurl.h"
 #include "url/url_canon.h"
 
@@ -157,6 +165,73 @@ bool IsMatcherEmpty(const std::unique_ptr<SubstringSetMatcher>& matcher) {
   return !matcher || matcher->IsEmpty();
 }
 
+// A snapshot of a URLMatcher consists of the header, followed by the snapshots
+// of its URL component and full URL SubstringSetMatchers, each of which starts
+// at a multiple of 8 bytes.
+struct URLMatcherSnapshotHeader {
+  uint32_t magic;
+  uint32_t version;
+  struct Section {
+    // Identify the patterns the SubstringSetMatcher was built for.
+    uint32_t num_patterns;
+    std::array<uint8_t, crypto::kSHA256Length> patterns_hash;
+    // Locate the snapshot of the SubstringSetMatcher in the URLMatcher's.
+    uint32_t offset;
+    uint32_t size;
+  } sections[2];
+};
+
+constexpr uint32_t kSnapshotMagic = 0x4d4c5255;  // "URLM"
+// Bumped whenever the format of the snapshots changes. The format of the
+// SubstringSetMatcher snapshots is versioned separately.
+constexpr uint32_t kSnapshotVersion = 2;
+constexpr size_t kSnapshotSectionAlignment = 8;
+
+size_t GetSnapshotSectionIndex(bool full_url_conditions) {
+  return full_url_conditions ? 1 : 0;
+}
+
+// Returns the SHA-256 hash of the IDs and strings of |patterns|, which are
+// sorted by ID.
+std::array<uint8_t, crypto::kSHA256Length> HashPatterns(
+    const std::vector<const StringPattern*>& patterns) {
+  std::string key;
+  for (const StringPattern* pattern : patterns) {
+    const StringPattern::ID id = pattern->id();
+    const uint32_t size = static_cast<uint32_t>(pattern->pattern().size());
+    key.append(reinterpret_cast<const char*>(&id), sizeof(id));
+    key.append(reinterpret_cast<const char*>(&size), sizeof(size));
+    key.append(pattern->pattern());
+  }
+  return crypto::SHA256Hash(base::as_bytes(base::make_span(key)));
+}
+
+// Returns the SubstringSetMatcher in |snapshot| for |patterns|, if there is
+// one.
+std::unique_ptr<SubstringSetMatcher> CreateSubstringSetMatcherFromSnapshot(
+    base::span<const uint8_t> snapshot,
+    bool full_url_conditions,
+    const std::vector<const StringPattern*>& patterns) {
+  URLMatcherSnapshotHeader header;
+  if (snapshot.size() < sizeof(header))
+    return nullptr;
+  memcpy(&header, snapshot.data(), sizeof(header));
+  if (header.magic != kSnapshotMagic || header.version != kSnapshotVersion)
+    return nullptr;
+
+  const URLMatcherSnapshotHeader::Section& section =
+      header.sections[GetSnapshotSectionIndex(full_url_conditions)];
+  base::CheckedNumeric<size_t> end = section.offset;
+  end += section.size;
+  if (section.num_patterns != patterns.size() ||
+      section.patterns_hash != HashPatterns(patterns) || !end.IsValid() ||
+      end.ValueOrDie() > snapshot.size()) {
+    return nullptr;
+  }
+  return SubstringSetMatcher::CreateFromSnapshot(
+      snapshot.subspan(section.offset, section.size));
+}
+
 }  // namespace
 
 //
@@ -805,6 +880,40 @@ URLMatcher::URLMatcher() {}
 
 URLMatcher::~URLMatcher() {}
 
+std::vector<uint8_t> URLMatcher::GetSnapshot() const {
+  URLMatcherSnapshotHeader header = {};
+  header.magic = kSnapshotMagic;
+  header.version = kSnapshotVersion;
+  std::vector<uint8_t> snapshot(sizeof(header));
+  for (bool full_url_conditions : {false, true}) {
+    const std::unique_ptr<SubstringSetMatcher>& url_matcher =
+        full_url_conditions ? full_url_matcher_ : url_component_matcher_;
+    if (!url_matcher)
+      continue;
+    const std::vector<const StringPattern*> patterns =
+        GetSubstringPatterns(full_url_conditions);
+    const base::span<const uint8_t> matcher_snapshot =
+        url_matcher->GetSnapshot();
+    snapshot.resize(base::bits::AlignUp(snapshot.size(),
+                                        kSnapshotSectionAlignment));
+
+    URLMatcherSnapshotHeader::Section& section =
+        header.sections[GetSnapshotSectionIndex(full_url_conditions)];
+    section.num_patterns = static_cast<uint32_t>(patterns.size());
+    section.patterns_hash = HashPatterns(patterns);
+    section.offset = base::checked_cast<uint32_t>(snapshot.size());
+    section.size = base::checked_cast<uint32_t>(matcher_snapshot.size());
+    snapshot.insert(snapshot.end(), matcher_snapshot.begin(),
+                    matcher_snapshot.end());
+  }
+  memcpy(snapshot.data(), &header, sizeof(header));
+  return snapshot;
+}
+
+void URLMatcher::SetSnapshot(base::span<const uint8_t> snapshot) {
+  snapshot_ = snapshot;
+}
+
 void URLMatcher::AddConditionSets(
     const URLMatcherConditionSet::Vector& condition_sets) {
   for (auto i = condition_sets.begin(); i != condition_sets.end(); ++i) {
@@ -890,7 +999,8 @@ bool URLMatcher::IsEmpty() const {
          origin_and_path_regex_set_matcher_.IsEmpty();
 }
 
-void URLMatcher::UpdateSubstringSetMatcher(bool full_url_conditions) {
+std::vector<const StringPattern*> URLMatcher::GetSubstringPatterns(
+    bool full_url_conditions) const {
   // The purpose of |full_url_conditions| is just that we need to execute
   // the same logic once for Full URL searches and once for URL Component
   // searches (see URLMatcherConditionFactory).
@@ -926,13 +1036,29 @@ void URLMatcher::UpdateSubstringSetMatcher(bool full_url_conditions) {
     }
   }
 
-  // Update the SubstringSetMatcher.
+  // Sort the patterns by ID, which identifies them in snapshots.
+  std::vector<const StringPattern*> patterns(new_patterns.begin(),
+                                             new_patterns.end());
+  std::sort(patterns.begin(), patterns.end(),
+            [](const StringPattern* a, const StringPattern* b) {
+              return a->id() < b->id();
+            });
+  return patterns;
+}
+
+void URLMatcher::UpdateSubstringSetMatcher(bool full_url_conditions) {
+  std::vector<const StringPattern*> patterns =
+      GetSubstringPatterns(full_url_conditions);
+
+  // Update the SubstringSetMatcher, from the snapshot if it has one for these
+  // patterns.
   std::unique_ptr<SubstringSetMatcher>& url_matcher =
       full_url_conditions ? full_url_matcher_ : url_component_matcher_;
 
-  url_matcher =
-      std::make_unique<SubstringSetMatcher>(std::vector<const StringPattern*>(
-          new_patterns.begin(), new_patterns.end()));
+  url_matcher = CreateSubstringSetMatcherFromSnapshot(
+      snapshot_, full_url_conditions, patterns);
+  if (!url_matcher)
+    url_matcher = std::make_unique<SubstringSetMatcher>(std::move(patterns));
 }
 
 void URLMatcher::UpdateRegexSetMatcher() {
@@ -6,11 +6,13 @@
 #define COMPONENTS_URL_MATCHER_URL_MATCHER_H_
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include <memory>
 #include <set>
 #include <vector>
 
+#include "base/containers/span.h"
 #include "base/memory/raw_ptr.h"
 #include "base/memory/ref_counted.h"
 #include "components/url_matcher/regex_set_matcher.h"
@@ -410,7 +412,25 @@ class URL_MATCHER_EXPORT URLMatcher {
   // Returns true if this object retains no allocated data. Only for debugging.
   bool IsEmpty() const;
 
+  // Returns a snapshot of the SubstringSetMatchers of this URLMatcher, e.g. to
+  // save in a file which a URLMatcher can memory-map at the next startup and
+  // pass to SetSnapshot(), instead of building them again.
+  std::vector<uint8_t> GetSnapshot() const;
+
+  // Makes this URLMatcher use the SubstringSetMatchers of |snapshot| in place,
+  // as long as the condition sets it's given need the same patterns as the
+  // ones of the URLMatcher it was taken from. They are built as usual
+  // otherwise, e.g. if the conditions changed, or if the snapshot was taken by
+  // another version. Must be called before AddConditionSets() to be of use.
+  // |snapshot| must be aligned for uint32_t, and outlive this URLMatcher.
+  void SetSnapshot(base::span<const uint8_t> snapshot);
+
  private:
+  // Returns the patterns of the full URL conditions, or of the URL component
+  // and query conditions, sorted by ID.
+  std::vector<const StringPattern*> GetSubstringPatterns(
+      bool full_url_conditions) const;
+
   void UpdateSubstringSetMatcher(bool full_url_conditions);
   void UpdateRegexSetMatcher();
   void UpdateTriggers();
@@ -436,6 +456,9 @@ class URL_MATCHER_EXPORT URLMatcher {
   std::unique_ptr<SubstringSetMatcher> url_component_matcher_;
   RegexSetMatcher regex_set_matcher_;
   RegexSetMatcher origin_and_path_regex_set_matcher_;
+
+  // See SetSnapshot().
+  base::span<const uint8_t> snapshot_;
 };
 
 }  // namespace url_matcher
@@ -0,0 +1,135 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "components/url_matcher/url_matcher.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/files/memory_mapped_file.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/process/process_metrics.h"
+#include "base/strings/stringprintf.h"
+#include "base/timer/elapsed_timer.h"
+#include "build/build_config.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+#include "url/gurl.h"
+
+// This file compares the startup of a URLMatcher for a large URL blocklist
+// policy, building its SubstringSetMatchers, and loading them from a
+// memory-mapped snapshot. The snapshot file is in the page cache, as on most
+// startups after the first one.
+
+namespace url_matcher {
+
+namespace {
+
+constexpr char kMetricPrefixURLMatcher[] = "URLMatcher.";
+constexpr char kMetricStartupTime[] = "startup_time";
+constexpr char kMetricMallocUsage[] = "malloc_usage";
+constexpr char kMetricResidentSetSize[] = "resident_set_size";
+
+constexpr size_t kNumConditionSets = 100000;
+
+// Adds a condition set for each rule of the blocklist to |matcher|.
+void AddConditionSets(URLMatcher* matcher) {
+  URLMatcherConditionFactory* factory = matcher->condition_factory();
+  URLMatcherConditionSet::Vector condition_sets;
+  for (size_t i = 0; i < kNumConditionSets; ++i) {
+    URLMatcherConditionSet::Conditions conditions;
+    const std::string host = base::StringPrintf("site%zu.example", i);
+    const std::string path =
+        i % 4 ? std::string("/") : base::StringPrintf("/path%zu", i);
+    conditions.insert(
+        factory->CreateHostSuffixPathPrefixCondition(host, path));
+    condition_sets.push_back(base::MakeRefCounted<URLMatcherConditionSet>(
+        static_cast<URLMatcherConditionSet::ID>(i), conditions));
+  }
+  matcher->AddConditionSets(condition_sets);
+}
+
+// Measures the startup of a URLMatcher, and the memory it uses afterwards. The
+// resident set size also counts the pages of the snapshot which were read, but
+// not the memory the allocator kept from previous measurements and reused.
+class StartupMeasurement {
+ public:
+  StartupMeasurement()
+      : process_metrics_(base::ProcessMetrics::CreateCurrentProcessMetrics()) {
+    malloc_usage_ = process_metrics_->GetMallocUsage();
+#if defined(OS_LINUX) || defined(OS_CHROMEOS) || defined(OS_ANDROID)
+    resident_set_size_ = process_metrics_->GetResidentSetSize();
+#endif
+  }
+
+  // Reports the measurements, once the URLMatcher has started and matched a
+  // URL.
+  void Report(const std::string& story_name) {
+    const base::TimeDelta startup_time = timer_.Elapsed();
+    perf_test::PerfResultReporter reporter(kMetricPrefixURLMatcher,
+                                           story_name);
+    reporter.RegisterImportantMetric(kMetricStartupTime, "ms");
+    reporter.RegisterImportantMetric(kMetricMallocUsage, "Mb");
+    reporter.AddResult(kMetricStartupTime, startup_time);
+    reporter.AddResult(
+        kMetricMallocUsage,
+        (process_metrics_->GetMallocUsage() - malloc_usage_) * 1.0 / (1 << 20));
+#if defined(OS_LINUX) || defined(OS_CHROMEOS) || defined(OS_ANDROID)
+    reporter.RegisterImportantMetric(kMetricResidentSetSize, "Mb");
+    reporter.AddResult(kMetricResidentSetSize,
+                       (process_metrics_->GetResidentSetSize() -
+                        resident_set_size_) *
+                           1.0 / (1 << 20));
+#endif
+  }
+
+ private:
+  const std::unique_ptr<base::ProcessMetrics> process_metrics_;
+  size_t malloc_usage_ = 0;
+#if defined(OS_LINUX) || defined(OS_CHROMEOS) || defined(OS_ANDROID)
+  size_t resident_set_size_ = 0;
+#endif
+  const base::ElapsedTimer timer_;
+};
+
+TEST(URLMatcherPerfTest, Startup) {
+  const GURL kUrl("https://site1234.example/index.html");
+
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  const base::FilePath snapshot_path =
+      temp_dir.GetPath().AppendASCII("url_matcher_snapshot");
+
+  {
+    StartupMeasurement measurement;
+    URLMatcher matcher;
+    AddConditionSets(&matcher);
+    EXPECT_EQ(1u, matcher.MatchURL(kUrl).size());
+    measurement.Report("Build");
+
+    ASSERT_TRUE(base::WriteFile(snapshot_path, matcher.GetSnapshot()));
+  }
+
+  {
+    StartupMeasurement measurement;
+    base::MemoryMappedFile snapshot;
+    ASSERT_TRUE(snapshot.Initialize(snapshot_path));
+    URLMatcher matcher;
+    matcher.SetSnapshot(base::make_span(snapshot.data(), snapshot.length()));
+    AddConditionSets(&matcher);
+    EXPECT_EQ(1u, matcher.MatchURL(kUrl).size());
+    measurement.Report("Snapshot");
+  }
+}
+
+}  // namespace
+
+}  // namespace url_matcher
@@ -7,7 +7,10 @@
 #include <stddef.h>
 
 #include <memory>
+#include <set>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "base/cxx17_backports.h"
 #include "base/strings/string_util.h"
@@ -985,4 +988,72 @@ TEST(URLMatcherTest, TestOriginAndPathRegExNegative) {
   EXPECT_EQ(0u, matcher.MatchURL(url).size());
 }
 
+namespace {
+
+// Adds the same condition sets to |matcher| as to the matchers of the other
+// calls, but for the host suffix of the last one.
+void AddConditionSetsForSnapshot(URLMatcher* matcher,
+                                 const std::string& host_suffix) {
+  URLMatcherConditionFactory* factory = matcher->condition_factory();
+  URLMatcherConditionSet::Conditions conditions1;
+  conditions1.insert(factory->CreateHostSuffixCondition("example.com"));
+  conditions1.insert(factory->CreatePathContainsCondition("foo"));
+  URLMatcherConditionSet::Conditions conditions2;
+  conditions2.insert(
+      factory->CreateURLPrefixCondition("https://www.example.org/"));
+  URLMatcherConditionSet::Conditions conditions3;
+  conditions3.insert(factory->CreateHostSuffixCondition(host_suffix));
+
+  URLMatcherConditionSet::Vector insert;
+  insert.push_back(
+      base::MakeRefCounted<URLMatcherConditionSet>(1, conditions1));
+  insert.push_back(
+      base::MakeRefCounted<URLMatcherConditionSet>(2, conditions2));
+  insert.push_back(
+      base::MakeRefCounted<URLMatcherConditionSet>(3, conditions3));
+  matcher->AddConditionSets(insert);
+}
+
+}  // namespace
+
+TEST(URLMatcherTest, TestSnapshot) {
+  const GURL kUrls[] = {GURL("http://www.example.com/foo"),
+                        GURL("https://www.example.org/index.html"),
+                        GURL("http://www.example.net/"),
+                        GURL("http://www.example.edu/")};
+
+  URLMatcher matcher;
+  AddConditionSetsForSnapshot(&matcher, "example.net");
+  const std::vector<uint8_t> snapshot = matcher.GetSnapshot();
+
+  // The same condition sets match the same URLs with the snapshot.
+  URLMatcher loaded_matcher;
+  loaded_matcher.SetSnapshot(snapshot);
+  AddConditionSetsForSnapshot(&loaded_matcher, "example.net");
+  for (const GURL& url : kUrls)
+    EXPECT_EQ(matcher.MatchURL(url), loaded_matcher.MatchURL(url)) << url;
+  EXPECT_EQ(snapshot, loaded_matcher.GetSnapshot());
+
+  // Different ones don't use it.
+  URLMatcher changed_matcher;
+  changed_matcher.SetSnapshot(snapshot);
+  AddConditionSetsForSnapshot(&changed_matcher, "example.edu");
+  EXPECT_EQ(std::set<URLMatcherConditionSet::ID>({1}),
+            changed_matcher.MatchURL(kUrls[0]));
+  EXPECT_TRUE(changed_matcher.MatchURL(kUrls[2]).empty());
+  EXPECT_EQ(std::set<URLMatcherConditionSet::ID>({3}),
+            changed_matcher.MatchURL(kUrls[3]));
+
+  // Neither does a URLMatcher with a snapshot of another version.
+  std::vector<uint8_t> other_version_snapshot = snapshot;
+  other_version_snapshot[sizeof(uint32_t)] ^= 1;
+  URLMatcher other_version_matcher;
+  other_version_matcher.SetSnapshot(other_version_snapshot);
+  AddConditionSetsForSnapshot(&other_version_matcher, "example.net");
+  for (const GURL& url : kUrls) {
+    EXPECT_EQ(matcher.MatchURL(url), other_version_matcher.MatchURL(url))
+        << url;
+  }
+}
+
 }  // namespace url_matcher
@@ -0,0 +1,19 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ipc/features.h"
+
+namespace IPC {
+namespace features {
+
+// Makes ChannelMojo write large messages without attachments into a ring
+// buffer in shared memory and only send their size through the message pipe,
+// which saves copying them through the pipe's transport. The ring for each
+// direction is allocated by the sending end the first time it sends a large
+// enough message, so only the sending end needs the feature enabled.
+const base::Feature kIpcSharedMemoryRing{"IpcSharedMemoryRing",
+                                         base::FEATURE_DISABLED_BY_DEFAULT};
+
+}  // namespace features
+}  // namespace IPC
@@ -0,0 +1,20 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IPC_FEATURES_H_
+#define IPC_FEATURES_H_
+
+#include "base/component_export.h"
+#include "base/feature_list.h"
+
+namespace IPC {
+namespace features {
+
+COMPONENT_EXPORT(IPC)
+extern const base::Feature kIpcSharedMemoryRing;
+
+}  // namespace features
+}  // namespace IPC
+
+#endif  // IPC_FEATURES_H_
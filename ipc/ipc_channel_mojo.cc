@@ -215,10 +215,12 @@ void ChannelMojo::FinishConnectOnIOThread() {
 
 void ChannelMojo::Pause() {
   bootstrap_->Pause();
+  paused_ = true;
 }
 
 void ChannelMojo::Unpause(bool flush) {
   bootstrap_->Unpause();
+  paused_ = false;
   if (flush)
     Flush();
 }
@@ -287,7 +289,7 @@ bool ChannelMojo::Send(Message* message) {
   //
   // With Mojo, there's no OnFileCanReadWithoutBlocking, but we expect the
   // pipe's connection error handler will be invoked in its place.
-  return message_reader_->Send(std::move(scoped_message));
+  return message_reader_->Send(std::move(scoped_message), !paused_);
 }
 
 Channel::AssociatedInterfaceSupport*
@@ -128,6 +128,9 @@ class COMPONENT_EXPORT(IPC) ChannelMojo
   std::unique_ptr<MojoBootstrap> bootstrap_;
   raw_ptr<Listener> listener_;
 
+  // Whether Pause() was called without a matching Unpause().
+  bool paused_ = false;
+
   std::unique_ptr<internal::MessagePipeReader> message_reader_;
 
   base::Lock associated_interface_lock_;
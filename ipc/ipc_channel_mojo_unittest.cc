@@ -14,6 +14,7 @@
 #include "base/bind.h"
 #include "base/callback_helpers.h"
 #include "base/containers/queue.h"
+#include "base/cxx17_backports.h"
 #include "base/files/file.h"
 #include "base/files/scoped_temp_dir.h"
 #include "base/location.h"
@@ -30,6 +31,7 @@
 #include "base/synchronization/waitable_event.h"
 #include "base/task/single_thread_task_runner.h"
 #include "base/test/bind.h"
+#include "base/test/scoped_feature_list.h"
 #include "base/test/task_environment.h"
 #include "base/test/test_io_thread.h"
 #include "base/test/test_shared_memory_util.h"
@@ -37,6 +39,7 @@
 #include "base/threading/thread.h"
 #include "base/threading/thread_task_runner_handle.h"
 #include "build/build_config.h"
+#include "ipc/features.h"
 #include "ipc/ipc_message.h"
 #include "ipc/ipc_message_utils.h"
 #include "ipc/ipc_mojo_handle_attachment.h"
@@ -661,6 +664,78 @@ DEFINE_IPC_CHANNEL_MOJO_TEST_CLIENT(IPCChannelMojoTestSendOkClient) {
   Close();
 }
 
+// Sizes of messages sent through the pipe, through the ring buffer, and too
+// large for it, given the parameters set in SendThroughMessageRing below,
+// sent for enough rounds to wrap around the ring several times.
+constexpr size_t kMessageRingTestSizes[] = {100,   2000, 20000,
+                                            70000, 5000, 30000};
+constexpr size_t kMessageRingTestCount = 60;
+
+std::string GetMessageRingTestString(size_t index) {
+  return std::string(
+      kMessageRingTestSizes[index % base::size(kMessageRingTestSizes)],
+      static_cast<char>('a' + index % 26));
+}
+
+class ListenerThatExpectsMessageRingStrings : public TestListenerBase {
+ public:
+  explicit ListenerThatExpectsMessageRingStrings(base::OnceClosure quit_closure)
+      : TestListenerBase(std::move(quit_closure)) {}
+
+  bool OnMessageReceived(const IPC::Message& message) override {
+    base::PickleIterator iter(message);
+    std::string value;
+    EXPECT_TRUE(iter.ReadString(&value));
+    EXPECT_EQ(GetMessageRingTestString(received_count_), value);
+    if (++received_count_ == kMessageRingTestCount) {
+      ListenerThatExpectsOK::SendOK(sender());
+      RunQuitClosure();
+    }
+    return true;
+  }
+
+  void OnBadMessageReceived(const IPC::Message& message) override {
+    ADD_FAILURE();
+  }
+
+ private:
+  size_t received_count_ = 0;
+};
+
+TEST_F(IPCChannelMojoTest, SendThroughMessageRing) {
+  // Only the sending end needs the feature enabled.
+  base::test::ScopedFeatureList feature_list;
+  feature_list.InitAndEnableFeatureWithParameters(
+      IPC::features::kIpcSharedMemoryRing,
+      {{"RingSizeKb", "64"}, {"MinMessageSize", "1024"}});
+  Init("IPCChannelMojoTestMessageRingClient");
+
+  base::RunLoop run_loop;
+  ListenerThatExpectsOK listener(run_loop.QuitClosure());
+  CreateChannel(&listener);
+  ASSERT_TRUE(ConnectChannel());
+
+  for (size_t i = 0; i < kMessageRingTestCount; ++i)
+    SendString(channel(), GetMessageRingTestString(i));
+
+  run_loop.Run();
+  channel()->Close();
+
+  EXPECT_TRUE(WaitForClientShutdown());
+  DestroyChannel();
+}
+
+DEFINE_IPC_CHANNEL_MOJO_TEST_CLIENT(IPCChannelMojoTestMessageRingClient) {
+  base::RunLoop run_loop;
+  ListenerThatExpectsMessageRingStrings listener(run_loop.QuitClosure());
+  Connect(&listener);
+  listener.set_sender(channel());
+
+  run_loop.Run();
+
+  Close();
+}
+
 class ListenerWithSimpleAssociatedInterface
     : public IPC::Listener,
       public IPC::mojom::SimpleTestDriver {
@@ -13,6 +13,7 @@
 #include "base/strings/stringprintf.h"
 #include "base/synchronization/waitable_event.h"
 #include "base/test/perf_log.h"
+#include "base/test/scoped_feature_list.h"
 #include "base/test/task_environment.h"
 #include "base/timer/timer.h"
 #include "ipc/ipc_channel_proxy.h"
@@ -54,6 +55,15 @@ std::vector<TestParams> GetDefaultTestParams() {
   return list;
 }
 
+std::vector<TestParams> GetLargeMessageTestParams() {
+  std::vector<TestParams> list;
+  list.push_back({1024, 60, 10, 10});
+  list.push_back({64 * 1024, 60, 10, 10});
+  list.push_back({1024 * 1024, 60, 2, 10});
+  list.push_back({4 * 1024 * 1024, 30, 1, 10});
+  return list;
+}
+
 std::string GetLogTitle(const std::string& label, const TestParams& params) {
   return base::StringPrintf(
       "%s_MsgSize_%zu_FrmPerSec_%zu_MsgPerFrm_%zu", label.c_str(),
@@ -102,6 +112,20 @@ MULTIPROCESS_TEST_MAIN(MojoPerfTestClientTestChildMain) {
   return rv;
 }
 
+MULTIPROCESS_TEST_MAIN(MojoPerfTestRingClientTestChildMain) {
+  base::test::ScopedFeatureList feature_list;
+  EnableSharedMemoryRing(&feature_list);
+  MojoPerfTestClient client;
+  int rv = mojo::core::test::MultiprocessTestHelper::RunClientMain(
+      base::BindOnce(&MojoPerfTestClient::Run, base::Unretained(&client)),
+      true /* pass_pipe_ownership_to_main */);
+
+  base::RunLoop run_loop;
+  run_loop.RunUntilIdle();
+
+  return rv;
+}
+
 class ChannelSteadyPingPongListener : public Listener {
  public:
   ChannelSteadyPingPongListener() = default;
@@ -222,7 +246,15 @@ class ChannelSteadyPingPongTest : public IPCChannelMojoTestBase {
   ~ChannelSteadyPingPongTest() override = default;
 
   void RunPingPongServer(const std::string& label, bool sync) {
-    Init("MojoPerfTestClient");
+    RunPingPongServer(label, sync, "MojoPerfTestClient",
+                      GetDefaultTestParams());
+  }
+
+  void RunPingPongServer(const std::string& label,
+                         bool sync,
+                         const std::string& client_name,
+                         const std::vector<TestParams>& params_list) {
+    Init(client_name);
 
     // Set up IPC channel and start client.
     ChannelSteadyPingPongListener listener;
@@ -246,7 +278,6 @@ class ChannelSteadyPingPongTest : public IPCChannelMojoTestBase {
     listener.Init(channel_proxy.get());
 
     LockThreadAffinity thread_locker(kSharedCore);
-    std::vector<TestParams> params_list = GetDefaultTestParams();
     for (const auto& params : params_list) {
       base::RunLoop run_loop;
 
@@ -275,6 +306,30 @@ TEST_F(ChannelSteadyPingPongTest, SyncPingPong) {
   RunPingPongServer("IPC_CPU_Sync", true);
 }
 
+TEST_F(ChannelSteadyPingPongTest, AsyncPingPongLargeMessages) {
+  RunPingPongServer("IPC_CPU_Async_Large", false, "MojoPerfTestClient",
+                    GetLargeMessageTestParams());
+}
+
+TEST_F(ChannelSteadyPingPongTest, AsyncPingPongSharedMemoryRing) {
+  base::test::ScopedFeatureList feature_list;
+  EnableSharedMemoryRing(&feature_list);
+  RunPingPongServer("IPC_CPU_Async_Ring", false, "MojoPerfTestRingClient",
+                    GetLargeMessageTestParams());
+}
+
+TEST_F(ChannelSteadyPingPongTest, SyncPingPongLargeMessages) {
+  RunPingPongServer("IPC_CPU_Sync_Large", true, "MojoPerfTestClient",
+                    GetLargeMessageTestParams());
+}
+
+TEST_F(ChannelSteadyPingPongTest, SyncPingPongSharedMemoryRing) {
+  base::test::ScopedFeatureList feature_list;
+  EnableSharedMemoryRing(&feature_list);
+  RunPingPongServer("IPC_CPU_Sync_Ring", true, "MojoPerfTestRingClient",
+                    GetLargeMessageTestParams());
+}
+
 class MojoSteadyPingPongTest : public mojo::core::test::MojoTestBase {
  public:
   MojoSteadyPingPongTest() = default;
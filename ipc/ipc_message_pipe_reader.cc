@@ -6,17 +6,23 @@
 
 #include <stdint.h>
 
+#include <algorithm>
 #include <utility>
+#include <vector>
 
 #include "base/bind.h"
+#include "base/bits.h"
 #include "base/callback_helpers.h"
 #include "base/containers/span.h"
 #include "base/location.h"
 #include "base/logging.h"
+#include "base/metrics/field_trial_params.h"
 #include "base/task/single_thread_task_runner.h"
 #include "base/threading/thread_task_runner_handle.h"
 #include "base/trace_event/trace_event.h"
+#include "ipc/features.h"
 #include "ipc/ipc_channel_mojo.h"
+#include "ipc/ipc_shared_memory_ring.h"
 #include "mojo/public/cpp/bindings/message.h"
 #include "mojo/public/cpp/bindings/thread_safe_proxy.h"
 
@@ -25,6 +31,28 @@ namespace internal {
 
 namespace {
 
+// The capacity of each direction's ring. Rounded down to a power of two.
+const base::FeatureParam<int> kIpcSharedMemoryRingSizeKb = {
+    &features::kIpcSharedMemoryRing, "RingSizeKb",
+    8 * 1024  // Room for several of the largest frequent messages.
+};
+
+// Messages smaller than this go through the pipe, as they're cheap to copy.
+const base::FeatureParam<int> kIpcSharedMemoryRingMinMessageSize = {
+    &features::kIpcSharedMemoryRing, "MinMessageSize", 16 * 1024};
+
+size_t GetMessageRingCapacity() {
+  if (!base::FeatureList::IsEnabled(features::kIpcSharedMemoryRing))
+    return 0;
+  const int size_kb =
+      std::min(kIpcSharedMemoryRingSizeKb.Get(),
+               static_cast<int>(SharedMemoryRingWriter::kMaxCapacity >> 10));
+  if (size_kb <= 0)
+    return 0;
+  return size_t{1} << (base::bits::Log2Floor(static_cast<uint32_t>(size_kb)) +
+                       10);
+}
+
 class ThreadSafeProxy : public mojo::ThreadSafeProxy {
  public:
   using Forwarder = base::RepeatingCallback<void(mojo::Message)>;
@@ -68,7 +96,10 @@ MessagePipeReader::MessagePipeReader(
     MessagePipeReader::Delegate* delegate)
     : delegate_(delegate),
       sender_(std::move(sender), task_runner),
-      receiver_(this, std::move(receiver), task_runner) {
+      receiver_(this, std::move(receiver), task_runner),
+      message_ring_capacity_(GetMessageRingCapacity()),
+      message_ring_min_message_size_(static_cast<size_t>(
+          std::max(1, kIpcSharedMemoryRingMinMessageSize.Get()))) {
   thread_safe_sender_ =
       std::make_unique<mojo::ThreadSafeForwarder<mojom::Channel>>(
           base::MakeRefCounted<ThreadSafeProxy>(
@@ -104,7 +135,8 @@ void MessagePipeReader::Close() {
     receiver_.reset();
 }
 
-bool MessagePipeReader::Send(std::unique_ptr<Message> message) {
+bool MessagePipeReader::Send(std::unique_ptr<Message> message,
+                             bool allow_message_ring) {
   CHECK(message->IsValid());
   TRACE_EVENT_WITH_FLOW0("toplevel.flow", "MessagePipeReader::Send",
                          message->flags(), TRACE_EVENT_FLAG_FLOW_OUT);
@@ -119,7 +151,8 @@ bool MessagePipeReader::Send(std::unique_ptr<Message> message) {
 
   base::span<const uint8_t> bytes(static_cast<const uint8_t*>(message->data()),
                                   message->size());
-  sender_->Receive(MessageView(bytes, std::move(handles)));
+  if (handles || !allow_message_ring || !SendThroughMessageRing(bytes))
+    sender_->Receive(MessageView(bytes, std::move(handles)));
   DVLOG(4) << "Send " << message->type() << ": " << message->size();
   return true;
 }
@@ -142,14 +175,48 @@ void MessagePipeReader::Receive(MessageView message_view) {
   }
   Message message(reinterpret_cast<const char*>(message_view.bytes().data()),
                   message_view.bytes().size());
+  DispatchMessage(message, message_view.TakeHandles());
+}
+
+void MessagePipeReader::SetMessageRing(base::UnsafeSharedMemoryRegion ring) {
+  if (ring_reader_) {
+    // The ring can only be set once.
+    ring_reader_.reset();
+    delegate_->OnBrokenDataReceived();
+    return;
+  }
+  ring_reader_ = SharedMemoryRingReader::Create(std::move(ring));
+  if (!ring_reader_)
+    delegate_->OnBrokenDataReceived();
+}
+
+void MessagePipeReader::ReceiveFromMessageRing(uint32_t size) {
+  base::span<const uint8_t> bytes;
+  if (ring_reader_)
+    bytes = ring_reader_->BeginRead(size);
+  if (bytes.empty()) {
+    delegate_->OnBrokenDataReceived();
+    return;
+  }
+  // The other end can still write to the ring, so copy the message out before
+  // validating it.
+  std::vector<char> buffer(bytes.begin(), bytes.end());
+  ring_reader_->EndRead();
+  Message message(buffer.data(), static_cast<int>(buffer.size()));
+  DispatchMessage(message, absl::nullopt);
+}
+
+void MessagePipeReader::DispatchMessage(
+    Message& message,
+    absl::optional<std::vector<mojo::native::SerializedHandlePtr>> handles) {
   if (!message.IsValid()) {
     delegate_->OnBrokenDataReceived();
     return;
   }
 
   DVLOG(4) << "Receive " << message.type() << ": " << message.size();
-  MojoResult write_result = ChannelMojo::WriteToMessageAttachmentSet(
-      message_view.TakeHandles(), &message);
+  MojoResult write_result =
+      ChannelMojo::WriteToMessageAttachmentSet(std::move(handles), &message);
   if (write_result != MOJO_RESULT_OK) {
     OnPipeError(write_result);
     return;
@@ -177,6 +244,29 @@ void MessagePipeReader::OnPipeError(MojoResult error) {
     delegate_->OnPipeError();
 }
 
+bool MessagePipeReader::SendThroughMessageRing(
+    base::span<const uint8_t> bytes) {
+  if (bytes.size() < message_ring_min_message_size_ ||
+      bytes.size() > message_ring_capacity_) {
+    return false;
+  }
+  if (!ring_writer_) {
+    base::UnsafeSharedMemoryRegion region;
+    ring_writer_ = SharedMemoryRingWriter::Create(message_ring_capacity_,
+                                                  &region);
+    if (!ring_writer_) {
+      // Don't try again.
+      message_ring_capacity_ = 0;
+      return false;
+    }
+    sender_->SetMessageRing(std::move(region));
+  }
+  if (!ring_writer_->Write(bytes))
+    return false;
+  sender_->ReceiveFromMessageRing(static_cast<uint32_t>(bytes.size()));
+  return true;
+}
+
 void MessagePipeReader::ForwardMessage(mojo::Message message) {
   sender_.internal_state()->ForwardMessage(std::move(message));
 }
@@ -15,6 +15,8 @@
 #include "base/component_export.h"
 #include "base/memory/raw_ptr.h"
 #include "base/memory/weak_ptr.h"
+#include "base/containers/span.h"
+#include "base/memory/unsafe_shared_memory_region.h"
 #include "base/process/process_handle.h"
 #include "base/threading/thread_checker.h"
 #include "ipc/ipc.mojom.h"
@@ -27,10 +29,14 @@
 #include "mojo/public/cpp/bindings/shared_remote.h"
 #include "mojo/public/cpp/system/core.h"
 #include "mojo/public/cpp/system/message_pipe.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
 
 namespace IPC {
 namespace internal {
 
+class SharedMemoryRingReader;
+class SharedMemoryRingWriter;
+
 // A helper class to handle bytestream directly over mojo::MessagePipe
 // in template-method pattern. MessagePipeReader manages the lifetime
 // of given MessagePipe and participates the event loop, and
@@ -44,8 +50,11 @@ namespace internal {
 //    The constructor automatically start listening on the pipe.
 //
 // All functions must be called on the IO thread, except for Send(), which can
-// be called on any thread. All |Delegate| functions will be called on the IO
-// thread.
+// be called on any thread as long as calls are sequenced. All |Delegate|
+// functions will be called on the IO thread.
+//
+// If features::kIpcSharedMemoryRing is enabled, large messages without
+// attachments are sent through a SharedMemoryRingWriter instead of the pipe.
 //
 class COMPONENT_EXPORT(IPC) MessagePipeReader : public mojom::Channel {
  public:
@@ -88,9 +97,13 @@ class COMPONENT_EXPORT(IPC) MessagePipeReader : public mojom::Channel {
   // Return true if the MessagePipe is alive.
   bool IsValid() { return sender_.is_bound(); }
 
-  // Sends an IPC::Message to the other end of the pipe. Safe to call from any
-  // thread.
-  bool Send(std::unique_ptr<Message> message);
+  // Sends an IPC::Message to the other end of the pipe. Can be called from any
+  // thread, but calls must not be concurrent: the ring that large messages go
+  // through has a single writer. |allow_message_ring| must be false while the
+  // channel is paused: the messages sent then are queued and can be overtaken
+  // by later ones, which must not happen to those that take their turn in the
+  // ring.
+  bool Send(std::unique_ptr<Message> message, bool allow_message_ring);
 
   // Requests an associated interface from the other end of the pipe.
   void GetRemoteInterface(mojo::GenericPendingAssociatedReceiver receiver);
@@ -106,9 +119,22 @@ class COMPONENT_EXPORT(IPC) MessagePipeReader : public mojom::Channel {
   // mojom::Channel:
   void SetPeerPid(int32_t peer_pid) override;
   void Receive(MessageView message_view) override;
+  void SetMessageRing(base::UnsafeSharedMemoryRegion ring) override;
+  void ReceiveFromMessageRing(uint32_t size) override;
   void GetAssociatedInterface(
       mojo::GenericPendingAssociatedReceiver receiver) override;
 
+  // Validates |message|, received through either of the above, and passes it
+  // on to |delegate_|.
+  void DispatchMessage(
+      Message& message,
+      absl::optional<std::vector<mojo::native::SerializedHandlePtr>> handles);
+
+  // Sends |bytes| through |ring_writer_| if they're eligible and fit, creating
+  // the ring first if needed. Returns false if they must be sent through the
+  // pipe instead.
+  bool SendThroughMessageRing(base::span<const uint8_t> bytes);
+
   void ForwardMessage(mojo::Message message);
 
   // |delegate_| is null once the message pipe is closed.
@@ -117,6 +143,15 @@ class COMPONENT_EXPORT(IPC) MessagePipeReader : public mojom::Channel {
   std::unique_ptr<mojo::ThreadSafeForwarder<mojom::Channel>>
       thread_safe_sender_;
   mojo::AssociatedReceiver<mojom::Channel> receiver_;
+
+  // The capacity of the ring to send large messages through, or 0 if that's
+  // disabled or the ring couldn't be created, and the size from which on
+  // messages are sent through it.
+  size_t message_ring_capacity_;
+  const size_t message_ring_min_message_size_;
+  std::unique_ptr<SharedMemoryRingWriter> ring_writer_;
+  std::unique_ptr<SharedMemoryRingReader> ring_reader_;
+
   base::ThreadChecker thread_checker_;
   base::WeakPtrFactory<MessagePipeReader> weak_ptr_factory_{this};
 };
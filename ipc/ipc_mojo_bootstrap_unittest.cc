@@ -95,6 +95,12 @@ class PeerPidReceiver : public IPC::mojom::Channel {
     EXPECT_EQ(expected_valid, message.IsValid());
   }
 
+  void SetMessageRing(base::UnsafeSharedMemoryRegion ring) override {
+    ADD_FAILURE();
+  }
+
+  void ReceiveFromMessageRing(uint32_t size) override { ADD_FAILURE(); }
+
   void GetAssociatedInterface(
       mojo::GenericPendingAssociatedReceiver receiver) override {}
 
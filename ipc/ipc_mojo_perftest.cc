@@ -13,10 +13,13 @@
 #include "base/run_loop.h"
 #include "base/strings/stringprintf.h"
 #include "base/synchronization/waitable_event.h"
+#include "base/test/perf_log.h"
 #include "base/test/perf_time_logger.h"
+#include "base/test/scoped_feature_list.h"
 #include "base/test/task_environment.h"
 #include "base/threading/thread.h"
 #include "base/threading/thread_task_runner_handle.h"
+#include "base/time/time.h"
 #include "build/build_config.h"
 #include "ipc/ipc_channel_mojo.h"
 #include "ipc/ipc_perftest_messages.h"
@@ -88,6 +91,8 @@ class PerformanceChannelListener : public Listener {
         base::StringPrintf("IPC_%s_Perf_%dx_%u", label_.c_str(), msg_count_,
                            static_cast<unsigned>(msg_size_));
     perf_logger_ = std::make_unique<base::PerfTimeLogger>(test_name.c_str());
+    test_name_ = test_name;
+    start_time_ = base::TimeTicks::Now();
     if (sync_) {
       for (; count_down_ > 0; --count_down_) {
         std::string response;
@@ -95,6 +100,7 @@ class PerformanceChannelListener : public Listener {
         DCHECK_EQ(response, payload_);
       }
       perf_logger_.reset();
+      LogLatencyAndThroughput();
       base::RunLoop::QuitCurrentWhenIdleDeprecated();
     } else {
       SendPong();
@@ -109,6 +115,7 @@ class PerformanceChannelListener : public Listener {
     count_down_--;
     if (count_down_ == 0) {
       perf_logger_.reset();  // Stop the perf timer now.
+      LogLatencyAndThroughput();
       base::RunLoop::QuitCurrentWhenIdleDeprecated();
       return;
     }
@@ -118,6 +125,17 @@ class PerformanceChannelListener : public Listener {
 
   void SendPong() { sender_->Send(new TestMsg_Ping(payload_)); }
 
+  // Logs the average round trip time, and the rate at which payload bytes were
+  // sent in either direction.
+  void LogLatencyAndThroughput() {
+    const double elapsed_us =
+        (base::TimeTicks::Now() - start_time_).InMicrosecondsF();
+    base::LogPerfResult((test_name_ + "_Latency").c_str(),
+                        elapsed_us / msg_count_, "us");
+    base::LogPerfResult((test_name_ + "_Throughput").c_str(),
+                        2.0 * msg_count_ * msg_size_ / elapsed_us, "MB/s");
+  }
+
  private:
   std::string label_;
   raw_ptr<Sender> sender_;
@@ -128,6 +146,8 @@ class PerformanceChannelListener : public Listener {
   int count_down_;
   std::string payload_;
   std::unique_ptr<base::PerfTimeLogger> perf_logger_;
+  std::string test_name_;
+  base::TimeTicks start_time_;
 };
 
 class PingPongTestParams {
@@ -175,6 +195,17 @@ std::vector<PingPongTestParams> GetDefaultTestParams() {
   return list;
 }
 
+std::vector<PingPongTestParams> GetLargeMessageTestParams() {
+  // Payloads from 1 KB to 4 MB, such as those sent for each frame.
+  std::vector<PingPongTestParams> list;
+  list.push_back(PingPongTestParams(1024, 500 * kMultiplier));
+  list.push_back(PingPongTestParams(16 * 1024, 200 * kMultiplier));
+  list.push_back(PingPongTestParams(256 * 1024, 50 * kMultiplier));
+  list.push_back(PingPongTestParams(1024 * 1024, 10 * kMultiplier));
+  list.push_back(PingPongTestParams(4 * 1024 * 1024, 3 * kMultiplier));
+  return list;
+}
+
 std::vector<InterfacePassingTestParams> GetDefaultInterfacePassingTestParams() {
   std::vector<InterfacePassingTestParams> list;
   list.push_back({500 * kMultiplier, 0});
@@ -190,18 +221,20 @@ class MojoChannelPerfTest : public IPCChannelMojoTestBase {
   MojoChannelPerfTest() = default;
   ~MojoChannelPerfTest() override = default;
 
-  void RunTestChannelProxyPingPong() {
-    Init("MojoPerfTestClient");
+  void RunTestChannelProxyPingPong(
+      const std::string& label,
+      const std::string& client_name,
+      const std::vector<PingPongTestParams>& params) {
+    Init(client_name);
 
     // Set up IPC channel and start client.
-    PerformanceChannelListener listener("ChannelProxy");
+    PerformanceChannelListener listener(label);
     auto channel_proxy = IPC::ChannelProxy::Create(
         TakeHandle().release(), IPC::Channel::MODE_SERVER, &listener,
         GetIOThreadTaskRunner(), base::ThreadTaskRunnerHandle::Get());
     listener.Init(channel_proxy.get());
 
     LockThreadAffinity thread_locker(kSharedCore);
-    std::vector<PingPongTestParams> params = GetDefaultTestParams();
     for (size_t i = 0; i < params.size(); i++) {
       listener.SetTestParams(params[i].message_count(),
                              params[i].message_size(), false);
@@ -220,11 +253,14 @@ class MojoChannelPerfTest : public IPCChannelMojoTestBase {
     channel_proxy.reset();
   }
 
-  void RunTestChannelProxySyncPing() {
-    Init("MojoPerfTestClient");
+  void RunTestChannelProxySyncPing(
+      const std::string& label,
+      const std::string& client_name,
+      const std::vector<PingPongTestParams>& params) {
+    Init(client_name);
 
     // Set up IPC channel and start client.
-    PerformanceChannelListener listener("ChannelProxy");
+    PerformanceChannelListener listener(label);
     base::WaitableEvent shutdown_event(
         base::WaitableEvent::ResetPolicy::MANUAL,
         base::WaitableEvent::InitialState::NOT_SIGNALED);
@@ -235,7 +271,6 @@ class MojoChannelPerfTest : public IPCChannelMojoTestBase {
     listener.Init(channel_proxy.get());
 
     LockThreadAffinity thread_locker(kSharedCore);
-    std::vector<PingPongTestParams> params = GetDefaultTestParams();
     for (size_t i = 0; i < params.size(); i++) {
       listener.SetTestParams(params[i].message_count(),
                              params[i].message_size(), true);
@@ -256,14 +291,54 @@ class MojoChannelPerfTest : public IPCChannelMojoTestBase {
 };
 
 TEST_F(MojoChannelPerfTest, ChannelProxyPingPong) {
-  RunTestChannelProxyPingPong();
+  RunTestChannelProxyPingPong("ChannelProxy", "MojoPerfTestClient",
+                              GetDefaultTestParams());
 
   base::RunLoop run_loop;
   run_loop.RunUntilIdle();
 }
 
 TEST_F(MojoChannelPerfTest, ChannelProxySyncPing) {
-  RunTestChannelProxySyncPing();
+  RunTestChannelProxySyncPing("ChannelProxy", "MojoPerfTestClient",
+                              GetDefaultTestParams());
+
+  base::RunLoop run_loop;
+  run_loop.RunUntilIdle();
+}
+
+// The large message tests compare sending messages through the pipe with
+// sending them through the shared memory ring, in both directions.
+TEST_F(MojoChannelPerfTest, ChannelProxyPingPongLargeMessages) {
+  RunTestChannelProxyPingPong("ChannelProxyLarge", "MojoPerfTestClient",
+                              GetLargeMessageTestParams());
+
+  base::RunLoop run_loop;
+  run_loop.RunUntilIdle();
+}
+
+TEST_F(MojoChannelPerfTest, ChannelProxyPingPongSharedMemoryRing) {
+  base::test::ScopedFeatureList feature_list;
+  EnableSharedMemoryRing(&feature_list);
+  RunTestChannelProxyPingPong("ChannelProxyRing", "MojoPerfTestRingClient",
+                              GetLargeMessageTestParams());
+
+  base::RunLoop run_loop;
+  run_loop.RunUntilIdle();
+}
+
+TEST_F(MojoChannelPerfTest, ChannelProxySyncPingLargeMessages) {
+  RunTestChannelProxySyncPing("ChannelProxyLarge", "MojoPerfTestClient",
+                              GetLargeMessageTestParams());
+
+  base::RunLoop run_loop;
+  run_loop.RunUntilIdle();
+}
+
+TEST_F(MojoChannelPerfTest, ChannelProxySyncPingSharedMemoryRing) {
+  base::test::ScopedFeatureList feature_list;
+  EnableSharedMemoryRing(&feature_list);
+  RunTestChannelProxySyncPing("ChannelProxyRing", "MojoPerfTestRingClient",
+                              GetLargeMessageTestParams());
 
   base::RunLoop run_loop;
   run_loop.RunUntilIdle();
@@ -281,6 +356,20 @@ MULTIPROCESS_TEST_MAIN(MojoPerfTestClientTestChildMain) {
   return rv;
 }
 
+MULTIPROCESS_TEST_MAIN(MojoPerfTestRingClientTestChildMain) {
+  base::test::ScopedFeatureList feature_list;
+  EnableSharedMemoryRing(&feature_list);
+  MojoPerfTestClient client;
+  int rv = mojo::core::test::MultiprocessTestHelper::RunClientMain(
+      base::BindOnce(&MojoPerfTestClient::Run, base::Unretained(&client)),
+      true /* pass_pipe_ownership_to_main */);
+
+  base::RunLoop run_loop;
+  run_loop.RunUntilIdle();
+
+  return rv;
+}
+
 class MojoInterfacePerfTest : public mojo::core::test::MojoTestBase {
  public:
   MojoInterfacePerfTest() : message_count_(0), count_down_(0) {}
@@ -7,6 +7,8 @@
 #include "base/ignore_result.h"
 #include "base/logging.h"
 #include "base/run_loop.h"
+#include "base/test/scoped_feature_list.h"
+#include "ipc/features.h"
 #include "ipc/ipc_channel_proxy.h"
 #include "ipc/ipc_perftest_messages.h"
 #include "mojo/core/embedder/embedder.h"
@@ -20,6 +22,11 @@ scoped_refptr<base::SingleThreadTaskRunner> GetIOThreadTaskRunner() {
       static_cast<base::SingleThreadTaskRunner*>(runner.get()));
 }
 
+void EnableSharedMemoryRing(base::test::ScopedFeatureList* feature_list) {
+  feature_list->InitAndEnableFeatureWithParameters(
+      features::kIpcSharedMemoryRing, {{"MinMessageSize", "1024"}});
+}
+
 ChannelReflectorListener::ChannelReflectorListener() : channel_(nullptr) {
   VLOG(1) << "Client listener up";
 }
@@ -31,10 +31,20 @@
 #include <windows.h>
 #endif
 
+namespace base {
+namespace test {
+class ScopedFeatureList;
+}  // namespace test
+}  // namespace base
+
 namespace IPC {
 
 scoped_refptr<base::SingleThreadTaskRunner> GetIOThreadTaskRunner();
 
+// Makes ChannelMojo send all but the smallest messages through a ring buffer
+// in shared memory, see features::kIpcSharedMemoryRing.
+void EnableSharedMemoryRing(base::test::ScopedFeatureList* feature_list);
+
 // This channel listener just replies to all messages with the exact same
 // message. It assumes each message has one string parameter. When the string
 // "quit" is sent, it will exit.
@@ -0,0 +1,150 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ipc/ipc_shared_memory_ring.h"
+
+#include <string.h>
+
+#include <atomic>
+#include <utility>
+
+#include "base/bits.h"
+#include "base/check_op.h"
+#include "base/memory/ptr_util.h"
+
+namespace IPC {
+namespace internal {
+
+namespace {
+
+// The ring starts with the reader's position, which only the reader writes,
+// followed by the messages from |kDataOffset| on, which keeps them off the
+// position's cache line.
+using SharedPosition = std::atomic<uint32_t>;
+static_assert(SharedPosition::is_always_lock_free,
+              "The position is shared between processes");
+constexpr size_t kDataOffset = 64;
+
+SharedPosition* GetSharedReadPosition(
+    const base::WritableSharedMemoryMapping& mapping) {
+  return reinterpret_cast<SharedPosition*>(mapping.memory());
+}
+
+uint8_t* GetData(const base::WritableSharedMemoryMapping& mapping) {
+  return static_cast<uint8_t*>(mapping.memory()) + kDataOffset;
+}
+
+// Returns the offset into the ring of a message of |size| bytes written at
+// |position|, skipping ahead to the start of the ring if the message would
+// otherwise wrap around its end, and sets |*end_position| to the position
+// following the message.
+size_t GetMessageOffset(uint32_t position,
+                        size_t size,
+                        size_t capacity,
+                        uint32_t* end_position) {
+  DCHECK_LE(size, capacity);
+  size_t offset = position & (capacity - 1);
+  if (offset + size > capacity) {
+    position += static_cast<uint32_t>(capacity - offset);
+    offset = 0;
+  }
+  *end_position = position + static_cast<uint32_t>(size);
+  return offset;
+}
+
+}  // namespace
+
+// static
+std::unique_ptr<SharedMemoryRingWriter> SharedMemoryRingWriter::Create(
+    size_t capacity,
+    base::UnsafeSharedMemoryRegion* region) {
+  DCHECK(base::bits::IsPowerOfTwo(capacity));
+  DCHECK_LE(capacity, kMaxCapacity);
+  base::UnsafeSharedMemoryRegion new_region =
+      base::UnsafeSharedMemoryRegion::Create(kDataOffset + capacity);
+  if (!new_region.IsValid())
+    return nullptr;
+  base::WritableSharedMemoryMapping mapping = new_region.Map();
+  if (!mapping.IsValid())
+    return nullptr;
+  // New shared memory is zero-filled, which is the initial read position.
+  *region = std::move(new_region);
+  return base::WrapUnique(
+      new SharedMemoryRingWriter(std::move(mapping), capacity));
+}
+
+SharedMemoryRingWriter::SharedMemoryRingWriter(
+    base::WritableSharedMemoryMapping mapping,
+    size_t capacity)
+    : mapping_(std::move(mapping)), capacity_(capacity) {}
+
+SharedMemoryRingWriter::~SharedMemoryRingWriter() = default;
+
+bool SharedMemoryRingWriter::Write(base::span<const uint8_t> bytes) {
+  DCHECK(!bytes.empty());
+  if (bytes.size() > capacity_)
+    return false;
+
+  uint32_t end_position;
+  const size_t offset =
+      GetMessageOffset(write_position_, bytes.size(), capacity_, &end_position);
+
+  // The acquire pairs with the reader's release once it is done with the
+  // space, so it isn't overwritten while being read. The reader's position
+  // can't be trusted, but as long as it's consistent with what was written,
+  // the worst the reader can do is have its own messages overwritten, so only
+  // positions that would let the space in use overflow are rejected.
+  const uint32_t read_position =
+      GetSharedReadPosition(mapping_)->load(std::memory_order_acquire);
+  if (write_position_ - read_position > capacity_ ||
+      end_position - read_position > capacity_) {
+    return false;
+  }
+
+  memcpy(GetData(mapping_) + offset, bytes.data(), bytes.size());
+  write_position_ = end_position;
+  return true;
+}
+
+// static
+std::unique_ptr<SharedMemoryRingReader> SharedMemoryRingReader::Create(
+    base::UnsafeSharedMemoryRegion region) {
+  if (!region.IsValid() || region.GetSize() <= kDataOffset)
+    return nullptr;
+  const size_t capacity = region.GetSize() - kDataOffset;
+  if (!base::bits::IsPowerOfTwo(capacity) ||
+      capacity > SharedMemoryRingWriter::kMaxCapacity) {
+    return nullptr;
+  }
+  base::WritableSharedMemoryMapping mapping = region.Map();
+  if (!mapping.IsValid())
+    return nullptr;
+  return base::WrapUnique(
+      new SharedMemoryRingReader(std::move(mapping), capacity));
+}
+
+SharedMemoryRingReader::SharedMemoryRingReader(
+    base::WritableSharedMemoryMapping mapping,
+    size_t capacity)
+    : mapping_(std::move(mapping)), capacity_(capacity) {}
+
+SharedMemoryRingReader::~SharedMemoryRingReader() = default;
+
+base::span<const uint8_t> SharedMemoryRingReader::BeginRead(size_t size) {
+  DCHECK_EQ(read_position_, end_of_read_position_);
+  if (size == 0 || size > capacity_)
+    return base::span<const uint8_t>();
+  const size_t offset =
+      GetMessageOffset(read_position_, size, capacity_, &end_of_read_position_);
+  return base::make_span(GetData(mapping_) + offset, size);
+}
+
+void SharedMemoryRingReader::EndRead() {
+  read_position_ = end_of_read_position_;
+  GetSharedReadPosition(mapping_)->store(read_position_,
+                                         std::memory_order_release);
+}
+
+}  // namespace internal
+}  // namespace IPC
@@ -0,0 +1,111 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IPC_IPC_SHARED_MEMORY_RING_H_
+#define IPC_IPC_SHARED_MEMORY_RING_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+
+#include "base/component_export.h"
+#include "base/containers/span.h"
+#include "base/memory/shared_memory_mapping.h"
+#include "base/memory/unsafe_shared_memory_region.h"
+
+namespace IPC {
+namespace internal {
+
+// A byte ring buffer in shared memory which carries the contents of large
+// messages from one end of a channel to the other, so that they are copied
+// into and out of the ring once instead of going through the message pipe.
+//
+// The writer copies each message into the ring and then tells the reader its
+// size through the message pipe, which also keeps messages sent through the
+// ring in order with those sent through the pipe directly. Each message is
+// stored contiguously: one that would wrap around the end of the ring starts
+// over at its beginning instead. Both ends track their own position and lay
+// out messages the same way, so the only position that's shared is the
+// reader's, which tells the writer which space it can reuse. Neither end
+// trusts anything the other writes to the ring beyond message contents.
+//
+// Each end must be used on a single sequence.
+
+class COMPONENT_EXPORT(IPC) SharedMemoryRingWriter {
+ public:
+  // The largest supported capacity.
+  static constexpr size_t kMaxCapacity = size_t{1} << 30;
+
+  // Creates a ring holding up to |capacity| bytes of messages, which must be a
+  // power of two no larger than kMaxCapacity. On success, |*region| receives
+  // the region to pass to SharedMemoryRingReader::Create() on the other end.
+  // Returns null if the shared memory can't be allocated.
+  static std::unique_ptr<SharedMemoryRingWriter> Create(
+      size_t capacity,
+      base::UnsafeSharedMemoryRegion* region);
+
+  SharedMemoryRingWriter(const SharedMemoryRingWriter&) = delete;
+  SharedMemoryRingWriter& operator=(const SharedMemoryRingWriter&) = delete;
+
+  ~SharedMemoryRingWriter();
+
+  size_t capacity() const { return capacity_; }
+
+  // Copies the non-empty |bytes| into the ring. Returns false without writing
+  // anything if there is no room for them until the reader catches up, or
+  // ever, in which case the message needs to be sent some other way.
+  bool Write(base::span<const uint8_t> bytes);
+
+ private:
+  SharedMemoryRingWriter(base::WritableSharedMemoryMapping mapping,
+                         size_t capacity);
+
+  base::WritableSharedMemoryMapping mapping_;
+  const size_t capacity_;
+
+  // The total number of bytes written, wrapping around at 2^32. As the
+  // capacity is a power of two, this also gives the offset of the next write.
+  uint32_t write_position_ = 0;
+};
+
+class COMPONENT_EXPORT(IPC) SharedMemoryRingReader {
+ public:
+  // Maps the ring in |region|, created by SharedMemoryRingWriter::Create() on
+  // the other end. Returns null if |region| isn't a valid ring.
+  static std::unique_ptr<SharedMemoryRingReader> Create(
+      base::UnsafeSharedMemoryRegion region);
+
+  SharedMemoryRingReader(const SharedMemoryRingReader&) = delete;
+  SharedMemoryRingReader& operator=(const SharedMemoryRingReader&) = delete;
+
+  ~SharedMemoryRingReader();
+
+  // Returns the next message, given that the writer said it's |size| bytes
+  // long, or an empty span if no message of that size fits into the ring. The
+  // returned bytes stay mapped until EndRead(), but as the other end can still
+  // write to them, they must be copied before they are validated.
+  base::span<const uint8_t> BeginRead(size_t size);
+
+  // Lets the writer reuse the space of the message returned by the last call
+  // to BeginRead().
+  void EndRead();
+
+ private:
+  SharedMemoryRingReader(base::WritableSharedMemoryMapping mapping,
+                         size_t capacity);
+
+  base::WritableSharedMemoryMapping mapping_;
+  const size_t capacity_;
+
+  // Like SharedMemoryRingWriter::write_position_, for the start of the next
+  // message and for the end of the one being read, respectively.
+  uint32_t read_position_ = 0;
+  uint32_t end_of_read_position_ = 0;
+};
+
+}  // namespace internal
+}  // namespace IPC
+
+#endif  // IPC_IPC_SHARED_MEMORY_RING_H_
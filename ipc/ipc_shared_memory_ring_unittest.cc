@@ -0,0 +1,128 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ipc/ipc_shared_memory_ring.h"
+
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "base/memory/shared_memory_mapping.h"
+#include "base/memory/unsafe_shared_memory_region.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace IPC {
+namespace internal {
+namespace {
+
+constexpr size_t kCapacity = 1024;
+
+std::vector<uint8_t> MakeMessage(size_t size, uint8_t seed) {
+  std::vector<uint8_t> message(size);
+  for (size_t i = 0; i < size; ++i)
+    message[i] = static_cast<uint8_t>(seed + i);
+  return message;
+}
+
+class SharedMemoryRingTest : public testing::Test {
+ public:
+  void SetUp() override {
+    base::UnsafeSharedMemoryRegion region;
+    writer_ = SharedMemoryRingWriter::Create(kCapacity, &region);
+    ASSERT_TRUE(writer_);
+    // Keep a mapping of the ring to tamper with it as the other end could.
+    mapping_ = region.Map();
+    ASSERT_TRUE(mapping_.IsValid());
+    reader_ = SharedMemoryRingReader::Create(std::move(region));
+    ASSERT_TRUE(reader_);
+  }
+
+  // Reads the next message and checks that it's |expected|.
+  void ExpectRead(const std::vector<uint8_t>& expected) {
+    base::span<const uint8_t> bytes = reader_->BeginRead(expected.size());
+    ASSERT_EQ(expected.size(), bytes.size());
+    EXPECT_EQ(expected, std::vector<uint8_t>(bytes.begin(), bytes.end()));
+    reader_->EndRead();
+  }
+
+ protected:
+  std::unique_ptr<SharedMemoryRingWriter> writer_;
+  std::unique_ptr<SharedMemoryRingReader> reader_;
+  base::WritableSharedMemoryMapping mapping_;
+};
+
+TEST_F(SharedMemoryRingTest, WriteAndRead) {
+  EXPECT_EQ(kCapacity, writer_->capacity());
+  const std::vector<uint8_t> first = MakeMessage(100, 1);
+  const std::vector<uint8_t> second = MakeMessage(kCapacity - 100, 2);
+  EXPECT_TRUE(writer_->Write(first));
+  EXPECT_TRUE(writer_->Write(second));
+  ExpectRead(first);
+  ExpectRead(second);
+}
+
+TEST_F(SharedMemoryRingTest, WrapsAround) {
+  // Messages that don't fit before the end of the ring start over at its
+  // beginning, for many rounds through the ring.
+  for (uint8_t i = 0; i < 200; ++i) {
+    const std::vector<uint8_t> message = MakeMessage(300 + i, i);
+    ASSERT_TRUE(writer_->Write(message));
+    ExpectRead(message);
+  }
+}
+
+TEST_F(SharedMemoryRingTest, FullUntilRead) {
+  const std::vector<uint8_t> first = MakeMessage(600, 1);
+  const std::vector<uint8_t> second = MakeMessage(600, 2);
+  EXPECT_TRUE(writer_->Write(first));
+  EXPECT_FALSE(writer_->Write(second));
+
+  // The space is reusable once the reader is done with it, not before.
+  base::span<const uint8_t> bytes = reader_->BeginRead(first.size());
+  ASSERT_EQ(first.size(), bytes.size());
+  EXPECT_FALSE(writer_->Write(second));
+  reader_->EndRead();
+  EXPECT_TRUE(writer_->Write(second));
+  ExpectRead(second);
+}
+
+TEST_F(SharedMemoryRingTest, TooLarge) {
+  EXPECT_FALSE(writer_->Write(MakeMessage(kCapacity + 1, 0)));
+  EXPECT_TRUE(reader_->BeginRead(kCapacity + 1).empty());
+  EXPECT_TRUE(reader_->BeginRead(0).empty());
+}
+
+TEST_F(SharedMemoryRingTest, RejectsInconsistentReadPosition) {
+  auto* read_position =
+      reinterpret_cast<std::atomic<uint32_t>*>(mapping_.memory());
+  const std::vector<uint8_t> message = MakeMessage(10, 0);
+
+  // A reader claiming to have read more than was written must not make the
+  // writer overwrite unread messages.
+  EXPECT_TRUE(writer_->Write(message));
+  read_position->store(kCapacity);
+  EXPECT_FALSE(writer_->Write(message));
+  read_position->store(11);
+  EXPECT_FALSE(writer_->Write(message));
+
+  read_position->store(0);
+  EXPECT_TRUE(writer_->Write(message));
+}
+
+TEST(SharedMemoryRingReaderTest, RejectsInvalidRegions) {
+  EXPECT_FALSE(
+      SharedMemoryRingReader::Create(base::UnsafeSharedMemoryRegion()));
+  // Too small to hold anything.
+  EXPECT_FALSE(SharedMemoryRingReader::Create(
+      base::UnsafeSharedMemoryRegion::Create(16)));
+  // Not a power of two after the header.
+  EXPECT_FALSE(SharedMemoryRingReader::Create(
+      base::UnsafeSharedMemoryRegion::Create(4096)));
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace IPC
@@ -12,13 +12,23 @@
 #include <utility>
 
 #include "base/check_op.h"
+#include "base/cpu.h"
 #include "base/memory/ptr_util.h"
 #include "base/notreached.h"
 #include "base/numerics/safe_conversions.h"
+#include "build/build_config.h"
 #include "media/base/audio_parameters.h"
 #include "media/base/limits.h"
 #include "media/base/vector_math.h"
 
+// NaCl does not allow intrinsics.
+#if defined(ARCH_CPU_X86_FAMILY) && !defined(OS_NACL)
+#include <immintrin.h>
+#include <avxintrin.h>
+#include <avx2intrin.h>
+#define AUDIO_BUS_AVX2
+#endif
+
 namespace media {
 
 static bool IsAligned(void* ptr) {
@@ -63,6 +73,264 @@ void AudioBus::CheckOverflow(int start_frame, int frames, int total_frames) {
   CHECK_GE(sum, 0);
 }
 
+#if defined(AUDIO_BUS_AVX2)
+namespace {
+
+__attribute__((target("avx2"))) __m256i LoadInt32x8(const uint8_t* source) {
+  return _mm256_cvtepu8_epi32(
+      _mm_loadl_epi64(reinterpret_cast<const __m128i*>(source)));
+}
+
+__attribute__((target("avx2"))) __m256i LoadInt32x8(const int16_t* source) {
+  return _mm256_cvtepi16_epi32(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(source)));
+}
+
+__attribute__((target("avx2"))) __m256i LoadInt32x8(const int32_t* source) {
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source));
+}
+
+// Packs 8 values which are in the range of int16_t to the low half.
+__attribute__((target("avx2"))) __m128i PackInt16x8(__m256i values) {
+  return _mm256_castsi256_si128(
+      _mm256_permute4x64_epi64(_mm256_packs_epi32(values, values), 0x08));
+}
+
+__attribute__((target("avx2"))) void StoreInt32x8(__m256i values,
+                                                  uint8_t* dest) {
+  const __m128i values_x16 = PackInt16x8(values);
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(dest),
+                   _mm_packus_epi16(values_x16, values_x16));
+}
+
+__attribute__((target("avx2"))) void StoreInt32x8(__m256i values,
+                                                  int16_t* dest) {
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), PackInt16x8(values));
+}
+
+__attribute__((target("avx2"))) void StoreInt32x8(__m256i values,
+                                                  int32_t* dest) {
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest), values);
+}
+
+// Loads and stores 8 samples at a time as floats, converting them the same
+// way as FixedSampleTypeTraits<SampleType>, including the clipping.
+template <typename SampleType>
+struct FixedSamplesAVX2 {
+  using Traits = FixedSampleTypeTraits<SampleType>;
+  using ValueType = SampleType;
+
+  static constexpr float kForPositiveInput =
+      static_cast<float>(Traits::kMaxValue) -
+      static_cast<float>(Traits::kZeroPointValue);
+  static constexpr float kForNegativeInput =
+      static_cast<float>(Traits::kZeroPointValue) -
+      static_cast<float>(Traits::kMinValue);
+
+  __attribute__((target("avx2"))) static __m256 Load(const SampleType* source) {
+    const __m256 offset_values = _mm256_cvtepi32_ps(_mm256_sub_epi32(
+        LoadInt32x8(source), _mm256_set1_epi32(Traits::kZeroPointValue)));
+    const __m256 is_negative =
+        _mm256_cmp_ps(offset_values, _mm256_setzero_ps(), _CMP_LT_OQ);
+    const __m256 inverse_scale =
+        _mm256_blendv_ps(_mm256_set1_ps(1.0f / kForPositiveInput),
+                         _mm256_set1_ps(1.0f / kForNegativeInput), is_negative);
+    return _mm256_mul_ps(offset_values, inverse_scale);
+  }
+
+  __attribute__((target("avx2"))) static void Store(__m256 values,
+                                                    SampleType* dest) {
+    const __m256 is_negative =
+        _mm256_cmp_ps(values, _mm256_setzero_ps(), _CMP_LT_OQ);
+    const __m256 scale =
+        _mm256_blendv_ps(_mm256_set1_ps(kForPositiveInput),
+                         _mm256_set1_ps(kForNegativeInput), is_negative);
+    __m256i samples = _mm256_cvttps_epi32(_mm256_add_ps(
+        _mm256_mul_ps(values, scale),
+        _mm256_set1_ps(static_cast<float>(Traits::kZeroPointValue))));
+    // Apply clipping, which also keeps 1.0 from overflowing.
+    const __m256 is_min = _mm256_cmp_ps(
+        values, _mm256_set1_ps(Float32SampleTypeTraits::kMinValue), _CMP_LE_OQ);
+    const __m256 is_max = _mm256_cmp_ps(
+        values, _mm256_set1_ps(Float32SampleTypeTraits::kMaxValue), _CMP_GE_OQ);
+    samples = _mm256_blendv_epi8(samples, _mm256_set1_epi32(Traits::kMinValue),
+                                 _mm256_castps_si256(is_min));
+    samples = _mm256_blendv_epi8(samples, _mm256_set1_epi32(Traits::kMaxValue),
+                                 _mm256_castps_si256(is_max));
+    StoreInt32x8(samples, dest);
+  }
+};
+
+// Same as FixedSamplesAVX2, for Float32SampleTypeTraits if |kClip| and
+// Float32SampleTypeTraitsNoClip otherwise.
+template <bool kClip>
+struct Float32SamplesAVX2 {
+  using ValueType = float;
+
+  __attribute__((target("avx2"))) static __m256 Load(const float* source) {
+    return _mm256_loadu_ps(source);
+  }
+
+  __attribute__((target("avx2"))) static void Store(__m256 values,
+                                                    float* dest) {
+    if (kClip) {
+      // _mm256_max_ps() returns its second operand for NaNs, which are
+      // clipped to the minimum value like the traits do.
+      values = _mm256_min_ps(
+          _mm256_max_ps(values,
+                        _mm256_set1_ps(Float32SampleTypeTraits::kMinValue)),
+          _mm256_set1_ps(Float32SampleTypeTraits::kMaxValue));
+    }
+    _mm256_storeu_ps(dest, values);
+  }
+};
+
+// Deinterleaves mono or stereo |source| into |dest|, 8 frames at a time, and
+// returns the number of frames converted.
+template <class Samples>
+__attribute__((target("avx2"))) int DeinterleaveAVX2(
+    const typename Samples::ValueType* source,
+    int channels,
+    int frames,
+    float* const dest[]) {
+  const int last_frame = frames - frames % 8;
+  if (channels == 1) {
+    for (int i = 0; i < last_frame; i += 8)
+      _mm256_storeu_ps(dest[0] + i, Samples::Load(source + i));
+    return last_frame;
+  }
+
+  DCHECK_EQ(channels, 2);
+  for (int i = 0; i < last_frame; i += 8) {
+    // Frames 0 to 3 and 4 to 7, interleaved.
+    const __m256 a = Samples::Load(source + 2 * i);
+    const __m256 b = Samples::Load(source + 2 * i + 8);
+    // L0 L1 L4 L5 | L2 L3 L6 L7, and the same for the right channel.
+    const __m256 left = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+    const __m256 right = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+    _mm256_storeu_ps(dest[0] + i,
+                     _mm256_castpd_ps(_mm256_permute4x64_pd(
+                         _mm256_castps_pd(left), _MM_SHUFFLE(3, 1, 2, 0))));
+    _mm256_storeu_ps(dest[1] + i,
+                     _mm256_castpd_ps(_mm256_permute4x64_pd(
+                         _mm256_castps_pd(right), _MM_SHUFFLE(3, 1, 2, 0))));
+  }
+  return last_frame;
+}
+
+// Interleaves mono or stereo |source| into |dest|, 8 frames at a time, and
+// returns the number of frames converted.
+template <class Samples>
+__attribute__((target("avx2"))) int InterleaveAVX2(
+    const float* const source[],
+    int channels,
+    int frames,
+    typename Samples::ValueType* dest) {
+  const int last_frame = frames - frames % 8;
+  if (channels == 1) {
+    for (int i = 0; i < last_frame; i += 8)
+      Samples::Store(_mm256_loadu_ps(source[0] + i), dest + i);
+    return last_frame;
+  }
+
+  DCHECK_EQ(channels, 2);
+  for (int i = 0; i < last_frame; i += 8) {
+    const __m256 left = _mm256_loadu_ps(source[0] + i);
+    const __m256 right = _mm256_loadu_ps(source[1] + i);
+    // L0 R0 L1 R1 | L4 R4 L5 R5 and L2 R2 L3 R3 | L6 R6 L7 R7.
+    const __m256 low = _mm256_unpacklo_ps(left, right);
+    const __m256 high = _mm256_unpackhi_ps(left, right);
+    Samples::Store(_mm256_permute2f128_ps(low, high, 0x20), dest + 2 * i);
+    Samples::Store(_mm256_permute2f128_ps(low, high, 0x31), dest + 2 * i + 8);
+  }
+  return last_frame;
+}
+
+}  // namespace
+#endif  // defined(AUDIO_BUS_AVX2)
+
+// static
+int AudioBus::CopyConvertFromInterleavedSourceToAudioBusVectorized(
+    VectorizedSampleFormat format,
+    const void* source_buffer,
+    int write_offset_in_frames,
+    int num_frames_to_write,
+    AudioBus* dest) {
+#if defined(AUDIO_BUS_AVX2)
+  const int channels = dest->channels();
+  if (channels > 2 || !base::CPU::CanUseAVX2())
+    return 0;
+  float* const dest_channels[] = {
+      dest->channel(0) + write_offset_in_frames,
+      channels == 2 ? dest->channel(1) + write_offset_in_frames : nullptr};
+  switch (format) {
+    case VectorizedSampleFormat::kNone:
+      break;
+    case VectorizedSampleFormat::kUnsignedInt8:
+      return DeinterleaveAVX2<FixedSamplesAVX2<uint8_t>>(
+          static_cast<const uint8_t*>(source_buffer), channels,
+          num_frames_to_write, dest_channels);
+    case VectorizedSampleFormat::kSignedInt16:
+      return DeinterleaveAVX2<FixedSamplesAVX2<int16_t>>(
+          static_cast<const int16_t*>(source_buffer), channels,
+          num_frames_to_write, dest_channels);
+    case VectorizedSampleFormat::kSignedInt32:
+      return DeinterleaveAVX2<FixedSamplesAVX2<int32_t>>(
+          static_cast<const int32_t*>(source_buffer), channels,
+          num_frames_to_write, dest_channels);
+    case VectorizedSampleFormat::kFloat32:
+    case VectorizedSampleFormat::kFloat32NoClip:
+      // Floats aren't clipped when read.
+      return DeinterleaveAVX2<Float32SamplesAVX2<false>>(
+          static_cast<const float*>(source_buffer), channels,
+          num_frames_to_write, dest_channels);
+  }
+#endif
+  return 0;
+}
+
+// static
+int AudioBus::CopyConvertFromAudioBusToInterleavedTargetVectorized(
+    VectorizedSampleFormat format,
+    const AudioBus* source,
+    int read_offset_in_frames,
+    int num_frames_to_read,
+    void* dest_buffer) {
+#if defined(AUDIO_BUS_AVX2)
+  const int channels = source->channels();
+  if (channels > 2 || !base::CPU::CanUseAVX2())
+    return 0;
+  const float* const source_channels[] = {
+      source->channel(0) + read_offset_in_frames,
+      channels == 2 ? source->channel(1) + read_offset_in_frames : nullptr};
+  switch (format) {
+    case VectorizedSampleFormat::kNone:
+      break;
+    case VectorizedSampleFormat::kUnsignedInt8:
+      return InterleaveAVX2<FixedSamplesAVX2<uint8_t>>(
+          source_channels, channels, num_frames_to_read,
+          static_cast<uint8_t*>(dest_buffer));
+    case VectorizedSampleFormat::kSignedInt16:
+      return InterleaveAVX2<FixedSamplesAVX2<int16_t>>(
+          source_channels, channels, num_frames_to_read,
+          static_cast<int16_t*>(dest_buffer));
+    case VectorizedSampleFormat::kSignedInt32:
+      return InterleaveAVX2<FixedSamplesAVX2<int32_t>>(
+          source_channels, channels, num_frames_to_read,
+          static_cast<int32_t*>(dest_buffer));
+    case VectorizedSampleFormat::kFloat32:
+      return InterleaveAVX2<Float32SamplesAVX2<true>>(
+          source_channels, channels, num_frames_to_read,
+          static_cast<float*>(dest_buffer));
+    case VectorizedSampleFormat::kFloat32NoClip:
+      return InterleaveAVX2<Float32SamplesAVX2<false>>(
+          source_channels, channels, num_frames_to_read,
+          static_cast<float*>(dest_buffer));
+  }
+#endif
+  return 0;
+}
+
 AudioBus::AudioBus(int channels, int frames)
     : frames_(frames), is_wrapper_(false) {
   ValidateConfig(channels, frames_);
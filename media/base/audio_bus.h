@@ -8,6 +8,7 @@
 #include <stdint.h>
 
 #include <memory>
+#include <type_traits>
 #include <vector>
 
 #include "base/callback.h"
@@ -199,6 +200,49 @@ class MEDIA_SHMEM_EXPORT AudioBus {
 
   static void CheckOverflow(int start_frame, int frames, int total_frames);
 
+  // The sample formats which the conversions below have vectorized versions
+  // for.
+  enum class VectorizedSampleFormat {
+    kNone,
+    kUnsignedInt8,
+    kSignedInt16,
+    kSignedInt32,
+    kFloat32,
+    kFloat32NoClip,
+  };
+
+  template <class SampleTypeTraits>
+  static constexpr VectorizedSampleFormat GetVectorizedSampleFormat() {
+    if (std::is_same<SampleTypeTraits, UnsignedInt8SampleTypeTraits>::value)
+      return VectorizedSampleFormat::kUnsignedInt8;
+    if (std::is_same<SampleTypeTraits, SignedInt16SampleTypeTraits>::value)
+      return VectorizedSampleFormat::kSignedInt16;
+    if (std::is_same<SampleTypeTraits, SignedInt32SampleTypeTraits>::value)
+      return VectorizedSampleFormat::kSignedInt32;
+    if (std::is_same<SampleTypeTraits, Float32SampleTypeTraits>::value)
+      return VectorizedSampleFormat::kFloat32;
+    if (std::is_same<SampleTypeTraits, Float32SampleTypeTraitsNoClip>::value)
+      return VectorizedSampleFormat::kFloat32NoClip;
+    return VectorizedSampleFormat::kNone;
+  }
+
+  // Vectorized versions of the conversions below, for mono and stereo on CPUs
+  // with AVX2. They convert the frames from the first one in blocks, and
+  // return the number of frames converted, which may be 0. The caller
+  // converts the remaining frames. The buffers hold samples of |format|.
+  static int CopyConvertFromInterleavedSourceToAudioBusVectorized(
+      VectorizedSampleFormat format,
+      const void* source_buffer,
+      int write_offset_in_frames,
+      int num_frames_to_write,
+      AudioBus* dest);
+  static int CopyConvertFromAudioBusToInterleavedTargetVectorized(
+      VectorizedSampleFormat format,
+      const AudioBus* source,
+      int read_offset_in_frames,
+      int num_frames_to_read,
+      void* dest_buffer);
+
   template <class SourceSampleTypeTraits>
   static void CopyConvertFromInterleavedSourceToAudioBus(
       const typename SourceSampleTypeTraits::ValueType* source_buffer,
@@ -279,8 +323,6 @@ void AudioBus::ToInterleavedPartial(
       this, read_offset_in_frames, num_frames_to_read, dest);
 }
 
-// TODO(chfremer): Consider using vector instructions to speed this up,
-//                 https://crbug.com/619628
 template <class SourceSampleTypeTraits>
 void AudioBus::CopyConvertFromInterleavedSourceToAudioBus(
     const typename SourceSampleTypeTraits::ValueType* source_buffer,
@@ -288,6 +330,17 @@ void AudioBus::CopyConvertFromInterleavedSourceToAudioBus(
     int num_frames_to_write,
     AudioBus* dest) {
   const int channels = dest->channels();
+  constexpr VectorizedSampleFormat kFormat =
+      GetVectorizedSampleFormat<SourceSampleTypeTraits>();
+  if (kFormat != VectorizedSampleFormat::kNone) {
+    const int converted_frames =
+        CopyConvertFromInterleavedSourceToAudioBusVectorized(
+            kFormat, source_buffer, write_offset_in_frames,
+            num_frames_to_write, dest);
+    source_buffer += converted_frames * channels;
+    write_offset_in_frames += converted_frames;
+    num_frames_to_write -= converted_frames;
+  }
   for (int ch = 0; ch < channels; ++ch) {
     float* channel_data = dest->channel(ch);
     for (int target_frame_index = write_offset_in_frames,
@@ -301,8 +354,6 @@ void AudioBus::CopyConvertFromInterleavedSourceToAudioBus(
   }
 }
 
-// TODO(chfremer): Consider using vector instructions to speed this up,
-//                 https://crbug.com/619628
 template <class TargetSampleTypeTraits>
 void AudioBus::CopyConvertFromAudioBusToInterleavedTarget(
     const AudioBus* source,
@@ -310,6 +361,17 @@ void AudioBus::CopyConvertFromAudioBusToInterleavedTarget(
     int num_frames_to_read,
     typename TargetSampleTypeTraits::ValueType* dest_buffer) {
   const int channels = source->channels();
+  constexpr VectorizedSampleFormat kFormat =
+      GetVectorizedSampleFormat<TargetSampleTypeTraits>();
+  if (kFormat != VectorizedSampleFormat::kNone) {
+    const int converted_frames =
+        CopyConvertFromAudioBusToInterleavedTargetVectorized(
+            kFormat, source, read_offset_in_frames, num_frames_to_read,
+            dest_buffer);
+    dest_buffer += converted_frames * channels;
+    read_offset_in_frames += converted_frames;
+    num_frames_to_read -= converted_frames;
+  }
   for (int ch = 0; ch < channels; ++ch) {
     const float* channel_data = source->channel(ch);
     for (int source_frame_index = read_offset_in_frames, write_pos_in_dest = ch;
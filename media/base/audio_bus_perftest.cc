@@ -5,6 +5,7 @@
 #include <stdint.h>
 #include <memory>
 
+#include "base/strings/string_number_conversions.h"
 #include "base/time/time.h"
 #include "media/base/audio_bus.h"
 #include "media/base/audio_sample_types.h"
@@ -79,6 +80,29 @@ TEST(AudioBusPerfTest, DISABLED_ToInterleavedFloat) {
       bus.get(), "to_interleave_float_no_clip", true);
 }
 
+// Benchmark the conversions of each sample format, which are vectorized for
+// mono and stereo on CPUs with AVX2, and not for more channels.
+TEST(AudioBusPerfTest, InterleaveSampleFormats) {
+  for (int channels : {1, 2, 6}) {
+    std::unique_ptr<AudioBus> bus =
+        AudioBus::Create(channels, kSampleRate * 60);
+    FakeAudioRenderCallback callback(0.2, kSampleRate);
+    callback.Render(base::TimeDelta(), base::TimeTicks::Now(), 0, bus.get());
+
+    const std::string suffix = "_" + base::NumberToString(channels) + "ch";
+    RunInterleaveBench<uint8_t, UnsignedInt8SampleTypeTraits>(
+        bus.get(), "uint8_t" + suffix);
+    RunInterleaveBench<int16_t, SignedInt16SampleTypeTraits>(
+        bus.get(), "int16_t" + suffix);
+    RunInterleaveBench<int32_t, SignedInt32SampleTypeTraits>(
+        bus.get(), "int32_t" + suffix);
+    RunInterleaveBench<float, Float32SampleTypeTraits>(bus.get(),
+                                                       "float" + suffix);
+    RunInterleaveBench<float, Float32SampleTypeTraitsNoClip>(
+        bus.get(), "float_no_clip" + suffix);
+  }
+}
+
 void RunCopyBench(void (AudioBus::*f)(AudioBus*) const,
                   const std::string& trace_name) {
   // Setup.
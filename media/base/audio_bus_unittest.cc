@@ -5,8 +5,10 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <cmath>
 #include <limits>
 #include <memory>
+#include <vector>
 
 #include "base/cxx17_backports.h"
 #include "base/memory/aligned_memory.h"
@@ -541,6 +543,70 @@ TEST_F(AudioBusTest, ToInterleavedPartial) {
   }
 }
 
+// Converts |kFrameCount| frames of mono and stereo, which are vectorized on
+// some CPUs, from an offset which isn't aligned, and compares them with the
+// conversions of each sample by |SampleTypeTraits|.
+template <class SampleTypeTraits>
+void VerifyInterleavedConversionOfEachSample() {
+  static const int kOffset = 3;
+  for (int channels = 1; channels <= 2; ++channels) {
+    SCOPED_TRACE(base::StringPrintf("%d channels", channels));
+    std::unique_ptr<AudioBus> bus =
+        AudioBus::Create(channels, kOffset + kFrameCount);
+    for (int ch = 0; ch < channels; ++ch) {
+      for (int i = 0; i < bus->frames(); ++i) {
+        // Cover the clipped values, and both sides of the zero point.
+        bus->channel(ch)[i] = (i % 7 == 0) ? (i % 2 ? 1.0f : -1.0f)
+                                           : sinf(i * 0.731f + ch) * 1.2f;
+      }
+    }
+
+    std::vector<typename SampleTypeTraits::ValueType> interleaved(
+        channels * kFrameCount);
+    bus->ToInterleavedPartial<SampleTypeTraits>(kOffset, kFrameCount,
+                                                interleaved.data());
+    std::unique_ptr<AudioBus> result =
+        AudioBus::Create(channels, kOffset + kFrameCount);
+    result->FromInterleavedPartial<SampleTypeTraits>(interleaved.data(),
+                                                     kOffset, kFrameCount);
+    for (int ch = 0; ch < channels; ++ch) {
+      for (int i = 0; i < kFrameCount; ++i) {
+        const typename SampleTypeTraits::ValueType sample =
+            interleaved[i * channels + ch];
+        ASSERT_EQ(SampleTypeTraits::FromFloat(bus->channel(ch)[kOffset + i]),
+                  sample);
+        ASSERT_EQ(SampleTypeTraits::ToFloat(sample),
+                  result->channel(ch)[kOffset + i]);
+      }
+    }
+  }
+}
+
+// Verify the vectorized conversions of mono and stereo match the conversions
+// of each sample.
+TEST_F(AudioBusTest, InterleavedConversionMatchesSampleTypeTraits) {
+  {
+    SCOPED_TRACE("UnsignedInt8SampleTypeTraits");
+    VerifyInterleavedConversionOfEachSample<UnsignedInt8SampleTypeTraits>();
+  }
+  {
+    SCOPED_TRACE("SignedInt16SampleTypeTraits");
+    VerifyInterleavedConversionOfEachSample<SignedInt16SampleTypeTraits>();
+  }
+  {
+    SCOPED_TRACE("SignedInt32SampleTypeTraits");
+    VerifyInterleavedConversionOfEachSample<SignedInt32SampleTypeTraits>();
+  }
+  {
+    SCOPED_TRACE("Float32SampleTypeTraits");
+    VerifyInterleavedConversionOfEachSample<Float32SampleTypeTraits>();
+  }
+  {
+    SCOPED_TRACE("Float32SampleTypeTraitsNoClip");
+    VerifyInterleavedConversionOfEachSample<Float32SampleTypeTraitsNoClip>();
+  }
+}
+
 struct ZeroingOutTestData {
   static constexpr int kChannelCount = 2;
   static constexpr int kFrameCount = 10;
@@ -4,6 +4,7 @@
 
 #include <memory>
 
+#include "base/strings/string_number_conversions.h"
 #include "base/time/time.h"
 #include "media/base/audio_converter.h"
 #include "media/base/fake_audio_render_callback.h"
@@ -29,6 +30,7 @@ class NullInputProvider : public AudioConverter::InputCallback {
 void RunConvertBenchmark(const AudioParameters& in_params,
                          const AudioParameters& out_params,
                          bool fifo,
+                         int iterations,
                          const std::string& trace_name) {
   NullInputProvider fake_input1;
   NullInputProvider fake_input2;
@@ -41,11 +43,11 @@ void RunConvertBenchmark(const AudioParameters& in_params,
   converter.AddInput(&fake_input3);
 
   base::TimeTicks start = base::TimeTicks::Now();
-  for (int i = 0; i < kBenchmarkIterations; ++i) {
+  for (int i = 0; i < iterations; ++i) {
     converter.Convert(output_bus.get());
   }
-  double runs_per_second = kBenchmarkIterations /
-                           (base::TimeTicks::Now() - start).InSecondsF();
+  double runs_per_second =
+      iterations / (base::TimeTicks::Now() - start).InSecondsF();
   perf_test::PerfResultReporter reporter("audio_converter", trace_name);
   reporter.RegisterImportantMetric("", "runs/s");
   reporter.AddResult("", runs_per_second);
@@ -59,7 +61,27 @@ TEST(AudioConverterPerfTest, ConvertBenchmark) {
   AudioParameters output_params(AudioParameters::AUDIO_PCM_LINEAR,
                                 CHANNEL_LAYOUT_STEREO, 44100, 440);
 
-  RunConvertBenchmark(input_params, output_params, false, "convert");
+  RunConvertBenchmark(input_params, output_params, false, kBenchmarkIterations,
+                      "convert");
+}
+
+TEST(AudioConverterPerfTest, ConvertBenchmarkMultiChannel) {
+  // Resample between the two most common sample rates without any channel
+  // mixing, for the channel counts of stereo, 5.1, 7.1 and larger discrete
+  // layouts.  Each benchmark resamples about the same number of samples.
+  for (int channels : {2, 6, 8, 16}) {
+    AudioParameters input_params(AudioParameters::AUDIO_PCM_LINEAR,
+                                 CHANNEL_LAYOUT_DISCRETE, 48000, 480);
+    input_params.set_channels_for_discrete(channels);
+    AudioParameters output_params(AudioParameters::AUDIO_PCM_LINEAR,
+                                  CHANNEL_LAYOUT_DISCRETE, 44100, 441);
+    output_params.set_channels_for_discrete(channels);
+
+    RunConvertBenchmark(input_params, output_params, false,
+                        kBenchmarkIterations / channels,
+                        "convert_" + base::NumberToString(channels) +
+                            "_channels");
+  }
 }
 
 TEST(AudioConverterPerfTest, ConvertBenchmarkFIFO) {
@@ -72,8 +94,9 @@ TEST(AudioConverterPerfTest, ConvertBenchmarkFIFO) {
   AudioParameters output_params(AudioParameters::AUDIO_PCM_LINEAR,
                                 CHANNEL_LAYOUT_STEREO, 44100, 440);
 
-  RunConvertBenchmark(input_params, output_params, true, "convert_fifo_only");
-  RunConvertBenchmark(input_params, output_params, false,
+  RunConvertBenchmark(input_params, output_params, true, kBenchmarkIterations,
+                      "convert_fifo_only");
+  RunConvertBenchmark(input_params, output_params, false, kBenchmarkIterations,
                       "convert_pass_through");
 }
 
@@ -6,18 +6,59 @@
 
 #include <algorithm>
 #include <cstring>
+#include <memory>
+#include <utility>
 
 #include "base/check_op.h"
 #include "base/numerics/checked_math.h"
+#include "media/base/decoder_buffer.h"
 
 namespace media {
 
-ByteQueue::ByteQueue() : buffer_(new uint8_t[size_]) {}
+// Memory of a chunk allocated by the queue. Its bytes are purposely not
+// initialized, since they are only read once pushed.
+class ByteQueue::ChunkMemory : public base::RefCountedMemory {
+ public:
+  explicit ChunkMemory(size_t capacity)
+      : data_(new uint8_t[capacity]), capacity_(capacity) {}
+
+  ChunkMemory(const ChunkMemory&) = delete;
+  ChunkMemory& operator=(const ChunkMemory&) = delete;
+
+  // base::RefCountedMemory implementation.
+  const uint8_t* front() const override { return data_.get(); }
+  size_t size() const override { return capacity_; }
+
+  uint8_t* writable_front() { return data_.get(); }
+
+ private:
+  ~ChunkMemory() override = default;
+
+  std::unique_ptr<uint8_t[]> data_;
+  const size_t capacity_;
+};
+
+ByteQueue::Chunk::Chunk(scoped_refptr<base::RefCountedMemory> memory,
+                        size_t begin,
+                        size_t end,
+                        bool appendable)
+    : memory(std::move(memory)),
+      begin(begin),
+      end(end),
+      appendable(appendable) {}
+
+ByteQueue::Chunk::Chunk(Chunk&& other) = default;
+
+ByteQueue::Chunk& ByteQueue::Chunk::operator=(Chunk&& other) = default;
+
+ByteQueue::Chunk::~Chunk() = default;
+
+ByteQueue::ByteQueue() = default;
 
 ByteQueue::~ByteQueue() = default;
 
 void ByteQueue::Reset() {
-  offset_ = 0;
+  chunks_.clear();
   used_ = 0;
 }
 
@@ -25,68 +66,198 @@ void ByteQueue::Push(const uint8_t* data, int size) {
   DCHECK(data);
   DCHECK_GT(size, 0);
 
-  // This can never overflow since used and size are both ints.
-  const size_t size_needed = static_cast<size_t>(used_) + size;
-
-  // Check to see if we need a bigger buffer.
-  if (size_needed > size_) {
-    // Growth is based on base::circular_deque which grows at 25%.
-    const size_t safe_size =
-        (base::CheckedNumeric<size_t>(size_) + size_ / 4).ValueOrDie();
-    const size_t new_size = std::max(size_needed, safe_size);
-
-    // Copy the data from the old buffer to the start of the new one.
-    if (used_ > 0) {
-      // Note: We could use realloc() here, but would need an additional move to
-      // pack data at offset_ = 0 after a potential internal new allocation +
-      // copy by realloc().
-      //
-      // In local tests on a few top video sites that ends up being the common
-      // case, so just prefer to copy and pack ourselves.
-      std::unique_ptr<uint8_t[]> new_buffer(new uint8_t[new_size]);
-      memcpy(new_buffer.get(), Front(), used_);
-      buffer_ = std::move(new_buffer);
-    } else {
-      // Free the existing |data| first so that the memory can be reused, if
-      // possible. Note that the new array is purposely not initialized.
-      buffer_.reset();
-      buffer_.reset(new uint8_t[new_size]);
+  const int new_used = (base::CheckedNumeric<int>(used_) + size).ValueOrDie();
+  size_t remaining = size;
+
+  // Fill the spare capacity of the last chunk first.
+  if (!chunks_.empty() && chunks_.back().appendable) {
+    Chunk& back = chunks_.back();
+    uint8_t* back_data =
+        static_cast<ChunkMemory*>(back.memory.get())->writable_front();
+
+    // If the chunk is the only one, move its bytes back to its start to make
+    // room, unless a DecoderBuffer references them. This keeps the queue
+    // contiguous when the bytes are popped as fast as they are pushed.
+    const size_t back_size = back.end - back.begin;
+    if (chunks_.size() == 1 && back.begin > 0 &&
+        back.memory->size() - back.end < remaining &&
+        back.memory->size() - back_size >= remaining &&
+        back.memory->HasOneRef()) {
+      memmove(back_data, back_data + back.begin, back_size);
+      back.begin = 0;
+      back.end = back_size;
     }
 
-    size_ = new_size;
-    offset_ = 0;
-  } else if ((offset_ + used_ + size) > size_) {
-    // The buffer is big enough, but we need to move the data in the queue.
-    memmove(buffer_.get(), Front(), used_);
-    offset_ = 0;
+    const size_t append_size =
+        std::min(remaining, back.memory->size() - back.end);
+    memcpy(back_data + back.end, data, append_size);
+    back.end += append_size;
+    data += append_size;
+    remaining -= append_size;
   }
 
-  memcpy(Front() + used_, data, size);
-  used_ += size;
+  if (remaining > 0) {
+    // Growth is based on base::circular_deque which grows at 25%, so that small
+    // pushes fill a few large chunks.
+    const size_t capacity =
+        std::max({remaining, static_cast<size_t>(kDefaultQueueSize),
+                  static_cast<size_t>(used_) / 4});
+    auto memory = base::MakeRefCounted<ChunkMemory>(capacity);
+    memcpy(memory->writable_front(), data, remaining);
+    chunks_.emplace_back(std::move(memory), 0, remaining, true);
+  }
+
+  used_ = new_used;
+}
+
+void ByteQueue::Push(scoped_refptr<base::RefCountedMemory> data) {
+  DCHECK(data);
+  DCHECK_GT(data->size(), 0u);
+
+  const size_t size = data->size();
+  used_ = (base::CheckedNumeric<int>(used_) + size).ValueOrDie<int>();
+
+  // Drop an empty chunk kept for its memory, see Pop().
+  if (!chunks_.empty() && chunks_.back().begin == chunks_.back().end)
+    chunks_.pop_back();
+  chunks_.emplace_back(std::move(data), 0, size, false);
 }
 
-void ByteQueue::Peek(const uint8_t** data, int* size) const {
+void ByteQueue::Peek(const uint8_t** data, int* size) {
   DCHECK(data);
   DCHECK(size);
-  *data = Front();
-  *size = used_;
+  Coalesce(used_);
+  PeekFront(data, size);
+}
+
+bool ByteQueue::PeekContiguous(int count, const uint8_t** data) {
+  DCHECK(data);
+  DCHECK_GE(count, 0);
+  if (count > used_)
+    return false;
+
+  Coalesce(count);
+  int size;
+  PeekFront(data, &size);
+  return true;
+}
+
+void ByteQueue::PeekFront(const uint8_t** data, int* size) const {
+  DCHECK(data);
+  DCHECK(size);
+  if (chunks_.empty()) {
+    *data = nullptr;
+    *size = 0;
+    return;
+  }
+
+  const Chunk& front = chunks_.front();
+  *data = front.memory->front() + front.begin;
+  *size = static_cast<int>(front.end - front.begin);
+}
+
+scoped_refptr<DecoderBuffer> ByteQueue::CreateDecoderBuffer(int offset,
+                                                            int size) const {
+  DCHECK_GE(offset, 0);
+  DCHECK_GE(size, 0);
+  DCHECK_LE(offset, used_);
+  DCHECK_LE(size, used_ - offset);
+  if (size == 0)
+    return base::MakeRefCounted<DecoderBuffer>(0);
+
+  // Find the chunk holding the first byte.
+  size_t i = 0;
+  size_t chunk_offset = offset;
+  while (chunk_offset >= chunks_[i].end - chunks_[i].begin) {
+    chunk_offset -= chunks_[i].end - chunks_[i].begin;
+    ++i;
+  }
+
+  const Chunk& chunk = chunks_[i];
+  if (static_cast<size_t>(size) <= chunk.end - chunk.begin - chunk_offset) {
+    return DecoderBuffer::FromRefCountedMemory(
+        chunk.memory, chunk.begin + chunk_offset, size);
+  }
+
+  // Copy the bytes, which span several chunks.
+  auto buffer = base::MakeRefCounted<DecoderBuffer>(static_cast<size_t>(size));
+  uint8_t* destination = buffer->writable_data();
+  size_t remaining = size;
+  for (; remaining > 0; ++i, chunk_offset = 0) {
+    const Chunk& source = chunks_[i];
+    const size_t copy_size =
+        std::min(remaining, source.end - source.begin - chunk_offset);
+    memcpy(destination, source.memory->front() + source.begin + chunk_offset,
+           copy_size);
+    destination += copy_size;
+    remaining -= copy_size;
+  }
+  return buffer;
 }
 
 void ByteQueue::Pop(int count) {
+  DCHECK_GE(count, 0);
   DCHECK_LE(count, used_);
 
-  offset_ += count;
   used_ -= count;
+  size_t remaining = count;
+  while (remaining > 0) {
+    Chunk& front = chunks_.front();
+    const size_t pop_size = std::min(remaining, front.end - front.begin);
+    front.begin += pop_size;
+    remaining -= pop_size;
+    if (front.begin == front.end && chunks_.size() > 1)
+      chunks_.pop_front();
+  }
 
-  // Move the offset back to 0 if we have reached the end of the buffer.
-  if (offset_ == size_) {
-    DCHECK_EQ(used_, 0);
-    offset_ = 0;
+  // Once the queue is empty, move back to the start of the last chunk so that
+  // its memory is reused, unless a DecoderBuffer references it.
+  if (used_ == 0 && !chunks_.empty()) {
+    DCHECK_EQ(chunks_.size(), 1u);
+    Chunk& chunk = chunks_.front();
+    if (chunk.appendable && chunk.memory->HasOneRef()) {
+      chunk.begin = 0;
+      chunk.end = 0;
+    } else {
+      chunks_.clear();
+    }
   }
 }
 
-uint8_t* ByteQueue::Front() const {
-  return buffer_.get() + offset_;
+void ByteQueue::Coalesce(int count) {
+  DCHECK_LE(count, used_);
+  if (count == 0 || chunks_.front().end - chunks_.front().begin >=
+                        static_cast<size_t>(count)) {
+    return;
+  }
+
+  // Copy whole chunks, so that the ones after them are left as they are.
+  size_t num_chunks = 0;
+  size_t coalesced_size = 0;
+  while (coalesced_size < static_cast<size_t>(count)) {
+    coalesced_size += chunks_[num_chunks].end - chunks_[num_chunks].begin;
+    ++num_chunks;
+  }
+
+  // When coalescing the whole queue, leave spare capacity for Push() with the
+  // same growth.
+  size_t capacity = coalesced_size;
+  if (num_chunks == chunks_.size()) {
+    capacity = (base::CheckedNumeric<size_t>(coalesced_size) +
+                coalesced_size / 4)
+                   .ValueOrDie();
+  }
+
+  auto memory = base::MakeRefCounted<ChunkMemory>(capacity);
+  uint8_t* destination = memory->writable_front();
+  for (; num_chunks > 0; --num_chunks) {
+    const Chunk& source = chunks_.front();
+    memcpy(destination, source.memory->front() + source.begin,
+           source.end - source.begin);
+    destination += source.end - source.begin;
+    chunks_.pop_front();
+  }
+  chunks_.emplace_front(std::move(memory), 0, coalesced_size, true);
 }
 
 }  // namespace media
@@ -8,18 +8,24 @@
 #include <stddef.h>
 #include <stdint.h>
 
-#include <memory>
-
+#include "base/containers/circular_deque.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/ref_counted_memory.h"
 #include "media/base/media_export.h"
 
 namespace media {
 
+class DecoderBuffer;
+
 // Represents a queue of bytes. Data is added to the end of the queue via an
 // Push() call and removed via Pop(). The contents of the queue can be observed
-// via the Peek() method.
+// via the Peek() methods.
 //
 // This class manages the underlying storage of the queue and tries to minimize
-// the number of buffer copies when data is appended and removed.
+// the number of buffer copies when data is appended and removed. The bytes are
+// stored as a rope of ref-counted chunks, so that popping never moves them,
+// and they are only made contiguous when a Peek() method needs it. Frames can
+// reference the chunks directly through CreateDecoderBuffer().
 class MEDIA_EXPORT ByteQueue {
  public:
   ByteQueue();
@@ -35,30 +41,77 @@ class MEDIA_EXPORT ByteQueue {
   // Appends new bytes onto the end of the queue.
   void Push(const uint8_t* data, int size);
 
+  // Appends the bytes of |data| onto the end of the queue without copying
+  // them. The bytes of |data| must not change afterwards.
+  void Push(scoped_refptr<base::RefCountedMemory> data);
+
   // Get a pointer to the front of the queue and the queue size. These values
-  // are only valid until the next Push() or Pop() call.
-  void Peek(const uint8_t** data, int* size) const;
+  // are only valid until the next Push(), Pop() or Peek*() call.
+  //
+  // This copies the whole queue into one chunk if it spans several, so parsers
+  // should prefer PeekContiguous() or PeekFront().
+  void Peek(const uint8_t** data, int* size);
+
+  // Get a pointer to the first |count| bytes of the queue, which are copied
+  // into one chunk first if they span several. Returns false, leaving |data|
+  // unchanged, if the queue holds fewer than |count| bytes. The pointer is only
+  // valid until the next Push(), Pop() or Peek*() call.
+  bool PeekContiguous(int count, const uint8_t** data);
+
+  // Get a pointer to the bytes of the first chunk of the queue and their
+  // count, which may be fewer than size(). Never copies. These values are only
+  // valid until the next Push(), Pop() or Peek*() call.
+  void PeekFront(const uint8_t** data, int* size) const;
+
+  // Returns a DecoderBuffer of the |size| bytes at |offset| from the front of
+  // the queue. The buffer references the chunk holding them, unless they span
+  // several chunks and are copied. It remains valid after they are popped.
+  scoped_refptr<DecoderBuffer> CreateDecoderBuffer(int offset, int size) const;
 
   // Remove |count| bytes from the front of the queue.
   void Pop(int count);
 
+  // Returns the number of bytes in the queue.
+  int size() const { return used_; }
+
  private:
-  // Default starting size for the queue.
+  class ChunkMemory;
+
+  struct Chunk {
+    Chunk(scoped_refptr<base::RefCountedMemory> memory,
+          size_t begin,
+          size_t end,
+          bool appendable);
+    Chunk(Chunk&& other);
+    Chunk& operator=(Chunk&& other);
+    ~Chunk();
+
+    // Memory of the chunk, which DecoderBuffers created from it share.
+    scoped_refptr<base::RefCountedMemory> memory;
+
+    // Bytes [|begin|, |end|) of |memory| are in the queue.
+    size_t begin;
+    size_t end;
+
+    // Whether |memory| is a ChunkMemory allocated by the queue, which Push()
+    // can append to up to its capacity. Bytes referenced by a DecoderBuffer
+    // never change.
+    bool appendable;
+  };
+
+  // Default size of the chunks the queue allocates.
   enum { kDefaultQueueSize = 1024 };
 
-  // Returns a pointer to the front of the queue.
-  uint8_t* Front() const;
-
-  // Size of |buffer_|.
-  size_t size_ = kDefaultQueueSize;
+  // Copies the chunks holding the first |count| bytes of the queue into one
+  // chunk, if there are several.
+  void Coalesce(int count);
 
-  // Offset from the start of |buffer_| that marks the front of the queue.
-  size_t offset_ = 0u;
+  // Queued bytes, in order. Only a lone chunk may be empty, which Pop() keeps
+  // to reuse its memory.
+  base::circular_deque<Chunk> chunks_;
 
-  // Number of bytes stored in |buffer_|.
+  // Number of bytes stored in |chunks_|.
   int used_ = 0;
-
-  std::unique_ptr<uint8_t[]> buffer_;
 };
 
 }  // namespace media
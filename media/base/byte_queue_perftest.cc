@@ -0,0 +1,147 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "base/memory/ref_counted_memory.h"
+#include "base/time/time.h"
+#include "media/base/byte_queue.h"
+#include "media/base/decoder_buffer.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace media {
+
+namespace {
+
+// Debug builds can be quite slow. Use fewer segments to test.
+#if defined(NDEBUG)
+constexpr int kNumSegments = 200;
+#else
+constexpr int kNumSegments = 10;
+#endif
+
+// Size of the appends of a media segment as read from the network.
+constexpr int kNetworkReadSize = 64 * 1024;
+
+// Size of the frame header of the segments, which is the big-endian frame
+// size.
+constexpr int kFrameHeaderSize = 4;
+
+// Returns a segment of about 2 MB of audio and video frames, each preceded by
+// its size, which stands for the segments of the stream parsers.
+std::vector<uint8_t> CreateSegment() {
+  std::vector<uint8_t> segment;
+  for (int i = 0; segment.size() < 2 * 1024 * 1024; ++i) {
+    // An audio frame, then a video frame with a key frame every 30 frames.
+    for (uint32_t frame_size :
+         {768u, i % 30 == 0 ? 120000u : 8000u + (i * 2654435761u) % 16000}) {
+      segment.push_back(frame_size >> 24);
+      segment.push_back(frame_size >> 16);
+      segment.push_back(frame_size >> 8);
+      segment.push_back(frame_size);
+      segment.insert(segment.end(), frame_size, static_cast<uint8_t>(i));
+    }
+  }
+  return segment;
+}
+
+// Creates DecoderBuffers for the frames at the front of |queue|, as a stream
+// parser does, either by peeking all of the queue and copying the frames, or
+// by peeking only the frame headers and referencing the queued frames.
+size_t ParseFrames(ByteQueue* queue, bool copy_frames) {
+  size_t parsed_size = 0;
+  for (;;) {
+    const uint8_t* data;
+    int size;
+    if (copy_frames) {
+      queue->Peek(&data, &size);
+      if (size < kFrameHeaderSize)
+        break;
+    } else if (!queue->PeekContiguous(kFrameHeaderSize, &data)) {
+      break;
+    }
+
+    const int frame_size =
+        (data[0] << 24) | (data[1] << 16) | (data[2] << 8) | data[3];
+    if (queue->size() < kFrameHeaderSize + frame_size)
+      break;
+
+    scoped_refptr<DecoderBuffer> buffer =
+        copy_frames
+            ? DecoderBuffer::CopyFrom(data + kFrameHeaderSize, frame_size)
+            : queue->CreateDecoderBuffer(kFrameHeaderSize, frame_size);
+    parsed_size += buffer->data_size();
+    queue->Pop(kFrameHeaderSize + frame_size);
+  }
+  return parsed_size;
+}
+
+// Appends |kNumSegments| segments to a ByteQueue in appends of |append_size|
+// bytes, and parses the frames after each append. The appends are copied,
+// unless |push_memory| is set.
+void RunParseBenchmark(int append_size,
+                       bool push_memory,
+                       bool copy_frames,
+                       const std::string& story) {
+  const std::vector<uint8_t> segment = CreateSegment();
+  const int segment_size = static_cast<int>(segment.size());
+
+  // The memory of the appends is created up front, as it would be by the data
+  // source.
+  std::vector<scoped_refptr<base::RefCountedMemory>> appends;
+  for (int offset = 0; offset < segment_size; offset += append_size) {
+    appends.push_back(base::MakeRefCounted<base::RefCountedBytes>(
+        segment.data() + offset, std::min(append_size, segment_size - offset)));
+  }
+
+  ByteQueue queue;
+  size_t parsed_size = 0;
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = 0; i < kNumSegments; ++i) {
+    for (const auto& append : appends) {
+      if (push_memory)
+        queue.Push(append);
+      else
+        queue.Push(append->front(), static_cast<int>(append->size()));
+      parsed_size += ParseFrames(&queue, copy_frames);
+    }
+  }
+  const base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+  EXPECT_EQ(0, queue.size());
+
+  perf_test::PerfResultReporter reporter("byte_queue", story);
+  reporter.RegisterImportantMetric("", "MB/s");
+  reporter.AddResult("", parsed_size / elapsed.InSecondsF() / (1024 * 1024));
+}
+
+}  // namespace
+
+// Peeks all of the queue and copies the frames out of it.
+TEST(ByteQueuePerfTest, ParseCopyingFrames) {
+  RunParseBenchmark(kNetworkReadSize, false, true, "copy_frames_network_read");
+  RunParseBenchmark(CreateSegment().size(), false, true, "copy_frames_segment");
+}
+
+// Peeks only the frame headers and references the frames in the queue.
+TEST(ByteQueuePerfTest, ParseReferencingFrames) {
+  RunParseBenchmark(kNetworkReadSize, false, false,
+                    "reference_frames_network_read");
+  RunParseBenchmark(CreateSegment().size(), false, false,
+                    "reference_frames_segment");
+}
+
+// Also pushes the appends without copying them.
+TEST(ByteQueuePerfTest, ParseReferencingAppendsAndFrames) {
+  RunParseBenchmark(kNetworkReadSize, true, false,
+                    "reference_appends_network_read");
+  RunParseBenchmark(CreateSegment().size(), true, false,
+                    "reference_appends_segment");
+}
+
+}  // namespace media
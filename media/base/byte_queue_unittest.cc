@@ -0,0 +1,255 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "media/base/byte_queue.h"
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "base/memory/ref_counted_memory.h"
+#include "media/base/decoder_buffer.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace media {
+
+namespace {
+
+// Returns |size| bytes counting up from |first|.
+std::vector<uint8_t> MakeBytes(int first, int size) {
+  std::vector<uint8_t> bytes(size);
+  for (int i = 0; i < size; ++i)
+    bytes[i] = static_cast<uint8_t>(first + i);
+  return bytes;
+}
+
+}  // namespace
+
+TEST(ByteQueueTest, Empty) {
+  ByteQueue queue;
+  EXPECT_EQ(0, queue.size());
+
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(1);
+  int size = 1;
+  queue.Peek(&data, &size);
+  EXPECT_EQ(nullptr, data);
+  EXPECT_EQ(0, size);
+
+  EXPECT_TRUE(queue.PeekContiguous(0, &data));
+  EXPECT_FALSE(queue.PeekContiguous(1, &data));
+}
+
+TEST(ByteQueueTest, PushPeekPop) {
+  ByteQueue queue;
+  const std::vector<uint8_t> bytes = MakeBytes(0, 100);
+  queue.Push(bytes.data(), 60);
+  queue.Push(bytes.data() + 60, 40);
+  EXPECT_EQ(100, queue.size());
+
+  const uint8_t* data;
+  int size;
+  queue.Peek(&data, &size);
+  ASSERT_EQ(100, size);
+  EXPECT_EQ(bytes, std::vector<uint8_t>(data, data + size));
+
+  queue.Pop(30);
+  queue.Peek(&data, &size);
+  ASSERT_EQ(70, size);
+  EXPECT_EQ(30, data[0]);
+
+  queue.Pop(70);
+  EXPECT_EQ(0, queue.size());
+  queue.Peek(&data, &size);
+  EXPECT_EQ(0, size);
+
+  // The queue is usable once emptied.
+  queue.Push(bytes.data(), 10);
+  queue.Peek(&data, &size);
+  ASSERT_EQ(10, size);
+  EXPECT_EQ(0, data[0]);
+  EXPECT_EQ(9, data[9]);
+}
+
+TEST(ByteQueueTest, Reset) {
+  ByteQueue queue;
+  const std::vector<uint8_t> bytes = MakeBytes(0, 10);
+  queue.Push(bytes.data(), 10);
+  queue.Reset();
+  EXPECT_EQ(0, queue.size());
+
+  queue.Push(bytes.data() + 5, 5);
+  const uint8_t* data;
+  int size;
+  queue.Peek(&data, &size);
+  ASSERT_EQ(5, size);
+  EXPECT_EQ(5, data[0]);
+}
+
+TEST(ByteQueueTest, PushMemoryIsNotCopied) {
+  ByteQueue queue;
+  const std::vector<uint8_t> bytes = MakeBytes(0, 5000);
+  auto memory = base::MakeRefCounted<base::RefCountedBytes>(bytes);
+  queue.Push(memory);
+  EXPECT_EQ(5000, queue.size());
+
+  const uint8_t* data;
+  int size;
+  queue.PeekFront(&data, &size);
+  EXPECT_EQ(memory->front(), data);
+  EXPECT_EQ(5000, size);
+
+  queue.Pop(1000);
+  EXPECT_TRUE(queue.PeekContiguous(4000, &data));
+  EXPECT_EQ(memory->front() + 1000, data);
+}
+
+TEST(ByteQueueTest, PeekContiguousCoalescesOnlyWhatIsNeeded) {
+  ByteQueue queue;
+  const std::vector<uint8_t> bytes = MakeBytes(0, 300);
+  auto first = base::MakeRefCounted<base::RefCountedBytes>(
+      std::vector<uint8_t>(bytes.begin(), bytes.begin() + 100));
+  auto second = base::MakeRefCounted<base::RefCountedBytes>(
+      std::vector<uint8_t>(bytes.begin() + 100, bytes.begin() + 200));
+  auto third = base::MakeRefCounted<base::RefCountedBytes>(
+      std::vector<uint8_t>(bytes.begin() + 200, bytes.end()));
+  queue.Push(first);
+  queue.Push(second);
+  queue.Push(third);
+  queue.Pop(90);
+
+  // The first 10 bytes are all in the first chunk.
+  const uint8_t* data;
+  EXPECT_TRUE(queue.PeekContiguous(10, &data));
+  EXPECT_EQ(first->front() + 90, data);
+
+  // The first 20 bytes span the first two chunks, which are copied, but the
+  // third one is not.
+  EXPECT_TRUE(queue.PeekContiguous(20, &data));
+  EXPECT_EQ(std::vector<uint8_t>(bytes.begin() + 90, bytes.begin() + 110),
+            std::vector<uint8_t>(data, data + 20));
+  int size;
+  queue.PeekFront(&data, &size);
+  EXPECT_EQ(110, size);
+
+  queue.Pop(110);
+  queue.PeekFront(&data, &size);
+  EXPECT_EQ(third->front(), data);
+  EXPECT_EQ(100, size);
+  EXPECT_EQ(100, queue.size());
+}
+
+TEST(ByteQueueTest, PeekFrontSpansChunks) {
+  ByteQueue queue;
+  const std::vector<uint8_t> bytes = MakeBytes(0, 200);
+  queue.Push(bytes.data(), 100);
+  queue.Push(base::MakeRefCounted<base::RefCountedBytes>(
+      std::vector<uint8_t>(bytes.begin() + 100, bytes.end())));
+
+  const uint8_t* data;
+  int size;
+  queue.PeekFront(&data, &size);
+  EXPECT_EQ(100, size);
+  EXPECT_EQ(200, queue.size());
+
+  queue.Peek(&data, &size);
+  ASSERT_EQ(200, size);
+  EXPECT_EQ(bytes, std::vector<uint8_t>(data, data + size));
+}
+
+TEST(ByteQueueTest, ManyPushes) {
+  ByteQueue queue;
+  const std::vector<uint8_t> bytes = MakeBytes(0, 256);
+  std::vector<uint8_t> expected;
+  for (int i = 0; i < 1000; ++i) {
+    const int size = 1 + i % 200;
+    queue.Push(bytes.data() + i % 50, size);
+    expected.insert(expected.end(), bytes.begin() + i % 50,
+                    bytes.begin() + i % 50 + size);
+    if (i % 3 == 0) {
+      queue.Pop(size / 2);
+      expected.erase(expected.begin(), expected.begin() + size / 2);
+    }
+  }
+
+  ASSERT_EQ(static_cast<int>(expected.size()), queue.size());
+  const uint8_t* data;
+  int size;
+  queue.Peek(&data, &size);
+  ASSERT_EQ(queue.size(), size);
+  EXPECT_EQ(expected, std::vector<uint8_t>(data, data + size));
+}
+
+TEST(ByteQueueTest, CreateDecoderBufferReferencesChunk) {
+  ByteQueue queue;
+  const std::vector<uint8_t> bytes = MakeBytes(0, 100);
+  queue.Push(bytes.data(), 100);
+
+  const uint8_t* data;
+  int size;
+  queue.PeekFront(&data, &size);
+  scoped_refptr<DecoderBuffer> buffer = queue.CreateDecoderBuffer(10, 20);
+  EXPECT_EQ(data + 10, buffer->data());
+  EXPECT_EQ(20u, buffer->data_size());
+  EXPECT_FALSE(buffer->end_of_stream());
+
+  // The buffer remains valid once its bytes are popped, and they are not
+  // overwritten by later pushes.
+  queue.Pop(100);
+  queue.Push(bytes.data() + 50, 50);
+  queue.Reset();
+  EXPECT_EQ(std::vector<uint8_t>(bytes.begin() + 10, bytes.begin() + 30),
+            std::vector<uint8_t>(buffer->data(),
+                                 buffer->data() + buffer->data_size()));
+}
+
+TEST(ByteQueueTest, PushDoesNotMoveReferencedBytes) {
+  ByteQueue queue;
+  const std::vector<uint8_t> bytes = MakeBytes(0, 1024);
+  queue.Push(bytes.data(), 1024);
+  scoped_refptr<DecoderBuffer> buffer = queue.CreateDecoderBuffer(900, 100);
+  const uint8_t* buffer_data = buffer->data();
+
+  // Pushing more bytes than the spare capacity of the chunk would move the
+  // remaining bytes to its start, if the buffer did not reference them.
+  queue.Pop(900);
+  queue.Push(bytes.data(), 500);
+  EXPECT_EQ(buffer_data, buffer->data());
+  EXPECT_EQ(std::vector<uint8_t>(bytes.begin() + 900, bytes.begin() + 1000),
+            std::vector<uint8_t>(buffer->data(),
+                                 buffer->data() + buffer->data_size()));
+
+  const uint8_t* data;
+  int size;
+  queue.Peek(&data, &size);
+  ASSERT_EQ(624, size);
+  EXPECT_EQ(std::vector<uint8_t>(bytes.begin() + 900, bytes.end()),
+            std::vector<uint8_t>(data, data + 124));
+  EXPECT_EQ(std::vector<uint8_t>(bytes.begin(), bytes.begin() + 500),
+            std::vector<uint8_t>(data + 124, data + size));
+}
+
+TEST(ByteQueueTest, CreateDecoderBufferSpanningChunksIsCopied) {
+  ByteQueue queue;
+  const std::vector<uint8_t> bytes = MakeBytes(0, 200);
+  queue.Push(bytes.data(), 100);
+  queue.Push(base::MakeRefCounted<base::RefCountedBytes>(
+      std::vector<uint8_t>(bytes.begin() + 100, bytes.end())));
+
+  scoped_refptr<DecoderBuffer> buffer = queue.CreateDecoderBuffer(90, 20);
+  ASSERT_EQ(20u, buffer->data_size());
+  EXPECT_EQ(std::vector<uint8_t>(bytes.begin() + 90, bytes.begin() + 110),
+            std::vector<uint8_t>(buffer->data(),
+                                 buffer->data() + buffer->data_size()));
+
+  // Bytes in the second chunk are not copied.
+  const uint8_t* data;
+  int size;
+  queue.Pop(100);
+  queue.PeekFront(&data, &size);
+  EXPECT_EQ(data + 10, queue.CreateDecoderBuffer(10, 5)->data());
+
+  EXPECT_EQ(0u, queue.CreateDecoderBuffer(100, 0)->data_size());
+}
+
+}  // namespace media
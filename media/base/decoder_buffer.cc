@@ -66,6 +66,15 @@ DecoderBuffer::DecoderBuffer(
       shared_mem_mapping_(std::move(shared_mem_mapping)),
       is_key_frame_(false) {}
 
+DecoderBuffer::DecoderBuffer(scoped_refptr<base::RefCountedMemory> memory,
+                             size_t offset,
+                             size_t size)
+    : size_(size),
+      side_data_size_(0),
+      ref_counted_memory_(std::move(memory)),
+      ref_counted_memory_offset_(offset),
+      is_key_frame_(false) {}
+
 DecoderBuffer::~DecoderBuffer() {
   data_.reset();
   side_data_.reset();
@@ -137,6 +146,18 @@ scoped_refptr<DecoderBuffer> DecoderBuffer::FromSharedMemoryRegion(
       new DecoderBuffer(std::move(unaligned_mapping), size));
 }
 
+// static
+scoped_refptr<DecoderBuffer> DecoderBuffer::FromRefCountedMemory(
+    scoped_refptr<base::RefCountedMemory> memory,
+    size_t offset,
+    size_t size) {
+  CHECK(memory);
+  CHECK_LE(offset, memory->size());
+  CHECK_LE(size, memory->size() - offset);
+  return base::WrapRefCounted(
+      new DecoderBuffer(std::move(memory), offset, size));
+}
+
 // static
 scoped_refptr<DecoderBuffer> DecoderBuffer::CreateEOSBuffer() {
   return base::WrapRefCounted(new DecoderBuffer(NULL, 0, NULL, 0));
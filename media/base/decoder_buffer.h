@@ -15,6 +15,7 @@
 #include "base/check.h"
 #include "base/memory/read_only_shared_memory_region.h"
 #include "base/memory/ref_counted.h"
+#include "base/memory/ref_counted_memory.h"
 #include "base/time/time.h"
 #include "build/build_config.h"
 #include "media/base/decrypt_config.h"
@@ -111,6 +112,16 @@ class MEDIA_EXPORT DecoderBuffer
       off_t offset,
       size_t size);
 
+  // Create a DecoderBuffer where data() of |size| bytes resides within |memory|
+  // at |offset|, without copying it. The buffer's |is_key_frame_| will default
+  // to false.
+  //
+  // The buffer keeps a reference to |memory|, whose bytes must not change.
+  static scoped_refptr<DecoderBuffer> FromRefCountedMemory(
+      scoped_refptr<base::RefCountedMemory> memory,
+      size_t offset,
+      size_t size);
+
   // Create a DecoderBuffer indicating we've reached end of stream.
   //
   // Calling any method other than end_of_stream() on the resulting buffer
@@ -146,6 +157,8 @@ class MEDIA_EXPORT DecoderBuffer
 
   const uint8_t* data() const {
     DCHECK(!end_of_stream());
+    if (ref_counted_memory_)
+      return ref_counted_memory_->front() + ref_counted_memory_offset_;
     if (shared_mem_mapping_ && shared_mem_mapping_->IsValid())
       return static_cast<const uint8_t*>(shared_mem_mapping_->memory());
     if (shm_)
@@ -158,6 +171,7 @@ class MEDIA_EXPORT DecoderBuffer
     DCHECK(!end_of_stream());
     DCHECK(!shm_);
     DCHECK(!shared_mem_mapping_);
+    DCHECK(!ref_counted_memory_);
     return data_.get();
   }
 
@@ -199,7 +213,9 @@ class MEDIA_EXPORT DecoderBuffer
   }
 
   // If there's no data in this buffer, it represents end of stream.
-  bool end_of_stream() const { return !shared_mem_mapping_ && !shm_ && !data_; }
+  bool end_of_stream() const {
+    return !ref_counted_memory_ && !shared_mem_mapping_ && !shm_ && !data_;
+  }
 
   bool is_key_frame() const {
     DCHECK(!end_of_stream());
@@ -239,6 +255,10 @@ class MEDIA_EXPORT DecoderBuffer
   DecoderBuffer(std::unique_ptr<ReadOnlyUnalignedMapping> shared_mem_mapping,
                 size_t size);
 
+  DecoderBuffer(scoped_refptr<base::RefCountedMemory> memory,
+                size_t offset,
+                size_t size);
+
   virtual ~DecoderBuffer();
 
   // Encoded data, if it is stored on the heap.
@@ -260,6 +280,11 @@ class MEDIA_EXPORT DecoderBuffer
   // Encoded data, if it is stored in SHM.
   std::unique_ptr<UnalignedSharedMemory> shm_;
 
+  // Encoded data, if it is stored at |ref_counted_memory_offset_| within
+  // memory shared with its producer, like a ByteQueue.
+  scoped_refptr<base::RefCountedMemory> ref_counted_memory_;
+  size_t ref_counted_memory_offset_ = 0;
+
   // Encryption parameters for the encoded data.
   std::unique_ptr<DecryptConfig> decrypt_config_;
 
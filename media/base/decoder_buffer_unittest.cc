@@ -11,6 +11,7 @@
 
 #include "base/cxx17_backports.h"
 #include "base/memory/read_only_shared_memory_region.h"
+#include "base/memory/ref_counted_memory.h"
 #include "base/memory/unsafe_shared_memory_region.h"
 #include "base/strings/string_util.h"
 #include "build/build_config.h"
@@ -78,6 +79,35 @@ TEST(DecoderBufferTest, FromArray) {
   EXPECT_FALSE(buffer->is_key_frame());
 }
 
+TEST(DecoderBufferTest, FromRefCountedMemory) {
+  const uint8_t kData[] = "XXXhello";
+  const size_t kDataSize = base::size(kData);
+  const size_t kDataOffset = 3;
+
+  auto memory = base::MakeRefCounted<base::RefCountedBytes>(kData, kDataSize);
+  scoped_refptr<DecoderBuffer> buffer(DecoderBuffer::FromRefCountedMemory(
+      memory, kDataOffset, kDataSize - kDataOffset));
+  ASSERT_TRUE(buffer.get());
+  EXPECT_EQ(memory->front() + kDataOffset, buffer->data());
+  EXPECT_EQ(buffer->data_size(), kDataSize - kDataOffset);
+  EXPECT_EQ(
+      0, memcmp(buffer->data(), kData + kDataOffset, kDataSize - kDataOffset));
+  EXPECT_FALSE(buffer->end_of_stream());
+  EXPECT_FALSE(buffer->is_key_frame());
+
+  // The buffer keeps the memory alive.
+  memory.reset();
+  EXPECT_EQ(
+      0, memcmp(buffer->data(), kData + kDataOffset, kDataSize - kDataOffset));
+
+  // An empty buffer is not the end of stream.
+  scoped_refptr<DecoderBuffer> empty_buffer(DecoderBuffer::FromRefCountedMemory(
+      base::MakeRefCounted<base::RefCountedBytes>(), 0, 0));
+  ASSERT_TRUE(empty_buffer.get());
+  EXPECT_EQ(0u, empty_buffer->data_size());
+  EXPECT_FALSE(empty_buffer->end_of_stream());
+}
+
 TEST(DecoderBufferTest, FromPlatformSharedMemoryRegion) {
   const uint8_t kData[] = "hello";
   const size_t kDataSize = base::size(kData);
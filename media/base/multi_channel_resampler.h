@@ -17,7 +17,8 @@ namespace media {
 class AudioBus;
 
 // MultiChannelResampler is a multi channel wrapper for SincResampler; allowing
-// high quality sample rate conversion of multiple channels at once.
+// high quality sample rate conversion of multiple channels at once.  All the
+// channels are resampled in lockstep by a single SincResampler.
 class MEDIA_EXPORT MultiChannelResampler {
  public:
   // Callback type for providing more data into the resampler.  Expects AudioBus
@@ -48,7 +49,7 @@ class MEDIA_EXPORT MultiChannelResampler {
   // not call while Resample() is in progress.
   void Flush();
 
-  // Update ratio for all SincResamplers.  SetRatio() will cause reconstruction
+  // Update ratio of the SincResampler.  SetRatio() will cause reconstruction
   // of the kernels used for resampling.  Not thread safe, do not call while
   // Resample() is in progress.
   void SetRatio(double io_sample_rate_ratio);
@@ -67,23 +68,25 @@ class MEDIA_EXPORT MultiChannelResampler {
   void PrimeWithSilence();
 
  private:
-  // SincResampler::ReadCB implementation.  ProvideInput() will be called for
-  // each channel (in channel order) as SincResampler needs more data.
-  void ProvideInput(int channel, int frames, float* destination);
+  // SincResampler::ReadCB implementation for a single channel.
+  void ProvideInput(int frames, float* destination);
+
+  // SincResampler::MultiChannelReadCB implementation.
+  void ProvideInputChannels(int frames, float* const* destinations);
 
   // Source of data for resampling.
   ReadCB read_cb_;
 
-  // Each channel has its own high quality resampler.
-  std::vector<std::unique_ptr<SincResampler>> resamplers_;
-
-  // Buffers for audio data going into SincResampler from ReadCB.
-  std::unique_ptr<AudioBus> resampler_audio_bus_;
+  // The high quality resampler of all the channels.
+  std::unique_ptr<SincResampler> resampler_;
 
-  // To avoid a memcpy() on the first channel we create a wrapped AudioBus where
-  // the first channel points to the |destination| provided to ProvideInput().
+  // To avoid a memcpy() we create a wrapped AudioBus where the channels point
+  // to the destinations provided to ProvideInput() or ProvideInputChannels().
   std::unique_ptr<AudioBus> wrapped_resampler_audio_bus_;
 
+  // The output channels of the current Resample() chunk.
+  std::vector<float*> output_channels_;
+
   // The number of output frames that have successfully been processed during
   // the current Resample() call.
   int output_frames_ready_;
@@ -4,6 +4,8 @@
 
 #include "media/base/multi_channel_resampler.h"
 
+#include <stdint.h>
+
 #include <cmath>
 #include <memory>
 
@@ -25,6 +27,10 @@ static const int kHighLatencySize = 8192;
 // sense since each error represents a larger portion of the total request.
 static const int kLowLatencySize = 128;
 
+// A request size whose channels aren't a multiple of the channel alignment
+// long, as used by AudioConverter for 10 ms buffers at 44.1 kHz.
+static const int kOddRequestSize = 441;
+
 // Test fill value.
 static const float kFillValue = 0.1f;
 
@@ -60,16 +66,23 @@ class MultiChannelResamplerTest
 
     float fill_value = fill_junk_values_ ? (1 / kFillValue) : kFillValue;
     EXPECT_EQ(audio_bus->channels(), audio_bus_->channels());
+    for (int i = 0; i < audio_bus->channels(); ++i) {
+      EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(audio_bus->channel(i)) %
+                        AudioBus::kChannelAlignment);
+    }
     for (int i = 0; i < audio_bus->channels(); ++i)
       for (int j = 0; j < audio_bus->frames(); ++j)
         audio_bus->channel(i)[j] = fill_value;
   }
 
-  void MultiChannelTest(int channels, int frames, double expected_max_rms_error,
-                        double expected_max_error) {
+  void MultiChannelTest(int channels,
+                        int frames,
+                        double expected_max_rms_error,
+                        double expected_max_error,
+                        int request_size = SincResampler::kDefaultRequestSize) {
     InitializeAudioData(channels, frames);
     MultiChannelResampler resampler(
-        channels, kScaleFactor, SincResampler::kDefaultRequestSize,
+        channels, kScaleFactor, request_size,
         base::BindRepeating(&MultiChannelResamplerTest::ProvideInput,
                             base::Unretained(this)));
 
@@ -135,6 +148,11 @@ TEST_P(MultiChannelResamplerTest, LowLatency) {
   LowLatencyTest(GetParam());
 }
 
+TEST_P(MultiChannelResamplerTest, OddRequestSize) {
+  MultiChannelTest(GetParam(), kHighLatencySize, kHighLatencyMaxRMSError,
+                   kHighLatencyMaxError, kOddRequestSize);
+}
+
 // Test common channel layouts: mono, stereo, 5.1, 7.1.
 INSTANTIATE_TEST_SUITE_P(MultiChannelResamplerTest,
                          MultiChannelResamplerTest,
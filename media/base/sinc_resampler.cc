@@ -77,12 +77,14 @@
 
 #include <limits>
 
+#include "base/bits.h"
 #include "base/check_op.h"
 #include "base/cpu.h"
 #include "base/numerics/math_constants.h"
 #include "base/trace_event/trace_event.h"
 #include "build/build_config.h"
 #include "cc/base/math_util.h"
+#include "media/base/audio_bus.h"
 
 #if defined(ARCH_CPU_X86_FAMILY)
 #include <immintrin.h>
@@ -118,18 +120,24 @@ static double SincScaleFactor(double io_ratio) {
 void SincResampler::InitializeCPUSpecificFeatures() {
 #if defined(ARCH_CPU_ARM_FAMILY) && defined(USE_NEON)
   convolve_proc_ = Convolve_NEON;
+  convolve_channels_proc_ = ConvolveChannels_NEON;
 #elif defined(ARCH_CPU_X86_FAMILY)
   base::CPU cpu;
   // Using AVX2 instead of SSE2 when AVX2/FMA3 supported.
-  if (cpu.has_avx2() && cpu.has_fma3())
+  if (cpu.has_avx2() && cpu.has_fma3()) {
     convolve_proc_ = Convolve_AVX2;
-  else if (cpu.has_sse2())
+    convolve_channels_proc_ = ConvolveChannels_AVX2;
+  } else if (cpu.has_sse2()) {
     convolve_proc_ = Convolve_SSE;
-  else
+    convolve_channels_proc_ = ConvolveChannels_SSE;
+  } else {
     convolve_proc_ = Convolve_C;
+    convolve_channels_proc_ = ConvolveChannels_C;
+  }
 #else
   // Unknown architecture.
   convolve_proc_ = Convolve_C;
+  convolve_channels_proc_ = ConvolveChannels_C;
 #endif
 }
 
@@ -140,9 +148,33 @@ static int CalculateChunkSize(int block_size_, double io_ratio) {
 SincResampler::SincResampler(double io_sample_rate_ratio,
                              int request_frames,
                              const ReadCB read_cb)
+    : SincResampler(1,
+                    io_sample_rate_ratio,
+                    request_frames,
+                    std::move(read_cb),
+                    MultiChannelReadCB()) {}
+
+SincResampler::SincResampler(int channels,
+                             double io_sample_rate_ratio,
+                             int request_frames,
+                             const MultiChannelReadCB read_cb)
+    : SincResampler(channels,
+                    io_sample_rate_ratio,
+                    request_frames,
+                    ReadCB(),
+                    std::move(read_cb)) {}
+
+SincResampler::SincResampler(int channels,
+                             double io_sample_rate_ratio,
+                             int request_frames,
+                             const ReadCB read_cb,
+                             const MultiChannelReadCB multi_channel_read_cb)
     : io_sample_rate_ratio_(io_sample_rate_ratio),
       read_cb_(std::move(read_cb)),
+      multi_channel_read_cb_(std::move(multi_channel_read_cb)),
       request_frames_(request_frames),
+      channels_(channels),
+      channel_stride_(channels <= 2 ? channels : (channels + 3) & ~3),
       input_buffer_size_(request_frames_ + kKernelSize),
       // Create input buffers with a 32-byte alignment for SIMD optimizations.
       kernel_storage_(static_cast<float*>(
@@ -151,19 +183,41 @@ SincResampler::SincResampler(double io_sample_rate_ratio,
           base::AlignedAlloc(sizeof(float) * kKernelStorageSize, 32))),
       kernel_window_storage_(static_cast<float*>(
           base::AlignedAlloc(sizeof(float) * kKernelStorageSize, 32))),
-      input_buffer_(static_cast<float*>(
-          base::AlignedAlloc(sizeof(float) * input_buffer_size_, 32))),
+      input_buffer_(static_cast<float*>(base::AlignedAlloc(
+          sizeof(float) * input_buffer_size_ * channel_stride_,
+          32))),
       r1_(input_buffer_.get()),
-      r2_(input_buffer_.get() + kKernelSize / 2) {
+      r2_(input_buffer_.get() + kKernelSize / 2 * channel_stride_) {
   CHECK_GT(request_frames, kKernelSize * 3 / 2)
       << "request_frames must be greater than 1.5 kernels to allow sufficient "
          "data for resampling";
+  CHECK_GT(channels_, 0);
   // This means that after the first call to Flush we will have
   // block_size_ > kKernelSize and r2_ < r3_.
 
   InitializeCPUSpecificFeatures();
   DCHECK(convolve_proc_);
+  DCHECK(convolve_channels_proc_);
   CHECK_GT(request_frames_, 0);
+
+  if (multi_channel_read_cb_) {
+    // Each channel starts on an AudioBus::kChannelAlignment boundary, since
+    // MultiChannelResampler wraps them in an AudioBus.
+    const size_t channel_input_stride = base::bits::AlignUp(
+        static_cast<size_t>(request_frames_),
+        AudioBus::kChannelAlignment / sizeof(float));
+    channel_input_buffer_.reset(static_cast<float*>(base::AlignedAlloc(
+        sizeof(float) * channel_input_stride * channels_, 32)));
+    channel_input_.reserve(channels_);
+    for (int ch = 0; ch < channels_; ++ch)
+      channel_input_.push_back(channel_input_buffer_.get() +
+                               ch * channel_input_stride);
+  }
+  if (channels_ > 1) {
+    channel_output_.reset(static_cast<float*>(
+        base::AlignedAlloc(sizeof(float) * channel_stride_, 32)));
+  }
+
   Flush();
 
   memset(kernel_storage_.get(), 0,
@@ -181,10 +235,11 @@ SincResampler::~SincResampler() = default;
 void SincResampler::UpdateRegions(bool second_load) {
   // Setup various region pointers in the buffer (see diagram above).  If we're
   // on the second load we need to slide r0_ to the right by kKernelSize / 2.
-  r0_ = input_buffer_.get() + (second_load ? kKernelSize : kKernelSize / 2);
-  r3_ = r0_ + request_frames_ - kKernelSize;
-  r4_ = r0_ + request_frames_ - kKernelSize / 2;
-  block_size_ = r4_ - r2_;
+  r0_ = input_buffer_.get() +
+        (second_load ? kKernelSize : kKernelSize / 2) * channel_stride_;
+  r3_ = r0_ + (request_frames_ - kKernelSize) * channel_stride_;
+  r4_ = r0_ + (request_frames_ - kKernelSize / 2) * channel_stride_;
+  block_size_ = (r4_ - r2_) / channel_stride_;
   chunk_size_ = CalculateChunkSize(block_size_, io_sample_rate_ratio_);
 
   // r1_ at the beginning of the buffer.
@@ -257,13 +312,22 @@ void SincResampler::SetRatio(double io_sample_rate_ratio) {
 }
 
 void SincResampler::Resample(int frames, float* destination) {
+  DCHECK_EQ(channels_, 1);
+  ResampleChannels(frames, &destination);
+}
+
+void SincResampler::ResampleChannels(int frames, float* const* destinations) {
   TRACE_EVENT1(TRACE_DISABLED_BY_DEFAULT("audio"), "SincResampler::Resample",
                "io sample rate ratio", io_sample_rate_ratio_);
   int remaining_frames = frames;
+  int output_idx = 0;
 
   // Step (1) -- Prime the input buffer at the start of the input stream.
   if (!buffer_primed_ && remaining_frames) {
-    read_cb_.Run(request_frames_, r0_.get());
+    if (read_cb_)
+      read_cb_.Run(request_frames_, r0_.get());
+    else
+      ReadChannels();
     buffer_primed_ = true;
   }
 
@@ -293,13 +357,22 @@ void SincResampler::Resample(int frames, float* destination) {
         DCHECK_EQ(0u, reinterpret_cast<uintptr_t>(k2) & 0x1F);
 
         // Initialize input pointer based on quantized |virtual_source_idx_|.
-        const float* input_ptr = r1_ + source_idx;
+        const float* input_ptr = r1_ + source_idx * channel_stride_;
 
         // Figure out how much to weight each kernel's "convolution".
         const double kernel_interpolation_factor =
             virtual_offset_idx - offset_idx;
-        *destination++ =
-            convolve_proc_(input_ptr, k1, k2, kernel_interpolation_factor);
+        if (channels_ == 1) {
+          destinations[0][output_idx] =
+              convolve_proc_(input_ptr, k1, k2, kernel_interpolation_factor);
+        } else {
+          convolve_channels_proc_(input_ptr, channel_stride_, k1, k2,
+                                  kernel_interpolation_factor,
+                                  channel_output_.get());
+          for (int ch = 0; ch < channels_; ++ch)
+            destinations[ch][output_idx] = channel_output_[ch];
+        }
+        ++output_idx;
 
         // Advance the virtual index.
         virtual_source_idx_ += io_sample_rate_ratio_;
@@ -314,14 +387,31 @@ void SincResampler::Resample(int frames, float* destination) {
 
     // Step (3) -- Copy r3_, r4_ to r1_, r2_.
     // This wraps the last input frames back to the start of the buffer.
-    memcpy(r1_, r3_, sizeof(*input_buffer_.get()) * kKernelSize);
+    memcpy(r1_, r3_,
+           sizeof(*input_buffer_.get()) * kKernelSize * channel_stride_);
 
     // Step (4) -- Reinitialize regions if necessary.
     if (r0_ == r2_)
       UpdateRegions(true);
 
     // Step (5) -- Refresh the buffer with more input.
-    read_cb_.Run(request_frames_, r0_.get());
+    if (read_cb_)
+      read_cb_.Run(request_frames_, r0_.get());
+    else
+      ReadChannels();
+  }
+}
+
+void SincResampler::ReadChannels() {
+  multi_channel_read_cb_.Run(request_frames_, channel_input_.data());
+
+  // Interleave the channels, leaving the padding of each frame untouched; it
+  // stays zero since Flush().
+  float* destination = r0_;
+  for (int i = 0; i < request_frames_; ++i) {
+    for (int ch = 0; ch < channels_; ++ch)
+      destination[ch] = channel_input_[ch][i];
+    destination += channel_stride_;
   }
 }
 
@@ -337,7 +427,7 @@ void SincResampler::Flush() {
   virtual_source_idx_ = 0;
   buffer_primed_ = false;
   memset(input_buffer_.get(), 0,
-         sizeof(*input_buffer_.get()) * input_buffer_size_);
+         sizeof(*input_buffer_.get()) * input_buffer_size_ * channel_stride_);
   UpdateRegions(false);
 }
 
@@ -372,6 +462,27 @@ float SincResampler::Convolve_C(const float* input_ptr, const float* k1,
       kernel_interpolation_factor * sum2);
 }
 
+void SincResampler::ConvolveChannels_C(const float* input_ptr,
+                                       int channel_stride,
+                                       const float* k1,
+                                       const float* k2,
+                                       double kernel_interpolation_factor,
+                                       float* output) {
+  // Linearly interpolate the two kernels once for all the channels.
+  const float factor = static_cast<float>(kernel_interpolation_factor);
+  float kernel[kKernelSize];
+  for (int i = 0; i < kKernelSize; ++i)
+    kernel[i] = k1[i] + factor * (k2[i] - k1[i]);
+
+  // Generate an output sample for each channel, a frame at a time.
+  memset(output, 0, sizeof(*output) * channel_stride);
+  for (int i = 0; i < kKernelSize; ++i) {
+    for (int ch = 0; ch < channel_stride; ++ch)
+      output[ch] += input_ptr[ch] * kernel[i];
+    input_ptr += channel_stride;
+  }
+}
+
 #if defined(ARCH_CPU_X86_FAMILY)
 float SincResampler::Convolve_SSE(const float* input_ptr, const float* k1,
                                   const float* k2,
@@ -458,6 +569,145 @@ __attribute__((target("avx2,fma"))) float SincResampler::Convolve_AVX2(
 
   return result;
 }
+
+void SincResampler::ConvolveChannels_SSE(const float* input_ptr,
+                                         int channel_stride,
+                                         const float* k1,
+                                         const float* k2,
+                                         double kernel_interpolation_factor,
+                                         float* output) {
+  DCHECK(channel_stride == 2 || channel_stride % 4 == 0);
+
+  // Linearly interpolate the two kernels once for all the channels.
+  alignas(16) float kernel[kKernelSize];
+  const __m128 m_factor =
+      _mm_set_ps1(static_cast<float>(kernel_interpolation_factor));
+  for (int i = 0; i < kKernelSize; i += 4) {
+    const __m128 m_k1 = _mm_load_ps(k1 + i);
+    _mm_store_ps(kernel + i,
+                 _mm_add_ps(m_k1, _mm_mul_ps(m_factor, _mm_sub_ps(
+                                                 _mm_load_ps(k2 + i), m_k1))));
+  }
+
+  // With two channels, each vector holds two frames, which are multiplied with
+  // the kernel duplicated for each channel.
+  if (channel_stride == 2) {
+    __m128 m_sums1 = _mm_setzero_ps();
+    __m128 m_sums2 = _mm_setzero_ps();
+    for (int i = 0; i < kKernelSize; i += 4) {
+      const __m128 m_kernel = _mm_load_ps(kernel + i);
+      m_sums1 = _mm_add_ps(m_sums1, _mm_mul_ps(_mm_loadu_ps(input_ptr),
+                                               _mm_unpacklo_ps(m_kernel,
+                                                               m_kernel)));
+      m_sums2 = _mm_add_ps(m_sums2, _mm_mul_ps(_mm_loadu_ps(input_ptr + 4),
+                                               _mm_unpackhi_ps(m_kernel,
+                                                               m_kernel)));
+      input_ptr += 8;
+    }
+    m_sums1 = _mm_add_ps(m_sums1, m_sums2);
+    m_sums1 = _mm_add_ps(m_sums1, _mm_movehl_ps(m_sums1, m_sums1));
+    _mm_storel_pi(reinterpret_cast<__m64*>(output), m_sums1);
+    return;
+  }
+
+  // Convolve 4 channels at a time, with a sum for the even and one for the
+  // odd frames to shorten the dependency chains.
+  for (int ch = 0; ch < channel_stride; ch += 4) {
+    const float* input = input_ptr + ch;
+    __m128 m_sums1 = _mm_setzero_ps();
+    __m128 m_sums2 = _mm_setzero_ps();
+    for (int i = 0; i < kKernelSize; i += 2) {
+      m_sums1 = _mm_add_ps(
+          m_sums1, _mm_mul_ps(_mm_loadu_ps(input), _mm_set_ps1(kernel[i])));
+      m_sums2 = _mm_add_ps(m_sums2,
+                           _mm_mul_ps(_mm_loadu_ps(input + channel_stride),
+                                      _mm_set_ps1(kernel[i + 1])));
+      input += 2 * channel_stride;
+    }
+    _mm_storeu_ps(output + ch, _mm_add_ps(m_sums1, m_sums2));
+  }
+}
+
+__attribute__((target("avx2,fma"))) void SincResampler::ConvolveChannels_AVX2(
+    const float* input_ptr,
+    int channel_stride,
+    const float* k1,
+    const float* k2,
+    double kernel_interpolation_factor,
+    float* output) {
+  DCHECK(channel_stride == 2 || channel_stride % 4 == 0);
+
+  // Linearly interpolate the two kernels once for all the channels.
+  alignas(32) float kernel[kKernelSize];
+  const __m256 m_factor =
+      _mm256_set1_ps(static_cast<float>(kernel_interpolation_factor));
+  for (int i = 0; i < kKernelSize; i += 8) {
+    const __m256 m_k1 = _mm256_load_ps(k1 + i);
+    _mm256_store_ps(kernel + i,
+                    _mm256_fmadd_ps(m_factor,
+                                    _mm256_sub_ps(_mm256_load_ps(k2 + i), m_k1),
+                                    m_k1));
+  }
+
+  // With two channels, each vector holds four frames, which are multiplied
+  // with the kernel duplicated for each channel.
+  if (channel_stride == 2) {
+    __m256 m_sums1 = _mm256_setzero_ps();
+    __m256 m_sums2 = _mm256_setzero_ps();
+    for (int i = 0; i < kKernelSize; i += 8) {
+      // Duplicating within lanes keeps the kernel order of the pairs in each
+      // half, so the input is multiplied by frames 0, 1, 4, 5 and 2, 3, 6, 7.
+      const __m256 m_kernel = _mm256_load_ps(kernel + i);
+      const __m256 m_input1 = _mm256_loadu_ps(input_ptr);
+      const __m256 m_input2 = _mm256_loadu_ps(input_ptr + 8);
+      m_sums1 = _mm256_fmadd_ps(
+          _mm256_permute2f128_ps(m_input1, m_input2, 0x20),
+          _mm256_unpacklo_ps(m_kernel, m_kernel), m_sums1);
+      m_sums2 = _mm256_fmadd_ps(
+          _mm256_permute2f128_ps(m_input1, m_input2, 0x31),
+          _mm256_unpackhi_ps(m_kernel, m_kernel), m_sums2);
+      input_ptr += 16;
+    }
+    const __m256 m_sums = _mm256_add_ps(m_sums1, m_sums2);
+    __m128 m128_sums = _mm_add_ps(_mm256_extractf128_ps(m_sums, 0),
+                                  _mm256_extractf128_ps(m_sums, 1));
+    m128_sums = _mm_add_ps(m128_sums, _mm_movehl_ps(m128_sums, m128_sums));
+    _mm_storel_pi(reinterpret_cast<__m64*>(output), m128_sums);
+    return;
+  }
+
+  // Convolve 8 channels at a time, with a sum for the even and one for the
+  // odd frames to shorten the dependency chains.
+  int ch = 0;
+  for (; ch + 8 <= channel_stride; ch += 8) {
+    const float* input = input_ptr + ch;
+    __m256 m_sums1 = _mm256_setzero_ps();
+    __m256 m_sums2 = _mm256_setzero_ps();
+    for (int i = 0; i < kKernelSize; i += 2) {
+      m_sums1 = _mm256_fmadd_ps(_mm256_loadu_ps(input),
+                                _mm256_broadcast_ss(kernel + i), m_sums1);
+      m_sums2 = _mm256_fmadd_ps(_mm256_loadu_ps(input + channel_stride),
+                                _mm256_broadcast_ss(kernel + i + 1), m_sums2);
+      input += 2 * channel_stride;
+    }
+    _mm256_storeu_ps(output + ch, _mm256_add_ps(m_sums1, m_sums2));
+  }
+
+  // Convolve the last 4 channels, if any.
+  if (ch < channel_stride) {
+    const float* input = input_ptr + ch;
+    __m128 m_sums1 = _mm_setzero_ps();
+    __m128 m_sums2 = _mm_setzero_ps();
+    for (int i = 0; i < kKernelSize; i += 2) {
+      m_sums1 = _mm_fmadd_ps(_mm_loadu_ps(input), _mm_broadcast_ss(kernel + i),
+                             m_sums1);
+      m_sums2 = _mm_fmadd_ps(_mm_loadu_ps(input + channel_stride),
+                             _mm_broadcast_ss(kernel + i + 1), m_sums2);
+      input += 2 * channel_stride;
+    }
+    _mm_storeu_ps(output + ch, _mm_add_ps(m_sums1, m_sums2));
+  }
+}
 #elif defined(ARCH_CPU_ARM_FAMILY) && defined(USE_NEON)
 float SincResampler::Convolve_NEON(const float* input_ptr, const float* k1,
                                    const float* k2,
@@ -485,6 +735,57 @@ float SincResampler::Convolve_NEON(const float* input_ptr, const float* k1,
   float32x2_t m_half = vadd_f32(vget_high_f32(m_sums1), vget_low_f32(m_sums1));
   return vget_lane_f32(vpadd_f32(m_half, m_half), 0);
 }
+
+void SincResampler::ConvolveChannels_NEON(const float* input_ptr,
+                                          int channel_stride,
+                                          const float* k1,
+                                          const float* k2,
+                                          double kernel_interpolation_factor,
+                                          float* output) {
+  DCHECK(channel_stride == 2 || channel_stride % 4 == 0);
+
+  // Linearly interpolate the two kernels once for all the channels.
+  float kernel[kKernelSize];
+  const float32x4_t m_factor = vmovq_n_f32(kernel_interpolation_factor);
+  for (int i = 0; i < kKernelSize; i += 4) {
+    const float32x4_t m_k1 = vld1q_f32(k1 + i);
+    vst1q_f32(kernel + i,
+              vmlaq_f32(m_k1, m_factor, vsubq_f32(vld1q_f32(k2 + i), m_k1)));
+  }
+
+  // With two channels, each vector holds two frames, which are multiplied with
+  // the kernel duplicated for each channel.
+  if (channel_stride == 2) {
+    float32x4_t m_sums1 = vmovq_n_f32(0);
+    float32x4_t m_sums2 = vmovq_n_f32(0);
+    for (int i = 0; i < kKernelSize; i += 4) {
+      const float32x4_t m_kernel = vld1q_f32(kernel + i);
+      const float32x4x2_t m_kernel_pairs = vzipq_f32(m_kernel, m_kernel);
+      m_sums1 = vmlaq_f32(m_sums1, vld1q_f32(input_ptr), m_kernel_pairs.val[0]);
+      m_sums2 =
+          vmlaq_f32(m_sums2, vld1q_f32(input_ptr + 4), m_kernel_pairs.val[1]);
+      input_ptr += 8;
+    }
+    m_sums1 = vaddq_f32(m_sums1, m_sums2);
+    vst1_f32(output, vadd_f32(vget_low_f32(m_sums1), vget_high_f32(m_sums1)));
+    return;
+  }
+
+  // Convolve 4 channels at a time, with a sum for the even and one for the
+  // odd frames to shorten the dependency chains.
+  for (int ch = 0; ch < channel_stride; ch += 4) {
+    const float* input = input_ptr + ch;
+    float32x4_t m_sums1 = vmovq_n_f32(0);
+    float32x4_t m_sums2 = vmovq_n_f32(0);
+    for (int i = 0; i < kKernelSize; i += 2) {
+      m_sums1 = vmlaq_n_f32(m_sums1, vld1q_f32(input), kernel[i]);
+      m_sums2 = vmlaq_n_f32(m_sums2, vld1q_f32(input + channel_stride),
+                            kernel[i + 1]);
+      input += 2 * channel_stride;
+    }
+    vst1q_f32(output + ch, vaddq_f32(m_sums1, m_sums2));
+  }
+}
 #endif
 
 }  // namespace media
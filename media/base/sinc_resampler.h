@@ -6,6 +6,7 @@
 #define MEDIA_BASE_SINC_RESAMPLER_H_
 
 #include <memory>
+#include <vector>
 
 #include "base/callback.h"
 #include "base/gtest_prod_util.h"
@@ -16,7 +17,8 @@
 
 namespace media {
 
-// SincResampler is a high-quality single-channel sample-rate converter.
+// SincResampler is a high-quality sample-rate converter.  It converts a single
+// channel, or several channels in lockstep; see the multi-channel constructor.
 class MEDIA_EXPORT SincResampler {
  public:
   enum {
@@ -41,6 +43,13 @@ class MEDIA_EXPORT SincResampler {
   // are available to satisfy the request.
   typedef base::RepeatingCallback<void(int frames, float* destination)> ReadCB;
 
+  // Callback type for providing more data into a multi-channel resampler.
+  // Expects |frames| of data to be rendered into each of the planar channel
+  // |destinations|; zero padded if not enough frames are available to satisfy
+  // the request.
+  typedef base::RepeatingCallback<void(int frames, float* const* destinations)>
+      MultiChannelReadCB;
+
   // Constructs a SincResampler with the specified |read_cb|, which is used to
   // acquire audio data for resampling.  |io_sample_rate_ratio| is the ratio
   // of input / output sample rates.  |request_frames| controls the size in
@@ -51,14 +60,31 @@ class MEDIA_EXPORT SincResampler {
                 int request_frames,
                 const ReadCB read_cb);
 
+  // Constructs a SincResampler which resamples |channels| channels in lockstep.
+  // The channels share the kernel selection and interpolation for each output
+  // frame, and are convolved together from channel-interleaved storage, which
+  // is faster than a SincResampler per channel.  The other parameters are as
+  // above.
+  SincResampler(int channels,
+                double io_sample_rate_ratio,
+                int request_frames,
+                const MultiChannelReadCB read_cb);
+
   SincResampler(const SincResampler&) = delete;
   SincResampler& operator=(const SincResampler&) = delete;
 
   ~SincResampler();
 
-  // Resample |frames| of data from |read_cb_| into |destination|.
+  // Resample |frames| of data from |read_cb_| into |destination|.  Only valid
+  // for a single-channel resampler.
   void Resample(int frames, float* destination);
 
+  // Resample |frames| of data for each channel from |multi_channel_read_cb_|
+  // into the planar channel |destinations|.
+  void ResampleChannels(int frames, float* const* destinations);
+
+  int channels() const { return channels_; }
+
   // The maximum size in frames that guarantees Resample() will only make a
   // single call to |read_cb_| for more data.  Note: If PrimeWithSilence() is
   // not called, chunk size will grow after the first two Resample() calls by
@@ -93,13 +119,25 @@ class MEDIA_EXPORT SincResampler {
 
  private:
   FRIEND_TEST_ALL_PREFIXES(SincResamplerTest, Convolve);
+  FRIEND_TEST_ALL_PREFIXES(SincResamplerTest, ConvolveChannels);
   FRIEND_TEST_ALL_PREFIXES(SincResamplerPerfTest, Convolve_unoptimized_aligned);
   FRIEND_TEST_ALL_PREFIXES(SincResamplerPerfTest, Convolve_optimized_aligned);
   FRIEND_TEST_ALL_PREFIXES(SincResamplerPerfTest, Convolve_optimized_unaligned);
+  FRIEND_TEST_ALL_PREFIXES(SincResamplerPerfTest, ConvolveChannels);
+
+  SincResampler(int channels,
+                double io_sample_rate_ratio,
+                int request_frames,
+                const ReadCB read_cb,
+                const MultiChannelReadCB multi_channel_read_cb);
 
   void InitializeKernel();
   void UpdateRegions(bool second_load);
 
+  // Reads |request_frames_| of each channel from |multi_channel_read_cb_| and
+  // interleaves them into |r0_|.
+  void ReadChannels();
+
   // Compute convolution of |k1| and |k2| over |input_ptr|, resultant sums are
   // linearly interpolated using |kernel_interpolation_factor|.  On x86, the
   // underlying implementation is chosen at run time based on SSE support.  On
@@ -120,6 +158,40 @@ class MEDIA_EXPORT SincResampler {
                              double kernel_interpolation_factor);
 #endif
 
+  // Compute convolution of the kernel linearly interpolated between |k1| and
+  // |k2| using |kernel_interpolation_factor| over each of the |channel_stride|
+  // channels interleaved at |input_ptr|, and write the sums to |output|.  The
+  // kernel is interpolated once for all channels.  Except for the C version,
+  // |channel_stride| must be 2 or a multiple of 4.  The implementation is
+  // chosen like the Convolve() one.
+  static void ConvolveChannels_C(const float* input_ptr,
+                                 int channel_stride,
+                                 const float* k1,
+                                 const float* k2,
+                                 double kernel_interpolation_factor,
+                                 float* output);
+#if defined(ARCH_CPU_X86_FAMILY)
+  static void ConvolveChannels_SSE(const float* input_ptr,
+                                   int channel_stride,
+                                   const float* k1,
+                                   const float* k2,
+                                   double kernel_interpolation_factor,
+                                   float* output);
+  static void ConvolveChannels_AVX2(const float* input_ptr,
+                                    int channel_stride,
+                                    const float* k1,
+                                    const float* k2,
+                                    double kernel_interpolation_factor,
+                                    float* output);
+#elif defined(ARCH_CPU_ARM_FAMILY) && defined(USE_NEON)
+  static void ConvolveChannels_NEON(const float* input_ptr,
+                                    int channel_stride,
+                                    const float* k1,
+                                    const float* k2,
+                                    double kernel_interpolation_factor,
+                                    float* output);
+#endif
+
   // Selects runtime specific CPU features like SSE.  Must be called before
   // using SincResampler.
   void InitializeCPUSpecificFeatures();
@@ -134,12 +206,21 @@ class MEDIA_EXPORT SincResampler {
   // The buffer is primed once at the very beginning of processing.
   bool buffer_primed_;
 
-  // Source of data for resampling.
+  // Source of data for resampling.  Only one of them is set, depending on the
+  // constructor used.
   const ReadCB read_cb_;
+  const MultiChannelReadCB multi_channel_read_cb_;
 
   // The size (in samples) to request from each |read_cb_| execution.
   const int request_frames_;
 
+  // The number of channels, and the distance in samples between consecutive
+  // frames in |input_buffer_|.  The channels of a frame are interleaved and,
+  // beyond two channels, padded to a multiple of 4 samples for SIMD
+  // optimizations.
+  const int channels_;
+  const int channel_stride_;
+
   // The number of source frames processed per pass.
   int block_size_;
 
@@ -147,7 +228,7 @@ class MEDIA_EXPORT SincResampler {
   // guarantees Resample() will only ask for input at most once.
   int chunk_size_;
 
-  // The size (in samples) of the internal buffer used by the resampler.
+  // The size (in frames) of the internal buffer used by the resampler.
   const int input_buffer_size_;
 
   // Contains kKernelOffsetCount kernels back-to-back, each of size kKernelSize.
@@ -166,6 +247,18 @@ class MEDIA_EXPORT SincResampler {
                                  const float*,
                                  double);
   ConvolveProc convolve_proc_;
+  using ConvolveChannelsProc =
+      void (*)(const float*, int, const float*, const float*, double, float*);
+  ConvolveChannelsProc convolve_channels_proc_;
+
+  // Planar buffers for each channel, which |multi_channel_read_cb_| renders
+  // into before they are interleaved into |input_buffer_|.  Unused with a
+  // single-channel |read_cb_|.
+  std::unique_ptr<float[], base::AlignedFreeDeleter> channel_input_buffer_;
+  std::vector<float*> channel_input_;
+
+  // Output of |convolve_channels_proc_| for one frame of all channels.
+  std::unique_ptr<float[], base::AlignedFreeDeleter> channel_output_;
 
   // Pointers to the various regions inside |input_buffer_|.  See the diagram at
   // the top of the .cc file for more information.
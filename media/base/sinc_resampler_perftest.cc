@@ -2,9 +2,12 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <vector>
+
 #include "base/bind.h"
 #include "base/callback_helpers.h"
 #include "base/cpu.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/time/time.h"
 #include "build/build_config.h"
 #include "media/base/sinc_resampler.h"
@@ -76,4 +79,35 @@ TEST(SincResamplerPerfTest, Convolve_optimized_unaligned) {
 #endif
 }
 
+// Benchmark for the ConvolveChannels() method chosen at run time, which is
+// reported per output sample to compare with the Convolve() ones above.
+TEST(SincResamplerPerfTest, ConvolveChannels) {
+  for (int channels : {2, 6, 8, 16}) {
+    SincResampler resampler(channels, kSampleRateRatio,
+                            SincResampler::kDefaultRequestSize,
+                            base::DoNothing());
+    const int channel_stride = resampler.channel_stride_;
+    const float* kernel = resampler.get_kernel_for_testing();
+    std::vector<float> input(SincResampler::kKernelSize * channel_stride,
+                             0.5f);
+    std::vector<float> output(channel_stride);
+
+    const int iterations = kBenchmarkIterations / channels;
+    base::TimeTicks start = base::TimeTicks::Now();
+    for (int i = 0; i < iterations; ++i) {
+      resampler.convolve_channels_proc_(input.data(), channel_stride, kernel,
+                                        kernel, kKernelInterpolationFactor,
+                                        output.data());
+    }
+    double total_time_seconds = (base::TimeTicks::Now() - start).InSecondsF();
+
+    perf_test::PerfResultReporter reporter(
+        "sinc_resampler",
+        "optimized_" + base::NumberToString(channels) + "_channels");
+    reporter.RegisterImportantMetric("_convolve", "runs/s");
+    reporter.AddResult("_convolve",
+                       iterations * channels / total_time_seconds);
+  }
+}
+
 } // namespace media
@@ -3,6 +3,7 @@
 // found in the LICENSE file.
 
 #include <memory>
+#include <vector>
 
 #include "base/bind.h"
 #include "base/callback_helpers.h"
@@ -183,6 +184,47 @@ TEST(SincResamplerTest, Convolve) {
   EXPECT_NEAR(result2, result, kEpsilon);
 }
 
+// Ensure the optimized ConvolveChannels() methods return the same values as
+// ConvolveChannels_C(), and the latter the same as Convolve_C() per channel.
+TEST(SincResamplerTest, ConvolveChannels) {
+  // Initialize a dummy resampler.
+  MockSource mock_source;
+  SincResampler resampler(kSampleRateRatio, SincResampler::kDefaultRequestSize,
+                          base::BindRepeating(&MockSource::ProvideInput,
+                                              base::Unretained(&mock_source)));
+
+  // Interpolating the kernels before the convolution rounds differently, so
+  // comparison must be done using an epsilon.
+  static const double kEpsilon = 0.000001;
+
+  const float* k1 = resampler.kernel_storage_.get();
+  const float* k2 = k1 + SincResampler::kKernelSize;
+  for (int channel_stride : {2, 4, 8, 12, 16}) {
+    SCOPED_TRACE(channel_stride);
+
+    // Use the kernel at a different offset for each channel as input.
+    std::vector<float> input(SincResampler::kKernelSize * channel_stride);
+    for (int i = 0; i < SincResampler::kKernelSize; ++i) {
+      for (int ch = 0; ch < channel_stride; ++ch)
+        input[i * channel_stride + ch] = k1[i + ch];
+    }
+
+    std::vector<float> result(channel_stride);
+    std::vector<float> result2(channel_stride);
+    resampler.ConvolveChannels_C(input.data(), channel_stride, k1, k2,
+                                 kKernelInterpolationFactor, result.data());
+    resampler.convolve_channels_proc_(input.data(), channel_stride, k1, k2,
+                                      kKernelInterpolationFactor,
+                                      result2.data());
+    for (int ch = 0; ch < channel_stride; ++ch) {
+      EXPECT_NEAR(resampler.Convolve_C(k1 + ch, k1, k2,
+                                       kKernelInterpolationFactor),
+                  result[ch], kEpsilon);
+      EXPECT_NEAR(result2[ch], result[ch], kEpsilon);
+    }
+  }
+}
+
 // Fake audio source for testing the resampler.  Generates a sinusoidal linear
 // chirp (http://en.wikipedia.org/wiki/Chirp) which can be tuned to stress the
 // resampler for the specific sample rate conversion being used.
@@ -399,6 +441,87 @@ INSTANTIATE_TEST_SUITE_P(
         std::make_tuple(96000, 192000, kResamplingRMSError, -73.52),
         std::make_tuple(192000, 192000, kResamplingRMSError, -73.52)));
 
+// Fake multi-channel audio source for testing the resampler, with a chirp of a
+// different maximum frequency on each channel.
+class MultiChannelChirpSource {
+ public:
+  MultiChannelChirpSource(int channels, int sample_rate, int samples) {
+    for (int ch = 0; ch < channels; ++ch) {
+      sources_.push_back(std::make_unique<SinusoidalLinearChirpSource>(
+          sample_rate, samples, 0.5 * sample_rate * (ch + 1) / channels));
+    }
+  }
+
+  void ProvideInput(int frames, float* const* destinations) {
+    for (size_t ch = 0; ch < sources_.size(); ++ch)
+      sources_[ch]->ProvideInput(frames, destinations[ch]);
+  }
+
+  void ProvideChannelInput(int channel, int frames, float* destination) {
+    sources_[channel]->ProvideInput(frames, destination);
+  }
+
+ private:
+  std::vector<std::unique_ptr<SinusoidalLinearChirpSource>> sources_;
+};
+
+// Ensure resampling several channels together matches resampling each channel
+// with its own resampler.
+TEST(SincResamplerTest, MultiChannelResample) {
+  static const int kInputRate = 44100;
+  static const int kOutputRate = 48000;
+  static const int kOutputFrames = 441;
+  static const int kIterations = 20;
+  // Interpolating the kernels before the convolution rounds differently.
+  static const double kEpsilon = 0.00001;
+
+  const double io_ratio = kInputRate / static_cast<double>(kOutputRate);
+  for (int channels : {2, 3, 6, 8, 16}) {
+    SCOPED_TRACE(channels);
+
+    MultiChannelChirpSource source(channels, kInputRate, kInputRate);
+    SincResampler resampler(
+        channels, io_ratio, SincResampler::kDefaultRequestSize,
+        base::BindRepeating(&MultiChannelChirpSource::ProvideInput,
+                            base::Unretained(&source)));
+    EXPECT_EQ(channels, resampler.channels());
+
+    MultiChannelChirpSource expected_source(channels, kInputRate, kInputRate);
+    std::vector<std::unique_ptr<SincResampler>> expected_resamplers;
+    for (int ch = 0; ch < channels; ++ch) {
+      expected_resamplers.push_back(std::make_unique<SincResampler>(
+          io_ratio, SincResampler::kDefaultRequestSize,
+          base::BindRepeating(&MultiChannelChirpSource::ProvideChannelInput,
+                              base::Unretained(&expected_source), ch)));
+    }
+    EXPECT_EQ(expected_resamplers[0]->ChunkSize(), resampler.ChunkSize());
+
+    std::vector<std::vector<float>> destinations(
+        channels, std::vector<float>(kOutputFrames));
+    std::vector<float*> destination_ptrs;
+    for (auto& destination : destinations)
+      destination_ptrs.push_back(destination.data());
+    std::vector<float> expected(kOutputFrames);
+
+    double max_error = 0;
+    for (int i = 0; i < kIterations; ++i) {
+      resampler.ResampleChannels(kOutputFrames, destination_ptrs.data());
+      for (int ch = 0; ch < channels; ++ch) {
+        expected_resamplers[ch]->Resample(kOutputFrames, expected.data());
+        for (int j = 0; j < kOutputFrames; ++j) {
+          max_error =
+              std::max(max_error,
+                       static_cast<double>(fabs(destinations[ch][j] -
+                                                expected[j])));
+        }
+      }
+      EXPECT_DOUBLE_EQ(expected_resamplers[0]->BufferedFrames(),
+                       resampler.BufferedFrames());
+    }
+    EXPECT_LE(max_error, kEpsilon);
+  }
+}
+
 // Verify the resampler properly reports the max number of input frames it would
 // request.
 TEST(SincResamplerTest, GetMaxInputFramesRequestedTest) {
@@ -8,12 +8,20 @@
 #include <algorithm>
 
 #include "base/check_op.h"
+#include "base/cpu.h"
 #include "base/memory/aligned_memory.h"
 #include "build/build_config.h"
 
 // NaCl does not allow intrinsics.
 #if defined(ARCH_CPU_X86_FAMILY) && !defined(OS_NACL)
+#include <immintrin.h>
 #include <xmmintrin.h>
+#include <avxintrin.h>
+#include <avx2intrin.h>
+#include <fmaintrin.h>
+// The AVX2 versions are used instead of FMAC_FUNC, FMUL_FUNC and
+// EWMAAndMaxPower_FUNC when the CPU supports AVX2 and FMA3.
+#define HAS_AVX2_VERSIONS
 // Don't use custom SSE versions where the auto-vectorized C version performs
 // better, which is anywhere clang is used.
 // TODO(pcc): Linux currently uses ThinLTO which has broken auto-vectorization
@@ -43,6 +51,10 @@ namespace vector_math {
 void FMAC(const float src[], float scale, int len, float dest[]) {
   DCHECK(base::IsAligned(src, kRequiredAlignment));
   DCHECK(base::IsAligned(dest, kRequiredAlignment));
+#if defined(HAS_AVX2_VERSIONS)
+  if (base::CPU::CanUseAVX2AndFMA3())
+    return FMAC_AVX2(src, scale, len, dest);
+#endif
   return FMAC_FUNC(src, scale, len, dest);
 }
 
@@ -54,6 +66,10 @@ void FMAC_C(const float src[], float scale, int len, float dest[]) {
 void FMUL(const float src[], float scale, int len, float dest[]) {
   DCHECK(base::IsAligned(src, kRequiredAlignment));
   DCHECK(base::IsAligned(dest, kRequiredAlignment));
+#if defined(HAS_AVX2_VERSIONS)
+  if (base::CPU::CanUseAVX2AndFMA3())
+    return FMUL_AVX2(src, scale, len, dest);
+#endif
   return FMUL_FUNC(src, scale, len, dest);
 }
 
@@ -65,6 +81,10 @@ void FMUL_C(const float src[], float scale, int len, float dest[]) {
 std::pair<float, float> EWMAAndMaxPower(
     float initial_value, const float src[], int len, float smoothing_factor) {
   DCHECK(base::IsAligned(src, kRequiredAlignment));
+#if defined(HAS_AVX2_VERSIONS)
+  if (base::CPU::CanUseAVX2AndFMA3())
+    return EWMAAndMaxPower_AVX2(initial_value, src, len, smoothing_factor);
+#endif
   return EWMAAndMaxPower_FUNC(initial_value, src, len, smoothing_factor);
 }
 
@@ -185,6 +205,103 @@ std::pair<float, float> EWMAAndMaxPower_SSE(
 
   return result;
 }
+
+// The AVX2 versions process 8 values at a time. |src| and |dest| are only
+// aligned for SSE, so they use unaligned loads and stores, which are as fast
+// as aligned ones on aligned addresses.
+__attribute__((target("avx2,fma"))) void FMUL_AVX2(const float src[],
+                                                   float scale,
+                                                   int len,
+                                                   float dest[]) {
+  const int rem = len % 8;
+  const int last_index = len - rem;
+  const __m256 m_scale = _mm256_set1_ps(scale);
+  for (int i = 0; i < last_index; i += 8) {
+    _mm256_storeu_ps(dest + i,
+                     _mm256_mul_ps(_mm256_loadu_ps(src + i), m_scale));
+  }
+
+  // Handle any remaining values that wouldn't fit in an AVX pass.
+  for (int i = last_index; i < len; ++i)
+    dest[i] = src[i] * scale;
+}
+
+__attribute__((target("avx2,fma"))) void FMAC_AVX2(const float src[],
+                                                   float scale,
+                                                   int len,
+                                                   float dest[]) {
+  const int rem = len % 8;
+  const int last_index = len - rem;
+  const __m256 m_scale = _mm256_set1_ps(scale);
+  for (int i = 0; i < last_index; i += 8) {
+    _mm256_storeu_ps(dest + i,
+                     _mm256_fmadd_ps(_mm256_loadu_ps(src + i), m_scale,
+                                     _mm256_loadu_ps(dest + i)));
+  }
+
+  // Handle any remaining values that wouldn't fit in an AVX pass.
+  for (int i = last_index; i < len; ++i)
+    dest[i] += src[i] * scale;
+}
+
+__attribute__((target("avx2,fma"))) std::pair<float, float>
+EWMAAndMaxPower_AVX2(float initial_value,
+                     const float src[],
+                     int len,
+                     float smoothing_factor) {
+  // Same as EWMAAndMaxPower_SSE(), with 8 lanes: z[n], ..., z[n-7] are
+  // computed in parallel in lanes 7 to 0, where
+  // z[n] = a(S[n]^2) + (1-a)^8(z[n-8]) + (1-a)^16(z[n-16]) + ...
+  const int rem = len % 8;
+  const int last_index = len - rem;
+
+  const __m256 smoothing_factor_x8 = _mm256_set1_ps(smoothing_factor);
+  const float weight_prev = 1.0f - smoothing_factor;
+  const __m256 weight_prev_x8 = _mm256_set1_ps(weight_prev);
+  const __m256 weight_prev_squared_x8 =
+      _mm256_mul_ps(weight_prev_x8, weight_prev_x8);
+  const __m256 weight_prev_4th_x8 =
+      _mm256_mul_ps(weight_prev_squared_x8, weight_prev_squared_x8);
+  const __m256 weight_prev_8th_x8 =
+      _mm256_mul_ps(weight_prev_4th_x8, weight_prev_4th_x8);
+
+  __m256 max_x8 = _mm256_setzero_ps();
+  __m256 ewma_x8 =
+      _mm256_setr_ps(0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, initial_value);
+  int i;
+  for (i = 0; i < last_index; i += 8) {
+    ewma_x8 = _mm256_mul_ps(ewma_x8, weight_prev_8th_x8);
+    const __m256 sample_x8 = _mm256_loadu_ps(src + i);
+    const __m256 sample_squared_x8 = _mm256_mul_ps(sample_x8, sample_x8);
+    max_x8 = _mm256_max_ps(max_x8, sample_squared_x8);
+    ewma_x8 =
+        _mm256_fmadd_ps(sample_squared_x8, smoothing_factor_x8, ewma_x8);
+  }
+
+  // y[n] = z[n] + (1-a)^1(z[n-1]) + ... + (1-a)^7(z[n-7])
+  float ewma_lanes[8];
+  float max_lanes[8];
+  _mm256_storeu_ps(ewma_lanes, ewma_x8);
+  _mm256_storeu_ps(max_lanes, max_x8);
+  std::pair<float, float> result(ewma_lanes[7], max_lanes[7]);
+  float weight = weight_prev;
+  for (int lane = 6; lane >= 0; --lane) {
+    result.first += ewma_lanes[lane] * weight;
+    result.second = std::max(result.second, max_lanes[lane]);
+    weight *= weight_prev;
+  }
+
+  // Handle remaining values at the end of |src|.
+  for (; i < len; ++i) {
+    result.first *= weight_prev;
+    const float sample = src[i];
+    const float sample_squared = sample * sample;
+    result.first += sample_squared * smoothing_factor;
+    result.second = std::max(result.second, sample_squared);
+  }
+
+  return result;
+}
 #endif
 
 #if defined(ARCH_CPU_ARM_FAMILY) && defined(USE_NEON)
@@ -4,6 +4,7 @@
 
 #include <memory>
 
+#include "base/cpu.h"
 #include "base/memory/aligned_memory.h"
 #include "base/time/time.h"
 #include "build/build_config.h"
@@ -166,4 +167,36 @@ TEST_F(VectorMathPerfTest, EWMAAndMaxPower_optimized_aligned) {
 }
 #endif
 
+#if defined(ARCH_CPU_X86_FAMILY)
+// Benchmarks for the AVX2 methods, which replace the optimized ones above on
+// CPUs with AVX2 and FMA3.
+static bool HasAVX2AndFMA3() {
+  base::CPU cpu;
+  return cpu.has_avx2() && cpu.has_fma3();
+}
+
+TEST_F(VectorMathPerfTest, FMAC_avx2) {
+  if (!HasAVX2AndFMA3())
+    return;
+  RunBenchmark(vector_math::FMAC_AVX2, false, "_fmac", "avx2_unaligned");
+  RunBenchmark(vector_math::FMAC_AVX2, true, "_fmac", "avx2_aligned");
+}
+
+TEST_F(VectorMathPerfTest, FMUL_avx2) {
+  if (!HasAVX2AndFMA3())
+    return;
+  RunBenchmark(vector_math::FMUL_AVX2, false, "_fmul", "avx2_unaligned");
+  RunBenchmark(vector_math::FMUL_AVX2, true, "_fmul", "avx2_aligned");
+}
+
+TEST_F(VectorMathPerfTest, EWMAAndMaxPower_avx2) {
+  if (!HasAVX2AndFMA3())
+    return;
+  RunBenchmark(vector_math::EWMAAndMaxPower_AVX2, kVectorSize - 1,
+               "_ewma_and_max_power", "avx2_unaligned");
+  RunBenchmark(vector_math::EWMAAndMaxPower_AVX2, kVectorSize,
+               "_ewma_and_max_power", "avx2_aligned");
+}
+#endif
+
 } // namespace media
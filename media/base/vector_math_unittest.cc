@@ -5,6 +5,7 @@
 #include <cmath>
 #include <memory>
 
+#include "base/cpu.h"
 #include "base/memory/aligned_memory.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/stringize_macros.h"
@@ -80,6 +81,14 @@ TEST_F(VectorMathTest, FMAC) {
         input_vector_.get(), kScale, kVectorSize, output_vector_.get());
     VerifyOutput(kResult);
   }
+
+  if (base::CPU().has_avx2() && base::CPU().has_fma3()) {
+    SCOPED_TRACE("FMAC_AVX2");
+    FillTestVectors(kInputFillValue, kOutputFillValue);
+    vector_math::FMAC_AVX2(
+        input_vector_.get(), kScale, kVectorSize, output_vector_.get());
+    VerifyOutput(kResult);
+  }
 #endif
 
 #if defined(ARCH_CPU_ARM_FAMILY) && defined(USE_NEON)
@@ -121,6 +130,14 @@ TEST_F(VectorMathTest, FMUL) {
         input_vector_.get(), kScale, kVectorSize, output_vector_.get());
     VerifyOutput(kResult);
   }
+
+  if (base::CPU().has_avx2() && base::CPU().has_fma3()) {
+    SCOPED_TRACE("FMUL_AVX2");
+    FillTestVectors(kInputFillValue, kOutputFillValue);
+    vector_math::FMUL_AVX2(
+        input_vector_.get(), kScale, kVectorSize, output_vector_.get());
+    VerifyOutput(kResult);
+  }
 #endif
 
 #if defined(ARCH_CPU_ARM_FAMILY) && defined(USE_NEON)
@@ -219,6 +236,15 @@ class EWMATestScenario {
       EXPECT_NEAR(expected_final_avg_, result.first, 0.0000001f);
       EXPECT_NEAR(expected_max_, result.second, 0.0000001f);
     }
+
+    if (base::CPU().has_avx2() && base::CPU().has_fma3()) {
+      SCOPED_TRACE("EWMAAndMaxPower_AVX2");
+      const std::pair<float, float>& result =
+          vector_math::EWMAAndMaxPower_AVX2(initial_value_, data_.get(),
+                                            data_len_, smoothing_factor_);
+      EXPECT_NEAR(expected_final_avg_, result.first, 0.0000001f);
+      EXPECT_NEAR(expected_max_, result.second, 0.0000001f);
+    }
 #endif
 
 #if defined(ARCH_CPU_ARM_FAMILY) && defined(USE_NEON)
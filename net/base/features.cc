@@ -34,6 +34,23 @@ const base::FeatureParam<base::TimeDelta> kDnsMinTransactionTimeout{
     &kDnsTransactionDynamicTimeouts, "DnsMinTransactionTimeout",
     base::Seconds(12)};
 
+const base::Feature kHostResolverFairShareDispatch{
+    "HostResolverFairShareDispatch", base::FEATURE_DISABLED_BY_DEFAULT};
+
+const base::FeatureParam<std::string> kHostResolverFairShareDispatchWeights{
+    &kHostResolverFairShareDispatch, "HostResolverFairShareDispatchWeights",
+    ""};
+
+const base::FeatureParam<base::TimeDelta>
+    kHostResolverFairShareDispatchMaxQueueDelay{
+        &kHostResolverFairShareDispatch,
+        "HostResolverFairShareDispatchMaxQueueDelay", base::Seconds(2)};
+
+const base::FeatureParam<bool>
+    kHostResolverFairShareDispatchByNetworkIsolationKey{
+        &kHostResolverFairShareDispatch,
+        "HostResolverFairShareDispatchByNetworkIsolationKey", true};
+
 const base::Feature kDnsHttpssvc{"DnsHttpssvc",
                                  base::FEATURE_DISABLED_BY_DEFAULT};
 
@@ -44,6 +44,22 @@ NET_EXPORT extern const base::FeatureParam<double>
 NET_EXPORT extern const base::FeatureParam<base::TimeDelta>
     kDnsMinTransactionTimeout;
 
+// Relaxes the strict priority order HostResolverManager starts its queued jobs
+// in, according to the parameters below. See PrioritizedDispatcher::Policy.
+NET_EXPORT extern const base::Feature kHostResolverFairShareDispatch;
+// The weight of each priority, as a list of NUM_PRIORITIES positive
+// integers separated by ':', from the lowest priority to the highest. Empty for
+// the strict priority order.
+NET_EXPORT extern const base::FeatureParam<std::string>
+    kHostResolverFairShareDispatchWeights;
+// How long a job can wait at the head of its priority's queue before it's
+// started ahead of higher priority jobs. Zero to never promote jobs.
+NET_EXPORT extern const base::FeatureParam<base::TimeDelta>
+    kHostResolverFairShareDispatchMaxQueueDelay;
+// Whether the jobs of each priority take turns among NetworkIsolationKeys.
+NET_EXPORT extern const base::FeatureParam<bool>
+    kHostResolverFairShareDispatchByNetworkIsolationKey;
+
 // Enables DNS query-only experiments for HTTPSSVC or INTEGRITY records,
 // depending on feature parameters. Received responses never affect Chrome
 // behavior other than metrics.
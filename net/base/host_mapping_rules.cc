@@ -4,6 +4,7 @@
 
 #include "net/base/host_mapping_rules.h"
 
+#include <algorithm>
 #include <string>
 
 #include "base/logging.h"
@@ -20,6 +21,22 @@
 
 namespace net {
 
+namespace {
+
+// Adds |hostname_pattern| to |index| as |id|. Rules are also matched against
+// "host:port", which only patterns with a colon can match, so those aren't
+// indexed by host.
+void AddToIndex(const std::string& hostname_pattern,
+                size_t id,
+                HostPatternIndex* index) {
+  if (hostname_pattern.find(':') != std::string::npos)
+    index->AddUnindexed(id);
+  else
+    index->AddHostPattern(hostname_pattern, id);
+}
+
+}  // namespace
+
 struct HostMappingRules::MapRule {
   MapRule() : replacement_port(-1) {}
 
@@ -43,8 +60,15 @@ HostMappingRules& HostMappingRules::operator=(
     const HostMappingRules& host_mapping_rules) = default;
 
 bool HostMappingRules::RewriteHost(HostPortPair* host_port) const {
+  // Only the rules in the index for the host can match, and the first one
+  // that does wins.
+  std::vector<size_t> candidates;
+  map_rule_index_.FindCandidates(host_port->host(), &candidates);
+  std::sort(candidates.begin(), candidates.end());
+
   // Check if the hostname was remapped.
-  for (const auto& map_rule : map_rules_) {
+  for (size_t index : candidates) {
+    const MapRule& map_rule = map_rules_[index];
     // The rule's hostname_pattern will be something like:
     //     www.foo.com
     //     *.foo.com
@@ -59,9 +83,13 @@ bool HostMappingRules::RewriteHost(HostPortPair* host_port) const {
     }
 
     // Check if the hostname was excluded.
-    for (const auto& exclusion_rule : exclusion_rules_) {
-      if (base::MatchPattern(host_port->host(),
-                             exclusion_rule.hostname_pattern))
+    std::vector<size_t> exclusion_candidates;
+    exclusion_rule_index_.FindCandidates(host_port->host(),
+                                         &exclusion_candidates);
+    for (size_t exclusion_index : exclusion_candidates) {
+      if (base::MatchPattern(
+              host_port->host(),
+              exclusion_rules_[exclusion_index].hostname_pattern))
         return false;
     }
 
@@ -113,6 +141,8 @@ bool HostMappingRules::AddRuleFromString(base::StringPiece rule_string) {
   if (parts.size() == 2 && base::LowerCaseEqualsASCII(parts[0], "exclude")) {
     ExclusionRule rule;
     rule.hostname_pattern = base::ToLowerASCII(parts[1]);
+    AddToIndex(rule.hostname_pattern, exclusion_rules_.size(),
+               &exclusion_rule_index_);
     exclusion_rules_.push_back(rule);
     return true;
   }
@@ -127,6 +157,7 @@ bool HostMappingRules::AddRuleFromString(base::StringPiece rule_string) {
       return false;  // Failed parsing the hostname/port.
     }
 
+    AddToIndex(rule.hostname_pattern, map_rules_.size(), &map_rule_index_);
     map_rules_.push_back(rule);
     return true;
   }
@@ -137,6 +168,8 @@ bool HostMappingRules::AddRuleFromString(base::StringPiece rule_string) {
 void HostMappingRules::SetRulesFromString(base::StringPiece rules_string) {
   exclusion_rules_.clear();
   map_rules_.clear();
+  exclusion_rule_index_.Clear();
+  map_rule_index_.Clear();
 
   std::vector<base::StringPiece> rules = base::SplitStringPiece(
       rules_string, ",", base::TRIM_WHITESPACE, base::SPLIT_WANT_ALL);
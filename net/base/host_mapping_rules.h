@@ -8,6 +8,7 @@
 #include <vector>
 
 #include "base/strings/string_piece.h"
+#include "net/base/host_pattern_index.h"
 #include "net/base/net_export.h"
 
 class GURL;
@@ -66,6 +67,11 @@ class NET_EXPORT_PRIVATE HostMappingRules {
 
   MapRuleList map_rules_;
   ExclusionRuleList exclusion_rules_;
+
+  // The rules by their position in the lists above, so that only the rules
+  // that may match a host are evaluated.
+  HostPatternIndex map_rule_index_;
+  HostPatternIndex exclusion_rule_index_;
 };
 
 }  // namespace net
@@ -73,6 +73,51 @@ TEST(HostMappingRulesTest, PortSpecificMatching) {
   EXPECT_EQ(443u, host_port.port());
 }
 
+// The first matching rule wins, however the rules are indexed.
+TEST(HostMappingRulesTest, FirstMatchingRuleWins) {
+  HostMappingRules rules;
+  rules.SetRulesFromString(
+      "map *oo.com glob, map www.foo.com exact:1, map *.foo.com suffix:2, "
+      "map foo.com:443 port:3, map *.bar.com suffix:4, map bar.com exact:5, "
+      "exclude *.excluded.bar.com");
+
+  HostPortPair host_port("www.foo.com", 80);
+  EXPECT_TRUE(rules.RewriteHost(&host_port));
+  EXPECT_EQ("glob", host_port.host());
+
+  host_port = HostPortPair("foo.com", 443);
+  EXPECT_TRUE(rules.RewriteHost(&host_port));
+  EXPECT_EQ("glob", host_port.host());
+
+  host_port = HostPortPair("a.b.bar.com", 80);
+  EXPECT_TRUE(rules.RewriteHost(&host_port));
+  EXPECT_EQ("suffix", host_port.host());
+  EXPECT_EQ(4u, host_port.port());
+
+  host_port = HostPortPair("bar.com", 80);
+  EXPECT_TRUE(rules.RewriteHost(&host_port));
+  EXPECT_EQ("exact", host_port.host());
+  EXPECT_EQ(5u, host_port.port());
+
+  host_port = HostPortPair("www.excluded.bar.com", 80);
+  EXPECT_FALSE(rules.RewriteHost(&host_port));
+
+  rules.SetRulesFromString(
+      "map foo.com:443 port:3, map www.foo.com exact:1, map *.foo.com x:2");
+
+  host_port = HostPortPair("foo.com", 443);
+  EXPECT_TRUE(rules.RewriteHost(&host_port));
+  EXPECT_EQ("port", host_port.host());
+  EXPECT_EQ(3u, host_port.port());
+
+  host_port = HostPortPair("foo.com", 80);
+  EXPECT_FALSE(rules.RewriteHost(&host_port));
+
+  host_port = HostPortPair("www.foo.com", 80);
+  EXPECT_TRUE(rules.RewriteHost(&host_port));
+  EXPECT_EQ("exact", host_port.host());
+}
+
 // Parsing bad rules should silently discard the rule (and never crash).
 TEST(HostMappingRulesTest, ParseInvalidRules) {
   HostMappingRules rules;
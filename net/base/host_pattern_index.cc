@@ -0,0 +1,193 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/base/host_pattern_index.h"
+
+#include "base/check_op.h"
+#include "base/numerics/safe_conversions.h"
+#include "base/strings/string_util.h"
+#include "net/base/ip_address.h"
+
+namespace net {
+
+namespace {
+
+// The position of the label of |host| that ends at |label_end|, found from
+// right to left. |dot| is the position of the dot before the label, or npos
+// for the first label.
+struct Label {
+  size_t begin;
+  size_t dot;
+};
+
+Label FindLabelEndingAt(base::StringPiece host, size_t label_end) {
+  const size_t dot =
+      label_end ? host.rfind('.', label_end - 1) : base::StringPiece::npos;
+  return {dot == base::StringPiece::npos ? 0 : dot + 1, dot};
+}
+
+uint64_t LoadBigEndian64(const uint8_t* bytes) {
+  uint64_t value = 0;
+  for (size_t i = 0; i < 8; ++i)
+    value = (value << 8) | bytes[i];
+  return value;
+}
+
+// Returns the bits of |address| as an IPv6 address.
+std::pair<uint64_t, uint64_t> GetIPv6Bits(const IPAddress& address) {
+  const IPAddress ipv6 =
+      address.IsIPv4() ? ConvertIPv4ToIPv4MappedIPv6(address) : address;
+  DCHECK_EQ(IPAddress::kIPv6AddressSize, ipv6.size());
+  return {LoadBigEndian64(ipv6.bytes().data()),
+          LoadBigEndian64(ipv6.bytes().data() + 8)};
+}
+
+// Returns |bits| with only the first |prefix_length| bits kept.
+std::pair<uint64_t, uint64_t> MaskIPv6Bits(std::pair<uint64_t, uint64_t> bits,
+                                           size_t prefix_length) {
+  DCHECK_LE(prefix_length, 128u);
+  auto mask = [](size_t length) -> uint64_t {
+    if (length == 0)
+      return 0;
+    return length >= 64 ? ~uint64_t{0} : ~uint64_t{0} << (64 - length);
+  };
+  return {bits.first & mask(prefix_length),
+          bits.second & mask(prefix_length > 64 ? prefix_length - 64 : 0)};
+}
+
+}  // namespace
+
+HostPatternIndex::Node::Node() = default;
+
+HostPatternIndex::Node::Node(const Node& other) = default;
+
+HostPatternIndex::Node::Node(Node&& other) = default;
+
+HostPatternIndex::Node::~Node() = default;
+
+HostPatternIndex::Node& HostPatternIndex::Node::operator=(const Node& other) =
+    default;
+
+HostPatternIndex::Node& HostPatternIndex::Node::operator=(Node&& other) =
+    default;
+
+HostPatternIndex::HostPatternIndex() = default;
+
+HostPatternIndex::HostPatternIndex(const HostPatternIndex& other) = default;
+
+HostPatternIndex::HostPatternIndex(HostPatternIndex&& other) = default;
+
+HostPatternIndex::~HostPatternIndex() = default;
+
+HostPatternIndex& HostPatternIndex::operator=(const HostPatternIndex& other) =
+    default;
+
+HostPatternIndex& HostPatternIndex::operator=(HostPatternIndex&& other) =
+    default;
+
+void HostPatternIndex::AddHostPattern(base::StringPiece pattern, size_t id) {
+  const bool match_subdomains =
+      base::StartsWith(pattern, "*.", base::CompareCase::SENSITIVE);
+  const base::StringPiece suffix =
+      match_subdomains ? pattern.substr(2) : pattern;
+  // Any other wildcard or escape makes the pattern a true glob.
+  if (suffix.find_first_of("*?\\") != base::StringPiece::npos) {
+    AddUnindexed(id);
+    return;
+  }
+  Node* node = GetOrAddNode(suffix);
+  (match_subdomains ? node->subdomain_ids : node->host_ids).push_back(id);
+}
+
+void HostPatternIndex::AddIPBlock(const IPAddress& prefix,
+                                  size_t prefix_length_in_bits,
+                                  size_t id) {
+  DCHECK_LE(prefix_length_in_bits, prefix.size() * 8);
+  const size_t prefix_length =
+      prefix.IsIPv4() ? prefix_length_in_bits + 96 : prefix_length_in_bits;
+  ip_blocks_[prefix_length][MaskIPv6Bits(GetIPv6Bits(prefix), prefix_length)]
+      .push_back(id);
+}
+
+void HostPatternIndex::AddUnindexed(size_t id) {
+  unindexed_ids_.push_back(id);
+}
+
+void HostPatternIndex::FindCandidates(base::StringPiece host,
+                                      std::vector<size_t>* ids) const {
+  ids->insert(ids->end(), unindexed_ids_.begin(), unindexed_ids_.end());
+
+  const Node* node = nodes_.empty() ? nullptr : &nodes_[0];
+  size_t label_end = host.size();
+  while (node) {
+    const Label label = FindLabelEndingAt(host, label_end);
+    auto it = node->children.find(
+        host.substr(label.begin, label_end - label.begin));
+    if (it == node->children.end())
+      break;
+    node = &nodes_[it->second];
+    if (label.dot == base::StringPiece::npos) {
+      ids->insert(ids->end(), node->host_ids.begin(), node->host_ids.end());
+      break;
+    }
+    ids->insert(ids->end(), node->subdomain_ids.begin(),
+                node->subdomain_ids.end());
+    label_end = label.dot;
+  }
+
+  if (ip_blocks_.empty())
+    return;
+  base::StringPiece ip_literal = host;
+  if (ip_literal.size() >= 2 && ip_literal.front() == '[' &&
+      ip_literal.back() == ']') {
+    ip_literal = ip_literal.substr(1, ip_literal.size() - 2);
+  }
+  IPAddress address;
+  if (address.AssignFromIPLiteral(ip_literal))
+    FindIPBlockCandidates(address, ids);
+}
+
+void HostPatternIndex::Clear() {
+  nodes_.clear();
+  ip_blocks_.clear();
+  unindexed_ids_.clear();
+}
+
+HostPatternIndex::Node* HostPatternIndex::GetOrAddNode(
+    base::StringPiece suffix) {
+  if (nodes_.empty())
+    nodes_.emplace_back();
+  size_t index = 0;
+  size_t label_end = suffix.size();
+  while (true) {
+    const Label label = FindLabelEndingAt(suffix, label_end);
+    const base::StringPiece label_string =
+        suffix.substr(label.begin, label_end - label.begin);
+    auto it = nodes_[index].children.find(label_string);
+    if (it == nodes_[index].children.end()) {
+      const uint32_t child = base::checked_cast<uint32_t>(nodes_.size());
+      nodes_[index].children.emplace(std::string(label_string), child);
+      // Invalidates the references into |nodes_|, so comes last.
+      nodes_.emplace_back();
+      index = child;
+    } else {
+      index = it->second;
+    }
+    if (label.dot == base::StringPiece::npos)
+      return &nodes_[index];
+    label_end = label.dot;
+  }
+}
+
+void HostPatternIndex::FindIPBlockCandidates(const IPAddress& address,
+                                             std::vector<size_t>* ids) const {
+  const IPBits bits = GetIPv6Bits(address);
+  for (const auto& blocks : ip_blocks_) {
+    auto it = blocks.second.find(MaskIPv6Bits(bits, blocks.first));
+    if (it != blocks.second.end())
+      ids->insert(ids->end(), it->second.begin(), it->second.end());
+  }
+}
+
+}  // namespace net
@@ -0,0 +1,115 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_BASE_HOST_PATTERN_INDEX_H_
+#define NET_BASE_HOST_PATTERN_INDEX_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "base/hash/hash.h"
+#include "base/strings/string_piece.h"
+#include "net/base/net_export.h"
+
+namespace net {
+
+class IPAddress;
+
+// Indexes a list of host rules by the hosts they can match, so that the rules
+// that may match a host can be found without evaluating all of them. Each rule
+// is identified by an id, such as its position in the list, and is added with
+// the host pattern or IP block it matches:
+//
+//  * Patterns without wildcards, such as "www.example.com", and patterns that
+//    match the subdomains of such a pattern, such as "*.example.com", go in a
+//    trie of the labels of the host from right to left.
+//  * IP blocks, such as "10.0.0.0/8", go in a table per prefix length.
+//  * The other rules, such as "*example*", are unindexed, and may match any
+//    host.
+//
+// FindCandidates() returns a superset of the rules that match a host, which
+// the caller then evaluates in its own order, so the result of the rule list
+// is the same as evaluating all of the rules.
+class NET_EXPORT_PRIVATE HostPatternIndex {
+ public:
+  HostPatternIndex();
+  HostPatternIndex(const HostPatternIndex& other);
+  HostPatternIndex(HostPatternIndex&& other);
+  ~HostPatternIndex();
+
+  HostPatternIndex& operator=(const HostPatternIndex& other);
+  HostPatternIndex& operator=(HostPatternIndex&& other);
+
+  // Adds the rule |id|, which matches hosts with
+  // base::MatchPattern(host, |pattern|).
+  void AddHostPattern(base::StringPiece pattern, size_t id);
+
+  // Adds the rule |id|, which matches IP address hosts in the given block, as
+  // IPAddressMatchesPrefix() does.
+  void AddIPBlock(const IPAddress& prefix,
+                  size_t prefix_length_in_bits,
+                  size_t id);
+
+  // Adds the rule |id|, which may match any host.
+  void AddUnindexed(size_t id);
+
+  // Appends the ids of the rules that may match |host|, in no particular
+  // order. |host| is in the form of GURL::host(), with brackets around IPv6
+  // addresses.
+  void FindCandidates(base::StringPiece host, std::vector<size_t>* ids) const;
+
+  void Clear();
+
+ private:
+  // A node of the trie, for the suffix of the host made of the labels on the
+  // path from the root.
+  struct Node {
+    Node();
+    Node(const Node& other);
+    Node(Node&& other);
+    ~Node();
+
+    Node& operator=(const Node& other);
+    Node& operator=(Node&& other);
+
+    // The indices of the children in |nodes_|, by their label.
+    std::map<std::string, uint32_t, std::less<>> children;
+    // The rules matching the suffix itself.
+    std::vector<size_t> host_ids;
+    // The rules matching the hosts with more labels before the suffix.
+    std::vector<size_t> subdomain_ids;
+  };
+
+  // The high and low 64 bits of an IPv6 address.
+  using IPBits = std::pair<uint64_t, uint64_t>;
+  using IPBlockTable = std::unordered_map<IPBits,
+                                          std::vector<size_t>,
+                                          base::IntPairHash<IPBits>>;
+
+  // Returns the node of |suffix|, creating it and its parents as needed.
+  Node* GetOrAddNode(base::StringPiece suffix);
+
+  void FindIPBlockCandidates(const IPAddress& address,
+                             std::vector<size_t>* ids) const;
+
+  // |nodes_[0]| is the root, once a pattern has been added.
+  std::vector<Node> nodes_;
+
+  // The IP blocks by their prefix length, of IPv6 addresses with IPv4
+  // addresses and prefixes mapped to IPv6. Prefix lengths are few in
+  // practice, so a lookup masks the address once for each of them.
+  std::map<size_t, IPBlockTable> ip_blocks_;
+
+  std::vector<size_t> unindexed_ids_;
+};
+
+}  // namespace net
+
+#endif  // NET_BASE_HOST_PATTERN_INDEX_H_
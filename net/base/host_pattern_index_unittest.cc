@@ -0,0 +1,183 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/base/host_pattern_index.h"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/cxx17_backports.h"
+#include "base/strings/pattern.h"
+#include "net/base/ip_address.h"
+#include "testing/gmock/include/gmock/gmock.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+using ::testing::IsEmpty;
+using ::testing::UnorderedElementsAre;
+
+std::vector<size_t> FindCandidates(const HostPatternIndex& index,
+                                   base::StringPiece host) {
+  std::vector<size_t> ids;
+  index.FindCandidates(host, &ids);
+  return ids;
+}
+
+TEST(HostPatternIndexTest, HostPatterns) {
+  HostPatternIndex index;
+  index.AddHostPattern("www.example.com", 0);
+  index.AddHostPattern("*.example.com", 1);
+  index.AddHostPattern("example.com", 2);
+  index.AddHostPattern("*.com", 3);
+  index.AddHostPattern("*example.org", 4);
+  index.AddHostPattern("*", 5);
+
+  EXPECT_THAT(FindCandidates(index, "www.example.com"),
+              UnorderedElementsAre(0, 1, 3, 4, 5));
+  EXPECT_THAT(FindCandidates(index, "a.b.example.com"),
+              UnorderedElementsAre(1, 3, 4, 5));
+  EXPECT_THAT(FindCandidates(index, "example.com"),
+              UnorderedElementsAre(2, 3, 4, 5));
+  EXPECT_THAT(FindCandidates(index, "com"), UnorderedElementsAre(4, 5));
+  EXPECT_THAT(FindCandidates(index, "example.net"), UnorderedElementsAre(4, 5));
+
+  index.Clear();
+  EXPECT_THAT(FindCandidates(index, "www.example.com"), IsEmpty());
+}
+
+// The candidates include all the patterns that match, for hosts and patterns
+// with unusual labels.
+TEST(HostPatternIndexTest, MatchesMatchPattern) {
+  const char* const kPatterns[] = {
+      "",    ".",       "*.",        "*..",     "a",       "a.",      "*.a",
+      "*.a.", "a..b",   "*..b",      "b",       "*.b",     "[::1]",   "*a",
+      "a*",  "?.a",     "a\\*",      "*.*.b",   "*.a.b",   "a.b",     "<local>",
+      "127.0.0.1",      "*.0.0.1",   "xn--n3h", "*.xn--n3h",
+  };
+  const char* const kHosts[] = {
+      "",    ".",       "..",        "a",       "a.",      ".a",      "b.a",
+      "a.b", "a..b",    ".b",        "c.a.b",   "a.b.",    "c.a.b.",  "aa",
+      "a*",  "[::1]",   "127.0.0.1", "10.0.0.1", "x.xn--n3h", "<local>",
+  };
+
+  HostPatternIndex index;
+  for (size_t i = 0; i < base::size(kPatterns); ++i)
+    index.AddHostPattern(kPatterns[i], i);
+
+  for (const char* host : kHosts) {
+    SCOPED_TRACE(host);
+    const std::vector<size_t> candidates = FindCandidates(index, host);
+    for (size_t i = 0; i < base::size(kPatterns); ++i) {
+      if (base::MatchPattern(host, kPatterns[i])) {
+        EXPECT_TRUE(std::find(candidates.begin(), candidates.end(), i) !=
+                    candidates.end())
+            << kPatterns[i];
+      }
+    }
+  }
+}
+
+TEST(HostPatternIndexTest, IPBlocks) {
+  HostPatternIndex index;
+  IPAddress prefix;
+  ASSERT_TRUE(prefix.AssignFromIPLiteral("10.0.0.0"));
+  index.AddIPBlock(prefix, 8, 0);
+  ASSERT_TRUE(prefix.AssignFromIPLiteral("10.1.2.0"));
+  index.AddIPBlock(prefix, 24, 1);
+  ASSERT_TRUE(prefix.AssignFromIPLiteral("fe80::"));
+  index.AddIPBlock(prefix, 10, 2);
+  ASSERT_TRUE(prefix.AssignFromIPLiteral("::ffff:192.168.0.0"));
+  index.AddIPBlock(prefix, 112, 3);
+  ASSERT_TRUE(prefix.AssignFromIPLiteral("0.0.0.0"));
+  index.AddIPBlock(prefix, 0, 4);
+
+  EXPECT_THAT(FindCandidates(index, "10.1.2.3"),
+              UnorderedElementsAre(0, 1, 4));
+  EXPECT_THAT(FindCandidates(index, "10.1.3.3"), UnorderedElementsAre(0, 4));
+  EXPECT_THAT(FindCandidates(index, "11.1.2.3"), UnorderedElementsAre(4));
+  EXPECT_THAT(FindCandidates(index, "[fe80::1]"), UnorderedElementsAre(2));
+  EXPECT_THAT(FindCandidates(index, "[febf::1]"), UnorderedElementsAre(2));
+  EXPECT_THAT(FindCandidates(index, "[fec0::1]"), IsEmpty());
+  // IPv4 addresses and IPv4-mapped IPv6 addresses match each other's blocks,
+  // as with IPAddressMatchesPrefix().
+  EXPECT_THAT(FindCandidates(index, "192.168.1.1"),
+              UnorderedElementsAre(3, 4));
+  EXPECT_THAT(FindCandidates(index, "[::ffff:10.1.2.3]"),
+              UnorderedElementsAre(0, 1, 4));
+  EXPECT_THAT(FindCandidates(index, "www.example.com"), IsEmpty());
+}
+
+TEST(HostPatternIndexTest, MatchesIPAddressMatchesPrefix) {
+  struct {
+    const char* prefix;
+    size_t prefix_length;
+  } kBlocks[] = {
+      {"0.0.0.0", 0},       {"10.0.0.0", 8},     {"10.0.0.0", 9},
+      {"10.128.0.0", 9},    {"192.168.1.1", 32}, {"::", 0},
+      {"::", 96},           {"2001:db8::", 32},  {"2001:db8::", 64},
+      {"2001:db8::1", 128}, {"::ffff:0:0", 96},  {"::ffff:10.0.0.0", 104},
+  };
+  const char* const kAddresses[] = {
+      "0.0.0.0",     "10.0.0.1",       "10.200.0.1",     "11.0.0.1",
+      "192.168.1.1", "192.168.1.2",    "::",             "::1",
+      "::a00:1",     "2001:db8::1",    "2001:db8:1::1",  "2001:db9::1",
+      "::ffff:10.0.0.1", "::ffff:192.168.1.1",
+  };
+
+  HostPatternIndex index;
+  std::vector<IPAddress> prefixes;
+  for (size_t i = 0; i < base::size(kBlocks); ++i) {
+    IPAddress prefix;
+    ASSERT_TRUE(prefix.AssignFromIPLiteral(kBlocks[i].prefix));
+    index.AddIPBlock(prefix, kBlocks[i].prefix_length, i);
+    prefixes.push_back(prefix);
+  }
+
+  for (const char* literal : kAddresses) {
+    SCOPED_TRACE(literal);
+    IPAddress address;
+    ASSERT_TRUE(address.AssignFromIPLiteral(literal));
+    const std::string host =
+        address.IsIPv6() ? std::string("[") + literal + "]" : literal;
+    std::vector<size_t> candidates = FindCandidates(index, host);
+    std::sort(candidates.begin(), candidates.end());
+    std::vector<size_t> expected;
+    for (size_t i = 0; i < base::size(kBlocks); ++i) {
+      if (IPAddressMatchesPrefix(address, prefixes[i],
+                                 kBlocks[i].prefix_length)) {
+        expected.push_back(i);
+      }
+    }
+    EXPECT_EQ(expected, candidates);
+  }
+}
+
+TEST(HostPatternIndexTest, Unindexed) {
+  HostPatternIndex index;
+  index.AddUnindexed(0);
+  index.AddHostPattern("example.com", 1);
+  EXPECT_THAT(FindCandidates(index, "example.com"), UnorderedElementsAre(0, 1));
+  EXPECT_THAT(FindCandidates(index, "10.0.0.1"), UnorderedElementsAre(0));
+}
+
+TEST(HostPatternIndexTest, CopyAndMove) {
+  HostPatternIndex index;
+  index.AddHostPattern("example.com", 0);
+
+  HostPatternIndex copy(index);
+  index.AddHostPattern("example.com", 1);
+  EXPECT_THAT(FindCandidates(copy, "example.com"), UnorderedElementsAre(0));
+
+  HostPatternIndex moved(std::move(index));
+  EXPECT_THAT(FindCandidates(moved, "example.com"), UnorderedElementsAre(0, 1));
+}
+
+}  // namespace
+
+}  // namespace net
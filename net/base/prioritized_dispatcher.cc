@@ -4,7 +4,11 @@
 
 #include "net/base/prioritized_dispatcher.h"
 
+#include <algorithm>
+
 #include "base/check_op.h"
+#include "base/time/default_tick_clock.h"
+#include "base/time/tick_clock.h"
 
 namespace net {
 
@@ -16,9 +20,29 @@ PrioritizedDispatcher::Limits::Limits(const Limits& other) = default;
 
 PrioritizedDispatcher::Limits::~Limits() = default;
 
+PrioritizedDispatcher::Policy::Policy() = default;
+
+PrioritizedDispatcher::Policy::Policy(const Policy& other) = default;
+
+PrioritizedDispatcher::Policy::~Policy() = default;
+
 PrioritizedDispatcher::PrioritizedDispatcher(const Limits& limits)
+    : PrioritizedDispatcher(limits, Policy()) {}
+
+PrioritizedDispatcher::PrioritizedDispatcher(const Limits& limits,
+                                             const Policy& policy)
     : queue_(limits.reserved_slots.size()),
-      max_running_jobs_(limits.reserved_slots.size()) {
+      max_running_jobs_(limits.reserved_slots.size()),
+      policy_(policy),
+      tick_clock_(base::DefaultTickClock::GetInstance()) {
+  if (!policy_.weights.empty()) {
+    DCHECK_EQ(num_priorities(), policy_.weights.size());
+    for (uint32_t weight : policy_.weights) {
+      DCHECK_GE(weight, 1u);
+      DCHECK_LE(weight, kMaxWeight);
+    }
+    priority_passes_.resize(num_priorities());
+  }
   SetLimits(limits);
 }
 
@@ -33,7 +57,7 @@ PrioritizedDispatcher::Handle PrioritizedDispatcher::Add(
     job->Start();
     return Handle();
   }
-  return queue_.Insert(job, priority);
+  return Enqueue(job, priority, /*at_head=*/false, tick_clock_->NowTicks());
 }
 
 PrioritizedDispatcher::Handle PrioritizedDispatcher::AddAtHead(
@@ -45,11 +69,11 @@ PrioritizedDispatcher::Handle PrioritizedDispatcher::AddAtHead(
     job->Start();
     return Handle();
   }
-  return queue_.InsertAtFront(job, priority);
+  return Enqueue(job, priority, /*at_head=*/true, tick_clock_->NowTicks());
 }
 
 void PrioritizedDispatcher::Cancel(const Handle& handle) {
-  queue_.Erase(handle);
+  Dequeue(handle, nullptr);
 }
 
 PrioritizedDispatcher::Job* PrioritizedDispatcher::EvictOldestLowest() {
@@ -73,9 +97,11 @@ PrioritizedDispatcher::Handle PrioritizedDispatcher::ChangePriority(
 
   if (MaybeDispatchJob(handle, priority))
     return Handle();
-  Job* job = handle.value();
-  queue_.Erase(handle);
-  return queue_.Insert(job, priority);
+  // The job keeps its queueing time, so changing priorities can't delay it
+  // past |policy_.max_queue_delay|.
+  base::TimeTicks queued_time;
+  Job* job = Dequeue(handle, &queued_time);
+  return Enqueue(job, priority, /*at_head=*/false, queued_time);
 }
 
 void PrioritizedDispatcher::OnJobFinished() {
@@ -122,24 +148,156 @@ void PrioritizedDispatcher::SetLimitsToZero() {
   SetLimits(Limits(queue_.num_priorities(), 0));
 }
 
+void PrioritizedDispatcher::SetTickClockForTesting(
+    const base::TickClock* tick_clock) {
+  tick_clock_ = tick_clock;
+}
+
+PrioritizedDispatcher::Handle PrioritizedDispatcher::Enqueue(
+    Job* job,
+    Priority priority,
+    bool at_head,
+    base::TimeTicks queued_time) {
+  if (!policy_.weights.empty() && queue_.FirstAt(priority).is_null()) {
+    // Like an idle group, an idle priority doesn't bank up a share.
+    priority_passes_[priority] = std::max(priority_passes_[priority], pass_);
+  }
+  if (policy_.share_among_groups) {
+    GroupState& group = groups_[job->GetFairShareGroup()];
+    if (group.num_queued_jobs++ == 0)
+      group.virtual_time = std::max(group.virtual_time, group_virtual_time_);
+  }
+  if (policy_.max_queue_delay.is_positive()) {
+    bool inserted = queued_times_.emplace(job, queued_time).second;
+    DCHECK(inserted) << "Job is already queued.";
+  }
+  return at_head ? queue_.InsertAtFront(job, priority)
+                 : queue_.Insert(job, priority);
+}
+
+PrioritizedDispatcher::Job* PrioritizedDispatcher::Dequeue(
+    const Handle& handle,
+    base::TimeTicks* queued_time) {
+  Job* job = queue_.Erase(handle);
+  if (policy_.share_among_groups) {
+    auto it = groups_.find(job->GetFairShareGroup());
+    DCHECK(it != groups_.end());
+    if (--it->second.num_queued_jobs == 0)
+      groups_.erase(it);
+  }
+  if (policy_.max_queue_delay.is_positive()) {
+    auto it = queued_times_.find(job);
+    DCHECK(it != queued_times_.end());
+    if (queued_time)
+      *queued_time = it->second;
+    queued_times_.erase(it);
+  }
+  return job;
+}
+
+PrioritizedDispatcher::Handle PrioritizedDispatcher::FindNextJob() const {
+  if (policy_.max_queue_delay.is_positive()) {
+    // The job that has waited the longest past the delay goes first. Only the
+    // head of each priority is checked, which is the oldest job unless jobs
+    // were added at the head.
+    const base::TimeTicks deadline =
+        tick_clock_->NowTicks() - policy_.max_queue_delay;
+    Handle overdue;
+    base::TimeTicks overdue_time;
+    for (Priority priority = 0; priority < num_priorities(); ++priority) {
+      Handle handle = queue_.FirstAt(priority);
+      if (handle.is_null() || !CanStartJobAt(priority))
+        continue;
+      base::TimeTicks queued_time = queued_times_.at(handle.value());
+      if (queued_time <= deadline &&
+          (overdue.is_null() || queued_time < overdue_time)) {
+        overdue = handle;
+        overdue_time = queued_time;
+      }
+    }
+    if (!overdue.is_null())
+      return overdue;
+  }
+
+  if (policy_.weights.empty()) {
+    // The limits increase with the priority, so if the highest priority job
+    // can't start, no job can.
+    Handle handle = queue_.FirstMax();
+    if (handle.is_null() || !CanStartJobAt(handle.priority()))
+      return Handle();
+    return FindNextJobAt(handle.priority());
+  }
+
+  // The priority furthest behind its share goes first, the highest on ties.
+  Handle next;
+  for (Priority priority = num_priorities(); priority > 0; --priority) {
+    Handle handle = queue_.FirstAt(priority - 1);
+    if (handle.is_null() || !CanStartJobAt(priority - 1))
+      continue;
+    if (next.is_null() ||
+        priority_passes_[priority - 1] < priority_passes_[next.priority()]) {
+      next = handle;
+    }
+  }
+  if (next.is_null())
+    return Handle();
+  return FindNextJobAt(next.priority());
+}
+
+PrioritizedDispatcher::Handle PrioritizedDispatcher::FindNextJobAt(
+    Priority priority) const {
+  Handle first = queue_.FirstAt(priority);
+  if (!policy_.share_among_groups)
+    return first;
+
+  // The first job of the group furthest behind its share goes first.
+  Handle next;
+  uint64_t next_virtual_time = 0;
+  size_t num_scanned = 0;
+  for (Handle handle = first; !handle.is_null() &&
+                              handle.priority() == priority &&
+                              num_scanned < kMaxJobsToScan;
+       handle = queue_.GetNextTowardsLastMin(handle), ++num_scanned) {
+    uint64_t virtual_time =
+        groups_.at(handle.value()->GetFairShareGroup()).virtual_time;
+    if (next.is_null() || virtual_time < next_virtual_time) {
+      next = handle;
+      next_virtual_time = virtual_time;
+    }
+  }
+  return next;
+}
+
 bool PrioritizedDispatcher::MaybeDispatchJob(const Handle& handle,
                                              Priority job_priority) {
   DCHECK_LT(job_priority, num_priorities());
-  if (num_running_jobs_ >= max_running_jobs_[job_priority])
+  if (!CanStartJobAt(job_priority))
     return false;
   Job* job = handle.value();
-  queue_.Erase(handle);
+  // Account for the job against the shares of its priority and group, before
+  // Job::Start() can reenter the dispatcher.
+  if (!policy_.weights.empty()) {
+    pass_ = priority_passes_[job_priority];
+    priority_passes_[job_priority] +=
+        kMaxWeight / policy_.weights[job_priority];
+  }
+  if (policy_.share_among_groups) {
+    GroupState& group = groups_.at(job->GetFairShareGroup());
+    group_virtual_time_ = group.virtual_time;
+    ++group.virtual_time;
+  }
+  Dequeue(handle, nullptr);
   ++num_running_jobs_;
   job->Start();
   return true;
 }
 
 bool PrioritizedDispatcher::MaybeDispatchNextJob() {
-  Handle handle = queue_.FirstMax();
-  if (handle.is_null()) {
-    DCHECK_EQ(0u, queue_.size());
+  if (queue_.empty())
+    return false;
+  Handle handle = FindNextJob();
+  if (handle.is_null())
     return false;
-  }
   return MaybeDispatchJob(handle, handle.priority());
 }
 
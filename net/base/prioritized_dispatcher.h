@@ -6,23 +6,32 @@
 #define NET_BASE_PRIORITIZED_DISPATCHER_H_
 
 #include <stddef.h>
+#include <stdint.h>
 
+#include <unordered_map>
 #include <vector>
 
+#include "base/memory/raw_ptr.h"
+#include "base/time/time.h"
 #include "net/base/net_export.h"
 #include "net/base/priority_queue.h"
 
+namespace base {
+class TickClock;
+}  // namespace base
+
 namespace net {
 
 // A priority-based dispatcher of jobs. Dispatch order is by priority (highest
 // first) and then FIFO. The dispatcher enforces limits on the number of running
 // jobs. It never revokes a job once started. The job must call OnJobFinished
-// once it finishes in order to dispatch further jobs.
+// once it finishes in order to dispatch further jobs. A Policy can relax the
+// dispatch order to share the slots among priorities and groups of jobs.
 //
 // This class is NOT thread-safe which is enforced by the underlying
 // non-thread-safe PriorityQueue. All operations are O(p) time for p priority
-// levels. It is safe to execute any method, including destructor, from within
-// Job::Start.
+// levels, plus O(kMaxJobsToScan) for a Policy that shares among groups. It is
+// safe to execute any method, including destructor, from within Job::Start.
 //
 class NET_EXPORT_PRIVATE PrioritizedDispatcher {
  public:
@@ -49,6 +58,40 @@ class NET_EXPORT_PRIVATE PrioritizedDispatcher {
     std::vector<size_t> reserved_slots;
   };
 
+  // Describes which of the queued jobs the dispatcher starts next, among the
+  // ones the limits permit. The default policy starts the highest priority
+  // job, then the oldest.
+  struct NET_EXPORT_PRIVATE Policy {
+    Policy();
+    Policy(const Policy& other);
+    ~Policy();
+
+    // If not empty, the weight of each priority, and the dispatcher shares
+    // the started jobs among the priorities with queued jobs in proportion to
+    // their weights rather than starting the highest priority first. For
+    // example, with weights { 1, 4 } and jobs queued at both priorities, one
+    // in five started jobs is at priority 0. Weights must be in
+    // [1, kMaxWeight].
+    std::vector<uint32_t> weights;
+
+    // If positive, a job at the head of its priority's queue that has waited
+    // longer than this is started before the other queued jobs, the longest
+    // waiting first, as soon as the limits of its priority permit. This keeps
+    // the low priorities from starving under a steady load of higher priority
+    // jobs.
+    base::TimeDelta max_queue_delay;
+
+    // If true, the queued jobs of a priority are started in turn among their
+    // groups, as returned by Job::GetFairShareGroup(), rather than in FIFO
+    // order, so that a group with many queued jobs doesn't delay the jobs of
+    // the other groups. Only the first kMaxJobsToScan jobs of the priority are
+    // considered.
+    bool share_among_groups = false;
+  };
+
+  static constexpr uint32_t kMaxWeight = 1u << 16;
+  static constexpr size_t kMaxJobsToScan = 64;
+
   // An interface to the job dispatched by PrioritizedDispatcher. The dispatcher
   // does not own the Job but expects it to live as long as the Job is queued.
   // Use Cancel to remove Job from queue before it is dispatched. The Job can be
@@ -60,6 +103,9 @@ class NET_EXPORT_PRIVATE PrioritizedDispatcher {
     // Called when the dispatcher starts the job. Once the job finishes, it must
     // call OnJobFinished.
     virtual void Start() = 0;
+    // Returns the group of the job, for a Policy that shares the dispatcher
+    // among groups. Must not change while the job is queued.
+    virtual uint64_t GetFairShareGroup() const { return 0; }
   };
 
   // A handle to the enqueued job. The handle becomes invalid when the job is
@@ -69,6 +115,10 @@ class NET_EXPORT_PRIVATE PrioritizedDispatcher {
   // Creates a dispatcher enforcing |limits| on number of running jobs.
   explicit PrioritizedDispatcher(const Limits& limits);
 
+  // Creates a dispatcher enforcing |limits| on number of running jobs, which
+  // starts the queued jobs according to |policy|.
+  PrioritizedDispatcher(const Limits& limits, const Policy& policy);
+
   PrioritizedDispatcher(const PrioritizedDispatcher&) = delete;
   PrioritizedDispatcher& operator=(const PrioritizedDispatcher&) = delete;
   ~PrioritizedDispatcher();
@@ -80,7 +130,8 @@ class NET_EXPORT_PRIVATE PrioritizedDispatcher {
   // Adds |job| with |priority| to the dispatcher. If limits permit, |job| is
   // started immediately. Returns handle to the job or null-handle if the job is
   // started. The dispatcher does not own |job|, but |job| must live as long as
-  // it is queued in the dispatcher.
+  // it is queued in the dispatcher. A job can't be queued more than once at a
+  // time.
   Handle Add(Job* job, Priority priority);
 
   // Just like Add, except that it adds Job at the font of queue of jobs with
@@ -116,7 +167,42 @@ class NET_EXPORT_PRIVATE PrioritizedDispatcher {
   // Set the limits to zero for all priorities, allowing no new jobs to start.
   void SetLimitsToZero();
 
+  // Sets the clock the queueing times of the jobs are measured with.
+  void SetTickClockForTesting(const base::TickClock* tick_clock);
+
  private:
+  // The share of the started jobs that went to a group of jobs.
+  struct GroupState {
+    // The number of queued jobs of the group.
+    size_t num_queued_jobs = 0;
+    // The number of jobs started from the group. A group without queued jobs
+    // catches up to |group_virtual_time_| when a job is queued, so that idle
+    // groups don't bank up a share.
+    uint64_t virtual_time = 0;
+  };
+
+  // Inserts |job| in |queue_|, at the head of the jobs of |priority| if
+  // |at_head|, as queued since |queued_time|.
+  Handle Enqueue(Job* job,
+                 Priority priority,
+                 bool at_head,
+                 base::TimeTicks queued_time);
+
+  // Removes the job with |handle| from |queue_| and returns it. If
+  // |queued_time| isn't null, sets it to the time the job was queued since.
+  Job* Dequeue(const Handle& handle, base::TimeTicks* queued_time);
+
+  // Returns the queued job to start next according to |policy_|, or a null
+  // handle if the limits don't permit starting any.
+  Handle FindNextJob() const;
+
+  // Returns the job to start next among the ones of |priority|.
+  Handle FindNextJobAt(Priority priority) const;
+
+  bool CanStartJobAt(Priority priority) const {
+    return num_running_jobs_ < max_running_jobs_[priority];
+  }
+
   // Attempts to dispatch the job with |handle| at priority |priority| (might be
   // different than |handle.priority()|. Returns true if successful. If so
   // the |handle| becomes invalid.
@@ -134,6 +220,25 @@ class NET_EXPORT_PRIVATE PrioritizedDispatcher {
   std::vector<size_t> max_running_jobs_;
   // Total number of running jobs.
   size_t num_running_jobs_ = 0;
+
+  const Policy policy_;
+  raw_ptr<const base::TickClock> tick_clock_;
+
+  // The times the queued jobs were queued, if |policy_| has a
+  // |max_queue_delay|.
+  std::unordered_map<Job*, base::TimeTicks> queued_times_;
+
+  // If |policy_| has weights, the stride scheduling pass of each priority,
+  // which advances by kMaxWeight / weight for each job started, and the pass
+  // of the last priority a job was started from. The priority with the lowest
+  // pass is behind on its share and starts next.
+  std::vector<uint64_t> priority_passes_;
+  uint64_t pass_ = 0;
+
+  // If |policy_| shares among groups, the groups with queued jobs, and the
+  // virtual time of the last group a job was started from.
+  std::unordered_map<uint64_t, GroupState> groups_;
+  uint64_t group_virtual_time_ = 0;
 };
 
 }  // namespace net
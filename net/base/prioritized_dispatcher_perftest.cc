@@ -0,0 +1,218 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/base/prioritized_dispatcher.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "base/test/simple_test_tick_clock.h"
+#include "base/time/time.h"
+#include "net/base/request_priority.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+// This file replays a trace of host resolutions through PrioritizedDispatchers
+// with different policies, in simulated time, and reports the time the jobs of
+// each priority spent queued. The trace is modeled on a page load heavy
+// session: a steady stream of resolutions for the navigations and subresources
+// of several NetworkIsolationKeys, and bursts of prefetch resolutions from one
+// of them, which together exceed the capacity of the dispatcher.
+
+namespace net {
+
+namespace {
+
+constexpr char kMetricPrefixDispatcher[] = "PrioritizedDispatcher.";
+constexpr char kMetricQueueDelayP50[] = "_queue_delay_p50";
+constexpr char kMetricQueueDelayP99[] = "_queue_delay_p99";
+
+constexpr size_t kMaxRunningJobs = 8;
+constexpr base::TimeDelta kTraceDuration = base::Seconds(60);
+constexpr base::TimeDelta kMeanResolutionTime = base::Milliseconds(50);
+
+struct TraceEntry {
+  // The time the resolution starts, from the start of the trace.
+  base::TimeDelta arrival;
+  RequestPriority priority;
+  uint64_t group;
+  base::TimeDelta duration;
+};
+
+// Returns the resolutions of the session, sorted by arrival time.
+std::vector<TraceEntry> GenerateTrace() {
+  std::minstd_rand generator(42);
+  std::exponential_distribution<double> resolution_time(
+      1 / kMeanResolutionTime.InSecondsF());
+  std::vector<TraceEntry> trace;
+  auto add_resolutions = [&](double per_second, RequestPriority priority,
+                             uint64_t first_group, uint64_t num_groups) {
+    std::exponential_distribution<double> interval(per_second);
+    for (base::TimeDelta arrival; arrival < kTraceDuration;
+         arrival += base::Seconds(interval(generator))) {
+      const uint64_t group = first_group + generator() % num_groups;
+      const base::TimeDelta duration =
+          base::Seconds(resolution_time(generator));
+      trace.push_back({arrival, priority, group, duration});
+    }
+  };
+  add_resolutions(40, HIGHEST, 1, 9);
+  add_resolutions(60, MEDIUM, 1, 9);
+  add_resolutions(20, LOWEST, 1, 9);
+  // Prefetches come in bursts of 50, about once a second, from group 0.
+  std::uniform_real_distribution<double> burst_time(
+      0, kTraceDuration.InSecondsF());
+  for (int i = 0; i < 60; ++i) {
+    const base::TimeDelta arrival = base::Seconds(burst_time(generator));
+    for (int j = 0; j < 50; ++j) {
+      trace.push_back(
+          {arrival, IDLE, 0, base::Seconds(resolution_time(generator))});
+    }
+  }
+  std::stable_sort(trace.begin(), trace.end(),
+                   [](const TraceEntry& a, const TraceEntry& b) {
+                     return a.arrival < b.arrival;
+                   });
+  return trace;
+}
+
+// Runs the jobs of a trace through a dispatcher. A job finishes its duration
+// after the dispatcher starts it.
+class Simulation {
+ public:
+  Simulation(const PrioritizedDispatcher::Limits& limits,
+             const PrioritizedDispatcher::Policy& policy)
+      : dispatcher_(limits, policy), queue_delays_(NUM_PRIORITIES) {
+    dispatcher_.SetTickClockForTesting(&clock_);
+  }
+
+  void Replay(const std::vector<TraceEntry>& trace) {
+    const base::TimeTicks start = clock_.NowTicks();
+    std::vector<std::unique_ptr<SimulatedJob>> jobs;
+    jobs.reserve(trace.size());
+    auto next = trace.begin();
+    while (next != trace.end() || !finish_times_.empty()) {
+      // Arrivals go before the finishes at the same time.
+      if (next != trace.end() &&
+          (finish_times_.empty() ||
+           start + next->arrival <= finish_times_.top())) {
+        clock_.SetNowTicks(start + next->arrival);
+        jobs.push_back(std::make_unique<SimulatedJob>(this, *next));
+        dispatcher_.Add(jobs.back().get(), next->priority);
+        ++next;
+      } else {
+        clock_.SetNowTicks(finish_times_.top());
+        finish_times_.pop();
+        dispatcher_.OnJobFinished();
+      }
+    }
+    EXPECT_EQ(0u, dispatcher_.num_queued_jobs());
+  }
+
+  // Returns the |percentile| of the queue delays of the jobs of |priority|.
+  base::TimeDelta GetQueueDelay(RequestPriority priority, double percentile) {
+    std::vector<base::TimeDelta>& delays = queue_delays_[priority];
+    if (delays.empty())
+      return base::TimeDelta();
+    const size_t index = std::min(
+        delays.size() - 1, static_cast<size_t>(percentile * delays.size()));
+    std::nth_element(delays.begin(), delays.begin() + index, delays.end());
+    return delays[index];
+  }
+
+ private:
+  class SimulatedJob : public PrioritizedDispatcher::Job {
+   public:
+    SimulatedJob(Simulation* simulation, const TraceEntry& entry)
+        : simulation_(simulation),
+          entry_(entry),
+          queued_time_(simulation->clock_.NowTicks()) {}
+
+    void Start() override {
+      const base::TimeTicks now = simulation_->clock_.NowTicks();
+      simulation_->queue_delays_[entry_.priority].push_back(now -
+                                                            queued_time_);
+      simulation_->finish_times_.push(now + entry_.duration);
+    }
+
+    uint64_t GetFairShareGroup() const override { return entry_.group; }
+
+   private:
+    Simulation* const simulation_;
+    const TraceEntry entry_;
+    const base::TimeTicks queued_time_;
+  };
+
+  base::SimpleTestTickClock clock_;
+  PrioritizedDispatcher dispatcher_;
+  std::priority_queue<base::TimeTicks,
+                      std::vector<base::TimeTicks>,
+                      std::greater<>>
+      finish_times_;
+  std::vector<std::vector<base::TimeDelta>> queue_delays_;
+};
+
+void RunTest(const std::string& story_name,
+             const PrioritizedDispatcher::Policy& policy) {
+  Simulation simulation(
+      PrioritizedDispatcher::Limits(NUM_PRIORITIES, kMaxRunningJobs), policy);
+  simulation.Replay(GenerateTrace());
+
+  perf_test::PerfResultReporter reporter(kMetricPrefixDispatcher, story_name);
+  for (RequestPriority priority : {IDLE, LOWEST, MEDIUM, HIGHEST}) {
+    const std::string name = RequestPriorityToString(priority);
+    reporter.RegisterImportantMetric(name + kMetricQueueDelayP50, "ms");
+    reporter.RegisterImportantMetric(name + kMetricQueueDelayP99, "ms");
+    reporter.AddResult(name + kMetricQueueDelayP50,
+                       simulation.GetQueueDelay(priority, 0.5));
+    reporter.AddResult(name + kMetricQueueDelayP99,
+                       simulation.GetQueueDelay(priority, 0.99));
+  }
+}
+
+PrioritizedDispatcher::Policy GetWeightedPolicy() {
+  PrioritizedDispatcher::Policy policy;
+  // THROTTLED, IDLE, LOWEST, LOW, MEDIUM, HIGHEST.
+  policy.weights = {1, 1, 2, 4, 8, 16};
+  return policy;
+}
+
+TEST(PrioritizedDispatcherPerfTest, Strict) {
+  RunTest("Strict", PrioritizedDispatcher::Policy());
+}
+
+TEST(PrioritizedDispatcherPerfTest, Weights) {
+  RunTest("Weights", GetWeightedPolicy());
+}
+
+TEST(PrioritizedDispatcherPerfTest, MaxQueueDelay) {
+  PrioritizedDispatcher::Policy policy;
+  policy.max_queue_delay = base::Seconds(2);
+  RunTest("MaxQueueDelay", policy);
+}
+
+TEST(PrioritizedDispatcherPerfTest, ShareAmongGroups) {
+  PrioritizedDispatcher::Policy policy;
+  policy.share_among_groups = true;
+  RunTest("ShareAmongGroups", policy);
+}
+
+TEST(PrioritizedDispatcherPerfTest, All) {
+  PrioritizedDispatcher::Policy policy = GetWeightedPolicy();
+  policy.max_queue_delay = base::Seconds(2);
+  policy.share_among_groups = true;
+  RunTest("All", policy);
+}
+
+}  // namespace
+
+}  // namespace net
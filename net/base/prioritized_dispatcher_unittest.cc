@@ -13,6 +13,8 @@
 #include "base/compiler_specific.h"
 #include "base/memory/raw_ptr.h"
 #include "base/test/gtest_util.h"
+#include "base/test/simple_test_tick_clock.h"
+#include "base/time/time.h"
 #include "net/base/request_priority.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -51,6 +53,8 @@ class PrioritizedDispatcherTest : public testing::Test {
       return running_;
     }
 
+    void set_group(uint64_t group) { group_ = group; }
+
     const PrioritizedDispatcher::Handle handle() const {
       return handle_;
     }
@@ -127,6 +131,8 @@ class PrioritizedDispatcherTest : public testing::Test {
       log_->append(1u, tag_);
     }
 
+    uint64_t GetFairShareGroup() const override { return group_; }
+
    private:
     raw_ptr<PrioritizedDispatcher> dispatcher_;
 
@@ -135,6 +141,7 @@ class PrioritizedDispatcherTest : public testing::Test {
 
     PrioritizedDispatcher::Handle handle_;
     bool running_;
+    uint64_t group_ = 0;
 
     raw_ptr<std::string> log_;
   };
@@ -144,6 +151,12 @@ class PrioritizedDispatcherTest : public testing::Test {
     dispatcher_ = std::make_unique<PrioritizedDispatcher>(limits);
   }
 
+  void Prepare(const PrioritizedDispatcher::Limits& limits,
+               const PrioritizedDispatcher::Policy& policy) {
+    dispatcher_ = std::make_unique<PrioritizedDispatcher>(limits, policy);
+    dispatcher_->SetTickClockForTesting(&clock_);
+  }
+
   std::unique_ptr<TestJob> AddJob(char data, Priority priority) {
     std::unique_ptr<TestJob> job(
         new TestJob(dispatcher_.get(), data, priority, &log_));
@@ -158,6 +171,16 @@ class PrioritizedDispatcherTest : public testing::Test {
     return job;
   }
 
+  std::unique_ptr<TestJob> AddJobInGroup(char data,
+                                         Priority priority,
+                                         uint64_t group) {
+    std::unique_ptr<TestJob> job(
+        new TestJob(dispatcher_.get(), data, priority, &log_));
+    job->set_group(group);
+    job->Add(false);
+    return job;
+  }
+
   void Expect(const std::string& log) {
     EXPECT_EQ(0u, dispatcher_->num_queued_jobs());
     EXPECT_EQ(0u, dispatcher_->num_running_jobs());
@@ -166,6 +189,7 @@ class PrioritizedDispatcherTest : public testing::Test {
   }
 
   std::string log_;
+  base::SimpleTestTickClock clock_;
   std::unique_ptr<PrioritizedDispatcher> dispatcher_;
 };
 
@@ -532,6 +556,131 @@ TEST_F(PrioritizedDispatcherTest, ZeroLimitsThenIncreasePriority) {
   Expect("a.");
 }
 
+TEST_F(PrioritizedDispatcherTest, PolicyWeights) {
+  PrioritizedDispatcher::Limits limits(NUM_PRIORITIES, 1);
+  PrioritizedDispatcher::Policy policy;
+  policy.weights.assign(NUM_PRIORITIES, 1);
+  policy.weights[HIGHEST] = 2;
+  Prepare(limits, policy);
+
+  std::unique_ptr<TestJob> job_a = AddJob('a', LOWEST);
+  std::unique_ptr<TestJob> job_b = AddJob('b', HIGHEST);
+  std::unique_ptr<TestJob> job_c = AddJob('c', HIGHEST);
+  std::unique_ptr<TestJob> job_d = AddJob('d', HIGHEST);
+  std::unique_ptr<TestJob> job_e = AddJob('e', HIGHEST);
+  std::unique_ptr<TestJob> job_x = AddJob('x', IDLE);
+  std::unique_ptr<TestJob> job_y = AddJob('y', IDLE);
+
+  // HIGHEST gets two jobs started for each one at IDLE.
+  ASSERT_TRUE(job_a->running());
+  job_a->Finish();
+  ASSERT_TRUE(job_b->running());
+  job_b->Finish();
+  ASSERT_TRUE(job_x->running());
+  job_x->Finish();
+  ASSERT_TRUE(job_c->running());
+  job_c->Finish();
+  ASSERT_TRUE(job_d->running());
+  job_d->Finish();
+  ASSERT_TRUE(job_y->running());
+  job_y->Finish();
+  ASSERT_TRUE(job_e->running());
+  job_e->Finish();
+
+  Expect("a.b.x.c.d.y.e.");
+}
+
+TEST_F(PrioritizedDispatcherTest, PolicyWeightsRespectLimits) {
+  PrioritizedDispatcher::Limits limits(NUM_PRIORITIES, 2);
+  limits.reserved_slots[HIGHEST] = 1;
+  PrioritizedDispatcher::Policy policy;
+  policy.weights.assign(NUM_PRIORITIES, 1);
+  Prepare(limits, policy);
+
+  std::unique_ptr<TestJob> job_a = AddJob('a', IDLE);
+  std::unique_ptr<TestJob> job_b = AddJob('b', IDLE);
+  std::unique_ptr<TestJob> job_c = AddJob('c', HIGHEST);
+  std::unique_ptr<TestJob> job_d = AddJob('d', HIGHEST);
+  ASSERT_TRUE(job_a->running());
+  ASSERT_TRUE(job_c->running());
+
+  // Whatever the shares, only HIGHEST can use the slot reserved for it.
+  job_c->Finish();
+  ASSERT_TRUE(job_d->running());
+  job_d->Finish();
+  job_a->Finish();
+  ASSERT_TRUE(job_b->running());
+  job_b->Finish();
+
+  Expect("ac.d..b.");
+}
+
+TEST_F(PrioritizedDispatcherTest, PolicyMaxQueueDelay) {
+  PrioritizedDispatcher::Limits limits(NUM_PRIORITIES, 1);
+  PrioritizedDispatcher::Policy policy;
+  policy.max_queue_delay = base::Seconds(1);
+  Prepare(limits, policy);
+
+  std::unique_ptr<TestJob> job_a = AddJob('a', HIGHEST);
+  std::unique_ptr<TestJob> job_b = AddJob('b', IDLE);
+  std::unique_ptr<TestJob> job_c = AddJob('c', IDLE);
+  clock_.Advance(base::Seconds(2));
+  std::unique_ptr<TestJob> job_d = AddJob('d', HIGHEST);
+  std::unique_ptr<TestJob> job_e = AddJob('e', LOWEST);
+  std::unique_ptr<TestJob> job_f = AddJob('f', HIGHEST);
+  // Changing priorities doesn't reset the time |job_c| has waited.
+  job_c->ChangePriority(LOW);
+
+  // The overdue jobs go first, the longest waiting first.
+  ASSERT_TRUE(job_a->running());
+  job_a->Finish();
+  ASSERT_TRUE(job_b->running());
+  job_b->Finish();
+  ASSERT_TRUE(job_c->running());
+  job_c->Finish();
+  ASSERT_TRUE(job_d->running());
+  job_d->Finish();
+  ASSERT_TRUE(job_f->running());
+  job_f->Finish();
+  ASSERT_TRUE(job_e->running());
+  job_e->Finish();
+
+  Expect("a.b.c.d.f.e.");
+}
+
+TEST_F(PrioritizedDispatcherTest, PolicyShareAmongGroups) {
+  PrioritizedDispatcher::Limits limits(NUM_PRIORITIES, 1);
+  PrioritizedDispatcher::Policy policy;
+  policy.share_among_groups = true;
+  Prepare(limits, policy);
+
+  std::unique_ptr<TestJob> job_a = AddJobInGroup('a', MEDIUM, 1);
+  std::unique_ptr<TestJob> job_b = AddJobInGroup('b', MEDIUM, 1);
+  std::unique_ptr<TestJob> job_c = AddJobInGroup('c', MEDIUM, 1);
+  std::unique_ptr<TestJob> job_d = AddJobInGroup('d', MEDIUM, 1);
+  std::unique_ptr<TestJob> job_x = AddJobInGroup('x', MEDIUM, 2);
+  std::unique_ptr<TestJob> job_y = AddJobInGroup('y', MEDIUM, 2);
+  std::unique_ptr<TestJob> job_z = AddJobInGroup('z', HIGHEST, 3);
+
+  // Priorities still go first, and the groups take turns within them.
+  ASSERT_TRUE(job_a->running());
+  job_a->Finish();
+  ASSERT_TRUE(job_z->running());
+  job_z->Finish();
+  ASSERT_TRUE(job_b->running());
+  job_b->Finish();
+  ASSERT_TRUE(job_x->running());
+  job_x->Finish();
+  ASSERT_TRUE(job_c->running());
+  job_c->Finish();
+  ASSERT_TRUE(job_y->running());
+  job_y->Finish();
+  ASSERT_TRUE(job_d->running());
+  job_d->Finish();
+
+  Expect("a.z.b.x.c.y.d.");
+}
+
 #if GTEST_HAS_DEATH_TEST
 TEST_F(PrioritizedDispatcherTest, CancelNull) {
   PrioritizedDispatcher::Limits limits(NUM_PRIORITIES, 1);
@@ -249,6 +249,17 @@ class PriorityQueue {
     return Pointer();
   }
 
+  // Returns a pointer to the first value of |priority| or a null-pointer if
+  // there is none.
+  Pointer FirstAt(Priority priority) const {
+    DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+    DCHECK_LT(priority, lists_.size());
+    List* list = const_cast<List*>(&lists_[priority]);
+    if (list->empty())
+      return Pointer();
+    return Pointer(priority, list->begin());
+  }
+
   // Given an ordering of the values in this queue by decreasing priority and
   // then FIFO, returns a pointer to the value following the value of the given
   // pointer (which must be non-NULL). I.e., gets the next element in decreasing
@@ -88,6 +88,21 @@ TEST_P(PriorityQueueTest, AddAndClear) {
   CheckEmpty();
 }
 
+TEST_P(PriorityQueueTest, FirstAt) {
+  for (Priority priority = 0; priority < kNumPriorities; ++priority) {
+    PriorityQueue<int>::Pointer first = queue_.FirstAt(priority);
+    size_t i = 0;
+    while (i < kNumElements && kPriorities[GetParam()][i] != priority)
+      ++i;
+    if (i == kNumElements) {
+      EXPECT_TRUE(first.is_null());
+      continue;
+    }
+    EXPECT_TRUE(first.Equals(pointers_[i]));
+    EXPECT_EQ(priority, first.priority());
+  }
+}
+
 TEST_P(PriorityQueueTest, PointerComparison) {
   for (PriorityQueue<int>::Pointer p = queue_.FirstMax();
        !p.Equals(queue_.LastMin()); p = queue_.GetNextTowardsLastMin(p)) {
@@ -0,0 +1,286 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/base/registry_controlled_domains/public_suffix_trie.h"
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <utility>
+
+#include "base/check_op.h"
+#include "base/containers/queue.h"
+#include "base/files/file_path.h"
+#include "base/hash/hash.h"
+#include "base/memory/ptr_util.h"
+#include "base/numerics/checked_math.h"
+#include "base/strings/string_split.h"
+#include "net/base/lookup_string_in_fixed_set.h"
+
+namespace net {
+namespace registry_controlled_domains {
+
+namespace {
+
+constexpr uint32_t kMagic = 0x544c5350;  // "PSLT"
+constexpr uint32_t kVersion = 1;
+
+uint32_t HashLabel(base::StringPiece label) {
+  return base::PersistentHash(label.data(), label.size());
+}
+
+// A node of the trie while it's being built.
+struct BuilderNode {
+  int type = kDafsaNotFound;
+  std::map<std::string, std::unique_ptr<BuilderNode>> children;
+};
+
+// Adds the rules of the DAFSA that are reachable from |lookup|, whose input so
+// far is |reversed_suffix|.
+void CollectRules(const FixedSetIncrementalLookup& lookup,
+                  std::string* reversed_suffix,
+                  std::vector<PublicSuffixTrie::Rule>* rules) {
+  const int type = lookup.GetResultForCurrentSequence();
+  if (type != kDafsaNotFound) {
+    rules->push_back({std::string(reversed_suffix->rbegin(),
+                                  reversed_suffix->rend()),
+                      type});
+  }
+  // The DAFSA only holds printable ASCII.
+  for (char c = '!'; c <= '~'; ++c) {
+    FixedSetIncrementalLookup next = lookup;
+    if (!next.Advance(c))
+      continue;
+    reversed_suffix->push_back(c);
+    CollectRules(next, reversed_suffix, rules);
+    reversed_suffix->pop_back();
+  }
+}
+
+}  // namespace
+
+struct PublicSuffixTrie::Header {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t node_count;
+  uint32_t edge_count;
+  uint32_t labels_size;
+};
+
+struct PublicSuffixTrie::Node {
+  uint32_t first_edge;
+  uint32_t edge_count;
+  // The type of the rule for the suffix of this node, or kDafsaNotFound.
+  int32_t type;
+};
+
+struct PublicSuffixTrie::Edge {
+  uint32_t label_hash;
+  uint32_t label_offset;
+  uint32_t label_length;
+  uint32_t child;
+};
+
+// static
+std::vector<uint8_t> PublicSuffixTrie::Serialize(
+    const std::vector<Rule>& rules) {
+  BuilderNode root;
+  for (const Rule& rule : rules) {
+    std::vector<base::StringPiece> labels = base::SplitStringPiece(
+        rule.suffix, ".", base::KEEP_WHITESPACE, base::SPLIT_WANT_ALL);
+    BuilderNode* node = &root;
+    for (auto it = labels.rbegin(); it != labels.rend(); ++it) {
+      std::unique_ptr<BuilderNode>& child = node->children[std::string(*it)];
+      if (!child)
+        child = std::make_unique<BuilderNode>();
+      node = child.get();
+    }
+    node->type = rule.type;
+  }
+
+  // Numbers the nodes breadth first, so that the children of each node, and
+  // therefore their edges, are consecutive.
+  std::vector<Node> nodes;
+  std::vector<Edge> edges;
+  std::string labels;
+  base::queue<const BuilderNode*> queue;
+  queue.push(&root);
+  uint32_t next_node = 1;
+  while (!queue.empty()) {
+    const BuilderNode* node = queue.front();
+    queue.pop();
+
+    std::vector<std::pair<std::string, const BuilderNode*>> children;
+    for (const auto& child : node->children)
+      children.emplace_back(child.first, child.second.get());
+    std::sort(children.begin(), children.end(),
+              [](const auto& a, const auto& b) {
+                return std::make_pair(HashLabel(a.first), a.first) <
+                       std::make_pair(HashLabel(b.first), b.first);
+              });
+
+    nodes.push_back({static_cast<uint32_t>(edges.size()),
+                     static_cast<uint32_t>(children.size()), node->type});
+    for (const auto& child : children) {
+      edges.push_back({HashLabel(child.first),
+                       static_cast<uint32_t>(labels.size()),
+                       static_cast<uint32_t>(child.first.size()), next_node++});
+      labels.append(child.first);
+      queue.push(child.second);
+    }
+  }
+  DCHECK_EQ(next_node, nodes.size());
+
+  Header header = {kMagic, kVersion, static_cast<uint32_t>(nodes.size()),
+                   static_cast<uint32_t>(edges.size()),
+                   static_cast<uint32_t>(labels.size())};
+  std::vector<uint8_t> data(sizeof(Header) + nodes.size() * sizeof(Node) +
+                            edges.size() * sizeof(Edge) + labels.size());
+  uint8_t* out = data.data();
+  memcpy(out, &header, sizeof(Header));
+  out += sizeof(Header);
+  memcpy(out, nodes.data(), nodes.size() * sizeof(Node));
+  out += nodes.size() * sizeof(Node);
+  memcpy(out, edges.data(), edges.size() * sizeof(Edge));
+  out += edges.size() * sizeof(Edge);
+  memcpy(out, labels.data(), labels.size());
+  return data;
+}
+
+// static
+std::vector<PublicSuffixTrie::Rule> PublicSuffixTrie::GetRulesFromReversedDafsa(
+    const unsigned char* graph,
+    size_t length) {
+  std::vector<Rule> rules;
+  std::string reversed_suffix;
+  CollectRules(FixedSetIncrementalLookup(graph, length), &reversed_suffix,
+               &rules);
+  return rules;
+}
+
+// static
+std::unique_ptr<PublicSuffixTrie> PublicSuffixTrie::CreateFromBytes(
+    base::span<const uint8_t> data) {
+  auto trie = base::WrapUnique(new PublicSuffixTrie());
+  trie->bytes_.assign(data.begin(), data.end());
+  if (!trie->Init(trie->bytes_))
+    return nullptr;
+  return trie;
+}
+
+// static
+std::unique_ptr<PublicSuffixTrie> PublicSuffixTrie::CreateFromFile(
+    const base::FilePath& path) {
+  auto trie = base::WrapUnique(new PublicSuffixTrie());
+  if (!trie->mapped_file_.Initialize(path) ||
+      !trie->Init(base::make_span(trie->mapped_file_.data(),
+                                  trie->mapped_file_.length()))) {
+    return nullptr;
+  }
+  return trie;
+}
+
+PublicSuffixTrie::PublicSuffixTrie() = default;
+
+PublicSuffixTrie::~PublicSuffixTrie() = default;
+
+int PublicSuffixTrie::LookupSuffix(base::StringPiece host,
+                                   bool include_private,
+                                   size_t* suffix_length) const {
+  *suffix_length = 0;
+  int result = kDafsaNotFound;
+  const Node* node = &nodes_[0];
+  // Look up the labels of host from right to left.
+  size_t label_end = host.size();
+  while (true) {
+    const size_t dot =
+        label_end ? host.rfind('.', label_end - 1) : base::StringPiece::npos;
+    const size_t label_begin = dot == base::StringPiece::npos ? 0 : dot + 1;
+    node = FindChild(*node, host.substr(label_begin, label_end - label_begin));
+    if (!node)
+      break;
+    if (node->type != kDafsaNotFound) {
+      // Break if private and private rules should be excluded.
+      if ((node->type & kDafsaPrivateRule) && !include_private)
+        break;
+      // Since hosts are looked up from right to left, the last saved values
+      // will be from the longest match.
+      *suffix_length = host.size() - label_begin;
+      result = node->type;
+    }
+    if (dot == base::StringPiece::npos)
+      break;
+    label_end = dot;
+  }
+  return result;
+}
+
+bool PublicSuffixTrie::Init(base::span<const uint8_t> data) {
+  if (data.size() < sizeof(Header) ||
+      reinterpret_cast<uintptr_t>(data.data()) % alignof(Header) != 0) {
+    return false;
+  }
+  const Header* header = reinterpret_cast<const Header*>(data.data());
+  if (header->magic != kMagic || header->version != kVersion ||
+      header->node_count == 0) {
+    return false;
+  }
+
+  base::CheckedNumeric<size_t> size = sizeof(Header);
+  size += base::CheckMul<size_t>(header->node_count, sizeof(Node));
+  size += base::CheckMul<size_t>(header->edge_count, sizeof(Edge));
+  size += header->labels_size;
+  if (!size.IsValid() || size.ValueOrDie() != data.size())
+    return false;
+
+  nodes_ = reinterpret_cast<const Node*>(data.data() + sizeof(Header));
+  node_count_ = header->node_count;
+  edges_ = reinterpret_cast<const Edge*>(nodes_ + node_count_);
+  edge_count_ = header->edge_count;
+  labels_ = reinterpret_cast<const char*>(edges_ + edge_count_);
+  labels_size_ = header->labels_size;
+
+  // The data may come from disk, so check that lookups stay in bounds.
+  for (size_t i = 0; i < node_count_; ++i) {
+    const Node& node = nodes_[i];
+    if (node.first_edge > edge_count_ ||
+        node.edge_count > edge_count_ - node.first_edge ||
+        node.type < kDafsaNotFound ||
+        node.type > (kDafsaExceptionRule | kDafsaWildcardRule |
+                     kDafsaPrivateRule)) {
+      return false;
+    }
+  }
+  for (size_t i = 0; i < edge_count_; ++i) {
+    const Edge& edge = edges_[i];
+    if (edge.child >= node_count_ || edge.label_offset > labels_size_ ||
+        edge.label_length > labels_size_ - edge.label_offset) {
+      return false;
+    }
+  }
+  return true;
+}
+
+const PublicSuffixTrie::Node* PublicSuffixTrie::FindChild(
+    const Node& node,
+    base::StringPiece label) const {
+  if (label.empty())
+    return nullptr;
+  const uint32_t hash = HashLabel(label);
+  const Edge* begin = edges_ + node.first_edge;
+  const Edge* end = begin + node.edge_count;
+  for (const Edge* edge = std::lower_bound(
+           begin, end, hash,
+           [](const Edge& e, uint32_t h) { return e.label_hash < h; });
+       edge != end && edge->label_hash == hash; ++edge) {
+    if (base::StringPiece(labels_ + edge->label_offset, edge->label_length) ==
+        label) {
+      return &nodes_[edge->child];
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace registry_controlled_domains
+}  // namespace net
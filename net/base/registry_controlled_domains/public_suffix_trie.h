@@ -0,0 +1,115 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_BASE_REGISTRY_CONTROLLED_DOMAINS_PUBLIC_SUFFIX_TRIE_H_
+#define NET_BASE_REGISTRY_CONTROLLED_DOMAINS_PUBLIC_SUFFIX_TRIE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/containers/span.h"
+#include "base/files/memory_mapped_file.h"
+#include "base/strings/string_piece.h"
+#include "net/base/net_export.h"
+
+namespace base {
+class FilePath;
+}
+
+namespace net {
+namespace registry_controlled_domains {
+
+// A trie of the public suffix list keyed by host labels from right to left,
+// in a flat binary format that can be memory-mapped and read without parsing.
+//
+// Each node of the trie is a label sequence, e.g. "uk" -> "co" for "co.uk",
+// holding the rule type of that suffix, if any. The children of a node are
+// sorted by a hash of their label, so each label of a host costs one binary
+// search and one comparison of the label, rather than a walk over its
+// characters as in the DAFSA.
+//
+// The serialized format, in native byte order, is:
+//   Header
+//   Node[node_count]    The root is node 0.
+//   Edge[edge_count]    The children of each node are consecutive, by hash.
+//   char[labels_size]   The labels of the edges.
+//
+// A PublicSuffixTrie is immutable, and can be used from any thread without
+// locking.
+class NET_EXPORT PublicSuffixTrie {
+ public:
+  struct Rule {
+    // The suffix, e.g. "co.uk". Wildcard and exception rules are stored
+    // without their "*." and "!" prefixes, as in the .gperf files.
+    std::string suffix;
+    // A bitmask of kDafsaExceptionRule, kDafsaWildcardRule and
+    // kDafsaPrivateRule, or kDafsaFound.
+    int type;
+  };
+
+  // Returns the serialized trie for |rules|.
+  static std::vector<uint8_t> Serialize(const std::vector<Rule>& rules);
+
+  // Returns the rules in a reversed DAFSA generated by make_dafsa.py, like
+  // the one compiled into registry_controlled_domain.cc. This is slow, and
+  // meant for generating the serialized trie, e.g. when the list is updated.
+  static std::vector<Rule> GetRulesFromReversedDafsa(const unsigned char* graph,
+                                                     size_t length);
+
+  // Returns a trie over |data|, or null if |data| isn't a valid serialized
+  // trie. The trie either copies |data| or maps |path|.
+  static std::unique_ptr<PublicSuffixTrie> CreateFromBytes(
+      base::span<const uint8_t> data);
+  static std::unique_ptr<PublicSuffixTrie> CreateFromFile(
+      const base::FilePath& path);
+
+  PublicSuffixTrie(const PublicSuffixTrie&) = delete;
+  PublicSuffixTrie& operator=(const PublicSuffixTrie&) = delete;
+
+  ~PublicSuffixTrie();
+
+  // Same as LookupSuffixInReversedSet(): finds the rule for the longest suffix
+  // of |host| that starts at a label, writes its length to |suffix_length|,
+  // and returns its type. Returns kDafsaNotFound, and writes 0, if there's no
+  // matching rule.
+  int LookupSuffix(base::StringPiece host,
+                   bool include_private,
+                   size_t* suffix_length) const;
+
+  size_t node_count() const { return node_count_; }
+
+ private:
+  struct Header;
+  struct Node;
+  struct Edge;
+
+  PublicSuffixTrie();
+
+  // Points the trie at |data|, which must stay alive. Returns false if |data|
+  // isn't a valid serialized trie.
+  bool Init(base::span<const uint8_t> data);
+
+  // Returns the child of |node| for |label|, or null.
+  const Node* FindChild(const Node& node, base::StringPiece label) const;
+
+  // Only one of these owns the data.
+  std::vector<uint8_t> bytes_;
+  base::MemoryMappedFile mapped_file_;
+
+  const Node* nodes_ = nullptr;
+  size_t node_count_ = 0;
+  const Edge* edges_ = nullptr;
+  size_t edge_count_ = 0;
+  const char* labels_ = nullptr;
+  size_t labels_size_ = 0;
+};
+
+}  // namespace registry_controlled_domains
+}  // namespace net
+
+#endif  // NET_BASE_REGISTRY_CONTROLLED_DOMAINS_PUBLIC_SUFFIX_TRIE_H_
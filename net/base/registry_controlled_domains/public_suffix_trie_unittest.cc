@@ -0,0 +1,152 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/base/registry_controlled_domains/public_suffix_trie.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/containers/span.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "net/base/lookup_string_in_fixed_set.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+namespace test1 {
+#include "net/base/registry_controlled_domains/effective_tld_names_unittest1-reversed-inc.cc"
+}
+}  // namespace
+
+namespace net {
+namespace registry_controlled_domains {
+
+namespace {
+
+std::vector<uint8_t> SerializeTest1() {
+  return PublicSuffixTrie::Serialize(
+      PublicSuffixTrie::GetRulesFromReversedDafsa(test1::kDafsa,
+                                                  sizeof(test1::kDafsa)));
+}
+
+TEST(PublicSuffixTrieTest, GetRulesFromReversedDafsa) {
+  std::vector<std::pair<std::string, int>> rules;
+  for (const auto& rule : PublicSuffixTrie::GetRulesFromReversedDafsa(
+           test1::kDafsa, sizeof(test1::kDafsa))) {
+    rules.emplace_back(rule.suffix, rule.type);
+  }
+  std::sort(rules.begin(), rules.end());
+  // The rules of effective_tld_names_unittest1.gperf.
+  const std::vector<std::pair<std::string, int>> kExpected = {
+      {"ac.jp", kDafsaFound},
+      {"b.c", kDafsaExceptionRule},
+      {"bar.baz.com", kDafsaFound},
+      {"bar.jp", kDafsaWildcardRule},
+      {"baz.bar.jp", kDafsaWildcardRule},
+      {"c", kDafsaWildcardRule},
+      {"jp", kDafsaFound},
+      {"no", kDafsaFound},
+      {"pref.bar.jp", kDafsaExceptionRule},
+      {"priv.no", kDafsaPrivateRule},
+      {"private", kDafsaPrivateRule},
+      {"xn--fiqs8s", kDafsaFound},
+  };
+  EXPECT_EQ(kExpected, rules);
+}
+
+TEST(PublicSuffixTrieTest, MatchesDafsa) {
+  std::unique_ptr<PublicSuffixTrie> trie =
+      PublicSuffixTrie::CreateFromBytes(SerializeTest1());
+  ASSERT_TRUE(trie);
+
+  const char* const kHosts[] = {
+      "",           "jp",           "a.jp",          "ac.jp",
+      "a.ac.jp",    "xac.jp",       "bar.jp",        "a.bar.jp",
+      "a.b.bar.jp", "pref.bar.jp",  "a.pref.bar.jp", "baz.bar.jp",
+      "a.baz.bar.jp", "bar.baz.com", "a.bar.baz.com", "baz.com",
+      "c",          "a.c",          "b.c",           "a.b.c",
+      "no",         "priv.no",      "a.priv.no",     "private",
+      "a.private",  "xn--fiqs8s",   "a.xn--fiqs8s",  "com",
+      ".jp",        "a..jp",        "unknown",
+  };
+  for (const char* host : kHosts) {
+    for (bool include_private : {false, true}) {
+      SCOPED_TRACE(testing::Message() << host << " " << include_private);
+      size_t dafsa_length = 1;
+      const int dafsa_type = LookupSuffixInReversedSet(
+          test1::kDafsa, sizeof(test1::kDafsa), include_private, host,
+          &dafsa_length);
+      size_t trie_length = 1;
+      EXPECT_EQ(dafsa_type,
+                trie->LookupSuffix(host, include_private, &trie_length));
+      EXPECT_EQ(dafsa_length, trie_length);
+    }
+  }
+}
+
+TEST(PublicSuffixTrieTest, PrivateRules) {
+  std::unique_ptr<PublicSuffixTrie> trie = PublicSuffixTrie::CreateFromBytes(
+      PublicSuffixTrie::Serialize({{"com", kDafsaFound},
+                                   {"example.com", kDafsaPrivateRule},
+                                   {"a.example.com", kDafsaFound}}));
+  ASSERT_TRUE(trie);
+
+  size_t length;
+  EXPECT_EQ(kDafsaFound, trie->LookupSuffix("x.a.example.com", true, &length));
+  EXPECT_EQ(13u, length);
+  EXPECT_EQ(kDafsaPrivateRule,
+            trie->LookupSuffix("x.example.com", true, &length));
+  EXPECT_EQ(11u, length);
+  // As with the DAFSA, excluding a private rule also excludes the rules that
+  // extend it.
+  EXPECT_EQ(kDafsaFound, trie->LookupSuffix("x.a.example.com", false, &length));
+  EXPECT_EQ(3u, length);
+}
+
+TEST(PublicSuffixTrieTest, CreateFromFile) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  const base::FilePath path = temp_dir.GetPath().AppendASCII("psl.trie");
+  const std::vector<uint8_t> data = SerializeTest1();
+  ASSERT_TRUE(base::WriteFile(path, data));
+
+  std::unique_ptr<PublicSuffixTrie> trie =
+      PublicSuffixTrie::CreateFromFile(path);
+  ASSERT_TRUE(trie);
+  size_t length;
+  EXPECT_EQ(kDafsaFound, trie->LookupSuffix("a.ac.jp", false, &length));
+  EXPECT_EQ(5u, length);
+
+  EXPECT_FALSE(PublicSuffixTrie::CreateFromFile(
+      temp_dir.GetPath().AppendASCII("missing.trie")));
+}
+
+TEST(PublicSuffixTrieTest, RejectsInvalidData) {
+  const std::vector<uint8_t> data = SerializeTest1();
+  ASSERT_TRUE(PublicSuffixTrie::CreateFromBytes(data));
+
+  EXPECT_FALSE(PublicSuffixTrie::CreateFromBytes({}));
+  EXPECT_FALSE(PublicSuffixTrie::CreateFromBytes(
+      base::make_span(data).first(data.size() - 1)));
+
+  std::vector<uint8_t> bad_magic = data;
+  bad_magic[0] ^= 1;
+  EXPECT_FALSE(PublicSuffixTrie::CreateFromBytes(bad_magic));
+
+  // Points the first edge of the root past the end of the edges.
+  std::vector<uint8_t> bad_edge = data;
+  const uint32_t kBadFirstEdge = 0x10000;
+  memcpy(bad_edge.data() + 5 * sizeof(uint32_t), &kBadFirstEdge,
+         sizeof(kBadFirstEdge));
+  EXPECT_FALSE(PublicSuffixTrie::CreateFromBytes(bad_edge));
+}
+
+}  // namespace
+
+}  // namespace registry_controlled_domains
+}  // namespace net
@@ -45,13 +45,22 @@
 
 #include "net/base/registry_controlled_domains/registry_controlled_domain.h"
 
+#include <atomic>
+#include <memory>
+#include <utility>
+
 #include "base/check_op.h"
+#include "base/hash/hash.h"
+#include "base/memory/ptr_util.h"
+#include "base/no_destructor.h"
 #include "base/notreached.h"
 #include "base/strings/string_piece.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/threading/thread_local.h"
 #include "net/base/lookup_string_in_fixed_set.h"
 #include "net/base/net_module.h"
+#include "net/base/registry_controlled_domains/public_suffix_trie.h"
 #include "net/base/url_util.h"
 #include "url/gurl.h"
 #include "url/origin.h"
@@ -69,6 +78,105 @@ namespace {
 const unsigned char* g_graph = kDafsa;
 size_t g_graph_length = sizeof(kDafsa);
 
+// If set, used instead of |g_graph|. Owns the trie, which is destroyed when
+// SetPublicSuffixTrie() replaces it, and otherwise lives until shutdown.
+std::unique_ptr<PublicSuffixTrie>& GetTrie() {
+  static base::NoDestructor<std::unique_ptr<PublicSuffixTrie>> trie;
+  return *trie;
+}
+
+// Incremented whenever the rules change, to invalidate the lookup caches.
+std::atomic<uint32_t> g_rules_generation{1};
+
+// A per-thread cache of suffix lookups. Pages tend to look up the same few
+// hosts over and over, e.g. for cookies and same-site checks, so this avoids
+// most walks of the rules. It's direct-mapped, so a lookup costs a hash of the
+// host and one comparison, and being per-thread, it needs no locking.
+class LookupCache {
+ public:
+  static LookupCache* Get() {
+    static base::NoDestructor<base::ThreadLocalOwnedPointer<LookupCache>>
+        cache;
+    LookupCache* current = cache->Get();
+    if (!current) {
+      current = new LookupCache();
+      cache->Set(base::WrapUnique(current));
+    }
+    return current;
+  }
+
+  // Returns true and sets |type| and |suffix_length| if |host| is cached.
+  bool Find(base::StringPiece host,
+            bool include_private,
+            uint32_t generation,
+            int* type,
+            size_t* suffix_length) const {
+    const Entry& entry = entries_[Slot(host)];
+    if (entry.generation != generation ||
+        entry.include_private != include_private || entry.host != host) {
+      return false;
+    }
+    *type = entry.type;
+    *suffix_length = entry.suffix_length;
+    return true;
+  }
+
+  void Insert(base::StringPiece host,
+              bool include_private,
+              uint32_t generation,
+              int type,
+              size_t suffix_length) {
+    // Don't let unusually long hosts pin memory.
+    if (host.size() > kMaxHostLength)
+      return;
+    Entry& entry = entries_[Slot(host)];
+    entry.generation = generation;
+    entry.include_private = include_private;
+    entry.host.assign(host.data(), host.size());
+    entry.type = type;
+    entry.suffix_length = suffix_length;
+  }
+
+ private:
+  static constexpr size_t kSize = 256;
+  static constexpr size_t kMaxHostLength = 128;
+
+  struct Entry {
+    // 0 is never a valid generation, so new entries don't match.
+    uint32_t generation = 0;
+    bool include_private = false;
+    std::string host;
+    int type = kDafsaNotFound;
+    size_t suffix_length = 0;
+  };
+
+  static size_t Slot(base::StringPiece host) {
+    return base::FastHash(host) % kSize;
+  }
+
+  Entry entries_[kSize];
+};
+
+// Same as LookupSuffixInReversedSet(), but uses the current rules, and the
+// cache.
+int LookupSuffix(base::StringPiece host,
+                 bool include_private,
+                 size_t* suffix_length) {
+  const uint32_t generation =
+      g_rules_generation.load(std::memory_order_relaxed);
+  LookupCache* cache = LookupCache::Get();
+  int type;
+  if (cache->Find(host, include_private, generation, &type, suffix_length))
+    return type;
+
+  const PublicSuffixTrie* trie = GetTrie().get();
+  type = trie ? trie->LookupSuffix(host, include_private, suffix_length)
+              : LookupSuffixInReversedSet(g_graph, g_graph_length,
+                                          include_private, host, suffix_length);
+  cache->Insert(host, include_private, generation, type, *suffix_length);
+  return type;
+}
+
 struct MappedHostComponent {
   size_t original_begin;
   size_t original_end;
@@ -83,9 +191,8 @@ size_t GetRegistryLengthInTrimmedHost(base::StringPiece host,
                                       UnknownRegistryFilter unknown_filter,
                                       PrivateRegistryFilter private_filter) {
   size_t length;
-  int type = LookupSuffixInReversedSet(
-      g_graph, g_graph_length, private_filter == INCLUDE_PRIVATE_REGISTRIES,
-      host, &length);
+  int type = LookupSuffix(host, private_filter == INCLUDE_PRIVATE_REGISTRIES,
+                          &length);
 
   DCHECK_LE(length, host.size());
 
@@ -456,6 +563,7 @@ size_t PermissiveGetHostRegistryLength(base::StringPiece16 host,
 }
 
 void SetFindDomainGraph() {
+  SetPublicSuffixTrie(nullptr);
   g_graph = kDafsa;
   g_graph_length = sizeof(kDafsa);
 }
@@ -463,9 +571,15 @@ void SetFindDomainGraph() {
 void SetFindDomainGraph(const unsigned char* domains, size_t length) {
   CHECK(domains);
   CHECK_NE(length, 0u);
+  SetPublicSuffixTrie(nullptr);
   g_graph = domains;
   g_graph_length = length;
 }
 
+void SetPublicSuffixTrie(std::unique_ptr<PublicSuffixTrie> trie) {
+  GetTrie() = std::move(trie);
+  g_rules_generation.fetch_add(1, std::memory_order_relaxed);
+}
+
 }  // namespace registry_controlled_domains
 }  // namespace net
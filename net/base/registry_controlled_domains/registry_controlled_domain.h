@@ -115,6 +115,7 @@
 
 #include <stddef.h>
 
+#include <memory>
 #include <string>
 
 #include "base/strings/string_piece.h"
@@ -132,6 +133,8 @@ struct DomainRule;
 namespace net {
 namespace registry_controlled_domains {
 
+class PublicSuffixTrie;
+
 // This enum is a required parameter to all public methods declared for this
 // service. The Public Suffix List (http://publicsuffix.org/) this service
 // uses as a data source splits all effective-TLDs into two groups. The main
@@ -303,6 +306,14 @@ NET_EXPORT_PRIVATE void SetFindDomainGraph();
 NET_EXPORT_PRIVATE void SetFindDomainGraph(const unsigned char* domains,
                                            size_t length);
 
+// Looks up suffixes in |trie| rather than in the graph, e.g. with a trie
+// mapped from a file with PublicSuffixTrie::CreateFromFile(). Takes ownership
+// of |trie| and destroys the trie set before, if any; passing null goes back
+// to the graph. Like SetFindDomainGraph(), this must not be called while other
+// threads look up domains.
+NET_EXPORT_PRIVATE void SetPublicSuffixTrie(
+    std::unique_ptr<PublicSuffixTrie> trie);
+
 }  // namespace registry_controlled_domains
 }  // namespace net
 
@@ -0,0 +1,142 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/base/registry_controlled_domains/registry_controlled_domain.h"
+
+#include <stddef.h>
+
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/cxx17_backports.h"
+#include "base/strings/stringprintf.h"
+#include "base/timer/elapsed_timer.h"
+#include "net/base/lookup_string_in_fixed_set.h"
+#include "net/base/registry_controlled_domains/public_suffix_trie.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace {
+#include "net/base/registry_controlled_domains/effective_tld_names-reversed-inc.cc"
+}  // namespace
+
+// This file compares looking up the registries of hosts in the DAFSA and in a
+// PublicSuffixTrie, directly and through GetDomainAndRegistry() with its
+// cache. The hosts follow a Zipf distribution, like the sites of the top
+// million list, where a few popular sites make up most of the lookups.
+
+namespace net {
+namespace registry_controlled_domains {
+
+namespace {
+
+constexpr char kMetricPrefixRegistry[] = "RegistryControlledDomain.";
+constexpr char kMetricLookupsPerSecond[] = "lookups_per_second";
+
+constexpr size_t kNumSites = 100000;
+constexpr size_t kNumLookups = 1000000;
+
+// Common suffixes, roughly by popularity.
+const char* const kSuffixes[] = {
+    "com",    "net",         "org",       "co.uk",        "de",
+    "ru",     "jp",          "com.br",    "fr",           "it",
+    "in",     "co.jp",       "io",        "com.au",       "nl",
+    "pl",     "cn",          "com.cn",    "appspot.com",  "github.io",
+    "gov.uk", "blogspot.com", "edu",      "s3.amazonaws.com",
+};
+
+const char* const kSubdomains[] = {"", "www.", "m.", "cdn.", "api.",
+                                   "static.a1."};
+
+perf_test::PerfResultReporter SetUpReporter(const std::string& story_name) {
+  perf_test::PerfResultReporter reporter(kMetricPrefixRegistry, story_name);
+  reporter.RegisterImportantMetric(kMetricLookupsPerSecond, "runs/s");
+  return reporter;
+}
+
+// Returns kNumLookups hosts drawn from kNumSites sites.
+std::vector<std::string> GenerateHosts() {
+  std::minstd_rand generator(42);
+  std::vector<std::string> sites;
+  std::vector<double> weights;
+  for (size_t i = 0; i < kNumSites; ++i) {
+    sites.push_back(base::StringPrintf(
+        "%ssite%zu.%s", kSubdomains[generator() % base::size(kSubdomains)], i,
+        kSuffixes[i % base::size(kSuffixes)]));
+    weights.push_back(1.0 / (i + 1));
+  }
+  std::discrete_distribution<size_t> zipf(weights.begin(), weights.end());
+  std::vector<std::string> hosts;
+  hosts.reserve(kNumLookups);
+  for (size_t i = 0; i < kNumLookups; ++i)
+    hosts.push_back(sites[zipf(generator)]);
+  return hosts;
+}
+
+class RegistryControlledDomainPerfTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    hosts_ = GenerateHosts();
+    trie_ = PublicSuffixTrie::CreateFromBytes(PublicSuffixTrie::Serialize(
+        PublicSuffixTrie::GetRulesFromReversedDafsa(kDafsa, sizeof(kDafsa))));
+    ASSERT_TRUE(trie_);
+  }
+
+  void TearDown() override { SetFindDomainGraph(); }
+
+  template <typename Lookup>
+  void RunTest(const std::string& story_name, Lookup lookup) {
+    size_t total_length = 0;
+    base::ElapsedTimer timer;
+    for (const std::string& host : hosts_)
+      total_length += lookup(host);
+    const base::TimeDelta elapsed = timer.Elapsed();
+    // Keeps the lookups from being optimized away.
+    EXPECT_NE(0u, total_length);
+
+    auto reporter = SetUpReporter(story_name);
+    reporter.AddResult(kMetricLookupsPerSecond,
+                       hosts_.size() / elapsed.InSecondsF());
+  }
+
+  std::vector<std::string> hosts_;
+  std::unique_ptr<PublicSuffixTrie> trie_;
+};
+
+TEST_F(RegistryControlledDomainPerfTest, Dafsa) {
+  RunTest("Dafsa", [](const std::string& host) {
+    size_t length;
+    LookupSuffixInReversedSet(kDafsa, sizeof(kDafsa), false, host, &length);
+    return length;
+  });
+}
+
+TEST_F(RegistryControlledDomainPerfTest, Trie) {
+  RunTest("Trie", [this](const std::string& host) {
+    size_t length;
+    trie_->LookupSuffix(host, false, &length);
+    return length;
+  });
+}
+
+TEST_F(RegistryControlledDomainPerfTest, GetDomainAndRegistryDafsa) {
+  RunTest("GetDomainAndRegistryDafsa", [](const std::string& host) {
+    return GetDomainAndRegistry(host, EXCLUDE_PRIVATE_REGISTRIES).size();
+  });
+}
+
+TEST_F(RegistryControlledDomainPerfTest, GetDomainAndRegistryTrie) {
+  SetPublicSuffixTrie(std::move(trie_));
+  RunTest("GetDomainAndRegistryTrie", [](const std::string& host) {
+    return GetDomainAndRegistry(host, EXCLUDE_PRIVATE_REGISTRIES).size();
+  });
+}
+
+}  // namespace
+
+}  // namespace registry_controlled_domains
+}  // namespace net
@@ -4,7 +4,11 @@
 
 #include "net/base/registry_controlled_domains/registry_controlled_domain.h"
 
+#include <memory>
+#include <utility>
+
 #include "base/strings/utf_string_conversions.h"
+#include "net/base/registry_controlled_domains/public_suffix_trie.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "url/buildflags.h"
 #include "url/gurl.h"
@@ -84,12 +88,21 @@ size_t GetCanonicalHostRegistryLengthIncludingPrivate(const std::string& host) {
 
 }  // namespace
 
-class RegistryControlledDomainTest : public testing::Test {
+// The tests run on both the graph and a PublicSuffixTrie generated from it.
+class RegistryControlledDomainTest : public testing::TestWithParam<bool> {
  protected:
   template <typename Graph>
   void UseDomainData(const Graph& graph) {
     // This is undone in TearDown.
     SetFindDomainGraph(graph, sizeof(Graph));
+    if (GetParam()) {
+      std::unique_ptr<PublicSuffixTrie> trie =
+          PublicSuffixTrie::CreateFromBytes(PublicSuffixTrie::Serialize(
+              PublicSuffixTrie::GetRulesFromReversedDafsa(graph,
+                                                          sizeof(Graph))));
+      ASSERT_TRUE(trie);
+      SetPublicSuffixTrie(std::move(trie));
+    }
   }
 
   bool CompareDomains(const std::string& url1, const std::string& url2) {
@@ -106,7 +119,9 @@ class RegistryControlledDomainTest : public testing::Test {
   void TearDown() override { SetFindDomainGraph(); }
 };
 
-TEST_F(RegistryControlledDomainTest, TestGetDomainAndRegistry) {
+INSTANTIATE_TEST_SUITE_P(All, RegistryControlledDomainTest, testing::Bool());
+
+TEST_P(RegistryControlledDomainTest, TestGetDomainAndRegistry) {
   UseDomainData(test1::kDafsa);
 
   struct {
@@ -179,7 +194,7 @@ TEST_F(RegistryControlledDomainTest, TestGetDomainAndRegistry) {
   EXPECT_EQ("", GetDomainFromHost(".localhost."));
 }
 
-TEST_F(RegistryControlledDomainTest, TestGetRegistryLength) {
+TEST_P(RegistryControlledDomainTest, TestGetRegistryLength) {
   UseDomainData(test1::kDafsa);
 
   // Test GURL version of GetRegistryLength().
@@ -324,7 +339,7 @@ TEST_F(RegistryControlledDomainTest, TestGetRegistryLength) {
                                                 EXCLUDE_UNKNOWN_REGISTRIES));
 }
 
-TEST_F(RegistryControlledDomainTest, HostHasRegistryControlledDomain) {
+TEST_P(RegistryControlledDomainTest, HostHasRegistryControlledDomain) {
   UseDomainData(test1::kDafsa);
 
   // Invalid hosts.
@@ -352,7 +367,7 @@ TEST_F(RegistryControlledDomainTest, HostHasRegistryControlledDomain) {
       "www.Google.Jp", EXCLUDE_UNKNOWN_REGISTRIES, EXCLUDE_PRIVATE_REGISTRIES));
 }
 
-TEST_F(RegistryControlledDomainTest, TestSameDomainOrHost) {
+TEST_P(RegistryControlledDomainTest, TestSameDomainOrHost) {
   UseDomainData(test2::kDafsa);
 
   EXPECT_TRUE(CompareDomains("http://a.b.bar.jp/file.html",
@@ -391,7 +406,7 @@ TEST_F(RegistryControlledDomainTest, TestSameDomainOrHost) {
       CompareDomains("https://foo.example.com", "https://foo.example.com."));
 }
 
-TEST_F(RegistryControlledDomainTest, TestDefaultData) {
+TEST_P(RegistryControlledDomainTest, TestDefaultData) {
   // Note that no data is set: we're using the default rules.
   EXPECT_EQ(3U, GetRegistryLengthFromURL("http://google.com",
                                          EXCLUDE_UNKNOWN_REGISTRIES));
@@ -409,7 +424,7 @@ TEST_F(RegistryControlledDomainTest, TestDefaultData) {
                                          INCLUDE_UNKNOWN_REGISTRIES));
 }
 
-TEST_F(RegistryControlledDomainTest, TestPrivateRegistryHandling) {
+TEST_P(RegistryControlledDomainTest, TestPrivateRegistryHandling) {
   UseDomainData(test1::kDafsa);
 
   // Testing the same dataset for INCLUDE_PRIVATE_REGISTRIES and
@@ -462,7 +477,21 @@ TEST_F(RegistryControlledDomainTest, TestPrivateRegistryHandling) {
                                                INCLUDE_UNKNOWN_REGISTRIES));
 }
 
-TEST_F(RegistryControlledDomainTest, TestDafsaTwoByteOffsets) {
+TEST_P(RegistryControlledDomainTest, ChangingRulesInvalidatesCache) {
+  // "*.bar.jp" in test1 is "bar.jp" in test2.
+  UseDomainData(test1::kDafsa);
+  EXPECT_EQ("a.b.bar.jp",
+            GetDomainAndRegistry("a.b.bar.jp", EXCLUDE_PRIVATE_REGISTRIES));
+  // Looked up again, from the cache.
+  EXPECT_EQ("a.b.bar.jp",
+            GetDomainAndRegistry("a.b.bar.jp", EXCLUDE_PRIVATE_REGISTRIES));
+
+  UseDomainData(test2::kDafsa);
+  EXPECT_EQ("b.bar.jp",
+            GetDomainAndRegistry("a.b.bar.jp", EXCLUDE_PRIVATE_REGISTRIES));
+}
+
+TEST_P(RegistryControlledDomainTest, TestDafsaTwoByteOffsets) {
   UseDomainData(test3::kDafsa);
 
   // Testing to lookup keys in a DAFSA with two byte offsets.
@@ -490,7 +519,7 @@ TEST_F(RegistryControlledDomainTest, TestDafsaTwoByteOffsets) {
             GetCanonicalHostRegistryLength(key2, EXCLUDE_UNKNOWN_REGISTRIES));
 }
 
-TEST_F(RegistryControlledDomainTest, TestDafsaThreeByteOffsets) {
+TEST_P(RegistryControlledDomainTest, TestDafsaThreeByteOffsets) {
   UseDomainData(test4::kDafsa);
 
   // Testing to lookup keys in a DAFSA with three byte offsets.
@@ -524,7 +553,7 @@ TEST_F(RegistryControlledDomainTest, TestDafsaThreeByteOffsets) {
             GetCanonicalHostRegistryLength(key2, EXCLUDE_UNKNOWN_REGISTRIES));
 }
 
-TEST_F(RegistryControlledDomainTest, TestDafsaJoinedPrefixes) {
+TEST_P(RegistryControlledDomainTest, TestDafsaJoinedPrefixes) {
   UseDomainData(test5::kDafsa);
 
   // Testing to lookup keys in a DAFSA with compressed prefixes.
@@ -559,7 +588,7 @@ TEST_F(RegistryControlledDomainTest, TestDafsaJoinedPrefixes) {
             GetCanonicalHostRegistryLength(key7, EXCLUDE_UNKNOWN_REGISTRIES));
 }
 
-TEST_F(RegistryControlledDomainTest, TestDafsaJoinedSuffixes) {
+TEST_P(RegistryControlledDomainTest, TestDafsaJoinedSuffixes) {
   UseDomainData(test6::kDafsa);
 
   // Testing to lookup keys in a DAFSA with compressed suffixes.
@@ -594,7 +623,7 @@ TEST_F(RegistryControlledDomainTest, TestDafsaJoinedSuffixes) {
             GetCanonicalHostRegistryLength(key7, EXCLUDE_UNKNOWN_REGISTRIES));
 }
 
-TEST_F(RegistryControlledDomainTest, Permissive) {
+TEST_P(RegistryControlledDomainTest, Permissive) {
   UseDomainData(test1::kDafsa);
 
   EXPECT_EQ(std::string::npos, PermissiveGetHostRegistryLength(""));
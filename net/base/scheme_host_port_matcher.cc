@@ -4,6 +4,9 @@
 
 #include "net/base/scheme_host_port_matcher.h"
 
+#include <algorithm>
+#include <functional>
+
 #include "base/containers/contains.h"
 #include "base/strings/string_tokenizer.h"
 #include "base/strings/string_util.h"
@@ -41,11 +44,13 @@ void SchemeHostPortMatcher::AddAsFirstRule(
     std::unique_ptr<SchemeHostPortMatcherRule> rule) {
   DCHECK(rule);
   rules_.insert(rules_.begin(), std::move(rule));
+  RebuildIndex();
 }
 
 void SchemeHostPortMatcher::AddAsLastRule(
     std::unique_ptr<SchemeHostPortMatcherRule> rule) {
   DCHECK(rule);
+  rule->AddToIndex(rules_.size(), &index_);
   rules_.push_back(std::move(rule));
 }
 
@@ -54,6 +59,7 @@ void SchemeHostPortMatcher::ReplaceRule(
     std::unique_ptr<SchemeHostPortMatcherRule> rule) {
   DCHECK_LT(index, rules_.size());
   rules_[index] = std::move(rule);
+  RebuildIndex();
 }
 
 bool SchemeHostPortMatcher::Includes(const GURL& url) const {
@@ -71,8 +77,13 @@ SchemeHostPortMatcherResult SchemeHostPortMatcher::Evaluate(
   //
   // However when mixing positive and negative rules, evaluation order makes a
   // difference.
-  for (auto it = rules_.rbegin(); it != rules_.rend(); ++it) {
-    SchemeHostPortMatcherResult result = (*it)->Evaluate(url);
+  //
+  // The other rules can't match the host of |url|.
+  std::vector<size_t> candidates;
+  index_.FindCandidates(url.host_piece(), &candidates);
+  std::sort(candidates.begin(), candidates.end(), std::greater<>());
+  for (size_t index : candidates) {
+    SchemeHostPortMatcherResult result = rules_[index]->Evaluate(url);
     if (result != SchemeHostPortMatcherResult::kNoMatch)
       return result;
   }
@@ -92,6 +103,13 @@ std::string SchemeHostPortMatcher::ToString() const {
 
 void SchemeHostPortMatcher::Clear() {
   rules_.clear();
+  index_.Clear();
+}
+
+void SchemeHostPortMatcher::RebuildIndex() {
+  index_.Clear();
+  for (size_t i = 0; i < rules_.size(); ++i)
+    rules_[i]->AddToIndex(i, &index_);
 }
 
 }  // namespace net
@@ -8,6 +8,7 @@
 #include <string>
 #include <vector>
 
+#include "net/base/host_pattern_index.h"
 #include "net/base/net_export.h"
 #include "net/base/scheme_host_port_matcher_rule.h"
 
@@ -22,6 +23,10 @@ namespace net {
 // In a simple configuration, all rules are "include this URL" so evaluation
 // order doesn't matter. When combining include and exclude rules,
 // later rules will have precedence over earlier rules.
+//
+// The rules are indexed by the hosts they can match, so that evaluating a URL
+// only evaluates the rules that may match its host, and the rules that can't
+// be indexed, such as patterns with wildcards in the middle.
 class NET_EXPORT SchemeHostPortMatcher {
  public:
   using RuleList = std::vector<std::unique_ptr<SchemeHostPortMatcherRule>>;
@@ -48,7 +53,8 @@ class NET_EXPORT SchemeHostPortMatcher {
   // Returns the current list of rules.
   const RuleList& rules() const { return rules_; }
 
-  // Add rule to the matcher as the first one in the rule list.
+  // Add rule to the matcher as the first one in the rule list. This reindexes
+  // all the rules, so prefer AddAsLastRule() for building long lists.
   void AddAsFirstRule(std::unique_ptr<SchemeHostPortMatcherRule> rule);
 
   // Add rule to the matcher as the last one in the rule list.
@@ -75,7 +81,12 @@ class NET_EXPORT SchemeHostPortMatcher {
   void Clear();
 
  private:
+  void RebuildIndex();
+
   RuleList rules_;
+
+  // The rules by their position in |rules_|.
+  HostPatternIndex index_;
 };
 
 }  // namespace net
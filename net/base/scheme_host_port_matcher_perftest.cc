@@ -0,0 +1,149 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/base/scheme_host_port_matcher.h"
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "base/strings/stringprintf.h"
+#include "base/timer/elapsed_timer.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+#include "url/gurl.h"
+
+// This file compares evaluating URLs against proxy bypass lists of different
+// sizes with the indexed SchemeHostPortMatcher and by evaluating all of the
+// rules in turn, as the matcher used to. The lists are mostly exact hosts and
+// "*." suffixes, with some IP blocks and a few true globs, like the bypass
+// lists of enterprise policies.
+
+namespace net {
+
+namespace {
+
+constexpr char kMetricPrefixMatcher[] = "SchemeHostPortMatcher.";
+constexpr char kMetricEvaluationsPerSecond[] = "evaluations_per_second";
+
+constexpr size_t kNumUrls = 100000;
+// Caps the rule evaluations of the linear runs, which would otherwise take
+// minutes with the largest list.
+constexpr size_t kMaxLinearEvaluations = 100000000;
+
+perf_test::PerfResultReporter SetUpReporter(const std::string& story_name) {
+  perf_test::PerfResultReporter reporter(kMetricPrefixMatcher, story_name);
+  reporter.RegisterImportantMetric(kMetricEvaluationsPerSecond, "runs/s");
+  return reporter;
+}
+
+std::string GetRule(size_t i) {
+  switch (i % 10) {
+    case 0:
+      return base::StringPrintf("10.%zu.%zu.0/24", (i >> 8) & 0xff, i & 0xff);
+    case 1:
+      return base::StringPrintf("*.corp%zu.example", i);
+    case 2:
+      return base::StringPrintf("https://site%zu.example:443", i);
+    default:
+      return base::StringPrintf("site%zu.example", i);
+  }
+}
+
+SchemeHostPortMatcher CreateMatcher(size_t num_rules) {
+  SchemeHostPortMatcher matcher;
+  // A couple of globs, which can't be indexed.
+  matcher.AddAsLastRule(
+      SchemeHostPortMatcherRule::FromUntrimmedRawString("*intranet*"));
+  matcher.AddAsLastRule(
+      SchemeHostPortMatcherRule::FromUntrimmedRawString("<-loopback>"));
+  for (size_t i = 0; i < num_rules; ++i) {
+    matcher.AddAsLastRule(
+        SchemeHostPortMatcherRule::FromUntrimmedRawString(GetRule(i)));
+  }
+  return matcher;
+}
+
+// Returns |num_urls| URLs, about half of which match a rule.
+std::vector<GURL> GenerateUrls(size_t num_rules, size_t num_urls) {
+  std::minstd_rand generator(42);
+  std::vector<GURL> urls;
+  urls.reserve(num_urls);
+  for (size_t i = 0; i < num_urls; ++i) {
+    const size_t site = generator() % (2 * num_rules);
+    switch (generator() % 3) {
+      case 0:
+        urls.emplace_back(base::StringPrintf(
+            "http://10.%zu.%zu.1/", (site >> 8) & 0xff, site & 0xff));
+        break;
+      case 1:
+        urls.emplace_back(
+            base::StringPrintf("https://www.corp%zu.example/", site));
+        break;
+      default:
+        urls.emplace_back(base::StringPrintf("https://site%zu.example/", site));
+        break;
+    }
+  }
+  return urls;
+}
+
+SchemeHostPortMatcherResult EvaluateLinearly(
+    const SchemeHostPortMatcher& matcher,
+    const GURL& url) {
+  for (auto it = matcher.rules().rbegin(); it != matcher.rules().rend();
+       ++it) {
+    SchemeHostPortMatcherResult result = (*it)->Evaluate(url);
+    if (result != SchemeHostPortMatcherResult::kNoMatch)
+      return result;
+  }
+  return SchemeHostPortMatcherResult::kNoMatch;
+}
+
+template <typename Evaluate>
+void RunTest(const std::string& story_name,
+             size_t num_rules,
+             size_t num_urls,
+             Evaluate evaluate) {
+  const SchemeHostPortMatcher matcher = CreateMatcher(num_rules);
+  const std::vector<GURL> urls = GenerateUrls(num_rules, num_urls);
+  size_t num_included = 0;
+  base::ElapsedTimer timer;
+  for (const GURL& url : urls) {
+    num_included +=
+        evaluate(matcher, url) == SchemeHostPortMatcherResult::kInclude;
+  }
+  const base::TimeDelta elapsed = timer.Elapsed();
+  // Keeps the evaluations from being optimized away.
+  EXPECT_NE(0u, num_included);
+
+  auto reporter = SetUpReporter(
+      base::StringPrintf("%s_%zu_rules", story_name.c_str(), num_rules));
+  reporter.AddResult(kMetricEvaluationsPerSecond,
+                     urls.size() / elapsed.InSecondsF());
+}
+
+TEST(SchemeHostPortMatcherPerfTest, Indexed) {
+  for (size_t num_rules : {10, 1000, 100000}) {
+    RunTest("Indexed", num_rules, kNumUrls,
+            [](const SchemeHostPortMatcher& matcher, const GURL& url) {
+              return matcher.Evaluate(url);
+            });
+  }
+}
+
+TEST(SchemeHostPortMatcherPerfTest, Linear) {
+  for (size_t num_rules : {10, 1000, 100000}) {
+    RunTest("Linear", num_rules,
+            std::min(kNumUrls, kMaxLinearEvaluations / num_rules),
+            EvaluateLinearly);
+  }
+}
+
+}  // namespace
+
+}  // namespace net
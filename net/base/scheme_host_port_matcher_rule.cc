@@ -8,6 +8,7 @@
 #include "base/strings/strcat.h"
 #include "base/strings/string_util.h"
 #include "base/strings/stringprintf.h"
+#include "net/base/host_pattern_index.h"
 #include "net/base/host_port_pair.h"
 #include "net/base/parse_number.h"
 #include "net/base/url_util.h"
@@ -103,6 +104,11 @@ bool SchemeHostPortMatcherRule::IsHostnamePatternRule() const {
   return false;
 }
 
+void SchemeHostPortMatcherRule::AddToIndex(size_t id,
+                                           HostPatternIndex* index) const {
+  index->AddUnindexed(id);
+}
+
 SchemeHostPortMatcherHostnamePatternRule::
     SchemeHostPortMatcherHostnamePatternRule(
         const std::string& optional_scheme,
@@ -148,6 +154,12 @@ bool SchemeHostPortMatcherHostnamePatternRule::IsHostnamePatternRule() const {
   return true;
 }
 
+void SchemeHostPortMatcherHostnamePatternRule::AddToIndex(
+    size_t id,
+    HostPatternIndex* index) const {
+  index->AddHostPattern(hostname_pattern_, id);
+}
+
 std::unique_ptr<SchemeHostPortMatcherHostnamePatternRule>
 SchemeHostPortMatcherHostnamePatternRule::GenerateSuffixMatchingRule() const {
   if (!base::StartsWith(hostname_pattern_, "*", base::CompareCase::SENSITIVE)) {
@@ -195,6 +207,12 @@ std::string SchemeHostPortMatcherIPHostRule::ToString() const {
   return str;
 }
 
+void SchemeHostPortMatcherIPHostRule::AddToIndex(
+    size_t id,
+    HostPatternIndex* index) const {
+  index->AddHostPattern(ip_host_, id);
+}
+
 SchemeHostPortMatcherIPBlockRule::SchemeHostPortMatcherIPBlockRule(
     const std::string& description,
     const std::string& optional_scheme,
@@ -230,4 +248,10 @@ std::string SchemeHostPortMatcherIPBlockRule::ToString() const {
   return description_;
 }
 
+void SchemeHostPortMatcherIPBlockRule::AddToIndex(
+    size_t id,
+    HostPatternIndex* index) const {
+  index->AddIPBlock(ip_prefix_, prefix_length_in_bits_, id);
+}
+
 }  // namespace net
@@ -17,6 +17,8 @@
 
 namespace net {
 
+class HostPatternIndex;
+
 // Interface for an individual SchemeHostPortMatcher rule.
 class NET_EXPORT SchemeHostPortMatcherRule {
  public:
@@ -42,6 +44,9 @@ class NET_EXPORT SchemeHostPortMatcherRule {
   // Returns true if |this| is an instance of
   // SchemeHostPortMatcherHostnamePatternRule.
   virtual bool IsHostnamePatternRule() const;
+  // Adds the rule to |index| as |id|, with the hosts it can match. By
+  // default, rules are unindexed, and evaluated against every URL.
+  virtual void AddToIndex(size_t id, HostPatternIndex* index) const;
 };
 
 // Rule that matches URLs with wildcard hostname patterns, and
@@ -66,6 +71,7 @@ class NET_EXPORT SchemeHostPortMatcherHostnamePatternRule
   SchemeHostPortMatcherResult Evaluate(const GURL& url) const override;
   std::string ToString() const override;
   bool IsHostnamePatternRule() const override;
+  void AddToIndex(size_t id, HostPatternIndex* index) const override;
 
   // Generates a new SchemeHostPortMatcherHostnamePatternRule based on the
   // current rule. The new rule will do suffix matching if the current rule
@@ -103,6 +109,7 @@ class NET_EXPORT SchemeHostPortMatcherIPHostRule
   // SchemeHostPortMatcherRule implementation:
   SchemeHostPortMatcherResult Evaluate(const GURL& url) const override;
   std::string ToString() const override;
+  void AddToIndex(size_t id, HostPatternIndex* index) const override;
 
  private:
   const std::string optional_scheme_;
@@ -133,6 +140,7 @@ class NET_EXPORT SchemeHostPortMatcherIPBlockRule
   // SchemeHostPortMatcherRule implementation:
   SchemeHostPortMatcherResult Evaluate(const GURL& url) const override;
   std::string ToString() const override;
+  void AddToIndex(size_t id, HostPatternIndex* index) const override;
 
  private:
   const std::string description_;
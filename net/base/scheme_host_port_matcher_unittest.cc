@@ -4,6 +4,10 @@
 
 #include "net/base/scheme_host_port_matcher.h"
 
+#include <memory>
+#include <string>
+
+#include "base/strings/string_number_conversions.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 namespace net {
@@ -63,6 +67,97 @@ TEST(SchemeHostPortMatcherTest, DoesNotMimicProxyBypassRules) {
             matcher.Evaluate(GURL("http://169.254.1.1")));
 }
 
+// Excludes the URLs with the given host. It isn't indexed, so is evaluated
+// against every URL.
+class ExcludeHostRule : public SchemeHostPortMatcherRule {
+ public:
+  explicit ExcludeHostRule(const std::string& host) : host_(host) {}
+
+  SchemeHostPortMatcherResult Evaluate(const GURL& url) const override {
+    return url.host() == host_ ? SchemeHostPortMatcherResult::kExclude
+                               : SchemeHostPortMatcherResult::kNoMatch;
+  }
+  std::string ToString() const override { return "-" + host_; }
+
+ private:
+  const std::string host_;
+};
+
+// The later of the matching rules wins, whether it's indexed or not.
+TEST(SchemeHostPortMatcherTest, EvaluationOrder) {
+  SchemeHostPortMatcher matcher = SchemeHostPortMatcher::FromRawString(
+      "*.example.com, 10.0.0.0/8, *example*, www.example.com:443");
+  matcher.AddAsLastRule(std::make_unique<ExcludeHostRule>("www.example.com"));
+  matcher.AddAsLastRule(std::make_unique<ExcludeHostRule>("10.1.1.1"));
+  matcher.AddAsLastRule(
+      SchemeHostPortMatcherRule::FromUntrimmedRawString("10.1.1.1"));
+
+  EXPECT_EQ(SchemeHostPortMatcherResult::kExclude,
+            matcher.Evaluate(GURL("https://www.example.com")));
+  EXPECT_EQ(SchemeHostPortMatcherResult::kInclude,
+            matcher.Evaluate(GURL("https://a.example.com")));
+  EXPECT_EQ(SchemeHostPortMatcherResult::kInclude,
+            matcher.Evaluate(GURL("https://myexample.org")));
+  EXPECT_EQ(SchemeHostPortMatcherResult::kInclude,
+            matcher.Evaluate(GURL("http://10.1.1.1")));
+  EXPECT_EQ(SchemeHostPortMatcherResult::kInclude,
+            matcher.Evaluate(GURL("http://10.2.2.2")));
+  EXPECT_EQ(SchemeHostPortMatcherResult::kNoMatch,
+            matcher.Evaluate(GURL("http://11.1.1.1")));
+  EXPECT_EQ(SchemeHostPortMatcherResult::kNoMatch,
+            matcher.Evaluate(GURL("https://www.google.com")));
+
+  // Adding a rule in front, or replacing one, reindexes the rules.
+  matcher.AddAsFirstRule(
+      SchemeHostPortMatcherRule::FromUntrimmedRawString("www.google.com"));
+  EXPECT_EQ(SchemeHostPortMatcherResult::kInclude,
+            matcher.Evaluate(GURL("https://www.google.com")));
+  EXPECT_EQ(SchemeHostPortMatcherResult::kExclude,
+            matcher.Evaluate(GURL("https://www.example.com")));
+  matcher.ReplaceRule(matcher.rules().size() - 1,
+                      std::make_unique<ExcludeHostRule>("www.google.com"));
+  EXPECT_EQ(SchemeHostPortMatcherResult::kExclude,
+            matcher.Evaluate(GURL("https://www.google.com")));
+  EXPECT_EQ(SchemeHostPortMatcherResult::kExclude,
+            matcher.Evaluate(GURL("http://10.1.1.1")));
+
+  matcher.Clear();
+  EXPECT_EQ(SchemeHostPortMatcherResult::kNoMatch,
+            matcher.Evaluate(GURL("https://www.example.com")));
+}
+
+// Checks that the index doesn't change the result against the rules
+// evaluated one by one, with more rules.
+TEST(SchemeHostPortMatcherTest, ManyRules) {
+  SchemeHostPortMatcher matcher;
+  for (int i = 0; i < 1000; ++i) {
+    const std::string n = base::NumberToString(i);
+    matcher.AddAsLastRule(SchemeHostPortMatcherRule::FromUntrimmedRawString(
+        i % 2 ? "*.site" + n + ".com" : "https://site" + n + ".com:443"));
+  }
+  matcher.AddAsLastRule(std::make_unique<ExcludeHostRule>("a.site1.com"));
+
+  const char* const kUrls[] = {
+      "https://site0.com",    "http://site0.com",     "https://a.site1.com",
+      "https://b.site1.com",  "https://site1.com",    "https://x.y.site999.com",
+      "https://site1000.com", "https://a.site2.com",
+  };
+  for (const char* url_string : kUrls) {
+    const GURL url(url_string);
+    SchemeHostPortMatcherResult expected =
+        SchemeHostPortMatcherResult::kNoMatch;
+    for (auto it = matcher.rules().rbegin(); it != matcher.rules().rend();
+         ++it) {
+      expected = (*it)->Evaluate(url);
+      if (expected != SchemeHostPortMatcherResult::kNoMatch)
+        break;
+    }
+    EXPECT_EQ(expected, matcher.Evaluate(url)) << url_string;
+  }
+  EXPECT_TRUE(matcher.Includes(GURL("https://b.site1.com")));
+  EXPECT_FALSE(matcher.Includes(GURL("https://a.site1.com")));
+}
+
 }  // namespace
 
 }  // namespace net
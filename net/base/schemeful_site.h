@@ -114,6 +114,10 @@ class NET_EXPORT SchemefulSite {
   // returns an empty GURL.
   GURL GetURL() const;
 
+  // Interns the scheme and host of the site, for sites that are kept around
+  // and copied or compared a lot. See SchemeHostPort::InternStrings().
+  void InternStrings() { site_as_origin_.InternStrings(); }
+
   bool opaque() const { return site_as_origin_.opaque(); }
 
   bool has_registrable_domain_or_host() const {
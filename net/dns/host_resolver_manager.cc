@@ -24,6 +24,7 @@
 #include "base/containers/linked_list.h"
 #include "base/debug/debugger.h"
 #include "base/feature_list.h"
+#include "base/hash/hash.h"
 #include "base/logging.h"
 #include "base/memory/ptr_util.h"
 #include "base/memory/raw_ptr.h"
@@ -483,6 +484,50 @@ PrioritizedDispatcher::Limits GetDispatcherLimits(
   return limits;
 }
 
+PrioritizedDispatcher::Policy GetDispatcherPolicy() {
+  PrioritizedDispatcher::Policy policy;
+  if (!base::FeatureList::IsEnabled(features::kHostResolverFairShareDispatch))
+    return policy;
+
+  policy.max_queue_delay =
+      features::kHostResolverFairShareDispatchMaxQueueDelay.Get();
+  policy.share_among_groups =
+      features::kHostResolverFairShareDispatchByNetworkIsolationKey.Get();
+
+  // The weights are in the same format as the limits of the field trial
+  // above, from the lowest priority to the highest. Invalid weights fall back
+  // to the strict priority order.
+  std::vector<base::StringPiece> weight_parts = base::SplitStringPiece(
+      features::kHostResolverFairShareDispatchWeights.Get(), ":",
+      base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY);
+  if (weight_parts.size() != NUM_PRIORITIES)
+    return policy;
+  std::vector<uint32_t> weights;
+  for (base::StringPiece weight_part : weight_parts) {
+    unsigned weight;
+    if (!base::StringToUint(weight_part, &weight) || weight == 0 ||
+        weight > PrioritizedDispatcher::kMaxWeight) {
+      return policy;
+    }
+    weights.push_back(weight);
+  }
+  policy.weights = std::move(weights);
+  return policy;
+}
+
+// Returns the group of a job for the policy of GetDispatcherPolicy(). Only
+// hashes |network_isolation_key| when the policy shares the dispatcher among
+// groups.
+uint64_t GetDispatcherFairShareGroup(
+    const NetworkIsolationKey& network_isolation_key) {
+  if (!base::FeatureList::IsEnabled(
+          features::kHostResolverFairShareDispatch) ||
+      !features::kHostResolverFairShareDispatchByNetworkIsolationKey.Get()) {
+    return 0;
+  }
+  return base::FastHash(network_isolation_key.ToDebugString());
+}
+
 // Keeps track of the highest priority.
 class PriorityTracker {
  public:
@@ -2019,6 +2064,8 @@ class HostResolverManager::Job : public PrioritizedDispatcher::Job,
         had_non_speculative_request_(false),
         num_occupied_job_slots_(0),
         dispatched_(false),
+        fair_share_group_(
+            GetDispatcherFairShareGroup(key_.network_isolation_key)),
         dns_task_error_(OK),
         tick_clock_(tick_clock),
         net_log_(
@@ -2268,6 +2315,7 @@ class HostResolverManager::Job : public PrioritizedDispatcher::Job,
          next_task == TaskType::MDNS)) {
       dispatched_ = true;
       job_running_ = false;
+      dispatch_time_ = tick_clock_->NowTicks();
       Schedule(false);
       DCHECK(is_running() || is_queued());
 
@@ -2411,10 +2459,16 @@ class HostResolverManager::Job : public PrioritizedDispatcher::Job,
 
     DCHECK(!is_running());
     DCHECK(!tasks_.empty());
+    base::UmaHistogramLongTimes100(
+        base::StrCat({"Net.DNS.JobQueueTime.Dispatcher.",
+                      RequestPriorityToString(priority())}),
+        tick_clock_->NowTicks() - dispatch_time_);
     RunNextTask();
     // Caution: Job::Start must not complete synchronously.
   }
 
+  uint64_t GetFairShareGroup() const override { return fair_share_group_; }
+
   // TODO(szym): Since DnsTransaction does not consume threads, we can increase
   // the limits on |dispatcher_|. But in order to keep the number of
   // ThreadPool threads low, we will need to use an "inner"
@@ -2880,6 +2934,13 @@ class HostResolverManager::Job : public PrioritizedDispatcher::Job,
   // True once this Job has been sent to `resolver_->dispatcher_`.
   bool dispatched_;
 
+  // The group of the Job in `resolver_->dispatcher_`, so that the jobs of
+  // different NetworkIsolationKeys take turns.
+  const uint64_t fair_share_group_;
+
+  // When this Job was sent to `resolver_->dispatcher_`.
+  base::TimeTicks dispatch_time_;
+
   // Result of DnsTask.
   int dns_task_error_;
 
@@ -2928,7 +2989,8 @@ HostResolverManager::HostResolverManager(
       tick_clock_(base::DefaultTickClock::GetInstance()),
       invalidation_in_progress_(false) {
   PrioritizedDispatcher::Limits job_limits = GetDispatcherLimits(options);
-  dispatcher_ = std::make_unique<PrioritizedDispatcher>(job_limits);
+  dispatcher_ = std::make_unique<PrioritizedDispatcher>(job_limits,
+                                                        GetDispatcherPolicy());
   max_queued_jobs_ = job_limits.total_jobs * 100u;
 
   DCHECK_GE(dispatcher_->num_priorities(), static_cast<size_t>(NUM_PRIORITIES));
@@ -3117,6 +3179,7 @@ void HostResolverManager::DeregisterResolveContext(
 void HostResolverManager::SetTickClockForTesting(
     const base::TickClock* tick_clock) {
   tick_clock_ = tick_clock;
+  dispatcher_->SetTickClockForTesting(tick_clock);
 }
 
 void HostResolverManager::SetMaxQueuedJobsForTesting(size_t value) {
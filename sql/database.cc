@@ -152,6 +152,15 @@ int GetSqlite3FileAndSize(sqlite3* db,
   return (*file)->pMethods->xFileSize(*file, db_size);
 }
 
+// The adaptive page cache is checked every this many statement executions...
+constexpr int kStatementsPerCacheCheck = 32;
+
+// ...once they have accessed enough pages for the hit rate to be meaningful.
+constexpr int kMinPageAccessesPerCacheCheck = 256;
+
+// The adaptive page cache grows while its hit rate is lower than this.
+constexpr double kMinCacheHitRate = 0.9;
+
 std::string AsUTF8ForSQL(const base::FilePath& path) {
 #if defined(OS_WIN)
   return base::WideToUTF8(path.value());
@@ -251,6 +260,9 @@ Database::Database() : Database({.exclusive_locking = false}) {}
 
 Database::Database(DatabaseOptions options)
     : options_(options), mmap_disabled_(!enable_mmap_by_default_) {
+  if (options_.profile_statements)
+    statement_stats_ = base::MakeRefCounted<StatementStatsRegistry>();
+  DCHECK_GE(options.adaptive_cache_budget_bytes, 0);
   DCHECK_GE(options.page_size, 512);
   DCHECK_LE(options.page_size, 65536);
   DCHECK(!(options.page_size & (options.page_size - 1)))
@@ -333,6 +345,7 @@ void Database::CloseInternal(bool forced) {
       DLOG(DCHECK) << "sqlite3_close failed: " << GetErrorMessage();
   }
   db_ = nullptr;
+  adaptive_cache_max_pages_ = 0;
 }
 
 void Database::Close() {
@@ -1293,10 +1306,19 @@ scoped_refptr<Database::StatementRef> Database::GetCachedStatement(
     statement_cache_[id] = statement;  // Only cache valid statements.
     DCHECK_EQ(std::string(sqlite3_sql(statement->stmt())), std::string(sql))
         << "Input SQL does not match SQLite's normalized version";
+    if (statement_stats_)
+      statement->set_stats(statement_stats_->GetStats(id));
   }
   return statement;
 }
 
+std::vector<std::pair<StatementID, StatementStats>>
+Database::GetStatementStats() const {
+  if (!statement_stats_)
+    return {};
+  return statement_stats_->GetSnapshot();
+}
+
 scoped_refptr<Database::StatementRef> Database::GetUniqueStatement(
     const char* sql) {
   return GetStatementImpl(sql);
@@ -1677,6 +1699,32 @@ bool Database::OpenInternal(const std::string& file_name,
     ignore_result(ExecuteWithTimeout(cache_size_sql.c_str(), kBusyTimeout));
   }
 
+  if (options_.adaptive_cache_budget_bytes) {
+    // The page size of an existing database may differ from the one in
+    // `options_`, and a negative cache size is in KiB rather than in pages.
+    int page_size = options_.page_size;
+    int cache_size = 0;
+    {
+      Statement s(GetUniqueStatement("PRAGMA page_size"));
+      if (s.Step() && s.ColumnInt(0) > 0)
+        page_size = s.ColumnInt(0);
+    }
+    {
+      Statement s(GetUniqueStatement("PRAGMA cache_size"));
+      if (s.Step())
+        cache_size = s.ColumnInt(0);
+    }
+    adaptive_cache_pages_ =
+        cache_size >= 0
+            ? cache_size
+            : static_cast<int>(-int64_t{cache_size} * 1024 / page_size);
+    adaptive_cache_max_pages_ =
+        std::max(adaptive_cache_pages_,
+                 options_.adaptive_cache_budget_bytes / page_size);
+    statements_since_cache_check_ = 0;
+    GetCacheCounters(&cache_hits_at_last_check_, &cache_misses_at_last_check_);
+  }
+
   static_assert(SQLITE_SECURE_DELETE == 1,
                 "Chrome assumes secure_delete is on by default.");
 
@@ -1701,8 +1749,24 @@ bool Database::OpenInternal(const std::string& file_name,
   // can be built to default-enable mmap.  GetAppropriateMmapSize() calculates a
   // safe range to memory-map based on past regular I/O.  This value will be
   // capped by SQLITE_MAX_MMAP_SIZE, which could be different between 32-bit and
-  // 64-bit platforms.
-  size_t mmap_size = mmap_disabled_ ? 0 : GetAppropriateMmapSize();
+  // 64-bit platforms.  With an adaptive page cache, memory-mapping is deferred
+  // until the cache is found to be too small.
+  size_t mmap_size =
+      mmap_disabled_ || options_.adaptive_cache_budget_bytes
+          ? 0
+          : GetAppropriateMmapSize();
+  SetMmapSize(mmap_size);
+
+  DCHECK(!memory_dump_provider_);
+  memory_dump_provider_ = std::make_unique<DatabaseMemoryDumpProvider>(
+      db_, histogram_tag_, statement_stats_);
+  base::trace_event::MemoryDumpManager::GetInstance()->RegisterDumpProvider(
+      memory_dump_provider_.get(), "sql::Database", nullptr);
+
+  return true;
+}
+
+void Database::SetMmapSize(size_t mmap_size) {
   std::string mmap_sql =
       base::StringPrintf("PRAGMA mmap_size=%" PRIuS, mmap_size);
   ignore_result(Execute(mmap_sql.c_str()));
@@ -1715,14 +1779,92 @@ bool Database::OpenInternal(const std::string& file_name,
     if (s.Step() && s.ColumnInt64(0) > 0)
       mmap_enabled_ = true;
   }
+}
 
-  DCHECK(!memory_dump_provider_);
-  memory_dump_provider_ =
-      std::make_unique<DatabaseMemoryDumpProvider>(db_, histogram_tag_);
-  base::trace_event::MemoryDumpManager::GetInstance()->RegisterDumpProvider(
-      memory_dump_provider_.get(), "sql::Database", nullptr);
+void Database::AdaptCacheSizeIfNeeded() {
+  // `adaptive_cache_max_pages_` is only set once OpenInternal() has read the
+  // initial cache size.
+  if (!options_.adaptive_cache_budget_bytes || !adaptive_cache_max_pages_ ||
+      !db_) {
+    return;
+  }
+  if (++statements_since_cache_check_ < kStatementsPerCacheCheck)
+    return;
+  statements_since_cache_check_ = 0;
+
+  int cache_hits;
+  int cache_misses;
+  GetCacheCounters(&cache_hits, &cache_misses);
+  // The counters may wrap around.
+  const uint32_t hits =
+      static_cast<uint32_t>(cache_hits) -
+      static_cast<uint32_t>(cache_hits_at_last_check_);
+  const uint32_t misses =
+      static_cast<uint32_t>(cache_misses) -
+      static_cast<uint32_t>(cache_misses_at_last_check_);
+  const uint64_t accesses = uint64_t{hits} + misses;
+  if (accesses < kMinPageAccessesPerCacheCheck)
+    return;
+  cache_hits_at_last_check_ = cache_hits;
+  cache_misses_at_last_check_ = cache_misses;
 
-  return true;
+  if (hits >= kMinCacheHitRate * accesses)
+    return;
+
+  if (adaptive_cache_pages_ < adaptive_cache_max_pages_) {
+    adaptive_cache_pages_ = static_cast<int>(std::min<int64_t>(
+        std::max(int64_t{adaptive_cache_pages_} * 2, int64_t{1}),
+        adaptive_cache_max_pages_));
+    TRACE_EVENT_INSTANT1("sql", "Database::AdaptCacheSize",
+                         TRACE_EVENT_SCOPE_THREAD, "cache_pages",
+                         adaptive_cache_pages_);
+    const std::string cache_size_sql =
+        base::StringPrintf("PRAGMA cache_size=%d", adaptive_cache_pages_);
+    ignore_result(Execute(cache_size_sql.c_str()));
+    return;
+  }
+
+  // The cache can't grow any more, so let reads that miss it be served from
+  // the OS page cache through the memory map instead.
+  // GetAppropriateMmapSize() may write to the meta table, which must not
+  // become part of the caller's transaction.
+  if (!mmap_enabled_ && !mmap_disabled_ && !transaction_nesting_) {
+    TRACE_EVENT0("sql", "Database::AdaptCacheSize::EnableMmap");
+    SetMmapSize(GetAppropriateMmapSize());
+  }
+}
+
+void Database::RecordStatementStep(StatementStats* stats,
+                                   bool returned_row,
+                                   base::TimeDelta step_time,
+                                   int cache_hits_before,
+                                   int cache_misses_before) {
+  DCHECK(statement_stats_);
+  int cache_hits;
+  int cache_misses;
+  GetCacheCounters(&cache_hits, &cache_misses);
+
+  StatementStats delta;
+  delta.steps = 1;
+  delta.rows = returned_row ? 1 : 0;
+  delta.step_time = step_time;
+  delta.cache_hits = static_cast<uint32_t>(cache_hits) -
+                     static_cast<uint32_t>(cache_hits_before);
+  delta.cache_misses = static_cast<uint32_t>(cache_misses) -
+                       static_cast<uint32_t>(cache_misses_before);
+  statement_stats_->Record(stats, delta);
+}
+
+void Database::GetCacheCounters(int* cache_hits, int* cache_misses) const {
+  *cache_hits = 0;
+  *cache_misses = 0;
+  if (!db_)
+    return;
+  int unused_highwater;
+  sqlite3_db_status(db_, SQLITE_DBSTATUS_CACHE_HIT, cache_hits,
+                    &unused_highwater, /*resetFlg=*/0);
+  sqlite3_db_status(db_, SQLITE_DBSTATUS_CACHE_MISS, cache_misses,
+                    &unused_highwater, /*resetFlg=*/0);
 }
 
 void Database::DoRollback() {
@@ -28,6 +28,7 @@
 #include "sql/internal_api_token.h"
 #include "sql/sql_features.h"
 #include "sql/statement_id.h"
+#include "sql/statement_stats.h"
 #include "third_party/abseil-cpp/absl/types/optional.h"
 
 struct sqlite3;
@@ -161,6 +162,24 @@ struct COMPONENT_EXPORT(SQL) DatabaseOptions {
   // If this option is false, CREATE VIRTUAL TABLE and DROP VIRTUAL TABLE
   // succeed, but statements targeting virtual tables fail.
   bool enable_virtual_tables_discouraged = false;
+
+  // If true, collects StatementStats for each cached statement. They can be
+  // read with Database::GetStatementStats(), and are included in detailed
+  // memory dumps.
+  //
+  // Profiling adds a few counter reads and a clock read around every step of a
+  // cached statement, so it is meant for diagnosing slow databases.
+  bool profile_statements = false;
+
+  // If non-zero, the page cache is sized adaptively, and can use up to this many
+  // bytes of RAM.
+  //
+  // The database starts with `cache_size` pages, and memory-mapped I/O off. The
+  // page cache hit rate is checked periodically; while it is low, the cache
+  // size is doubled, up to the budget. If the hit rate stays low with the cache
+  // at the budget, memory-mapped I/O is turned on, unless it was disabled with
+  // Database::set_mmap_disabled().
+  int adaptive_cache_budget_bytes = 0;
 };
 
 // Handle to an open SQLite database.
@@ -257,6 +276,12 @@ class COMPONENT_EXPORT(SQL) Database {
   bool ReportMemoryUsage(base::trace_event::ProcessMemoryDump* pmd,
                          const std::string& dump_name);
 
+  // Returns the counters collected for each cached statement, or nothing if
+  // DatabaseOptions::profile_statements is false. The counters are kept across
+  // Close() and Open() calls.
+  std::vector<std::pair<StatementID, StatementStats>> GetStatementStats()
+      const;
+
   // Initialization ------------------------------------------------------------
 
   // Initializes the SQL database for the given file, returning true if the
@@ -592,6 +617,7 @@ class COMPONENT_EXPORT(SQL) Database {
   // (they should go through Statement).
   friend class Statement;
 
+  FRIEND_TEST_ALL_PREFIXES(SQLDatabaseTest, AdaptiveCacheSize);
   FRIEND_TEST_ALL_PREFIXES(SQLDatabaseTest, CachedStatement);
   FRIEND_TEST_ALL_PREFIXES(SQLDatabaseTest, CollectDiagnosticInfo);
   FRIEND_TEST_ALL_PREFIXES(SQLDatabaseTest, GetAppropriateMmapSize);
@@ -673,6 +699,11 @@ class COMPONENT_EXPORT(SQL) Database {
     // this will return nullptr.
     sqlite3_stmt* stmt() const { return stmt_; }
 
+    // The counters to update when the statement is stepped, or null if the
+    // statement is not profiled.
+    StatementStats* stats() const { return stats_; }
+    void set_stats(StatementStats* stats) { stats_ = stats; }
+
     // Destroys the compiled statement and sets it to nullptr. The statement
     // will no longer be active. |forced| is used to indicate if
     // orderly-shutdown checks should apply (see Database::RazeAndClose()).
@@ -696,6 +727,7 @@ class COMPONENT_EXPORT(SQL) Database {
     raw_ptr<Database> database_;
     raw_ptr<sqlite3_stmt> stmt_;
     bool was_valid_;
+    raw_ptr<StatementStats> stats_ = nullptr;
   };
   friend class StatementRef;
 
@@ -743,6 +775,26 @@ class COMPONENT_EXPORT(SQL) Database {
   // which do not participate in the total-rows-changed tracking.
   void ReleaseCacheMemoryIfNeeded(bool implicit_change_performed);
 
+  // Called after each statement execution. Periodically grows the page cache or
+  // turns on memory-mapped I/O if the page cache hit rate is low. See
+  // DatabaseOptions::adaptive_cache_budget_bytes.
+  void AdaptCacheSizeIfNeeded();
+
+  // Runs "PRAGMA mmap_size" with `mmap_size`, and updates `mmap_enabled_`.
+  void SetMmapSize(size_t mmap_size);
+
+  // Records a step of a profiled statement. `cache_hits_before` and
+  // `cache_misses_before` are the results of GetCacheCounters() before the
+  // step.
+  void RecordStatementStep(StatementStats* stats,
+                           bool returned_row,
+                           base::TimeDelta step_time,
+                           int cache_hits_before,
+                           int cache_misses_before);
+
+  // Returns the page cache counters of the connection. They may wrap around.
+  void GetCacheCounters(int* cache_hits, int* cache_misses) const;
+
   // Returns the results of sqlite3_db_filename(), which should match the path
   // passed to Open().
   base::FilePath DbPath() const;
@@ -835,6 +887,19 @@ class COMPONENT_EXPORT(SQL) Database {
 
   // Stores the dump provider object when db is open.
   std::unique_ptr<DatabaseMemoryDumpProvider> memory_dump_provider_;
+
+  // Counters for the cached statements, if DatabaseOptions::profile_statements
+  // is set. Shared with `memory_dump_provider_`.
+  scoped_refptr<StatementStatsRegistry> statement_stats_;
+
+  // The state of the adaptive page cache, if
+  // DatabaseOptions::adaptive_cache_budget_bytes is set. The cache size is in
+  // pages, and the counters are those of GetCacheCounters() at the last check.
+  int adaptive_cache_pages_ = 0;
+  int adaptive_cache_max_pages_ = 0;
+  int statements_since_cache_check_ = 0;
+  int cache_hits_at_last_check_ = 0;
+  int cache_misses_at_last_check_ = 0;
 };
 
 }  // namespace sql
@@ -6,15 +6,23 @@
 
 #include <inttypes.h>
 
+#include <utility>
+
+#include "base/files/file_path.h"
 #include "base/strings/stringprintf.h"
 #include "base/trace_event/process_memory_dump.h"
+#include "sql/statement_stats.h"
 #include "third_party/sqlite/sqlite3.h"
 
 namespace sql {
 
-DatabaseMemoryDumpProvider::DatabaseMemoryDumpProvider(sqlite3* db,
-                                                       const std::string& name)
-    : db_(db), connection_name_(name) {}
+DatabaseMemoryDumpProvider::DatabaseMemoryDumpProvider(
+    sqlite3* db,
+    const std::string& name,
+    scoped_refptr<StatementStatsRegistry> statement_stats)
+    : db_(db),
+      connection_name_(name),
+      statement_stats_(std::move(statement_stats)) {}
 
 DatabaseMemoryDumpProvider::~DatabaseMemoryDumpProvider() = default;
 
@@ -50,6 +58,9 @@ bool DatabaseMemoryDumpProvider::OnMemoryDump(
   dump->AddScalar("statement_size",
                   base::trace_event::MemoryAllocatorDump::kUnitsBytes,
                   statement_size);
+
+  if (statement_stats_)
+    DumpStatementStats(pmd);
   return true;
 }
 
@@ -103,4 +114,36 @@ std::string DatabaseMemoryDumpProvider::FormatDumpName() const {
       reinterpret_cast<uintptr_t>(this));
 }
 
+void DatabaseMemoryDumpProvider::DumpStatementStats(
+    base::trace_event::ProcessMemoryDump* pmd) {
+  const std::string dump_name_prefix = FormatDumpName() + "/statements/";
+  for (const auto& entry : statement_stats_->GetSnapshot()) {
+    const StatementID& id = entry.first;
+    const StatementStats& stats = entry.second;
+    // Dump names use '/' as a separator, so only the base name of the source
+    // file is used.
+    const std::string file_name =
+        base::FilePath::FromUTF8Unsafe(id.source_file())
+            .BaseName()
+            .AsUTF8Unsafe();
+    base::trace_event::MemoryAllocatorDump* dump = pmd->CreateAllocatorDump(
+        base::StringPrintf("%s%s_%zu", dump_name_prefix.c_str(),
+                           file_name.c_str(), id.source_line()));
+    dump->AddScalar("steps",
+                    base::trace_event::MemoryAllocatorDump::kUnitsObjects,
+                    stats.steps);
+    dump->AddScalar("rows",
+                    base::trace_event::MemoryAllocatorDump::kUnitsObjects,
+                    stats.rows);
+    dump->AddScalar("step_time_us", "microseconds",
+                    stats.step_time.InMicroseconds());
+    dump->AddScalar("cache_hits",
+                    base::trace_event::MemoryAllocatorDump::kUnitsObjects,
+                    stats.cache_hits);
+    dump->AddScalar("cache_misses",
+                    base::trace_event::MemoryAllocatorDump::kUnitsObjects,
+                    stats.cache_misses);
+  }
+}
+
 }  // namespace sql
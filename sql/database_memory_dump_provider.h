@@ -8,6 +8,7 @@
 #include <string>
 
 #include "base/memory/raw_ptr.h"
+#include "base/memory/scoped_refptr.h"
 #include "base/synchronization/lock.h"
 #include "base/trace_event/memory_dump_provider.h"
 
@@ -21,10 +22,17 @@ class ProcessMemoryDump;
 
 namespace sql {
 
+class StatementStatsRegistry;
+
 class DatabaseMemoryDumpProvider
     : public base::trace_event::MemoryDumpProvider {
  public:
-  DatabaseMemoryDumpProvider(sqlite3* db, const std::string& name);
+  // |statement_stats| is null unless the database profiles its statements, in
+  // which case detailed dumps also report the counters of each statement.
+  DatabaseMemoryDumpProvider(
+      sqlite3* db,
+      const std::string& name,
+      scoped_refptr<StatementStatsRegistry> statement_stats);
 
   DatabaseMemoryDumpProvider(const DatabaseMemoryDumpProvider&) = delete;
   DatabaseMemoryDumpProvider& operator=(const DatabaseMemoryDumpProvider&) =
@@ -49,9 +57,12 @@ class DatabaseMemoryDumpProvider
 
   std::string FormatDumpName() const;
 
+  void DumpStatementStats(base::trace_event::ProcessMemoryDump* pmd);
+
   raw_ptr<sqlite3> db_;  // not owned.
   base::Lock lock_;
   std::string connection_name_;
+  const scoped_refptr<StatementStatsRegistry> statement_stats_;
 };
 
 }  // namespace sql
@@ -0,0 +1,252 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/command_line.h"
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_split.h"
+#include "base/strings/string_util.h"
+#include "base/strings/stringprintf.h"
+#include "base/time/time.h"
+#include "sql/database.h"
+#include "sql/statement.h"
+#include "sql/statement_stats.h"
+#include "sql/test/test_helpers.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+// This file replays a trace of SQL statements against an on-disk database,
+// with and without statement profiling and the adaptive page cache.
+//
+// A trace is a text file with one SQL statement per line. Empty lines and
+// lines starting with '#' are ignored. Each distinct statement is run as a
+// cached statement, and is stepped until it returns no more rows. Pass
+//   --sql-trace=<path>
+// to replay a recorded trace, and
+//   --sql-trace-database=<path>
+// to replay it against a copy of an existing database. Without a trace, a
+// synthetic workload resembling a cookie store is replayed.
+
+namespace sql {
+
+namespace {
+
+constexpr char kTraceSwitch[] = "sql-trace";
+constexpr char kTraceDatabaseSwitch[] = "sql-trace-database";
+
+constexpr char kMetricPrefixDatabase[] = "Database.";
+constexpr char kMetricTimePerStatement[] = "time_per_statement";
+constexpr char kMetricCacheHitRate[] = "cache_hit_rate";
+constexpr char kMetricCachePages[] = "cache_pages";
+
+// The source file of the StatementIDs of the replayed statements, whose source
+// lines are their indices in the trace.
+constexpr char kTraceSourceFile[] = "sql_trace";
+
+// The synthetic database and trace.
+constexpr int kNumHosts = 2000;
+constexpr int kCookiesPerHost = 10;
+constexpr int kNumTraceStatements = 20000;
+constexpr size_t kCookieValueSize = 200;
+
+// The configuration of the adaptive page cache. The initial cache is much
+// smaller than the synthetic database, and the budget is about as large.
+constexpr int kAdaptiveInitialCachePages = 64;
+constexpr int kAdaptiveBudgetBytes = 8 * 1024 * 1024;
+
+perf_test::PerfResultReporter SetUpReporter(const std::string& story_name) {
+  perf_test::PerfResultReporter reporter(kMetricPrefixDatabase, story_name);
+  reporter.RegisterImportantMetric(kMetricTimePerStatement, "us");
+  reporter.RegisterImportantMetric(kMetricCacheHitRate, "%");
+  reporter.RegisterImportantMetric(kMetricCachePages, "count");
+  return reporter;
+}
+
+std::string HostKey(int host) {
+  return base::StringPrintf("host%d.example.com", host);
+}
+
+bool PopulateSyntheticDatabase(Database* db) {
+  if (!db->Execute("CREATE TABLE cookies("
+                   "host_key TEXT NOT NULL,"
+                   "name TEXT NOT NULL,"
+                   "value TEXT NOT NULL,"
+                   "path TEXT NOT NULL,"
+                   "expires_utc INTEGER NOT NULL,"
+                   "last_access_utc INTEGER NOT NULL)") ||
+      !db->Execute("CREATE INDEX cookies_host_key ON cookies(host_key)") ||
+      !db->BeginTransaction()) {
+    return false;
+  }
+  Statement insert(db->GetUniqueStatement(
+      "INSERT INTO cookies VALUES (?, ?, ?, '/', ?, ?)"));
+  const std::string value(kCookieValueSize, 'v');
+  for (int host = 0; host < kNumHosts; ++host) {
+    for (int cookie = 0; cookie < kCookiesPerHost; ++cookie) {
+      insert.BindString(0, HostKey(host));
+      insert.BindString(1, base::StringPrintf("cookie%d", cookie));
+      insert.BindString(2, value);
+      insert.BindInt64(3, host + cookie);
+      insert.BindInt64(4, host);
+      if (!insert.Run())
+        return false;
+      insert.Reset(true);
+    }
+  }
+  return db->CommitTransaction();
+}
+
+// Returns a trace where most lookups go to a small set of hot hosts, with
+// some updates of their cookies in between, like a cookie store serving page
+// loads.
+std::vector<std::string> MakeSyntheticTrace() {
+  std::vector<std::string> trace;
+  uint32_t random = 1;
+  for (int i = 0; i < kNumTraceStatements; ++i) {
+    random = random * 1103515245 + 12345;
+    const uint32_t r = random >> 8;
+    // 80% of the statements touch 10% of the hosts.
+    const int host = (r % 10 < 8) ? (r / 10) % (kNumHosts / 10)
+                                  : (r / 10) % kNumHosts;
+    if (r % 16 == 0) {
+      trace.push_back(base::StringPrintf(
+          "UPDATE cookies SET last_access_utc=%d WHERE host_key='%s'", i,
+          HostKey(host).c_str()));
+    } else {
+      trace.push_back(base::StringPrintf(
+          "SELECT name, value, path, expires_utc FROM cookies "
+          "WHERE host_key='%s'",
+          HostKey(host).c_str()));
+    }
+  }
+  return trace;
+}
+
+std::vector<std::string> ParseTrace(const std::string& contents) {
+  std::vector<std::string> trace;
+  for (const std::string& line :
+       base::SplitString(contents, "\n", base::TRIM_WHITESPACE,
+                         base::SPLIT_WANT_NONEMPTY)) {
+    if (!base::StartsWith(line, "#"))
+      trace.push_back(line);
+  }
+  return trace;
+}
+
+class DatabasePerfTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    db_path_ = temp_dir_.GetPath().AppendASCII("database_perftest.sqlite");
+
+    const base::CommandLine& command_line =
+        *base::CommandLine::ForCurrentProcess();
+    if (command_line.HasSwitch(kTraceSwitch)) {
+      std::string contents;
+      ASSERT_TRUE(base::ReadFileToString(
+          command_line.GetSwitchValuePath(kTraceSwitch), &contents));
+      trace_ = ParseTrace(contents);
+      if (command_line.HasSwitch(kTraceDatabaseSwitch)) {
+        ASSERT_TRUE(base::CopyFile(
+            command_line.GetSwitchValuePath(kTraceDatabaseSwitch), db_path_));
+      }
+      return;
+    }
+
+    trace_ = MakeSyntheticTrace();
+    Database db;
+    ASSERT_TRUE(db.Open(db_path_));
+    ASSERT_TRUE(PopulateSyntheticDatabase(&db));
+  }
+
+  // Replays the trace against a fresh connection opened with |options|.
+  void RunReplayTest(const char* story_name, const DatabaseOptions& options) {
+    Database db(options);
+    ASSERT_TRUE(db.Open(db_path_));
+
+    // Assigns the statements their IDs up front, so that the lookups don't
+    // count towards the replay time.
+    std::map<std::string, size_t> statement_indices;
+    std::vector<size_t> trace_indices;
+    for (const std::string& sql : trace_) {
+      trace_indices.push_back(
+          statement_indices.emplace(sql, statement_indices.size())
+              .first->second);
+    }
+
+    const base::TimeTicks start = base::TimeTicks::Now();
+    for (size_t i = 0; i < trace_.size(); ++i) {
+      Statement statement(db.GetCachedStatement(
+          StatementID(kTraceSourceFile, trace_indices[i]), trace_[i].c_str()));
+      ASSERT_TRUE(statement.is_valid()) << trace_[i];
+      while (statement.Step()) {
+      }
+      ASSERT_TRUE(statement.Succeeded()) << trace_[i];
+    }
+    const base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+
+    auto reporter = SetUpReporter(story_name);
+    reporter.AddResult(kMetricTimePerStatement,
+                       elapsed.InMicrosecondsF() / trace_.size());
+
+    if (options.profile_statements) {
+      int64_t cache_hits = 0;
+      int64_t cache_misses = 0;
+      for (const auto& entry : db.GetStatementStats()) {
+        cache_hits += entry.second.cache_hits;
+        cache_misses += entry.second.cache_misses;
+      }
+      if (cache_hits + cache_misses) {
+        reporter.AddResult(kMetricCacheHitRate,
+                           100.0 * cache_hits / (cache_hits + cache_misses));
+      }
+    }
+
+    int cache_pages = 0;
+    ASSERT_TRUE(base::StringToInt(
+        test::ExecuteWithResult(&db, "PRAGMA cache_size"), &cache_pages));
+    // A negative cache size is in KiB.
+    if (cache_pages < 0)
+      cache_pages = -cache_pages * 1024 / options.page_size;
+    reporter.AddResult(kMetricCachePages, static_cast<size_t>(cache_pages));
+  }
+
+  base::ScopedTempDir temp_dir_;
+  base::FilePath db_path_;
+  std::vector<std::string> trace_;
+};
+
+TEST_F(DatabasePerfTest, ReplayDefault) {
+  RunReplayTest("ReplayDefault", DatabaseOptions());
+}
+
+// The difference to ReplayDefault is the cost of profiling.
+TEST_F(DatabasePerfTest, ReplayProfiled) {
+  DatabaseOptions options;
+  options.profile_statements = true;
+  RunReplayTest("ReplayProfiled", options);
+}
+
+// Also profiled, so that the hit rate can be compared to ReplayProfiled.
+TEST_F(DatabasePerfTest, ReplayAdaptive) {
+  DatabaseOptions options;
+  options.profile_statements = true;
+  options.cache_size = kAdaptiveInitialCachePages;
+  options.adaptive_cache_budget_bytes = kAdaptiveBudgetBytes;
+  RunReplayTest("ReplayAdaptive", options);
+}
+
+}  // namespace
+
+}  // namespace sql
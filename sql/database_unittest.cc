@@ -7,6 +7,10 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "base/bind.h"
 #include "base/files/file_util.h"
@@ -1759,6 +1763,102 @@ TEST_P(SQLDatabaseTest, CheckpointDatabase) {
             "2");
 }
 
+TEST_P(SQLDatabaseTest, StatementStats) {
+  EXPECT_TRUE(db_->GetStatementStats().empty());
+
+  DatabaseOptions options = GetDBOptions();
+  options.profile_statements = true;
+  db_ = std::make_unique<Database>(options);
+  ASSERT_TRUE(db_->Open(db_path_));
+  ASSERT_TRUE(db_->Execute("CREATE TABLE foo (a, b)"));
+  ASSERT_TRUE(db_->Execute("INSERT INTO foo VALUES (1, 2), (3, 4), (5, 6)"));
+
+  const StatementID select_id = SQL_FROM_HERE;
+  for (int i = 0; i < 2; ++i) {
+    Statement select(db_->GetCachedStatement(select_id, "SELECT a FROM foo"));
+    int rows = 0;
+    while (select.Step())
+      ++rows;
+    EXPECT_EQ(3, rows);
+  }
+  const StatementID insert_id = SQL_FROM_HERE;
+  {
+    Statement insert(
+        db_->GetCachedStatement(insert_id, "INSERT INTO foo VALUES (7, 8)"));
+    ASSERT_TRUE(insert.Run());
+  }
+  // Statements that are not cached are not profiled.
+  EXPECT_TRUE(db_->Execute("SELECT b FROM foo"));
+
+  std::vector<std::pair<StatementID, StatementStats>> stats =
+      db_->GetStatementStats();
+  ASSERT_EQ(2u, stats.size());
+  std::map<StatementID, StatementStats> stats_by_id(stats.begin(),
+                                                     stats.end());
+  ASSERT_EQ(1u, stats_by_id.count(select_id));
+  ASSERT_EQ(1u, stats_by_id.count(insert_id));
+  // Each scan steps once per row, and once more to reach the end.
+  EXPECT_EQ(8, stats_by_id[select_id].steps);
+  EXPECT_EQ(6, stats_by_id[select_id].rows);
+  EXPECT_GT(stats_by_id[select_id].cache_hits +
+                stats_by_id[select_id].cache_misses,
+            0);
+  EXPECT_EQ(1, stats_by_id[insert_id].steps);
+  EXPECT_EQ(0, stats_by_id[insert_id].rows);
+
+  // The counters are kept across Close() and Open().
+  db_->Close();
+  ASSERT_TRUE(db_->Open(db_path_));
+  {
+    Statement select(db_->GetCachedStatement(select_id, "SELECT a FROM foo"));
+    ASSERT_TRUE(select.Step());
+  }
+  stats = db_->GetStatementStats();
+  stats_by_id = std::map<StatementID, StatementStats>(stats.begin(),
+                                                      stats.end());
+  EXPECT_EQ(9, stats_by_id[select_id].steps);
+}
+
+TEST_P(SQLDatabaseTest, AdaptiveCacheSize) {
+  constexpr int kInitialCachePages = 10;
+  constexpr int kMaxCachePages = 64;
+  DatabaseOptions options = GetDBOptions();
+  options.cache_size = kInitialCachePages;
+  options.adaptive_cache_budget_bytes = kMaxCachePages * options.page_size;
+  db_ = std::make_unique<Database>(options);
+  ASSERT_TRUE(db_->Open(db_path_));
+  EXPECT_EQ(ExecuteWithResult(db_.get(), "PRAGMA cache_size"),
+            base::NumberToString(kInitialCachePages));
+
+  // A table that is much larger than the budget, so that scanning it keeps
+  // missing the cache.
+  ASSERT_TRUE(db_->Execute("CREATE TABLE foo (a BLOB)"));
+  {
+    ASSERT_TRUE(db_->BeginTransaction());
+    Statement insert(db_->GetUniqueStatement("INSERT INTO foo VALUES (?)"));
+    const std::string blob(options.page_size / 4, 'x');
+    for (int i = 0; i < 8 * kMaxCachePages * 4; ++i) {
+      insert.BindBlob(0, blob);
+      ASSERT_TRUE(insert.Run());
+      insert.Reset(true);
+    }
+    ASSERT_TRUE(db_->CommitTransaction());
+  }
+
+  for (int i = 0; i < 200; ++i) {
+    Statement select(db_->GetCachedStatement(
+        SQL_FROM_HERE, "SELECT COUNT(*) FROM foo WHERE length(a) > 0"));
+    ASSERT_TRUE(select.Step());
+  }
+
+  int cache_pages = 0;
+  ASSERT_TRUE(base::StringToInt(
+      ExecuteWithResult(db_.get(), "PRAGMA cache_size"), &cache_pages));
+  EXPECT_GT(cache_pages, kInitialCachePages);
+  EXPECT_LE(cache_pages, kMaxCachePages);
+  EXPECT_EQ(kMaxCachePages, db_->adaptive_cache_pages_);
+}
+
 TEST_P(SQLDatabaseTest, CorruptSizeInHeaderTest) {
   ASSERT_TRUE(db_->Execute("CREATE TABLE foo (x)"));
   ASSERT_TRUE(db_->Execute("CREATE TABLE bar (x)"));
@@ -0,0 +1,124 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sql/group_committer.h"
+
+#include <utility>
+
+#include "base/bind.h"
+#include "base/check_op.h"
+#include "base/ignore_result.h"
+#include "base/strings/stringprintf.h"
+#include "base/trace_event/trace_event.h"
+
+namespace sql {
+
+GroupCommitter::PendingWrite::PendingWrite(WriteCallback write,
+                                           DoneCallback done)
+    : write(std::move(write)), done(std::move(done)) {}
+
+GroupCommitter::PendingWrite::PendingWrite(PendingWrite&&) = default;
+
+GroupCommitter::PendingWrite& GroupCommitter::PendingWrite::operator=(
+    PendingWrite&&) = default;
+
+GroupCommitter::PendingWrite::~PendingWrite() = default;
+
+// static
+DatabaseOptions GroupCommitter::GetDefaultDatabaseOptions() {
+  DatabaseOptions options;
+  options.wal_mode = true;
+  return options;
+}
+
+GroupCommitter::GroupCommitter(Database* database, const Options& options)
+    : database_(database), options_(options) {
+  DCHECK(database_);
+  DCHECK(database_->is_open());
+  DCHECK_GT(options_.max_batch_size, 0u);
+  DCHECK_GE(options_.checkpoint_interval_batches, 0);
+
+  if (options_.wal_autocheckpoint_pages >= 0 && database_->UseWALMode()) {
+    const std::string autocheckpoint_sql =
+        base::StringPrintf("PRAGMA wal_autocheckpoint=%d",
+                           options_.wal_autocheckpoint_pages);
+    ignore_result(database_->Execute(autocheckpoint_sql.c_str()));
+  }
+}
+
+GroupCommitter::~GroupCommitter() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  ignore_result(Flush());
+}
+
+void GroupCommitter::Write(WriteCallback write, DoneCallback done) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  DCHECK(write);
+
+  pending_writes_.emplace_back(std::move(write), std::move(done));
+  if (pending_writes_.size() >= options_.max_batch_size) {
+    ignore_result(Flush());
+    return;
+  }
+  if (!timer_.IsRunning()) {
+    // Unretained() is safe because `this` owns `timer_`.
+    timer_.Start(FROM_HERE, options_.max_delay,
+                 base::BindOnce(base::IgnoreResult(&GroupCommitter::Flush),
+                                base::Unretained(this)));
+  }
+}
+
+bool GroupCommitter::Flush() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  // A surrounding transaction would delay the commit past the callbacks.
+  DCHECK_EQ(database_->transaction_nesting(), 0);
+
+  timer_.Stop();
+  if (pending_writes_.empty())
+    return true;
+
+  TRACE_EVENT1("sql", "GroupCommitter::Flush", "writes",
+               pending_writes_.size());
+
+  // Writes queued by the callbacks below go into the next batch.
+  std::vector<PendingWrite> batch;
+  batch.swap(pending_writes_);
+
+  std::vector<bool> succeeded(batch.size(), false);
+  bool committed = database_->BeginTransaction();
+  if (committed) {
+    for (size_t i = 0; i < batch.size(); ++i)
+      succeeded[i] = RunWrite(std::move(batch[i].write));
+    committed = database_->CommitTransaction();
+  }
+
+  if (committed) {
+    ++committed_batch_count_;
+    if (options_.checkpoint_interval_batches &&
+        committed_batch_count_ % options_.checkpoint_interval_batches == 0 &&
+        database_->UseWALMode()) {
+      ignore_result(database_->CheckpointDatabase());
+    }
+  }
+
+  for (size_t i = 0; i < batch.size(); ++i) {
+    if (batch[i].done)
+      std::move(batch[i].done).Run(committed && succeeded[i]);
+  }
+  return committed;
+}
+
+bool GroupCommitter::RunWrite(WriteCallback write) {
+  if (!database_->Execute("SAVEPOINT group_commit_write"))
+    return false;
+  if (std::move(write).Run(database_) &&
+      database_->Execute("RELEASE group_commit_write")) {
+    return true;
+  }
+  ignore_result(database_->Execute("ROLLBACK TO group_commit_write"));
+  ignore_result(database_->Execute("RELEASE group_commit_write"));
+  return false;
+}
+
+}  // namespace sql
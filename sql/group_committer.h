@@ -0,0 +1,143 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SQL_GROUP_COMMITTER_H_
+#define SQL_GROUP_COMMITTER_H_
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "base/callback.h"
+#include "base/component_export.h"
+#include "base/memory/raw_ptr.h"
+#include "base/sequence_checker.h"
+#include "base/thread_annotations.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
+#include "sql/database.h"
+
+namespace sql {
+
+// Coalesces many small writes to a Database into few transactions.
+//
+// Each transaction costs a journal commit, which usually means one or more
+// fsync() calls. Features that issue bursts of small independent writes, such
+// as usage bookkeeping, can hand them to a GroupCommitter instead of wrapping
+// each one in a Transaction. The writes are queued, and run together in one
+// transaction when the oldest one has waited for `Options::max_delay`, or when
+// `Options::max_batch_size` writes are queued, whichever comes first. Each
+// write's completion callback is run after the transaction commits.
+//
+// Each write runs in its own savepoint, so a write that fails is rolled back
+// without affecting the other writes in its batch.
+//
+// Queued writes are not visible to reads on the same Database until they are
+// committed. Callers that need to read their own writes should call Flush()
+// first.
+//
+// This class is not thread-safe. It must be used on the sequence of the
+// Database, and writes from other sequences must be posted to it, for example
+// by owning the Database and the GroupCommitter in a base::SequenceBound.
+class COMPONENT_EXPORT(SQL) GroupCommitter {
+ public:
+  struct COMPONENT_EXPORT(SQL) Options {
+    // The longest time that a write waits for other writes to share its
+    // transaction.
+    base::TimeDelta max_delay = base::Milliseconds(50);
+
+    // The largest number of writes in one transaction.
+    size_t max_batch_size = 128;
+
+    // If non-negative, and the database is in WAL mode, sets the number of
+    // pages after which the WAL is checkpointed into the database file by
+    // SQLite's automatic checkpoints. 0 turns automatic checkpoints off.
+    //
+    // See https://www.sqlite.org/pragma.html#pragma_wal_autocheckpoint
+    int wal_autocheckpoint_pages = -1;
+
+    // If non-zero, and the database is in WAL mode, a passive checkpoint is
+    // run after every this many committed batches, in addition to SQLite's
+    // automatic checkpoints.
+    int checkpoint_interval_batches = 0;
+  };
+
+  // Runs one write. Returns false if the write failed, in which case its
+  // changes are rolled back.
+  using WriteCallback = base::OnceCallback<bool(Database*)>;
+
+  // Told whether a write was committed.
+  using DoneCallback = base::OnceCallback<void(bool success)>;
+
+  // Returns the options to open a Database that is written through a
+  // GroupCommitter with. Databases in WAL mode commit with a single sequential
+  // write to the log, and without waiting for the log to be synced, so they
+  // benefit the most from batching.
+  static DatabaseOptions GetDefaultDatabaseOptions();
+
+  // `database` must be open, and must outlive the GroupCommitter.
+  GroupCommitter(Database* database, const Options& options);
+  GroupCommitter(const GroupCommitter&) = delete;
+  GroupCommitter& operator=(const GroupCommitter&) = delete;
+
+  // Commits the queued writes.
+  ~GroupCommitter();
+
+  // Queues `write`, and runs `done` once the transaction containing it is
+  // committed or rolled back. `done` may be null.
+  //
+  // Queueing the `Options::max_batch_size`th write commits the batch
+  // synchronously.
+  void Write(WriteCallback write, DoneCallback done);
+
+  // Runs the queued writes in one transaction now. Returns false if the
+  // transaction failed to commit. The callbacks of the writes are run before
+  // this returns.
+  bool Flush();
+
+  // The number of writes waiting for their transaction.
+  size_t pending_write_count() const {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+    return pending_writes_.size();
+  }
+
+  // The number of transactions committed so far.
+  size_t committed_batch_count() const {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+    return committed_batch_count_;
+  }
+
+ private:
+  struct PendingWrite {
+    PendingWrite(WriteCallback write, DoneCallback done);
+    PendingWrite(PendingWrite&&);
+    PendingWrite& operator=(PendingWrite&&);
+    ~PendingWrite();
+
+    WriteCallback write;
+    DoneCallback done;
+  };
+
+  // Runs `write` in a savepoint. Returns false, after rolling back to the
+  // savepoint, if the write failed.
+  bool RunWrite(WriteCallback write);
+
+  SEQUENCE_CHECKER(sequence_checker_);
+
+  const raw_ptr<Database> database_ GUARDED_BY_CONTEXT(sequence_checker_);
+  const Options options_;
+
+  std::vector<PendingWrite> pending_writes_
+      GUARDED_BY_CONTEXT(sequence_checker_);
+
+  // Runs Flush() once the oldest pending write has waited for
+  // `options_.max_delay`.
+  base::OneShotTimer timer_ GUARDED_BY_CONTEXT(sequence_checker_);
+
+  size_t committed_batch_count_ GUARDED_BY_CONTEXT(sequence_checker_) = 0;
+};
+
+}  // namespace sql
+
+#endif  // SQL_GROUP_COMMITTER_H_
@@ -0,0 +1,126 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sql/group_committer.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+
+#include "base/bind.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/strings/stringprintf.h"
+#include "base/test/task_environment.h"
+#include "base/time/time.h"
+#include "sql/database.h"
+#include "sql/statement.h"
+#include "sql/transaction.h"
+#include "sql/vfs_wrapper.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+// This file compares committing a burst of small writes, like the usage
+// updates of the quota database, in one transaction each and through a
+// GroupCommitter, with and without WAL.
+
+namespace sql {
+
+namespace {
+
+constexpr char kMetricPrefixGroupCommit[] = "GroupCommit.";
+constexpr char kMetricWritesPerSecond[] = "committed_writes_per_second";
+constexpr char kMetricSyncsPerWrite[] = "fsyncs_per_write";
+
+constexpr int kNumWrites = 1000;
+constexpr int kNumOrigins = 100;
+
+perf_test::PerfResultReporter SetUpReporter(const std::string& story_name) {
+  perf_test::PerfResultReporter reporter(kMetricPrefixGroupCommit, story_name);
+  reporter.RegisterImportantMetric(kMetricWritesPerSecond, "runs/s");
+  reporter.RegisterImportantMetric(kMetricSyncsPerWrite, "count");
+  return reporter;
+}
+
+bool UpdateUsage(int write, Database* db) {
+  Statement update(db->GetCachedStatement(
+      SQL_FROM_HERE,
+      "INSERT OR REPLACE INTO usage(origin, used, last_access) "
+      "VALUES(?, ?, ?)"));
+  update.BindString(0, base::StringPrintf("https://origin%d.example",
+                                          write % kNumOrigins));
+  update.BindInt64(1, write * 1024);
+  update.BindInt64(2, write);
+  return update.Run();
+}
+
+class GroupCommitterPerfTest : public testing::Test {
+ protected:
+  void SetUp() override { ASSERT_TRUE(temp_dir_.CreateUniqueTempDir()); }
+
+  void OpenDatabase(Database* db) {
+    ASSERT_TRUE(db->Open(temp_dir_.GetPath().AppendASCII("usage.sqlite")));
+    ASSERT_TRUE(
+        db->Execute("CREATE TABLE usage(origin TEXT PRIMARY KEY NOT NULL,"
+                    "used INTEGER NOT NULL, last_access INTEGER NOT NULL)"));
+  }
+
+  void RunTest(const char* story_name, bool wal_mode, bool group_commit) {
+    DatabaseOptions options = GroupCommitter::GetDefaultDatabaseOptions();
+    options.wal_mode = wal_mode;
+    Database db(options);
+    OpenDatabase(&db);
+
+    const uint64_t syncs_before = GetVFSWrapperSyncCountForTesting();
+    const base::TimeTicks start = base::TimeTicks::Now();
+    if (group_commit) {
+      GroupCommitter committer(&db, GroupCommitter::Options());
+      for (int i = 0; i < kNumWrites; ++i) {
+        committer.Write(base::BindOnce(&UpdateUsage, i),
+                        base::BindOnce([](bool success) {
+                          EXPECT_TRUE(success);
+                        }));
+      }
+      ASSERT_TRUE(committer.Flush());
+    } else {
+      for (int i = 0; i < kNumWrites; ++i) {
+        Transaction transaction(&db);
+        ASSERT_TRUE(transaction.Begin());
+        ASSERT_TRUE(UpdateUsage(i, &db));
+        ASSERT_TRUE(transaction.Commit());
+      }
+    }
+    const base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+    const uint64_t syncs = GetVFSWrapperSyncCountForTesting() - syncs_before;
+
+    auto reporter = SetUpReporter(story_name);
+    reporter.AddResult(kMetricWritesPerSecond,
+                       kNumWrites / elapsed.InSecondsF());
+    reporter.AddResult(kMetricSyncsPerWrite,
+                       static_cast<double>(syncs) / kNumWrites);
+  }
+
+  base::test::TaskEnvironment task_environment_;
+  base::ScopedTempDir temp_dir_;
+};
+
+TEST_F(GroupCommitterPerfTest, TransactionPerWrite) {
+  RunTest("TransactionPerWrite", /*wal_mode=*/false, /*group_commit=*/false);
+}
+
+TEST_F(GroupCommitterPerfTest, TransactionPerWriteWAL) {
+  RunTest("TransactionPerWriteWAL", /*wal_mode=*/true, /*group_commit=*/false);
+}
+
+TEST_F(GroupCommitterPerfTest, GroupCommit) {
+  RunTest("GroupCommit", /*wal_mode=*/false, /*group_commit=*/true);
+}
+
+TEST_F(GroupCommitterPerfTest, GroupCommitWAL) {
+  RunTest("GroupCommitWAL", /*wal_mode=*/true, /*group_commit=*/true);
+}
+
+}  // namespace
+
+}  // namespace sql
@@ -0,0 +1,189 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sql/group_committer.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/test/task_environment.h"
+#include "sql/database.h"
+#include "sql/statement.h"
+#include "sql/test/scoped_error_expecter.h"
+#include "sql/test/test_helpers.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "third_party/sqlite/sqlite3.h"
+
+namespace sql {
+
+namespace {
+
+using sql::test::ExecuteWithResult;
+
+constexpr base::TimeDelta kMaxDelay = base::Milliseconds(100);
+constexpr size_t kMaxBatchSize = 4;
+
+GroupCommitter::WriteCallback InsertRow(int id) {
+  return base::BindOnce(
+      [](int id, Database* db) {
+        Statement insert(db->GetCachedStatement(
+            SQL_FROM_HERE, "INSERT INTO rows(id) VALUES(?)"));
+        insert.BindInt(0, id);
+        return insert.Run();
+      },
+      id);
+}
+
+// Inserts a row, and then fails.
+GroupCommitter::WriteCallback InsertRowAndFail(int id) {
+  return base::BindOnce(
+      [](GroupCommitter::WriteCallback insert, Database* db) {
+        EXPECT_TRUE(std::move(insert).Run(db));
+        return false;
+      },
+      InsertRow(id));
+}
+
+class SQLGroupCommitterTest : public testing::Test {
+ public:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    db_ = std::make_unique<Database>(
+        GroupCommitter::GetDefaultDatabaseOptions());
+    ASSERT_TRUE(
+        db_->Open(temp_dir_.GetPath().AppendASCII("group_committer.sqlite")));
+    ASSERT_TRUE(db_->Execute("CREATE TABLE rows(id INTEGER PRIMARY KEY)"));
+
+    GroupCommitter::Options options;
+    options.max_delay = kMaxDelay;
+    options.max_batch_size = kMaxBatchSize;
+    committer_ = std::make_unique<GroupCommitter>(db_.get(), options);
+  }
+
+  GroupCommitter::DoneCallback RecordResult() {
+    return base::BindOnce(
+        [](std::vector<bool>* results, bool success) {
+          results->push_back(success);
+        },
+        &results_);
+  }
+
+  std::string CountRows() {
+    return ExecuteWithResult(db_.get(), "SELECT COUNT(*) FROM rows");
+  }
+
+ protected:
+  base::test::TaskEnvironment task_environment_{
+      base::test::TaskEnvironment::TimeSource::MOCK_TIME};
+  base::ScopedTempDir temp_dir_;
+  std::unique_ptr<Database> db_;
+  std::unique_ptr<GroupCommitter> committer_;
+  std::vector<bool> results_;
+};
+
+TEST_F(SQLGroupCommitterTest, UsesWALByDefault) {
+  EXPECT_TRUE(GroupCommitter::GetDefaultDatabaseOptions().wal_mode);
+  if (db_->UseWALMode())
+    EXPECT_EQ("wal", ExecuteWithResult(db_.get(), "PRAGMA journal_mode"));
+}
+
+TEST_F(SQLGroupCommitterTest, CommitsAfterMaxDelay) {
+  committer_->Write(InsertRow(1), RecordResult());
+  task_environment_.FastForwardBy(kMaxDelay / 2);
+  committer_->Write(InsertRow(2), RecordResult());
+  EXPECT_EQ(2u, committer_->pending_write_count());
+  EXPECT_EQ("0", CountRows());
+  EXPECT_TRUE(results_.empty());
+
+  // The delay counts from the oldest write.
+  task_environment_.FastForwardBy(kMaxDelay / 2);
+  EXPECT_EQ(0u, committer_->pending_write_count());
+  EXPECT_EQ(1u, committer_->committed_batch_count());
+  EXPECT_EQ("2", CountRows());
+  EXPECT_EQ(std::vector<bool>({true, true}), results_);
+}
+
+TEST_F(SQLGroupCommitterTest, CommitsAtMaxBatchSize) {
+  for (size_t i = 0; i < kMaxBatchSize - 1; ++i)
+    committer_->Write(InsertRow(i), RecordResult());
+  EXPECT_EQ(0u, committer_->committed_batch_count());
+
+  committer_->Write(InsertRow(kMaxBatchSize), RecordResult());
+  EXPECT_EQ(1u, committer_->committed_batch_count());
+  EXPECT_EQ(0u, committer_->pending_write_count());
+  EXPECT_EQ(std::vector<bool>(kMaxBatchSize, true), results_);
+
+  // The timer was stopped with the commit.
+  task_environment_.FastForwardBy(kMaxDelay);
+  EXPECT_EQ(1u, committer_->committed_batch_count());
+}
+
+TEST_F(SQLGroupCommitterTest, FailedWriteIsRolledBack) {
+  committer_->Write(InsertRow(1), RecordResult());
+  committer_->Write(InsertRowAndFail(2), RecordResult());
+  // Fails because of the duplicate primary key.
+  committer_->Write(InsertRow(1), RecordResult());
+  {
+    sql::test::ScopedErrorExpecter expecter;
+    expecter.ExpectError(SQLITE_CONSTRAINT);
+    // Fills the batch, which runs the writes.
+    committer_->Write(InsertRow(3), base::NullCallback());
+    EXPECT_TRUE(expecter.SawExpectedErrors());
+  }
+  EXPECT_EQ(1u, committer_->committed_batch_count());
+
+  EXPECT_EQ(std::vector<bool>({true, false, false}), results_);
+  EXPECT_EQ("1,3", test::ExecuteWithResults(
+                       db_.get(), "SELECT id FROM rows ORDER BY id", ",", ","));
+}
+
+TEST_F(SQLGroupCommitterTest, Flush) {
+  EXPECT_TRUE(committer_->Flush());
+  EXPECT_EQ(0u, committer_->committed_batch_count());
+
+  committer_->Write(InsertRow(1), RecordResult());
+  EXPECT_TRUE(committer_->Flush());
+  EXPECT_EQ(1u, committer_->committed_batch_count());
+  EXPECT_EQ("1", CountRows());
+  EXPECT_EQ(std::vector<bool>({true}), results_);
+}
+
+TEST_F(SQLGroupCommitterTest, WritesFromCallbacksGoToNextBatch) {
+  committer_->Write(InsertRow(1),
+                    base::BindOnce(
+                        [](GroupCommitter* committer, bool success) {
+                          EXPECT_TRUE(success);
+                          committer->Write(InsertRow(2), base::NullCallback());
+                        },
+                        committer_.get()));
+  EXPECT_TRUE(committer_->Flush());
+  EXPECT_EQ(1u, committer_->pending_write_count());
+  EXPECT_EQ("1", CountRows());
+
+  task_environment_.FastForwardBy(kMaxDelay);
+  EXPECT_EQ(2u, committer_->committed_batch_count());
+  EXPECT_EQ("2", CountRows());
+}
+
+TEST_F(SQLGroupCommitterTest, CommitsOnDestruction) {
+  committer_->Write(InsertRow(1), RecordResult());
+  committer_.reset();
+  EXPECT_EQ("1", CountRows());
+  EXPECT_EQ(std::vector<bool>({true}), results_);
+}
+
+TEST_F(SQLGroupCommitterTest, FailsWhenDatabaseIsPoisoned) {
+  committer_->Write(InsertRow(1), RecordResult());
+  ASSERT_TRUE(db_->RazeAndClose());
+  EXPECT_FALSE(committer_->Flush());
+  EXPECT_EQ(std::vector<bool>({false}), results_);
+}
+
+}  // namespace
+
+}  // namespace sql
@@ -73,7 +73,21 @@ int Statement::StepInternal() {
   absl::optional<base::ScopedBlockingCall> scoped_blocking_call;
   ref_->InitScopedBlockingCall(FROM_HERE, &scoped_blocking_call);
 
+  StatementStats* stats = ref_->stats();
+  if (!stats) {
+    int ret = sqlite3_step(ref_->stmt());
+    return CheckError(ret);
+  }
+
+  Database* database = ref_->database();
+  int cache_hits_before;
+  int cache_misses_before;
+  database->GetCacheCounters(&cache_hits_before, &cache_misses_before);
+  const base::TimeTicks start = base::TimeTicks::Now();
   int ret = sqlite3_step(ref_->stmt());
+  database->RecordStatementStep(stats, ret == SQLITE_ROW,
+                                base::TimeTicks::Now() - start,
+                                cache_hits_before, cache_misses_before);
   return CheckError(ret);
 }
 
@@ -115,9 +129,11 @@ void Statement::Reset(bool clear_bound_vars) {
   }
 
   // Potentially release dirty cache pages if an autocommit statement made
-  // changes.
-  if (ref_->database())
+  // changes, and resize the cache if it is adaptive.
+  if (ref_->database()) {
     ref_->database()->ReleaseCacheMemoryIfNeeded(false);
+    ref_->database()->AdaptCacheSizeIfNeeded();
+  }
 
   succeeded_ = false;
 #if DCHECK_IS_ON()
@@ -36,6 +36,10 @@ class COMPONENT_EXPORT(SQL) StatementID {
   // Facilitates storing StatementID instances in maps.
   bool operator<(const StatementID& rhs) const noexcept;
 
+  // The source location passed to the constructor, for diagnostics.
+  const char* source_file() const noexcept { return source_file_; }
+  size_t source_line() const noexcept { return source_line_; }
+
  private:
   // Instances cannot be immutable because they support being used as map keys.
   //
@@ -0,0 +1,40 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sql/statement_stats.h"
+
+namespace sql {
+
+StatementStats& StatementStats::operator+=(const StatementStats& other) {
+  steps += other.steps;
+  rows += other.rows;
+  step_time += other.step_time;
+  cache_hits += other.cache_hits;
+  cache_misses += other.cache_misses;
+  return *this;
+}
+
+StatementStatsRegistry::StatementStatsRegistry() = default;
+
+StatementStatsRegistry::~StatementStatsRegistry() = default;
+
+StatementStats* StatementStatsRegistry::GetStats(StatementID id) {
+  base::AutoLock lock(lock_);
+  return &stats_[id];
+}
+
+void StatementStatsRegistry::Record(StatementStats* stats,
+                                    const StatementStats& delta) {
+  base::AutoLock lock(lock_);
+  *stats += delta;
+}
+
+std::vector<std::pair<StatementID, StatementStats>>
+StatementStatsRegistry::GetSnapshot() const {
+  base::AutoLock lock(lock_);
+  return std::vector<std::pair<StatementID, StatementStats>>(stats_.begin(),
+                                                             stats_.end());
+}
+
+}  // namespace sql
@@ -0,0 +1,78 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SQL_STATEMENT_STATS_H_
+#define SQL_STATEMENT_STATS_H_
+
+#include <stdint.h>
+
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "base/component_export.h"
+#include "base/memory/ref_counted.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
+#include "base/time/time.h"
+#include "sql/statement_id.h"
+
+namespace sql {
+
+// Counters for the executions of one cached statement.
+//
+// Collected when DatabaseOptions::profile_statements is set.
+struct COMPONENT_EXPORT(SQL) StatementStats {
+  StatementStats& operator+=(const StatementStats& other);
+
+  // Number of times the statement was stepped.
+  int64_t steps = 0;
+
+  // Number of result rows returned by the steps.
+  int64_t rows = 0;
+
+  // Wall time spent stepping the statement.
+  base::TimeDelta step_time;
+
+  // Number of pages that the steps found in SQLite's page cache, and number of
+  // pages that had to be read from the database file or its memory map.
+  int64_t cache_hits = 0;
+  int64_t cache_misses = 0;
+};
+
+// The StatementStats of all the cached statements of a Database.
+//
+// The counters are updated on the Database's sequence and read by the memory
+// dump provider on another thread, so accesses are synchronized.
+class COMPONENT_EXPORT(SQL) StatementStatsRegistry
+    : public base::RefCountedThreadSafe<StatementStatsRegistry> {
+ public:
+  StatementStatsRegistry();
+  StatementStatsRegistry(const StatementStatsRegistry&) = delete;
+  StatementStatsRegistry& operator=(const StatementStatsRegistry&) = delete;
+
+  // Returns the counters for the statement identified by `id`, creating them
+  // if needed. The counters live as long as the registry, so the result can
+  // be cached by the caller and passed to Record().
+  StatementStats* GetStats(StatementID id);
+
+  // Adds `delta` to `stats`, which must have been returned by GetStats().
+  void Record(StatementStats* stats, const StatementStats& delta);
+
+  // Returns a copy of the counters of all statements, in StatementID order.
+  std::vector<std::pair<StatementID, StatementStats>> GetSnapshot() const;
+
+ private:
+  friend class base::RefCountedThreadSafe<StatementStatsRegistry>;
+  ~StatementStatsRegistry();
+
+  mutable base::Lock lock_;
+
+  // std::map, because the counters must not move.
+  std::map<StatementID, StatementStats> stats_ GUARDED_BY(lock_);
+};
+
+}  // namespace sql
+
+#endif  // SQL_STATEMENT_STATS_H_
@@ -5,6 +5,7 @@
 #include "sql/vfs_wrapper.h"
 
 #include <algorithm>
+#include <atomic>
 #include <string>
 #include <vector>
 
@@ -28,6 +29,9 @@
 namespace sql {
 namespace {
 
+// The number of xSync() calls, see GetVFSWrapperSyncCountForTesting().
+std::atomic<uint64_t> g_sync_count{0};
+
 // https://www.sqlite.org/vfs.html - documents the overall VFS system.
 //
 // https://www.sqlite.org/c3ref/vfs.html - VFS methods.  This code tucks the
@@ -89,6 +93,7 @@ int Truncate(sqlite3_file* sqlite_file, sqlite3_int64 size)
 
 int Sync(sqlite3_file* sqlite_file, int flags)
 {
+  g_sync_count.fetch_add(1, std::memory_order_relaxed);
   sqlite3_file* wrapped_file = GetWrappedFile(sqlite_file);
   return wrapped_file->pMethods->xSync(wrapped_file, flags);
 }
@@ -362,6 +367,10 @@ int CurrentTimeInt64(sqlite3_vfs* vfs, sqlite3_int64* now) {
 
 }  // namespace
 
+uint64_t GetVFSWrapperSyncCountForTesting() {
+  return g_sync_count.load(std::memory_order_relaxed);
+}
+
 sqlite3_vfs* VFSWrapper() {
   const char* kVFSName = "VFSWrapper";
 
@@ -5,8 +5,11 @@
 #ifndef SQL_VFS_WRAPPER_H_
 #define SQL_VFS_WRAPPER_H_
 
+#include <stdint.h>
+
 #include <string>
 
+#include "base/component_export.h"
 #include "build/build_config.h"
 #include "third_party/sqlite/sqlite3.h"
 
@@ -24,6 +27,10 @@ namespace sql {
 // TODO(shess): On Windows, wrap xFetch() with a structured exception handler.
 sqlite3_vfs* VFSWrapper();
 
+// Returns the number of times that files opened through VFSWrapper() were
+// synced, for benchmarks that measure the durability cost of writes.
+COMPONENT_EXPORT(SQL) uint64_t GetVFSWrapperSyncCountForTesting();
+
 // Internal representation of sqlite3_file for VFSWrapper.
 struct VfsFile {
   const sqlite3_io_methods* methods;
@@ -268,15 +268,16 @@ void BlobDataBuilder::SliceBlob(const BlobEntry* source,
       case BlobDataItem::Type::kBytesDescription:
       case BlobDataItem::Type::kBytes: {
         need_copy = true;
-        copy_quota_needed_ += read_size;
         total_memory_size_ += read_size;
-        // Since we don't have quota yet for memory, we create temporary items
-        // for this data. When our blob is finished constructing, all dependent
-        // blobs are done, and we have enough memory quota, we'll copy the data
-        // over.
+        // The source may not be populated yet, so we create temporary items
+        // for this data. When our blob is finished constructing and all
+        // dependent blobs are done, these become slices that share the memory
+        // of the source item. That memory is already accounted for by the
+        // source, so slices don't request any quota and are only waiting to
+        // be populated.
         data_item = BlobDataItem::CreateBytesDescription(
             base::checked_cast<size_t>(read_size));
-        state = ShareableBlobDataItem::QUOTA_NEEDED;
+        state = ShareableBlobDataItem::QUOTA_GRANTED;
         break;
       }
       case BlobDataItem::Type::kFile: {
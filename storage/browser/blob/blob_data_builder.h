@@ -200,7 +200,7 @@ class COMPONENT_EXPORT(STORAGE_BROWSER) BlobDataBuilder {
   bool IsValid() const {
     return !(found_memory_transport_ && found_file_transport_) &&
            !has_blob_errors_ && total_size_.IsValid() &&
-           transport_quota_needed_.IsValid() && copy_quota_needed_.IsValid();
+           transport_quota_needed_.IsValid();
   }
 
   bool found_memory_transport() const { return found_memory_transport_; }
@@ -219,10 +219,6 @@ class COMPONENT_EXPORT(STORAGE_BROWSER) BlobDataBuilder {
     return IsValid() ? transport_quota_needed_.ValueOrDie() : 0u;
   }
 
-  uint64_t copy_quota_needed() const {
-    return IsValid() ? copy_quota_needed_.ValueOrDie() : 0u;
-  }
-
  private:
   friend class BlobStorageContext;
   friend COMPONENT_EXPORT(STORAGE_BROWSER) void PrintTo(
@@ -241,7 +237,6 @@ class COMPONENT_EXPORT(STORAGE_BROWSER) BlobDataBuilder {
   base::CheckedNumeric<uint64_t> total_size_;
   base::CheckedNumeric<uint64_t> total_memory_size_;
   base::CheckedNumeric<uint64_t> transport_quota_needed_;
-  base::CheckedNumeric<uint64_t> copy_quota_needed_;
   bool has_blob_errors_ = false;
   bool found_memory_transport_ = false;
   bool found_file_transport_ = false;
@@ -68,7 +68,7 @@ scoped_refptr<BlobDataItem> BlobDataItem::CreateBytes(
     base::span<const uint8_t> bytes) {
   auto item =
       base::WrapRefCounted(new BlobDataItem(Type::kBytes, 0, bytes.size()));
-  item->bytes_.assign(bytes.begin(), bytes.end());
+  item->bytes_ = base::MakeRefCounted<base::RefCountedBytes>(bytes);
   return item;
 }
 
@@ -79,6 +79,20 @@ scoped_refptr<BlobDataItem> BlobDataItem::CreateBytesDescription(
       new BlobDataItem(Type::kBytesDescription, 0, length));
 }
 
+// static
+scoped_refptr<BlobDataItem> BlobDataItem::CreateBytesSlice(
+    const BlobDataItem& source,
+    size_t offset,
+    size_t length) {
+  DCHECK_EQ(source.type(), Type::kBytes);
+  DCHECK_LE(offset, source.length());
+  DCHECK_LE(length, source.length() - offset);
+  auto item = base::WrapRefCounted(new BlobDataItem(Type::kBytes, 0, length));
+  item->bytes_ = source.bytes_;
+  item->bytes_offset_ = source.bytes_offset_ + offset;
+  return item;
+}
+
 // static
 scoped_refptr<BlobDataItem> BlobDataItem::CreateFile(base::FilePath path) {
   return CreateFile(path, 0, blink::BlobUtils::kUnknownSize);
@@ -178,7 +192,7 @@ BlobDataItem::~BlobDataItem() = default;
 
 void BlobDataItem::AllocateBytes() {
   DCHECK_EQ(type_, Type::kBytesDescription);
-  bytes_.resize(length_);
+  bytes_ = base::MakeRefCounted<base::RefCountedBytes>(length_);
   type_ = Type::kBytes;
 }
 
@@ -186,14 +200,16 @@ void BlobDataItem::PopulateBytes(base::span<const uint8_t> data) {
   DCHECK_EQ(type_, Type::kBytesDescription);
   DCHECK_EQ(length_, data.size());
   type_ = Type::kBytes;
-  bytes_.assign(data.begin(), data.end());
+  bytes_ = base::MakeRefCounted<base::RefCountedBytes>(data);
 }
 
 void BlobDataItem::ShrinkBytes(size_t new_length) {
   DCHECK_EQ(type_, Type::kBytes);
+  DCHECK(!HasSharedBytes());
+  DCHECK_EQ(bytes_offset_, 0u);
   length_ = new_length;
-  bytes_.resize(length_);
-  bytes_.shrink_to_fit();
+  bytes_->data().resize(length_);
+  bytes_->data().shrink_to_fit();
 }
 
 void BlobDataItem::PopulateFile(
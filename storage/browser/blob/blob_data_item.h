@@ -15,6 +15,7 @@
 #include "base/containers/span.h"
 #include "base/files/file_path.h"
 #include "base/memory/ref_counted.h"
+#include "base/memory/ref_counted_memory.h"
 #include "components/services/storage/public/mojom/blob_storage_context.mojom.h"
 #include "net/base/io_buffer.h"
 #include "storage/browser/blob/shareable_file_reference.h"
@@ -82,6 +83,12 @@ class COMPONENT_EXPORT(STORAGE_BROWSER) BlobDataItem
   static scoped_refptr<BlobDataItem> CreateBytes(
       base::span<const uint8_t> bytes);
   static scoped_refptr<BlobDataItem> CreateBytesDescription(size_t length);
+  // Returns a kBytes item for the given range of the bytes of |source|, which
+  // shares the memory of |source| instead of copying it.
+  static scoped_refptr<BlobDataItem> CreateBytesSlice(
+      const BlobDataItem& source,
+      size_t offset,
+      size_t length);
   static scoped_refptr<BlobDataItem> CreateFile(base::FilePath path);
   static scoped_refptr<BlobDataItem> CreateFile(
       base::FilePath path,
@@ -111,7 +118,22 @@ class COMPONENT_EXPORT(STORAGE_BROWSER) BlobDataItem
 
   base::span<const uint8_t> bytes() const {
     DCHECK_EQ(type_, Type::kBytes);
-    return base::make_span(bytes_);
+    return base::make_span(bytes_->front() + bytes_offset_, length_);
+  }
+
+  // Returns the memory that bytes() points into, which may be larger than
+  // bytes() and shared with other items. Holding a reference keeps bytes()
+  // valid even after this item is destroyed, so it can back IOBuffers that
+  // outlive the read.
+  scoped_refptr<base::RefCountedMemory> shared_bytes() const {
+    DCHECK_EQ(type_, Type::kBytes);
+    return bytes_;
+  }
+
+  // Returns true if the memory of bytes() is also referenced by other items,
+  // or by IOBuffers handed out for reads.
+  bool HasSharedBytes() const {
+    return type_ == Type::kBytes && !bytes_->HasOneRef();
   }
 
   const base::FilePath& path() const {
@@ -158,7 +180,9 @@ class COMPONENT_EXPORT(STORAGE_BROWSER) BlobDataItem
 
   base::span<uint8_t> mutable_bytes() {
     DCHECK_EQ(type_, Type::kBytes);
-    return base::make_span(bytes_);
+    // Bytes are only written while the item is built, before they are shared.
+    DCHECK(!HasSharedBytes());
+    return base::make_span(bytes_->front() + bytes_offset_, length_);
   }
 
   void AllocateBytes();
@@ -183,7 +207,10 @@ class COMPONENT_EXPORT(STORAGE_BROWSER) BlobDataItem
   uint64_t offset_;
   uint64_t length_;
 
-  std::vector<uint8_t> bytes_;    // For Type::kBytes.
+  // For Type::kBytes. Slices share the memory of the item they were created
+  // from, starting at |bytes_offset_|.
+  scoped_refptr<base::RefCountedBytes> bytes_;
+  size_t bytes_offset_ = 0;
   base::FilePath path_;           // For Type::kFile.
   FileSystemURL filesystem_url_;  // For Type::kFileFilesystem.
   base::Time
@@ -35,13 +35,10 @@ BlobEntry::BuildingState::BuildingState(
       num_building_dependent_blobs(num_building_dependent_blobs) {}
 
 BlobEntry::BuildingState::~BuildingState() {
-  DCHECK(!copy_quota_request);
   DCHECK(!transport_quota_request);
 }
 
 void BlobEntry::BuildingState::CancelRequestsAndAbort() {
-  if (copy_quota_request)
-    copy_quota_request->Cancel();
   if (transport_quota_request)
     transport_quota_request->Cancel();
   if (build_aborted_callback)
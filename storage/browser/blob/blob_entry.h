@@ -29,7 +29,7 @@ class COMPONENT_EXPORT(STORAGE_BROWSER) BlobEntry {
   using BuildAbortedCallback = base::OnceClosure;
 
   // Records a copy from a referenced blob. Copies happen after referenced blobs
-  // are complete & quota for the copies is granted.
+  // are complete. Copies of memory items share the memory of the source item.
   struct COMPONENT_EXPORT(STORAGE_BROWSER) ItemCopyEntry {
     ItemCopyEntry(scoped_refptr<ShareableBlobDataItem> source_item,
                   size_t source_item_offset,
@@ -84,9 +84,6 @@ class COMPONENT_EXPORT(STORAGE_BROWSER) BlobEntry {
     base::WeakPtr<BlobMemoryController::QuotaAllocationTask>
         transport_quota_request;
 
-    // Copy quota is always memory.
-    base::WeakPtr<BlobMemoryController::QuotaAllocationTask> copy_quota_request;
-
     // These are copies from a referenced blob item to our blob items. Some of
     // these entries may have changed from bytes to files if they were paged.
     std::vector<ItemCopyEntry> copies;
@@ -116,7 +113,6 @@ class COMPONENT_EXPORT(STORAGE_BROWSER) BlobEntry {
   bool CanFinishBuilding() const {
     // PENDING_REFERENCED_BLOBS means transport is finished.
     return status_ == BlobStatus::PENDING_REFERENCED_BLOBS && building_state_ &&
-           !building_state_->copy_quota_request &&
            building_state_->num_building_dependent_blobs == 0;
   }
 
@@ -223,7 +223,6 @@ TEST_F(BlobFlattenerTest, BlobWithSlices) {
   EXPECT_EQ(3u, builder.dependent_blobs().size());
   EXPECT_EQ(32u, builder.total_size());
   EXPECT_EQ(14u, builder.transport_quota_needed());
-  EXPECT_EQ(2u, builder.copy_quota_needed());
 
   ASSERT_EQ(8u, builder.items().size());
   EXPECT_EQ(*CreateDataItem("hi", 2u), *builder.items()[0]->item());
@@ -895,12 +895,19 @@ size_t BlobMemoryController::CollectItemsForEviction(
   base::CheckedNumeric<size_t> total_items_size = 0;
   // Process the recent item list and remove items until we have at least a
   // minimum file size or we're at the end of our items to page to disk.
+  auto iterator = populated_memory_items_.rbegin();
   while (total_items_size.ValueOrDie() < min_page_file_size &&
-         !populated_memory_items_.empty()) {
-    auto iterator = --populated_memory_items_.end();
+         iterator != populated_memory_items_.rend()) {
     ShareableBlobDataItem* item = iterator->second;
     DCHECK_EQ(item->item()->type(), BlobDataItem::Type::kBytes);
-    populated_memory_items_.Erase(iterator);
+    // Bytes shared with slices or pending reads would stay in memory after
+    // paging, so paging them wouldn't free anything. They are left in the
+    // list, as they can be paged once they aren't shared anymore.
+    if (item->item()->HasSharedBytes()) {
+      ++iterator;
+      continue;
+    }
+    iterator = populated_memory_items_.Erase(iterator);
     size_t size = base::checked_cast<size_t>(item->item()->length());
     populated_memory_items_bytes_ -= size;
     total_items_size += size;
@@ -1025,14 +1032,25 @@ void BlobMemoryController::OnEvictionComplete(
   // Switch item from memory to the new file.
   uint64_t offset = 0;
   for (const scoped_refptr<ShareableBlobDataItem>& shareable_item : items) {
-    scoped_refptr<BlobDataItem> new_item = BlobDataItem::CreateFile(
-        file_reference->path(), offset, shareable_item->item()->length(),
-        file_info.last_modified, file_reference);
+    const uint64_t length = shareable_item->item()->length();
+    items_paging_to_file_.erase(shareable_item->item_id());
+    // Items whose bytes got shared with slices or reads while they were paged
+    // stay in memory and keep their quota, so they go back into the list of
+    // items to page. Their copy in the file is unused.
+    if (shareable_item->item()->HasSharedBytes()) {
+      populated_memory_items_bytes_ += base::checked_cast<size_t>(length);
+      populated_memory_items_.Put(shareable_item->item_id(),
+                                  shareable_item.get());
+      offset += length;
+      continue;
+    }
+    scoped_refptr<BlobDataItem> new_item =
+        BlobDataItem::CreateFile(file_reference->path(), offset, length,
+                                 file_info.last_modified, file_reference);
     DCHECK(shareable_item->memory_allocation_);
     shareable_item->set_memory_allocation(nullptr);
     shareable_item->set_item(new_item);
-    items_paging_to_file_.erase(shareable_item->item_id());
-    offset += shareable_item->item()->length();
+    offset += length;
   }
   in_flight_memory_used_ -= total_items_size;
 
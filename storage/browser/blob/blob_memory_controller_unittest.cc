@@ -353,6 +353,77 @@ TEST_P(BlobMemoryControllerTest, PageToDisk) {
   EXPECT_EQ(0u, controller.disk_usage());
 }
 
+TEST_P(BlobMemoryControllerTest, SharedItemsNotPaged) {
+  const std::string kId = "id";
+  const std::string kId2 = "id2";
+  BlobMemoryController controller(temp_dir_.GetPath(), file_runner_);
+  SetTestMemoryLimits(&controller);
+  AssertEnoughDiskSpace();
+
+  char kData[kTestBlobStorageMaxBlobMemorySize];
+  std::memset(kData, 'e', kTestBlobStorageMaxBlobMemorySize);
+
+  // Add memory item that is the memory quota.
+  BlobDataBuilder builder(kId);
+  BlobDataBuilder::FutureData future_data =
+      builder.AppendFutureData(kTestBlobStorageMaxBlobMemorySize);
+  std::vector<scoped_refptr<ShareableBlobDataItem>> items =
+      CreateSharedDataItems(builder);
+  controller.ReserveMemoryQuota(items, GetMemoryRequestCallback());
+  EXPECT_TRUE(memory_quota_result_);
+  memory_quota_result_ = false;
+  future_data.Populate(base::as_bytes(
+      base::make_span(kData, kTestBlobStorageMaxBlobMemorySize)));
+  items[0]->set_state(ItemState::POPULATED_WITH_QUOTA);
+
+  // A slice shares the bytes of the item, so paging it wouldn't free them.
+  scoped_refptr<BlobDataItem> slice =
+      BlobDataItem::CreateBytesSlice(*items[0]->item(), 10, 20);
+  controller.NotifyMemoryItemsUsed(items);
+  EXPECT_FALSE(file_runner_->HasPendingTask());
+
+  // Once it isn't shared anymore, the item is paged when memory is needed.
+  slice.reset();
+  BlobDataBuilder builder2(kId2);
+  builder2.AppendFutureData(kTestBlobStorageMinFileSizeBytes + 1);
+  std::vector<scoped_refptr<ShareableBlobDataItem>> items2 =
+      CreateSharedDataItems(builder2);
+  base::WeakPtr<QuotaAllocationTask> task =
+      controller.ReserveMemoryQuota(items2, GetMemoryRequestCallback());
+  EXPECT_NE(nullptr, task);
+  EXPECT_TRUE(file_runner_->HasPendingTask());
+
+  // The item is sliced again while it's paged, so it stays in memory along
+  // with its quota.
+  slice = BlobDataItem::CreateBytesSlice(*items[0]->item(), 10, 20);
+  RunFileThreadTasks();
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(BlobDataItem::Type::kBytes, items[0]->item()->type());
+  EXPECT_TRUE(HasMemoryAllocation(items[0].get()));
+  EXPECT_EQ(kTestBlobStorageMaxBlobMemorySize, controller.memory_usage());
+  EXPECT_NE(nullptr, task);
+  EXPECT_FALSE(memory_quota_result_);
+
+  // It can still be paged once the slice is gone.
+  slice.reset();
+  controller.NotifyMemoryItemsUsed(items2);
+  EXPECT_TRUE(file_runner_->HasPendingTask());
+  RunFileThreadTasks();
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(BlobDataItem::Type::kFile, items[0]->item()->type());
+  EXPECT_FALSE(HasMemoryAllocation(items[0].get()));
+  EXPECT_EQ(nullptr, task);
+  EXPECT_TRUE(memory_quota_result_);
+  EXPECT_EQ(kTestBlobStorageMinFileSizeBytes + 1, controller.memory_usage());
+
+  items2.clear();
+  items.clear();
+  RunFileThreadTasks();
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(0u, controller.memory_usage());
+  EXPECT_EQ(0u, controller.disk_usage());
+}
+
 TEST_P(BlobMemoryControllerTest, NoDiskTooLarge) {
   BlobMemoryController controller(temp_dir_.GetPath(), nullptr);
   SetTestMemoryLimits(&controller);
@@ -0,0 +1,242 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/callback_helpers.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/run_loop.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/test/task_environment.h"
+#include "base/test/test_simple_task_runner.h"
+#include "base/threading/thread_restrictions.h"
+#include "base/time/time.h"
+#include "build/build_config.h"
+#include "net/base/io_buffer.h"
+#include "storage/browser/blob/blob_data_builder.h"
+#include "storage/browser/blob/blob_data_handle.h"
+#include "storage/browser/blob/blob_memory_controller.h"
+#include "storage/browser/blob/blob_reader.h"
+#include "storage/browser/blob/blob_storage_constants.h"
+#include "storage/browser/blob/blob_storage_context.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+// This file measures building a blob in memory, slicing it into chunks like
+// the upload pipeline does for resumable uploads, and reading the chunks, both
+// by copying into buffers and through views of the blob's memory. It also
+// measures paging the source to disk once the chunks that share its memory
+// are gone.
+
+namespace storage {
+
+namespace {
+
+constexpr char kMetricPrefixBlob[] = "Blob.";
+constexpr char kMetricBuildThroughput[] = "build_throughput";
+constexpr char kMetricSliceThroughput[] = "slice_throughput";
+constexpr char kMetricReadCopyThroughput[] = "read_copy_throughput";
+constexpr char kMetricReadViewThroughput[] = "read_view_throughput";
+constexpr char kMetricSlicedMemoryUsage[] = "sliced_memory_usage";
+constexpr char kMetricPageThroughput[] = "page_throughput";
+
+constexpr size_t kMB = 1024 * 1024;
+
+// The size of the data items that the blob is built from.
+constexpr size_t kItemSize = 4 * kMB;
+
+// The size of the chunks that the blob is sliced into. This isn't a multiple
+// of kItemSize, so some chunks span two items.
+constexpr size_t kChunkSize = 3 * kMB;
+
+// The size of the buffers that chunks are read into.
+constexpr size_t kReadSize = 64 * 1024;
+
+perf_test::PerfResultReporter SetUpReporter(const std::string& story_name) {
+  perf_test::PerfResultReporter reporter(kMetricPrefixBlob, story_name);
+  reporter.RegisterImportantMetric(kMetricBuildThroughput, "MB/s");
+  reporter.RegisterImportantMetric(kMetricSliceThroughput, "MB/s");
+  reporter.RegisterImportantMetric(kMetricReadCopyThroughput, "MB/s");
+  reporter.RegisterImportantMetric(kMetricReadViewThroughput, "MB/s");
+  reporter.RegisterImportantMetric(kMetricSlicedMemoryUsage, "MB");
+  reporter.RegisterImportantMetric(kMetricPageThroughput, "MB/s");
+  return reporter;
+}
+
+double Throughput(size_t bytes, base::TimeDelta elapsed) {
+  return bytes / static_cast<double>(kMB) / elapsed.InSecondsF();
+}
+
+class BlobPerfTest : public testing::Test {
+ protected:
+  void SetUp() override { ASSERT_TRUE(temp_dir_.CreateUniqueTempDir()); }
+
+  void TearDown() override {
+    context_.reset();
+    base::RunLoop().RunUntilIdle();
+    RunFileTasks();
+    ASSERT_TRUE(temp_dir_.Delete());
+  }
+
+  // Creates a context with disk support that keeps |blob_size| bytes in
+  // memory, and pages kItemSize bytes at a time once there are more.
+  void CreateContext(size_t blob_size) {
+    context_ = std::make_unique<BlobStorageContext>(
+        temp_dir_.GetPath(), temp_dir_.GetPath(), file_runner_);
+    BlobStorageLimits limits;
+    limits.min_page_file_size = kItemSize;
+    limits.max_file_size = kItemSize;
+    limits.max_blob_in_memory_space = blob_size + kItemSize;
+    limits.desired_max_disk_space = 2 * blob_size;
+    limits.effective_max_disk_space = 2 * blob_size;
+    ASSERT_TRUE(limits.IsValid());
+    context_->set_limits_for_testing(limits);
+  }
+
+  void RunFileTasks() {
+    base::ScopedAllowBlockingForTesting allow_blocking;
+    while (file_runner_->HasPendingTask()) {
+      file_runner_->RunPendingTasks();
+      base::RunLoop().RunUntilIdle();
+    }
+  }
+
+  // Adds a blob of kItemSize bytes, which doesn't fit in memory next to the
+  // source, and runs the paging that it starts.
+  std::unique_ptr<BlobDataHandle> AddFillerBlob(const std::string& uuid) {
+    auto builder = std::make_unique<BlobDataBuilder>(uuid);
+    builder->AppendData(std::string(kItemSize, 'f'));
+    std::unique_ptr<BlobDataHandle> handle =
+        context_->AddFinishedBlob(std::move(builder));
+    EXPECT_FALSE(handle->IsBroken());
+    RunFileTasks();
+    return handle;
+  }
+
+  // Reads all of |handle|, and returns the number of bytes read.
+  size_t ReadBlob(const BlobDataHandle& handle, bool use_views) {
+    std::unique_ptr<BlobReader> reader = handle.CreateReader();
+    EXPECT_EQ(BlobReader::Status::DONE,
+              reader->CalculateSize(base::DoNothing()));
+    scoped_refptr<net::IOBuffer> buffer =
+        base::MakeRefCounted<net::IOBuffer>(kReadSize);
+    size_t total_read = 0;
+    while (true) {
+      int bytes_read = 0;
+      BlobReader::Status status =
+          use_views ? reader->ReadView(kReadSize, &buffer, &bytes_read,
+                                       base::DoNothing())
+                    : reader->Read(buffer.get(), kReadSize, &bytes_read,
+                                   base::DoNothing());
+      EXPECT_EQ(BlobReader::Status::DONE, status);
+      if (status != BlobReader::Status::DONE || bytes_read == 0)
+        break;
+      total_read += bytes_read;
+    }
+    return total_read;
+  }
+
+  void RunTest(const std::string& story_name, size_t blob_size) {
+    const std::string source_uuid = "source";
+    const std::vector<uint8_t> item_data(kItemSize, 'b');
+    CreateContext(blob_size);
+    const BlobMemoryController& memory_controller =
+        context_->memory_controller();
+
+    base::TimeTicks start = base::TimeTicks::Now();
+    auto builder = std::make_unique<BlobDataBuilder>(source_uuid);
+    for (size_t offset = 0; offset < blob_size; offset += kItemSize)
+      builder->AppendData(item_data);
+    std::unique_ptr<BlobDataHandle> source =
+        context_->AddFinishedBlob(std::move(builder));
+    const base::TimeDelta build_time = base::TimeTicks::Now() - start;
+    ASSERT_FALSE(source->IsBroken());
+
+    start = base::TimeTicks::Now();
+    std::vector<std::unique_ptr<BlobDataHandle>> chunks;
+    for (size_t offset = 0; offset < blob_size; offset += kChunkSize) {
+      auto chunk_builder = std::make_unique<BlobDataBuilder>(
+          "chunk" + base::NumberToString(offset));
+      chunk_builder->AppendBlob(source_uuid, offset, kChunkSize,
+                                context_->registry());
+      chunks.push_back(context_->AddFinishedBlob(std::move(chunk_builder)));
+      ASSERT_FALSE(chunks.back()->IsBroken());
+    }
+    const base::TimeDelta slice_time = base::TimeTicks::Now() - start;
+    // The chunks share the memory of the source.
+    const size_t sliced_memory_usage = memory_controller.memory_usage();
+    EXPECT_EQ(blob_size, sliced_memory_usage);
+
+    size_t bytes_read = 0;
+    start = base::TimeTicks::Now();
+    for (const auto& chunk : chunks)
+      bytes_read += ReadBlob(*chunk, /*use_views=*/false);
+    const base::TimeDelta read_copy_time = base::TimeTicks::Now() - start;
+    EXPECT_EQ(blob_size, bytes_read);
+
+    bytes_read = 0;
+    start = base::TimeTicks::Now();
+    for (const auto& chunk : chunks)
+      bytes_read += ReadBlob(*chunk, /*use_views=*/true);
+    const base::TimeDelta read_view_time = base::TimeTicks::Now() - start;
+    EXPECT_EQ(blob_size, bytes_read);
+
+    // Paging the shared source wouldn't free any memory, so the filler blob
+    // is paged instead.
+    std::unique_ptr<BlobDataHandle> filler1 = AddFillerBlob("filler1");
+    EXPECT_EQ(blob_size, memory_controller.memory_usage());
+    EXPECT_EQ(kItemSize, memory_controller.disk_usage());
+
+    // Without the chunks, the source can be paged.
+    chunks.clear();
+    start = base::TimeTicks::Now();
+    std::unique_ptr<BlobDataHandle> filler2 = AddFillerBlob("filler2");
+    const base::TimeDelta page_time = base::TimeTicks::Now() - start;
+    EXPECT_EQ(blob_size, memory_controller.memory_usage());
+    EXPECT_EQ(2 * kItemSize, memory_controller.disk_usage());
+
+    auto reporter = SetUpReporter(story_name);
+    reporter.AddResult(kMetricBuildThroughput,
+                       Throughput(blob_size, build_time));
+    reporter.AddResult(kMetricSliceThroughput,
+                       Throughput(blob_size, slice_time));
+    reporter.AddResult(kMetricReadCopyThroughput,
+                       Throughput(blob_size, read_copy_time));
+    reporter.AddResult(kMetricReadViewThroughput,
+                       Throughput(blob_size, read_view_time));
+    reporter.AddResult(kMetricSlicedMemoryUsage,
+                       sliced_memory_usage / static_cast<double>(kMB));
+    reporter.AddResult(kMetricPageThroughput, Throughput(kItemSize, page_time));
+  }
+
+  base::test::SingleThreadTaskEnvironment task_environment_;
+  base::ScopedTempDir temp_dir_;
+  scoped_refptr<base::TestSimpleTaskRunner> file_runner_ =
+      base::MakeRefCounted<base::TestSimpleTaskRunner>();
+  std::unique_ptr<BlobStorageContext> context_;
+};
+
+TEST_F(BlobPerfTest, Blob_12MB) {
+  RunTest("Blob_12MB", 12 * kMB);
+}
+
+TEST_F(BlobPerfTest, Blob_96MB) {
+  RunTest("Blob_96MB", 96 * kMB);
+}
+
+#if defined(ARCH_CPU_64_BITS)
+TEST_F(BlobPerfTest, Blob_1200MB) {
+  RunTest("Blob_1200MB", 1200 * kMB);
+}
+#endif
+
+}  // namespace
+
+}  // namespace storage
@@ -15,6 +15,7 @@
 #include "base/bind.h"
 #include "base/callback_helpers.h"
 #include "base/memory/ptr_util.h"
+#include "base/memory/ref_counted_memory.h"
 #include "base/task/post_task.h"
 #include "base/task/thread_pool.h"
 #include "base/time/time.h"
@@ -31,6 +32,24 @@
 namespace storage {
 namespace {
 
+// An IOBuffer that points into the shared memory of a kBytes item, and keeps
+// that memory alive.
+class SharedBytesIOBuffer : public net::WrappedIOBuffer {
+ public:
+  SharedBytesIOBuffer(scoped_refptr<base::RefCountedMemory> bytes,
+                      const uint8_t* data)
+      : net::WrappedIOBuffer(reinterpret_cast<const char*>(data)),
+        bytes_(std::move(bytes)) {
+    DCHECK_GE(data, bytes_->front());
+    DCHECK_LE(data, bytes_->front() + bytes_->size());
+  }
+
+ private:
+  ~SharedBytesIOBuffer() override = default;
+
+  const scoped_refptr<base::RefCountedMemory> bytes_;
+};
+
 bool IsFileType(BlobDataItem::Type type) {
   switch (type) {
     case BlobDataItem::Type::kFile:
@@ -463,6 +482,65 @@ void BlobReader::DidCountSize() {
     std::move(size_callback_).Run(net::OK);
 }
 
+BlobReader::Status BlobReader::ReadView(size_t max_bytes,
+                                        scoped_refptr<net::IOBuffer>* view,
+                                        int* bytes_read,
+                                        net::CompletionOnceCallback done) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  DCHECK(view);
+  DCHECK(bytes_read);
+  DCHECK(read_callback_.is_null());
+
+  *bytes_read = 0;
+  if (!blob_data_.get())
+    return ReportError(net::ERR_FILE_NOT_FOUND);
+  if (!total_size_calculated_)
+    return ReportError(net::ERR_UNEXPECTED);
+  if (net_error_ != net::OK)
+    return Status::NET_ERROR;
+
+  if (remaining_bytes_ < static_cast<uint64_t>(max_bytes))
+    max_bytes = static_cast<size_t>(remaining_bytes_);
+  if (!max_bytes) {
+    *view = nullptr;
+    return Status::DONE;
+  }
+
+  // Skip over the items that have been read completely, or are empty.
+  const auto& items = blob_data_->items();
+  while (current_item_index_ < items.size() &&
+         current_item_offset_ == item_length_list_[current_item_index_]) {
+    AdvanceItem();
+  }
+  if (current_item_index_ >= items.size())
+    return ReportError(net::ERR_UNEXPECTED);
+
+  const BlobDataItem& item = *items.at(current_item_index_);
+  if (item.type() != BlobDataItem::Type::kBytes) {
+    *view = base::MakeRefCounted<net::IOBuffer>(max_bytes);
+    return Read(view->get(), max_bytes, bytes_read, std::move(done));
+  }
+
+  TRACE_EVENT1("Blob", "BlobReader::ReadView", "uuid", blob_data_->uuid());
+  uint64_t item_remaining =
+      item_length_list_[current_item_index_] - current_item_offset_;
+  uint64_t max_int_value = std::numeric_limits<int>::max();
+  int bytes_to_read = static_cast<int>(std::min(
+      {item_remaining, static_cast<uint64_t>(max_bytes), max_int_value}));
+
+  *view = base::MakeRefCounted<SharedBytesIOBuffer>(
+      item.shared_bytes(),
+      item.bytes().data() + item.offset() + current_item_offset_);
+
+  current_item_offset_ += bytes_to_read;
+  if (current_item_offset_ == item_length_list_[current_item_index_])
+    AdvanceItem();
+  remaining_bytes_ -= bytes_to_read;
+
+  *bytes_read = bytes_to_read;
+  return Status::DONE;
+}
+
 BlobReader::Status BlobReader::ReadLoop(int* bytes_read) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
@@ -14,6 +14,7 @@
 
 #include "base/component_export.h"
 #include "base/gtest_prod_util.h"
+#include "base/memory/ref_counted.h"
 #include "base/memory/weak_ptr.h"
 #include "base/sequence_checker.h"
 #include "mojo/public/cpp/base/big_buffer.h"
@@ -126,6 +127,20 @@ class COMPONENT_EXPORT(STORAGE_BROWSER) BlobReader {
               int* bytes_read,
               net::CompletionOnceCallback done);
 
+  // Like Read, but for blob data that's in memory |view| is set to a buffer
+  // that points into the memory of the blob instead of a copy of it.
+  // * At most |max_bytes| are read, and views never span more than one item,
+  //   so a view may hold fewer bytes than are remaining in the blob.
+  // * Views must not be written to. They keep the memory alive, so they stay
+  //   valid after the reader and the blob are gone.
+  // * Data that isn't in memory is read into a newly allocated buffer, which
+  //   |view| is set to, as with Read.
+  // * bytes_read and the done callback behave like they do for Read.
+  Status ReadView(size_t max_bytes,
+                  scoped_refptr<net::IOBuffer>* view,
+                  int* bytes_read,
+                  net::CompletionOnceCallback done);
+
   // Returns if this reader contains a single MojoDataItem.  If so,
   // ReadSingleMojoDataItem can be called instead of multiple Reads as an
   // optimized path.  This can only be called after CalculateSize.
@@ -32,6 +32,8 @@
 #include "net/base/test_completion_callback.h"
 #include "storage/browser/blob/blob_data_builder.h"
 #include "storage/browser/blob/blob_data_handle.h"
+#include "storage/browser/blob/blob_data_item.h"
+#include "storage/browser/blob/blob_data_snapshot.h"
 #include "storage/browser/blob/blob_reader.h"
 #include "storage/browser/blob/blob_storage_context.h"
 #include "storage/browser/file_system/file_stream_reader.h"
@@ -502,6 +504,105 @@ TEST_F(BlobReaderTest, MemoryRange) {
   EXPECT_EQ(0, memcmp(buffer->data(), "llo!", kReadLength));
 }
 
+TEST_F(BlobReaderTest, ReadViewMemory) {
+  auto b = std::make_unique<BlobDataBuilder>("uuid");
+  b->AppendData("Hello ");
+  b->AppendData("there!");
+  this->InitializeReader(std::move(b));
+
+  int size_result = -1;
+  EXPECT_EQ(BlobReader::Status::DONE, reader_->CalculateSize(base::BindOnce(
+                                          &SetValue<int>, &size_result)));
+  CheckSizeCalculatedSynchronously(12u, size_result);
+  reader_->SetReadRange(1, 9);
+
+  std::unique_ptr<BlobDataSnapshot> snapshot = blob_handle_->CreateSnapshot();
+  const char* second_item_data = reinterpret_cast<const char*>(
+      snapshot->items().back()->bytes().data());
+
+  // Views don't span items.
+  scoped_refptr<net::IOBuffer> view;
+  int bytes_read = 0;
+  int async_bytes_read = 0;
+  EXPECT_EQ(BlobReader::Status::DONE,
+            reader_->ReadView(
+                100, &view, &bytes_read,
+                base::BindOnce(&SetValue<int>, &async_bytes_read)));
+  ASSERT_EQ(5, bytes_read);
+  EXPECT_EQ("ello ", std::string(view->data(), bytes_read));
+
+  // The view points into the memory of the blob.
+  EXPECT_EQ(BlobReader::Status::DONE,
+            reader_->ReadView(
+                2, &view, &bytes_read,
+                base::BindOnce(&SetValue<int>, &async_bytes_read)));
+  ASSERT_EQ(2, bytes_read);
+  EXPECT_EQ(second_item_data, view->data());
+  EXPECT_EQ("th", std::string(view->data(), bytes_read));
+
+  EXPECT_EQ(BlobReader::Status::DONE,
+            reader_->ReadView(
+                100, &view, &bytes_read,
+                base::BindOnce(&SetValue<int>, &async_bytes_read)));
+  ASSERT_EQ(2, bytes_read);
+  EXPECT_EQ(second_item_data + 2, view->data());
+  EXPECT_EQ(0u, reader_->remaining_bytes());
+  EXPECT_EQ(0, async_bytes_read);
+
+  // Views stay valid after the blob is gone.
+  snapshot.reset();
+  reader_.reset();
+  blob_handle_.reset();
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ("er", std::string(view->data(), bytes_read));
+}
+
+TEST_F(BlobReaderTest, ReadViewFile) {
+  auto b = std::make_unique<BlobDataBuilder>("uuid");
+  const FilePath kPath = FilePath::FromUTF8Unsafe("/fake/file.txt");
+  const std::string kData = "FileData!!!";
+  const base::Time kTime = base::Time::Now();
+  b->AppendFile(kPath, 0, kData.size(), kTime);
+  b->AppendData("Memory");
+  this->InitializeReader(std::move(b));
+
+  std::unique_ptr<FakeFileStreamReader> reader(new FakeFileStreamReader(kData));
+  reader->SetAsyncRunner(base::ThreadTaskRunnerHandle::Get().get());
+  ExpectLocalFileCall(kPath, kTime, 0, reader.release());
+
+  int size_result = -1;
+  EXPECT_EQ(BlobReader::Status::DONE, reader_->CalculateSize(base::BindOnce(
+                                          &SetValue<int>, &size_result)));
+  CheckSizeCalculatedSynchronously(kData.size() + 6, size_result);
+
+  // Data that isn't in memory is read into a new buffer.
+  scoped_refptr<net::IOBuffer> view;
+  int bytes_read = 0;
+  int async_bytes_read = 0;
+  EXPECT_EQ(BlobReader::Status::IO_PENDING,
+            reader_->ReadView(
+                kData.size(), &view, &bytes_read,
+                base::BindOnce(&SetValue<int>, &async_bytes_read)));
+  ASSERT_TRUE(view);
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(net::OK, reader_->net_error());
+  ASSERT_EQ(static_cast<int>(kData.size()), async_bytes_read);
+  EXPECT_EQ(kData, std::string(view->data(), async_bytes_read));
+
+  EXPECT_EQ(BlobReader::Status::DONE,
+            reader_->ReadView(
+                100, &view, &bytes_read,
+                base::BindOnce(&SetValue<int>, &async_bytes_read)));
+  ASSERT_EQ(6, bytes_read);
+  EXPECT_EQ("Memory", std::string(view->data(), bytes_read));
+
+  EXPECT_EQ(BlobReader::Status::DONE,
+            reader_->ReadView(
+                100, &view, &bytes_read,
+                base::BindOnce(&SetValue<int>, &async_bytes_read)));
+  EXPECT_EQ(0, bytes_read);
+}
+
 TEST_F(BlobReaderTest, BufferSmallerThanMemory) {
   auto b = std::make_unique<BlobDataBuilder>("uuid");
   const std::string kData("Hello!!!");
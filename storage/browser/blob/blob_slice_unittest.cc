@@ -67,7 +67,9 @@ class BlobSliceTest : public testing::Test {
     EXPECT_EQ(slice_offset, copy.source_item_offset);
     EXPECT_EQ(dest_item, copy.dest_item);
     EXPECT_EQ(size, dest_item->item()->length());
-    EXPECT_EQ(ShareableBlobDataItem::QUOTA_NEEDED, dest_item->state());
+    // Slices of memory share the quota of the source, but aren't populated
+    // until the blob is built.
+    EXPECT_EQ(ShareableBlobDataItem::QUOTA_GRANTED, dest_item->state());
     EXPECT_EQ(BlobDataItem::Type::kBytesDescription, dest_item->item()->type());
   }
 };
@@ -224,10 +224,9 @@ std::unique_ptr<BlobDataHandle> BlobStorageContext::BuildBlobInternal(
                                                 : TransportQuotaType::FILE;
 
   uint64_t total_memory_needed =
-      content->copy_quota_needed() +
-      (transport_quota_type == TransportQuotaType::MEMORY
-           ? content->transport_quota_needed()
-           : 0);
+      transport_quota_type == TransportQuotaType::MEMORY
+          ? content->transport_quota_needed()
+          : 0;
   UMA_HISTOGRAM_COUNTS_1M("Storage.Blob.TotalUnsharedSize",
                           total_memory_needed / 1024);
 
@@ -296,11 +295,6 @@ std::unique_ptr<BlobDataHandle> BlobStorageContext::BuildBlobInternal(
   for (const auto& item : content->pending_transport_items())
     transport_items.emplace_back(item.get());
 
-  std::vector<scoped_refptr<ShareableBlobDataItem>> pending_copy_items;
-  pending_copy_items.reserve(content->copies().size());
-  for (const auto& copy : content->copies())
-    pending_copy_items.emplace_back(copy.dest_item);
-
   auto previous_building_state = std::move(entry->building_state_);
   entry->set_building_state(std::make_unique<BlobEntry::BuildingState>(
       !content->pending_transport_items().empty(),
@@ -332,25 +326,12 @@ std::unique_ptr<BlobDataHandle> BlobStorageContext::BuildBlobInternal(
     return handle;
   }
 
-  // Avoid the state where we might grant only one quota.
-  if (!memory_controller_.CanReserveQuota(content->copy_quota_needed() +
-                                          content->transport_quota_needed())) {
+  // Fail early if the quota could never be granted.
+  if (!memory_controller_.CanReserveQuota(content->transport_quota_needed())) {
     CancelBuildingBlobInternal(entry, BlobStatus::ERR_OUT_OF_MEMORY);
     return handle;
   }
 
-  if (content->copy_quota_needed() > 0) {
-    // The blob can complete during the execution of |ReserveMemoryQuota|.
-    base::WeakPtr<QuotaAllocationTask> pending_request =
-        memory_controller_.ReserveMemoryQuota(
-            std::move(pending_copy_items),
-            base::BindOnce(&BlobStorageContext::OnEnoughSpaceForCopies,
-                           ptr_factory_.GetWeakPtr(), content->uuid_));
-    // Building state will be null if the blob is already finished.
-    if (entry->building_state_)
-      entry->building_state_->copy_quota_request = std::move(pending_request);
-  }
-
   if (content->transport_quota_needed() > 0) {
     base::WeakPtr<QuotaAllocationTask> pending_request;
 
@@ -532,22 +513,21 @@ void BlobStorageContext::FinishBuilding(BlobEntry* entry) {
       // Our source item can be a file if it was a slice of an unpopulated file,
       // or a slice of data that was then paged to disk.
       size_t dest_size = static_cast<size_t>(copy.dest_item->item()->length());
-      BlobDataItem::Type dest_type = copy.dest_item->item()->type();
       switch (copy.source_item->item()->type()) {
         case BlobDataItem::Type::kBytes: {
-          DCHECK_EQ(dest_type, BlobDataItem::Type::kBytesDescription);
-          base::span<const uint8_t> src_data =
-              copy.source_item->item()->bytes().subspan(copy.source_item_offset,
-                                                        dest_size);
-          copy.dest_item->item()->PopulateBytes(src_data);
+          DCHECK_EQ(copy.dest_item->item()->type(),
+                    BlobDataItem::Type::kBytesDescription);
+          // Slices of slices keep the item that owns the memory alive.
+          scoped_refptr<ShareableBlobDataItem> memory_owner =
+              copy.source_item->slice_source()
+                  ? copy.source_item->slice_source()
+                  : copy.source_item;
+          copy.dest_item->set_item(BlobDataItem::CreateBytesSlice(
+              *copy.source_item->item(), copy.source_item_offset, dest_size));
+          copy.dest_item->set_slice_source(std::move(memory_owner));
           break;
         }
         case BlobDataItem::Type::kFile: {
-          // If we expected a memory item (and our source was paged to disk) we
-          // free that memory.
-          if (dest_type == BlobDataItem::Type::kBytesDescription)
-            copy.dest_item->set_memory_allocation(nullptr);
-
           const auto& source_item = copy.source_item->item();
           scoped_refptr<BlobDataItem> new_item = BlobDataItem::CreateFile(
               source_item->path(),
@@ -563,7 +543,7 @@ void BlobStorageContext::FinishBuilding(BlobEntry* entry) {
           NOTREACHED();
           break;
       }
-      copy.dest_item->set_state(ShareableBlobDataItem::POPULATED_WITH_QUOTA);
+      copy.dest_item->set_state(ShareableBlobDataItem::POPULATED_WITHOUT_QUOTA);
     }
 
     entry->set_status(BlobStatus::DONE);
@@ -624,20 +604,6 @@ void BlobStorageContext::OnEnoughSpaceForTransport(
     FinishBuilding(entry);
 }
 
-void BlobStorageContext::OnEnoughSpaceForCopies(const std::string& uuid,
-                                                bool success) {
-  if (!success) {
-    CancelBuildingBlob(uuid, BlobStatus::ERR_OUT_OF_MEMORY);
-    return;
-  }
-  BlobEntry* entry = registry_.GetEntry(uuid);
-  if (!entry)
-    return;
-
-  if (entry->CanFinishBuilding())
-    FinishBuilding(entry);
-}
-
 void BlobStorageContext::OnDependentBlobFinished(
     const std::string& owning_blob_uuid,
     BlobStatus status) {
@@ -233,8 +233,6 @@ class COMPONENT_EXPORT(STORAGE_BROWSER) BlobStorageContext
       std::vector<BlobMemoryController::FileCreationInfo> files,
       bool can_fit);
 
-  void OnEnoughSpaceForCopies(const std::string& uuid, bool can_fit);
-
   void OnDependentBlobFinished(const std::string& owning_blob_uuid,
                                BlobStatus reason);
 
@@ -397,7 +397,8 @@ TEST_F(BlobStorageContextTest, AddFinishedBlob) {
   std::unique_ptr<BlobDataHandle> blob_data_handle2 =
       context_->AddFinishedBlob(std::move(builder2));
 
-  EXPECT_EQ(10u + 12u + 5u, context_->memory_controller().memory_usage());
+  // The slice shares the memory of the first blob.
+  EXPECT_EQ(10u + 12u, context_->memory_controller().memory_usage());
 
   ASSERT_TRUE(blob_data_handle);
   ASSERT_TRUE(blob_data_handle2);
@@ -410,7 +411,8 @@ TEST_F(BlobStorageContextTest, AddFinishedBlob) {
 
   base::RunLoop().RunUntilIdle();
 
-  EXPECT_EQ(12u + 5u, context_->memory_controller().memory_usage());
+  // The slice keeps all of the memory it shares alive.
+  EXPECT_EQ(10u + 12u, context_->memory_controller().memory_usage());
 
   blob_data_handle = context_->GetBlobDataFromUUID(kId1);
   EXPECT_FALSE(blob_data_handle);
@@ -428,7 +430,7 @@ TEST_F(BlobStorageContextTest, AddFinishedBlob) {
   blob_data_handle2.reset();
   base::RunLoop().RunUntilIdle();
 
-  EXPECT_EQ(12u + 5u, context_->memory_controller().memory_usage());
+  EXPECT_EQ(10u + 12u, context_->memory_controller().memory_usage());
 
   blob_data_handle2 = context_->GetBlobDataFromUUID(kId2);
   EXPECT_FALSE(blob_data_handle2);
@@ -448,6 +450,142 @@ TEST_F(BlobStorageContextTest, AddFinishedBlob) {
   base::RunLoop().RunUntilIdle();
 }
 
+TEST_F(BlobStorageContextTest, SlicesShareMemory) {
+  const std::string kId1("id1");
+  const std::string kId2("id2");
+  const std::string kId3("id3");
+
+  auto builder1 = std::make_unique<BlobDataBuilder>(kId1);
+  builder1->AppendData("Data1Data2Data3");
+  std::unique_ptr<BlobDataHandle> handle1 =
+      context_->AddFinishedBlob(std::move(builder1));
+  EXPECT_EQ(15u, context_->memory_controller().memory_usage());
+
+  auto builder2 = std::make_unique<BlobDataBuilder>(kId2);
+  builder2->AppendBlob(kId1, 5, 10, context_->registry());
+  std::unique_ptr<BlobDataHandle> handle2 =
+      context_->AddFinishedBlob(std::move(builder2));
+
+  // Slicing a slice shares the memory of the original item.
+  auto builder3 = std::make_unique<BlobDataBuilder>(kId3);
+  builder3->AppendBlob(kId2, 5, 3, context_->registry());
+  std::unique_ptr<BlobDataHandle> handle3 =
+      context_->AddFinishedBlob(std::move(builder3));
+  EXPECT_EQ(15u, context_->memory_controller().memory_usage());
+
+  std::unique_ptr<BlobDataSnapshot> data1 = handle1->CreateSnapshot();
+  std::unique_ptr<BlobDataSnapshot> data2 = handle2->CreateSnapshot();
+  std::unique_ptr<BlobDataSnapshot> data3 = handle3->CreateSnapshot();
+  ASSERT_EQ(1u, data2->items().size());
+  ASSERT_EQ(1u, data3->items().size());
+  const BlobDataItem& item1 = *data1->items()[0];
+  const BlobDataItem& item2 = *data2->items()[0];
+  const BlobDataItem& item3 = *data3->items()[0];
+  ASSERT_EQ(BlobDataItem::Type::kBytes, item2.type());
+  ASSERT_EQ(BlobDataItem::Type::kBytes, item3.type());
+  EXPECT_EQ(item1.bytes().data() + 5, item2.bytes().data());
+  EXPECT_EQ(item1.bytes().data() + 10, item3.bytes().data());
+  EXPECT_EQ("Data2Data3",
+            std::string(item2.bytes().begin(), item2.bytes().end()));
+  EXPECT_EQ("Dat", std::string(item3.bytes().begin(), item3.bytes().end()));
+  EXPECT_TRUE(item1.HasSharedBytes());
+  data1.reset();
+  data2.reset();
+  data3.reset();
+
+  // The memory, and its quota, lives as long as any of the slices.
+  handle1.reset();
+  handle2.reset();
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(15u, context_->memory_controller().memory_usage());
+  data3 = handle3->CreateSnapshot();
+  EXPECT_EQ("Dat", std::string(data3->items()[0]->bytes().begin(),
+                               data3->items()[0]->bytes().end()));
+  data3.reset();
+
+  handle3.reset();
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(0u, context_->memory_controller().memory_usage());
+}
+
+TEST_F(BlobStorageContextTest, SliceOfPartiallyPopulatedBlob) {
+  const std::string kId1("id1");
+  const std::string kId2("id2");
+  const std::string kId3("id3");
+  context_ = std::make_unique<BlobStorageContext>(
+      temp_dir_.GetPath(), temp_dir_.GetPath(), file_runner_);
+  SetTestMemoryLimits();
+
+  // The first item of the source is populated, the second one isn't yet.
+  auto builder1 = std::make_unique<BlobDataBuilder>(kId1);
+  builder1->AppendData("Data1");
+  BlobDataBuilder::FutureData future_data = builder1->AppendFutureData(5);
+  BlobStatus status = BlobStatus::ERR_INVALID_CONSTRUCTION_ARGUMENTS;
+  std::unique_ptr<BlobDataHandle> handle1 = context_->BuildBlob(
+      std::move(builder1),
+      base::BindOnce(&SaveBlobStatusAndFiles, &status, &files_));
+  EXPECT_EQ(BlobStatus::PENDING_TRANSPORT, status);
+  EXPECT_EQ(10u, context_->memory_controller().memory_usage());
+
+  auto builder2 = std::make_unique<BlobDataBuilder>(kId2);
+  builder2->AppendBlob(kId1, 2, 6, context_->registry());
+  std::unique_ptr<BlobDataHandle> handle2 = context_->BuildBlob(
+      std::move(builder2), BlobStorageContext::TransportAllowedCallback());
+  EXPECT_TRUE(handle2->IsBeingBuilt());
+
+  // The slices wait for the source without quota of their own.
+  const BlobEntry* entry2 = context_->registry().GetEntry(kId2);
+  ASSERT_EQ(2u, entry2->items().size());
+  for (const auto& item : entry2->items()) {
+    EXPECT_EQ(ShareableBlobDataItem::QUOTA_GRANTED, item->state());
+    EXPECT_FALSE(item->IsPopulated());
+  }
+  EXPECT_EQ(10u, context_->memory_controller().memory_usage());
+
+  future_data.Populate(base::as_bytes(base::make_span("Data2", 5)), 0);
+  context_->NotifyTransportComplete(kId1);
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(BlobStatus::DONE, handle1->GetBlobStatus());
+  EXPECT_EQ(BlobStatus::DONE, handle2->GetBlobStatus());
+  for (const auto& item : entry2->items()) {
+    EXPECT_EQ(ShareableBlobDataItem::POPULATED_WITHOUT_QUOTA, item->state());
+    EXPECT_EQ(BlobDataItem::Type::kBytes, item->item()->type());
+  }
+  EXPECT_EQ(10u, context_->memory_controller().memory_usage());
+
+  // Filling the memory pages the new blob, but not the shared source items,
+  // which paging wouldn't free.
+  const size_t kSize3 = kTestBlobStorageMaxBlobMemorySize - 10;
+  auto builder3 = std::make_unique<BlobDataBuilder>(kId3);
+  builder3->AppendData(std::string(kSize3, 'x'));
+  std::unique_ptr<BlobDataHandle> handle3 =
+      context_->AddFinishedBlob(std::move(builder3));
+  EXPECT_TRUE(file_runner_->HasPendingTask());
+  RunFileTasks();
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(10u, context_->memory_controller().memory_usage());
+  EXPECT_EQ(kSize3, context_->memory_controller().disk_usage());
+
+  std::unique_ptr<BlobDataSnapshot> data2 = handle2->CreateSnapshot();
+  std::string contents;
+  for (const auto& item : data2->items()) {
+    ASSERT_EQ(BlobDataItem::Type::kBytes, item->type());
+    contents.append(item->bytes().begin(), item->bytes().end());
+  }
+  EXPECT_EQ("ta1Dat", contents);
+  data2.reset();
+
+  handle1.reset();
+  handle2.reset();
+  handle3.reset();
+  files_.clear();
+  base::RunLoop().RunUntilIdle();
+  RunFileTasks();
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(0u, context_->memory_controller().memory_usage());
+  EXPECT_EQ(0u, context_->memory_controller().disk_usage());
+}
+
 TEST_F(BlobStorageContextTest, AddFinishedBlob_LargeOffset) {
   // A value which does not fit in a 4-byte data type. Used to confirm that
   // large values are supported on 32-bit Chromium builds. Regression test for:
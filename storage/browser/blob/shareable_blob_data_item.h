@@ -32,7 +32,8 @@ class COMPONENT_EXPORT(STORAGE_BROWSER) ShareableBlobDataItem
     // We have requested quota from the BlobMemoryController.
     QUOTA_REQUESTED,
     // Space has been allocated for this item in the BlobMemoryController, but
-    // it may not yet be populated.
+    // it may not yet be populated. Slices of memory items are in this state
+    // until they are populated, as the quota of their source covers them.
     QUOTA_GRANTED,
     // We're a populated item that needed quota.
     POPULATED_WITH_QUOTA,
@@ -83,11 +84,22 @@ class COMPONENT_EXPORT(STORAGE_BROWSER) ShareableBlobDataItem
 
   bool has_memory_allocation() { return static_cast<bool>(memory_allocation_); }
 
+  // Set for items whose bytes are a slice of the bytes of |source|. Keeps
+  // |source|, and with it the memory quota of the shared bytes, alive for as
+  // long as this item is.
+  void set_slice_source(scoped_refptr<ShareableBlobDataItem> source) {
+    slice_source_ = std::move(source);
+  }
+  const scoped_refptr<ShareableBlobDataItem>& slice_source() const {
+    return slice_source_;
+  }
+
   // This is a unique identifier for this ShareableBlobDataItem.
   const uint64_t item_id_;
   State state_;
   scoped_refptr<BlobDataItem> item_;
   std::unique_ptr<BlobMemoryController::MemoryAllocation> memory_allocation_;
+  scoped_refptr<ShareableBlobDataItem> slice_source_;
 };
 
 COMPONENT_EXPORT(STORAGE_BROWSER)
@@ -126,10 +126,11 @@ void FileWriterDelegate::OnReadCompleted(int bytes_read) {
 void FileWriterDelegate::Read() {
   bytes_written_ = 0;
   if (blob_reader_) {
-    BlobReader::Status status =
-        blob_reader_->Read(io_buffer_.get(), io_buffer_->size(), &bytes_read_,
-                           base::BindOnce(&FileWriterDelegate::OnReadCompleted,
-                                          weak_factory_.GetWeakPtr()));
+    // In-memory blob data is written straight from the blob's memory.
+    BlobReader::Status status = blob_reader_->ReadView(
+        kReadBufSize, &read_buffer_, &bytes_read_,
+        base::BindOnce(&FileWriterDelegate::OnReadCompleted,
+                       weak_factory_.GetWeakPtr()));
     switch (status) {
       case BlobReader::Status::NET_ERROR:
         OnReadCompleted(blob_reader_->net_error());
@@ -148,6 +149,7 @@ void FileWriterDelegate::Read() {
   }
 
   DCHECK(data_pipe_);
+  read_buffer_ = io_buffer_;
   uint32_t num_bytes = io_buffer_->size();
   MojoResult result = data_pipe_->ReadData(io_buffer_->data(), &num_bytes,
                                            MOJO_READ_DATA_FLAG_NONE);
@@ -179,7 +181,7 @@ void FileWriterDelegate::OnDataReceived(int bytes_read) {
     // that we could read and write at the same time.  It's not yet clear that
     // it's necessary.
     cursor_ =
-        base::MakeRefCounted<net::DrainableIOBuffer>(io_buffer_, bytes_read_);
+        base::MakeRefCounted<net::DrainableIOBuffer>(read_buffer_, bytes_read_);
     Write();
   }
 }
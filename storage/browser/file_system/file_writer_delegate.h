@@ -95,6 +95,9 @@ class COMPONENT_EXPORT(STORAGE_BROWSER) FileWriterDelegate {
   bool async_write_in_progress_ = false;
   base::File::Error saved_read_error_ = base::File::FILE_OK;
   scoped_refptr<net::IOBufferWithSize> io_buffer_;
+  // The buffer the last read went to: |io_buffer_| for data pipes, or a view
+  // returned by BlobReader::ReadView for blobs.
+  scoped_refptr<net::IOBuffer> read_buffer_;
   scoped_refptr<net::DrainableIOBuffer> cursor_;
 
   // Used when reading from a blob.
@@ -58,7 +58,7 @@ GURL::GURL(const char* canonical_spec,
            size_t canonical_spec_len,
            const url::Parsed& parsed,
            bool is_valid)
-    : spec_(canonical_spec, canonical_spec_len),
+    : spec_(std::string(canonical_spec, canonical_spec_len)),
       is_valid_(is_valid),
       parsed_(parsed) {
   InitializeFromCanonicalSpec();
@@ -71,23 +71,23 @@ GURL::GURL(std::string canonical_spec, const url::Parsed& parsed, bool is_valid)
 
 template <typename T, typename CharT>
 void GURL::InitCanonical(T input_spec, bool trim_path_end) {
-  url::StdStringCanonOutput output(&spec_);
+  url::StdStringCanonOutput output(spec_.GetMutable());
   is_valid_ = url::Canonicalize(
       input_spec.data(), static_cast<int>(input_spec.length()), trim_path_end,
       NULL, &output, &parsed_);
 
   output.Complete();  // Must be done before using string.
   if (is_valid_ && SchemeIsFileSystem()) {
-    inner_url_ = std::make_unique<GURL>(spec_.data(), parsed_.Length(),
+    inner_url_ = std::make_unique<GURL>(spec_.get().data(), parsed_.Length(),
                                         *parsed_.inner_parsed(), true);
   }
   // Valid URLs always have non-empty specs.
-  DCHECK(!is_valid_ || !spec_.empty());
+  DCHECK(!is_valid_ || !spec_.get().empty());
 }
 
 void GURL::InitializeFromCanonicalSpec() {
   if (is_valid_ && SchemeIsFileSystem()) {
-    inner_url_ = std::make_unique<GURL>(spec_.data(), parsed_.Length(),
+    inner_url_ = std::make_unique<GURL>(spec_.get().data(), parsed_.Length(),
                                         *parsed_.inner_parsed(), true);
   }
 
@@ -96,22 +96,22 @@ void GURL::InitializeFromCanonicalSpec() {
   // what we would have produced. Skip checking for invalid URLs have no meaning
   // and we can't always canonicalize then reproducibly.
   if (is_valid_) {
-    DCHECK(!spec_.empty());
+    DCHECK(!spec_.get().empty());
     url::Component scheme;
     // We can't do this check on the inner_url of a filesystem URL, as
     // canonical_spec actually points to the start of the outer URL, so we'd
     // end up with infinite recursion in this constructor.
-    if (!url::FindAndCompareScheme(spec_.data(), spec_.length(),
+    if (!url::FindAndCompareScheme(spec_.get().data(), spec_.get().length(),
                                    url::kFileSystemScheme, &scheme) ||
         scheme.begin == parsed_.scheme.begin) {
       // We need to retain trailing whitespace on path URLs, as the |parsed_|
       // spec we originally received may legitimately contain trailing white-
       // space on the path or  components e.g. if the #ref has been
       // removed from a "foo:hello #ref" URL (see http://crbug.com/291747).
-      GURL test_url(spec_, RETAIN_TRAILING_PATH_WHITEPACE);
+      GURL test_url(spec_.get(), RETAIN_TRAILING_PATH_WHITEPACE);
 
       DCHECK(test_url.is_valid_ == is_valid_);
-      DCHECK(test_url.spec_ == spec_);
+      DCHECK(test_url.spec_.get() == spec_.get());
 
       DCHECK(test_url.parsed_.scheme == parsed_.scheme);
       DCHECK(test_url.parsed_.username == parsed_.username);
@@ -155,19 +155,19 @@ GURL& GURL::operator=(GURL&& other) noexcept {
 }
 
 const std::string& GURL::spec() const {
-  if (is_valid_ || spec_.empty())
-    return spec_;
+  if (is_valid_ || spec_.get().empty())
+    return spec_.get();
 
   DCHECK(false) << "Trying to get the spec of an invalid URL!";
   return base::EmptyString();
 }
 
 bool GURL::operator<(const GURL& other) const {
-  return spec_ < other.spec_;
+  return spec_.get() < other.spec_.get();
 }
 
 bool GURL::operator>(const GURL& other) const {
-  return spec_ > other.spec_;
+  return spec_.get() > other.spec_.get();
 }
 
 // Note: code duplicated below (it's inconvenient to use a template here).
@@ -177,9 +177,10 @@ GURL GURL::Resolve(base::StringPiece relative) const {
     return GURL();
 
   GURL result;
-  url::StdStringCanonOutput output(&result.spec_);
-  if (!url::ResolveRelative(spec_.data(), static_cast<int>(spec_.length()),
-                            parsed_, relative.data(),
+  url::StdStringCanonOutput output(result.spec_.GetMutable());
+  if (!url::ResolveRelative(spec_.get().data(),
+                            static_cast<int>(spec_.get().length()), parsed_,
+                            relative.data(),
                             static_cast<int>(relative.length()),
                             nullptr, &output, &result.parsed_)) {
     // Error resolving, return an empty URL.
@@ -189,9 +190,9 @@ GURL GURL::Resolve(base::StringPiece relative) const {
   output.Complete();
   result.is_valid_ = true;
   if (result.SchemeIsFileSystem()) {
-    result.inner_url_ =
-        std::make_unique<GURL>(result.spec_.data(), result.parsed_.Length(),
-                               *result.parsed_.inner_parsed(), true);
+    result.inner_url_ = std::make_unique<GURL>(
+        result.spec_.get().data(), result.parsed_.Length(),
+        *result.parsed_.inner_parsed(), true);
   }
   return result;
 }
@@ -203,9 +204,10 @@ GURL GURL::Resolve(base::StringPiece16 relative) const {
     return GURL();
 
   GURL result;
-  url::StdStringCanonOutput output(&result.spec_);
-  if (!url::ResolveRelative(spec_.data(), static_cast<int>(spec_.length()),
-                            parsed_, relative.data(),
+  url::StdStringCanonOutput output(result.spec_.GetMutable());
+  if (!url::ResolveRelative(spec_.get().data(),
+                            static_cast<int>(spec_.get().length()), parsed_,
+                            relative.data(),
                             static_cast<int>(relative.length()),
                             nullptr, &output, &result.parsed_)) {
     // Error resolving, return an empty URL.
@@ -215,9 +217,9 @@ GURL GURL::Resolve(base::StringPiece16 relative) const {
   output.Complete();
   result.is_valid_ = true;
   if (result.SchemeIsFileSystem()) {
-    result.inner_url_ =
-        std::make_unique<GURL>(result.spec_.data(), result.parsed_.Length(),
-                               *result.parsed_.inner_parsed(), true);
+    result.inner_url_ = std::make_unique<GURL>(
+        result.spec_.get().data(), result.parsed_.Length(),
+        *result.parsed_.inner_parsed(), true);
   }
   return result;
 }
@@ -231,10 +233,10 @@ GURL GURL::ReplaceComponents(
   if (!is_valid_)
     return GURL();
 
-  url::StdStringCanonOutput output(&result.spec_);
+  url::StdStringCanonOutput output(result.spec_.GetMutable());
   result.is_valid_ = url::ReplaceComponents(
-      spec_.data(), static_cast<int>(spec_.length()), parsed_, replacements,
-      NULL, &output, &result.parsed_);
+      spec_.get().data(), static_cast<int>(spec_.get().length()), parsed_,
+      replacements, NULL, &output, &result.parsed_);
 
   output.Complete();
 
@@ -251,10 +253,10 @@ GURL GURL::ReplaceComponents(
   if (!is_valid_)
     return GURL();
 
-  url::StdStringCanonOutput output(&result.spec_);
+  url::StdStringCanonOutput output(result.spec_.GetMutable());
   result.is_valid_ = url::ReplaceComponents(
-      spec_.data(), static_cast<int>(spec_.length()), parsed_, replacements,
-      NULL, &output, &result.parsed_);
+      spec_.get().data(), static_cast<int>(spec_.get().length()), parsed_,
+      replacements, NULL, &output, &result.parsed_);
 
   output.Complete();
 
@@ -267,7 +269,7 @@ void GURL::ProcessFileSystemURLAfterReplaceComponents() {
   if (!is_valid_)
     return;
   if (SchemeIsFileSystem()) {
-    inner_url_ = std::make_unique<GURL>(spec_.data(), parsed_.Length(),
+    inner_url_ = std::make_unique<GURL>(spec_.get().data(), parsed_.Length(),
                                         *parsed_.inner_parsed(), true);
   }
 }
@@ -292,7 +294,7 @@ GURL GURL::DeprecatedGetOriginAsURL() const {
 }
 
 GURL GURL::GetAsReferrer() const {
-  if (!is_valid() || !IsReferrerScheme(spec_.data(), parsed_.scheme))
+  if (!is_valid() || !IsReferrerScheme(spec_.get().data(), parsed_.scheme))
     return GURL();
 
   if (!has_ref() && !has_username() && !has_password())
@@ -323,9 +325,10 @@ GURL GURL::GetWithEmptyPath() const {
 
   // Set the path, since the path is longer than one, we can just set the
   // first character and resize.
-  other.spec_[other.parsed_.path.begin] = '/';
+  std::string* spec = other.spec_.GetMutable();
+  (*spec)[other.parsed_.path.begin] = '/';
   other.parsed_.path.len = 1;
-  other.spec_.resize(other.parsed_.path.begin + 1);
+  spec->resize(other.parsed_.path.begin + 1);
   return other;
 }
 
@@ -334,7 +337,7 @@ GURL GURL::GetWithoutFilename() const {
 }
 
 bool GURL::IsStandard() const {
-  return url::IsStandard(spec_.data(), parsed_.scheme);
+  return url::IsStandard(spec_.get().data(), parsed_.scheme);
 }
 
 bool GURL::IsAboutBlank() const {
@@ -378,21 +381,21 @@ bool GURL::SchemeIsCryptographic(base::StringPiece lower_ascii_scheme) {
 
 int GURL::IntPort() const {
   if (parsed_.port.is_nonempty())
-    return url::ParsePort(spec_.data(), parsed_.port);
+    return url::ParsePort(spec_.get().data(), parsed_.port);
   return url::PORT_UNSPECIFIED;
 }
 
 int GURL::EffectiveIntPort() const {
   int int_port = IntPort();
   if (int_port == url::PORT_UNSPECIFIED && IsStandard())
-    return url::DefaultPortForScheme(spec_.data() + parsed_.scheme.begin,
+    return url::DefaultPortForScheme(spec_.get().data() + parsed_.scheme.begin,
                                      parsed_.scheme.len);
   return int_port;
 }
 
 std::string GURL::ExtractFileName() const {
   url::Component file_component;
-  url::ExtractFileName(spec_.data(), parsed_.path, &file_component);
+  url::ExtractFileName(spec_.get().data(), parsed_.path, &file_component);
   return ComponentString(file_component);
 }
 
@@ -402,7 +405,7 @@ base::StringPiece GURL::PathForRequestPiece() const {
   if (parsed_.ref.len >= 0) {
     // Clip off the reference when it exists. The reference starts after the
     // #-sign, so we have to subtract one to also remove it.
-    return base::StringPiece(&spec_[parsed_.path.begin],
+    return base::StringPiece(&spec_.get()[parsed_.path.begin],
                              parsed_.ref.begin - parsed_.path.begin - 1);
   }
   // Compute the actual path length, rather than depending on the spec's
@@ -412,7 +415,7 @@ base::StringPiece GURL::PathForRequestPiece() const {
   if (parsed_.query.is_valid())
     path_len = parsed_.query.end() - parsed_.path.begin;
 
-  return base::StringPiece(&spec_[parsed_.path.begin], path_len);
+  return base::StringPiece(&spec_.get()[parsed_.path.begin], path_len);
 }
 
 std::string GURL::PathForRequest() const {
@@ -426,7 +429,8 @@ std::string GURL::HostNoBrackets() const {
 base::StringPiece GURL::HostNoBracketsPiece() const {
   // If host looks like an IPv6 literal, strip the square brackets.
   url::Component h(parsed_.host);
-  if (h.len >= 2 && spec_[h.begin] == '[' && spec_[h.end() - 1] == ']') {
+  if (h.len >= 2 && spec_.get()[h.begin] == '[' &&
+      spec_.get()[h.end() - 1] == ']') {
     h.begin++;
     h.len -= 2;
   }
@@ -465,19 +469,25 @@ bool GURL::EqualsIgnoringRef(const GURL& other) const {
   int ref_position = parsed_.CountCharactersBefore(url::Parsed::REF, true);
   int ref_position_other =
       other.parsed_.CountCharactersBefore(url::Parsed::REF, true);
-  return base::StringPiece(spec_).substr(0, ref_position) ==
-         base::StringPiece(other.spec_).substr(0, ref_position_other);
+  return base::StringPiece(spec_.get()).substr(0, ref_position) ==
+         base::StringPiece(other.spec_.get()).substr(0, ref_position_other);
 }
 
 void GURL::Swap(GURL* other) {
-  spec_.swap(other->spec_);
+  std::swap(spec_, other->spec_);
   std::swap(is_valid_, other->is_valid_);
   std::swap(parsed_, other->parsed_);
   inner_url_.swap(other->inner_url_);
 }
 
+void GURL::ShareSpec() {
+  spec_.Share();
+  if (inner_url_)
+    inner_url_->ShareSpec();
+}
+
 size_t GURL::EstimateMemoryUsage() const {
-  return base::trace_event::EstimateMemoryUsage(spec_) +
+  return spec_.EstimateMemoryUsage() +
          base::trace_event::EstimateMemoryUsage(inner_url_) +
          (parsed_.inner_parsed() ? sizeof(url::Parsed) : 0);
 }
@@ -521,7 +531,7 @@ std::ostream& operator<<(std::ostream& out, const GURL& url) {
 }
 
 bool operator==(const GURL& x, const GURL& y) {
-  return x.possibly_invalid_spec() == y.possibly_invalid_spec();
+  return x.spec_.Equals(y.spec_);
 }
 
 bool operator!=(const GURL& x, const GURL& y) {
@@ -15,6 +15,7 @@
 #include "base/debug/alias.h"
 #include "base/strings/string_piece.h"
 #include "third_party/perfetto/include/perfetto/tracing/traced_value_forward.h"
+#include "url/shareable_string.h"
 #include "url/third_party/mozilla/url_parse.h"
 #include "url/url_canon.h"
 #include "url/url_canon_stdstring.h"
@@ -93,7 +94,7 @@ class COMPONENT_EXPORT(URL) GURL {
   // invalid, and is_valid() will return false for them. This is provided
   // because some users may want to treat the empty case differently.
   bool is_empty() const {
-    return spec_.empty();
+    return spec_.get().empty();
   }
 
   // Returns the raw spec, i.e., the full text of the URL, in canonical UTF-8,
@@ -118,7 +119,7 @@ class COMPONENT_EXPORT(URL) GURL {
   //
   // The returned string is guaranteed to be valid UTF-8.
   const std::string& possibly_invalid_spec() const {
-    return spec_;
+    return spec_.get();
   }
 
   // Getter for the raw parsed structure. This allows callers to locate parts
@@ -435,6 +436,13 @@ class COMPONENT_EXPORT(URL) GURL {
     return inner_url_.get();
   }
 
+  // Moves the spec into immutable, reference-counted storage, so that copies
+  // of this GURL, and the copies of those, share it instead of copying it.
+  // Use this for long-lived URLs that are copied a lot. Changing the URL in
+  // place, e.g. with Swap(), doesn't affect the copies.
+  void ShareSpec();
+  bool has_shared_spec() const { return spec_.is_shared(); }
+
   // Estimates dynamic memory usage.
   // See base/trace_event/memory_usage_estimator.h for more info.
   size_t EstimateMemoryUsage() const;
@@ -446,6 +454,9 @@ class COMPONENT_EXPORT(URL) GURL {
   void WriteIntoTrace(perfetto::TracedValue context) const;
 
  private:
+  // Compares the specs without their characters when they're shared.
+  friend bool operator==(const GURL& x, const GURL& y);
+
   // Variant of the string parsing constructor that allows the caller to elect
   // retain trailing whitespace, if any, on the passed URL spec, but only if
   // the scheme is one that allows trailing whitespace. The primary use-case is
@@ -466,18 +477,18 @@ class COMPONENT_EXPORT(URL) GURL {
   std::string ComponentString(const url::Component& comp) const {
     if (comp.len <= 0)
       return std::string();
-    return std::string(spec_, comp.begin, comp.len);
+    return std::string(spec_.get(), comp.begin, comp.len);
   }
   base::StringPiece ComponentStringPiece(const url::Component& comp) const {
     if (comp.len <= 0)
       return base::StringPiece();
-    return base::StringPiece(&spec_[comp.begin], comp.len);
+    return base::StringPiece(&spec_.get()[comp.begin], comp.len);
   }
 
   void ProcessFileSystemURLAfterReplaceComponents();
 
   // The actual text of the URL, in canonical ASCII form.
-  std::string spec_;
+  url::ShareableString spec_;
 
   // Set when the given URL is valid. Otherwise, we may still have a spec and
   // components, but they may not identify valid resources (for example, an
@@ -0,0 +1,83 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <vector>
+
+#include "base/strings/string_piece.h"
+#include "base/test/perf_time_logger.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+#include "url/origin.h"
+
+namespace {
+
+// Compares copying and comparing URLs and origins with their own strings and
+// with shared ones, as in the caches and maps that hold on to them.
+
+constexpr base::StringPiece kUrl =
+    "https://www.example.com/Stephen-King-Thrillers-Horror-People/dp/"
+    "0766012336/ref=sr_1_2/133-4144931-4505264?ie=UTF8&s=books&qid=2144880915";
+
+constexpr int kIterations = 1000000;
+
+void CopyURL(const GURL& url, const char* name) {
+  std::vector<GURL> copies(100);
+  base::PerfTimeLogger timer(name);
+  for (int i = 0; i < kIterations; i++)
+    copies[i % copies.size()] = url;
+  timer.Done();
+  EXPECT_EQ(url, copies[0]);
+}
+
+TEST(GURLPerfTest, Copy) {
+  GURL url(kUrl);
+  CopyURL(url, "GURL_Copy_AMillion");
+  url.ShareSpec();
+  CopyURL(url, "GURL_Copy_Shared_AMillion");
+}
+
+void CompareURLs(const GURL& a, const GURL& b, const char* name) {
+  int equal = 0;
+  base::PerfTimeLogger timer(name);
+  for (int i = 0; i < kIterations; i++)
+    equal += a == b;
+  timer.Done();
+  EXPECT_EQ(kIterations, equal);
+}
+
+TEST(GURLPerfTest, Compare) {
+  GURL url(kUrl);
+  CompareURLs(url, GURL(kUrl), "GURL_Compare_AMillion");
+  url.ShareSpec();
+  const GURL copy = url;
+  CompareURLs(url, copy, "GURL_Compare_Shared_AMillion");
+}
+
+void CopyAndCompareOrigins(const url::Origin& a,
+                           const url::Origin& b,
+                           const char* name) {
+  std::vector<url::Origin> copies(100);
+  int equal = 0;
+  base::PerfTimeLogger timer(name);
+  for (int i = 0; i < kIterations; i++) {
+    url::Origin& copy = copies[i % copies.size()];
+    copy = a;
+    equal += copy == b;
+  }
+  timer.Done();
+  EXPECT_EQ(kIterations, equal);
+}
+
+TEST(GURLPerfTest, Origin) {
+  // Long enough that the host isn't stored inline in the std::string.
+  const GURL url("https://static.assets.example-content-delivery.com/");
+  url::Origin a = url::Origin::Create(url);
+  url::Origin b = url::Origin::Create(url);
+  CopyAndCompareOrigins(a, b, "Origin_Copy_Compare_AMillion");
+  a.InternStrings();
+  b.InternStrings();
+  CopyAndCompareOrigins(a, b, "Origin_Copy_Compare_Interned_AMillion");
+}
+
+}  // namespace
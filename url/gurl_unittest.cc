@@ -208,6 +208,39 @@ TEST(GURLTest, CopyFileSystem) {
   EXPECT_EQ("", inner->ref());
 }
 
+TEST(GURLTest, ShareSpec) {
+  GURL url("filesystem:https://google.com:99/t/foo;bar?q=a#ref");
+  EXPECT_FALSE(url.has_shared_spec());
+  url.ShareSpec();
+  EXPECT_TRUE(url.has_shared_spec());
+  EXPECT_TRUE(url.inner_url()->has_shared_spec());
+  EXPECT_EQ("filesystem:https://google.com:99/t/foo;bar?q=a#ref", url.spec());
+
+  // Copies share the spec, and compare equal to the URLs that don't.
+  GURL copy(url);
+  EXPECT_TRUE(copy.has_shared_spec());
+  EXPECT_EQ(url.spec().data(), copy.spec().data());
+  EXPECT_EQ(url, copy);
+  EXPECT_EQ(GURL(url.spec()), copy);
+  EXPECT_EQ("google.com", copy.inner_url()->host());
+
+  // Derived URLs get their own spec, and the shared one is left alone.
+  EXPECT_EQ("filesystem:https://google.com:99/t/foo;bar?q=a",
+            url.GetWithoutRef().spec());
+  GURL http_url("http://google.com/foo?q=a");
+  http_url.ShareSpec();
+  const GURL empty_path = http_url.GetWithEmptyPath();
+  EXPECT_FALSE(empty_path.has_shared_spec());
+  EXPECT_EQ("http://google.com/", empty_path.spec());
+  EXPECT_EQ("http://google.com/foo?q=a", http_url.spec());
+
+  GURL other("http://example.com/");
+  other.Swap(&copy);
+  EXPECT_TRUE(other.has_shared_spec());
+  EXPECT_FALSE(copy.has_shared_spec());
+  EXPECT_EQ(url, other);
+}
+
 TEST(GURLTest, IsValid) {
   const char* valid_cases[] = {
       "http://google.com",
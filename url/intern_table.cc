@@ -0,0 +1,105 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "url/intern_table.h"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+#include "base/trace_event/memory_allocator_dump.h"
+#include "base/trace_event/memory_dump_manager.h"
+#include "base/trace_event/memory_usage_estimator.h"
+#include "base/trace_event/process_memory_dump.h"
+
+namespace url {
+
+namespace {
+
+// The table isn't purged before it has this many strings.
+constexpr size_t kMinPurgeThreshold = 256;
+
+}  // namespace
+
+// static
+InternTable* InternTable::GetInstance() {
+  static base::NoDestructor<InternTable> instance;
+  return instance.get();
+}
+
+InternTable::InternTable() : purge_threshold_(kMinPurgeThreshold) {
+  base::trace_event::MemoryDumpManager::GetInstance()->RegisterDumpProvider(
+      this, "UrlInternTable", nullptr);
+}
+
+InternTable::~InternTable() = default;
+
+ShareableString InternTable::Intern(base::StringPiece value) {
+  base::AutoLock lock(lock_);
+  auto it = strings_.find(value);
+  if (it != strings_.end())
+    return ShareableString(it->second);
+
+  if (strings_.size() >= purge_threshold_) {
+    PurgeLocked();
+    purge_threshold_ = std::max(kMinPurgeThreshold, 2 * strings_.size());
+  }
+  scoped_refptr<const ShareableString::Data> data =
+      base::MakeRefCounted<ShareableString::Data>(std::string(value));
+  strings_.emplace(data->value(), data);
+  return ShareableString(std::move(data));
+}
+
+void InternTable::Purge() {
+  base::AutoLock lock(lock_);
+  PurgeLocked();
+}
+
+size_t InternTable::size() const {
+  base::AutoLock lock(lock_);
+  return strings_.size();
+}
+
+bool InternTable::OnMemoryDump(const base::trace_event::MemoryDumpArgs& args,
+                               base::trace_event::ProcessMemoryDump* pmd) {
+  size_t table_size;
+  size_t table_count;
+  {
+    base::AutoLock lock(lock_);
+    // The strings themselves are part of the shared strings below.
+    table_size = base::trace_event::EstimateHashMapMemoryUsage<
+        decltype(strings_)::value_type>(strings_.bucket_count(),
+                                        strings_.size());
+    table_count = strings_.size();
+  }
+  base::trace_event::MemoryAllocatorDump* dump =
+      pmd->CreateAllocatorDump("url/intern_table");
+  dump->AddScalar(base::trace_event::MemoryAllocatorDump::kNameSize,
+                  base::trace_event::MemoryAllocatorDump::kUnitsBytes,
+                  table_size);
+  dump->AddScalar(base::trace_event::MemoryAllocatorDump::kNameObjectCount,
+                  base::trace_event::MemoryAllocatorDump::kUnitsObjects,
+                  table_count);
+
+  // The storage of all shared strings, interned or not.
+  dump = pmd->CreateAllocatorDump("url/shared_strings");
+  dump->AddScalar(base::trace_event::MemoryAllocatorDump::kNameSize,
+                  base::trace_event::MemoryAllocatorDump::kUnitsBytes,
+                  ShareableString::Data::GetLiveBytes());
+  dump->AddScalar(base::trace_event::MemoryAllocatorDump::kNameObjectCount,
+                  base::trace_event::MemoryAllocatorDump::kUnitsObjects,
+                  ShareableString::Data::GetLiveCount());
+  return true;
+}
+
+void InternTable::PurgeLocked() {
+  for (auto it = strings_.begin(); it != strings_.end();) {
+    if (it->second->HasOneRef())
+      it = strings_.erase(it);
+    else
+      ++it;
+  }
+}
+
+}  // namespace url
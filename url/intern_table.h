@@ -0,0 +1,78 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef URL_INTERN_TABLE_H_
+#define URL_INTERN_TABLE_H_
+
+#include <stddef.h>
+
+#include <unordered_map>
+
+#include "base/component_export.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/no_destructor.h"
+#include "base/strings/string_piece.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
+#include "base/trace_event/memory_dump_provider.h"
+#include "url/shareable_string.h"
+
+namespace url {
+
+// A process-wide table of shared strings, so that equal strings that are
+// interned share one copy. The schemes and hosts of origins and sites repeat
+// a lot in a process, and are copied and compared often, so they're interned
+// by SchemeHostPort::InternStrings() and its callers.
+//
+// Strings stay in the table while they're in use outside of it. The unused
+// ones are dropped when the table has doubled in size since the last time,
+// or when Purge() is called.
+//
+// Also reports the memory used by the table and by all shared strings to
+// memory-infra. This class is thread-safe.
+class COMPONENT_EXPORT(URL) InternTable
+    : public base::trace_event::MemoryDumpProvider {
+ public:
+  static InternTable* GetInstance();
+
+  InternTable(const InternTable&) = delete;
+  InternTable& operator=(const InternTable&) = delete;
+
+  // Returns a shared string equal to |value|, which shares its storage with
+  // the other strings interned with the same value.
+  ShareableString Intern(base::StringPiece value);
+
+  // Drops the strings that are only referenced by the table.
+  void Purge();
+
+  // Returns the number of strings in the table.
+  size_t size() const;
+
+  // MemoryDumpProvider implementation.
+  bool OnMemoryDump(const base::trace_event::MemoryDumpArgs& args,
+                    base::trace_event::ProcessMemoryDump* pmd) override;
+
+ private:
+  friend class base::NoDestructor<InternTable>;
+
+  InternTable();
+  ~InternTable() override;
+
+  void PurgeLocked() EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  mutable base::Lock lock_;
+
+  // The keys point into the values.
+  std::unordered_map<base::StringPiece,
+                     scoped_refptr<const ShareableString::Data>,
+                     base::StringPieceHash>
+      strings_ GUARDED_BY(lock_);
+
+  // The size of the table that triggers the next purge.
+  size_t purge_threshold_ GUARDED_BY(lock_);
+};
+
+}  // namespace url
+
+#endif  // URL_INTERN_TABLE_H_
@@ -284,6 +284,10 @@ class COMPONENT_EXPORT(URL) Origin {
   // |d|, and |d| is cross-origin to |a| and |c|.
   Origin DeriveNewOpaqueOrigin() const;
 
+  // Interns the scheme and host, or those of the precursor of an opaque
+  // origin. See SchemeHostPort::InternStrings().
+  void InternStrings() { tuple_.InternStrings(); }
+
   // Creates a string representation of the object that can be used for logging
   // and debugging. It serializes the internal state, such as the nonce value
   // and precursor information.
@@ -17,6 +17,7 @@
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_piece.h"
 #include "url/gurl.h"
+#include "url/intern_table.h"
 #include "url/third_party/mozilla/url_parse.h"
 #include "url/url_canon.h"
 #include "url/url_canon_stdstring.h"
@@ -151,11 +152,11 @@ SchemeHostPort::SchemeHostPort(std::string scheme,
     return;
   }
 
-  scheme_ = std::move(scheme);
-  host_ = std::move(host);
+  scheme_ = ShareableString(std::move(scheme));
+  host_ = ShareableString(std::move(host));
   port_ = port;
-  DCHECK(IsValid()) << "Scheme: " << scheme_ << " Host: " << host_
-                    << " Port: " << port;
+  DCHECK(IsValid()) << "Scheme: " << scheme_.get()
+                    << " Host: " << host_.get() << " Port: " << port;
 }
 
 SchemeHostPort::SchemeHostPort(base::StringPiece scheme,
@@ -185,19 +186,27 @@ SchemeHostPort::SchemeHostPort(const GURL& url) {
   if (!IsValidInput(scheme, host, port, ALREADY_CANONICALIZED))
     return;
 
-  scheme_ = std::string(scheme);
-  host_ = std::string(host);
+  scheme_ = ShareableString(std::string(scheme));
+  host_ = ShareableString(std::string(host));
   port_ = port;
 }
 
 SchemeHostPort::~SchemeHostPort() = default;
 
+void SchemeHostPort::InternStrings() {
+  if (!IsValid())
+    return;
+  InternTable* table = InternTable::GetInstance();
+  scheme_ = table->Intern(scheme());
+  host_ = table->Intern(host());
+}
+
 bool SchemeHostPort::IsValid() const {
   // It suffices to just check |scheme_| for emptiness; the other fields are
   // never present without it.
-  DCHECK(!scheme_.empty() || host_.empty());
-  DCHECK(!scheme_.empty() || port_ == 0);
-  return !scheme_.empty();
+  DCHECK(!scheme().empty() || host().empty());
+  DCHECK(!scheme().empty() || port_ == 0);
+  return !scheme().empty();
 }
 
 std::string SchemeHostPort::Serialize() const {
@@ -216,8 +225,8 @@ GURL SchemeHostPort::GetURL() const {
 
   // SchemeHostPort does not have enough information to determine if an empty
   // host is valid or not for the given scheme. Force re-parsing.
-  DCHECK(!scheme_.empty());
-  if (host_.empty())
+  DCHECK(!scheme().empty());
+  if (host().empty())
     return GURL(serialized);
 
   // If the serialized string is passed to GURL for parsing, it will append an
@@ -230,8 +239,8 @@ GURL SchemeHostPort::GetURL() const {
 }
 
 bool SchemeHostPort::operator<(const SchemeHostPort& other) const {
-  return std::tie(port_, scheme_, host_) <
-         std::tie(other.port_, other.scheme_, other.host_);
+  return std::tie(port_, scheme(), host()) <
+         std::tie(other.port_, other.scheme(), other.host());
 }
 
 std::string SchemeHostPort::SerializeInternal(url::Parsed* parsed) const {
@@ -240,24 +249,24 @@ std::string SchemeHostPort::SerializeInternal(url::Parsed* parsed) const {
     return result;
 
   // Reserve enough space for the "normal" case of scheme://host/.
-  result.reserve(scheme_.size() + host_.size() + 4);
+  result.reserve(scheme().size() + host().size() + 4);
 
-  if (!scheme_.empty()) {
-    parsed->scheme = Component(0, scheme_.length());
-    result.append(scheme_);
+  if (!scheme().empty()) {
+    parsed->scheme = Component(0, scheme().length());
+    result.append(scheme());
   }
 
   result.append(kStandardSchemeSeparator);
 
-  if (!host_.empty()) {
-    parsed->host = Component(result.length(), host_.length());
-    result.append(host_);
+  if (!host().empty()) {
+    parsed->host = Component(result.length(), host().length());
+    result.append(host());
   }
 
   // Omit the port component if the port matches with the default port
   // defined for the scheme, if any.
-  int default_port = DefaultPortForScheme(scheme_.data(),
-                                          static_cast<int>(scheme_.length()));
+  int default_port = DefaultPortForScheme(scheme().data(),
+                                          static_cast<int>(scheme().length()));
   if (default_port == PORT_UNSPECIFIED)
     return result;
   if (port_ != default_port) {
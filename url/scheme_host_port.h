@@ -11,6 +11,7 @@
 
 #include "base/component_export.h"
 #include "base/strings/string_piece.h"
+#include "url/shareable_string.h"
 
 class GURL;
 
@@ -119,11 +120,18 @@ class COMPONENT_EXPORT(URL) SchemeHostPort {
   // Returns the host component, in URL form. That is all IDN domain names will
   // be expressed as A-Labels ('☃.net' will be returned as 'xn--n3h.net'), and
   // and all IPv6 addresses will be enclosed in brackets ("[2001:db8::1]").
-  const std::string& host() const { return host_; }
-  const std::string& scheme() const { return scheme_; }
+  const std::string& host() const { return host_.get(); }
+  const std::string& scheme() const { return scheme_.get(); }
   uint16_t port() const { return port_; }
   bool IsValid() const;
 
+  // Replaces the scheme and host with their interned copies from
+  // InternTable, so that the copies of this object share them with each
+  // other and with the other interned objects with the same scheme and host,
+  // and compare equal to those without comparing the strings. Use this for
+  // long-lived objects that are copied or compared a lot.
+  void InternStrings();
+
   // Serializes the SchemeHostPort tuple to a canonical form.
   //
   // While this string form resembles the Origin serialization specified in
@@ -143,8 +151,8 @@ class COMPONENT_EXPORT(URL) SchemeHostPort {
   // In particular, invalid SchemeHostPort objects match each other (and
   // themselves). Opaque origins, on the other hand, would not.
   bool operator==(const SchemeHostPort& other) const {
-    return port_ == other.port() && scheme_ == other.scheme() &&
-           host_ == other.host();
+    return port_ == other.port_ && scheme_.Equals(other.scheme_) &&
+           host_.Equals(other.host_);
   }
   bool operator!=(const SchemeHostPort& other) const {
     return !(*this == other);
@@ -156,8 +164,8 @@ class COMPONENT_EXPORT(URL) SchemeHostPort {
  private:
   std::string SerializeInternal(url::Parsed* parsed) const;
 
-  std::string scheme_;
-  std::string host_;
+  ShareableString scheme_;
+  ShareableString host_;
   uint16_t port_ = 0;
 };
 
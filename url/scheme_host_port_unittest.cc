@@ -274,6 +274,24 @@ TEST_F(SchemeHostPortTest, Comparison) {
   }
 }
 
+TEST_F(SchemeHostPortTest, InternStrings) {
+  url::SchemeHostPort a("https", "www.example.com", 443);
+  url::SchemeHostPort b("https", "www.example.com", 443);
+  a.InternStrings();
+  b.InternStrings();
+  EXPECT_EQ(a.host().data(), b.host().data());
+  EXPECT_EQ(a.scheme().data(), b.scheme().data());
+  EXPECT_EQ(a, b);
+  EXPECT_EQ(a, url::SchemeHostPort("https", "www.example.com", 443));
+  EXPECT_NE(a, url::SchemeHostPort("https", "www.example.com", 8443));
+  EXPECT_EQ("https://www.example.com", a.Serialize());
+  EXPECT_EQ(GURL("https://www.example.com/"), a.GetURL());
+
+  url::SchemeHostPort invalid;
+  invalid.InternStrings();
+  EXPECT_FALSE(invalid.IsValid());
+}
+
 // Some schemes have optional authority. Make sure that GURL conversion from
 // SchemeHostPort is not opinionated in that regard. For more info, See
 // crbug.com/820194, where we considered all SchemeHostPorts with
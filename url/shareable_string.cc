@@ -0,0 +1,85 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "url/shareable_string.h"
+
+#include <atomic>
+#include <utility>
+
+#include "base/trace_event/memory_usage_estimator.h"
+
+namespace url {
+
+namespace {
+
+std::atomic<size_t> g_live_count{0};
+std::atomic<size_t> g_live_bytes{0};
+
+size_t GetDataSize(const std::string& value) {
+  return sizeof(ShareableString::Data) +
+         base::trace_event::EstimateMemoryUsage(value);
+}
+
+}  // namespace
+
+ShareableString::Data::Data(std::string value) : value_(std::move(value)) {
+  g_live_count.fetch_add(1, std::memory_order_relaxed);
+  g_live_bytes.fetch_add(GetDataSize(value_), std::memory_order_relaxed);
+}
+
+ShareableString::Data::~Data() {
+  g_live_count.fetch_sub(1, std::memory_order_relaxed);
+  g_live_bytes.fetch_sub(GetDataSize(value_), std::memory_order_relaxed);
+}
+
+// static
+size_t ShareableString::Data::GetLiveCount() {
+  return g_live_count.load(std::memory_order_relaxed);
+}
+
+// static
+size_t ShareableString::Data::GetLiveBytes() {
+  return g_live_bytes.load(std::memory_order_relaxed);
+}
+
+ShareableString::ShareableString() = default;
+
+ShareableString::ShareableString(std::string value)
+    : owned_(std::move(value)) {}
+
+ShareableString::ShareableString(scoped_refptr<const Data> data)
+    : data_(std::move(data)) {}
+
+ShareableString::ShareableString(const ShareableString& other) = default;
+
+ShareableString::ShareableString(ShareableString&& other) noexcept = default;
+
+ShareableString::~ShareableString() = default;
+
+ShareableString& ShareableString::operator=(const ShareableString& other) =
+    default;
+
+ShareableString& ShareableString::operator=(ShareableString&& other) noexcept =
+    default;
+
+std::string* ShareableString::GetMutable() {
+  if (data_) {
+    owned_ = data_->value();
+    data_ = nullptr;
+  }
+  return &owned_;
+}
+
+void ShareableString::Share() {
+  if (data_)
+    return;
+  data_ = base::MakeRefCounted<Data>(std::move(owned_));
+  owned_.clear();
+}
+
+size_t ShareableString::EstimateMemoryUsage() const {
+  return base::trace_event::EstimateMemoryUsage(owned_);
+}
+
+}  // namespace url
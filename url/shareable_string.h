@@ -0,0 +1,93 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef URL_SHAREABLE_STRING_H_
+#define URL_SHAREABLE_STRING_H_
+
+#include <stddef.h>
+
+#include <string>
+
+#include "base/component_export.h"
+#include "base/memory/ref_counted.h"
+
+namespace url {
+
+// A string that starts out owned, like a std::string, and can be moved into
+// immutable, reference-counted storage with Share(). Copying a shared string
+// only adds a reference, so the URL types that are copied a lot, such as the
+// spec of a GURL or the host of an Origin, can opt into sharing once they're
+// built. The string is copied out of the shared storage again the first time
+// it's changed with GetMutable().
+//
+// Sharing is thread-safe, but a ShareableString itself is not.
+class COMPONENT_EXPORT(URL) ShareableString {
+ public:
+  // The immutable storage of shared strings.
+  class COMPONENT_EXPORT(URL) Data
+      : public base::RefCountedThreadSafe<Data> {
+   public:
+    explicit Data(std::string value);
+    Data(const Data&) = delete;
+    Data& operator=(const Data&) = delete;
+
+    const std::string& value() const { return value_; }
+
+    // The memory used by the storage of shared strings still alive in the
+    // process, for memory-infra.
+    static size_t GetLiveCount();
+    static size_t GetLiveBytes();
+
+   private:
+    friend class base::RefCountedThreadSafe<Data>;
+    ~Data();
+
+    const std::string value_;
+  };
+
+  ShareableString();
+  explicit ShareableString(std::string value);
+  explicit ShareableString(scoped_refptr<const Data> data);
+  ShareableString(const ShareableString& other);
+  ShareableString(ShareableString&& other) noexcept;
+  ~ShareableString();
+
+  ShareableString& operator=(const ShareableString& other);
+  ShareableString& operator=(ShareableString&& other) noexcept;
+
+  const std::string& get() const { return data_ ? data_->value() : owned_; }
+
+  // Returns the string for changing it in place, after copying it out of the
+  // shared storage if it's shared.
+  std::string* GetMutable();
+
+  // Moves the string into shared storage, if it isn't there already.
+  void Share();
+
+  bool is_shared() const { return !!data_; }
+
+  // Returns true if this and |other| are the same shared string, in which
+  // case they're equal without comparing their characters.
+  bool SharesWith(const ShareableString& other) const {
+    return data_ && data_ == other.data_;
+  }
+
+  // Compares the characters unless SharesWith(other).
+  bool Equals(const ShareableString& other) const {
+    return SharesWith(other) || get() == other.get();
+  }
+
+  // Returns the memory owned by this string. The storage of a shared string
+  // is accounted for by the process-wide totals of Data instead.
+  size_t EstimateMemoryUsage() const;
+
+ private:
+  // Empty when |data_| is set.
+  std::string owned_;
+  scoped_refptr<const Data> data_;
+};
+
+}  // namespace url
+
+#endif  // URL_SHAREABLE_STRING_H_
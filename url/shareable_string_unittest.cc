@@ -0,0 +1,119 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "url/shareable_string.h"
+
+#include <string>
+#include <utility>
+
+#include "base/trace_event/memory_allocator_dump.h"
+#include "base/trace_event/process_memory_dump.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/intern_table.h"
+
+namespace url {
+
+namespace {
+
+TEST(ShareableStringTest, Share) {
+  ShareableString string(std::string("https://www.example.com/"));
+  EXPECT_FALSE(string.is_shared());
+  const size_t live_count = ShareableString::Data::GetLiveCount();
+
+  string.Share();
+  EXPECT_TRUE(string.is_shared());
+  EXPECT_EQ("https://www.example.com/", string.get());
+  EXPECT_EQ(live_count + 1, ShareableString::Data::GetLiveCount());
+  EXPECT_EQ(0u, string.EstimateMemoryUsage());
+
+  ShareableString copy(string);
+  EXPECT_TRUE(copy.SharesWith(string));
+  EXPECT_EQ(string.get().data(), copy.get().data());
+  EXPECT_EQ(live_count + 1, ShareableString::Data::GetLiveCount());
+
+  ShareableString moved(std::move(copy));
+  EXPECT_TRUE(moved.SharesWith(string));
+
+  // Changing a shared string copies it out of the shared storage first.
+  moved.GetMutable()->append("path");
+  EXPECT_FALSE(moved.is_shared());
+  EXPECT_EQ("https://www.example.com/path", moved.get());
+  EXPECT_EQ("https://www.example.com/", string.get());
+
+  string = ShareableString();
+  EXPECT_EQ(live_count, ShareableString::Data::GetLiveCount());
+}
+
+TEST(ShareableStringTest, Equals) {
+  ShareableString a(std::string("example.com"));
+  ShareableString b(std::string("example.com"));
+  ShareableString c(std::string("example.org"));
+  EXPECT_TRUE(a.Equals(b));
+  EXPECT_FALSE(a.Equals(c));
+  EXPECT_FALSE(a.SharesWith(b));
+
+  a.Share();
+  EXPECT_TRUE(a.Equals(b));
+  EXPECT_FALSE(a.SharesWith(b));
+  b = a;
+  EXPECT_TRUE(a.SharesWith(b));
+  EXPECT_TRUE(a.Equals(b));
+
+  // Unshared empty strings don't share anything.
+  EXPECT_FALSE(ShareableString().SharesWith(ShareableString()));
+  EXPECT_TRUE(ShareableString().Equals(ShareableString()));
+}
+
+TEST(InternTableTest, Intern) {
+  InternTable* table = InternTable::GetInstance();
+  ShareableString a = table->Intern("intern-table-test.example");
+  ShareableString b = table->Intern(std::string("intern-table-test.example"));
+  ShareableString c = table->Intern("intern-table-test.example.org");
+  EXPECT_TRUE(a.SharesWith(b));
+  EXPECT_FALSE(a.SharesWith(c));
+  EXPECT_EQ("intern-table-test.example", a.get());
+  EXPECT_EQ("intern-table-test.example.org", c.get());
+}
+
+TEST(InternTableTest, Purge) {
+  InternTable* table = InternTable::GetInstance();
+  table->Purge();
+  const size_t size = table->size();
+
+  ShareableString kept = table->Intern("kept.example");
+  table->Intern("dropped.example");
+  EXPECT_EQ(size + 2, table->size());
+
+  table->Purge();
+  EXPECT_EQ(size + 1, table->size());
+  EXPECT_TRUE(kept.SharesWith(table->Intern("kept.example")));
+}
+
+TEST(InternTableTest, PurgesWhenFull) {
+  InternTable* table = InternTable::GetInstance();
+  table->Purge();
+  for (int i = 0; i < 10000; ++i)
+    table->Intern("unused" + std::to_string(i) + ".example");
+  // The unused strings are dropped as the table grows.
+  EXPECT_LT(table->size(), 1000u);
+}
+
+TEST(InternTableTest, OnMemoryDump) {
+  ShareableString interned =
+      InternTable::GetInstance()->Intern("memory-dump.example");
+
+  base::trace_event::MemoryDumpArgs args = {
+      base::trace_event::MemoryDumpLevelOfDetail::DETAILED};
+  base::trace_event::ProcessMemoryDump pmd(args);
+  ASSERT_TRUE(InternTable::GetInstance()->OnMemoryDump(args, &pmd));
+  ASSERT_TRUE(pmd.GetAllocatorDump("url/intern_table"));
+  const base::trace_event::MemoryAllocatorDump* shared =
+      pmd.GetAllocatorDump("url/shared_strings");
+  ASSERT_TRUE(shared);
+  EXPECT_LE(interned.get().size(), shared->GetSizeInternal());
+}
+
+}  // namespace
+
+}  // namespace url
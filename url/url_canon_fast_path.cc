@@ -0,0 +1,166 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "url/url_canon_fast_path.h"
+
+#include "base/bits.h"
+#include "build/build_config.h"
+
+#if defined(ARCH_CPU_X86_FAMILY) && !defined(OS_NACL)
+// Include order is important, so we disable formatting.
+// clang-format off
+#include <immintrin.h>
+#include <tmmintrin.h>
+// clang-format on
+#include "base/cpu.h"
+#define URL_CANON_FAST_PATH_SSSE3
+#if defined(ARCH_CPU_X86_64)
+#include <avxintrin.h>
+#include <avx2intrin.h>
+#define URL_CANON_FAST_PATH_AVX2
+#endif
+#elif defined(ARCH_CPU_ARM64)
+#include <arm_neon.h>
+#define URL_CANON_FAST_PATH_NEON
+#endif
+
+namespace url {
+
+namespace {
+
+// The vectorized kernels split each character into its low and high nibbles,
+// look up the row of the set for the low nibble and the bit for the high
+// nibble with byte shuffles, and test one against the other. The bit is 0 for
+// non-ASCII characters, whose high nibble is 8 or more.
+
+size_t CountLeadingCharsInSetPortable(const char* src,
+                                      size_t length,
+                                      const CanonCharSet& set) {
+  size_t i = 0;
+  while (i < length && set.Contains(static_cast<unsigned char>(src[i])))
+    ++i;
+  return i;
+}
+
+#if defined(URL_CANON_FAST_PATH_SSSE3)
+
+// Like base::CPU::CanUseAVX2(), for the SSSE3 kernels.
+bool HasSSSE3() {
+  static const bool has_ssse3 =
+      base::CPU::GetInstanceNoAllocation().has_ssse3();
+  return has_ssse3;
+}
+
+__attribute__((target("ssse3"))) size_t CountLeadingCharsInSetSsse3(
+    const char* src,
+    size_t length,
+    const CanonCharSet& set) {
+  const __m128i rows =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(set.rows()));
+  const __m128i high_nibble_bits =
+      _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0);
+  const __m128i nibble_mask = _mm_set1_epi8(0x0F);
+  size_t i = 0;
+  for (; i + sizeof(__m128i) <= length; i += sizeof(__m128i)) {
+    const __m128i chars =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    const __m128i low = _mm_and_si128(chars, nibble_mask);
+    const __m128i high = _mm_and_si128(_mm_srli_epi16(chars, 4), nibble_mask);
+    const __m128i in_set =
+        _mm_and_si128(_mm_shuffle_epi8(rows, low),
+                      _mm_shuffle_epi8(high_nibble_bits, high));
+    // The bits of the characters that are not in the set.
+    const int mask =
+        _mm_movemask_epi8(_mm_cmpeq_epi8(in_set, _mm_setzero_si128()));
+    if (mask) {
+      return i + base::bits::CountTrailingZeroBits(static_cast<uint32_t>(mask));
+    }
+  }
+  return i + CountLeadingCharsInSetPortable(src + i, length - i, set);
+}
+
+#endif  // defined(URL_CANON_FAST_PATH_SSSE3)
+
+#if defined(URL_CANON_FAST_PATH_AVX2)
+
+// The shuffles work within each 128-bit lane, so the tables are in both.
+__attribute__((target("avx2"))) size_t CountLeadingCharsInSetAvx2(
+    const char* src,
+    size_t length,
+    const CanonCharSet& set) {
+  const __m256i rows = _mm256_broadcastsi128_si256(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(set.rows())));
+  const __m256i high_nibble_bits = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0));
+  const __m256i nibble_mask = _mm256_set1_epi8(0x0F);
+  size_t i = 0;
+  for (; i + sizeof(__m256i) <= length; i += sizeof(__m256i)) {
+    const __m256i chars =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    const __m256i low = _mm256_and_si256(chars, nibble_mask);
+    const __m256i high =
+        _mm256_and_si256(_mm256_srli_epi16(chars, 4), nibble_mask);
+    const __m256i in_set =
+        _mm256_and_si256(_mm256_shuffle_epi8(rows, low),
+                         _mm256_shuffle_epi8(high_nibble_bits, high));
+    const int mask = _mm256_movemask_epi8(
+        _mm256_cmpeq_epi8(in_set, _mm256_setzero_si256()));
+    if (mask) {
+      return i + base::bits::CountTrailingZeroBits(static_cast<uint32_t>(mask));
+    }
+  }
+  // Avoids the penalty for mixing VEX-encoded and legacy SSE instructions.
+  _mm256_zeroupper();
+  return i + CountLeadingCharsInSetSsse3(src + i, length - i, set);
+}
+
+#endif  // defined(URL_CANON_FAST_PATH_AVX2)
+
+#if defined(URL_CANON_FAST_PATH_NEON)
+
+size_t CountLeadingCharsInSetNeon(const char* src,
+                                  size_t length,
+                                  const CanonCharSet& set) {
+  const uint8x16_t rows = vld1q_u8(set.rows());
+  static const uint8_t kHighNibbleBits[16] = {1,  2,  4,  8,  16, 32, 64, 128,
+                                              0,  0,  0,  0,  0,  0,  0,  0};
+  const uint8x16_t high_nibble_bits = vld1q_u8(kHighNibbleBits);
+  size_t i = 0;
+  for (; i + sizeof(uint8x16_t) <= length; i += sizeof(uint8x16_t)) {
+    const uint8x16_t chars =
+        vld1q_u8(reinterpret_cast<const uint8_t*>(src + i));
+    const uint8x16_t low = vandq_u8(chars, vdupq_n_u8(0x0F));
+    const uint8x16_t high = vshrq_n_u8(chars, 4);
+    // Lanes are 0xFF for the characters in the set.
+    const uint8x16_t in_set = vtstq_u8(vqtbl1q_u8(rows, low),
+                                       vqtbl1q_u8(high_nibble_bits, high));
+    if (vminvq_u8(in_set) != 0xFF)
+      break;
+  }
+  return i + CountLeadingCharsInSetPortable(src + i, length - i, set);
+}
+
+#endif  // defined(URL_CANON_FAST_PATH_NEON)
+
+}  // namespace
+
+size_t CountLeadingCharsInSet(const char* src,
+                              size_t length,
+                              const CanonCharSet& set) {
+#if defined(URL_CANON_FAST_PATH_AVX2)
+  if (base::CPU::CanUseAVX2())
+    return CountLeadingCharsInSetAvx2(src, length, set);
+#endif
+#if defined(URL_CANON_FAST_PATH_SSSE3)
+  if (HasSSSE3())
+    return CountLeadingCharsInSetSsse3(src, length, set);
+  return CountLeadingCharsInSetPortable(src, length, set);
+#elif defined(URL_CANON_FAST_PATH_NEON)
+  return CountLeadingCharsInSetNeon(src, length, set);
+#else
+  return CountLeadingCharsInSetPortable(src, length, set);
+#endif
+}
+
+}  // namespace url
@@ -0,0 +1,83 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Fast paths for the canonicalizers. Most URLs are plain ASCII, and most of
+// their characters canonicalize to themselves, so the canonicalizers copy the
+// runs of those characters to the output in one go, after finding them with a
+// vectorized scan, and only go through the rest one character at a time.
+//
+// The best available SIMD extension is picked at runtime on x86 (AVX2 or
+// SSSE3, for their byte shuffles) and at compile time elsewhere (NEON on
+// ARM64, or a table lookup per character).
+
+#ifndef URL_URL_CANON_FAST_PATH_H_
+#define URL_URL_CANON_FAST_PATH_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "base/component_export.h"
+#include "url/url_canon.h"
+
+namespace url {
+
+// A set of ASCII characters, laid out for the vectorized lookups of
+// CountLeadingCharsInSet(): bit n of rows_[c & 0xF] is set if the character c
+// with c >> 4 == n is in the set. Sets are built at compile time from the
+// canonicalizers' lookup tables.
+class CanonCharSet {
+ public:
+  // Returns the set of the ASCII characters |c| for which |is_in_set(c)|.
+  template <typename Predicate>
+  static constexpr CanonCharSet FromPredicate(Predicate is_in_set) {
+    CanonCharSet set;
+    for (int c = 0; c < 0x80; ++c) {
+      if (is_in_set(static_cast<unsigned char>(c)))
+        set.rows_[c & 0xF] |= static_cast<uint8_t>(1 << (c >> 4));
+    }
+    return set;
+  }
+
+  constexpr bool Contains(unsigned char c) const {
+    return c < 0x80 && (rows_[c & 0xF] & (1 << (c >> 4)));
+  }
+
+  const uint8_t* rows() const { return rows_; }
+
+ private:
+  uint8_t rows_[16] = {};
+};
+
+// Returns the number of leading characters of the |length| characters at
+// |src| that are in |set|.
+COMPONENT_EXPORT(URL)
+size_t CountLeadingCharsInSet(const char* src,
+                              size_t length,
+                              const CanonCharSet& set);
+
+// Appends the characters of |spec| from |*begin| up to |end| that are in |set|
+// to |output| in one go, and advances |*begin| past them. Nothing is done for
+// 16-bit input or output, which take the per-character paths.
+inline void AppendCharsInSet(const char* spec,
+                             int* begin,
+                             int end,
+                             const CanonCharSet& set,
+                             CanonOutput* output) {
+  const int count = static_cast<int>(
+      CountLeadingCharsInSet(spec + *begin, end - *begin, set));
+  if (count) {
+    output->Append(spec + *begin, count);
+    *begin += count;
+  }
+}
+template <typename CHAR, typename OUTCHAR>
+inline void AppendCharsInSet(const CHAR* spec,
+                             int* begin,
+                             int end,
+                             const CanonCharSet& set,
+                             CanonOutputT<OUTCHAR>* output) {}
+
+}  // namespace url
+
+#endif  // URL_URL_CANON_FAST_PATH_H_
@@ -7,6 +7,7 @@
 #include "base/check.h"
 #include "base/metrics/histogram_macros.h"
 #include "url/url_canon.h"
+#include "url/url_canon_fast_path.h"
 #include "url/url_canon_internal.h"
 
 namespace url {
@@ -53,7 +54,7 @@ namespace {
 // based on how many times you run the canonicalizer. We prefer to always report
 // the same vailidity, so reject this.
 const unsigned char kEsc = 0xff;
-const unsigned char kHostCharLookup[0x80] = {
+constexpr unsigned char kHostCharLookup[0x80] = {
 // 00-1f: all are invalid
      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
@@ -70,6 +71,13 @@ const unsigned char kHostCharLookup[0x80] = {
 //   p    q    r    s    t    u    v    w    x    y    z    {    |    }    ~
     'p', 'q', 'r', 's', 't', 'u', 'v', 'w', 'x', 'y', 'z',kEsc,kEsc,kEsc,  0 ,  0 };
 
+// The characters that are already canonical, and are copied to the output
+// unchanged. Invalid characters map to 0, so NUL is left out explicitly.
+constexpr CanonCharSet kCanonicalHostChars =
+    CanonCharSet::FromPredicate([](unsigned char c) {
+      return kHostCharLookup[c] != 0 && kHostCharLookup[c] == c;
+    });
+
 // RFC1034 maximum FQDN length.
 constexpr int kMaxHostLength = 253;
 
@@ -136,6 +144,10 @@ bool DoSimpleHost(const INCHAR* host,
 
   bool success = true;
   for (int i = 0; i < host_len; ++i) {
+    // Copy the run of characters that are already canonical first.
+    AppendCharsInSet(host, &i, host_len, kCanonicalHostChars, output);
+    if (i == host_len)
+      break;
     unsigned int source = host[i];
     if (source == '%') {
       // Unescape first, if possible.
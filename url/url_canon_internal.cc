@@ -108,7 +108,7 @@ bool PrepareUTF16OverrideComponent(const char16_t* override_source,
 }  // namespace
 
 // See the header file for this array's declaration.
-const unsigned char kSharedCharTypeTable[0x100] = {
+constexpr unsigned char kSharedCharTypeTable[0x100] = {
     0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 0x00 - 0x0f
     0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 0x10 - 0x1f
     0,                           // 0x20  ' ' (escape spaces in queries)
@@ -217,6 +217,11 @@ const unsigned char kSharedCharTypeTable[0x100] = {
     0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 0xf0 - 0xff
 };
 
+constexpr CanonCharSet kQueryCharSet =
+    CanonCharSet::FromPredicate([](unsigned char c) {
+      return !!(kSharedCharTypeTable[c] & CHAR_QUERY);
+    });
+
 const char kHexCharLookup[0x10] = {
     '0', '1', '2', '3', '4', '5', '6', '7',
     '8', '9', 'A', 'B', 'C', 'D', 'E', 'F',
@@ -16,6 +16,7 @@
 #include "base/component_export.h"
 #include "base/notreached.h"
 #include "url/url_canon.h"
+#include "url/url_canon_fast_path.h"
 
 namespace url {
 
@@ -57,6 +58,9 @@ enum SharedCharTypes {
 // over using a 32-bit number.
 extern const unsigned char kSharedCharTypeTable[0x100];
 
+// The characters with CHAR_QUERY, for AppendCharsInSet().
+extern const CanonCharSet kQueryCharSet;
+
 // More readable wrappers around the character type lookup table.
 inline bool IsCharOfType(unsigned char c, SharedCharTypes type) {
   return !!(kSharedCharTypeTable[c] & type);
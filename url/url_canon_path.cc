@@ -7,6 +7,7 @@
 #include "base/check.h"
 #include "base/check_op.h"
 #include "url/url_canon.h"
+#include "url/url_canon_fast_path.h"
 #include "url/url_canon_internal.h"
 #include "url/url_parse_internal.h"
 
@@ -52,7 +53,7 @@ enum CharacterFlags {
 // Dot is even more special, and the escaped version is handled specially by
 // IsDot. Therefore, we don't need the "escape" flag, and even the "unescape"
 // bit is never handled (we just need the "special") bit.
-const unsigned char kPathCharLookup[0x100] = {
+constexpr unsigned char kPathCharLookup[0x100] = {
 //   NULL     control chars...
      INVALID, ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,
 //   control chars...
@@ -79,6 +80,12 @@ const unsigned char kPathCharLookup[0x100] = {
      ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,
      ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE};
 
+// The characters that are copied to the output unchanged.
+constexpr CanonCharSet kPathPassChars =
+    CanonCharSet::FromPredicate([](unsigned char c) {
+      return !(kPathCharLookup[c] & SPECIAL);
+    });
+
 enum DotDisposition {
   // The given dot is just part of a filename and is not special.
   NOT_A_DIRECTORY,
@@ -262,6 +269,10 @@ bool DoPartialPathInternal(const CHAR* spec,
   bool success = true;
   for (int i = path.begin; i < end; i++) {
     DCHECK_LT(last_invalid_percent_index, output->length());
+    // Copy the run of characters that need no handling first.
+    AppendCharsInSet(spec, &i, end, kPathPassChars, output);
+    if (i == end)
+      break;
     UCHAR uch = static_cast<UCHAR>(spec[i]);
     if (sizeof(CHAR) > 1 && uch >= 0x80) {
       // We only need to test wide input for having non-ASCII characters. For
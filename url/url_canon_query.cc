@@ -3,6 +3,7 @@
 // found in the LICENSE file.
 
 #include "url/url_canon.h"
+#include "url/url_canon_fast_path.h"
 #include "url/url_canon_internal.h"
 
 // Query canonicalization in IE
@@ -59,6 +60,10 @@ template<typename CHAR>
 void AppendRaw8BitQueryString(const CHAR* source, int length,
                               CanonOutput* output) {
   for (int i = 0; i < length; i++) {
+    // Copy the run of characters that don't need escaping first.
+    AppendCharsInSet(source, &i, length, kQueryCharSet, output);
+    if (i == length)
+      break;
     if (!IsQueryChar(static_cast<unsigned char>(source[i])))
       AppendEscapedChar(static_cast<unsigned char>(source[i]), output);
     else  // Doesn't need escaping.
@@ -13,6 +13,7 @@
 #include "testing/gtest/include/gtest/gtest.h"
 #include "url/third_party/mozilla/url_parse.h"
 #include "url/url_canon.h"
+#include "url/url_canon_fast_path.h"
 #include "url/url_canon_internal.h"
 #include "url/url_canon_stdstring.h"
 #include "url/url_test_utils.h"
@@ -609,6 +610,32 @@ TEST(URLCanonTest, Host) {
   }
 }
 
+TEST(URLCanonTest, HostWithEmbeddedNull) {
+  // Embedded NULs are invalid, both before and within runs long enough for
+  // the vectorized scans.
+  const std::string kPrefixes[] = {"exa", std::string(40, 'a')};
+  for (const std::string& prefix : kPrefixes) {
+    const std::string input = prefix + std::string(1, '\0') + "mple.com";
+    SCOPED_TRACE(prefix);
+    for (bool wide : {false, true}) {
+      std::string out_str;
+      StdStringCanonOutput output(&out_str);
+      CanonHostInfo host_info;
+      Component in_comp(0, static_cast<int>(input.size()));
+      if (wide) {
+        const std::u16string input16(input.begin(), input.end());
+        CanonicalizeHostVerbose(input16.data(), in_comp, &output, &host_info);
+      } else {
+        CanonicalizeHostVerbose(input.data(), in_comp, &output, &host_info);
+      }
+      output.Complete();
+
+      EXPECT_EQ(CanonHostInfo::BROKEN, host_info.family);
+      EXPECT_EQ(prefix + "%00mple.com", out_str);
+    }
+  }
+}
+
 TEST(URLCanonTest, IPv4) {
   // clang-format off
   IPAddressCase cases[] = {
@@ -1345,6 +1372,94 @@ TEST(URLCanonTest, Query) {
   EXPECT_EQ("?a%20%00z%01", out_str);
 }
 
+TEST(URLCanonTest, CountLeadingCharsInSet) {
+  constexpr CanonCharSet kLowerCase = CanonCharSet::FromPredicate(
+      [](unsigned char c) { return c >= 'a' && c <= 'z'; });
+  EXPECT_TRUE(kLowerCase.Contains('a'));
+  EXPECT_TRUE(kLowerCase.Contains('z'));
+  EXPECT_FALSE(kLowerCase.Contains('A'));
+  EXPECT_FALSE(kLowerCase.Contains('a' | 0x80));
+
+  // Covers the vectorized loops and the tails after them, with the first
+  // character that's not in the set at every position.
+  for (size_t length = 0; length < 80; ++length) {
+    std::string input(length, 'x');
+    EXPECT_EQ(length,
+              CountLeadingCharsInSet(input.data(), input.size(), kLowerCase));
+    for (size_t i = 0; i < length; ++i) {
+      for (char c : {'A', '/', '\xE9', '\0'}) {
+        std::string with_other = input;
+        with_other[i] = c;
+        EXPECT_EQ(i, CountLeadingCharsInSet(with_other.data(),
+                                            with_other.size(), kLowerCase));
+      }
+    }
+  }
+}
+
+// The 16-bit canonicalizers don't take the fast paths, so they check that the
+// fast paths don't change the output.
+TEST(URLCanonTest, FastPathsMatch16Bit) {
+  const std::string kBase = "abcdefghijklmnopqrstuvwxyz0123456789-_.abcdef";
+  // Non-ASCII characters are left out, since they are UTF-8 in 8-bit input.
+  const char kSpecialChars[] = {'.', '%', '\\', ' ', '#', '?', '"',
+                                '<', '\'', 'A', '/', '~', '\x7F', '\0'};
+  for (size_t i = 0; i < kBase.size(); ++i) {
+    for (char c : kSpecialChars) {
+      std::string input = kBase;
+      input[i] = c;
+      if (c == '%' && i + 2 < input.size()) {
+        input[i + 1] = '4';
+        input[i + 2] = '1';
+      }
+      SCOPED_TRACE(input);
+      const std::u16string input16(input.begin(), input.end());
+      const Component component(0, static_cast<int>(input.size()));
+
+      std::string out8, out16;
+      Component out_component8, out_component16;
+      {
+        StdStringCanonOutput output8(&out8);
+        StdStringCanonOutput output16(&out16);
+        EXPECT_EQ(CanonicalizePath(input.data(), component, &output8,
+                                   &out_component8),
+                  CanonicalizePath(input16.data(), component, &output16,
+                                   &out_component16));
+        output8.Complete();
+        output16.Complete();
+        EXPECT_EQ(out16, out8);
+      }
+
+      out8.clear();
+      out16.clear();
+      {
+        StdStringCanonOutput output8(&out8);
+        StdStringCanonOutput output16(&out16);
+        CanonicalizeQuery(input.data(), component, nullptr, &output8,
+                          &out_component8);
+        CanonicalizeQuery(input16.data(), component, nullptr, &output16,
+                          &out_component16);
+        output8.Complete();
+        output16.Complete();
+        EXPECT_EQ(out16, out8);
+      }
+
+      out8.clear();
+      out16.clear();
+      {
+        StdStringCanonOutput output8(&out8);
+        StdStringCanonOutput output16(&out16);
+        EXPECT_EQ(CanonicalizeHostSubstring(input.data(), component, &output8),
+                  CanonicalizeHostSubstring(input16.data(), component,
+                                            &output16));
+        output8.Complete();
+        output16.Complete();
+        EXPECT_EQ(out16, out8);
+      }
+    }
+  }
+}
+
 TEST(URLCanonTest, Ref) {
   // Refs are trivial, it just checks the encoding.
   DualComponentCase ref_cases[] = {
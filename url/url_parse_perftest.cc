@@ -2,6 +2,7 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include "base/cxx17_backports.h"
 #include "base/strings/string_piece.h"
 #include "base/test/perf_time_logger.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -122,6 +123,82 @@ TEST(URLParse, TypicalURLParseCanonStdString) {
   canon_timer.Done();
 }
 
+// URLs with longer paths and queries, like those of resources and API calls,
+// where most of the time goes to canonicalizing the path and the query.
+constexpr base::StringPiece kLongUrls[] = {
+    "https://static.example-cdn.com/assets/v2/build/js/vendors~main~checkout."
+    "chunk.3f9a1c2b7d4e5f60718293a4b5c6d7e8f9012345.min.js",
+    "https://api.example.com/v1/users/123456789/timeline/entries?"
+    "limit=50&include_entities=true&cursor=eyJpZCI6MTIzNDU2Nzg5MCwidHMiOjE2MD"
+    "AwMDAwMDB9&fields=id,created_at,text,author_id,public_metrics",
+    "https://www.example.org/wiki/Uniform_Resource_Locator/"
+    "Syntax_and_semantics/Percent-encoding_reserved_characters_in_paths",
+    "https://ads.example.net/pagead/conversion/1234567890/?random=1617181920"
+    "&cv=9&fst=1617181920000&num=1&bg=ffffff&guid=ON&resp=GooglemKTybQhCsO"
+    "&u_h=1080&u_w=1920&u_ah=1040&u_aw=1920&u_cd=24&u_his=2&u_tz=-420",
+};
+
+// Canonicalizes the path, query and host of the URLs separately, which
+// includes no parsing or mallocs.
+TEST(URLParse, CanonicalizeComponents) {
+  url::Parsed parsed[base::size(kLongUrls)];
+  for (size_t i = 0; i < base::size(kLongUrls); ++i) {
+    url::ParseStandardURL(kLongUrls[i].data(), kLongUrls[i].size(),
+                          &parsed[i]);
+  }
+
+  url::RawCanonOutput<1024> output;
+  url::Component out_component;
+  base::PerfTimeLogger path_timer("Long_Path_Canon_AMillion");
+  for (int i = 0; i < 250000; i++) {  // divide by 4 so we get 1M
+    for (size_t j = 0; j < base::size(kLongUrls); ++j) {
+      output.set_length(0);
+      url::CanonicalizePath(kLongUrls[j].data(), parsed[j].path, &output,
+                            &out_component);
+    }
+  }
+  path_timer.Done();
+
+  base::PerfTimeLogger query_timer("Long_Query_Canon_AMillion");
+  for (int i = 0; i < 250000; i++) {
+    for (size_t j = 0; j < base::size(kLongUrls); ++j) {
+      output.set_length(0);
+      url::CanonicalizeQuery(kLongUrls[j].data(), parsed[j].query, nullptr,
+                             &output, &out_component);
+    }
+  }
+  query_timer.Done();
+
+  base::PerfTimeLogger host_timer("Long_Host_Canon_AMillion");
+  for (int i = 0; i < 250000; i++) {
+    for (size_t j = 0; j < base::size(kLongUrls); ++j) {
+      output.set_length(0);
+      url::CanonicalizeHost(kLongUrls[j].data(), parsed[j].host, &output,
+                            &out_component);
+    }
+  }
+  host_timer.Done();
+}
+
+TEST(URLParse, LongURLParseCanon) {
+  url::Parsed parsed[base::size(kLongUrls)];
+  url::Parsed out_parsed;
+  url::RawCanonOutput<1024> output;
+  base::PerfTimeLogger canon_timer("Long_Parse_Canon_AMillion");
+  for (int i = 0; i < 250000; i++) {  // divide by 4 so we get 1M
+    for (size_t j = 0; j < base::size(kLongUrls); ++j) {
+      url::ParseStandardURL(kLongUrls[j].data(), kLongUrls[j].size(),
+                            &parsed[j]);
+      output.set_length(0);
+      url::CanonicalizeStandardURL(
+          kLongUrls[j].data(), kLongUrls[j].size(), parsed[j],
+          url::SCHEME_WITH_HOST_PORT_AND_USER_INFORMATION, nullptr, &output,
+          &out_parsed);
+    }
+  }
+  canon_timer.Done();
+}
+
 TEST(URLParse, GURL) {
   base::PerfTimeLogger gurl_timer("Typical_GURL_AMillion");
   for (int i = 0; i < 333333; i++) {  // divide by 3 so we get 1M